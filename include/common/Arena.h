@@ -0,0 +1,64 @@
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include <stddef.h> // size_t
+
+namespace CommonNamespace {
+
+    class ArenaPrivate;
+
+    /* Monotonic allocator for short living objects of a request.
+     * The memory is provided from blocks which are only released as a whole with "reset".
+     * Single allocations cannot be freed.
+     * The first block is kept after a reset and is reused by the next request.
+     * This class is not thread safe. Each thread uses its own instance (see "getThreadArena").
+     */
+    class Arena {
+    public:
+
+        class Metrics {
+        public:
+            /* count of allocations */
+            unsigned long allocationCount;
+            /* count of allocated bytes */
+            unsigned long long allocatedBytes;
+            /* count of blocks allocated via malloc */
+            unsigned long blockAllocationCount;
+            /* count of resets */
+            unsigned long resetCount;
+            /* max. count of bytes used between two resets */
+            size_t maxUsedBytes;
+        };
+
+        /* blockSize: size of the blocks in bytes; larger allocations get an own block */
+        Arena(size_t blockSize = 16 * 1024);
+        virtual ~Arena();
+
+        /* Returns memory for "size" bytes with an alignment which is sufficient for all
+         * scalar types. Returns NULL if the memory cannot be allocated. */
+        virtual void* allocate(size_t size);
+        /* Releases all allocations. */
+        virtual void reset();
+        /* Returns the count of bytes which have been allocated since the last reset. */
+        virtual size_t getUsedBytes() const;
+
+        virtual Metrics getMetrics() const;
+
+        /* Returns the arena of the calling thread. The instance is created with the first call
+         * and destroyed when the thread exits. */
+        static Arena& getThreadArena();
+        /* Returns the arena which has been activated via ArenaScope by the calling thread or
+         * NULL. */
+        static Arena* getCurrent();
+    private:
+        Arena(const Arena& orig);
+        Arena& operator=(const Arena&);
+
+        static void setCurrent(Arena* arena);
+
+        ArenaPrivate* d;
+
+        friend class ArenaScope;
+    };
+} // namespace CommonNamespace
+#endif /* COMMON_ARENA_H */
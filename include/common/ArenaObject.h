@@ -0,0 +1,22 @@
+#ifndef COMMON_ARENAOBJECT_H
+#define COMMON_ARENAOBJECT_H
+
+#include <stddef.h> // size_t
+
+namespace CommonNamespace {
+
+    /* Base class for objects which are allocated from the current arena of the thread (see
+     * ArenaScope). If no arena is active then the objects are allocated from the heap.
+     * Deleting an object which has been allocated from an arena only calls the destructor; the
+     * memory is released with the reset of the arena.
+     */
+    class ArenaObject {
+    public:
+        static void* operator new(size_t size);
+        static void operator delete(void* p);
+        // used by the memory leak detection of CppUTest
+        static void* operator new(size_t size, const char* file, int line);
+        static void operator delete(void* p, const char* file, int line);
+    };
+} // namespace CommonNamespace
+#endif /* COMMON_ARENAOBJECT_H */
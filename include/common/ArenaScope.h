@@ -0,0 +1,25 @@
+#ifndef COMMON_ARENASCOPE_H
+#define COMMON_ARENASCOPE_H
+
+#include "Arena.h"
+
+namespace CommonNamespace {
+
+    /* Activates an arena for the calling thread while the scope exists. Instances of
+     * ArenaObject which are created in the scope are allocated from the arena.
+     * When the outermost scope of an arena is left, the arena is reset. All objects which have
+     * been allocated from the arena must have been destroyed before.
+     */
+    class ArenaScope {
+    public:
+        ArenaScope(Arena& arena = Arena::getThreadArena());
+        virtual ~ArenaScope();
+    private:
+        ArenaScope(const ArenaScope& orig);
+        ArenaScope& operator=(const ArenaScope&);
+
+        Arena& arena;
+        Arena* previous;
+    };
+} // namespace CommonNamespace
+#endif /* COMMON_ARENASCOPE_H */
@@ -0,0 +1,89 @@
+#ifndef COMMON_COMPACTVALUE_H
+#define COMMON_COMPACTVALUE_H
+
+#include <stddef.h> // size_t
+
+namespace CommonNamespace {
+
+    /* Compact storage of a scalar value: a numeric value or a byte sequence (e.g. an UTF-8
+     * encoded string or a byte string).
+     * Numeric values and byte sequences with up to INLINE_CAPACITY bytes are stored in the
+     * instance itself. Longer byte sequences are stored in a reference counted buffer which is
+     * shared by the copies of the instance. An attached byte sequence is owned by the instance
+     * without being copied; copies of such an instance get their own storage.
+     * An instance must not be used by multiple threads concurrently but copies of an instance
+     * may be used by different threads.
+     */
+    class CompactValue {
+    public:
+
+        union Numeric {
+            bool boolValue;
+            signed char scharValue;
+            char charValue;
+            int intValue;
+            unsigned int uintValue;
+            long longValue;
+            unsigned long ulongValue;
+            long long llongValue;
+            unsigned long long ullongValue;
+            float floatValue;
+            double doubleValue;
+        };
+
+        static const size_t INLINE_CAPACITY = 24;
+
+        // NULL value
+        CompactValue();
+        // Copies an inline value or an attached byte sequence or shares the buffer of the value.
+        CompactValue(const CompactValue& orig);
+        ~CompactValue();
+
+        CompactValue& operator=(const CompactValue& orig);
+
+        bool isNull() const;
+        bool isNumeric() const;
+
+        // Returns the numeric value.
+        const Numeric& getNumeric() const;
+        // Releases the current value and returns the numeric value for modification.
+        Numeric& setNumeric();
+
+        // Returns the byte sequence or NULL if the value is not a byte sequence.
+        const char* getBytes() const;
+        // Returns the length of the byte sequence.
+        size_t getLength() const;
+        // Copies a byte sequence. If "bytes" is NULL then the value is set to NULL.
+        void setBytes(const char* bytes, size_t length);
+        // Takes over a byte sequence which has been allocated with new[] without copying it.
+        // The byte sequence is destroyed with delete[] when the value is released.
+        // If "bytes" is NULL then the value is set to NULL.
+        void attachBytes(char* bytes, size_t length);
+        // Returns true if the value contains the byte sequence.
+        bool equalBytes(const char* bytes, size_t length) const;
+
+        // Releases the current value and sets the value to NULL.
+        void clear();
+    private:
+        class SharedBuffer;
+
+        enum Kind {
+            NULL_VALUE, NUMERIC, INLINE, SHARED, ATTACHED
+        };
+
+        struct Attached {
+            char* bytes;
+            size_t length;
+        };
+
+        union {
+            Numeric numeric;
+            char inlineBytes[INLINE_CAPACITY];
+            SharedBuffer* shared;
+            Attached attached;
+        };
+        unsigned char kind;
+        unsigned char inlineLength;
+    };
+} // namespace CommonNamespace
+#endif /* COMMON_COMPACTVALUE_H */
@@ -0,0 +1,70 @@
+#ifndef COMMON_LOGGING_LOGTHROTTLE_H
+#define COMMON_LOGGING_LOGTHROTTLE_H
+
+#include "Logger.h"
+#include <string>
+
+namespace CommonNamespace {
+
+    class LogThrottlePrivate;
+
+    /* Limits the rate of similar log messages. Messages are similar if they have the same
+     * message template and refer to the same node. Each combination has a token bucket which
+     * allows a burst of messages and refills with a fixed rate.
+     * The count of suppressed messages is logged as summary via the logger when a message
+     * passes again or after the summary interval.
+     * Instances are provided by LoggerFactory::getLogThrottle.
+     * This class is thread safe.
+     */
+    class LogThrottle {
+    public:
+
+        class Configuration {
+        public:
+            Configuration();
+
+            /* max. count of similar messages which are logged at once */
+            int maxBurst;
+            /* count of similar messages per second which may be logged after a burst
+             * (0: throttling is disabled) */
+            double messagesPerSecond;
+            /* interval in milliseconds for logging summaries of suppressed messages */
+            long summaryInterval;
+        };
+
+        class Metrics {
+        public:
+            /* count of passed messages */
+            unsigned long passedCount;
+            /* count of suppressed messages */
+            unsigned long suppressedCount;
+            /* count of logged summaries */
+            unsigned long summaryCount;
+        };
+
+        LogThrottle(Logger& log, const Configuration& conf) /* throws MutexException */;
+        /* Logs the summaries of suppressed messages. */
+        virtual ~LogThrottle();
+
+        /* Returns whether a message may be logged.
+         * messageTemplate: identifies the message (e.g. the format string)
+         * node: the node the message refers to (may be empty)
+         */
+        virtual bool pass(const char* messageTemplate, const std::string& node = std::string());
+        /* Logs the summaries of all suppressed messages. */
+        virtual void flush();
+
+        /* Sets the logger for the summaries. The summaries are dropped if no logger is set
+         * (NULL). LoggerFactory sets the logger of the active logger factory implementation.
+         */
+        virtual void setLogger(Logger* log);
+        virtual void setConfiguration(const Configuration& conf);
+        virtual Metrics getMetrics();
+    private:
+        LogThrottle(const LogThrottle& orig);
+        LogThrottle& operator=(const LogThrottle&);
+
+        LogThrottlePrivate* d;
+    };
+} // namespace CommonNamespace
+#endif /* COMMON_LOGGING_LOGTHROTTLE_H */
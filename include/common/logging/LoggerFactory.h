@@ -3,6 +3,7 @@
 
 #include "ILoggerFactory.h"
 #include "Logger.h"
+#include "LogThrottle.h"
 
 namespace CommonNamespace {
 
@@ -25,6 +26,21 @@ namespace CommonNamespace {
          * The call of this method is thread safe.
          */
         static Logger* getLogger(const char* name);
+
+        /* Sets the configuration of the log throttle for a logger. An empty name sets the
+         * default configuration for all loggers without an own configuration.
+         * Existing log throttles are updated.
+         * The call of this method is thread safe.
+         */
+        static void setLogThrottle(const char* name, const LogThrottle::Configuration& conf);
+        /* Gets the log throttle of a logger. The name identifies the logger.
+         * NULL is returned if logging is deactivated.
+         * The returned instance is kept if the active logger factory implementation changes
+         * (the summaries are logged with the logger of the active implementation). It is
+         * deleted when the logging is deactivated and must NOT be deleted by the caller.
+         * The call of this method is thread safe.
+         */
+        static LogThrottle* getLogThrottle(const char* name) /* throws MutexException */;
     private:
         LoggerFactory(const LoggerFactory& orig);
         LoggerFactory& operator=(const LoggerFactory&);
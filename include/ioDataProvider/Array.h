@@ -2,6 +2,7 @@
 #define IODATAPROVIDER_ARRAY_H_
 
 #include "Variant.h"
+#include <stddef.h> // size_t
 #include <string>
 #include <vector>
 
@@ -21,13 +22,38 @@ namespace IODataProviderNamespace {
         virtual ~Array();
 
         int getArrayType() const;
+        // Returns the count of elements (0 for a NULL array).
+        unsigned long getLength() const;
+        // Returns the elements.
+        // For an array with contiguous values the elements are created with the first call
+        // (this is thread safe). Converters should use getValues before.
         const std::vector<const Variant*>* getElements() const;
+        // Returns whether the element instances exist. For an array with contiguous values
+        // they only exist after a call of getElements.
+        bool hasElements() const;
+        // Returns the contiguous values or NULL if the array has been created with elements.
+        // The values are stored with fixed size types:
+        //   BOOL: uint8_t, SCHAR: int8_t, CHAR: char, INT: int16_t, UINT: uint16_t,
+        //   LONG: int32_t, ULONG: uint32_t, LLONG: int64_t, ULLONG: uint64_t,
+        //   FLOAT: float, DOUBLE: double
+        const void* getValues() const;
+        void* getValues();
+
+        // Returns the size of an element in bytes if an array of the given type can be
+        // created with contiguous values else 0.
+        static size_t getElementSize(int arrayType);
+        // Creates an array with contiguous values of a numeric, boolean or byte type
+        // (see getElementSize). The values are initialized with 0 and can be set via
+        // getValues. Element instances are only created on demand (see getElements).
+        // The returned instance must be destroyed by the caller.
+        static Array* createTypedArray(int arrayType, unsigned long length);
 
         // interface Variant
         virtual Variant* copy() const;
         virtual Variant::Type getVariantType() const;
         virtual std::string toString() const;
     private:
+        Array();
         Array& operator=(const Array&);
 
         ArrayPrivate* d;
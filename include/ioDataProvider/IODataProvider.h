@@ -50,8 +50,10 @@ namespace IODataProviderNamespace {
                 int namespaceId) /* throws IODataProviderException */ = 0;
 
         // Gets data from the data provider.
-        // References to the parameter values must neither be saved in the implementation
-        // nor be returned.
+        // References to the parameter values must not be saved in the implementation. The
+        // returned NodeData instances may reference the node ids of the request instead of
+        // copies (see NodeData::copyNodeId). The caller must not use them after the node ids
+        // have been destroyed.
         // The returned container and its components must be deleted by the caller.
         // The components are responsible for destroying their own sub structures.
         virtual std::vector<NodeData*>* read(
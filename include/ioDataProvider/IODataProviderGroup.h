@@ -0,0 +1,89 @@
+#ifndef IODATAPROVIDER_IODATAPROVIDERGROUP_H_
+#define IODATAPROVIDER_IODATAPROVIDERGROUP_H_
+
+#include "IODataProvider.h"
+#include <string>
+#include <vector>
+
+namespace IODataProviderNamespace {
+
+    class IODataProviderGroupPrivate;
+
+    // An IO data provider which routes the requests to a group of IO data providers.
+    // A node is routed to a provider via the routing table:
+    //  1. the longest matching prefix of a string NodeId (see "addNodeIdPrefixRoute")
+    //  2. the namespace of the NodeId (see "addNamespaceRoute")
+    //  3. the default provider (the first provider of the group)
+    // Batched requests are split per target provider. The sub requests are processed in
+    // parallel and the results are merged in the order of the request. The calling thread
+    // processes one of the sub requests itself. Each provider except the first one of the
+    // group has a worker thread which processes its sub requests in the order of their
+    // arrival.
+    class IODataProviderGroup : public IODataProvider {
+    public:
+        // If the values are attached then the responsibility for destroying the providers
+        // is delegated to the group.
+        // The list of providers must not be empty.
+        IODataProviderGroup(const std::vector<IODataProvider*>& providers,
+                bool attachValues = false) /* throws IODataProviderException */;
+        virtual ~IODataProviderGroup();
+
+        // Routes all nodes of a namespace to a provider of the group.
+        // The namespace index is resolved when the node properties of the namespace are
+        // requested via "getDefaultNodeProperties" or "getNodeProperties".
+        virtual void addNamespaceRoute(const std::string& namespaceUri,
+                IODataProvider& provider) /* throws IODataProviderException */;
+        // Routes all nodes with a string identifier starting with the given prefix to a
+        // provider of the group. A negative namespace index matches all namespaces.
+        virtual void addNodeIdPrefixRoute(int namespaceIndex, const std::string& prefix,
+                IODataProvider& provider) /* throws IODataProviderException */;
+        // Gets the provider which is responsible for a node.
+        virtual IODataProvider& getProvider(const NodeId& nodeId);
+
+        // interface IODataProvider
+        // The providers are opened/closed with the same parameters.
+        virtual void open(const std::string& confDir) /* throws IODataProviderException */;
+        virtual void open(JNIEnv *env, jobject properties, jobject dataProvider) /* throws IODataProviderException */;
+        virtual void close();
+        virtual const NodeProperties* getDefaultNodeProperties(const std::string& namespaceUri,
+                int namespaceId) /* throws IODataProviderException */;
+        virtual std::vector<const NodeData*>* getNodeProperties(
+                const std::string& namespaceUri,
+                int namespaceId) /* throws IODataProviderException */;
+        // If a provider fails then the exception is set to each NodeData instance of the
+        // relating nodes.
+        virtual std::vector<NodeData*>* read(
+                const std::vector<const NodeId*>& nodeIds) /* throws IODataProviderException */;
+        // If a provider fails then the first exception is thrown after all sub requests
+        // have been processed.
+        virtual void write(const std::vector<const NodeData*>& nodeData,
+                bool sendValuesChangedEvents) /* throws IODataProviderException */;
+        // If a provider fails then the exception is set to each MethodData instance of the
+        // relating methods.
+        virtual std::vector<MethodData*>* call(
+                const std::vector<const MethodData*>& methodData) /* throws IODataProviderException */;
+        // If a provider fails then the exception is set to each NodeData instance of the
+        // relating nodes.
+        virtual std::vector<NodeData*>* subscribe(
+                const std::vector<const NodeId*>& nodeIds,
+                SubscriberCallback& callback) /* throws IODataProviderException */;
+        // If a provider fails then the first exception is thrown after all sub requests
+        // have been processed.
+        virtual void unsubscribe(
+                const std::vector<const NodeId*>& nodeIds) /* throws IODataProviderException */;
+        // Notifications and events are forwarded to the provider of the namespace (see
+        // "addNamespaceRoute"). Prefix routes are not applied because the identifiers are
+        // Java objects.
+        virtual void notification(JNIEnv *env, int ns, jobject id, jobject value);
+        virtual void event(JNIEnv *env, int eNs, jobject event, int pNs, jobject param,
+                long timestamp, int severity, jstring msg, jobject value);
+        virtual void setNodeBrowser(SASModelProviderNamespace::NodeBrowser* nodeBrowser);
+    private:
+        IODataProviderGroup(const IODataProviderGroup&);
+        IODataProviderGroup& operator=(const IODataProviderGroup&);
+
+        IODataProviderGroupPrivate* d;
+    };
+
+} // namespace IODataProviderNamespace
+#endif /* IODATAPROVIDER_IODATAPROVIDERGROUP_H_ */
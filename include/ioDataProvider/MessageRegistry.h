@@ -0,0 +1,23 @@
+#ifndef IODATAPROVIDER_MESSAGEREGISTRY_H_
+#define IODATAPROVIDER_MESSAGEREGISTRY_H_
+
+#include <string>
+
+namespace IODataProviderNamespace {
+
+    // Interns the messages of node status codes (see NodeData::setStatus).
+    // A message is registered once and referenced by its id afterwards.
+    // This class is thread safe.
+    class MessageRegistry {
+    public:
+        // Registers a message and returns its id. If the message has already been registered
+        // then the existing id is returned.
+        static int registerMessage(const std::string& message);
+        // Returns the message for an id or an empty string if the id is unknown.
+        static std::string getMessage(int messageId);
+    private:
+        MessageRegistry();
+    };
+
+} // namespace IODataProviderNamespace
+#endif /* IODATAPROVIDER_MESSAGEREGISTRY_H_ */
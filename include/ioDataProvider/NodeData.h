@@ -16,18 +16,41 @@ namespace IODataProviderNamespace {
         // is delegated to the NodeData instance.
         NodeData(const NodeId& nodeId, const Variant* data, bool attachValues =
                 false);
+        // The node id and the other values are attached separately. A node id which is not
+        // attached (e.g. the node id of a read request) must outlive the instance or be
+        // replaced with "copyNodeId" before.
+        NodeData(const NodeId& nodeId, const Variant* data, bool attachValues,
+                bool attachNodeId);
         // Creates a deep copy of the instance.
         NodeData(const NodeData& nodeData);
         virtual ~NodeData();
 
         virtual const NodeId& getNodeId() const;
+        // Replaces a node id which is not attached with an attached copy. If the node id is
+        // already attached then nothing is to be done.
+        virtual void copyNodeId();
 
         virtual const Variant* getData() const;
         virtual void setData(const Variant* data);
 
+        // Returns the exception. If only a bad status code has been set then an exception is
+        // created on demand from the status code and the message.
         virtual IODataProviderException* getException() const;
         virtual void setException(IODataProviderException* e);
 
+        // Sets a compact error status without creating an exception
+        // (e.g. for per-node failures of a read).
+        // statusCode: OPC UA status code (0: good)
+        // messageId: id of a message registered via MessageRegistry (-1: no message)
+        virtual void setStatus(unsigned long statusCode, int messageId = -1);
+        // Returns the OPC UA status code. If only an exception has been set then
+        // BAD (0x80000000) is returned.
+        virtual unsigned long getStatusCode() const;
+        virtual int getMessageId() const;
+        // Returns whether an exception or a bad status code has been set.
+        // In contrast to getException no exception is created.
+        virtual bool hasError() const;
+
         virtual std::string toString() const;
     private:
         NodeData& operator=(const NodeData&);
@@ -6,14 +6,21 @@
 
 namespace IODataProviderNamespace {
 
-class NodeIdPrivate;
-
+// The identifier is stored in the instance itself. A string identifier is held as std::string
+// member, so getString does not modify the instance.
 class NodeId : public Variant {
 public:
 	enum Type {
 		NUMERIC, STRING
 	};
 
+	// Orders node ids by namespace index, type and identifier without creating strings.
+	// It can be used as comparator of ordered containers like std::map.
+	class Less {
+	public:
+		bool operator()(const NodeId& nodeId1, const NodeId& nodeId2) const;
+	};
+
 	NodeId(int namespaceIndex, long id);
 	// If the values are attached then the responsibility for destroying the value instances
 	// is delegated to the NodeId instance.
@@ -40,7 +47,10 @@ public:
 private:
 	NodeId& operator=(const NodeId&);
 
-	NodeIdPrivate* d;
+	int namespaceIndex;
+	Type nodeType;
+	long numericId;
+	std::string stringId;
 };
 
 } // namespace IODataProviderNamespace
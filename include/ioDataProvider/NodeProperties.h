@@ -25,6 +25,22 @@ public:
 	virtual ValueHandling getValueHandling() const;
 	virtual void setValueHandling(ValueHandling valueHandling);
 
+	// Sets a filter for the values of an ASYNC node which are received from the IO data
+	// provider. The filter replaces the ingress filter settings of the server configuration
+	// for the node.
+	// suppressEqualValues: values which equal the last value are suppressed
+	// absoluteDeadband: numeric values are suppressed if the absolute difference to the last
+	//   value does not exceed the deadband (0: disabled)
+	// percentDeadband: the deadband in percent of the EURange of the variable
+	//   (0: disabled, replaces the absolute deadband if the variable has an EURange)
+	virtual void setIngressFilter(bool suppressEqualValues, double absoluteDeadband,
+			double percentDeadband);
+	// Returns whether a filter has been set via "setIngressFilter".
+	virtual bool hasIngressFilter() const;
+	virtual bool getIngressSuppressEqualValues() const;
+	virtual double getIngressAbsoluteDeadband() const;
+	virtual double getIngressPercentDeadband() const;
+
 	// interface Variant
 	virtual Variant* copy() const;
 	virtual Type getVariantType() const;
@@ -2,12 +2,14 @@
 #define IODATAPROVIDER_SCALAR_H_
 
 #include "Variant.h"
+#include <common/CompactValue.h>
 #include <string>
 
 namespace IODataProviderNamespace {
 
-    class ScalarPrivate;
-
+    // Numeric values and byte strings are stored in the instance itself (see CompactValue).
+    // Strings are held as std::string members which are set by the setters, so the getters
+    // do not modify the instance.
     class Scalar : public Variant {
     public:
 
@@ -95,7 +97,21 @@ namespace IODataProviderNamespace {
     private:
         Scalar& operator=(const Scalar&);
 
-        ScalarPrivate* d;
+        void clear();
+
+        // Takes over the content of a string: an attached string is swapped and destroyed.
+        // Returns false if the string is NULL.
+        static bool assignString(std::string& dest, const std::string* src, bool attachValue);
+
+        Type scalarType;
+        // numeric value or byte string
+        CommonNamespace::CompactValue value;
+        // string or text of a localized text
+        std::string text;
+        // locale of a localized text
+        std::string locale;
+        bool hasText;
+        bool hasLocale;
     };
 
 } // namespace IODataProviderNamespace
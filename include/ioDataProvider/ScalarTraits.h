@@ -0,0 +1,172 @@
+#ifndef IODATAPROVIDER_SCALARTRAITS_H_
+#define IODATAPROVIDER_SCALARTRAITS_H_
+
+#include "Scalar.h"
+#include <stdint.h> // int32_t
+
+namespace IODataProviderNamespace {
+
+    // Compile-time description of a numeric, boolean or byte scalar type. Converters use the
+    // traits to generate a specialized conversion for each pair of types instead of
+    // dispatching via switch statements for each value:
+    //   Type:        the value type of the getter and setter of Scalar
+    //   ElementType: the type of the contiguous values of an Array (see Array::getValues)
+    //   get/set:     access to the value of a Scalar
+    template<int ScalarType> class ScalarTraits;
+
+    template<> class ScalarTraits<Scalar::BOOL> {
+    public:
+        typedef bool Type;
+        typedef uint8_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getBool();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setBool(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::SCHAR> {
+    public:
+        typedef signed char Type;
+        typedef int8_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getSChar();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setSChar(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::CHAR> {
+    public:
+        typedef char Type;
+        typedef char ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getChar();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setChar(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::INT> {
+    public:
+        typedef int Type;
+        typedef int16_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getInt();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setInt(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::UINT> {
+    public:
+        typedef unsigned int Type;
+        typedef uint16_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getUInt();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setUInt(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::LONG> {
+    public:
+        typedef long Type;
+        typedef int32_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getLong();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setLong(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::ULONG> {
+    public:
+        typedef unsigned long Type;
+        typedef uint32_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getULong();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setULong(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::LLONG> {
+    public:
+        typedef long long Type;
+        typedef int64_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getLLong();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setLLong(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::ULLONG> {
+    public:
+        typedef unsigned long long Type;
+        typedef uint64_t ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getULLong();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setULLong(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::FLOAT> {
+    public:
+        typedef float Type;
+        typedef float ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getFloat();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setFloat(value);
+        }
+    };
+
+    template<> class ScalarTraits<Scalar::DOUBLE> {
+    public:
+        typedef double Type;
+        typedef double ElementType;
+
+        static Type get(const Scalar& scalar) {
+            return scalar.getDouble();
+        }
+
+        static void set(Scalar& scalar, Type value) {
+            scalar.setDouble(value);
+        }
+    };
+
+} // namespace IODataProviderNamespace
+#endif /* IODATAPROVIDER_SCALARTRAITS_H_ */
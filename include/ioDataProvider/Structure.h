@@ -4,17 +4,28 @@
 #include "NodeId.h"
 #include "Variant.h"
 #include <map>
+#include <stddef.h> // size_t
 #include <string>
 
 namespace IODataProviderNamespace {
 
     class StructurePrivate;
 
+    // The fields of a structure are stored contiguously. A structure created by a converter
+    // provides the fields in the order of the data type definition. Unset optional fields are
+    // not stored.
     class Structure : public Variant {
     public:
+
+        class Field {
+        public:
+            std::string name;
+            const Variant* value;
+        };
+
         // If the values are attached then the responsibility for destroying the value instances
         // is delegated to the Structure instance.
-        // fieldData: field name => field value
+        // fieldData: field name => field value (the fields are stored in the order of the map)
         Structure(const NodeId& dataTypeId,
                 const std::map<std::string, const Variant*>& fieldData, bool attachValues = false);
         // Creates a deep copy of the instance.
@@ -22,13 +33,33 @@ namespace IODataProviderNamespace {
         virtual ~Structure();
 
         const NodeId& getDataTypeId() const;
+        // Returns the fields as map (field name => field value).
+        // The map is created with the first call (this is thread safe).
         const std::map<std::string, const Variant*>& getFieldData() const;
+        // Returns the count of fields.
+        size_t getFieldCount() const;
+        // Returns the field at a position.
+        const Field& getField(size_t index) const;
+        // Returns the value of a field or NULL if the structure does not contain the field.
+        // The search starts at the position "hint" (e.g. the position of the field in the data
+        // type definition), so fields in the order of the data type definition are found with
+        // one comparison.
+        const Variant* getFieldValue(const std::string& name, size_t hint = 0) const;
+        // Appends a field. If the values are attached then the value is attached too.
+        void addField(const std::string& name, const Variant& value);
+
+        // Creates a structure without fields. The fields are appended via addField in the
+        // order of the data type definition. The data type id and the values are attached.
+        // fieldCount: the expected count of fields
+        // The returned instance must be destroyed by the caller.
+        static Structure* createStructure(const NodeId& dataTypeId, size_t fieldCount);
 
         // interface Variant
         virtual Variant* copy() const;
         virtual Type getVariantType() const;
         virtual std::string toString() const;
     private:
+        Structure();
         Structure& operator=(const Structure&);
 
         StructurePrivate* d;
@@ -2,6 +2,7 @@
 #define IODATAPROVIDER_SUBSCRIBERCALLBACK_H_
 
 #include "Event.h"
+#include "NodeId.h"
 
 namespace IODataProviderNamespace {
 
@@ -12,6 +13,13 @@ namespace IODataProviderNamespace {
 
         // References to parameter values must not be saved in the implementation.
         virtual void valuesChanged(const Event& event) /* throws SubscriberCallbackException */ = 0;
+        // Returns whether events of an event type are delivered to any client.
+        // An IO data provider may skip the creation of events which are not monitored.
+        // The default implementation returns true.
+        virtual bool isEventMonitored(const NodeId& eventTypeId);
+        // Is called by an IO data provider if it skipped the creation of an event because
+        // the event type is not monitored. The default implementation does nothing.
+        virtual void eventSkipped(const NodeId& eventTypeId);
     };
 
 } // namespace IODataProviderNamespace
@@ -15,6 +15,7 @@
 #include <uaarraytemplates.h> // PDataValueArray
 #include <uadatavariablecache.h> // UaVariableCache
 #include <uastring.h> // UaString
+#include <vector>
 
 namespace SASModelProviderNamespace {
 
@@ -27,6 +28,12 @@ namespace SASModelProviderNamespace {
                 OpcUa_Boolean firesEvents = OpcUa_False);
         virtual ~CodeNodeManagerBase();
 
+        // interface NodeManagerConfig
+        // The node is removed from the caches of the node browsers before it is deleted.
+        virtual UaStatus deleteUaNode(UaNode* pNode, OpcUa_Boolean bDeleteTargetReferences,
+                OpcUa_Boolean bDeleteSourceReferences,
+                OpcUa_Boolean bAddModelChangeEvents = OpcUa_False);
+
         // interface HaNodeManager
         virtual UaStatus afterStartUp();
         virtual UaStatus beforeShutDown();
@@ -50,7 +57,9 @@ namespace SASModelProviderNamespace {
         virtual UaString getNameSpaceUri();
         virtual const UaString& getDefaultLocaleId() const;
         virtual void setVariable(UaVariable& variable,
-                UaVariant& newValue) /* throws HaNodeManagerException */;                       
+                UaVariant& newValue) /* throws HaNodeManagerException */;
+        virtual void setVariables(const std::vector<UaVariable*>& variables,
+                const std::vector<UaVariant*>& newValues) /* throws HaNodeManagerException */;
     private:
         CodeNodeManagerBase(const CodeNodeManagerBase&);
         CodeNodeManagerBase& operator=(const CodeNodeManagerBase&);
@@ -20,11 +20,18 @@ namespace SASModelProviderNamespace {
             virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId) = 0;
             // The returned container must be deleted by the caller.
             virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& typeId) = 0;
+            // Returns the last super type or the type itself if it is a type of namespace 0.
+            // If no super type exists then a null UaNodeId is returned.
+            // The default implementation uses getSuperTypes.
+            virtual UaNodeId getBuildInType(const UaNodeId& typeId);
         };
 
         // If the values are attached then the responsibility for destroying the callback instance
         // is delegated to the Converter instance.
-        ConverterUa2IO(ConverterCallback& callback, bool attachValues = false);
+        // The structure definitions provided by the callback are compiled to codecs once per
+        // data type and cached for the lifetime of the converter.
+        ConverterUa2IO(ConverterCallback& callback, bool attachValues = false)
+        /* throws MutexException */;
         virtual ~ConverterUa2IO();
 
         // Converts a UaNodeId to a NodeId.
@@ -42,6 +49,11 @@ namespace SASModelProviderNamespace {
         // The returned UaVariant instance must be destroyed by the caller.
         virtual UaVariant* convertIo2ua(const IODataProviderNamespace::Variant& value,
                 const UaNodeId& destDataTypeId) const; /* throws ConversionException */
+        // Converts a Variant to the UaVariant "dest" (eg. a reused slot). A previous value of
+        // "dest" is replaced. Scalars are converted without an intermediate UaVariant instance.
+        virtual void convertIo2ua(const IODataProviderNamespace::Variant& value,
+                const UaNodeId& destDataTypeId,
+                UaVariant& dest) const; /* throws ConversionException */
     private:
         ConverterUa2IO(const ConverterUa2IO& orig);
         ConverterUa2IO& operator=(const ConverterUa2IO&);
@@ -0,0 +1,86 @@
+#ifndef SASMODELPROVIDER_BASE_DEMANDSUBSCRIPTIONMANAGER_H_
+#define SASMODELPROVIDER_BASE_DEMANDSUBSCRIPTIONMANAGER_H_
+
+#include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/SubscriberCallback.h>
+#include <vector>
+
+namespace SASModelProviderNamespace {
+
+    class DemandSubscriptionManagerPrivate;
+
+    // Subscribes nodes at an IO data provider only while they are monitored.
+    // The monitored items of each node are counted. A node is subscribed when its first
+    // monitored item begins and unsubscribed after its last monitored item stops.
+    // The changes are collected by a separate thread for a debounce time (starting with
+    // the first change) and sent with one subscribe and one unsubscribe call. Changes which
+    // are reverted within the debounce time do not result in a call.
+    // This class is thread safe.
+    class DemandSubscriptionManager {
+    public:
+
+        class StatusCallback {
+        public:
+            StatusCallback();
+            virtual ~StatusCallback();
+
+            // Is called by the subscribing thread with the initial values of newly
+            // subscribed nodes. The values contain the exceptions of failed nodes.
+            // References to the parameter values must not be saved in the implementation.
+            virtual void subscribed(
+                    const std::vector<IODataProviderNamespace::NodeData*>& initialValues) = 0;
+            // Is called by the subscribing thread if a subscribe or unsubscribe call failed.
+            // References to the parameter values must not be saved in the implementation.
+            virtual void subscriptionFailed(
+                    const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds,
+                    bool isSubscribe,
+                    const IODataProviderNamespace::IODataProviderException& exception) = 0;
+        };
+
+        class Metrics {
+        public:
+            // count of subscribe calls to the IO data provider
+            unsigned long subscribeCallCount;
+            // count of unsubscribe calls to the IO data provider
+            unsigned long unsubscribeCallCount;
+            // count of nodes sent with subscribe calls
+            unsigned long subscribedNodeCount;
+            // count of nodes sent with unsubscribe calls
+            unsigned long unsubscribedNodeCount;
+            // count of changes which have been reverted within the debounce time
+            unsigned long debouncedCount;
+        };
+
+        // debounceTime: delay of the provider calls in milliseconds
+        // References to the subscriber callback and the status callback are saved internally.
+        DemandSubscriptionManager(IODataProviderNamespace::IODataProvider& ioDataProvider,
+                IODataProviderNamespace::SubscriberCallback& subscriberCallback,
+                long debounceTime, StatusCallback* statusCallback) /* throws MutexException */;
+        // Stops the subscribing thread. Pending changes are discarded.
+        virtual ~DemandSubscriptionManager();
+
+        // Is called when a monitored item for a node begins.
+        virtual void monitoringStarted(const IODataProviderNamespace::NodeId& nodeId);
+        // Is called when a monitored item for a node stops.
+        virtual void monitoringStopped(const IODataProviderNamespace::NodeId& nodeId);
+        // Sends the pending changes to the IO data provider in the current thread.
+        // Failures are reported via the status callback.
+        virtual void flush();
+        // Returns whether a node is subscribed at the IO data provider.
+        virtual bool isSubscribed(const IODataProviderNamespace::NodeId& nodeId);
+        // Returns the count of nodes with pending changes.
+        virtual int getPendingCount();
+
+        virtual Metrics getMetrics();
+    private:
+        DemandSubscriptionManager(const DemandSubscriptionManager&);
+        DemandSubscriptionManager& operator=(const DemandSubscriptionManager&);
+
+        DemandSubscriptionManagerPrivate* d;
+    };
+
+} // namespace SASModelProviderNamespace
+#endif /* SASMODELPROVIDER_BASE_DEMANDSUBSCRIPTIONMANAGER_H_ */
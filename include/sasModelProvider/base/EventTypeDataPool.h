@@ -0,0 +1,76 @@
+#ifndef SASMODELPROVIDER_BASE_EVENTTYPEDATAPOOL_H_
+#define SASMODELPROVIDER_BASE_EVENTTYPEDATAPOOL_H_
+
+#include <ioDataProvider/NodeId.h>
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <uanodeid.h> // UaNodeId
+
+namespace SASModelProviderNamespace {
+
+    class EventTypeData;
+    class EventTypeDataPoolPrivate;
+
+    // Holds reusable event objects per event type. The field slots of an event object are
+    // allocated once and reused for further events of the same type.
+    // The resolved fields of the event types are cached per IO field id, so the field data of
+    // further events can be converted to the slots without resolving the fields again.
+    // This class is thread safe.
+    class EventTypeDataPool {
+    public:
+
+        // A resolved field of an event type.
+        class Field {
+        public:
+            UaNodeId nodeId;
+            // the data type of the field variable
+            UaNodeId dataTypeId;
+            // the index of the field in the event type registry (-1 if the field has not been
+            // registered yet when the field has been cached)
+            int index;
+        };
+
+        class Metrics {
+        public:
+            // count of acquired event objects
+            unsigned long acquireCount;
+            // count of acquired event objects which have been taken from the pool
+            unsigned long hitCount;
+            // count of event objects currently in use
+            unsigned long inUseCount;
+            // max. count of event objects in use at the same time
+            unsigned long highWaterMark;
+        };
+
+        // maxIdleCount: max. count of unused event objects held per event type
+        EventTypeDataPool(EventTypeRegistry& eventTypeRegistry, int maxIdleCount)
+        /* throws MutexException */;
+        // The event objects must have been released.
+        virtual ~EventTypeDataPool();
+
+        // Returns an event object without field data.
+        // The event object must be returned with method "release".
+        virtual EventTypeData* acquire(const UaNodeId& eventTypeNodeId);
+        // Returns an event object to the pool (e.g. after it has been fired).
+        virtual void release(EventTypeData* eventData);
+
+        // Returns a cached field of an event type or NULL if the field has not been cached yet.
+        // The returned instance is valid for the lifetime of the pool.
+        virtual const Field* getField(const UaNodeId& eventTypeNodeId,
+                const IODataProviderNamespace::NodeId& ioFieldNodeId);
+        // Caches a field of an event type. The index of the field is read from the event type
+        // registry. If the field has already been cached the existing instance is returned.
+        // The returned instance is valid for the lifetime of the pool.
+        virtual const Field* addField(const UaNodeId& eventTypeNodeId,
+                const IODataProviderNamespace::NodeId& ioFieldNodeId, const UaNodeId& fieldNodeId,
+                const UaNodeId& dataTypeId);
+
+        virtual Metrics getMetrics();
+    private:
+        EventTypeDataPool(const EventTypeDataPool&);
+        EventTypeDataPool& operator=(const EventTypeDataPool&);
+
+        EventTypeDataPoolPrivate* d;
+    };
+
+} // namespace SASModelProviderNamespace
+#endif /* SASMODELPROVIDER_BASE_EVENTTYPEDATAPOOL_H_ */
@@ -8,6 +8,11 @@ namespace SASModelProviderNamespace {
 
     class EventTypeRegistryPrivate;
 
+    // Provides the nodeIds of event fields via a table indexed by the event type index and
+    // the field index. The table contains the fields of the super types and is updated
+    // when event types or fields are registered. The lookups and the registrations are
+    // synchronized via one mutex of the registry.
+    // This class is thread safe.
     class EventTypeRegistry {
     public:
         EventTypeRegistry();
@@ -20,8 +25,21 @@ namespace SASModelProviderNamespace {
         // Copies of the parameter values are stored internally.
         virtual void registerEventField(const UaNodeId& eventTypeId,
                 const UaNodeId& fieldNodeId, const UaQualifiedName& filterName);
-        virtual const UaNodeId* getEventFieldNodeId(const UaNodeId& eventTypeId,
+        // Returns the index of an event type for method getEventFieldNodeId or -1 if neither
+        // the type nor a field of the type has been registered.
+        virtual int getEventTypeIndex(const UaNodeId& eventTypeId);
+        // Returns a copy of the nodeId of an event field of the event type or its super types
+        // or a null nodeId if the field has not been registered.
+        // (a copy is returned because the field may be registered again concurrently)
+        virtual UaNodeId getEventFieldNodeId(int eventTypeIndex, OpcUa_UInt32 fieldIndex);
+        virtual UaNodeId getEventFieldNodeId(const UaNodeId& eventTypeId,
                 OpcUa_UInt32 fieldIndex);
+        // Returns the index of an event field of the event type or its super types or -1 if the
+        // field has not been registered.
+        virtual int getEventFieldIndex(int eventTypeIndex, const UaNodeId& fieldNodeId);
+        // Returns the size of the field table row of an event type (the highest registered
+        // field index of the type and its super types + 1).
+        virtual OpcUa_UInt32 getEventFieldCount(int eventTypeIndex);
     private:
         EventTypeRegistry(const EventTypeRegistry&);
         EventTypeRegistry& operator=(const EventTypeRegistry&);
@@ -8,6 +8,7 @@
 #include <nodemanager.h> // NodeManager
 #include <nodemanagerbase.h> // NodeManagerBase
 #include <uastructuredefinition.h> // UaStructureDefinition
+#include <vector>
 
 namespace SASModelProviderNamespace {
 
@@ -42,6 +43,14 @@ namespace SASModelProviderNamespace {
         virtual const UaString& getDefaultLocaleId() const = 0;
         virtual void setVariable(UaVariable& variable,
                 UaVariant& newValue) = 0 /* throws HaNodeManagerException */;
+        // Sets the values of several variables while holding the node lock once.
+        // All variables get the same time stamps. If a value cannot be set then the
+        // remaining values are set nevertheless and an exception for the first failed
+        // variable is thrown afterwards.
+        // The change handling (e.g. data change notifications) is still done per variable
+        // by the SDK while the value is set.
+        virtual void setVariables(const std::vector<UaVariable*>& variables,
+                const std::vector<UaVariant*>& newValues) = 0 /* throws HaNodeManagerException */;
     };
 
 } // namespace SASModelProviderNamespace
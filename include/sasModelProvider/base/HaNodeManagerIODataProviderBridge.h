@@ -1,8 +1,13 @@
 #ifndef SASMODELPROVIDER_BASE_HANODEMANAGERIOBRIDGE_H
 #define SASMODELPROVIDER_BASE_HANODEMANAGERIOBRIDGE_H
 
+#include "DemandSubscriptionManager.h"
 #include "HaNodeManager.h"
 #include "IODataManager.h"
+#include "IngressFilter.h"
+#include "PollScheduler.h"
+#include "SingleFlightReader.h"
+#include "WriteBehindQueue.h"
 #include <ioDataProvider/IODataProvider.h>
 #include <ioDataProvider/Scalar.h>
 #include <iomanageruanode.h> // UaVariableArray
@@ -14,6 +19,8 @@
 #include <uadatavalue.h> // UaDataValueArray
 #include <uanodeid.h> // UaNodeId
 #include <uavariant.h> // UaVariant
+#include <map>
+#include <string>
 #include <vector>
 #include <uaargument.h> // UaArgument
 
@@ -24,8 +31,73 @@ namespace SASModelProviderNamespace {
     class HaNodeManagerIODataProviderBridge : public IODataManager,
     public MethodManager {
     public:
+
+        class Configuration {
+        public:
+            Configuration();
+
+            // max. delay in milliseconds of values set via beforeSetAttributeValue
+            // (0: the values are written synchronously)
+            long writeBehindWindow;
+            // count of queued values which triggers the writing
+            int writeBehindMaxBatchSize;
+            // The ingress filter settings are used for asynchronous variables without an
+            // ingress filter in their node properties (see NodeProperties::setIngressFilter).
+            // suppress received values of asynchronous variables which equal the last value
+            bool ingressSuppressEqualValues;
+            // absolute deadband for received numeric values of asynchronous variables
+            // (0: disabled)
+            double ingressAbsoluteDeadband;
+            // deadband in percent of the EURange of a variable; overrides the absolute
+            // deadband for variables with an EURange property (0: disabled)
+            double ingressPercentDeadband;
+            // subscribe asynchronous variables at the IO data provider only while they
+            // are monitored by clients; the values of unmonitored variables are read from
+            // the IO data provider on request
+            bool demandSubscriptions;
+            // delay in milliseconds for collecting monitoring changes before the
+            // IO data provider is called
+            long demandSubscriptionDebounceTime;
+            // poll monitored synchronous variables in groups per sampling interval and
+            // answer reads within the interval from the server cache
+            bool pollGroups;
+            // min. poll interval in milliseconds
+            long pollMinInterval;
+            // share the reads of nodes which are already being read by other threads
+            bool readCoalescing;
+            // time in milliseconds for answering back-to-back reads of a node with the last
+            // read value (0: disabled); requires read coalescing
+            long readFreshnessWindow;
+            // namespace URI -> freshness window which overrides readFreshnessWindow
+            std::map<std::string, long> namespaceReadFreshnessWindows;
+            // skip received events while no event monitored item exists
+            bool skipUnmonitoredEvents;
+            // generate the values of variables, the output arguments of methods and events
+            // instead of using the IO data provider (e.g. for load tests)
+            bool dataGenerator;
+            // max. count of subscribed variables whose values are changed (0: all)
+            long generatorVariableCount;
+            // value changes per second and subscribed variable
+            double generatorVariableChangeRate;
+            // max. count of subscribed event types for which events are fired (0: all)
+            long generatorEventTypeCount;
+            // events per second and subscribed event type
+            double generatorEventRate;
+            // processing time of method calls in milliseconds
+            long generatorMethodLatency;
+        };
+
+        class EventMonitoringMetrics {
+        public:
+            // count of existing event monitored items
+            unsigned long monitoredItemCount;
+            // count of events which have been skipped due to missing event monitored items
+            unsigned long skippedEventCount;
+        };
+
         HaNodeManagerIODataProviderBridge(HaNodeManager& nodeManager,
-                IODataProviderNamespace::IODataProvider& ioDataProvider);
+                IODataProviderNamespace::IODataProvider& ioDataProvider,
+                const Configuration& conf = Configuration());
         virtual ~HaNodeManagerIODataProviderBridge();
 
         // interface IODataManager
@@ -43,6 +115,15 @@ namespace SASModelProviderNamespace {
         virtual void variableCacheMonitoringChanged(UaVariableCache* pVariable,
                 IOManager::TransactionType transactionType);
 
+        // Is called by the node manager after an event monitored item has been created
+        // (isStarted=true) or deleted (isStarted=false).
+        virtual void eventMonitoringChanged(bool isStarted);
+        // Returns whether received events shall be processed. If skipping of unmonitored events
+        // is disabled then true is returned.
+        virtual bool isEventMonitored();
+        // Is called when an event is dropped because isEventMonitored returned false.
+        virtual void eventSkipped();
+
         // interface MethodManager
         virtual UaStatus beginCall(MethodManagerCallback* pCallback,
                 const ServiceContext& serviceContext, OpcUa_UInt32 callbackHandle,
@@ -59,6 +140,25 @@ namespace SASModelProviderNamespace {
         virtual void updateValueHandling(const std::vector<UaVariable*>& variables)
         /* throws HaNodeManagerIODataProviderBridgeException */;
 
+        // Gets the metrics of the write behind queue.
+        // If the values are written synchronously then all counters are 0.
+        virtual WriteBehindQueue::Metrics getWriteBehindMetrics();
+        // Gets the metrics of the ingress filter for asynchronous variables.
+        // If no filter is configured then all counters are 0.
+        virtual IngressFilter::Metrics getIngressFilterMetrics();
+        // Gets the metrics of the demand driven subscriptions.
+        // If the variables are subscribed at start up then all counters are 0.
+        virtual DemandSubscriptionManager::Metrics getDemandSubscriptionMetrics();
+        // Gets the metrics of the poll groups.
+        // If polling is disabled then all counters are 0.
+        virtual PollScheduler::Metrics getPollMetrics();
+        // Gets the metrics of the read coalescing.
+        // If read coalescing is disabled then all counters are 0.
+        virtual SingleFlightReader::Metrics getReadCoalescingMetrics();
+        // Gets the metrics of the event monitoring.
+        // If skipping of unmonitored events is disabled then all counters are 0.
+        virtual EventMonitoringMetrics getEventMonitoringMetrics();
+
         // Converts a NodeId to a UaNodeId.
         // The returned UaNodeId instance must be destroyed by the caller.
         virtual UaNodeId* convert(const IODataProviderNamespace::NodeId& nodeId) const;
@@ -69,6 +169,9 @@ namespace SASModelProviderNamespace {
         // The returned UaVariant instance must be destroyed by the caller.
         virtual UaVariant* convert(const IODataProviderNamespace::Variant& value,
                 const UaNodeId& dataTypeId); /* throws ConversionException */
+        // Converts a Variant to the UaVariant "dest". A previous value of "dest" is replaced.
+        virtual void convert(const IODataProviderNamespace::Variant& value,
+                const UaNodeId& dataTypeId, UaVariant& dest); /* throws ConversionException */
         // Converts a UaVariant to a Variant.
         // The returned Variant instance must be destroyed by the caller.
         virtual IODataProviderNamespace::Variant* convert(const UaVariant& value,
@@ -2,6 +2,7 @@
 #define SASMODELPROVIDER_BASE_IODATAPROVIDERSUBSCRIBERCALLBACK_H_
 
 #include "HaNodeManager.h"
+#include "IngressFilter.h"
 #include <ioDataProvider/SubscriberCallback.h>
 
 namespace SASModelProviderNamespace {
@@ -10,12 +11,20 @@ class IODataProviderSubscriberCallbackPrivate;
 
 class IODataProviderSubscriberCallback: public IODataProviderNamespace::SubscriberCallback {
 public:
-	IODataProviderSubscriberCallback(HaNodeManager& haNodeManager);
+	// Received values are filtered with the ingress filter before they are converted
+	// (NULL: no filtering). A reference to the ingress filter is saved internally.
+	IODataProviderSubscriberCallback(HaNodeManager& haNodeManager,
+			IngressFilter* ingressFilter = NULL);
 	virtual ~IODataProviderSubscriberCallback();
 
 	// interface SubscriberCallback
 	virtual void valuesChanged(
 			const IODataProviderNamespace::Event& event) /* throws SubscriberCallbackException */;
+	// Returns false while no event monitored item exists and unmonitored events shall be
+	// skipped (see HaNodeManagerIODataProviderBridge::Configuration::skipUnmonitoredEvents).
+	virtual bool isEventMonitored(const IODataProviderNamespace::NodeId& eventTypeId);
+	// Counts the skipped event (see HaNodeManagerIODataProviderBridge::eventSkipped).
+	virtual void eventSkipped(const IODataProviderNamespace::NodeId& eventTypeId);
 private:
 	IODataProviderSubscriberCallback(const IODataProviderSubscriberCallback&);
 	IODataProviderSubscriberCallback& operator=(
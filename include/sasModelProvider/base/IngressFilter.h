@@ -0,0 +1,60 @@
+#ifndef SASMODELPROVIDER_BASE_INGRESSFILTER_H_
+#define SASMODELPROVIDER_BASE_INGRESSFILTER_H_
+
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+
+namespace SASModelProviderNamespace {
+
+    class IngressFilterPrivate;
+
+    // Filters the values received from an IO data provider before they are converted and
+    // set to the server cache. A value is suppressed if it equals the last committed value or
+    // if a numeric value does not leave the deadband around the last committed value.
+    // A passed value must be committed after it has been set to the server cache, so a value
+    // which cannot be set does not suppress the next equal value.
+    // Nodes without a filter, values with exceptions and non-scalar values always pass.
+    // This class is thread safe.
+    class IngressFilter {
+    public:
+
+        class Metrics {
+        public:
+            // count of values which have passed a filter
+            unsigned long passedCount;
+            // count of values which have been suppressed due to equality
+            unsigned long suppressedEqualCount;
+            // count of values which have been suppressed due to a deadband
+            unsigned long suppressedDeadbandCount;
+        };
+
+        IngressFilter() /* throws MutexException */;
+        virtual ~IngressFilter();
+
+        // Adds or replaces the filter for a node.
+        // suppressEqualValues: values which equal the last committed value are suppressed
+        // deadband: numeric values are suppressed if the absolute difference to the last
+        //   committed value does not exceed the deadband (0: disabled)
+        virtual void setFilter(const IODataProviderNamespace::NodeId& nodeId,
+                bool suppressEqualValues, double deadband);
+        virtual void removeFilter(const IODataProviderNamespace::NodeId& nodeId);
+        // Forgets the last committed value of a node. The next value of the node passes.
+        virtual void reset(const IODataProviderNamespace::NodeId& nodeId);
+        // Returns whether a value shall be processed.
+        virtual bool pass(const IODataProviderNamespace::NodeData& nodeData);
+        // Saves a value which has been set to the server cache as reference for the next
+        // values of the node.
+        virtual void commit(const IODataProviderNamespace::NodeData& nodeData);
+        // Returns the count of filtered nodes.
+        virtual int size();
+
+        virtual Metrics getMetrics();
+    private:
+        IngressFilter(const IngressFilter&);
+        IngressFilter& operator=(const IngressFilter&);
+
+        IngressFilterPrivate* d;
+    };
+
+} // namespace SASModelProviderNamespace
+#endif /* SASMODELPROVIDER_BASE_INGRESSFILTER_H_ */
@@ -11,11 +11,28 @@ namespace SASModelProviderNamespace {
 
     class NodeBrowserPrivate;
 
+    // Provides the nodes of a node manager and its associated node managers.
+    // The node managers are resolved via a table indexed by the namespace index and
+    // the found variables are cached. The tables and caches of all node browsers are
+    // updated when a node manager starts or stops.
+    // The super types of all data types and object types are held in a type hierarchy
+    // which is shared by all node browsers. It is built when a node manager starts.
+    // This class is thread safe.
     class NodeBrowser {
     public:
         NodeBrowser(HaNodeManager& nodeManager);
         virtual ~NodeBrowser();
 
+        // Must be called after a node manager has been started.
+        static void nodeManagerStarted(HaNodeManager& nodeManager)
+        /* throws NodeBrowserException */;
+        // Must be called before a node manager is stopped. The references to cached variables
+        // are released.
+        static void nodeManagerStopped(HaNodeManager& nodeManager);
+        // Must be called before a node is deleted (see method "deleteUaNode" of the
+        // node managers). The reference to the cached variable is released.
+        static void nodeDeleted(const UaNodeId& nodeId);
+
         // If an object is found for the nodeId, the reference count of the object is 
         // incremented. The caller must release the reference with method "releaseReference"
         // when the object is no longer needed.
@@ -49,8 +66,14 @@ namespace SASModelProviderNamespace {
         // Returns the super types incl. the first one in namespace 0 starting with the nearest parent.
         virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& typeId)
         /* throws NodeBrowserException */;
+        // Returns the last super type of getSuperTypes or the type itself if it is a type of
+        // namespace 0. If no super type exists then a null UaNodeId is returned.
+        virtual UaNodeId getBuildInType(const UaNodeId& typeId) /* throws NodeBrowserException */;
 
     private:
+        NodeBrowser(const NodeBrowser&);
+        NodeBrowser& operator=(const NodeBrowser&);
+
         NodeBrowserPrivate* d;
     };
 
@@ -0,0 +1,89 @@
+#ifndef SASMODELPROVIDER_BASE_POLLSCHEDULER_H_
+#define SASMODELPROVIDER_BASE_POLLSCHEDULER_H_
+
+#include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <vector>
+
+namespace SASModelProviderNamespace {
+
+    class PollSchedulerPrivate;
+
+    // Polls monitored nodes from an IO data provider in poll groups.
+    // A node joins the group for the fastest sampling interval requested by its monitored
+    // items. It changes the group if the fastest interval changes due to a stopped or
+    // modified monitored item and leaves it after its last monitored item stops. Each group is read with one
+    // batched read per interval by a separate thread. The first ticks of the groups are
+    // staggered to avoid bursts of reads.
+    // This class is thread safe.
+    class PollScheduler {
+    public:
+
+        class PollCallback {
+        public:
+            PollCallback();
+            virtual ~PollCallback();
+
+            // Is called by the polling thread with the read values of a group. The values
+            // contain the exceptions of failed nodes.
+            // References to the parameter values must not be saved in the implementation.
+            virtual void polled(const std::vector<IODataProviderNamespace::NodeData*>& values) = 0;
+            // Is called by the polling thread if the read of a group failed.
+            // References to the parameter values must not be saved in the implementation.
+            virtual void pollFailed(
+                    const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds,
+                    const IODataProviderNamespace::IODataProviderException& exception) = 0;
+        };
+
+        class Metrics {
+        public:
+            // count of batched reads
+            unsigned long pollCount;
+            // count of failed batched reads
+            unsigned long failedPollCount;
+            // count of read nodes
+            unsigned long polledNodeCount;
+            // count of polls which took longer than the interval of the group
+            unsigned long overrunCount;
+        };
+
+        // minInterval: min. poll interval in milliseconds
+        // A reference to the callback is saved internally.
+        PollScheduler(IODataProviderNamespace::IODataProvider& ioDataProvider, long minInterval,
+                PollCallback* callback) /* throws MutexException */;
+        // Stops the polling thread.
+        virtual ~PollScheduler();
+
+        // Is called when a monitored item for a node begins.
+        // samplingInterval: requested sampling interval in milliseconds
+        virtual void monitoringStarted(const IODataProviderNamespace::NodeId& nodeId,
+                long samplingInterval);
+        // Is called when a monitored item for a node stops.
+        // samplingInterval: fastest sampling interval of the remaining monitored items in
+        //                   milliseconds (0: the interval of the node is not changed)
+        virtual void monitoringStopped(const IODataProviderNamespace::NodeId& nodeId,
+                long samplingInterval = 0);
+        // Is called when the sampling interval of a monitored item for a node is modified.
+        // samplingInterval: fastest sampling interval of all monitored items in milliseconds
+        virtual void monitoringModified(const IODataProviderNamespace::NodeId& nodeId,
+                long samplingInterval);
+        // Returns whether the last successful poll of a node is not older than the
+        // interval of its group.
+        virtual bool isFresh(const IODataProviderNamespace::NodeId& nodeId);
+        // Returns the interval of the group of a node or 0 if the node is not polled.
+        virtual long getInterval(const IODataProviderNamespace::NodeId& nodeId);
+        // Returns the count of poll groups.
+        virtual int getGroupCount();
+
+        virtual Metrics getMetrics();
+    private:
+        PollScheduler(const PollScheduler&);
+        PollScheduler& operator=(const PollScheduler&);
+
+        PollSchedulerPrivate* d;
+    };
+
+} // namespace SASModelProviderNamespace
+#endif /* SASMODELPROVIDER_BASE_POLLSCHEDULER_H_ */
@@ -0,0 +1,59 @@
+#ifndef SASMODELPROVIDER_BASE_SINGLEFLIGHTREADER_H_
+#define SASMODELPROVIDER_BASE_SINGLEFLIGHTREADER_H_
+
+#include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <vector>
+
+namespace SASModelProviderNamespace {
+
+    class SingleFlightReaderPrivate;
+
+    // Coalesces concurrent reads of the same nodes from an IO data provider.
+    // A node which is already being read by another thread is not read again: the calling
+    // thread waits for the running read and gets a copy of its result. Only the remaining
+    // nodes are read with one call of the IO data provider.
+    // Optionally successfully read values are returned for a short freshness window without
+    // calling the IO data provider again.
+    // This class is thread safe.
+    class SingleFlightReader {
+    public:
+
+        class Metrics {
+        public:
+            // count of reads via the IO data provider
+            unsigned long readCallCount;
+            // count of nodes read via the IO data provider
+            unsigned long readNodeCount;
+            // count of nodes whose values have been taken from the read of another thread
+            unsigned long sharedCount;
+            // count of nodes whose values have been returned within the freshness window
+            unsigned long freshCount;
+        };
+
+        // freshnessWindow: time in milliseconds for returning read values without calling the
+        //                  IO data provider again (0: disabled)
+        SingleFlightReader(IODataProviderNamespace::IODataProvider& ioDataProvider,
+                long freshnessWindow) /* throws MutexException */;
+        virtual ~SingleFlightReader();
+
+        // Reads the values of nodes.
+        // The returned node data are in the order of the nodeIds. If the IO data provider fails
+        // or does not return a node then the node data contain a bad status code.
+        // The returned vector and its elements must be deleted by the caller.
+        virtual std::vector<IODataProviderNamespace::NodeData*>* read(
+                const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds);
+        // Removes the value of a node from the freshness window (e.g. after a write).
+        virtual void invalidate(const IODataProviderNamespace::NodeId& nodeId);
+
+        virtual Metrics getMetrics();
+    private:
+        SingleFlightReader(const SingleFlightReader&);
+        SingleFlightReader& operator=(const SingleFlightReader&);
+
+        SingleFlightReaderPrivate* d;
+    };
+
+} // namespace SASModelProviderNamespace
+#endif /* SASMODELPROVIDER_BASE_SINGLEFLIGHTREADER_H_ */
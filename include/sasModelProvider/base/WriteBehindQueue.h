@@ -0,0 +1,79 @@
+#ifndef SASMODELPROVIDER_BASE_WRITEBEHINDQUEUE_H_
+#define SASMODELPROVIDER_BASE_WRITEBEHINDQUEUE_H_
+
+#include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <vector>
+
+namespace SASModelProviderNamespace {
+
+    class WriteBehindQueuePrivate;
+
+    // Collects single writes to an IO data provider and sends them as one batched write.
+    // Queued values are coalesced per node (the last value wins). The queue is flushed
+    // by a separate thread after a time window (starting with the first queued value) or
+    // if the size threshold is reached.
+    // This class is thread safe.
+    class WriteBehindQueue {
+    public:
+
+        class StatusCallback {
+        public:
+            StatusCallback();
+            virtual ~StatusCallback();
+
+            // Is called by the flushing thread if a batched write failed.
+            // References to the parameter values must not be saved in the implementation.
+            virtual void writeFailed(
+                    const std::vector<const IODataProviderNamespace::NodeData*>& nodeData,
+                    const IODataProviderNamespace::IODataProviderException& exception) = 0;
+        };
+
+        class Metrics {
+        public:
+            // count of batched writes
+            unsigned long batchCount;
+            // count of failed batched writes
+            unsigned long failedBatchCount;
+            // count of values sent to the IO data provider
+            unsigned long valueCount;
+            // count of values which have been replaced by a newer value before sending
+            unsigned long coalescedCount;
+            unsigned long maxBatchSize;
+            // count of batched writes per batch size:
+            // index i counts batch sizes in range [2^i, 2^(i+1))
+            static const int BATCH_SIZE_BUCKETS = 12;
+            unsigned long batchSizes[BATCH_SIZE_BUCKETS];
+        };
+
+        // window: max. delay of a queued value in milliseconds
+        // maxBatchSize: count of queued nodes which triggers a flush
+        // A reference to the callback is saved internally.
+        WriteBehindQueue(IODataProviderNamespace::IODataProvider& ioDataProvider, long window,
+                int maxBatchSize, StatusCallback* callback) /* throws MutexException */;
+        // Flushes the queue and stops the flushing thread.
+        virtual ~WriteBehindQueue();
+
+        // Enqueues a value. An already queued value for the same node is replaced.
+        // The responsibility for destroying the node data is delegated to the queue.
+        virtual void enqueue(const IODataProviderNamespace::NodeData* nodeData);
+        // Writes all queued values in the current thread.
+        // Failures are reported via the status callback.
+        virtual void flush();
+        // Returns the count of queued values.
+        virtual int size();
+        // Returns true if a value is queued for at least one of the nodes.
+        virtual bool isQueued(const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds);
+
+        virtual Metrics getMetrics();
+    private:
+        WriteBehindQueue(const WriteBehindQueue&);
+        WriteBehindQueue& operator=(const WriteBehindQueue&);
+
+        WriteBehindQueuePrivate* d;
+    };
+
+} // namespace SASModelProviderNamespace
+#endif /* SASMODELPROVIDER_BASE_WRITEBEHINDQUEUE_H_ */
@@ -4,10 +4,12 @@
 #include "logging/ServerSdkLoggerFactory.h"
 #include "utilities/linux.h" // RegisterSignalHandler
 #include <common/Exception.h> // ExceptionDef
+#include <common/ScopeGuard.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <ioDataProvider/IODataProviderException.h>
 #include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/IODataProviderGroup.h>
 #include <sasModelProvider/SASModelProvider.h>
 #include <sasModelProvider/SASModelProviderException.h>
 #include <ualocalizedtext.h> // UaLocalizedText
@@ -18,6 +20,7 @@
 #include <algorithm>  // std::sort
 #include <dirent.h> // opendir
 #include <dlfcn.h> // dlopen
+#include <fstream> // std::ifstream
 #include <sstream> // std::ostringstream
 #include <vector>
 #include <config.h>  // SERVER_VERSION (generated by cmake)
@@ -45,8 +48,19 @@ private:
     std::vector<void *> libHandles;
     std::map<IODataProviderNamespace::IODataProviderFactory*, destroyIODataProviderFactory_t*> ioDataProviderFactories;
     std::vector<IODataProviderNamespace::IODataProvider*> ioDataProviders;
+    IODataProviderNamespace::IODataProviderGroup* ioDataProviderGroup;
     std::map<SASModelProviderNamespace::SASModelProviderFactory*, destroySASModelProviderFactory_t*> sasModelProviderFactories;
     std::vector<SASModelProviderNamespace::SASModelProvider*> sasModelProviders;
+
+    // Reads the routing table for the IO data provider group.
+    // Each line of the file contains a route to the first IO data provider of a module:
+    //   <moduleName> namespace <namespaceUri>
+    //   <moduleName> prefix <namespaceIndex> <nodeIdPrefix>
+    // Empty lines and lines starting with '#' are ignored.
+    // If the file does not exist then all nodes are routed to the first IO data provider.
+    void addIODataProviderRoutes(const std::string& routingFile,
+            std::map<std::string, IODataProviderNamespace::IODataProvider*>& moduleProviders)
+    /* throws ServerException, IODataProviderException */;
 };
 
 Server::Server(OpcUa_UInt shutdownDelay) {
@@ -55,6 +69,7 @@ Server::Server(OpcUa_UInt shutdownDelay) {
     d->confPath = "/etc/opcua";
     d->providerPath = "/usr/lib/provider/";
     d->shutdownDelay = shutdownDelay;
+    d->ioDataProviderGroup = NULL;
 }
 
 Server::~Server() {
@@ -173,17 +188,13 @@ void Server::open()/*throws ServerException, IODataProviderException, SASModelPr
             createIODataProviderFactory_t* createIODataProviderFactoryDlsym
                     = (createIODataProviderFactory_t*) dlsym(libHandle, "createIODataProviderFactory");
             if (createIODataProviderFactoryDlsym != NULL) {
-                if (ioDataProviderFactories.size() == 0) {
-                    d->log->info("Found IO data provider factory in %s", libFile);
-                    // create factory
-                    IODataProviderNamespace::IODataProviderFactory* providerFactory = createIODataProviderFactoryDlsym();
-                    ioDataProviderFactories[moduleName] = providerFactory;
-                    ServerPrivate::destroyIODataProviderFactory_t* destroyIODataProviderFactoryDlsym
-                            = (ServerPrivate::destroyIODataProviderFactory_t*) dlsym(libHandle, "destroyIODataProviderFactory");
-                    d->ioDataProviderFactories[providerFactory] = destroyIODataProviderFactoryDlsym;
-                } else {
-                    d->log->info("Ignoring IO data provider factory in %s", libFile);
-                }
+                d->log->info("Found IO data provider factory in %s", libFile);
+                // create factory
+                IODataProviderNamespace::IODataProviderFactory* providerFactory = createIODataProviderFactoryDlsym();
+                ioDataProviderFactories[moduleName] = providerFactory;
+                ServerPrivate::destroyIODataProviderFactory_t* destroyIODataProviderFactoryDlsym
+                        = (ServerPrivate::destroyIODataProviderFactory_t*) dlsym(libHandle, "destroyIODataProviderFactory");
+                d->ioDataProviderFactories[providerFactory] = destroyIODataProviderFactoryDlsym;
             }
 
             createSASModelProviderFactory_t* createSASModelProviderFactoryDlsym
@@ -204,33 +215,34 @@ void Server::open()/*throws ServerException, IODataProviderException, SASModelPr
                 }
             }
         }
-        // open IO data provider
+        // open IO data providers
+        // module name -> first IO data provider of the module
+        std::map<std::string, IODataProviderNamespace::IODataProvider*> moduleProviders;
         for (std::map<std::string, IODataProviderNamespace::IODataProviderFactory*>::iterator i
                 = ioDataProviderFactories.begin(); i != ioDataProviderFactories.end(); i++) {
             std::string moduleName = (*i).first;
             IODataProviderNamespace::IODataProviderFactory& providerFactory = *(*i).second;
             // create providers
-            std::vector<IODataProviderNamespace::IODataProvider*>& providers =
-                    *providerFactory.create();
+            std::vector<IODataProviderNamespace::IODataProvider*>* providers =
+                    providerFactory.create();
+            ScopeGuard<std::vector<IODataProviderNamespace::IODataProvider*> > providersSG(
+                    providers);
+            // the providers are closed and deleted via method "close"
+            d->ioDataProviders.insert(d->ioDataProviders.end(), providers->begin(),
+                    providers->end());
+            if (providers->size() > 0) {
+                moduleProviders[moduleName] = providers->front();
+            }
             // open providers
             std::string moduleConfDir(providerConfDir.toUtf8());
             moduleConfDir += moduleName + '/';
-            std::vector<IODataProviderNamespace::IODataProvider*>::iterator iter;
-            try {
-                for (iter = providers.begin(); iter != providers.end(); iter++) {
-                    if (d->env != NULL) {
-                    	(*iter)->open(d->env, d->properties, d->dataProvider);
-                    } else {
-                    	(*iter)->open(moduleConfDir); // IODataProviderException
-                    }
-                    //TODO handle all providers
-                    iter++;
-                    break;
+            for (std::vector<IODataProviderNamespace::IODataProvider*>::iterator iter =
+                    providers->begin(); iter != providers->end(); iter++) {
+                if (d->env != NULL) {
+                    (*iter)->open(d->env, d->properties, d->dataProvider);
+                } else {
+                    (*iter)->open(moduleConfDir); // IODataProviderException
                 }
-                d->ioDataProviders.insert(d->ioDataProviders.end(), providers.begin(), iter);
-            } catch (IODataProviderNamespace::IODataProviderException& e) {
-                d->ioDataProviders.insert(d->ioDataProviders.end(), providers.begin(), iter);
-                throw e;
             }
         }
 
@@ -239,9 +251,13 @@ void Server::open()/*throws ServerException, IODataProviderException, SASModelPr
             msg << "No IO data provider library found in " << providerLibDir.c_str();
             throw ExceptionDef(ServerException, msg.str());
         }
-        //TODO create group of IO data providers:
-        //       class IODataProviderGroup implementing IODataProvider interface
-        IODataProviderNamespace::IODataProvider* ioDataProvider = d->ioDataProviders.at(0);
+        // create group of IO data providers: the nodes are routed to the providers
+        // via the routing table
+        d->ioDataProviderGroup = new IODataProviderNamespace::IODataProviderGroup(
+                d->ioDataProviders);
+        d->addIODataProviderRoutes(std::string(providerConfDir.toUtf8()) + "IODataProviderRouting.conf",
+                moduleProviders); // ServerException, IODataProviderException
+        IODataProviderNamespace::IODataProvider* ioDataProvider = d->ioDataProviderGroup;
         // open SAS model provider
         for (std::map<std::string, SASModelProviderNamespace::SASModelProviderFactory*>::iterator i
                 = sasModelProviderFactories.begin(); i != sasModelProviderFactories.end(); i++) {
@@ -299,17 +315,18 @@ void Server::open()/*throws ServerException, IODataProviderException, SASModelPr
 }
 
 void Server::notification(JNIEnv *env, int ns, jobject id, jobject msg){
-	   for (std::vector<IODataProviderNamespace::IODataProvider*>::iterator i =
-	           d->ioDataProviders.begin(); i != d->ioDataProviders.end(); i++) {
-		   (*i)->notification(env, ns, id, msg);
-	   }
+	// the notification is routed to the provider of the namespace
+	if (d->ioDataProviderGroup != NULL) {
+		d->ioDataProviderGroup->notification(env, ns, id, msg);
+	}
 }
 
 void Server::event(JNIEnv *env, int eNs, jobject event, int pNs, jobject param, long timestamp, int severity, jstring msg, jobject value){
-	   for (std::vector<IODataProviderNamespace::IODataProvider*>::iterator i =
-	           d->ioDataProviders.begin(); i != d->ioDataProviders.end(); i++) {
-		   (*i)->event(env, eNs, event, pNs, param, timestamp, severity, msg, value);
-	   }
+	// the event is routed to the provider of the namespace of the event type
+	if (d->ioDataProviderGroup != NULL) {
+		d->ioDataProviderGroup->event(env, eNs, event, pNs, param, timestamp, severity, msg,
+				value);
+	}
 }
 
 void Server::close() {
@@ -339,6 +356,9 @@ void Server::close() {
 	   }
 	   d->sasModelProviderFactories.clear();
 
+	   // delete the group of IO data providers (the providers are not attached)
+	   delete d->ioDataProviderGroup;
+	   d->ioDataProviderGroup = NULL;
 	   // close and delete IO data providers
 	   for (std::vector<IODataProviderNamespace::IODataProvider*>::iterator i =
 	           d->ioDataProviders.begin(); i != d->ioDataProviders.end(); i++) {
@@ -370,3 +390,54 @@ void Server::close() {
 	   // clean up the XML parser
 	   UaXmlDocument::cleanupParser();
 }
+
+void ServerPrivate::addIODataProviderRoutes(const std::string& routingFile,
+        std::map<std::string, IODataProviderNamespace::IODataProvider*>& moduleProviders)
+/* throws ServerException, IODataProviderException */ {
+    std::ifstream in(routingFile.c_str());
+    if (!in.is_open()) {
+        return;
+    }
+    log->info("Reading routes for IO data providers from %s", routingFile.c_str());
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string moduleName;
+        std::string routeType;
+        if (!(fields >> moduleName) || moduleName[0] == '#') {
+            continue;
+        }
+        std::map<std::string, IODataProviderNamespace::IODataProvider*>::iterator provider =
+                moduleProviders.find(moduleName);
+        bool isValid = (fields >> routeType) && provider != moduleProviders.end();
+        if (isValid && routeType == "namespace") {
+            std::string namespaceUri;
+            isValid = fields >> namespaceUri;
+            if (isValid) {
+                ioDataProviderGroup->addNamespaceRoute(namespaceUri,
+                        *(*provider).second); // IODataProviderException
+                log->info("Routing namespace %s to IO data provider of module %s",
+                        namespaceUri.c_str(), moduleName.c_str());
+            }
+        } else if (isValid && routeType == "prefix") {
+            int namespaceIndex;
+            std::string prefix;
+            isValid = fields >> namespaceIndex >> prefix;
+            if (isValid) {
+                ioDataProviderGroup->addNodeIdPrefixRoute(namespaceIndex, prefix,
+                        *(*provider).second); // IODataProviderException
+                log->info("Routing nodes with prefix %s in namespace %d to IO data provider of module %s",
+                        prefix.c_str(), namespaceIndex, moduleName.c_str());
+            }
+        } else {
+            isValid = false;
+        }
+        if (!isValid) {
+            std::ostringstream msg;
+            msg << "Invalid route in " << routingFile.c_str() << ":" << lineNumber << ": " << line;
+            throw ExceptionDef(ServerException, msg.str());
+        }
+    }
+}
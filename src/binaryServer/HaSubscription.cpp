@@ -5,6 +5,7 @@
 #include <common/MutexLock.h>
 #include <common/ScopeGuard.h>
 #include <common/VectorScopeGuard.h>
+#include <common/logging/LogThrottle.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <statuscode.h> // UaStatus
@@ -473,36 +474,53 @@ void HaSubscriptionPrivate::dataChange(OpcUa_UInt32 clientSubscriptionHandle,
                 = monitoredItems.find(dataNotifications[i].ClientHandle);
         // if a subscription for the nodeId exists
         if (it != monitoredItems.end()) {
-            std::vector<NodeAttributes*>* nodeAttributes = new std::vector<NodeAttributes*>();
-            VectorScopeGuard<NodeAttributes> nodeAttributesSG(nodeAttributes);
-            // maybe there are several notifications for one monitored item 
-            // => the existing node attribute list cannot be used directly
-            NodeAttributes* nodeAttrWithValues = new NodeAttributes(*it->second->nodeAttr);
+            NodeAttributes& monitoredNodeAttr = *it->second->nodeAttr;
+            // maybe there are several notifications for one monitored item
+            // => the existing node attributes cannot be used directly
+            // => the node attributes for the notification reference the values of the existing
+            // node attributes (no deep copy) and the value of the notification
+            NodeAttributes nodeAttrWithValues(monitoredNodeAttr.getNodeId());
+            nodeAttrWithValues.setDataType(monitoredNodeAttr.getDataType());
+            nodeAttrWithValues.setNodeClass(monitoredNodeAttr.getNodeClass());
+            nodeAttrWithValues.setValue(monitoredNodeAttr.getValue());
+            nodeAttrWithValues.setException(monitoredNodeAttr.getException());
+            UaVariant value;
+            UaDateTime sourceTimestamp(dataNotifications[i].Value.SourceTimestamp);
+            HaSubscriptionException* exception = NULL;
             UaStatus status(dataNotifications[i].Value.StatusCode);
             if (status.isGood()) {
                 // set value to internal object
-                nodeAttrWithValues->setValue(new UaVariant(dataNotifications[i].Value.Value));
+                value = dataNotifications[i].Value.Value;
+                nodeAttrWithValues.setValue(&value);
+                nodeAttrWithValues.setSourceTimestamp(&sourceTimestamp);
                 if (log->isDebugEnabled()) {
                     log->debug("  %s %s value=%s",
                             UaDateTime(dataNotifications[i].Value.ServerTimestamp).toTimeString().toUtf8(),
-                            nodeAttrWithValues->getNodeId().toXmlString().toUtf8(),
-                            nodeAttrWithValues->getValue()->toFullString().toUtf8());
+                            nodeAttrWithValues.getNodeId().toXmlString().toUtf8(),
+                            value.toFullString().toUtf8());
                 }
             } else {
                 std::ostringstream msg;
-                msg << "Exception for " << nodeAttrWithValues->getNodeId().toXmlString().toUtf8()
+                msg << "Exception for " << nodeAttrWithValues.getNodeId().toXmlString().toUtf8()
                         << " found in data notification: " << status.toString().toUtf8();
-                nodeAttrWithValues->setException(new ExceptionDef(HaSubscriptionException, msg.str()));
+                exception = new ExceptionDef(HaSubscriptionException, msg.str());
+                nodeAttrWithValues.setException(exception);
             }
-            nodeAttributes->push_back(nodeAttrWithValues);
+            ScopeGuard<HaSubscriptionException> exceptionSG(exception);
+            std::vector<NodeAttributes*> nodeAttributes;
+            nodeAttributes.push_back(&nodeAttrWithValues);
             try {
                 // send notification    
-                callback->dataChanged(*nodeAttributes); // Exception
+                callback->dataChanged(nodeAttributes); // Exception
             } catch (Exception& e) {
                 // the error cannot be returned => log it
-                std::string st;
-                e.getStackTrace(st);
-                log->error("Exception while processing notifications: %s", st.c_str());
+                LogThrottle* throttle = LoggerFactory::getLogThrottle("HaSubscription");
+                if (throttle == NULL
+                        || throttle->pass("Exception while processing notifications: %s")) {
+                    std::string st;
+                    e.getStackTrace(st);
+                    log->error("Exception while processing notifications: %s", st.c_str());
+                }
             }
         }
     }
@@ -9,6 +9,7 @@ private:
     UaVariant* value;
     UaNodeId* dataType;
     OpcUa_NodeClass* nodeClass;
+    UaDateTime* sourceTimestamp;
     Exception* exception;
     bool hasAttachedValues;
 };
@@ -19,6 +20,7 @@ NodeAttributes::NodeAttributes(UaNodeId& nodeId, bool attachValues) {
     d->value = NULL;
     d->dataType = NULL;
     d->nodeClass = NULL;
+    d->sourceTimestamp = NULL;
     d->exception = NULL;
     d->hasAttachedValues = attachValues;
 }
@@ -29,6 +31,8 @@ NodeAttributes::NodeAttributes(const NodeAttributes& orig) {
     d->value = orig.d->value == NULL ? NULL : new UaVariant(*orig.d->value);
     d->dataType = orig.d->dataType == NULL ? NULL : new UaNodeId(*orig.d->dataType);
     d->nodeClass = orig.d->nodeClass == NULL ? NULL : new OpcUa_NodeClass(*orig.d->nodeClass);
+    d->sourceTimestamp = orig.d->sourceTimestamp == NULL ? NULL
+            : new UaDateTime(*orig.d->sourceTimestamp);
     d->exception = orig.d->exception == NULL ? NULL : new Exception(*orig.d->exception);
     d->hasAttachedValues = true;
 }
@@ -40,6 +44,7 @@ NodeAttributes::~NodeAttributes() {
         delete d->dataType;
         delete d->exception;
         delete d->nodeClass;
+        delete d->sourceTimestamp;
     }
     delete d;
 }
@@ -81,6 +86,17 @@ void NodeAttributes::setNodeClass(OpcUa_NodeClass* nodeClass) {
     d->nodeClass = nodeClass;
 }
 
+UaDateTime* NodeAttributes::getSourceTimestamp() const {
+    return d->sourceTimestamp;
+}
+
+void NodeAttributes::setSourceTimestamp(UaDateTime* sourceTimestamp) {
+    if (d->hasAttachedValues) {
+        delete d->sourceTimestamp;
+    }
+    d->sourceTimestamp = sourceTimestamp;
+}
+
 Exception* NodeAttributes::getException() const {
     return d->exception;
 }
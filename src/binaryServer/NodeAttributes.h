@@ -2,6 +2,7 @@
 #define BINARYSERVER_NODEATTRIBUTES_H
 
 #include <common/Exception.h>
+#include <uadatetime.h>
 #include <uanodeid.h>
 #include <uavariant.h>
 
@@ -21,6 +22,9 @@ public:
     virtual void setDataType(UaNodeId* dataType);
     virtual OpcUa_NodeClass* getNodeClass() const;
     virtual void setNodeClass(OpcUa_NodeClass* nodeClass);
+    // source time stamp of the value (only set for data change notifications)
+    virtual UaDateTime* getSourceTimestamp() const;
+    virtual void setSourceTimestamp(UaDateTime* sourceTimestamp);
     
     virtual CommonNamespace::Exception* getException() const;
     virtual void setException(CommonNamespace::Exception* exception);
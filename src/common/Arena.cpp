@@ -0,0 +1,157 @@
+#include <common/Arena.h>
+#include <pthread.h>
+#include <stdlib.h> // malloc
+#include <string.h> // memset
+#include <vector>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+namespace CommonNamespace {
+
+    class ArenaPrivate {
+        friend class Arena;
+    private:
+
+        class Block {
+        public:
+            char* data;
+            size_t size;
+        };
+
+        static const size_t ALIGNMENT = 16;
+
+        static pthread_key_t currentKey;
+        static pthread_key_t threadArenaKey;
+        static pthread_once_t keysOnce;
+
+        size_t blockSize;
+        // blocks with the default size
+        std::vector<Block> blocks;
+        // blocks for allocations which are larger than the default size
+        std::vector<Block> largeBlocks;
+        // offset of the next allocation in the last block
+        size_t offset;
+        size_t usedBytes;
+        Arena::Metrics metrics;
+
+        static void createKeys();
+        static void deleteThreadArena(void* arena);
+
+        char* addBlock(std::vector<Block>& list, size_t size);
+    };
+
+    pthread_key_t ArenaPrivate::currentKey;
+    pthread_key_t ArenaPrivate::threadArenaKey;
+    pthread_once_t ArenaPrivate::keysOnce = PTHREAD_ONCE_INIT;
+
+    void ArenaPrivate::createKeys() {
+        pthread_key_create(&currentKey, NULL);
+        pthread_key_create(&threadArenaKey, &ArenaPrivate::deleteThreadArena);
+    }
+
+    void ArenaPrivate::deleteThreadArena(void* arena) {
+        delete static_cast<Arena*> (arena);
+    }
+
+    char* ArenaPrivate::addBlock(std::vector<Block>& list, size_t size) {
+        Block block;
+        block.size = size;
+        block.data = static_cast<char*> (malloc(size));
+        if (block.data != NULL) {
+            list.push_back(block);
+            metrics.blockAllocationCount++;
+        }
+        return block.data;
+    }
+
+    Arena::Arena(size_t blockSize) {
+        d = new ArenaPrivate();
+        d->blockSize = blockSize;
+        d->offset = 0;
+        d->usedBytes = 0;
+        memset(&d->metrics, 0, sizeof (Metrics));
+    }
+
+    Arena::~Arena() {
+        reset();
+        if (!d->blocks.empty()) {
+            free(d->blocks[0].data);
+        }
+        delete d;
+    }
+
+    void* Arena::allocate(size_t size) {
+        // round up the size to the alignment
+        size = (size + ArenaPrivate::ALIGNMENT - 1) & ~(ArenaPrivate::ALIGNMENT - 1);
+        if (size == 0) {
+            size = ArenaPrivate::ALIGNMENT;
+        }
+        void* ret;
+        if (size > d->blockSize) {
+            ret = d->addBlock(d->largeBlocks, size);
+        } else if (!d->blocks.empty() && d->offset + size <= d->blockSize) {
+            ret = d->blocks.back().data + d->offset;
+            d->offset += size;
+        } else {
+            ret = d->addBlock(d->blocks, d->blockSize);
+            d->offset = size;
+        }
+        if (ret == NULL) {
+            return NULL;
+        }
+        d->usedBytes += size;
+        if (d->usedBytes > d->metrics.maxUsedBytes) {
+            d->metrics.maxUsedBytes = d->usedBytes;
+        }
+        d->metrics.allocationCount++;
+        d->metrics.allocatedBytes += size;
+        return ret;
+    }
+
+    void Arena::reset() {
+        // keep the first block for the next allocations
+        for (size_t i = 1; i < d->blocks.size(); i++) {
+            free(d->blocks[i].data);
+        }
+        if (d->blocks.size() > 1) {
+            d->blocks.resize(1);
+        }
+        for (size_t i = 0; i < d->largeBlocks.size(); i++) {
+            free(d->largeBlocks[i].data);
+        }
+        d->largeBlocks.clear();
+        d->offset = 0;
+        d->usedBytes = 0;
+        d->metrics.resetCount++;
+    }
+
+    size_t Arena::getUsedBytes() const {
+        return d->usedBytes;
+    }
+
+    Arena::Metrics Arena::getMetrics() const {
+        return d->metrics;
+    }
+
+    Arena& Arena::getThreadArena() {
+        pthread_once(&ArenaPrivate::keysOnce, &ArenaPrivate::createKeys);
+        Arena* ret = static_cast<Arena*> (pthread_getspecific(ArenaPrivate::threadArenaKey));
+        if (ret == NULL) {
+            ret = new Arena();
+            pthread_setspecific(ArenaPrivate::threadArenaKey, ret);
+        }
+        return *ret;
+    }
+
+    Arena* Arena::getCurrent() {
+        pthread_once(&ArenaPrivate::keysOnce, &ArenaPrivate::createKeys);
+        return static_cast<Arena*> (pthread_getspecific(ArenaPrivate::currentKey));
+    }
+
+    void Arena::setCurrent(Arena* arena) {
+        pthread_once(&ArenaPrivate::keysOnce, &ArenaPrivate::createKeys);
+        pthread_setspecific(ArenaPrivate::currentKey, arena);
+    }
+
+} // namespace CommonNamespace
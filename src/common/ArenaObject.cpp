@@ -0,0 +1,45 @@
+#include <common/ArenaObject.h>
+#include <common/Arena.h>
+#include <new> // std::bad_alloc
+
+namespace CommonNamespace {
+
+    // The memory of an object is prefixed with a header containing the arena the object has been
+    // allocated from (NULL for the heap). The header size keeps the alignment of the arena.
+    static const size_t HEADER_SIZE = 16;
+
+    void* ArenaObject::operator new(size_t size) {
+        Arena* arena = Arena::getCurrent();
+        char* header;
+        if (arena == NULL) {
+            header = static_cast<char*> (::operator new(HEADER_SIZE + size)); // std::bad_alloc
+        } else {
+            header = static_cast<char*> (arena->allocate(HEADER_SIZE + size));
+            if (header == NULL) {
+                throw std::bad_alloc();
+            }
+        }
+        *reinterpret_cast<Arena**> (header) = arena;
+        return header + HEADER_SIZE;
+    }
+
+    void ArenaObject::operator delete(void* p) {
+        if (p == NULL) {
+            return;
+        }
+        char* header = static_cast<char*> (p) - HEADER_SIZE;
+        // memory of an arena is released with the reset of the arena
+        if (*reinterpret_cast<Arena**> (header) == NULL) {
+            ::operator delete(header);
+        }
+    }
+
+    void* ArenaObject::operator new(size_t size, const char* file, int line) {
+        return ArenaObject::operator new(size);
+    }
+
+    void ArenaObject::operator delete(void* p, const char* file, int line) {
+        ArenaObject::operator delete(p);
+    }
+
+} // namespace CommonNamespace
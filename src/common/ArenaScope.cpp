@@ -0,0 +1,21 @@
+#include <common/ArenaScope.h>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+namespace CommonNamespace {
+
+    ArenaScope::ArenaScope(Arena& arena) : arena(arena) {
+        previous = Arena::getCurrent();
+        Arena::setCurrent(&arena);
+    }
+
+    ArenaScope::~ArenaScope() {
+        Arena::setCurrent(previous);
+        // if the arena is not used by an outer scope
+        if (previous != &arena) {
+            arena.reset();
+        }
+    }
+
+} // namespace CommonNamespace
@@ -0,0 +1,167 @@
+#include <common/CompactValue.h>
+#include <new> // std::bad_alloc
+#include <stdlib.h> // malloc
+#include <string.h> // memcpy
+
+namespace CommonNamespace {
+
+    class CompactValue::SharedBuffer {
+    public:
+        int referenceCount;
+        size_t length;
+        // the bytes follow the header
+        char bytes[1];
+
+        static SharedBuffer* create(const char* bytes, size_t length) {
+            SharedBuffer* ret = static_cast<SharedBuffer*> (
+                    malloc(offsetof(SharedBuffer, bytes) + length));
+            if (ret == NULL) {
+                throw std::bad_alloc();
+            }
+            ret->referenceCount = 1;
+            ret->length = length;
+            memcpy(ret->bytes, bytes, length);
+            return ret;
+        }
+
+        void acquire() {
+            __sync_add_and_fetch(&referenceCount, 1);
+        }
+
+        void release() {
+            if (__sync_sub_and_fetch(&referenceCount, 1) == 0) {
+                free(this);
+            }
+        }
+    };
+
+    CompactValue::CompactValue() {
+        kind = NULL_VALUE;
+        inlineLength = 0;
+    }
+
+    CompactValue::CompactValue(const CompactValue& orig) {
+        kind = NULL_VALUE;
+        inlineLength = 0;
+        *this = orig;
+    }
+
+    CompactValue::~CompactValue() {
+        clear();
+    }
+
+    CompactValue& CompactValue::operator=(const CompactValue& orig) {
+        // avoid self-assignment
+        if (this == &orig) {
+            return *this;
+        }
+        clear();
+        switch (orig.kind) {
+            case NUMERIC:
+                numeric = orig.numeric;
+                break;
+            case INLINE:
+                memcpy(inlineBytes, orig.inlineBytes, orig.inlineLength);
+                inlineLength = orig.inlineLength;
+                break;
+            case SHARED:
+                shared = orig.shared;
+                shared->acquire();
+                break;
+            case ATTACHED:
+                // the copy gets its own storage
+                setBytes(orig.attached.bytes, orig.attached.length); // std::bad_alloc
+                return *this;
+        }
+        kind = orig.kind;
+        return *this;
+    }
+
+    bool CompactValue::isNull() const {
+        return kind == NULL_VALUE;
+    }
+
+    bool CompactValue::isNumeric() const {
+        return kind == NUMERIC;
+    }
+
+    const CompactValue::Numeric& CompactValue::getNumeric() const {
+        return numeric;
+    }
+
+    CompactValue::Numeric& CompactValue::setNumeric() {
+        clear();
+        kind = NUMERIC;
+        return numeric;
+    }
+
+    const char* CompactValue::getBytes() const {
+        switch (kind) {
+            case INLINE:
+                return inlineBytes;
+            case SHARED:
+                return shared->bytes;
+            case ATTACHED:
+                return attached.bytes;
+            default:
+                return NULL;
+        }
+    }
+
+    size_t CompactValue::getLength() const {
+        switch (kind) {
+            case INLINE:
+                return inlineLength;
+            case SHARED:
+                return shared->length;
+            case ATTACHED:
+                return attached.length;
+            default:
+                return 0;
+        }
+    }
+
+    void CompactValue::setBytes(const char* bytes, size_t length) {
+        clear();
+        if (bytes == NULL) {
+            return;
+        }
+        if (length <= INLINE_CAPACITY) {
+            memcpy(inlineBytes, bytes, length);
+            inlineLength = length;
+            kind = INLINE;
+        } else {
+            shared = SharedBuffer::create(bytes, length); // std::bad_alloc
+            kind = SHARED;
+        }
+    }
+
+    void CompactValue::attachBytes(char* bytes, size_t length) {
+        clear();
+        if (bytes == NULL) {
+            return;
+        }
+        attached.bytes = bytes;
+        attached.length = length;
+        kind = ATTACHED;
+    }
+
+    bool CompactValue::equalBytes(const char* bytes, size_t length) const {
+        const char* thisBytes = getBytes();
+        if (thisBytes == NULL || bytes == NULL) {
+            return thisBytes == bytes;
+        }
+        return getLength() == length && memcmp(thisBytes, bytes, length) == 0;
+    }
+
+    void CompactValue::clear() {
+        if (kind == SHARED) {
+            shared->release();
+        } else if (kind == ATTACHED) {
+            delete[] attached.bytes;
+        }
+        kind = NULL_VALUE;
+        inlineLength = 0;
+    }
+
+} // namespace CommonNamespace
@@ -0,0 +1,214 @@
+#include <common/logging/LogThrottle.h>
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <pthread.h> // pthread_mutex_t
+#include <stddef.h> // NULL
+#include <string.h> // memset
+#include <time.h> // clock_gettime
+#include <map>
+#include <utility> // std::pair
+#include <vector>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+namespace CommonNamespace {
+
+    class LogThrottlePrivate {
+        friend class LogThrottle;
+    private:
+
+        class Bucket {
+        public:
+            double tokens;
+            timespec lastRefill;
+            unsigned long suppressedCount;
+            timespec firstSuppressed;
+        };
+
+        class Summary {
+        public:
+            std::string messageTemplate;
+            std::string node;
+            unsigned long suppressedCount;
+        };
+
+        Logger* log;
+        LogThrottle::Configuration conf;
+
+        // protects the logger, the buckets, the configuration and the metrics
+        pthread_mutex_t mutex;
+        // (message template, node) => bucket
+        std::map<std::pair<std::string, std::string>, Bucket> buckets;
+        // time of the last check of the summaries
+        timespec lastSummaryCheck;
+
+        LogThrottle::Metrics metrics;
+
+        // Collects the summaries of buckets with suppressed messages and removes unused
+        // buckets. The mutex must be locked by the caller.
+        void collectSummaries(const timespec& now, bool all, std::vector<Summary>& summaries);
+        static void logSummaries(Logger* log, const std::vector<Summary>& summaries);
+        // Returns the difference in milliseconds.
+        static double diff(const timespec& end, const timespec& start);
+    };
+
+    LogThrottle::Configuration::Configuration() {
+        maxBurst = 10;
+        messagesPerSecond = 1;
+        summaryInterval = 60000;
+    }
+
+    LogThrottle::LogThrottle(Logger& log, const Configuration& conf) /* throws MutexException */ {
+        d = new LogThrottlePrivate();
+        d->log = &log;
+        d->conf = conf;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        clock_gettime(CLOCK_REALTIME, &d->lastSummaryCheck);
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for log throttle");
+        }
+    }
+
+    LogThrottle::~LogThrottle() {
+        flush();
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    bool LogThrottle::pass(const char* messageTemplate, const std::string& node) {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        std::vector<LogThrottlePrivate::Summary> summaries;
+        bool ret = true;
+        pthread_mutex_lock(&d->mutex);
+        if (d->conf.messagesPerSecond > 0) {
+            std::pair<std::string, std::string> key(messageTemplate, node);
+            std::map<std::pair<std::string, std::string>, LogThrottlePrivate::Bucket>::iterator i =
+                    d->buckets.find(key);
+            if (i == d->buckets.end()) {
+                LogThrottlePrivate::Bucket bucket;
+                bucket.tokens = d->conf.maxBurst;
+                bucket.lastRefill = now;
+                bucket.suppressedCount = 0;
+                i = d->buckets.insert(std::make_pair(key, bucket)).first;
+            }
+            LogThrottlePrivate::Bucket& bucket = (*i).second;
+            // refill the bucket
+            bucket.tokens += LogThrottlePrivate::diff(now, bucket.lastRefill)
+                    * d->conf.messagesPerSecond / 1000;
+            if (bucket.tokens > d->conf.maxBurst) {
+                bucket.tokens = d->conf.maxBurst;
+            }
+            bucket.lastRefill = now;
+            if (bucket.tokens >= 1) {
+                bucket.tokens--;
+            } else {
+                if (bucket.suppressedCount == 0) {
+                    bucket.firstSuppressed = now;
+                }
+                bucket.suppressedCount++;
+                ret = false;
+            }
+            // report the suppressed messages before the message is logged again
+            if (ret && bucket.suppressedCount > 0) {
+                LogThrottlePrivate::Summary summary;
+                summary.messageTemplate = key.first;
+                summary.node = key.second;
+                summary.suppressedCount = bucket.suppressedCount;
+                summaries.push_back(summary);
+                bucket.suppressedCount = 0;
+            }
+            if (LogThrottlePrivate::diff(now, d->lastSummaryCheck) >= d->conf.summaryInterval) {
+                d->collectSummaries(now, false /* all */, summaries);
+                d->lastSummaryCheck = now;
+            }
+        }
+        if (ret) {
+            d->metrics.passedCount++;
+        } else {
+            d->metrics.suppressedCount++;
+        }
+        d->metrics.summaryCount += summaries.size();
+        Logger* log = d->log;
+        pthread_mutex_unlock(&d->mutex);
+        // log outside of the lock
+        LogThrottlePrivate::logSummaries(log, summaries);
+        return ret;
+    }
+
+    void LogThrottle::flush() {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        std::vector<LogThrottlePrivate::Summary> summaries;
+        pthread_mutex_lock(&d->mutex);
+        d->collectSummaries(now, true /* all */, summaries);
+        d->lastSummaryCheck = now;
+        d->metrics.summaryCount += summaries.size();
+        Logger* log = d->log;
+        pthread_mutex_unlock(&d->mutex);
+        LogThrottlePrivate::logSummaries(log, summaries);
+    }
+
+    void LogThrottle::setLogger(Logger* log) {
+        pthread_mutex_lock(&d->mutex);
+        d->log = log;
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    void LogThrottle::setConfiguration(const Configuration& conf) {
+        pthread_mutex_lock(&d->mutex);
+        d->conf = conf;
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    LogThrottle::Metrics LogThrottle::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void LogThrottlePrivate::collectSummaries(const timespec& now, bool all,
+            std::vector<Summary>& summaries) {
+        std::map<std::pair<std::string, std::string>, Bucket>::iterator i = buckets.begin();
+        while (i != buckets.end()) {
+            Bucket& bucket = (*i).second;
+            if (bucket.suppressedCount > 0
+                    && (all || diff(now, bucket.firstSuppressed) >= conf.summaryInterval)) {
+                Summary summary;
+                summary.messageTemplate = (*i).first.first;
+                summary.node = (*i).first.second;
+                summary.suppressedCount = bucket.suppressedCount;
+                summaries.push_back(summary);
+                bucket.suppressedCount = 0;
+            }
+            // remove buckets which would be full again
+            if (bucket.suppressedCount == 0 && bucket.tokens
+                    + diff(now, bucket.lastRefill) * conf.messagesPerSecond / 1000
+                    >= conf.maxBurst) {
+                buckets.erase(i++);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void LogThrottlePrivate::logSummaries(Logger* log, const std::vector<Summary>& summaries) {
+        if (log == NULL) {
+            return;
+        }
+        for (std::vector<Summary>::const_iterator i = summaries.begin(); i != summaries.end();
+                i++) {
+            const Summary& summary = *i;
+            log->warn("Suppressed %lu similar messages: %s%s%s", summary.suppressedCount,
+                    summary.messageTemplate.c_str(), summary.node.empty() ? "" : " ",
+                    summary.node.c_str());
+        }
+    }
+
+    double LogThrottlePrivate::diff(const timespec& end, const timespec& start) {
+        return (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+    }
+} // namespace CommonNamespace
@@ -1,8 +1,11 @@
 #include <common/logging/LoggerFactory.h>
 #include <common/Exception.h>
 #include <common/logging/LoggingException.h>
+#include <pthread.h> // pthread_mutex_t
 #include <stddef.h> //NULL
 #include <algorithm> //std::find
+#include <map>
+#include <string>
 #include <vector>
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
@@ -16,12 +19,30 @@ namespace CommonNamespace {
         static ILoggerFactory* iloggerFactory;
         static std::vector<ILoggerFactory*>* previous;
 
+        // protects the log throttles and their configurations
+        static pthread_mutex_t throttleMutex;
+        // logger name => configuration ("": default configuration)
+        static std::map<std::string, LogThrottle::Configuration>* throttleConfs;
+        // logger name => log throttle
+        // The throttles are kept while logging is active because the callers use the
+        // returned pointers without further synchronization.
+        static std::map<std::string, LogThrottle*>* throttles;
+
         ILoggerFactory* addedIloggerFactory;
         bool hasAttachedValues;
+
+        // Logs the summaries of the log throttles with the loggers of the previously active
+        // logger factory implementation and sets the loggers of the active one.
+        static void updateLogThrottles();
+        // Deletes the log throttles after logging has been deactivated.
+        static void deleteLogThrottles();
     };
 
     ILoggerFactory* LoggerFactoryPrivate::iloggerFactory = NULL;
     std::vector<ILoggerFactory*>* LoggerFactoryPrivate::previous = NULL;
+    pthread_mutex_t LoggerFactoryPrivate::throttleMutex = PTHREAD_MUTEX_INITIALIZER;
+    std::map<std::string, LogThrottle::Configuration>* LoggerFactoryPrivate::throttleConfs = NULL;
+    std::map<std::string, LogThrottle*>* LoggerFactoryPrivate::throttles = NULL;
 
     LoggerFactory::LoggerFactory(ILoggerFactory& iloggerFactory, bool attachValues) {
         d = new LoggerFactoryPrivate();
@@ -34,6 +55,7 @@ namespace CommonNamespace {
         d->iloggerFactory = &iloggerFactory;
         d->addedIloggerFactory = &iloggerFactory;
         d->hasAttachedValues = attachValues;
+        LoggerFactoryPrivate::updateLogThrottles();
     }
 
     LoggerFactory::~LoggerFactory() {
@@ -50,9 +72,16 @@ namespace CommonNamespace {
                 } else {
                     d->previous->pop_back();
                 }
+                LoggerFactoryPrivate::updateLogThrottles();
             } else {
                 // deactivate logging
+                // (the summaries are logged with the loggers of the added implementation)
+                LoggerFactoryPrivate::deleteLogThrottles();
                 d->iloggerFactory = NULL;
+                pthread_mutex_lock(&LoggerFactoryPrivate::throttleMutex);
+                delete d->throttleConfs;
+                d->throttleConfs = NULL;
+                pthread_mutex_unlock(&LoggerFactoryPrivate::throttleMutex);
             }
         } else {
             // remove added logger from previous loggers
@@ -77,4 +106,94 @@ namespace CommonNamespace {
         }
         return LoggerFactoryPrivate::iloggerFactory->getLogger(name);
     }
+
+    void LoggerFactory::setLogThrottle(const char* name, const LogThrottle::Configuration& conf) {
+        pthread_mutex_lock(&LoggerFactoryPrivate::throttleMutex);
+        if (LoggerFactoryPrivate::throttleConfs == NULL) {
+            LoggerFactoryPrivate::throttleConfs =
+                    new std::map<std::string, LogThrottle::Configuration>();
+        }
+        std::string loggerName(name);
+        (*LoggerFactoryPrivate::throttleConfs)[loggerName] = conf;
+        if (LoggerFactoryPrivate::throttles != NULL) {
+            for (std::map<std::string, LogThrottle*>::iterator i =
+                    LoggerFactoryPrivate::throttles->begin();
+                    i != LoggerFactoryPrivate::throttles->end(); i++) {
+                // update the throttle if the logger name matches or the default configuration
+                // is used for the throttle
+                if ((*i).first == loggerName || (loggerName.empty()
+                        && LoggerFactoryPrivate::throttleConfs->find((*i).first)
+                        == LoggerFactoryPrivate::throttleConfs->end())) {
+                    (*i).second->setConfiguration(conf);
+                }
+            }
+        }
+        pthread_mutex_unlock(&LoggerFactoryPrivate::throttleMutex);
+    }
+
+    LogThrottle* LoggerFactory::getLogThrottle(const char* name) /* throws MutexException */ {
+        Logger* log = getLogger(name);
+        if (log == NULL) {
+            return NULL;
+        }
+        LogThrottle* ret = NULL;
+        pthread_mutex_lock(&LoggerFactoryPrivate::throttleMutex);
+        try {
+            if (LoggerFactoryPrivate::throttles == NULL) {
+                LoggerFactoryPrivate::throttles = new std::map<std::string, LogThrottle*>();
+            }
+            std::string loggerName(name);
+            std::map<std::string, LogThrottle*>::iterator i =
+                    LoggerFactoryPrivate::throttles->find(loggerName);
+            if (i != LoggerFactoryPrivate::throttles->end()) {
+                ret = (*i).second;
+            } else {
+                // get the configuration for the logger or the default configuration
+                LogThrottle::Configuration conf;
+                if (LoggerFactoryPrivate::throttleConfs != NULL) {
+                    std::map<std::string, LogThrottle::Configuration>::iterator c =
+                            LoggerFactoryPrivate::throttleConfs->find(loggerName);
+                    if (c == LoggerFactoryPrivate::throttleConfs->end()) {
+                        c = LoggerFactoryPrivate::throttleConfs->find(std::string());
+                    }
+                    if (c != LoggerFactoryPrivate::throttleConfs->end()) {
+                        conf = (*c).second;
+                    }
+                }
+                ret = new LogThrottle(*log, conf); // MutexException
+                (*LoggerFactoryPrivate::throttles)[loggerName] = ret;
+            }
+        } catch (Exception& e) {
+            pthread_mutex_unlock(&LoggerFactoryPrivate::throttleMutex);
+            throw;
+        }
+        pthread_mutex_unlock(&LoggerFactoryPrivate::throttleMutex);
+        return ret;
+    }
+
+    void LoggerFactoryPrivate::updateLogThrottles() {
+        pthread_mutex_lock(&throttleMutex);
+        if (throttles != NULL) {
+            for (std::map<std::string, LogThrottle*>::iterator i = throttles->begin();
+                    i != throttles->end(); i++) {
+                LogThrottle& throttle = *(*i).second;
+                throttle.flush();
+                throttle.setLogger(iloggerFactory->getLogger((*i).first.c_str()));
+            }
+        }
+        pthread_mutex_unlock(&throttleMutex);
+    }
+
+    void LoggerFactoryPrivate::deleteLogThrottles() {
+        pthread_mutex_lock(&throttleMutex);
+        if (throttles != NULL) {
+            for (std::map<std::string, LogThrottle*>::iterator i = throttles->begin();
+                    i != throttles->end(); i++) {
+                delete (*i).second;
+            }
+            delete throttles;
+            throttles = NULL;
+        }
+        pthread_mutex_unlock(&throttleMutex);
+    }
 } // namespace CommonNamespace
\ No newline at end of file
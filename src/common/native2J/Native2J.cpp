@@ -2,11 +2,163 @@
 
 #include <common/logging/JLogger.h>
 #include <common/logging/JLoggerFactory.h>
+#include <provider/binary/messages/dto/ScalarTraits.h>
 
 #include <uadatavalue.h>
 
 #define LIB_EXCEPTION "havis/util/opcua/OPCUAException"
 
+// Compile-time description of the Java box class of a scalar type of the binary protocol:
+//   JType:     the primitive Java type
+//   getClassName(), getValueMethodName(), getValueMethodSignature(),
+//   getConstructorSignature(): the names and signatures for the JNI lookups
+//   callValueMethod: calls the value method of the box class (or java.lang.Number)
+template<int ScalarType> class JavaBoxTraits;
+
+template<> class JavaBoxTraits<Scalar::BOOLEAN> {
+public:
+	typedef jboolean JType;
+	static const char* getClassName() { return "java/lang/Boolean"; }
+	static const char* getValueMethodName() { return "booleanValue"; }
+	static const char* getValueMethodSignature() { return "()Z"; }
+	static const char* getConstructorSignature() { return "(Z)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallBooleanMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::CHAR> {
+public:
+	typedef jchar JType;
+	static const char* getClassName() { return "java/lang/Character"; }
+	static const char* getValueMethodName() { return "charValue"; }
+	static const char* getValueMethodSignature() { return "()C"; }
+	static const char* getConstructorSignature() { return "(C)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallCharMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::BYTE> {
+public:
+	typedef jbyte JType;
+	static const char* getClassName() { return "java/lang/Byte"; }
+	static const char* getValueMethodName() { return "byteValue"; }
+	static const char* getValueMethodSignature() { return "()B"; }
+	static const char* getConstructorSignature() { return "(B)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallByteMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::SHORT> {
+public:
+	typedef jshort JType;
+	static const char* getClassName() { return "java/lang/Short"; }
+	static const char* getValueMethodName() { return "shortValue"; }
+	static const char* getValueMethodSignature() { return "()S"; }
+	static const char* getConstructorSignature() { return "(S)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallShortMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::INT> {
+public:
+	typedef jint JType;
+	static const char* getClassName() { return "java/lang/Integer"; }
+	static const char* getValueMethodName() { return "intValue"; }
+	static const char* getValueMethodSignature() { return "()I"; }
+	static const char* getConstructorSignature() { return "(I)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallIntMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::LONG> {
+public:
+	typedef jlong JType;
+	static const char* getClassName() { return "java/lang/Long"; }
+	static const char* getValueMethodName() { return "longValue"; }
+	static const char* getValueMethodSignature() { return "()J"; }
+	static const char* getConstructorSignature() { return "(J)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallLongMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::FLOAT> {
+public:
+	typedef jfloat JType;
+	static const char* getClassName() { return "java/lang/Float"; }
+	static const char* getValueMethodName() { return "floatValue"; }
+	static const char* getValueMethodSignature() { return "()F"; }
+	static const char* getConstructorSignature() { return "(F)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallFloatMethod(obj, method);
+	}
+};
+
+template<> class JavaBoxTraits<Scalar::DOUBLE> {
+public:
+	typedef jdouble JType;
+	static const char* getClassName() { return "java/lang/Double"; }
+	static const char* getValueMethodName() { return "doubleValue"; }
+	static const char* getValueMethodSignature() { return "()D"; }
+	static const char* getConstructorSignature() { return "(D)V"; }
+	static JType callValueMethod(JNIEnv *env, jobject obj, jmethodID method) {
+		return env->CallDoubleMethod(obj, method);
+	}
+};
+
+// Reads the value of a Java object with the value method of a scalar type. The object must be
+// an instance of "clazz".
+template<int ScalarType> static void readJavaValue(JNIEnv *env, jobject data, jclass clazz,
+		Scalar& scalar) {
+	typedef JavaBoxTraits<ScalarType> Traits;
+	jmethodID method = env->GetMethodID(clazz, Traits::getValueMethodName(),
+			Traits::getValueMethodSignature());
+	ScalarTraits<ScalarType>::set(scalar,
+			static_cast<typename ScalarTraits<ScalarType>::Type>(
+					Traits::callValueMethod(env, data, method)));
+}
+
+// Reads the value of a Java object if it is an instance of the box class of a scalar type.
+template<int ScalarType> static bool readJavaBox(JNIEnv *env, jobject data, Scalar& scalar) {
+	jclass clazz = env->FindClass(JavaBoxTraits<ScalarType>::getClassName());
+	bool ret = env->IsInstanceOf(data, clazz);
+	if (ret) {
+		readJavaValue<ScalarType>(env, data, clazz, scalar);
+	}
+	env->DeleteLocalRef(clazz);
+	return ret;
+}
+
+// Reads the value of a java.lang.Number as a scalar type. If the object is not a number NULL
+// is returned.
+template<int ScalarType> static Scalar *readJavaNumber(JNIEnv *env, jobject data) {
+	jclass java_lang_Number = env->FindClass("java/lang/Number");
+	Scalar *scalar = NULL;
+	if (env->IsInstanceOf(data, java_lang_Number)) {
+		scalar = new Scalar();
+		readJavaValue<ScalarType>(env, data, java_lang_Number, *scalar);
+	}
+	env->DeleteLocalRef(java_lang_Number);
+	return scalar;
+}
+
+// Creates an instance of the Java box class of a scalar type.
+template<int ScalarType> static jobject newJavaBox(JNIEnv *env, const Scalar& value) {
+	typedef JavaBoxTraits<ScalarType> Traits;
+	jclass clazz = env->FindClass(Traits::getClassName());
+	jmethodID constructor = env->GetMethodID(clazz, "<init>",
+			Traits::getConstructorSignature());
+	jobject ret = env->NewObject(clazz, constructor,
+			static_cast<typename Traits::JType>(ScalarTraits<ScalarType>::get(value)));
+	env->DeleteLocalRef(clazz);
+	return ret;
+}
+
 Native2J::Native2J(JNIEnv *env, jobject handler) {
 	this->log = LoggerFactory::getLogger("Native2J");
 	env->GetJavaVM(&jvm);
@@ -123,7 +275,7 @@ jobject Native2J::createVariant(JNIEnv *env, Event& message) {
 	jobject map = env->NewObject(java_util_HashMap, java_util_HashMap_);
 	jobject innerMap = env->NewObject(java_util_HashMap, java_util_HashMap_);
 
-	ParamMap paramMap = message.getParamMap();
+	const ParamMap& paramMap = message.getParamMap();
 	const std::map<const ParamId*, const Variant*>& elements =
 			paramMap.getElements();
 
@@ -160,7 +312,7 @@ jobject Native2J::createVariant(JNIEnv *env, Event& message) {
 Native2J::ValueChanged Native2J::createVariant(JNIEnv *env,
 		Notification& message) {
 	ValueChanged value;
-	ParamMap paramMap = message.getParamMap();
+	const ParamMap& paramMap = message.getParamMap();
 	const std::map<const ParamId*, const Variant*>& elements =
 			paramMap.getElements();
 	for (std::map<const ParamId*, const Variant*>::const_iterator i =
@@ -243,8 +395,7 @@ Struct* Native2J::getStructureVariant(JNIEnv *env, jobject data, std::string key
 			java_util_Set_toArray);
 	int len = env->GetArrayLength(arr);
 
-	std::map<std::string, const Variant*>* fields = new std::map<std::string,
-			const Variant*>();
+	Struct* ret = Struct::createStruct(*structId, len);
 
 	for (int i = 0; i < len; i++) {
 		jstring key = (jstring) env->GetObjectArrayElement(arr, i);
@@ -258,14 +409,14 @@ Struct* Native2J::getStructureVariant(JNIEnv *env, jobject data, std::string key
 		else {
 			variant = getVariant(env, value, ckey);
 		}
-		(*fields)[std::string(ckey)] = variant;
+		ret->addField(std::string(ckey), *variant);
 		env->ReleaseStringUTFChars(key, ckey);
 	}
 
 	env->DeleteLocalRef(keySet);
 	env->DeleteLocalRef(arr);
 
-	return new Struct(*structId, *fields, true);
+	return ret;
 }
 
 Array *Native2J::getArrayVariant(JNIEnv *env, jobject data, ModelType t) {
@@ -323,115 +474,53 @@ Array *Native2J::getArrayVariant(JNIEnv *env, jobject data, ModelType t) {
 
 Scalar *Native2J::guessScalar(JNIEnv *env, jobject data) {
 	Scalar *scalar = new Scalar();
-
-	jclass java_lang_Boolean = env->FindClass("java/lang/Boolean");
-	jclass java_lang_Character = env->FindClass("java/lang/Character");
-	jclass java_lang_Byte = env->FindClass("java/lang/Byte");
-	jclass java_lang_Short = env->FindClass("java/lang/Short");
-	jclass java_lang_Integer = env->FindClass("java/lang/Integer");
-	jclass java_lang_Long = env->FindClass("java/lang/Long");
-	jclass java_lang_Float = env->FindClass("java/lang/Float");
-	jclass java_lang_Double = env->FindClass("java/lang/Double");
-
-	jmethodID method;
-
-	if (env->IsInstanceOf(data, java_lang_Boolean)) {
-		method = env->GetMethodID(java_lang_Boolean, "booleanValue", "()Z");
-		jboolean b = env->CallBooleanMethod(data, method);
-		scalar->setBoolean(b);
-	} else if (env->IsInstanceOf(data, java_lang_Character)) {
-		method = env->GetMethodID(java_lang_Character, "charValue", "()C");
-		jchar c = env->CallCharMethod(data, method);
-		scalar->setChar(c);
-	} else if (env->IsInstanceOf(data, java_lang_Byte)) {
-		method = env->GetMethodID(java_lang_Byte, "byteValue", "()B");
-		jbyte by = env->CallCharMethod(data, method);
-		scalar->setByte(by);
-	} else if (env->IsInstanceOf(data, java_lang_Short)) {
-		method = env->GetMethodID(java_lang_Short, "shortValue", "()S");
-		jshort s = env->CallCharMethod(data, method);
-		scalar->setShort(s);
-	} else if (env->IsInstanceOf(data, java_lang_Integer)) {
-		method = env->GetMethodID(java_lang_Integer, "intValue", "()I");
-		jint i = env->CallIntMethod(data, method);
-		scalar->setInt(i);
-	} else if (env->IsInstanceOf(data, java_lang_Long)) {
-		method = env->GetMethodID(java_lang_Long, "longValue", "()J");
-		jlong l = env->CallIntMethod(data, method);
-		scalar->setLong(l);
-	} else if (env->IsInstanceOf(data, java_lang_Float)) {
-		method = env->GetMethodID(java_lang_Float, "floatValue", "()F");
-		jfloat f = env->CallIntMethod(data, method);
-		scalar->setFloat(f);
-	} else if (env->IsInstanceOf(data, java_lang_Double)) {
-		method = env->GetMethodID(java_lang_Double, "doubleValue", "()D");
-		jdouble d = env->CallDoubleMethod(data, method);
-		scalar->setDouble(d);
-	}
-
+	// the box classes are looked up until the first match
+	readJavaBox<Scalar::BOOLEAN>(env, data, *scalar)
+			|| readJavaBox<Scalar::CHAR>(env, data, *scalar)
+			|| readJavaBox<Scalar::BYTE>(env, data, *scalar)
+			|| readJavaBox<Scalar::SHORT>(env, data, *scalar)
+			|| readJavaBox<Scalar::INT>(env, data, *scalar)
+			|| readJavaBox<Scalar::LONG>(env, data, *scalar)
+			|| readJavaBox<Scalar::FLOAT>(env, data, *scalar)
+			|| readJavaBox<Scalar::DOUBLE>(env, data, *scalar);
 	return scalar;
 }
 
 Scalar *Native2J::getScalarVariant(JNIEnv *env, jobject data, ModelType t) {
-	Scalar *scalar = new Scalar();
-
-	jclass java_lang_Boolean = env->FindClass("java/lang/Boolean");
-	jclass java_lang_Character = env->FindClass("java/lang/Character");
-	jclass java_lang_Byte = env->FindClass("java/lang/Byte");
-	jclass java_lang_Short = env->FindClass("java/lang/Short");
-	jclass java_lang_Integer = env->FindClass("java/lang/Integer");
-	jclass java_lang_Long = env->FindClass("java/lang/Long");
-	jclass java_lang_Float = env->FindClass("java/lang/Float");
-	jclass java_lang_Double = env->FindClass("java/lang/Double");
-
-	jmethodID method;
 	if (t.type != ModelType::REF && t.t ==-99){
-		delete scalar;
 		return guessScalar(env, data);
 	}
 	if (t.type == ModelType::REF){
 		ModelType t2 = getDataTypeFromModel(t.ref, t);
 		//No SubReference?
 		if (t.ref == t2.ref){
-			delete scalar;
 			return guessScalar(env, data);
 		}
-		delete scalar;
 		return getScalarVariant(env, data, t2);
-	} else {
-		switch (t.t) {
-			case OpcUaId_Int32:
-			case OpcUaId_Enumeration:{
-				method = env->GetMethodID(java_lang_Integer, "intValue", "()I");
-				jint i = env->CallIntMethod(data, method);
-				scalar->setInt(i);
-				break;
-			};
-			case OpcUaId_Double:{
-				method = env->GetMethodID(java_lang_Double, "doubleValue", "()D");
-				jdouble d = env->CallDoubleMethod(data, method);
-				scalar->setDouble(d);
-				break;
-			};
-			case OpcUaId_Float:{
-				method = env->GetMethodID(java_lang_Double, "doubleValue", "()D");
-				jdouble d = env->CallDoubleMethod(data, method);
-				scalar->setFloat(d);
-				break;
-			};
-			case OpcUaId_ByteString: {
-				method = env->GetMethodID(java_lang_Integer, "intValue", "()I");
-				jint i = env->CallIntMethod(data, method);
-				scalar->setByte(i);
-				break;
-			};
-			default: {
-				delete scalar;
-				return guessScalar(env, data);
-			}
-		}
 	}
-
+	Scalar *scalar;
+	switch (t.t) {
+		case OpcUaId_Int32:
+		case OpcUaId_Enumeration:
+			scalar = readJavaNumber<Scalar::INT>(env, data);
+			break;
+		case OpcUaId_Double:
+			scalar = readJavaNumber<Scalar::DOUBLE>(env, data);
+			break;
+		case OpcUaId_Float:
+			scalar = readJavaNumber<Scalar::FLOAT>(env, data);
+			break;
+		case OpcUaId_ByteString:
+			scalar = readJavaNumber<Scalar::BYTE>(env, data);
+			break;
+		default:
+			scalar = NULL;
+			break;
+	}
+	if (scalar == NULL) {
+		// unknown model type or not a number
+		return guessScalar(env, data);
+	}
 	return scalar;
 }
 
@@ -538,14 +627,12 @@ jobject Native2J::getStruct(JNIEnv *env, const Struct& value) {
 			"()V");
 	jmethodID java_util_HashMap_put = env->GetMethodID(java_util_HashMap, "put",
 			"(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-	const std::map<std::string, const Variant*>& fields = value.getFields();
 
 	jobject map = env->NewObject(java_util_HashMap, java_util_HashMap_);
-	for (std::map<std::string, const Variant*>::const_iterator i =
-			fields.begin(); i != fields.end(); i++) {
-		std::string key = (*i).first;
-		const Variant& paramValue = *(*i).second;
-		jstring jkey = env->NewStringUTF(key.c_str());
+	for (size_t i = 0; i < value.getFieldCount(); i++) {
+		const Struct::Field& field = value.getField(i);
+		const Variant& paramValue = *field.value;
+		jstring jkey = env->NewStringUTF(field.name.c_str());
 		env->CallObjectMethod(map, java_util_HashMap_put, jkey,
 				getVariant(env, paramValue));
 		//env->ReleaseStringUTFChars(jkey, key.c_str());
@@ -582,72 +669,23 @@ jobject Native2J::getArray(JNIEnv *env, const Array& value) {
 }
 
 jobject Native2J::getScalar(JNIEnv *env, const Scalar& value) {
-	jobject scalar = env->NewGlobalRef(NULL);
 	switch (value.getScalarType()) {
-	case Scalar::BOOLEAN: {
-		jclass java_lang_Boolean = env->FindClass("java/lang/Boolean");
-		jmethodID java_lang_Boolean_ = env->GetMethodID(java_lang_Boolean,
-				"<init>", "(Z)V");
-		scalar = env->NewObject(java_lang_Boolean, java_lang_Boolean_,
-				value.getBoolean());
-		break;
-	}
-	case Scalar::CHAR: {
-		jclass java_lang_Character = env->FindClass("java/lang/Character");
-		jmethodID java_lang_Character_ = env->GetMethodID(java_lang_Character,
-				"<init>", "(C)V");
-		scalar = env->NewObject(java_lang_Character, java_lang_Character_,
-				value.getChar());
-		break;
-	}
-	case Scalar::BYTE: {
-		jclass java_lang_Byte = env->FindClass("java/lang/Byte");
-		jmethodID java_lang_Byte_ = env->GetMethodID(java_lang_Byte, "<init>",
-				"(B)V");
-		scalar = env->NewObject(java_lang_Byte, java_lang_Byte_,
-				value.getByte());
-		break;
-	}
-	case Scalar::SHORT: {
-		jclass java_lang_Short = env->FindClass("java/lang/Short");
-		jmethodID java_lang_Short_ = env->GetMethodID(java_lang_Short, "<init>",
-				"(S)V");
-		scalar = env->NewObject(java_lang_Short, java_lang_Short_,
-				value.getShort());
-		break;
-	}
-	case Scalar::INT: {
-		jclass java_lang_Integer = env->FindClass("java/lang/Integer");
-		jmethodID java_lang_Integer_ = env->GetMethodID(java_lang_Integer,
-				"<init>", "(I)V");
-		scalar = env->NewObject(java_lang_Integer, java_lang_Integer_,
-				value.getInt());
-		break;
-	}
-	case Scalar::LONG: {
-		jclass java_lang_Long = env->FindClass("java/lang/Long");
-		jmethodID java_lang_Long_ = env->GetMethodID(java_lang_Long, "<init>",
-				"(J)V");
-		scalar = env->NewObject(java_lang_Long, java_lang_Long_,
-				value.getLong());
-		break;
-	}
-	case Scalar::FLOAT: {
-		jclass java_lang_Float = env->FindClass("java/lang/Float");
-		jmethodID java_lang_Float_ = env->GetMethodID(java_lang_Float, "<init>",
-				"(F)V");
-		scalar = env->NewObject(java_lang_Float, java_lang_Float_,
-				value.getFloat());
-		break;
-	}
-	case Scalar::DOUBLE: {
-		jclass java_lang_Double = env->FindClass("java/lang/Double");
-		jmethodID java_lang_Double_ = env->GetMethodID(java_lang_Double,
-				"<init>", "(D)V");
-		scalar = env->NewObject(java_lang_Double, java_lang_Double_,
-				value.getDouble());
-		break;
-	}
+	case Scalar::BOOLEAN:
+		return newJavaBox<Scalar::BOOLEAN>(env, value);
+	case Scalar::CHAR:
+		return newJavaBox<Scalar::CHAR>(env, value);
+	case Scalar::BYTE:
+		return newJavaBox<Scalar::BYTE>(env, value);
+	case Scalar::SHORT:
+		return newJavaBox<Scalar::SHORT>(env, value);
+	case Scalar::INT:
+		return newJavaBox<Scalar::INT>(env, value);
+	case Scalar::LONG:
+		return newJavaBox<Scalar::LONG>(env, value);
+	case Scalar::FLOAT:
+		return newJavaBox<Scalar::FLOAT>(env, value);
+	case Scalar::DOUBLE:
+		return newJavaBox<Scalar::DOUBLE>(env, value);
 	default: {
 		std::stringstream ss;
 		ss << "Unknown scalar type " << value.getScalarType();
@@ -655,7 +693,6 @@ jobject Native2J::getScalar(JNIEnv *env, const Scalar& value) {
 		return env->NewGlobalRef(NULL);
 	}
 	}
-	return scalar;
 }
 
 ParamId *Native2J::createParamId(JNIEnv *env, jint ns, jobject paramId) {
@@ -1,4 +1,7 @@
 #include <ioDataProvider/Array.h>
+#include <ioDataProvider/Scalar.h>
+#include <ioDataProvider/ScalarTraits.h>
+#include <string.h> // memcpy
 #include <sstream> // std::ostringstream
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
@@ -12,6 +15,17 @@ namespace IODataProviderNamespace {
         int arrayType;
         const std::vector<const Variant*>* elements;
         bool hasAttachedValues;
+        // contiguous values (NULL if the array has been created with elements)
+        char* values;
+        unsigned long length;
+
+        // Creates a Scalar for a contiguous value of type ScalarType.
+        template<int ScalarType> Scalar* createScalar(unsigned long index) const;
+
+        typedef Scalar* (ArrayPrivate::*ScalarFactory)(unsigned long index) const;
+        // Gets the function which creates the Scalar instances for the contiguous values of the
+        // array type.
+        ScalarFactory getScalarFactory() const;
     };
 
     Array::Array(int arrayType, const std::vector<const Variant*>* elements, bool attachValues) {
@@ -19,6 +33,12 @@ namespace IODataProviderNamespace {
         d->arrayType = arrayType;
         d->elements = elements;
         d->hasAttachedValues = attachValues;
+        d->values = NULL;
+        d->length = elements == NULL ? 0 : elements->size();
+    }
+
+    Array::Array() {
+        d = new ArrayPrivate();
     }
 
     Array::Array(const Array& array) {
@@ -28,8 +48,15 @@ namespace IODataProviderNamespace {
         }
         d = new ArrayPrivate();
         d->arrayType = array.d->arrayType;
+        d->values = NULL;
+        d->length = array.d->length;
         std::vector<const Variant*>* newElements = NULL;
-        if (array.d->elements != NULL) {
+        if (array.d->values != NULL) {
+            // copy the contiguous values; the elements are created on demand
+            size_t size = d->length * getElementSize(d->arrayType);
+            d->values = new char[size];
+            memcpy(d->values, array.d->values, size);
+        } else if (array.d->elements != NULL) {
             newElements = new std::vector<const Variant*>();
             for (std::vector<const Variant*>::const_iterator i =
                     array.d->elements->begin(); i != array.d->elements->end(); i++) {
@@ -50,6 +77,7 @@ namespace IODataProviderNamespace {
                 delete d->elements;
             }
         }
+        delete[] d->values;
         delete d;
     }
 
@@ -57,8 +85,88 @@ namespace IODataProviderNamespace {
         return d->arrayType;
     }
 
+    unsigned long Array::getLength() const {
+        return d->length;
+    }
+
     const std::vector<const Variant*>* Array::getElements() const {
-        return d->elements;
+        // the elements are published with a full barrier (readers of the same instance
+        // may call this method concurrently)
+        const std::vector<const Variant*>* ret = d->elements;
+        __sync_synchronize();
+        if (ret == NULL && d->values != NULL) {
+            std::vector<const Variant*>* elements = new std::vector<const Variant*>();
+            elements->reserve(d->length);
+            ArrayPrivate::ScalarFactory createScalar = d->getScalarFactory();
+            for (unsigned long i = 0; i < d->length; i++) {
+                elements->push_back((d->*createScalar)(i));
+            }
+            if (__sync_bool_compare_and_swap(&d->elements,
+                    static_cast<const std::vector<const Variant*>*> (NULL), elements)) {
+                ret = elements;
+            } else {
+                // another thread has created the elements
+                for (std::vector<const Variant*>::const_iterator i = elements->begin();
+                        i != elements->end(); i++) {
+                    delete *i;
+                }
+                delete elements;
+                ret = d->elements;
+            }
+        }
+        return ret;
+    }
+
+    bool Array::hasElements() const {
+        return d->elements != NULL;
+    }
+
+    const void* Array::getValues() const {
+        return d->values;
+    }
+
+    void* Array::getValues() {
+        return d->values;
+    }
+
+    size_t Array::getElementSize(int arrayType) {
+        switch (arrayType) {
+            case Scalar::BOOL:
+                return sizeof (ScalarTraits<Scalar::BOOL>::ElementType);
+            case Scalar::SCHAR:
+                return sizeof (ScalarTraits<Scalar::SCHAR>::ElementType);
+            case Scalar::CHAR:
+                return sizeof (ScalarTraits<Scalar::CHAR>::ElementType);
+            case Scalar::INT:
+                return sizeof (ScalarTraits<Scalar::INT>::ElementType);
+            case Scalar::UINT:
+                return sizeof (ScalarTraits<Scalar::UINT>::ElementType);
+            case Scalar::LONG:
+                return sizeof (ScalarTraits<Scalar::LONG>::ElementType);
+            case Scalar::ULONG:
+                return sizeof (ScalarTraits<Scalar::ULONG>::ElementType);
+            case Scalar::LLONG:
+                return sizeof (ScalarTraits<Scalar::LLONG>::ElementType);
+            case Scalar::ULLONG:
+                return sizeof (ScalarTraits<Scalar::ULLONG>::ElementType);
+            case Scalar::FLOAT:
+                return sizeof (ScalarTraits<Scalar::FLOAT>::ElementType);
+            case Scalar::DOUBLE:
+                return sizeof (ScalarTraits<Scalar::DOUBLE>::ElementType);
+            default:
+                return 0;
+        }
+    }
+
+    Array* Array::createTypedArray(int arrayType, unsigned long length) {
+        Array* ret = new Array();
+        ret->d->arrayType = arrayType;
+        ret->d->elements = NULL;
+        ret->d->hasAttachedValues = true;
+        // value-initialized with 0
+        ret->d->values = new char[length * getElementSize(arrayType)]();
+        ret->d->length = length;
+        return ret;
     }
 
     Variant* Array::copy() const {
@@ -72,7 +180,17 @@ namespace IODataProviderNamespace {
     std::string Array::toString() const {
         std::ostringstream msg;
         msg << "IODataProviderNamespace::Array[type=" << d->arrayType << ",elements=";
-        if (d->elements == NULL) {
+        if (d->values != NULL) {
+            ArrayPrivate::ScalarFactory createScalar = d->getScalarFactory();
+            for (unsigned long i = 0; i < d->length; i++) {
+                if (i > 0) {
+                    msg << ",";
+                }
+                Scalar* s = (d->*createScalar)(i);
+                msg << s->toString();
+                delete s;
+            }
+        } else if (d->elements == NULL) {
             msg << "<NULL>";
         } else {
             for (std::vector<const Variant*>::const_iterator i = d->elements->begin();
@@ -87,4 +205,40 @@ namespace IODataProviderNamespace {
         return msg.str();
     }
 
+    template<int ScalarType> Scalar* ArrayPrivate::createScalar(unsigned long index) const {
+        typedef ScalarTraits<ScalarType> Traits;
+        Scalar* ret = new Scalar();
+        Traits::set(*ret, static_cast<typename Traits::Type> (
+                reinterpret_cast<const typename Traits::ElementType*> (values)[index]));
+        return ret;
+    }
+
+    ArrayPrivate::ScalarFactory ArrayPrivate::getScalarFactory() const {
+        switch (arrayType) {
+            case Scalar::BOOL:
+                return &ArrayPrivate::createScalar<Scalar::BOOL>;
+            case Scalar::SCHAR:
+                return &ArrayPrivate::createScalar<Scalar::SCHAR>;
+            case Scalar::CHAR:
+                return &ArrayPrivate::createScalar<Scalar::CHAR>;
+            case Scalar::INT:
+                return &ArrayPrivate::createScalar<Scalar::INT>;
+            case Scalar::UINT:
+                return &ArrayPrivate::createScalar<Scalar::UINT>;
+            case Scalar::LONG:
+                return &ArrayPrivate::createScalar<Scalar::LONG>;
+            case Scalar::ULONG:
+                return &ArrayPrivate::createScalar<Scalar::ULONG>;
+            case Scalar::LLONG:
+                return &ArrayPrivate::createScalar<Scalar::LLONG>;
+            case Scalar::ULLONG:
+                return &ArrayPrivate::createScalar<Scalar::ULLONG>;
+            case Scalar::FLOAT:
+                return &ArrayPrivate::createScalar<Scalar::FLOAT>;
+            case Scalar::DOUBLE:
+            default: // contiguous values only exist for the types of Array::getElementSize
+                return &ArrayPrivate::createScalar<Scalar::DOUBLE>;
+        }
+    }
+
 } // namespace IODataProviderNamespace
@@ -0,0 +1,642 @@
+#include <ioDataProvider/IODataProviderGroup.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <common/Exception.h>
+#include <common/Mutex.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <pthread.h> // pthread_t
+#include <deque>
+#include <map>
+#include <sstream> // std::ostringstream
+#include <stddef.h> // NULL
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+
+namespace IODataProviderNamespace {
+
+    class IODataProviderGroupPrivate {
+        friend class IODataProviderGroup;
+    private:
+
+        class PrefixRoute {
+        public:
+            int namespaceIndex;
+            std::string prefix;
+            int providerIndex;
+        };
+
+        // A sub request for one provider of the group.
+        class Task {
+        public:
+
+            enum Type {
+                READ, WRITE, CALL, SUBSCRIBE, UNSUBSCRIBE
+            };
+
+            Type type;
+            IODataProvider* provider;
+            // positions of the request entries in the original request
+            std::vector<int> positions;
+            std::vector<const NodeId*> nodeIds;
+            std::vector<const NodeData*> nodeData;
+            std::vector<const MethodData*> methodData;
+            bool sendValuesChangedEvents;
+            SubscriberCallback* callback;
+
+            std::vector<NodeData*>* nodeDataResults;
+            std::vector<MethodData*>* methodDataResults;
+            Exception* exception;
+            // whether a worker has processed the task
+            bool isDone;
+
+            Task(Type type, IODataProvider& provider) {
+                this->type = type;
+                this->provider = &provider;
+                sendValuesChangedEvents = false;
+                callback = NULL;
+                nodeDataResults = NULL;
+                methodDataResults = NULL;
+                exception = NULL;
+                isDone = false;
+            }
+
+            ~Task() {
+                VectorScopeGuard<NodeData> nodeDataResultsSG(nodeDataResults);
+                VectorScopeGuard<MethodData> methodDataResultsSG(methodDataResults);
+                delete exception;
+            }
+        };
+
+        // A thread which processes the sub requests of one provider in the order of their
+        // arrival.
+        class Worker {
+        public:
+            pthread_t thread;
+            // protects the queue, the state of the queued tasks and the closed flag
+            pthread_mutex_t mutex;
+            // signals new tasks, processed tasks and the closing of the worker
+            pthread_cond_t cond;
+            std::deque<Task*> queue;
+            bool isClosed;
+        };
+
+        Logger* log;
+
+        std::vector<IODataProvider*> providers;
+        bool hasAttachedValues;
+        // provider index -> worker (NULL for the first provider: the sub request for the
+        // first provider is always processed by the calling thread)
+        std::vector<Worker*> workers;
+
+        Mutex* mutex;
+        // namespaceUri -> provider index
+        std::map<std::string, int> namespaceUriRoutes;
+        // namespace index -> provider index
+        std::map<int, int> namespaceIndexRoutes;
+        std::vector<PrefixRoute> prefixRoutes;
+
+        int getProviderIndex(IODataProvider& provider) /* throws IODataProviderException */;
+        void addNamespaceIndexRoute(const std::string& namespaceUri, int namespaceIndex);
+        int resolve(const NodeId& nodeId);
+        // Gets the provider index for a namespace (the default provider if no route exists).
+        int resolve(int namespaceIndex);
+
+        // Gets the task for a provider or creates a new one.
+        Task& getTask(std::map<int, Task*>& tasks, Task::Type type, int providerIndex);
+        // Starts a worker for each provider except the first one.
+        void startWorkers() /* throws IODataProviderException */;
+        // Stops the started workers.
+        void stopWorkers();
+        static void* runWorker(void* worker);
+        // Processes the tasks in parallel. The current thread processes the first task and
+        // the remaining tasks are queued to the workers of their providers.
+        void run(std::map<int, Task*>& tasks);
+        static void runTask(Task& task);
+        // Sets a copy of the task exception to each returned node data.
+        void setException(Task& task, std::vector<NodeData*>& results,
+                const std::vector<const NodeId*>& nodeIds);
+        void throwFirstException(std::map<int, Task*>& tasks) /* throws IODataProviderException */;
+        void deleteTasks(std::map<int, Task*>& tasks);
+    };
+
+    IODataProviderGroup::IODataProviderGroup(const std::vector<IODataProvider*>& providers,
+            bool attachValues) /* throws IODataProviderException */ {
+        if (providers.size() == 0) {
+            throw ExceptionDef(IODataProviderException,
+                    std::string("A group of IO data providers requires at least one provider"));
+        }
+        d = new IODataProviderGroupPrivate();
+        d->log = LoggerFactory::getLogger("IODataProviderGroup");
+        d->providers = providers;
+        d->hasAttachedValues = attachValues;
+        d->mutex = new Mutex(); // MutexException
+        try {
+            d->startWorkers(); // IODataProviderException
+        } catch (Exception& e) {
+            delete d->mutex;
+            delete d;
+            throw;
+        }
+    }
+
+    IODataProviderGroup::~IODataProviderGroup() {
+        d->stopWorkers();
+        if (d->hasAttachedValues) {
+            for (std::vector<IODataProvider*>::iterator i = d->providers.begin();
+                    i != d->providers.end(); i++) {
+                delete *i;
+            }
+        }
+        delete d->mutex;
+        delete d;
+    }
+
+    void IODataProviderGroup::addNamespaceRoute(const std::string& namespaceUri,
+            IODataProvider& provider) /* throws IODataProviderException */ {
+        int providerIndex = d->getProviderIndex(provider); // IODataProviderException
+        pthread_mutex_lock(&d->mutex->getMutex());
+        d->namespaceUriRoutes[namespaceUri] = providerIndex;
+        pthread_mutex_unlock(&d->mutex->getMutex());
+    }
+
+    void IODataProviderGroup::addNodeIdPrefixRoute(int namespaceIndex, const std::string& prefix,
+            IODataProvider& provider) /* throws IODataProviderException */ {
+        IODataProviderGroupPrivate::PrefixRoute route;
+        route.namespaceIndex = namespaceIndex;
+        route.prefix = prefix;
+        route.providerIndex = d->getProviderIndex(provider); // IODataProviderException
+        pthread_mutex_lock(&d->mutex->getMutex());
+        d->prefixRoutes.push_back(route);
+        pthread_mutex_unlock(&d->mutex->getMutex());
+    }
+
+    IODataProvider& IODataProviderGroup::getProvider(const NodeId& nodeId) {
+        return *d->providers[d->resolve(nodeId)];
+    }
+
+    void IODataProviderGroup::open(const std::string& confDir) /* throws IODataProviderException */ {
+        for (std::vector<IODataProvider*>::iterator i = d->providers.begin();
+                i != d->providers.end(); i++) {
+            (*i)->open(confDir); // IODataProviderException
+        }
+    }
+
+    void IODataProviderGroup::open(JNIEnv *env, jobject properties, jobject dataProvider)
+    /* throws IODataProviderException */ {
+        for (std::vector<IODataProvider*>::iterator i = d->providers.begin();
+                i != d->providers.end(); i++) {
+            (*i)->open(env, properties, dataProvider); // IODataProviderException
+        }
+    }
+
+    void IODataProviderGroup::close() {
+        for (std::vector<IODataProvider*>::iterator i = d->providers.begin();
+                i != d->providers.end(); i++) {
+            (*i)->close();
+        }
+    }
+
+    const NodeProperties* IODataProviderGroup::getDefaultNodeProperties(
+            const std::string& namespaceUri, int namespaceId) /* throws IODataProviderException */ {
+        d->addNamespaceIndexRoute(namespaceUri, namespaceId);
+        pthread_mutex_lock(&d->mutex->getMutex());
+        std::map<int, int>::const_iterator route = d->namespaceIndexRoutes.find(namespaceId);
+        int providerIndex = route == d->namespaceIndexRoutes.end() ? 0 : (*route).second;
+        pthread_mutex_unlock(&d->mutex->getMutex());
+        return d->providers[providerIndex]->getDefaultNodeProperties(namespaceUri,
+                namespaceId); // IODataProviderException
+    }
+
+    std::vector<const NodeData*>* IODataProviderGroup::getNodeProperties(
+            const std::string& namespaceUri, int namespaceId) /* throws IODataProviderException */ {
+        d->addNamespaceIndexRoute(namespaceUri, namespaceId);
+        std::vector<const NodeData*>* ret = new std::vector<const NodeData*>();
+        VectorScopeGuard<const NodeData> retSG(ret);
+        // for each provider
+        for (int providerIndex = 0; providerIndex < d->providers.size(); providerIndex++) {
+            std::vector<const NodeData*>* nodeProps =
+                    d->providers[providerIndex]->getNodeProperties(namespaceUri,
+                    namespaceId); // IODataProviderException
+            if (nodeProps == NULL) {
+                continue;
+            }
+            // keep the properties of the nodes which are routed to the provider
+            for (std::vector<const NodeData*>::iterator i = nodeProps->begin();
+                    i != nodeProps->end(); i++) {
+                if (d->resolve((*i)->getNodeId()) == providerIndex) {
+                    ret->push_back(*i);
+                } else {
+                    delete *i;
+                }
+            }
+            delete nodeProps;
+        }
+        return retSG.detach();
+    }
+
+    std::vector<NodeData*>* IODataProviderGroup::read(
+            const std::vector<const NodeId*>& nodeIds) /* throws IODataProviderException */ {
+        if (d->providers.size() == 1) {
+            return d->providers[0]->read(nodeIds); // IODataProviderException
+        }
+        std::map<int, IODataProviderGroupPrivate::Task*> tasks;
+        for (int i = 0; i < nodeIds.size(); i++) {
+            IODataProviderGroupPrivate::Task& task = d->getTask(tasks,
+                    IODataProviderGroupPrivate::Task::READ, d->resolve(*nodeIds[i]));
+            task.positions.push_back(i);
+            task.nodeIds.push_back(nodeIds[i]);
+        }
+        d->run(tasks);
+        // merge the results in the order of the request
+        std::vector<NodeData*>* ret = new std::vector<NodeData*>(nodeIds.size(), NULL);
+        for (std::map<int, IODataProviderGroupPrivate::Task*>::iterator i = tasks.begin();
+                i != tasks.end(); i++) {
+            IODataProviderGroupPrivate::Task& task = *(*i).second;
+            d->setException(task, *ret, nodeIds);
+            if (task.nodeDataResults == NULL) {
+                continue;
+            }
+            for (int j = 0; j < task.positions.size(); j++) {
+                (*ret)[task.positions[j]] = (*task.nodeDataResults)[j];
+            }
+            task.nodeDataResults->clear();
+        }
+        d->deleteTasks(tasks);
+        return ret;
+    }
+
+    void IODataProviderGroup::write(const std::vector<const NodeData*>& nodeData,
+            bool sendValuesChangedEvents) /* throws IODataProviderException */ {
+        if (d->providers.size() == 1) {
+            d->providers[0]->write(nodeData, sendValuesChangedEvents); // IODataProviderException
+            return;
+        }
+        std::map<int, IODataProviderGroupPrivate::Task*> tasks;
+        for (int i = 0; i < nodeData.size(); i++) {
+            IODataProviderGroupPrivate::Task& task = d->getTask(tasks,
+                    IODataProviderGroupPrivate::Task::WRITE,
+                    d->resolve(nodeData[i]->getNodeId()));
+            task.positions.push_back(i);
+            task.nodeData.push_back(nodeData[i]);
+            task.sendValuesChangedEvents = sendValuesChangedEvents;
+        }
+        d->run(tasks);
+        d->throwFirstException(tasks); // IODataProviderException
+    }
+
+    std::vector<MethodData*>* IODataProviderGroup::call(
+            const std::vector<const MethodData*>& methodData) /* throws IODataProviderException */ {
+        if (d->providers.size() == 1) {
+            return d->providers[0]->call(methodData); // IODataProviderException
+        }
+        std::map<int, IODataProviderGroupPrivate::Task*> tasks;
+        for (int i = 0; i < methodData.size(); i++) {
+            IODataProviderGroupPrivate::Task& task = d->getTask(tasks,
+                    IODataProviderGroupPrivate::Task::CALL,
+                    d->resolve(methodData[i]->getMethodNodeId()));
+            task.positions.push_back(i);
+            task.methodData.push_back(methodData[i]);
+        }
+        d->run(tasks);
+        // merge the results in the order of the request
+        std::vector<MethodData*>* ret = new std::vector<MethodData*>(methodData.size(), NULL);
+        for (std::map<int, IODataProviderGroupPrivate::Task*>::iterator i = tasks.begin();
+                i != tasks.end(); i++) {
+            IODataProviderGroupPrivate::Task& task = *(*i).second;
+            if (task.exception == NULL && (task.methodDataResults == NULL
+                    || task.methodDataResults->size() != task.positions.size())) {
+                std::ostringstream msg;
+                msg << "Invalid count of method data returned from IO data provider: "
+                        << (task.methodDataResults == NULL ? 0 : task.methodDataResults->size())
+                        << "/" << task.positions.size();
+                task.exception = new ExceptionDef(IODataProviderException, msg.str());
+            }
+            for (int j = 0; j < task.positions.size(); j++) {
+                MethodData* result;
+                if (task.exception == NULL) {
+                    result = (*task.methodDataResults)[j];
+                } else {
+                    result = new MethodData(*methodData[task.positions[j]]);
+                    result->setException(
+                            static_cast<IODataProviderException*> (task.exception->copy()));
+                }
+                (*ret)[task.positions[j]] = result;
+            }
+            if (task.methodDataResults != NULL && task.exception == NULL) {
+                task.methodDataResults->clear();
+            }
+        }
+        d->deleteTasks(tasks);
+        return ret;
+    }
+
+    std::vector<NodeData*>* IODataProviderGroup::subscribe(
+            const std::vector<const NodeId*>& nodeIds,
+            SubscriberCallback& callback) /* throws IODataProviderException */ {
+        if (d->providers.size() == 1) {
+            return d->providers[0]->subscribe(nodeIds, callback); // IODataProviderException
+        }
+        std::map<int, IODataProviderGroupPrivate::Task*> tasks;
+        for (int i = 0; i < nodeIds.size(); i++) {
+            IODataProviderGroupPrivate::Task& task = d->getTask(tasks,
+                    IODataProviderGroupPrivate::Task::SUBSCRIBE, d->resolve(*nodeIds[i]));
+            task.positions.push_back(i);
+            task.nodeIds.push_back(nodeIds[i]);
+            task.callback = &callback;
+        }
+        d->run(tasks);
+        // merge the results in the order of the request
+        std::vector<NodeData*>* ret = new std::vector<NodeData*>(nodeIds.size(), NULL);
+        for (std::map<int, IODataProviderGroupPrivate::Task*>::iterator i = tasks.begin();
+                i != tasks.end(); i++) {
+            IODataProviderGroupPrivate::Task& task = *(*i).second;
+            d->setException(task, *ret, nodeIds);
+            if (task.nodeDataResults == NULL) {
+                continue;
+            }
+            for (int j = 0; j < task.positions.size(); j++) {
+                (*ret)[task.positions[j]] = (*task.nodeDataResults)[j];
+            }
+            task.nodeDataResults->clear();
+        }
+        d->deleteTasks(tasks);
+        return ret;
+    }
+
+    void IODataProviderGroup::unsubscribe(
+            const std::vector<const NodeId*>& nodeIds) /* throws IODataProviderException */ {
+        if (d->providers.size() == 1) {
+            d->providers[0]->unsubscribe(nodeIds); // IODataProviderException
+            return;
+        }
+        std::map<int, IODataProviderGroupPrivate::Task*> tasks;
+        for (int i = 0; i < nodeIds.size(); i++) {
+            IODataProviderGroupPrivate::Task& task = d->getTask(tasks,
+                    IODataProviderGroupPrivate::Task::UNSUBSCRIBE, d->resolve(*nodeIds[i]));
+            task.positions.push_back(i);
+            task.nodeIds.push_back(nodeIds[i]);
+        }
+        d->run(tasks);
+        d->throwFirstException(tasks); // IODataProviderException
+    }
+
+    void IODataProviderGroup::notification(JNIEnv *env, int ns, jobject id, jobject value) {
+        d->providers[d->resolve(ns)]->notification(env, ns, id, value);
+    }
+
+    void IODataProviderGroup::event(JNIEnv *env, int eNs, jobject event, int pNs, jobject param,
+            long timestamp, int severity, jstring msg, jobject value) {
+        // the event is routed via the namespace of the event type
+        d->providers[d->resolve(eNs)]->event(env, eNs, event, pNs, param, timestamp, severity,
+                msg, value);
+    }
+
+    void IODataProviderGroup::setNodeBrowser(SASModelProviderNamespace::NodeBrowser* nodeBrowser) {
+        for (std::vector<IODataProvider*>::iterator i = d->providers.begin();
+                i != d->providers.end(); i++) {
+            (*i)->setNodeBrowser(nodeBrowser);
+        }
+    }
+
+    int IODataProviderGroupPrivate::getProviderIndex(IODataProvider& provider)
+    /* throws IODataProviderException */ {
+        for (int i = 0; i < providers.size(); i++) {
+            if (providers[i] == &provider) {
+                return i;
+            }
+        }
+        throw ExceptionDef(IODataProviderException,
+                std::string("The IO data provider is not a member of the group"));
+    }
+
+    void IODataProviderGroupPrivate::addNamespaceIndexRoute(const std::string& namespaceUri,
+            int namespaceIndex) {
+        pthread_mutex_lock(&mutex->getMutex());
+        std::map<std::string, int>::const_iterator route = namespaceUriRoutes.find(namespaceUri);
+        if (route != namespaceUriRoutes.end()) {
+            namespaceIndexRoutes[namespaceIndex] = (*route).second;
+            if (log->isInfoEnabled()) {
+                log->info("Routing namespace %d (%s) to IO data provider %d", namespaceIndex,
+                        namespaceUri.c_str(), (*route).second);
+            }
+        }
+        pthread_mutex_unlock(&mutex->getMutex());
+    }
+
+    int IODataProviderGroupPrivate::resolve(const NodeId& nodeId) {
+        int ret = 0;
+        pthread_mutex_lock(&mutex->getMutex());
+        // get the longest matching prefix
+        bool hasPrefixRoute = false;
+        size_t prefixLength = 0;
+        if (nodeId.getNodeType() == NodeId::STRING) {
+            const std::string& id = nodeId.getString();
+            for (std::vector<PrefixRoute>::const_iterator i = prefixRoutes.begin();
+                    i != prefixRoutes.end(); i++) {
+                const PrefixRoute& route = *i;
+                if ((route.namespaceIndex < 0
+                        || route.namespaceIndex == nodeId.getNamespaceIndex())
+                        && route.prefix.length() >= prefixLength
+                        && id.compare(0, route.prefix.length(), route.prefix) == 0) {
+                    hasPrefixRoute = true;
+                    prefixLength = route.prefix.length();
+                    ret = route.providerIndex;
+                }
+            }
+        }
+        pthread_mutex_unlock(&mutex->getMutex());
+        return hasPrefixRoute ? ret : resolve(nodeId.getNamespaceIndex());
+    }
+
+    int IODataProviderGroupPrivate::resolve(int namespaceIndex) {
+        int ret = 0;
+        pthread_mutex_lock(&mutex->getMutex());
+        std::map<int, int>::const_iterator route = namespaceIndexRoutes.find(namespaceIndex);
+        if (route != namespaceIndexRoutes.end()) {
+            ret = (*route).second;
+        }
+        pthread_mutex_unlock(&mutex->getMutex());
+        return ret;
+    }
+
+    IODataProviderGroupPrivate::Task& IODataProviderGroupPrivate::getTask(
+            std::map<int, Task*>& tasks, Task::Type type, int providerIndex) {
+        std::map<int, Task*>::iterator i = tasks.find(providerIndex);
+        if (i != tasks.end()) {
+            return *(*i).second;
+        }
+        Task* task = new Task(type, *providers[providerIndex]);
+        tasks[providerIndex] = task;
+        return *task;
+    }
+
+    void IODataProviderGroupPrivate::startWorkers() /* throws IODataProviderException */ {
+        workers.resize(providers.size(), NULL);
+        for (int i = 1; i < providers.size(); i++) {
+            Worker* worker = new Worker();
+            worker->isClosed = false;
+            pthread_mutex_init(&worker->mutex, NULL /*attr*/);
+            pthread_cond_init(&worker->cond, NULL /*attr*/);
+            if (pthread_create(&worker->thread, NULL /*attr*/,
+                    &IODataProviderGroupPrivate::runWorker, worker) != 0) {
+                pthread_cond_destroy(&worker->cond);
+                pthread_mutex_destroy(&worker->mutex);
+                delete worker;
+                stopWorkers();
+                throw ExceptionDef(IODataProviderException,
+                        std::string("Cannot start thread for IO data provider"));
+            }
+            workers[i] = worker;
+        }
+    }
+
+    void IODataProviderGroupPrivate::stopWorkers() {
+        for (std::vector<Worker*>::iterator i = workers.begin(); i != workers.end(); i++) {
+            Worker* worker = *i;
+            if (worker == NULL) {
+                continue;
+            }
+            pthread_mutex_lock(&worker->mutex);
+            worker->isClosed = true;
+            pthread_cond_broadcast(&worker->cond);
+            pthread_mutex_unlock(&worker->mutex);
+            pthread_join(worker->thread, NULL /*return*/);
+            pthread_cond_destroy(&worker->cond);
+            pthread_mutex_destroy(&worker->mutex);
+            delete worker;
+        }
+        workers.clear();
+    }
+
+    void* IODataProviderGroupPrivate::runWorker(void* object) {
+        Worker& worker = *static_cast<Worker*> (object);
+        pthread_mutex_lock(&worker.mutex);
+        while (true) {
+            if (worker.queue.size() > 0) {
+                Task* task = worker.queue.front();
+                worker.queue.pop_front();
+                pthread_mutex_unlock(&worker.mutex);
+                runTask(*task);
+                pthread_mutex_lock(&worker.mutex);
+                task->isDone = true;
+                pthread_cond_broadcast(&worker.cond);
+            } else if (worker.isClosed) {
+                break;
+            } else {
+                pthread_cond_wait(&worker.cond, &worker.mutex);
+            }
+        }
+        pthread_mutex_unlock(&worker.mutex);
+        return NULL;
+    }
+
+    void IODataProviderGroupPrivate::run(std::map<int, Task*>& tasks) {
+        std::map<int, Task*>::iterator first = tasks.begin();
+        if (first == tasks.end()) {
+            return;
+        }
+        // queue the remaining tasks to the workers
+        std::map<int, Task*>::iterator i = first;
+        for (i++; i != tasks.end(); i++) {
+            Worker& worker = *workers[(*i).first];
+            pthread_mutex_lock(&worker.mutex);
+            worker.queue.push_back((*i).second);
+            pthread_cond_broadcast(&worker.cond);
+            pthread_mutex_unlock(&worker.mutex);
+        }
+        runTask(*(*first).second);
+        // wait for the workers
+        i = first;
+        for (i++; i != tasks.end(); i++) {
+            Worker& worker = *workers[(*i).first];
+            Task& task = *(*i).second;
+            pthread_mutex_lock(&worker.mutex);
+            while (!task.isDone) {
+                pthread_cond_wait(&worker.cond, &worker.mutex);
+            }
+            pthread_mutex_unlock(&worker.mutex);
+        }
+    }
+
+    void IODataProviderGroupPrivate::runTask(Task& task) {
+        try {
+            switch (task.type) {
+                case Task::READ:
+                    task.nodeDataResults = task.provider->read(task.nodeIds); // IODataProviderException
+                    break;
+                case Task::WRITE:
+                    task.provider->write(task.nodeData,
+                            task.sendValuesChangedEvents); // IODataProviderException
+                    break;
+                case Task::CALL:
+                    task.methodDataResults = task.provider->call(task.methodData); // IODataProviderException
+                    break;
+                case Task::SUBSCRIBE:
+                    task.nodeDataResults = task.provider->subscribe(task.nodeIds,
+                            *task.callback); // IODataProviderException
+                    break;
+                case Task::UNSUBSCRIBE:
+                    task.provider->unsubscribe(task.nodeIds); // IODataProviderException
+                    break;
+            }
+        } catch (Exception& e) {
+            IODataProviderException* exception = new ExceptionDef(IODataProviderException,
+                    std::string("Processing of request by IO data provider failed"));
+            exception->setCause(&e);
+            task.exception = exception;
+        } catch (...) {
+            task.exception = new ExceptionDef(IODataProviderException,
+                    std::string("Processing of request by IO data provider failed with an unknown exception"));
+        }
+    }
+
+    void IODataProviderGroupPrivate::setException(Task& task, std::vector<NodeData*>& results,
+            const std::vector<const NodeId*>& nodeIds) {
+        if (task.exception == NULL && (task.nodeDataResults == NULL
+                || task.nodeDataResults->size() != task.positions.size())) {
+            std::ostringstream msg;
+            msg << "Invalid count of node data returned from IO data provider: "
+                    << (task.nodeDataResults == NULL ? 0 : task.nodeDataResults->size())
+                    << "/" << task.positions.size();
+            task.exception = new ExceptionDef(IODataProviderException, msg.str());
+        }
+        if (task.exception == NULL) {
+            return;
+        }
+        for (int i = 0; i < task.positions.size(); i++) {
+            int position = task.positions[i];
+            NodeData* result = new NodeData(*new NodeId(*nodeIds[position]), NULL /* data */,
+                    true /* attachValues */);
+            result->setException(static_cast<IODataProviderException*> (task.exception->copy()));
+            results[position] = result;
+        }
+        // the results of the task are replaced
+        VectorScopeGuard<NodeData> nodeDataResultsSG(task.nodeDataResults);
+        task.nodeDataResults = NULL;
+    }
+
+    void IODataProviderGroupPrivate::throwFirstException(std::map<int, Task*>& tasks)
+    /* throws IODataProviderException */ {
+        for (std::map<int, Task*>::iterator i = tasks.begin(); i != tasks.end(); i++) {
+            Task& task = *(*i).second;
+            if (task.exception != NULL) {
+                IODataProviderException e = *static_cast<IODataProviderException*> (task.exception);
+                deleteTasks(tasks);
+                throw e;
+            }
+        }
+        deleteTasks(tasks);
+    }
+
+    void IODataProviderGroupPrivate::deleteTasks(std::map<int, Task*>& tasks) {
+        for (std::map<int, Task*>::iterator i = tasks.begin(); i != tasks.end(); i++) {
+            delete (*i).second;
+        }
+        tasks.clear();
+    }
+
+} // namespace IODataProviderNamespace
@@ -0,0 +1,43 @@
+#include <ioDataProvider/MessageRegistry.h>
+#include <pthread.h> // pthread_mutex_t
+#include <map>
+#include <vector>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+namespace IODataProviderNamespace {
+
+    // protects the messages
+    static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    // message id => message
+    static std::vector<std::string> messages;
+    // message => message id
+    static std::map<std::string, int> messageIds;
+
+    int MessageRegistry::registerMessage(const std::string& message) {
+        pthread_mutex_lock(&mutex);
+        int ret;
+        std::map<std::string, int>::const_iterator i = messageIds.find(message);
+        if (i == messageIds.end()) {
+            ret = messages.size();
+            messages.push_back(message);
+            messageIds[message] = ret;
+        } else {
+            ret = (*i).second;
+        }
+        pthread_mutex_unlock(&mutex);
+        return ret;
+    }
+
+    std::string MessageRegistry::getMessage(int messageId) {
+        std::string ret;
+        pthread_mutex_lock(&mutex);
+        if (messageId >= 0 && messageId < messages.size()) {
+            ret = messages[messageId];
+        }
+        pthread_mutex_unlock(&mutex);
+        return ret;
+    }
+
+} // namespace IODataProviderNamespace
@@ -1,5 +1,7 @@
 #include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/MessageRegistry.h>
 #include <stddef.h> // NULL
+#include <stdio.h> // snprintf
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
@@ -10,9 +12,16 @@ namespace IODataProviderNamespace {
         friend class NodeData;
     private:
         bool hasAttachedValues;
+        bool hasAttachedNodeId;
         const NodeId* nodeId;
         const Variant* data;
         IODataProviderException* exception;
+        unsigned long statusCode;
+        int messageId;
+        // exception created from the status code (it is always owned by the instance)
+        IODataProviderException* statusException;
+
+        static const unsigned long BAD = 0x80000000;
     };
 
     NodeData::NodeData(const NodeId& nodeId, const Variant* data, bool attachValues) {
@@ -20,7 +29,24 @@ namespace IODataProviderNamespace {
         d->nodeId = &nodeId;
         d->data = data;
         d->exception = NULL;
+        d->statusCode = 0;
+        d->messageId = -1;
+        d->statusException = NULL;
         d->hasAttachedValues = attachValues;
+        d->hasAttachedNodeId = attachValues;
+    }
+
+    NodeData::NodeData(const NodeId& nodeId, const Variant* data, bool attachValues,
+            bool attachNodeId) {
+        d = new NodeDataPrivate();
+        d->nodeId = &nodeId;
+        d->data = data;
+        d->exception = NULL;
+        d->statusCode = 0;
+        d->messageId = -1;
+        d->statusException = NULL;
+        d->hasAttachedValues = attachValues;
+        d->hasAttachedNodeId = attachNodeId;
     }
 
     NodeData::NodeData(const NodeData& nodeData) {
@@ -30,18 +56,25 @@ namespace IODataProviderNamespace {
         }
         d = new NodeDataPrivate();
         d->hasAttachedValues = true;
+        d->hasAttachedNodeId = true;
         d->nodeId = new NodeId(*nodeData.d->nodeId);
         d->data = nodeData.d->data == NULL ? NULL : nodeData.d->data->copy();
         d->exception = nodeData.d->exception == NULL ?
                 NULL : static_cast<IODataProviderException*> (nodeData.d->exception->copy());
+        d->statusCode = nodeData.d->statusCode;
+        d->messageId = nodeData.d->messageId;
+        d->statusException = NULL;
     }
 
     NodeData::~NodeData() {
-        if (d->hasAttachedValues) {
+        if (d->hasAttachedNodeId) {
             delete d->nodeId;
+        }
+        if (d->hasAttachedValues) {
             delete d->data;
             delete d->exception;
         }
+        delete d->statusException;
         delete d;
     }
 
@@ -49,6 +82,13 @@ namespace IODataProviderNamespace {
         return *d->nodeId;
     }
 
+    void NodeData::copyNodeId() {
+        if (!d->hasAttachedNodeId) {
+            d->nodeId = new NodeId(*d->nodeId);
+            d->hasAttachedNodeId = true;
+        }
+    }
+
     const Variant* NodeData::getData() const {
         return d->data;
     }
@@ -61,7 +101,21 @@ namespace IODataProviderNamespace {
     }
 
     IODataProviderException* NodeData::getException() const {
-        return d->exception;
+        if (d->exception != NULL || (d->statusCode & NodeDataPrivate::BAD) == 0) {
+            return d->exception;
+        }
+        if (d->statusException == NULL) {
+            char statusCode[11];
+            snprintf(statusCode, sizeof (statusCode), "0x%08lX", d->statusCode);
+            std::string msg = MessageRegistry::getMessage(d->messageId);
+            if (msg.empty()) {
+                msg = "Failed to process node";
+            }
+            d->statusException = new ExceptionDef(IODataProviderException,
+                    msg.append(" (").append(d->nodeId->toString()).append(", status code ")
+                    .append(statusCode).append(")"));
+        }
+        return d->statusException;
     }
 
     void NodeData::setException(IODataProviderException* e) {
@@ -71,15 +125,38 @@ namespace IODataProviderNamespace {
         d->exception = e;
     }
 
+    void NodeData::setStatus(unsigned long statusCode, int messageId) {
+        d->statusCode = statusCode;
+        d->messageId = messageId;
+        delete d->statusException;
+        d->statusException = NULL;
+    }
+
+    unsigned long NodeData::getStatusCode() const {
+        if (d->statusCode == 0 && d->exception != NULL) {
+            return NodeDataPrivate::BAD;
+        }
+        return d->statusCode;
+    }
+
+    int NodeData::getMessageId() const {
+        return d->messageId;
+    }
+
+    bool NodeData::hasError() const {
+        return d->exception != NULL || (d->statusCode & NodeDataPrivate::BAD) != 0;
+    }
+
     std::string NodeData::toString() const {
         std::string st;
-        if (d->exception != NULL) {
-            d->exception->getStackTrace(st);
+        IODataProviderException* exception = getException();
+        if (exception != NULL) {
+            exception->getStackTrace(st);
         }
         return std::string("IODataProviderNamespace::NodeData[nodeId=")
                 .append(d->nodeId->toString())
                 .append(",data=").append(d->data == NULL ? "<NULL>" : d->data->toString())
-                .append(",exception=").append(d->exception == NULL ? "<NULL>" : st)
+                .append(",exception=").append(exception == NULL ? "<NULL>" : st)
                 .append("]");
     }
 
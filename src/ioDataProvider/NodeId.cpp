@@ -6,82 +6,68 @@
 
 namespace IODataProviderNamespace {
 
-    class NodeIdPrivate {
-        friend class NodeId;
-    private:
-        int namespaceIndex;
-        NodeId::Type nodeType;
-        bool hasAttachedValues;
-
-        union {
-            long numericId;
-            const std::string* stringId;
-        };
-
-        void setNumeric(int namespaceIndex, long id);
-        void setString(int namespaceIndex, const std::string& id);
-        void init(bool attachValues);
-        void clear();
-    };
-
     NodeId::NodeId(int namespaceIndex, long id) {
-        d = new NodeIdPrivate();
-        d->init(false /* attachValues */);
-        d->setNumeric(namespaceIndex, id);
+        this->namespaceIndex = namespaceIndex;
+        nodeType = NUMERIC;
+        numericId = id;
     }
 
     NodeId::NodeId(int namespaceIndex, const std::string& id, bool attachValues) {
-        d = new NodeIdPrivate();
-        d->init(attachValues);
-        d->setString(namespaceIndex, id);
+        this->namespaceIndex = namespaceIndex;
+        nodeType = STRING;
+        numericId = 0;
+        if (attachValues) {
+            // take over the content of the attached string
+            stringId.swap(const_cast<std::string&> (id));
+            delete &id;
+        } else {
+            stringId = id;
+        }
     }
 
-    NodeId::NodeId(const NodeId& nodeId) {
-        // avoid self-assignment
-        if (this == &nodeId) {
-            return;
-        }
-        d = new NodeIdPrivate();
-        d->namespaceIndex = nodeId.d->namespaceIndex;
-        d->nodeType = nodeId.d->nodeType;
-        d->hasAttachedValues = true;
-        switch (d->nodeType) {
-            case NUMERIC:
-                d->numericId = nodeId.d->numericId;
-                break;
-            case STRING:
-                d->stringId = new std::string(*nodeId.d->stringId);
-                break;
-        }
+    NodeId::NodeId(const NodeId& nodeId) :
+    stringId(nodeId.stringId) {
+        namespaceIndex = nodeId.namespaceIndex;
+        nodeType = nodeId.nodeType;
+        numericId = nodeId.numericId;
     }
 
     NodeId::~NodeId() {
-        d->clear();
-        delete d;
     }
 
     bool NodeId::equals(const NodeId& nodeId) const {
-        return d->namespaceIndex == nodeId.d->namespaceIndex
-                && d->nodeType == nodeId.d->nodeType
-                && (d->nodeType == NUMERIC ?
-                d->numericId == nodeId.d->numericId :
-                *d->stringId == *nodeId.d->stringId);
+        if (namespaceIndex != nodeId.namespaceIndex || nodeType != nodeId.nodeType) {
+            return false;
+        }
+        return nodeType == NUMERIC ? numericId == nodeId.numericId
+                : stringId == nodeId.stringId;
+    }
+
+    bool NodeId::Less::operator()(const NodeId& nodeId1, const NodeId& nodeId2) const {
+        if (nodeId1.namespaceIndex != nodeId2.namespaceIndex) {
+            return nodeId1.namespaceIndex < nodeId2.namespaceIndex;
+        }
+        if (nodeId1.nodeType != nodeId2.nodeType) {
+            return nodeId1.nodeType < nodeId2.nodeType;
+        }
+        return nodeId1.nodeType == NUMERIC ? nodeId1.numericId < nodeId2.numericId
+                : nodeId1.stringId < nodeId2.stringId;
     }
 
     NodeId::Type NodeId::getNodeType() const {
-        return d->nodeType;
+        return nodeType;
     }
 
     int NodeId::getNamespaceIndex() const {
-        return d->namespaceIndex;
+        return namespaceIndex;
     }
 
     long NodeId::getNumeric() const {
-        return d->numericId;
+        return numericId;
     }
 
     const std::string& NodeId::getString() const {
-        return *d->stringId;
+        return stringId;
     }
 
     Variant* NodeId::copy() const {
@@ -95,47 +81,16 @@ namespace IODataProviderNamespace {
     std::string NodeId::toString() const {
         std::ostringstream msg;
         msg << "IODataProviderNamespace::NodeId[type=";
-        switch (d->nodeType) {
+        switch (nodeType) {
             case NodeId::NUMERIC:
-                msg << "numeric,ns=" << d->namespaceIndex << ",value=" << d->numericId;
+                msg << "numeric,ns=" << namespaceIndex << ",value=" << getNumeric();
                 break;
             case NodeId::STRING:
-                msg << "string,ns=" << d->namespaceIndex << ",value=" << d->stringId->c_str();
+                msg << "string,ns=" << namespaceIndex << ",value=" << getString().c_str();
                 break;
         }
         msg << "]";
         return msg.str();
     }
 
-    void NodeIdPrivate::setNumeric(int namespaceIndex, long id) {
-        clear();
-        this->namespaceIndex = namespaceIndex;
-        nodeType = NodeId::NUMERIC;
-        numericId = id;
-    }
-
-    void NodeIdPrivate::setString(int namespaceIndex, const std::string& id) {
-        clear();
-        this->namespaceIndex = namespaceIndex;
-        nodeType = NodeId::STRING;
-        stringId = &id;
-    }
-
-    void NodeIdPrivate::init(bool attachValues) {
-        nodeType = NodeId::NUMERIC;
-        hasAttachedValues = attachValues;
-    }
-
-    void NodeIdPrivate::clear() {
-        if (hasAttachedValues) {
-            switch (nodeType) {
-                case NodeId::STRING:
-                    delete stringId;
-                    break;
-                default:
-                    break;
-            }
-        }
-    }
-
 } // namespace IODataProviderNamespace
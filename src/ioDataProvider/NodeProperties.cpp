@@ -9,11 +9,19 @@ namespace IODataProviderNamespace {
         friend class NodeProperties;
     private:
         NodeProperties::ValueHandling valueHandling;
+        bool hasIngressFilter;
+        bool ingressSuppressEqualValues;
+        double ingressAbsoluteDeadband;
+        double ingressPercentDeadband;
     };
 
     NodeProperties::NodeProperties(ValueHandling valueHandling) {
         d = new NodePropertiesPrivate();
         d->valueHandling = valueHandling;
+        d->hasIngressFilter = false;
+        d->ingressSuppressEqualValues = false;
+        d->ingressAbsoluteDeadband = 0;
+        d->ingressPercentDeadband = 0;
     }
 
     NodeProperties::NodeProperties(const NodeProperties& nodeProperties) {
@@ -22,7 +30,7 @@ namespace IODataProviderNamespace {
             return;
         }
         d = new NodePropertiesPrivate();
-        d->valueHandling = nodeProperties.d->valueHandling;
+        *d = *nodeProperties.d;
     }
 
     NodeProperties::~NodeProperties() {
@@ -37,6 +45,30 @@ namespace IODataProviderNamespace {
         d->valueHandling = valueHandling;
     }
 
+    void NodeProperties::setIngressFilter(bool suppressEqualValues, double absoluteDeadband,
+            double percentDeadband) {
+        d->hasIngressFilter = true;
+        d->ingressSuppressEqualValues = suppressEqualValues;
+        d->ingressAbsoluteDeadband = absoluteDeadband;
+        d->ingressPercentDeadband = percentDeadband;
+    }
+
+    bool NodeProperties::hasIngressFilter() const {
+        return d->hasIngressFilter;
+    }
+
+    bool NodeProperties::getIngressSuppressEqualValues() const {
+        return d->ingressSuppressEqualValues;
+    }
+
+    double NodeProperties::getIngressAbsoluteDeadband() const {
+        return d->ingressAbsoluteDeadband;
+    }
+
+    double NodeProperties::getIngressPercentDeadband() const {
+        return d->ingressPercentDeadband;
+    }
+
     Variant* NodeProperties::copy() const {
         return new NodeProperties(*this);
     }
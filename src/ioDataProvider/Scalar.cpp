@@ -8,267 +8,182 @@
 
 namespace IODataProviderNamespace {
 
-    class ScalarPrivate {
-        friend class Scalar;
-    private:
-        Scalar::Type scalarType;
-        bool hasAttachedValues;
-        long byteStringLengthValue;
-        const std::string* localizedTextLocaleValue;
-
-        union {
-            bool boolValue;
-            signed char scharValue;
-            char charValue;
-            int intValue;
-            unsigned int uintValue;
-            long longValue;
-            unsigned long ulongValue;
-            long long llongValue;
-            unsigned long long ullongValue;
-            double floatValue;
-            double doubleValue;
-            const std::string* stringValue; // localizedTextText
-            const char* byteStringValue;
-        };
-
-        void clear();
-    };
-
     Scalar::Scalar() {
-        d = new ScalarPrivate();
-        d->scalarType = Scalar::INT;
-        d->hasAttachedValues = false;
+        scalarType = INT;
+        hasText = false;
+        hasLocale = false;
         setInt(0);
     }
 
-    Scalar::Scalar(const Scalar& value) {
-        // avoid self-assignment
-        if (this == &value) {
-            return;
-        }
-        d = new ScalarPrivate();
-        d->scalarType = value.d->scalarType;
-        d->hasAttachedValues = true;
-        switch (d->scalarType) {
-            case BOOL:
-                d->boolValue = value.d->boolValue;
-                break;
-            case SCHAR:
-                d->scharValue = value.d->scharValue;
-                break;
-            case CHAR:
-                d->charValue = value.d->charValue;
-                break;
-            case INT:
-                d->intValue = value.d->intValue;
-                break;
-            case UINT:
-                d->uintValue = value.d->uintValue;
-                break;
-            case LONG:
-                d->longValue = value.d->longValue;
-                break;
-            case ULONG:
-                d->ulongValue = value.d->ulongValue;
-                break;
-            case LLONG:
-                d->llongValue = value.d->llongValue;
-                break;
-            case ULLONG:
-                d->ullongValue = value.d->ullongValue;
-                break;
-            case FLOAT:
-                d->floatValue = value.d->floatValue;
-                break;
-            case DOUBLE:
-                d->doubleValue = value.d->doubleValue;
-                break;
-            case STRING:
-                d->stringValue = value.d->stringValue == NULL ? NULL
-                        : new std::string(*value.d->stringValue);
-                break;
-            case BYTE_STRING:
-            {
-                d->byteStringLengthValue = value.d->byteStringLengthValue;
-                char* chars = NULL;
-                if (value.d->byteStringValue != NULL) {
-                    chars = new char[d->byteStringLengthValue];
-                    memcpy(chars, value.d->byteStringValue, d->byteStringLengthValue * sizeof (char));
-                }
-                d->byteStringValue = chars;
-                break;
-            }
-            case LOCALIZED_TEXT:
-                d->localizedTextLocaleValue = value.d->localizedTextLocaleValue == NULL
-                        ? NULL : new std::string(*value.d->localizedTextLocaleValue);
-                d->stringValue = value.d->stringValue == NULL
-                        ? NULL : new std::string(*value.d->stringValue);
-                break;
-        }
+    Scalar::Scalar(const Scalar& orig) :
+    text(orig.text), locale(orig.locale) {
+        scalarType = orig.scalarType;
+        // inline values are copied, buffers are shared
+        value = orig.value;
+        hasText = orig.hasText;
+        hasLocale = orig.hasLocale;
     }
 
-    Scalar::~Scalar() {        
-        d->clear();
-        delete d;
+    Scalar::~Scalar() {
+        clear();
     }
 
     Scalar::Type Scalar::getScalarType() const {
-        return d->scalarType;
+        return scalarType;
     }
 
     bool Scalar::getBool() const {
-        return d->boolValue;
+        return value.getNumeric().boolValue;
     }
 
     void Scalar::setBool(bool value) {
-        d->clear();
-        d->scalarType = BOOL;
-        d->boolValue = value;
+        clear();
+        scalarType = BOOL;
+        this->value.setNumeric().boolValue = value;
     }
 
     signed char Scalar::getSChar() const {
-        return d->scharValue;
+        return value.getNumeric().scharValue;
     }
 
     void Scalar::setSChar(signed char value) {
-        d->clear();
-        d->scalarType = SCHAR;
-        d->scharValue = value;
+        clear();
+        scalarType = SCHAR;
+        this->value.setNumeric().scharValue = value;
     }
 
     char Scalar::getChar() const {
-        return d->charValue;
+        return value.getNumeric().charValue;
     }
 
     void Scalar::setChar(char value) {
-        d->clear();
-        d->scalarType = CHAR;
-        d->charValue = value;
+        clear();
+        scalarType = CHAR;
+        this->value.setNumeric().charValue = value;
     }
 
     int Scalar::getInt() const {
-        return d->intValue;
+        return value.getNumeric().intValue;
     }
 
     void Scalar::setInt(int value) {
-        d->clear();
-        d->scalarType = INT;
-        d->intValue = value;
+        clear();
+        scalarType = INT;
+        this->value.setNumeric().intValue = value;
     }
 
     unsigned int Scalar::getUInt() const {
-        return d->uintValue;
+        return value.getNumeric().uintValue;
     }
 
     void Scalar::setUInt(unsigned int value) {
-        d->clear();
-        d->scalarType = UINT;
-        d->uintValue = value;
+        clear();
+        scalarType = UINT;
+        this->value.setNumeric().uintValue = value;
     }
 
     long Scalar::getLong() const {
-        return d->longValue;
+        return value.getNumeric().longValue;
     }
 
     void Scalar::setLong(long value) {
-        d->clear();
-        d->scalarType = LONG;
-        d->longValue = value;
+        clear();
+        scalarType = LONG;
+        this->value.setNumeric().longValue = value;
     }
 
     unsigned long Scalar::getULong() const {
-        return d->ulongValue;
+        return value.getNumeric().ulongValue;
     }
 
     void Scalar::setULong(unsigned long value) {
-        d->clear();
-        d->scalarType = ULONG;
-        d->ulongValue = value;
+        clear();
+        scalarType = ULONG;
+        this->value.setNumeric().ulongValue = value;
     }
 
     long long Scalar::getLLong() const {
-        return d->llongValue;
+        return value.getNumeric().llongValue;
     }
 
     void Scalar::setLLong(long long value) {
-        d->clear();
-        d->scalarType = LLONG;
-        d->llongValue = value;
+        clear();
+        scalarType = LLONG;
+        this->value.setNumeric().llongValue = value;
     }
 
     unsigned long long Scalar::getULLong() const {
-        return d->ullongValue;
+        return value.getNumeric().ullongValue;
     }
 
     void Scalar::setULLong(unsigned long long value) {
-        d->clear();
-        d->scalarType = ULLONG;
-        d->ullongValue = value;
+        clear();
+        scalarType = ULLONG;
+        this->value.setNumeric().ullongValue = value;
     }
 
     float Scalar::getFloat() const {
-        return d->floatValue;
+        return value.getNumeric().floatValue;
     }
 
     void Scalar::setFloat(float value) {
-        d->clear();
-        d->scalarType = FLOAT;
-        d->floatValue = value;
+        clear();
+        scalarType = FLOAT;
+        this->value.setNumeric().floatValue = value;
     }
 
     double Scalar::getDouble() const {
-        return d->doubleValue;
+        return value.getNumeric().doubleValue;
     }
 
     void Scalar::setDouble(double value) {
-        d->clear();
-        d->scalarType = DOUBLE;
-        d->doubleValue = value;
+        clear();
+        scalarType = DOUBLE;
+        this->value.setNumeric().doubleValue = value;
     }
 
     const std::string* Scalar::getString() const {
-        return d->stringValue;
+        return hasText ? &text : NULL;
     }
 
     void Scalar::setString(const std::string* value, bool attachValue) {
-        d->clear();
-        d->scalarType = STRING;
-        d->stringValue = value;
-        d->hasAttachedValues = attachValue;
+        clear();
+        scalarType = STRING;
+        hasText = assignString(text, value, attachValue);
     }
 
     const char* Scalar::getByteString() const {
-        return d->byteStringValue;
+        return value.getBytes();
     }
 
     long Scalar::getByteStringLength() const {
-        return d->byteStringLengthValue;
+        return value.getLength();
     }
 
     void Scalar::setByteString(const char* value, long length, bool attachValue) {
-        d->clear();
-        d->scalarType = BYTE_STRING;
-        d->byteStringLengthValue = length;
-        d->byteStringValue = value;
-        d->hasAttachedValues = attachValue;
+        clear();
+        scalarType = BYTE_STRING;
+        if (attachValue) {
+            this->value.attachBytes(const_cast<char*> (value), length);
+        } else {
+            this->value.setBytes(value, length);
+        }
     }
 
     const std::string* Scalar::getLocalizedTextLocale() const {
-        return d->localizedTextLocaleValue;
+        return hasLocale ? &locale : NULL;
     }
 
     const std::string* Scalar::getLocalizedTextText() const {
-        return d->stringValue;
+        return getString();
     }
 
     void Scalar::setLocalizedText(const std::string* locale, const std::string* text,
             bool attachValues) {
-        d->clear();
-        d->scalarType = LOCALIZED_TEXT;
-        d->localizedTextLocaleValue = locale;
-        d->stringValue = text;
-        d->hasAttachedValues = attachValues;
+        clear();
+        scalarType = LOCALIZED_TEXT;
+        hasLocale = assignString(this->locale, locale, attachValues);
+        hasText = assignString(this->text, text, attachValues);
     }
 
     Variant* Scalar::copy() const {
@@ -282,86 +197,96 @@ namespace IODataProviderNamespace {
     std::string Scalar::toString() const {
         std::ostringstream msg;
         msg << "IODataProviderNamespace::Scalar[type=";
-        switch (d->scalarType) {
+        switch (scalarType) {
             case BOOL:
-                msg << "bool,value=" << d->boolValue;
+                msg << "bool,value=" << getBool();
                 break;
             case SCHAR:
-                msg << "byte,value=" << d->scharValue;
+                msg << "byte,value=" << getSChar();
                 break;
             case CHAR:
-                msg << "char,value=" << d->charValue;
+                msg << "char,value=" << getChar();
                 break;
             case INT:
-                msg << "int,value=" << d->intValue;
+                msg << "int,value=" << getInt();
                 break;
             case UINT:
-                msg << "uint,value=" << d->uintValue;
+                msg << "uint,value=" << getUInt();
                 break;
             case LONG:
-                msg << "long,value=" << d->longValue;
+                msg << "long,value=" << getLong();
                 break;
             case ULONG:
-                msg << "ulong,value=" << d->ulongValue;
+                msg << "ulong,value=" << getULong();
                 break;
             case LLONG:
-                msg << "llong,value=" << d->llongValue;
+                msg << "llong,value=" << getLLong();
                 break;
             case ULLONG:
-                msg << "ullong,value=" << d->ullongValue;
+                msg << "ullong,value=" << getULLong();
                 break;
             case FLOAT:
-                msg << "float,value=" << d->floatValue;
+                msg << "float,value=" << getFloat();
                 break;
             case DOUBLE:
-                msg << "double,value=" << d->doubleValue;
+                msg << "double,value=" << getDouble();
                 break;
             case STRING:
-                msg << "string,value=" << (d->stringValue == NULL ? "<NULL>" : *d->stringValue);
+            {
+                const std::string* string = getString();
+                msg << "string,value=" << (string == NULL ? "<NULL>" : *string);
                 break;
+            }
             case BYTE_STRING:
                 msg << "byteString,value=";
-                if (d->byteStringValue == NULL) {
+                if (getByteString() == NULL) {
                     msg << "<NULL>";
                 } else {
                     msg << std::hex;
-                    for (size_t i = 0; i < d->byteStringLengthValue; i++) {
+                    const char* bytes = getByteString();
+                    for (long i = 0; i < getByteStringLength(); i++) {
                         if (i > 0) {
                             msg << ' ';
                         }
                         char s[11]; // 0xfffffffe
-                        sprintf(s, "0x%x", d->byteStringValue[i]);
+                        sprintf(s, "0x%x", bytes[i]);
                         msg << s;
                     }
                 }
                 break;
             case LOCALIZED_TEXT:
-                msg << "localizedText,locale=" << (d->localizedTextLocaleValue == NULL
-                        ? "<NULL>" : *d->localizedTextLocaleValue)
-                        << ",text=" << (d->stringValue == NULL ? "<NULL>" : *d->stringValue);
+            {
+                const std::string* locale = getLocalizedTextLocale();
+                const std::string* text = getLocalizedTextText();
+                msg << "localizedText,locale=" << (locale == NULL ? "<NULL>" : *locale)
+                        << ",text=" << (text == NULL ? "<NULL>" : *text);
                 break;
+            }
         }
         msg << "]";
         return msg.str();
     }
 
-    void ScalarPrivate::clear() {
-        if (hasAttachedValues) {
-            switch (scalarType) {
-                case Scalar::STRING:
-                    delete stringValue;
-                    break;
-                case Scalar::BYTE_STRING:
-                    delete[] byteStringValue;
-                    break;
-                case Scalar::LOCALIZED_TEXT:
-                    delete localizedTextLocaleValue;
-                    delete stringValue;
-                    break;
-                default:
-                    break;
-            }
+    bool Scalar::assignString(std::string& dest, const std::string* src, bool attachValue) {
+        if (src == NULL) {
+            return false;
+        }
+        if (attachValue) {
+            dest.swap(*const_cast<std::string*> (src));
+            delete src;
+        } else {
+            dest.assign(*src);
         }
+        return true;
+    }
+
+    void Scalar::clear() {
+        value.clear();
+        // keep the capacity of the strings for following values
+        text.clear();
+        locale.clear();
+        hasText = false;
+        hasLocale = false;
     }
 
 } // namespace IODataProviderNamespace
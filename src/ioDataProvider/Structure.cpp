@@ -1,4 +1,5 @@
 #include <ioDataProvider/Structure.h>
+#include <vector>
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
@@ -9,7 +10,10 @@ namespace IODataProviderNamespace {
         friend class Structure;
     private:
         const NodeId* dataTypeId;
-        const std::map<std::string, const Variant*>* fieldData;
+        std::vector<Structure::Field> fields;
+        // field name => field value (the attached map or NULL until the first call of
+        // getFieldData)
+        std::map<std::string, const Variant*>* fieldData;
         bool hasAttachedValues;
     };
 
@@ -17,8 +21,21 @@ namespace IODataProviderNamespace {
             const std::map<std::string, const Variant*>& fieldData, bool attachValues) {
         d = new StructurePrivate();
         d->dataTypeId = &dataTypeId;
-        d->fieldData = &fieldData;
+        d->fieldData = NULL;
         d->hasAttachedValues = attachValues;
+        d->fields.reserve(fieldData.size());
+        for (std::map<std::string, const Variant*>::const_iterator i = fieldData.begin();
+                i != fieldData.end(); i++) {
+            addField((*i).first, *(*i).second);
+        }
+        if (attachValues) {
+            // the attached map is provided by getFieldData
+            d->fieldData = const_cast<std::map<std::string, const Variant*>*> (&fieldData);
+        }
+    }
+
+    Structure::Structure() {
+        d = new StructurePrivate();
     }
 
     Structure::Structure(const Structure& orig) {
@@ -28,26 +45,24 @@ namespace IODataProviderNamespace {
         }
         d = new StructurePrivate();
         d->dataTypeId = new NodeId(*orig.d->dataTypeId);
-        std::map<std::string, const Variant*>* fieldData = new std::map<std::string, const Variant*>();
-        for (std::map<std::string, const Variant*>::const_iterator i =
-                orig.d->fieldData->begin(); i != orig.d->fieldData->end(); i++) {
-            const std::string& fieldName = (*i).first;
-            const Variant* fieldValue = (*i).second->copy();
-            fieldData->insert(std::pair<std::string, const Variant*>(fieldName, fieldValue));
-        }
-        d->fieldData = fieldData;
+        d->fieldData = NULL;
         d->hasAttachedValues = true;
+        d->fields.reserve(orig.d->fields.size());
+        for (std::vector<Field>::const_iterator i = orig.d->fields.begin();
+                i != orig.d->fields.end(); i++) {
+            addField((*i).name, *(*i).value->copy());
+        }
     }
 
     Structure::~Structure() {
         if (d->hasAttachedValues) {
             delete d->dataTypeId;
-            for (std::map<std::string, const Variant*>::const_iterator i =
-                    d->fieldData->begin(); i != d->fieldData->end(); i++) {
-                delete (*i).second;
+            for (std::vector<Field>::const_iterator i = d->fields.begin();
+                    i != d->fields.end(); i++) {
+                delete (*i).value;
             }
-            delete d->fieldData;
         }
+        delete d->fieldData;
         delete d;
     }
 
@@ -56,7 +71,66 @@ namespace IODataProviderNamespace {
     }
 
     const std::map<std::string, const Variant*>& Structure::getFieldData() const {
-        return *d->fieldData;
+        // the map is read and published atomically (readers of the same instance may call
+        // this method concurrently)
+        std::map<std::string, const Variant*>* ret = __sync_val_compare_and_swap(&d->fieldData,
+                static_cast<std::map<std::string, const Variant*>*> (NULL),
+                static_cast<std::map<std::string, const Variant*>*> (NULL));
+        if (ret == NULL) {
+            std::map<std::string, const Variant*>* fieldData =
+                    new std::map<std::string, const Variant*>();
+            for (std::vector<Field>::const_iterator i = d->fields.begin();
+                    i != d->fields.end(); i++) {
+                (*fieldData)[(*i).name] = (*i).value;
+            }
+            ret = __sync_val_compare_and_swap(&d->fieldData,
+                    static_cast<std::map<std::string, const Variant*>*> (NULL), fieldData);
+            if (ret == NULL) {
+                ret = fieldData;
+            } else {
+                // another thread has created the map
+                delete fieldData;
+            }
+        }
+        return *ret;
+    }
+
+    size_t Structure::getFieldCount() const {
+        return d->fields.size();
+    }
+
+    const Structure::Field& Structure::getField(size_t index) const {
+        return d->fields[index];
+    }
+
+    const Variant* Structure::getFieldValue(const std::string& name, size_t hint) const {
+        size_t count = d->fields.size();
+        for (size_t i = 0; i < count; i++) {
+            const Field& field = d->fields[(hint + i) % count];
+            if (field.name == name) {
+                return field.value;
+            }
+        }
+        return NULL;
+    }
+
+    void Structure::addField(const std::string& name, const Variant& value) {
+        d->fields.push_back(Field());
+        Field& field = d->fields.back();
+        field.name = name;
+        field.value = &value;
+        if (d->fieldData != NULL) {
+            (*d->fieldData)[name] = &value;
+        }
+    }
+
+    Structure* Structure::createStructure(const NodeId& dataTypeId, size_t fieldCount) {
+        Structure* ret = new Structure();
+        ret->d->dataTypeId = &dataTypeId;
+        ret->d->fieldData = NULL;
+        ret->d->hasAttachedValues = true;
+        ret->d->fields.reserve(fieldCount);
+        return ret;
     }
 
     Variant* Structure::copy() const {
@@ -70,13 +144,12 @@ namespace IODataProviderNamespace {
     std::string Structure::toString() const {
         std::string ret("IODataProviderNamespace::Structure[dataTypeId=");
         ret.append(d->dataTypeId->toString()).append(",fieldData=");
-        int index = 0;
-        for (std::map<std::string, const Variant*>::const_iterator i = d->fieldData->begin();
-                i != d->fieldData->end(); i++, index++) {
-            if (index > 0) {
+        for (std::vector<Field>::const_iterator i = d->fields.begin(); i != d->fields.end();
+                i++) {
+            if (i != d->fields.begin()) {
                 ret.append(" ");
             }
-            ret.append((*i).first).append("=>").append((*i).second->toString());
+            ret.append((*i).name).append("=>").append((*i).value->toString());
         }
         return ret.append("]");
     }
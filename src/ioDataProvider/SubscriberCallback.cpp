@@ -8,4 +8,11 @@ SubscriberCallback::SubscriberCallback() {
 SubscriberCallback::~SubscriberCallback() {
 }
 
+bool SubscriberCallback::isEventMonitored(const NodeId& eventTypeId) {
+    return true;
+}
+
+void SubscriberCallback::eventSkipped(const NodeId& eventTypeId) {
+}
+
 }
@@ -1,4 +1,6 @@
 #include "JDataProvider.h"
+#include "Java2IO.h"
+#include "../common/ConversionException.h"
 #include "../messages/ConverterBin2IO.h"
 #include "../messages/dto/Call.h"
 #include "../messages/dto/CallResponse.h"
@@ -14,6 +16,7 @@
 #include "../messages/dto/UnsubscribeResponse.h"
 #include "../messages/dto/Write.h"
 #include "../messages/dto/WriteResponse.h"
+#include <common/ArenaScope.h>
 #include <common/Exception.h>
 #include <common/Mutex.h>
 #include <common/MutexLock.h>
@@ -22,6 +25,7 @@
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/MessageRegistry.h>
 #include <ioDataProvider/OpcUaEventData.h>
 #include <pthread.h> // pthread_t
 #include <sstream> // std::ostringstream
@@ -49,9 +53,52 @@ private:
 		IODataProviderNamespace::SubscriberCallback* callback;
 	};
 
+	class ConverterCallback: public SASModelProviderNamespace::ConverterUa2IO::ConverterCallback {
+	public:
+
+		ConverterCallback(Mutex& mutex) {
+			this->mutex = &mutex;
+			nodeBrowser = NULL;
+		}
+
+		void setNodeBrowser(SASModelProviderNamespace::NodeBrowser* nodeBrowser) {
+			MutexLock lock(*mutex);
+			this->nodeBrowser = nodeBrowser;
+		}
+
+		virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId) {
+			return getNodeBrowser().getStructureDefinition(dataTypeId);
+		}
+
+		virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& nodeId) {
+			return getNodeBrowser().getSuperTypes(nodeId);
+		}
+
+		virtual UaNodeId getBuildInType(const UaNodeId& typeId) {
+			return getNodeBrowser().getBuildInType(typeId);
+		}
+
+	private:
+		Mutex* mutex;
+		SASModelProviderNamespace::NodeBrowser* nodeBrowser;
+
+		SASModelProviderNamespace::NodeBrowser& getNodeBrowser() /* throws ConversionException */ {
+			MutexLock lock(*mutex);
+			if (nodeBrowser == NULL) {
+				throw ExceptionDef(ConversionException, std::string("Missing node browser"));
+			}
+			return *nodeBrowser;
+		}
+	};
+
 	Logger* log;
 
 	ConverterBin2IO converter;
+	// provides the data types of the node browser to java2io
+	ConverterCallback* converterCallback;
+	// converts values directly to the IO data provider model (types are resolved via the
+	// node browser)
+	Java2IO* java2io;
 
 	bool unitTesting;
 	int namespaceIndex;
@@ -61,12 +108,20 @@ private:
 
 	std::vector<CallbackData*> callbacks;
 
+	// id of the message for nodes which cannot be read
+	int readFailedMessageId;
 };
 
 JDataProvider::JDataProvider(bool unitTesting) /* throws MutexException */{
 	d = new JDataProviderPrivate();
 	d->log = LoggerFactory::getLogger("JDataProvider");
 	d->mutex = new Mutex(); // MutexException
+	d->converterCallback = new JDataProviderPrivate::ConverterCallback(*d->mutex);
+	d->java2io = new Java2IO(*d->converterCallback, true /* attachValues */); // MutexException
+	d->namespaceIndex = 0;
+	d->messageIdCounter = 0;
+	d->readFailedMessageId = IODataProviderNamespace::MessageRegistry::registerMessage(
+			"Cannot read data");
 	nodeBrowser = NULL;
 	jvm = NULL;
 	native2j = NULL;
@@ -78,6 +133,7 @@ JDataProvider::~JDataProvider() {
 		delete native2j;
 	}
 	close();
+	delete d->java2io;
 	delete d->mutex;
 	delete d;
 }
@@ -99,7 +155,10 @@ void JDataProvider::open(JNIEnv *env, jobject properties,
 }
 
 void JDataProvider::setNodeBrowser(SASModelProviderNamespace::NodeBrowser* nodeBrowser){
+	MutexLock lock(*d->mutex);
 	this->nodeBrowser = nodeBrowser;
+	// the resolved types of java2io are kept (the types of the address space are static)
+	d->converterCallback->setNodeBrowser(nodeBrowser);
 }
 
 void JDataProvider::close() {
@@ -138,27 +197,27 @@ bool JDataProvider::findFieldModel(const UaNodeId &start) {
 		}
 	} else {
 		//Child count 0
-		std::vector<UaNodeId>* superTypes = nodeBrowser->getSuperTypes(start); // ConversionException
-		ScopeGuard<std::vector<UaNodeId> > sSuperTypes(superTypes);
+		// the built-in type is taken from the type hierarchy without browsing
+		UaNodeId buildInType = nodeBrowser->getBuildInType(start); // NodeBrowserException
 		ModelType t;
-		if (superTypes->size() > 0) {
+		if (!buildInType.isNull()) {
 
-			if (superTypes->back().namespaceIndex() != 0) {
+			if (buildInType.namespaceIndex() != 0) {
 				t.type = ModelType::REF;
-				if (superTypes->back().identifierType()
+				if (buildInType.identifierType()
 						== OpcUa_IdentifierType_Numeric) {
-					t.ref = ParamId(superTypes->back().namespaceIndex(),
-							superTypes->back().identifierNumeric()).toString();
+					t.ref = ParamId(buildInType.namespaceIndex(),
+							buildInType.identifierNumeric()).toString();
 				} else {
 					t.ref =
-							ParamId(superTypes->back().namespaceIndex(),
+							ParamId(buildInType.namespaceIndex(),
 									UaString(
-											superTypes->back().identifierString()).toUtf8()).toString();
+											buildInType.identifierString()).toUtf8()).toString();
 				}
-				findFieldModel(superTypes->back());
+				findFieldModel(buildInType);
 			} else {
 				t.type = ModelType::TYPE;
-				t.t = superTypes->back().identifierNumeric();
+				t.t = buildInType.identifierNumeric();
 			}
 
 		} else {
@@ -259,6 +318,28 @@ std::string JDataProvider::getParamId(UaNodeId nId){
 	return std::string();
 }
 
+IODataProviderNamespace::Variant* JDataProvider::convertValue(JNIEnv* env, jobject value,
+		const UaNodeId& nodeId, ModelType& t, int namespaceIndex) {
+	UaVariable* uaVar = nodeBrowser->getVariable(nodeId);
+	if (uaVar != NULL) {
+		UaNodeId dataTypeId = uaVar->dataType();
+		uaVar->releaseReference();
+		try {
+			return d->java2io->convert(env, value, dataTypeId); // ConversionException
+		} catch (ConversionException& e) {
+			if (d->log->isDebugEnabled()) {
+				std::string st;
+				e.getStackTrace(st);
+				d->log->debug("Using generic conversion for %s: %s",
+						nodeId.toXmlString().toUtf8(), st.c_str());
+			}
+		}
+	}
+	Variant* v = native2j->getVariant(env, value, t.ref, t);
+	ScopeGuard<Variant> vSG(v);
+	return d->converter.convertBin2io(*v, namespaceIndex);
+}
+
 void JDataProvider::updateModel(UaNodeId nId){
 	bool changed = false;
 	UaVariable* uaVar = nodeBrowser->getVariable(nId);
@@ -272,6 +353,11 @@ void JDataProvider::updateModel(UaNodeId nId){
 
 std::vector<IODataProviderNamespace::NodeData*>* JDataProvider::read(
 		const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds) /* throws IODataProviderException */{
+	// the dto objects of the request are allocated from the arena of the thread and released
+	// at once when the request is finished (the STL containers and strings of the dto objects
+	// and the IO data provider values are still allocated from the heap; see the
+	// ConverterBin2IO/io2bin/*/arena benchmarks)
+	ArenaScope arenaScope;
 	unsigned long messageId;
 	int sendReceiveTimeout;
 	int namespaceIndex;
@@ -283,11 +369,19 @@ std::vector<IODataProviderNamespace::NodeData*>* JDataProvider::read(
 	std::vector<IODataProviderNamespace::NodeData*>* ret = new std::vector<
 			IODataProviderNamespace::NodeData*>();
 	VectorScopeGuard<IODataProviderNamespace::NodeData> retSG(ret);
+	// the thread is attached and the Java method is resolved once per request
+	JNIEnv *tmpEnv;
+	jvm->AttachCurrentThread((void **) &tmpEnv, NULL);
+	jclass havis_util_opcua_DataProvider = tmpEnv->FindClass(
+			"havis/util/opcua/DataProvider");
+	jmethodID havis_util_opcua_DataProvider_read = tmpEnv->GetMethodID(
+			havis_util_opcua_DataProvider, "read",
+			"(ILjava/lang/Object;)Ljava/lang/Object;");
 	// for each node
 	for (int i = 0; i < nodeIds.size(); i++) {
 		const IODataProviderNamespace::NodeId& nodeId = *nodeIds[i];
 		IODataProviderNamespace::Variant* nodeValue = NULL;
-		IODataProviderNamespace::IODataProviderException* exception = NULL;
+		OpcUa_StatusCode statusCode = OpcUa_Good;
 		try {
 			ParamId* paramId = d->converter.convertIo2bin(nodeId); // ConversionException
 			ScopeGuard<ParamId> sParamId(paramId);
@@ -295,68 +389,62 @@ std::vector<IODataProviderNamespace::NodeData*>* JDataProvider::read(
 
 			updateModel(uaNode);
 
-			JNIEnv *tmpEnv;
-			jvm->AttachCurrentThread((void **) &tmpEnv, NULL);
-			jclass havis_util_opcua_DataProvider = tmpEnv->FindClass(
-					"havis/util/opcua/DataProvider");
-
-			jmethodID havis_util_opcua_DataProvider_read = tmpEnv->GetMethodID(
-					havis_util_opcua_DataProvider, "read",
-					"(ILjava/lang/Object;)Ljava/lang/Object;");
-			jstring node = tmpEnv->NewStringUTF(paramId->toString().c_str());
-			if (paramId->getParamIdType() == ParamId::STRING) {
-				node = tmpEnv->NewStringUTF(paramId->getString().c_str());
-			}
+			jstring node = tmpEnv->NewStringUTF(
+					paramId->getParamIdType() == ParamId::STRING ?
+							paramId->getString().c_str() : paramId->toString().c_str());
 			jobject result = tmpEnv->CallObjectMethod(jDataProvider,
 					havis_util_opcua_DataProvider_read, namespaceIndex, node);
-
-			ReadResponse* readResponse = new ReadResponse(999, Status::SUCCESS);
-			ScopeGuard<ReadResponse> readResponseSG(readResponse);
-			if (readResponse->getStatus() == Status::SUCCESS) {
-				// convert param value
-				if (result != NULL) {
+			tmpEnv->DeleteLocalRef(node);
+			// convert param value
+			if (result != NULL) {
+				try {
 					ModelType t;
 					t.type = ModelType::REF;
 					t.ref = getParamId(uaNode);
-					if (t.ref.length()>0){
-						Variant* res = native2j->getVariant(tmpEnv, result, t.ref, t);
-						ScopeGuard<Variant> sRes(res);
-						nodeValue = d->converter.convertBin2io(
-								*res, namespaceIndex);
+					if (t.ref.length() > 0) {
+						nodeValue = convertValue(tmpEnv, result, uaNode, t,
+								namespaceIndex);
 					}
+				} catch (Exception& e) {
+					tmpEnv->DeleteLocalRef(result);
+					throw;
 				}
-			} else {
-				std::ostringstream msg;
-				msg << "Received a read response for "
-						<< nodeId.toString().c_str() << ": messageId="
-						<< messageId << ",status=" << readResponse->getStatus();
-				exception =
-						new ExceptionDef(IODataProviderNamespace::IODataProviderException,
-								msg.str());
+				tmpEnv->DeleteLocalRef(result);
 			}
-			jvm->DetachCurrentThread();
 		} catch (Exception& e) {
-			exception =
-					new ExceptionDef(IODataProviderNamespace::IODataProviderException,
-							std::string("Cannot read data for ").append(nodeId.toString()));
-			exception->setCause(&e);
+			// the node gets a status code; the exception is only created for debug logging
+			statusCode = OpcUa_BadCommunicationError;
+			if (d->log->isDebugEnabled()) {
+				IODataProviderNamespace::IODataProviderException ex =
+						ExceptionDef(IODataProviderNamespace::IODataProviderException,
+								std::string("Cannot read data for ").append(nodeId.toString()));
+				ex.setCause(&e);
+				std::string st;
+				ex.getStackTrace(st);
+				d->log->debug("Exception while reading: %s", st.c_str());
+			}
 		}
-		// add value to result list
+		// add value to result list (the node id of the request is referenced instead of a
+		// copy)
 		IODataProviderNamespace::NodeData* nodeData =
-				new IODataProviderNamespace::NodeData(
-						*new IODataProviderNamespace::NodeId(nodeId), nodeValue,
-						true /* attachValues */);
-		nodeData->setException(exception);
+				new IODataProviderNamespace::NodeData(nodeId, nodeValue,
+						true /* attachValues */, false /* attachNodeId */);
+		if (statusCode != OpcUa_Good) {
+			nodeData->setStatus(statusCode, d->readFailedMessageId);
+		}
 		ret->push_back(nodeData);
 		MutexLock lock(*d->mutex);
 		messageId = d->messageIdCounter++;
 	}
+	tmpEnv->DeleteLocalRef(havis_util_opcua_DataProvider);
+	jvm->DetachCurrentThread();
 	return retSG.detach();
 }
 
 void JDataProvider::write(
 		const std::vector<const IODataProviderNamespace::NodeData*>& nodeData,
 		bool sendValueChangedEvents) /* throws IODataProviderException */{
+	ArenaScope arenaScope;
 	unsigned long messageId;
 	int sendReceiveTimeout;
 	{
@@ -457,6 +545,7 @@ void JDataProvider::write(
 
 std::vector<IODataProviderNamespace::MethodData*>* JDataProvider::call(
 		const std::vector<const IODataProviderNamespace::MethodData*>& methodData) {
+	ArenaScope arenaScope;
 	std::vector<IODataProviderNamespace::MethodData*>* ret = new std::vector<
 			IODataProviderNamespace::MethodData*>();
 	VectorScopeGuard<IODataProviderNamespace::MethodData> retSG(ret);
@@ -786,6 +875,7 @@ void JDataProvider::unsubscribe(
 
 void JDataProvider::notification(JNIEnv *env, int ns, jobject id,
 		jobject value) {
+	ArenaScope arenaScope;
 	ParamId* paramIdp = native2j->createParamId(env, ns, id);
 	ScopeGuard<ParamId> sParamId(paramIdp);
 	IODataProviderNamespace::NodeId* ioNodeId = d->converter.convertBin2io(
@@ -802,11 +892,7 @@ void JDataProvider::notification(JNIEnv *env, int ns, jobject id,
 	t.type = ModelType::REF;
 	t.ref = getParamId(nId);
 
-	Variant* v = native2j->getVariant(env, value, t.ref, t);
-	ScopeGuard<Variant> sV(v);
-
-	IODataProviderNamespace::Variant* ioNodeValue = d->converter.convertBin2io(
-			*v, ns);
+	IODataProviderNamespace::Variant* ioNodeValue = convertValue(env, value, nId, t, ns);
 
 	ioNodeData->push_back(
 			new IODataProviderNamespace::NodeData(*ioNodeId, ioNodeValue,
@@ -824,9 +910,33 @@ void JDataProvider::notification(JNIEnv *env, int ns, jobject id,
 }
 
 void JDataProvider::event(JNIEnv *env, int eNs, jobject event, int pNs, jobject param, long timestamp, int severity, jstring msg, jobject value) {
+	ArenaScope arenaScope;
 
 	ParamId* eventIdp = native2j->createParamId(env, eNs, event);
 	ScopeGuard<ParamId> sEventIdp(eventIdp);
+	// eventTypeId
+	IODataProviderNamespace::NodeId* ioEventTypeId =
+	d->converter.convertBin2io(*eventIdp, eNs); // ConversionException
+	ScopeGuard<IODataProviderNamespace::NodeId> ioEventTypeIdSG(ioEventTypeId);
+	// skip the unmarshalling if no client receives the event
+	bool isMonitored = false;
+	IODataProviderNamespace::SubscriberCallback* unmonitoredCallback = NULL;
+	for (int i = 0; i < d->callbacks.size() && !isMonitored; i++) {
+		JDataProviderPrivate::CallbackData& callbackData = *d->callbacks[i];
+		if (callbackData.nodeId->equals(*ioEventTypeId)) {
+			isMonitored = callbackData.callback->isEventMonitored(*ioEventTypeId);
+			if (!isMonitored) {
+				unmonitoredCallback = callbackData.callback;
+			}
+		}
+	}
+	if (!isMonitored) {
+		// the event is subscribed but no client receives it
+		if (unmonitoredCallback != NULL) {
+			unmonitoredCallback->eventSkipped(*ioEventTypeId);
+		}
+		return;
+	}
 	ParamId* paramIdp = native2j->createParamId(env, pNs, param);
 	ScopeGuard<ParamId> sParamIdp(paramIdp);
 	IODataProviderNamespace::NodeId* srcNodeId = d->converter.convertBin2io(
@@ -887,11 +997,10 @@ void JDataProvider::event(JNIEnv *env, int eNs, jobject event, int pNs, jobject
 
 	const Struct& s = (Struct&)*v;
 	//Create Event Params
-	std::map<std::string, const Variant*> fields = s.getFields();
-    for (std::map<const string, const Variant*>::const_iterator i = fields.begin();
-            i != fields.end(); i++) {
-    	const ParamId& pId(i->first);
-		const Variant& paramValue = *i->second;
+    for (size_t i = 0; i < s.getFieldCount(); i++) {
+    	const Struct::Field& field = s.getField(i);
+    	const ParamId& pId(field.name);
+		const Variant& paramValue = *field.value;
 		ScopeGuard<IODataProviderNamespace::NodeId> nodeIdSG(
 				d->converter.convertBin2io(pId, pNs)); // ConversionException
 		IODataProviderNamespace::Variant* nodeValue =
@@ -914,16 +1023,13 @@ void JDataProvider::event(JNIEnv *env, int eNs, jobject event, int pNs, jobject
 
 
 
-	// eventTypeId
-	IODataProviderNamespace::NodeId* ioEventTypeId =
-	d->converter.convertBin2io(*eventIdp, eNs); // ConversionException
-				// eventData incl. eventTypeId, eventValue
+	// eventData incl. eventTypeId, eventValue
 	std::vector<const IODataProviderNamespace::NodeData*>* ioEventData =
 			new std::vector<const IODataProviderNamespace::NodeData*>();
 
 
 	ioEventData->push_back(new IODataProviderNamespace::NodeData(
-			*ioEventTypeId, ioEventValue, true /* attachValues */));
+			*ioEventTypeIdSG.detach(), ioEventValue, true /* attachValues */));
 	// event incl. timeStamp, eventData
 
 	IODataProviderNamespace::Event ioEvent(timestamp, *ioEventData,
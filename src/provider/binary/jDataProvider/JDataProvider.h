@@ -48,6 +48,12 @@ public:
 
 private:
 
+    // Converts a Java value of a node. The value is converted directly to the IO data provider
+    // model using the data type of the node if possible, else the generic conversion via the
+    // binary model is used.
+    // The returned Variant instance must be destroyed by the caller.
+    IODataProviderNamespace::Variant* convertValue(JNIEnv* env, jobject value,
+            const UaNodeId& nodeId, ModelType& t, int namespaceIndex);
     bool findFieldModel(const UaNodeId &start);
     UaNodeId getUaNode(ParamId *pId);
     std::string getParamId(UaNodeId nId);
@@ -0,0 +1,852 @@
+#include "Java2IO.h"
+#include "../common/ConversionException.h"
+#include <common/Exception.h>
+#include <common/Mutex.h>
+#include <common/MutexLock.h>
+#include <common/ScopeGuard.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/Array.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <ioDataProvider/Structure.h>
+#include <uastructuredefinition.h> // UaStructureDefinition
+#include <stdint.h> // int8_t, ...
+#include <map>
+#include <string>
+#include <vector>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+// A data type with the resolved built-in type. For structure and union types the fields are
+// provided in the order of the definition with their resolved types.
+class Java2IOType {
+public:
+    class Field {
+    public:
+        std::string name;
+        // global reference to the field name (key of the Java map)
+        jstring jName;
+        bool isOptional;
+        Java2IOType* type;
+    };
+
+    UaNodeId typeId;
+    // the identifier of the built-in type (0 if the built-in type is not of namespace 0)
+    OpcUa_UInt32 buildInType;
+    // the scalar type of the IO data provider model for the built-in type (-1 if the type is
+    // a structure or is not supported)
+    int scalarType;
+    bool isStructure;
+    bool isUnion;
+    // the data type id of the structures (NULL if the type is not a structure)
+    NodeId* ioTypeId;
+    // the fields in the order of the definition
+    std::vector<Field> fields;
+};
+
+class Java2IOPrivate {
+    friend class Java2IO;
+private:
+
+    // Deletes a local reference when the scope is left.
+    class LocalRef {
+    public:
+
+        LocalRef(JNIEnv* env, jobject ref) {
+            this->env = env;
+            this->ref = ref;
+        }
+
+        ~LocalRef() {
+            if (ref != NULL) {
+                env->DeleteLocalRef(ref);
+            }
+        }
+
+        jobject get() const {
+            return ref;
+        }
+    private:
+        LocalRef(const LocalRef&);
+        LocalRef& operator=(const LocalRef&);
+
+        JNIEnv* env;
+        jobject ref;
+    };
+
+    // The kinds of Java values. The kinds are determined via the classes in "classes" (same
+    // order). The scalar classes are checked first, so the kind of a number is determined
+    // with one call of IsInstanceOf.
+    enum Kind {
+        NULL_VALUE, NUMBER, STRING, BOOLEAN, CHARACTER, MAP, LIST, OBJECT_ARRAY, BOOLEAN_ARRAY,
+        BYTE_ARRAY, CHAR_ARRAY, SHORT_ARRAY, INT_ARRAY, LONG_ARRAY, FLOAT_ARRAY, DOUBLE_ARRAY,
+        UNKNOWN
+    };
+
+    static const char* CLASS_NAMES[UNKNOWN];
+
+    Logger* log;
+    SASModelProviderNamespace::ConverterUa2IO::ConverterCallback* callback;
+    bool hasAttachedValues;
+
+    // protects the types and the initialization of the Java references
+    Mutex* mutex;
+    // data type -> type
+    std::map<UaNodeId, Java2IOType*> types;
+
+    // global references to the Java classes and the method ids
+    // (initialized with the first conversion)
+    volatile bool isJavaInitialized;
+    JavaVM* jvm;
+    jclass classes[UNKNOWN];
+    jmethodID booleanValue;
+    jmethodID charValue;
+    jmethodID longValue;
+    jmethodID doubleValue;
+    jmethodID mapGet;
+    jmethodID listGet;
+    jmethodID listSize;
+
+    void initJava(JNIEnv* env) /* throws ConversionException */;
+    jclass getClass(JNIEnv* env, const char* name) /* throws ConversionException */;
+    jmethodID getMethod(JNIEnv* env, Kind kind, const char* name,
+            const char* signature) /* throws ConversionException */;
+    Kind getKind(JNIEnv* env, jobject value);
+    // Throws a ConversionException if a Java exception is pending. The Java exception is
+    // cleared.
+    void checkException(JNIEnv* env, const char* call) /* throws ConversionException */;
+
+    // Gets the type for a data type. The type is resolved with the first call.
+    const Java2IOType& getType(JNIEnv* env,
+            const UaNodeId& dataTypeId) /* throws ConversionException */;
+    // Gets or resolves a type. The mutex must be locked by the caller. The resolved types are
+    // added to "resolved".
+    Java2IOType& getType(JNIEnv* env, const UaNodeId& dataTypeId,
+            std::vector<Java2IOType*>& resolved) /* throws ConversionException */;
+    void deleteType(JNIEnv* env, Java2IOType* type);
+    // Returns the scalar type of the IO data provider model for a built-in type or -1.
+    static int getScalarType(OpcUa_UInt32 buildInType);
+
+    Variant* convert(JNIEnv* env, jobject value,
+            const Java2IOType& type) /* throws ConversionException */;
+    Scalar* convertScalar(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type) /* throws ConversionException */;
+    Scalar* convertByteString(JNIEnv* env, jobject value);
+    Structure* convertStructure(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type) /* throws ConversionException */;
+    Array* convertArray(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type) /* throws ConversionException */;
+    // Copies the values of a primitive Java array to the contiguous values of an array if the
+    // element types are equal. Returns false if the types differ.
+    bool copyValues(JNIEnv* env, jobject value, Kind kind, Array& dest);
+
+    jlong getLong(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type) /* throws ConversionException */;
+    jdouble getDouble(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type) /* throws ConversionException */;
+    void getString(JNIEnv* env, jobject value, Kind kind, const Java2IOType& type,
+            std::string& dest) /* throws ConversionException */;
+
+    // Returns the number of elements of a Java list or object array.
+    jsize getLength(JNIEnv* env, jobject value, Kind kind) /* throws ConversionException */;
+    // Returns a local reference to an element of a Java list or object array.
+    jobject getElement(JNIEnv* env, jobject value, Kind kind,
+            jsize index) /* throws ConversionException */;
+    // Sets the elements of a Java list or object array as integer values of type V to the
+    // contiguous values of an array.
+    template<class V> void setLongValues(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type, Array& dest) /* throws ConversionException */;
+    // Sets the elements of a Java list or object array as floating point values of type V to
+    // the contiguous values of an array.
+    template<class V> void setDoubleValues(JNIEnv* env, jobject value, Kind kind,
+            const Java2IOType& type, Array& dest) /* throws ConversionException */;
+
+    std::string getCannotConvertMessage(Kind kind, const Java2IOType& type);
+};
+
+const char* Java2IOPrivate::CLASS_NAMES[] = {
+    NULL, "java/lang/Number", "java/lang/String", "java/lang/Boolean", "java/lang/Character",
+    "java/util/Map", "java/util/List", "[Ljava/lang/Object;", "[Z", "[B", "[C", "[S", "[I",
+    "[J", "[F", "[D"
+};
+
+Java2IO::Java2IO(SASModelProviderNamespace::ConverterUa2IO::ConverterCallback& callback,
+        bool attachValues) /* throws MutexException */ {
+    d = new Java2IOPrivate();
+    d->log = LoggerFactory::getLogger("Java2IO");
+    d->callback = &callback;
+    d->hasAttachedValues = attachValues;
+    d->isJavaInitialized = false;
+    d->jvm = NULL;
+    try {
+        d->mutex = new Mutex(); // MutexException
+    } catch (Exception& e) {
+        delete d;
+        throw;
+    }
+}
+
+Java2IO::~Java2IO() {
+    // the global references can only be deleted if the current thread is attached to the JVM
+    JNIEnv* env = NULL;
+    if (d->jvm != NULL && d->jvm->GetEnv((void**) &env, JNI_VERSION_1_6) != JNI_OK) {
+        env = NULL;
+    }
+    for (std::map<UaNodeId, Java2IOType*>::const_iterator i = d->types.begin();
+            i != d->types.end(); i++) {
+        d->deleteType(env, (*i).second);
+    }
+    if (env != NULL && d->isJavaInitialized) {
+        for (int i = Java2IOPrivate::NUMBER; i < Java2IOPrivate::UNKNOWN; i++) {
+            env->DeleteGlobalRef(d->classes[i]);
+        }
+    }
+    delete d->mutex;
+    if (d->hasAttachedValues) {
+        delete d->callback;
+    }
+    delete d;
+}
+
+Variant* Java2IO::convert(JNIEnv* env, jobject value,
+        const UaNodeId& destDataTypeId) /* throws ConversionException */ {
+    d->initJava(env); // ConversionException
+    const Java2IOType& type = d->getType(env, destDataTypeId); // ConversionException
+    return d->convert(env, value, type); // ConversionException
+}
+
+void Java2IOPrivate::initJava(JNIEnv* env) /* throws ConversionException */ {
+    if (isJavaInitialized) {
+        return;
+    }
+    MutexLock lock(*mutex);
+    if (isJavaInitialized) {
+        return;
+    }
+    classes[NULL_VALUE] = NULL;
+    for (int i = NUMBER; i < UNKNOWN; i++) {
+        classes[i] = NULL;
+    }
+    try {
+        for (int i = NUMBER; i < UNKNOWN; i++) {
+            classes[i] = getClass(env, CLASS_NAMES[i]); // ConversionException
+        }
+        booleanValue = getMethod(env, BOOLEAN, "booleanValue", "()Z"); // ConversionException
+        charValue = getMethod(env, CHARACTER, "charValue", "()C"); // ConversionException
+        longValue = getMethod(env, NUMBER, "longValue", "()J"); // ConversionException
+        doubleValue = getMethod(env, NUMBER, "doubleValue", "()D"); // ConversionException
+        mapGet = getMethod(env, MAP, "get",
+                "(Ljava/lang/Object;)Ljava/lang/Object;"); // ConversionException
+        listGet = getMethod(env, LIST, "get", "(I)Ljava/lang/Object;"); // ConversionException
+        listSize = getMethod(env, LIST, "size", "()I"); // ConversionException
+    } catch (Exception& e) {
+        for (int i = NUMBER; i < UNKNOWN; i++) {
+            if (classes[i] != NULL) {
+                env->DeleteGlobalRef(classes[i]);
+            }
+        }
+        throw;
+    }
+    env->GetJavaVM(&jvm);
+    // the references must be visible to other threads before the flag is set
+    __sync_synchronize();
+    isJavaInitialized = true;
+}
+
+jclass Java2IOPrivate::getClass(JNIEnv* env,
+        const char* name) /* throws ConversionException */ {
+    LocalRef localClass(env, env->FindClass(name));
+    if (localClass.get() == NULL) {
+        env->ExceptionClear();
+        throw ExceptionDef(ConversionException,
+                std::string("Cannot find Java class ").append(name));
+    }
+    return static_cast<jclass> (env->NewGlobalRef(localClass.get()));
+}
+
+jmethodID Java2IOPrivate::getMethod(JNIEnv* env, Kind kind, const char* name,
+        const char* signature) /* throws ConversionException */ {
+    jmethodID ret = env->GetMethodID(classes[kind], name, signature);
+    if (ret == NULL) {
+        env->ExceptionClear();
+        throw ExceptionDef(ConversionException, std::string("Cannot find Java method ")
+                .append(CLASS_NAMES[kind]).append(".").append(name));
+    }
+    return ret;
+}
+
+Java2IOPrivate::Kind Java2IOPrivate::getKind(JNIEnv* env, jobject value) {
+    if (value == NULL) {
+        return NULL_VALUE;
+    }
+    for (int i = NUMBER; i < UNKNOWN; i++) {
+        if (env->IsInstanceOf(value, classes[i])) {
+            return static_cast<Kind> (i);
+        }
+    }
+    return UNKNOWN;
+}
+
+void Java2IOPrivate::checkException(JNIEnv* env,
+        const char* call) /* throws ConversionException */ {
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        throw ExceptionDef(ConversionException,
+                std::string("Java exception while calling ").append(call));
+    }
+}
+
+const Java2IOType& Java2IOPrivate::getType(JNIEnv* env,
+        const UaNodeId& dataTypeId) /* throws ConversionException */ {
+    MutexLock lock(*mutex);
+    std::vector<Java2IOType*> resolved;
+    try {
+        return getType(env, dataTypeId, resolved); // ConversionException
+    } catch (Exception& e) {
+        // remove the types of this call (they may refer to each other)
+        for (std::vector<Java2IOType*>::const_iterator i = resolved.begin();
+                i != resolved.end(); i++) {
+            types.erase((*i)->typeId);
+            deleteType(env, *i);
+        }
+        throw;
+    }
+}
+
+Java2IOType& Java2IOPrivate::getType(JNIEnv* env, const UaNodeId& dataTypeId,
+        std::vector<Java2IOType*>& resolved) /* throws ConversionException */ {
+    std::map<UaNodeId, Java2IOType*>::const_iterator i = types.find(dataTypeId);
+    if (i != types.end()) {
+        return *(*i).second;
+    }
+    Java2IOType* type = new Java2IOType();
+    resolved.push_back(type);
+    type->typeId = dataTypeId;
+    type->ioTypeId = NULL;
+    // register the type before the fields are resolved (a structure may refer to itself)
+    types[dataTypeId] = type;
+    UaNodeId buildInTypeId;
+    try {
+        buildInTypeId = callback->getBuildInType(dataTypeId);
+    } catch (Exception& e) {
+        ConversionException ex = ExceptionDef(ConversionException,
+                std::string("Cannot get base type of ").append(
+                dataTypeId.toXmlString().toUtf8()));
+        ex.setCause(&e);
+        throw ex;
+    }
+    type->buildInType = buildInTypeId.namespaceIndex() == 0
+            && buildInTypeId.identifierType() == OpcUa_IdentifierType_Numeric
+            ? buildInTypeId.identifierNumeric() : 0;
+    type->isStructure = type->buildInType == OpcUaId_Structure
+            || type->buildInType == OpcUaId_Union;
+    type->isUnion = false;
+    type->scalarType = type->isStructure ? -1 : getScalarType(type->buildInType);
+    if (!type->isStructure) {
+        return *type;
+    }
+    switch (dataTypeId.identifierType()) {
+        case OpcUa_IdentifierType_Numeric:
+            type->ioTypeId = new NodeId(dataTypeId.namespaceIndex(),
+                    dataTypeId.identifierNumeric());
+            break;
+        case OpcUa_IdentifierType_String:
+            type->ioTypeId = new NodeId(dataTypeId.namespaceIndex(),
+                    std::string(UaString(dataTypeId.identifierString()).toUtf8()));
+            break;
+        default:
+            throw ExceptionDef(ConversionException,
+                    std::string("Unsupported identifier type of data type ").append(
+                    dataTypeId.toXmlString().toUtf8()));
+    }
+    UaStructureDefinition definition;
+    try {
+        definition = callback->getStructureDefinition(dataTypeId);
+    } catch (Exception& e) {
+        ConversionException ex = ExceptionDef(ConversionException,
+                std::string("Cannot get structure definition of ").append(
+                dataTypeId.toXmlString().toUtf8()));
+        ex.setCause(&e);
+        throw ex;
+    }
+    type->isUnion = definition.isUnion();
+    type->fields.resize(definition.childrenCount());
+    // initialize the references first (the type may be deleted while the fields are resolved)
+    for (int j = 0; j < definition.childrenCount(); j++) {
+        type->fields[j].jName = NULL;
+        type->fields[j].type = NULL;
+    }
+    for (int j = 0; j < definition.childrenCount(); j++) {
+        Java2IOType::Field& field = type->fields[j];
+        UaStructureField structureField = definition.child(j);
+        field.name = structureField.name().toUtf8();
+        field.isOptional = structureField.isOptional();
+        LocalRef name(env, env->NewStringUTF(field.name.c_str()));
+        checkException(env, "NewStringUTF"); // ConversionException
+        field.jName = static_cast<jstring> (env->NewGlobalRef(name.get()));
+        field.type = &getType(env, structureField.typeId(), resolved); // ConversionException
+    }
+    if (log->isDebugEnabled()) {
+        log->debug("Resolved %s %s with %lu fields", type->isUnion ? "union" : "structure",
+                dataTypeId.toXmlString().toUtf8(), type->fields.size());
+    }
+    return *type;
+}
+
+void Java2IOPrivate::deleteType(JNIEnv* env, Java2IOType* type) {
+    if (env != NULL) {
+        for (std::vector<Java2IOType::Field>::const_iterator i = type->fields.begin();
+                i != type->fields.end(); i++) {
+            if ((*i).jName != NULL) {
+                env->DeleteGlobalRef((*i).jName);
+            }
+        }
+    }
+    delete type->ioTypeId;
+    delete type;
+}
+
+int Java2IOPrivate::getScalarType(OpcUa_UInt32 buildInType) {
+    // OPC UA                   - InternalInterface
+    // boolean                  - bool
+    // sbyte                    - schar
+    // byte                     - char
+    // int16                    - int
+    // uint16                   - uint
+    // int32/enum               - long
+    // uint32                   - ulong
+    // int64/dateTime/utcTime   - llong
+    // uint64                   - ullong
+    // float                    - float
+    // double/duration          - double
+    // string/localizedText     - string
+    // byteString               - byteString
+    switch (buildInType) {
+        case OpcUaId_Boolean:
+            return Scalar::BOOL;
+        case OpcUaId_SByte:
+            return Scalar::SCHAR;
+        case OpcUaId_Byte:
+            return Scalar::CHAR;
+        case OpcUaId_Int16:
+            return Scalar::INT;
+        case OpcUaId_UInt16:
+            return Scalar::UINT;
+        case OpcUaId_Int32:
+        case OpcUaId_Enumeration:
+            return Scalar::LONG;
+        case OpcUaId_UInt32:
+            return Scalar::ULONG;
+        case OpcUaId_Int64:
+        case OpcUaId_DateTime:
+        case OpcUaId_UtcTime:
+            return Scalar::LLONG;
+        case OpcUaId_UInt64:
+            return Scalar::ULLONG;
+        case OpcUaId_Float:
+            return Scalar::FLOAT;
+        case OpcUaId_Double:
+        case OpcUaId_Duration:
+            return Scalar::DOUBLE;
+        case OpcUaId_String:
+        case OpcUaId_LocalizedText:
+            return Scalar::STRING;
+        case OpcUaId_ByteString:
+            return Scalar::BYTE_STRING;
+        default:
+            return -1;
+    }
+}
+
+Variant* Java2IOPrivate::convert(JNIEnv* env, jobject value,
+        const Java2IOType& type) /* throws ConversionException */ {
+    Kind kind = getKind(env, value);
+    switch (kind) {
+        case NULL_VALUE:
+        case UNKNOWN:
+            throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+        case NUMBER:
+        case STRING:
+        case BOOLEAN:
+        case CHARACTER:
+            return convertScalar(env, value, kind, type); // ConversionException
+        case MAP:
+            return convertStructure(env, value, kind, type); // ConversionException
+        case BYTE_ARRAY:
+            if (type.scalarType == Scalar::BYTE_STRING) {
+                return convertByteString(env, value);
+            }
+            // fall through
+        default:
+            return convertArray(env, value, kind, type); // ConversionException
+    }
+}
+
+Scalar* Java2IOPrivate::convertScalar(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type) /* throws ConversionException */ {
+    Scalar* ret = new Scalar();
+    ScopeGuard<Scalar> retSG(ret);
+    switch (type.scalarType) {
+        case Scalar::BOOL:
+            ret->setBool(getLong(env, value, kind, type) != 0); // ConversionException
+            break;
+        case Scalar::SCHAR:
+            ret->setSChar(static_cast<signed char> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::CHAR:
+            ret->setChar(static_cast<char> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::INT:
+            ret->setInt(static_cast<int> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::UINT:
+            ret->setUInt(static_cast<unsigned int> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::LONG:
+            ret->setLong(static_cast<long> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::ULONG:
+            ret->setULong(static_cast<unsigned long> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::LLONG:
+            ret->setLLong(getLong(env, value, kind, type)); // ConversionException
+            break;
+        case Scalar::ULLONG:
+            ret->setULLong(static_cast<unsigned long long> (
+                    getLong(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::FLOAT:
+            ret->setFloat(static_cast<float> (
+                    getDouble(env, value, kind, type))); // ConversionException
+            break;
+        case Scalar::DOUBLE:
+            ret->setDouble(getDouble(env, value, kind, type)); // ConversionException
+            break;
+        case Scalar::STRING:
+        {
+            std::string* str = new std::string();
+            ScopeGuard<std::string> strSG(str);
+            getString(env, value, kind, type, *str); // ConversionException
+            ret->setString(strSG.detach(), true /* attachValue */);
+            break;
+        }
+        default:
+            throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+    }
+    return retSG.detach();
+}
+
+Scalar* Java2IOPrivate::convertByteString(JNIEnv* env, jobject value) {
+    jsize length = env->GetArrayLength(static_cast<jarray> (value));
+    char* bytes = new char[length];
+    env->GetByteArrayRegion(static_cast<jbyteArray> (value), 0, length,
+            reinterpret_cast<jbyte*> (bytes));
+    Scalar* ret = new Scalar();
+    ret->setByteString(bytes, length, true /* attachValue */);
+    return ret;
+}
+
+Structure* Java2IOPrivate::convertStructure(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type) /* throws ConversionException */ {
+    if (!type.isStructure) {
+        throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+    }
+    Structure* ret = Structure::createStructure(*new NodeId(*type.ioTypeId),
+            type.isUnion ? 1 : type.fields.size());
+    ScopeGuard<Structure> retSG(ret);
+    // for each field in the order of the definition
+    for (std::vector<Java2IOType::Field>::const_iterator i = type.fields.begin();
+            i != type.fields.end(); i++) {
+        const Java2IOType::Field& field = *i;
+        LocalRef fieldValue(env, env->CallObjectMethod(value, mapGet, field.jName));
+        checkException(env, "Map.get"); // ConversionException
+        if (fieldValue.get() == NULL) {
+            if (!type.isUnion && !field.isOptional) {
+                throw ExceptionDef(ConversionException,
+                        std::string("Cannot convert Java map to ").append(
+                        type.typeId.toXmlString().toUtf8()).append(
+                        " due to missing value for mandatory field ").append(field.name));
+            }
+            continue;
+        }
+        if (type.isUnion && ret->getFieldCount() > 0) {
+            throw ExceptionDef(ConversionException,
+                    std::string("Cannot convert Java map to ").append(
+                    type.typeId.toXmlString().toUtf8()).append(
+                    " due to too many values for a union type"));
+        }
+        ret->addField(field.name,
+                *convert(env, fieldValue.get(), *field.type)); // ConversionException
+    }
+    return retSG.detach();
+}
+
+Array* Java2IOPrivate::convertArray(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type) /* throws ConversionException */ {
+    bool isObjects = kind == LIST || kind == OBJECT_ARRAY;
+    // structures and strings are converted element by element
+    if (type.isStructure || type.scalarType == Scalar::STRING) {
+        if (!isObjects) {
+            throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+        }
+        jsize length = getLength(env, value, kind); // ConversionException
+        std::vector<const Variant*>* elements = new std::vector<const Variant*>();
+        VectorScopeGuard<const Variant> elementsSG(elements);
+        elements->reserve(length);
+        for (jsize i = 0; i < length; i++) {
+            LocalRef element(env, getElement(env, value, kind, i)); // ConversionException
+            Kind elementKind = getKind(env, element.get());
+            elements->push_back(type.isStructure
+                    ? static_cast<Variant*> (convertStructure(env, element.get(), elementKind,
+                    type)) : convertScalar(env, element.get(), elementKind,
+                    type)); // ConversionException
+        }
+        return new Array(type.isStructure ? Variant::STRUCTURE : Scalar::STRING,
+                elementsSG.detach(), true /* attachValues */);
+    }
+    // numeric values are stored contiguously: primitive arrays are copied in bulk if the
+    // element types are equal, lists and object arrays are converted element by element
+    if (Array::getElementSize(type.scalarType) == 0) {
+        throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+    }
+    jsize length = isObjects ? getLength(env, value, kind) // ConversionException
+            : env->GetArrayLength(static_cast<jarray> (value));
+    Array* ret = Array::createTypedArray(type.scalarType, length);
+    ScopeGuard<Array> retSG(ret);
+    if (!isObjects) {
+        if (!copyValues(env, value, kind, *ret)) {
+            throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+        }
+        return retSG.detach();
+    }
+    switch (type.scalarType) {
+        case Scalar::BOOL:
+            setLongValues<uint8_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::SCHAR:
+            setLongValues<int8_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::CHAR:
+            setLongValues<char>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::INT:
+            setLongValues<int16_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::UINT:
+            setLongValues<uint16_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::LONG:
+            setLongValues<int32_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::ULONG:
+            setLongValues<uint32_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::LLONG:
+            setLongValues<int64_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::ULLONG:
+            setLongValues<uint64_t>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::FLOAT:
+            setDoubleValues<float>(env, value, kind, type, *ret); // ConversionException
+            break;
+        case Scalar::DOUBLE:
+            setDoubleValues<double>(env, value, kind, type, *ret); // ConversionException
+            break;
+    }
+    return retSG.detach();
+}
+
+bool Java2IOPrivate::copyValues(JNIEnv* env, jobject value, Kind kind, Array& dest) {
+    jsize length = dest.getLength();
+    void* values = dest.getValues();
+    if (length == 0) {
+        return true;
+    }
+    // Java type   - InternalInterface
+    // boolean[]   - bool[]
+    // byte[]      - schar[]/char[]
+    // char[]      - uint[]
+    // short[]     - int[]
+    // int[]       - long[]
+    // long[]      - llong[]
+    // float[]     - float[]
+    // double[]    - double[]
+    switch (kind) {
+        case BOOLEAN_ARRAY:
+            if (dest.getArrayType() != Scalar::BOOL) {
+                return false;
+            }
+            env->GetBooleanArrayRegion(static_cast<jbooleanArray> (value), 0, length,
+                    static_cast<jboolean*> (values));
+            return true;
+        case BYTE_ARRAY:
+            if (dest.getArrayType() != Scalar::SCHAR && dest.getArrayType() != Scalar::CHAR) {
+                return false;
+            }
+            env->GetByteArrayRegion(static_cast<jbyteArray> (value), 0, length,
+                    static_cast<jbyte*> (values));
+            return true;
+        case CHAR_ARRAY:
+            if (dest.getArrayType() != Scalar::UINT) {
+                return false;
+            }
+            env->GetCharArrayRegion(static_cast<jcharArray> (value), 0, length,
+                    static_cast<jchar*> (values));
+            return true;
+        case SHORT_ARRAY:
+            if (dest.getArrayType() != Scalar::INT) {
+                return false;
+            }
+            env->GetShortArrayRegion(static_cast<jshortArray> (value), 0, length,
+                    static_cast<jshort*> (values));
+            return true;
+        case INT_ARRAY:
+            if (dest.getArrayType() != Scalar::LONG) {
+                return false;
+            }
+            env->GetIntArrayRegion(static_cast<jintArray> (value), 0, length,
+                    static_cast<jint*> (values));
+            return true;
+        case LONG_ARRAY:
+            if (dest.getArrayType() != Scalar::LLONG) {
+                return false;
+            }
+            env->GetLongArrayRegion(static_cast<jlongArray> (value), 0, length,
+                    static_cast<jlong*> (values));
+            return true;
+        case FLOAT_ARRAY:
+            if (dest.getArrayType() != Scalar::FLOAT) {
+                return false;
+            }
+            env->GetFloatArrayRegion(static_cast<jfloatArray> (value), 0, length,
+                    static_cast<jfloat*> (values));
+            return true;
+        case DOUBLE_ARRAY:
+            if (dest.getArrayType() != Scalar::DOUBLE) {
+                return false;
+            }
+            env->GetDoubleArrayRegion(static_cast<jdoubleArray> (value), 0, length,
+                    static_cast<jdouble*> (values));
+            return true;
+        default:
+            return false;
+    }
+}
+
+jlong Java2IOPrivate::getLong(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type) /* throws ConversionException */ {
+    jlong ret;
+    switch (kind) {
+        case NUMBER:
+            ret = env->CallLongMethod(value, longValue);
+            break;
+        case BOOLEAN:
+            ret = env->CallBooleanMethod(value, booleanValue) ? 1 : 0;
+            break;
+        case CHARACTER:
+            ret = env->CallCharMethod(value, charValue);
+            break;
+        default:
+            throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+    }
+    checkException(env, CLASS_NAMES[kind]); // ConversionException
+    return ret;
+}
+
+jdouble Java2IOPrivate::getDouble(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type) /* throws ConversionException */ {
+    if (kind != NUMBER) {
+        throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+    }
+    jdouble ret = env->CallDoubleMethod(value, doubleValue);
+    checkException(env, "Number.doubleValue"); // ConversionException
+    return ret;
+}
+
+void Java2IOPrivate::getString(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type, std::string& dest) /* throws ConversionException */ {
+    if (kind != STRING) {
+        throw ExceptionDef(ConversionException, getCannotConvertMessage(kind, type));
+    }
+    const char* chars = env->GetStringUTFChars(static_cast<jstring> (value), NULL);
+    if (chars == NULL) {
+        checkException(env, "GetStringUTFChars"); // ConversionException
+        throw ExceptionDef(ConversionException, std::string("Cannot get Java string"));
+    }
+    dest.assign(chars);
+    env->ReleaseStringUTFChars(static_cast<jstring> (value), chars);
+}
+
+jsize Java2IOPrivate::getLength(JNIEnv* env, jobject value,
+        Kind kind) /* throws ConversionException */ {
+    if (kind == LIST) {
+        jsize ret = env->CallIntMethod(value, listSize);
+        checkException(env, "List.size"); // ConversionException
+        return ret;
+    }
+    return env->GetArrayLength(static_cast<jarray> (value));
+}
+
+jobject Java2IOPrivate::getElement(JNIEnv* env, jobject value, Kind kind,
+        jsize index) /* throws ConversionException */ {
+    jobject ret;
+    if (kind == LIST) {
+        ret = env->CallObjectMethod(value, listGet, index);
+    } else {
+        ret = env->GetObjectArrayElement(static_cast<jobjectArray> (value), index);
+    }
+    if (env->ExceptionCheck()) {
+        if (ret != NULL) {
+            env->DeleteLocalRef(ret);
+        }
+        checkException(env, kind == LIST ? "List.get" : "GetObjectArrayElement"); // ConversionException
+    }
+    return ret;
+}
+
+template<class V> void Java2IOPrivate::setLongValues(JNIEnv* env, jobject value, Kind kind,
+        const Java2IOType& type, Array& dest) /* throws ConversionException */ {
+    V* values = static_cast<V*> (dest.getValues());
+    jsize length = dest.getLength();
+    for (jsize i = 0; i < length; i++) {
+        LocalRef element(env, getElement(env, value, kind, i)); // ConversionException
+        values[i] = static_cast<V> (getLong(env, element.get(), getKind(env, element.get()),
+                type)); // ConversionException
+    }
+}
+
+template<class V> void Java2IOPrivate::setDoubleValues(JNIEnv* env, jobject value,
+        Kind kind, const Java2IOType& type, Array& dest) /* throws ConversionException */ {
+    V* values = static_cast<V*> (dest.getValues());
+    jsize length = dest.getLength();
+    for (jsize i = 0; i < length; i++) {
+        LocalRef element(env, getElement(env, value, kind, i)); // ConversionException
+        values[i] = static_cast<V> (getDouble(env, element.get(), getKind(env, element.get()),
+                type)); // ConversionException
+    }
+}
+
+std::string Java2IOPrivate::getCannotConvertMessage(Kind kind, const Java2IOType& type) {
+    std::string ret("Cannot convert Java value of kind ");
+    if (kind == NULL_VALUE) {
+        ret.append("null");
+    } else if (kind == UNKNOWN) {
+        ret.append("unknown");
+    } else {
+        ret.append(CLASS_NAMES[kind]);
+    }
+    return ret.append(" to Variant of type ").append(type.typeId.toXmlString().toUtf8());
+}
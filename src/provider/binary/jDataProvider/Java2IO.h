@@ -0,0 +1,39 @@
+#ifndef PROVIDER_BINARY_JDATAPROVIDER_JAVA2IO_H
+#define PROVIDER_BINARY_JDATAPROVIDER_JAVA2IO_H
+
+#include <ioDataProvider/Variant.h>
+#include <jni.h>
+#include <sasModelProvider/base/ConverterUa2IO.h>
+#include <uanodeid.h> // UaNodeId
+
+class Java2IOPrivate;
+
+// Converts values of the Java data provider directly to the model of the IO data providers.
+// The conversion is driven by the destination data type: the built-in types and structure
+// definitions of the data types are resolved once and cached for the lifetime of the
+// converter. Structures are created in the order of the definitions and numeric arrays are
+// created with contiguous values (primitive Java arrays are copied in bulk).
+// The generic conversion (Native2J, ConverterBin2IO) remains the fallback for values which
+// cannot be converted directly.
+// This class is thread safe.
+
+class Java2IO {
+public:
+    // If the values are attached then the responsibility for destroying the callback instance
+    // is delegated to the Java2IO instance.
+    Java2IO(SASModelProviderNamespace::ConverterUa2IO::ConverterCallback& callback,
+            bool attachValues = false) /* throws MutexException */;
+    virtual ~Java2IO();
+
+    // Converts a Java value to a Variant for the destination data type.
+    // The returned Variant instance must be destroyed by the caller.
+    virtual IODataProviderNamespace::Variant* convert(JNIEnv* env, jobject value,
+            const UaNodeId& destDataTypeId) /* throws ConversionException */;
+private:
+    Java2IO(const Java2IO& orig);
+    Java2IO& operator=(const Java2IO&);
+
+    Java2IOPrivate* d;
+};
+
+#endif /* PROVIDER_BINARY_JDATAPROVIDER_JAVA2IO_H */
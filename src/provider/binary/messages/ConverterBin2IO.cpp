@@ -2,13 +2,14 @@
 #include "../common/ConversionException.h"
 #include "dto/Array.h"
 #include "dto/Scalar.h"
+#include "dto/ScalarTraits.h"
 #include "dto/Struct.h"
 #include <common/Exception.h>
 #include <common/ScopeGuard.h>
-#include <common/MapScopeGuard.h>
 #include <common/VectorScopeGuard.h>
 #include <ioDataProvider/Array.h>
 #include <ioDataProvider/Scalar.h>
+#include <ioDataProvider/ScalarTraits.h>
 #include <ioDataProvider/Structure.h>
 #include <sstream> // ostringstream
 #ifdef DEBUG
@@ -17,18 +18,62 @@
 
 using namespace CommonNamespace;
 
+// A conversion between a scalar type of the binary protocol and a scalar type of the internal
+// interface (see ConverterBin2IOPrivate::conversions). The converters are resolved once per
+// value or array. The converters which are not supported for a direction are NULL.
+class ScalarConversion {
+public:
+    int binScalarType;
+    int ioScalarType;
+    // Converts a Scalar.
+    // The returned Variant instance must be destroyed by the caller.
+    IODataProviderNamespace::Variant* (*convertBin2ioScalar)(const Scalar& value);
+    // Converts the Scalar elements of an array to contiguous values.
+    void (*convertBin2ioValues)(const std::vector<const Variant*>& elements, void* values);
+    // Converts a Scalar.
+    // The returned Variant instance must be destroyed by the caller.
+    Variant* (*convertIo2binScalar)(const IODataProviderNamespace::Scalar& value);
+    // Creates the Scalar elements for contiguous values.
+    void (*convertIo2binValues)(const void* values, unsigned long length,
+            std::vector<const Variant*>& elements);
+};
+
 class ConverterBin2IOPrivate {
     friend class ConverterBin2IO;
 private:
     ConverterBin2IO* parent;
     IODataProviderNamespace::Variant* convertBin2ioScalarValue(const Scalar& value)/* throws ConversionException */;
     IODataProviderNamespace::Variant* convertBin2ioArrayValue(const Array& value, int destNamespaceIndex);
+    // Converts an array with scalar elements to an Array with contiguous values.
+    IODataProviderNamespace::Array* convertBin2ioTypedArrayValue(const Array& value,
+            const ScalarConversion& conversion);
     IODataProviderNamespace::Variant* convertBin2ioStructureValue(const Struct& value, int destNamespaceIndex);
 
     Variant* convertIo2binScalarValue(const IODataProviderNamespace::Scalar& value);
     Variant* convertIo2binNodeIdValue(const IODataProviderNamespace::Variant& value);
     Variant* convertIo2binArrayValue(const IODataProviderNamespace::Array& value);
     Variant* convertIo2binStructureValue(const IODataProviderNamespace::Structure& value);
+
+    // The conversions between the numeric, boolean and byte scalar types of the binary
+    // protocol and the scalar types of the internal interface.
+    static const ScalarConversion conversions[];
+    static const size_t conversionCount;
+
+    // Gets the conversion of a scalar type of the binary protocol.
+    // If the type is not supported NULL is returned.
+    static const ScalarConversion* getBin2ioConversion(int binScalarType);
+    // Gets the conversion of a scalar type of the internal interface.
+    // If the type is not supported NULL is returned.
+    static const ScalarConversion* getIo2binConversion(int ioScalarType);
+    // the converters for the pairs of scalar types
+    template<int BinScalarType, int IOScalarType>
+    static IODataProviderNamespace::Variant* convertBin2ioScalar(const Scalar& value);
+    template<int BinScalarType, int IOScalarType> static void convertBin2ioValues(
+            const std::vector<const Variant*>& elements, void* values);
+    template<int BinScalarType, int IOScalarType> static Variant* convertIo2binScalar(
+            const IODataProviderNamespace::Scalar& value);
+    template<int BinScalarType, int IOScalarType> static void convertIo2binValues(
+            const void* values, unsigned long length, std::vector<const Variant*>& elements);
 };
 
 ConverterBin2IO::ConverterBin2IO() {
@@ -142,37 +187,12 @@ Variant* ConverterBin2IO::convertIo2bin(const IODataProviderNamespace::Variant&
 
 IODataProviderNamespace::Variant* ConverterBin2IOPrivate::convertBin2ioScalarValue(
         const Scalar& value)/* throws ConversionException */ {
-    IODataProviderNamespace::Scalar* ret = new IODataProviderNamespace::Scalar();
-    switch (value.getScalarType()) {
-        case Scalar::BOOLEAN:
-            ret->setBool(value.getBoolean());
-            break;
-        case Scalar::BYTE:
-            ret->setSChar(value.getByte());
-            break;
-        case Scalar::CHAR:
-            ret->setChar(value.getChar());
-            break;
-        case Scalar::SHORT:
-            ret->setInt(value.getShort());
-            break;
-        case Scalar::INT:
-            ret->setLong(value.getInt());
-            break;
-        case Scalar::LONG:
-            ret->setLLong(value.getLong());
-            break;
-        case Scalar::FLOAT:
-            ret->setFloat(value.getFloat());
-            break;
-        case Scalar::DOUBLE:
-            ret->setDouble(value.getDouble());
-            break;
-        default:
-            throw ExceptionDef(ConversionException,
-                    std::string("Unsupported scalar type ").append(value.toString()));
+    const ScalarConversion* conversion = getBin2ioConversion(value.getScalarType());
+    if (conversion == NULL) {
+        throw ExceptionDef(ConversionException,
+                std::string("Unsupported scalar type ").append(value.toString()));
     }
-    return ret;
+    return conversion->convertBin2ioScalar(value);
 }
 
 IODataProviderNamespace::Variant* ConverterBin2IOPrivate::convertBin2ioArrayValue(
@@ -213,26 +233,13 @@ IODataProviderNamespace::Variant* ConverterBin2IOPrivate::convertBin2ioArrayValu
         }
         default:
         {
+            const ScalarConversion* conversion = getBin2ioConversion(value.getArrayType());
+            if (conversion != NULL) {
+                // copy scalar values to contiguous values
+                return convertBin2ioTypedArrayValue(value, *conversion);
+            }
             int arrayType;
             switch (value.getArrayType()) {
-                case Scalar::BOOLEAN:
-                    arrayType = IODataProviderNamespace::Scalar::BOOL;
-                    break;
-                case Scalar::SHORT:
-                    arrayType = IODataProviderNamespace::Scalar::INT;
-                    break;
-                case Scalar::INT:
-                    arrayType = IODataProviderNamespace::Scalar::LONG;
-                    break;
-                case Scalar::LONG:
-                    arrayType = IODataProviderNamespace::Scalar::LLONG;
-                    break;
-                case Scalar::FLOAT:
-                    arrayType = IODataProviderNamespace::Scalar::FLOAT;
-                    break;
-                case Scalar::DOUBLE:
-                    arrayType = IODataProviderNamespace::Scalar::DOUBLE;
-                    break;
                 case Variant::ARRAY:
                     arrayType = IODataProviderNamespace::Variant::ARRAY;
                     break;
@@ -267,24 +274,31 @@ IODataProviderNamespace::Variant* ConverterBin2IOPrivate::convertBin2ioArrayValu
     }
 }
 
+IODataProviderNamespace::Array* ConverterBin2IOPrivate::convertBin2ioTypedArrayValue(
+        const Array& value, const ScalarConversion& conversion) {
+    const std::vector<const Variant*>& elements = value.getElements();
+    IODataProviderNamespace::Array* ret = IODataProviderNamespace::Array::createTypedArray(
+            conversion.ioScalarType, elements.size());
+    conversion.convertBin2ioValues(elements, ret->getValues());
+    return ret;
+}
+
 IODataProviderNamespace::Variant* ConverterBin2IOPrivate::convertBin2ioStructureValue(
         const Struct& value, int destNamespaceIndex) /* throws ConversionException */ {
     IODataProviderNamespace::NodeId* dataTypeId
             = parent->convertBin2io(value.getStructId(), destNamespaceIndex); // ConversionException
-    ScopeGuard<IODataProviderNamespace::NodeId> dataTypeIdSG(dataTypeId);
-    std::map<std::string, const IODataProviderNamespace::Variant*>* fieldData =
-            new std::map<std::string, const IODataProviderNamespace::Variant*>();
-    MapScopeGuard<std::string, const IODataProviderNamespace::Variant> fieldDataSG(fieldData);
-    // for each field
-    for (std::map<std::string, const Variant*>::const_iterator i = value.getFields().begin();
-            i != value.getFields().end(); i++) {
-        std::string fieldName = (*i).first;
-        const Variant& fieldValue = *(*i).second;
+    IODataProviderNamespace::Structure* ret =
+            IODataProviderNamespace::Structure::createStructure(*dataTypeId,
+            value.getFieldCount());
+    ScopeGuard<IODataProviderNamespace::Structure> retSG(ret);
+    // for each field in the order of the struct
+    for (size_t i = 0; i < value.getFieldCount(); i++) {
+        const Struct::Field& field = value.getField(i);
         // convert field value
-        (*fieldData)[fieldName] = parent->convertBin2io(fieldValue, destNamespaceIndex); // ConversionException
+        ret->addField(field.name,
+                *parent->convertBin2io(*field.value, destNamespaceIndex)); // ConversionException
     }
-    return new IODataProviderNamespace::Structure(*dataTypeIdSG.detach(), *fieldDataSG.detach(),
-            true /*attachValues*/);
+    return retSG.detach();
 }
 
 Variant* ConverterBin2IOPrivate::convertIo2binNodeIdValue(const IODataProviderNamespace::Variant& value)
@@ -306,49 +320,12 @@ Variant* ConverterBin2IOPrivate::convertIo2binNodeIdValue(const IODataProviderNa
 
 Variant* ConverterBin2IOPrivate::convertIo2binScalarValue(
         const IODataProviderNamespace::Scalar& value)/* throws ConversionException */ {
-    Scalar* scalar = NULL;
+    const ScalarConversion* conversion = getIo2binConversion(value.getScalarType());
+    if (conversion != NULL) {
+        return conversion->convertIo2binScalar(value);
+    }
     Array* array = NULL;
     switch (value.getScalarType()) {
-        case IODataProviderNamespace::Scalar::BOOL:
-            scalar = new Scalar();
-            scalar->setBoolean(value.getBool());
-            break;
-        case IODataProviderNamespace::Scalar::SCHAR:
-            scalar = new Scalar();
-            scalar->setByte(value.getSChar());
-            break;
-        case IODataProviderNamespace::Scalar::CHAR:
-            scalar = new Scalar();
-            scalar->setChar(value.getChar());
-            break;
-        case IODataProviderNamespace::Scalar::INT:
-            scalar = new Scalar();
-            scalar->setShort(value.getInt());
-            break;
-        case IODataProviderNamespace::Scalar::UINT:
-            scalar = new Scalar();
-            scalar->setInt(static_cast<long> (value.getUInt()));
-            break;
-        case IODataProviderNamespace::Scalar::LONG:
-            scalar = new Scalar();
-            scalar->setInt(value.getLong());
-            break;
-        case IODataProviderNamespace::Scalar::ULONG:
-            scalar = new Scalar();
-            scalar->setLong(static_cast<long long> (value.getULong()));
-            break;
-        case IODataProviderNamespace::Scalar::LLONG:
-            scalar = new Scalar();
-            scalar->setLong(value.getLLong());
-            break;
-        case IODataProviderNamespace::Scalar::FLOAT:
-            scalar = new Scalar();
-            scalar->setFloat(value.getFloat());
-            break;
-        case IODataProviderNamespace::Scalar::DOUBLE:
-            scalar = new Scalar();
-            scalar->setDouble(value.getDouble());
-            break;
         case IODataProviderNamespace::Scalar::STRING:
         { // char[]
             // NULL is converted to an empty char array (cause: see byteString)
@@ -402,69 +379,51 @@ Variant* ConverterBin2IOPrivate::convertIo2binScalarValue(
             throw ExceptionDef(ConversionException,
                     std::string("Unsupported scalar type ").append(value.toString()));
     }
-    if (array == NULL) {
-        return scalar;
-    } else {
-        return array;
-    }
+    return array;
 }
 
 Variant* ConverterBin2IOPrivate::convertIo2binArrayValue(const IODataProviderNamespace::Array& value)
 /* throws ConversionException */ {
-    if (value.getElements() == NULL) {
+    // check the contiguous values first: getElements would create the elements
+    if (value.getValues() == NULL && value.getElements() == NULL) {
         throw ExceptionDef(ConversionException,
                 std::string("A null array cannot be converted to Variant"));
     }
     int arrayType;
-    switch (value.getArrayType()) {
-        case IODataProviderNamespace::Scalar::BOOL:
-            arrayType = Scalar::BOOLEAN;
-            break;
-        case IODataProviderNamespace::Scalar::SCHAR:
-            arrayType = Scalar::BYTE;
-            break;
-        case IODataProviderNamespace::Scalar::INT:
-            arrayType = Scalar::SHORT;
-            break;
-        case IODataProviderNamespace::Scalar::UINT:
-            arrayType = Scalar::INT;
-            break;
-        case IODataProviderNamespace::Scalar::LONG:
-            arrayType = Scalar::INT;
-            break;
-        case IODataProviderNamespace::Scalar::ULONG:
-            arrayType = Scalar::LONG;
-            break;
-        case IODataProviderNamespace::Scalar::LLONG:
-            arrayType = Scalar::LONG;
-            break;
-        case IODataProviderNamespace::Scalar::FLOAT:
-            arrayType = Scalar::FLOAT;
-            break;
-        case IODataProviderNamespace::Scalar::DOUBLE:
-            arrayType = Scalar::DOUBLE;
-            break;
-        case IODataProviderNamespace::Scalar::STRING:
-        case IODataProviderNamespace::Scalar::BYTE_STRING:
-        case IODataProviderNamespace::Scalar::LOCALIZED_TEXT:
-        case IODataProviderNamespace::Scalar::VARIANT:
-            arrayType = Scalar::ARRAY;
-            break;
-        case IODataProviderNamespace::Variant::STRUCTURE:
-            arrayType = Variant::STRUCT;
-            break;
-        case IODataProviderNamespace::Scalar::CHAR:
-        case IODataProviderNamespace::Scalar::ULLONG:
-        case IODataProviderNamespace::Variant::NODE_PROPERTIES:
-        case IODataProviderNamespace::Variant::OPC_UA_EVENT_DATA:
-        default:
-            std::ostringstream msg;
-            msg << "Unsupported array type " << value.getArrayType();
-            throw ExceptionDef(ConversionException, msg.str());
-            break;
+    const ScalarConversion* conversion = value.getArrayType()
+            == IODataProviderNamespace::Scalar::CHAR
+            ? NULL : getIo2binConversion(value.getArrayType());
+    if (conversion != NULL) {
+        arrayType = conversion->binScalarType;
+    } else {
+        switch (value.getArrayType()) {
+            case IODataProviderNamespace::Scalar::STRING:
+            case IODataProviderNamespace::Scalar::BYTE_STRING:
+            case IODataProviderNamespace::Scalar::LOCALIZED_TEXT:
+            case IODataProviderNamespace::Scalar::VARIANT:
+                arrayType = Scalar::ARRAY;
+                break;
+            case IODataProviderNamespace::Variant::STRUCTURE:
+                arrayType = Variant::STRUCT;
+                break;
+            case IODataProviderNamespace::Scalar::CHAR:
+            case IODataProviderNamespace::Scalar::ULLONG:
+            case IODataProviderNamespace::Variant::NODE_PROPERTIES:
+            case IODataProviderNamespace::Variant::OPC_UA_EVENT_DATA:
+            default:
+                std::ostringstream msg;
+                msg << "Unsupported array type " << value.getArrayType();
+                throw ExceptionDef(ConversionException, msg.str());
+                break;
+        }
     }
     std::vector<const Variant*>* elements = new std::vector<const Variant*>();
     VectorScopeGuard<const Variant> elementsSG(elements);
+    if (value.getValues() != NULL) {
+        // create the elements directly from the contiguous values
+        conversion->convertIo2binValues(value.getValues(), value.getLength(), *elements);
+        return new Array(arrayType, *elementsSG.detach(), true /*attachValues*/);
+    }
     const std::vector<const IODataProviderNamespace::Variant*>* elems = value.getElements();
     // for each element
     for (int i = 0; i < elems->size(); i++) {
@@ -478,16 +437,136 @@ Variant* ConverterBin2IOPrivate::convertIo2binArrayValue(const IODataProviderNam
 Variant* ConverterBin2IOPrivate::convertIo2binStructureValue(
         const IODataProviderNamespace::Structure& value)/* throws ConversionException */ {
     ParamId* structId = parent->convertIo2bin(value.getDataTypeId()); // ConversionException
-    ScopeGuard<ParamId> structIdSG(structId);
-    std::map<std::string, const Variant*>* fieldData = new std::map<std::string, const Variant*>();
-    MapScopeGuard<std::string, const Variant> fieldDataSG(fieldData);
-    // for each field
-    for (std::map<std::string, const IODataProviderNamespace::Variant*>::const_iterator i =
-            value.getFieldData().begin(); i != value.getFieldData().end(); i++) {
-        std::string fieldName = (*i).first;
-        const IODataProviderNamespace::Variant& fieldValue = *(*i).second;
+    Struct* ret = Struct::createStruct(*structId, value.getFieldCount());
+    ScopeGuard<Struct> retSG(ret);
+    // for each field in the order of the structure
+    for (size_t i = 0; i < value.getFieldCount(); i++) {
+        const IODataProviderNamespace::Structure::Field& field = value.getField(i);
         // convert field value
-        (*fieldData)[fieldName] = parent->convertIo2bin(fieldValue); // ConversionException
+        ret->addField(field.name, *parent->convertIo2bin(*field.value)); // ConversionException
+    }
+    return retSG.detach();
+}
+
+// binary protocol - InternalInterface
+// boolean         - bool
+// byte            - schar
+// char            - char
+// short           - int
+// int             - long/uint (only uint -> int)
+// long            - llong/ulong (only ulong -> long)
+// float           - float
+// double          - double
+const ScalarConversion ConverterBin2IOPrivate::conversions[] = {
+    { Scalar::BOOLEAN, IODataProviderNamespace::Scalar::BOOL,
+        &convertBin2ioScalar<Scalar::BOOLEAN, IODataProviderNamespace::Scalar::BOOL>,
+        &convertBin2ioValues<Scalar::BOOLEAN, IODataProviderNamespace::Scalar::BOOL>,
+        &convertIo2binScalar<Scalar::BOOLEAN, IODataProviderNamespace::Scalar::BOOL>,
+        &convertIo2binValues<Scalar::BOOLEAN, IODataProviderNamespace::Scalar::BOOL> },
+    { Scalar::BYTE, IODataProviderNamespace::Scalar::SCHAR,
+        &convertBin2ioScalar<Scalar::BYTE, IODataProviderNamespace::Scalar::SCHAR>,
+        &convertBin2ioValues<Scalar::BYTE, IODataProviderNamespace::Scalar::SCHAR>,
+        &convertIo2binScalar<Scalar::BYTE, IODataProviderNamespace::Scalar::SCHAR>,
+        &convertIo2binValues<Scalar::BYTE, IODataProviderNamespace::Scalar::SCHAR> },
+    { Scalar::CHAR, IODataProviderNamespace::Scalar::CHAR,
+        &convertBin2ioScalar<Scalar::CHAR, IODataProviderNamespace::Scalar::CHAR>,
+        &convertBin2ioValues<Scalar::CHAR, IODataProviderNamespace::Scalar::CHAR>,
+        &convertIo2binScalar<Scalar::CHAR, IODataProviderNamespace::Scalar::CHAR>,
+        &convertIo2binValues<Scalar::CHAR, IODataProviderNamespace::Scalar::CHAR> },
+    { Scalar::SHORT, IODataProviderNamespace::Scalar::INT,
+        &convertBin2ioScalar<Scalar::SHORT, IODataProviderNamespace::Scalar::INT>,
+        &convertBin2ioValues<Scalar::SHORT, IODataProviderNamespace::Scalar::INT>,
+        &convertIo2binScalar<Scalar::SHORT, IODataProviderNamespace::Scalar::INT>,
+        &convertIo2binValues<Scalar::SHORT, IODataProviderNamespace::Scalar::INT> },
+    { Scalar::INT, IODataProviderNamespace::Scalar::LONG,
+        &convertBin2ioScalar<Scalar::INT, IODataProviderNamespace::Scalar::LONG>,
+        &convertBin2ioValues<Scalar::INT, IODataProviderNamespace::Scalar::LONG>,
+        &convertIo2binScalar<Scalar::INT, IODataProviderNamespace::Scalar::LONG>,
+        &convertIo2binValues<Scalar::INT, IODataProviderNamespace::Scalar::LONG> },
+    { Scalar::INT, IODataProviderNamespace::Scalar::UINT, NULL, NULL,
+        &convertIo2binScalar<Scalar::INT, IODataProviderNamespace::Scalar::UINT>,
+        &convertIo2binValues<Scalar::INT, IODataProviderNamespace::Scalar::UINT> },
+    { Scalar::LONG, IODataProviderNamespace::Scalar::LLONG,
+        &convertBin2ioScalar<Scalar::LONG, IODataProviderNamespace::Scalar::LLONG>,
+        &convertBin2ioValues<Scalar::LONG, IODataProviderNamespace::Scalar::LLONG>,
+        &convertIo2binScalar<Scalar::LONG, IODataProviderNamespace::Scalar::LLONG>,
+        &convertIo2binValues<Scalar::LONG, IODataProviderNamespace::Scalar::LLONG> },
+    { Scalar::LONG, IODataProviderNamespace::Scalar::ULONG, NULL, NULL,
+        &convertIo2binScalar<Scalar::LONG, IODataProviderNamespace::Scalar::ULONG>,
+        &convertIo2binValues<Scalar::LONG, IODataProviderNamespace::Scalar::ULONG> },
+    { Scalar::FLOAT, IODataProviderNamespace::Scalar::FLOAT,
+        &convertBin2ioScalar<Scalar::FLOAT, IODataProviderNamespace::Scalar::FLOAT>,
+        &convertBin2ioValues<Scalar::FLOAT, IODataProviderNamespace::Scalar::FLOAT>,
+        &convertIo2binScalar<Scalar::FLOAT, IODataProviderNamespace::Scalar::FLOAT>,
+        &convertIo2binValues<Scalar::FLOAT, IODataProviderNamespace::Scalar::FLOAT> },
+    { Scalar::DOUBLE, IODataProviderNamespace::Scalar::DOUBLE,
+        &convertBin2ioScalar<Scalar::DOUBLE, IODataProviderNamespace::Scalar::DOUBLE>,
+        &convertBin2ioValues<Scalar::DOUBLE, IODataProviderNamespace::Scalar::DOUBLE>,
+        &convertIo2binScalar<Scalar::DOUBLE, IODataProviderNamespace::Scalar::DOUBLE>,
+        &convertIo2binValues<Scalar::DOUBLE, IODataProviderNamespace::Scalar::DOUBLE> }
+};
+
+const size_t ConverterBin2IOPrivate::conversionCount =
+        sizeof (conversions) / sizeof (conversions[0]);
+
+const ScalarConversion* ConverterBin2IOPrivate::getBin2ioConversion(int binScalarType) {
+    for (size_t i = 0; i < conversionCount; i++) {
+        if (conversions[i].binScalarType == binScalarType
+                && conversions[i].convertBin2ioScalar != NULL) {
+            return &conversions[i];
+        }
+    }
+    return NULL;
+}
+
+const ScalarConversion* ConverterBin2IOPrivate::getIo2binConversion(int ioScalarType) {
+    for (size_t i = 0; i < conversionCount; i++) {
+        if (conversions[i].ioScalarType == ioScalarType) {
+            return &conversions[i];
+        }
+    }
+    return NULL;
+}
+
+template<int BinScalarType, int IOScalarType> IODataProviderNamespace::Variant*
+ConverterBin2IOPrivate::convertBin2ioScalar(const Scalar& value) {
+    typedef IODataProviderNamespace::ScalarTraits<IOScalarType> IOTraits;
+    IODataProviderNamespace::Scalar* ret = new IODataProviderNamespace::Scalar();
+    IOTraits::set(*ret, static_cast<typename IOTraits::Type> (
+            ScalarTraits<BinScalarType>::get(value)));
+    return ret;
+}
+
+template<int BinScalarType, int IOScalarType> void ConverterBin2IOPrivate::convertBin2ioValues(
+        const std::vector<const Variant*>& elements, void* values) {
+    typedef IODataProviderNamespace::ScalarTraits<IOScalarType> IOTraits;
+    typename IOTraits::ElementType* ioValues =
+            static_cast<typename IOTraits::ElementType*> (values);
+    for (size_t i = 0; i < elements.size(); i++) {
+        ioValues[i] = static_cast<typename IOTraits::ElementType> (
+                ScalarTraits<BinScalarType>::get(*static_cast<const Scalar*> (elements[i])));
+    }
+}
+
+template<int BinScalarType, int IOScalarType> Variant* ConverterBin2IOPrivate::convertIo2binScalar(
+        const IODataProviderNamespace::Scalar& value) {
+    typedef ScalarTraits<BinScalarType> BinTraits;
+    Scalar* ret = new Scalar();
+    BinTraits::set(*ret, static_cast<typename BinTraits::Type> (
+            IODataProviderNamespace::ScalarTraits<IOScalarType>::get(value)));
+    return ret;
+}
+
+template<int BinScalarType, int IOScalarType> void ConverterBin2IOPrivate::convertIo2binValues(
+        const void* values, unsigned long length, std::vector<const Variant*>& elements) {
+    typedef IODataProviderNamespace::ScalarTraits<IOScalarType> IOTraits;
+    typedef ScalarTraits<BinScalarType> BinTraits;
+    const typename IOTraits::ElementType* ioValues =
+            static_cast<const typename IOTraits::ElementType*> (values);
+    elements.reserve(length);
+    for (unsigned long i = 0; i < length; i++) {
+        Scalar* s = new Scalar();
+        elements.push_back(s);
+        BinTraits::set(*s, static_cast<typename BinTraits::Type> (ioValues[i]));
     }
-    return new Struct(*structIdSG.detach(), *fieldDataSG.detach(), true /*attachValues*/);
 }
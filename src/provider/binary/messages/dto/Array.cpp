@@ -5,7 +5,7 @@
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
 
-class ArrayPrivate {
+class ArrayPrivate : public CommonNamespace::ArenaObject {
     friend class Array;
 private:
     int arrayType;
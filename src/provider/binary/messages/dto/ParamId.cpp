@@ -5,58 +5,37 @@
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
 
-class ParamIdPrivate {
-    friend class ParamId;
-private:
-    ParamId::Type paramIdType;
-    int namespaceIndex;
-    bool hasAttachedValues;
-
-    union {
-        unsigned long numericId;
-        const std::string* stringId;
-    };
-
-	void setNamespaceIndex(int index);
-    void setNumeric(long id);
-    void setString(const std::string& id);
-    void init(bool attachValues);
-    void clear();
-};
-
 ParamId::ParamId(int namespaceIndex, unsigned long id) {
-    d = new ParamIdPrivate();
-    d->init(false /* attachValues */);
-    d->setNamespaceIndex(namespaceIndex);
-    d->setNumeric(id);
+    paramIdType = NUMERIC;
+    this->namespaceIndex = namespaceIndex;
+    numericId = id;
 }
 
 ParamId::ParamId(int namespaceIndex, const std::string& id, bool attachValues) {
-    d = new ParamIdPrivate();
-    d->init(attachValues);
-    d->setNamespaceIndex(namespaceIndex);
-    d->setString(id);
+    paramIdType = STRING;
+    this->namespaceIndex = namespaceIndex;
+    numericId = 0;
+    if (attachValues) {
+        // take over the content of the attached string
+        stringId.swap(const_cast<std::string&> (id));
+        delete &id;
+    } else {
+        stringId = id;
+    }
 }
 
-ParamId::ParamId(const ParamId& orig) {
-    d = new ParamIdPrivate();
-    d->paramIdType = orig.d->paramIdType;
-    d->hasAttachedValues = true;
-    d->namespaceIndex = orig.d->namespaceIndex;
-    switch (d->paramIdType) {
-        case NUMERIC:
-            d->numericId = orig.d->numericId;
-            break;
-        case STRING:
-            d->stringId = new std::string(*orig.d->stringId);
-            break;
-    }
+ParamId::ParamId(const ParamId& orig) :
+stringId(orig.stringId) {
+    paramIdType = orig.paramIdType;
+    namespaceIndex = orig.namespaceIndex;
+    numericId = orig.numericId;
 }
 
 ParamId::ParamId(std::string fullString){
 	//TODO ErrorHandling improvement
-	d = new ParamIdPrivate();
-	d->init(false);
+	paramIdType = NUMERIC;
+	namespaceIndex = 0;
+	numericId = 0;
 	std::vector<std::string> v = split(fullString, '|');
 
 	//Must have 3 elements
@@ -65,21 +44,21 @@ ParamId::ParamId(std::string fullString){
 		std::vector<std::string> vns = split(v.at(0), 'S');
 		//Must have 2 elements
 		if (vns.size()>1){
-			std::istringstream(vns.at(1)) >> d->namespaceIndex;
+			std::istringstream(vns.at(1)) >> namespaceIndex;
 		}
 		//Type
 		if (v.at(1).compare("Numeric") == 0){
-			d->paramIdType = NUMERIC;
+			paramIdType = NUMERIC;
 		} else {
-			d->paramIdType = STRING;
+			paramIdType = STRING;
 		}
 		//Identifier
-		switch (d->paramIdType) {
+		switch (paramIdType) {
 			case NUMERIC:
-				std::istringstream(v.at(2)) >> d->numericId;
+				std::istringstream(v.at(2)) >> numericId;
 				break;
 			case STRING:
-				d->setString(v.at(2));
+				stringId = v.at(2);
 				break;
 		}
 	}
@@ -96,70 +75,35 @@ std::vector<std::string> ParamId::split(const std::string& s, char d){
 }
 
 ParamId::~ParamId() {
-    d->clear();
-    delete d;
 }
 
 ParamId::Type ParamId::getParamIdType() const {
-    return d->paramIdType;
+    return paramIdType;
 }
 
 int ParamId::getNamespaceIndex() const {
-    return d->namespaceIndex;
+    return namespaceIndex;
 }
 
 unsigned long ParamId::getNumeric() const {
-    return d->numericId;
+    return numericId;
 }
 
 const std::string& ParamId::getString() const {
-    return *d->stringId;
+    return stringId;
 }
 
 std::string ParamId::toString() const {
     std::ostringstream msg;
-    msg << "NS" << d->namespaceIndex;
+    msg << "NS" << namespaceIndex;
     msg << "|";
-    switch (d->paramIdType) {
+    switch (paramIdType) {
         case NUMERIC:
-            msg << "Numeric|" << d->numericId;
+            msg << "Numeric|" << getNumeric();
             break;
         case STRING:
-            msg << "String|" << d->stringId->c_str();
+            msg << "String|" << getString().c_str();
             break;
     }
     return msg.str();
 }
-
-void ParamIdPrivate::setNamespaceIndex(int index) {
-    namespaceIndex = index;
-}
-
-void ParamIdPrivate::setNumeric(long id) {
-    clear();
-    paramIdType = ParamId::NUMERIC;
-    numericId = id;
-}
-
-void ParamIdPrivate::setString(const std::string& id) {
-    clear();
-    paramIdType = ParamId::STRING;
-    stringId = &id;
-}
-
-void ParamIdPrivate::init(bool attachValues) {
-    paramIdType = ParamId::NUMERIC;
-    hasAttachedValues = attachValues;
-}
-
-void ParamIdPrivate::clear() {
-    if (hasAttachedValues) {
-        switch (paramIdType) {
-            case ParamId::NUMERIC:
-                break;
-            case ParamId::STRING:
-                delete stringId;
-                break;
-        }
-    }
-}
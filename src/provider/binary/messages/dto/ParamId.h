@@ -1,13 +1,14 @@
 #ifndef PROVIDER_BINARY_MESSAGES_DTO_PARAMID_H
 #define PROVIDER_BINARY_MESSAGES_DTO_PARAMID_H
 
+#include <common/ArenaObject.h>
 #include <string>
 #include <vector>
 
 
-class ParamIdPrivate;
-
-class ParamId {
+// Instances are allocated from the current arena of the thread if an ArenaScope is active.
+// A string identifier is held as std::string member, so getString does not modify the instance.
+class ParamId : public CommonNamespace::ArenaObject {
 public:
 
     enum Type {
@@ -38,8 +39,11 @@ public:
 
 private:    
     ParamId& operator=(const ParamId& orig);
-    
-    ParamIdPrivate* d;
+
+    Type paramIdType;
+    int namespaceIndex;
+    unsigned long numericId;
+    std::string stringId;
 
     std::vector<std::string> split(const std::string& s, char d);
 
@@ -5,137 +5,92 @@
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
 
-class ScalarPrivate {
-    friend class Scalar;
-private:
-    Scalar::Type scalarType;
-
-    union {
-        bool booleanValue;
-        char charValue;
-        signed char byteValue;
-        int shortValue;
-        long intValue;
-        long long longValue;
-        float floatValue;
-        double doubleValue;
-    };
-};
-
 Scalar::Scalar() {
-    d = new ScalarPrivate();
     setInt(0);
 }
 
 Scalar::Scalar(const Scalar& orig) {
-    d = new ScalarPrivate();
-    d->scalarType = orig.d->scalarType;
-    switch (d->scalarType) {
-        case BOOLEAN:
-            d->booleanValue = orig.d->booleanValue;
-            break;
-        case CHAR:
-            d->charValue = orig.d->charValue;
-            break;
-        case BYTE:
-            d->byteValue = orig.d->byteValue;
-            break;
-        case SHORT:
-            d->shortValue = orig.d->shortValue;
-            break;
-        case INT:
-            d->intValue = orig.d->intValue;
-            break;
-        case LONG:
-            d->longValue = orig.d->longValue;
-            break;
-        case FLOAT:
-            d->floatValue = orig.d->floatValue;
-            break;
-        case DOUBLE:
-            d->doubleValue = orig.d->doubleValue;
-            break;
-    }
+    scalarType = orig.scalarType;
+    value = orig.value;
 }
 
 Scalar::~Scalar() {
-    delete d;
 }
 
 Scalar::Type Scalar::getScalarType() const {
-    return d->scalarType;
+    return scalarType;
 }
 
 bool Scalar::getBoolean() const {
-    return d->booleanValue;
+    return value.getNumeric().boolValue;
 }
 
 void Scalar::setBoolean(bool value) {
-    d->scalarType = BOOLEAN;
-    d->booleanValue = value;
+    scalarType = BOOLEAN;
+    this->value.setNumeric().boolValue = value;
 }
 
 char Scalar::getChar() const {
-    return d->charValue;
+    return value.getNumeric().charValue;
 }
 
 void Scalar::setChar(char value) {
-    d->scalarType = CHAR;
-    d->charValue = value;
+    scalarType = CHAR;
+    this->value.setNumeric().charValue = value;
 }
 
 signed char Scalar::getByte() const {
-    return d->byteValue;
+    return value.getNumeric().scharValue;
 }
 
 void Scalar::setByte(signed char value) {
-    d->scalarType = BYTE;
-    d->byteValue = value;
+    scalarType = BYTE;
+    this->value.setNumeric().scharValue = value;
 }
 
 int Scalar::getShort() const {
-    return d->shortValue;
+    return value.getNumeric().intValue;
 }
 
 void Scalar::setShort(int value) {
-    d->scalarType = SHORT;
-    d->shortValue = value;
+    scalarType = SHORT;
+    this->value.setNumeric().intValue = value;
 }
 
 long Scalar::getInt() const {
-    return d->intValue;
+    return value.getNumeric().longValue;
 }
 
 void Scalar::setInt(long value) {
-    d->scalarType = INT;
-    d->intValue = value;
+    scalarType = INT;
+    this->value.setNumeric().longValue = value;
 }
 
 long long Scalar::getLong() const {
-    return d->longValue;
+    return value.getNumeric().llongValue;
 }
 
 void Scalar::setLong(long long value) {
-    d->scalarType = LONG;
-    d->longValue = value;
+    scalarType = LONG;
+    this->value.setNumeric().llongValue = value;
 }
 
 float Scalar::getFloat() const {
-    return d->floatValue;
+    return value.getNumeric().floatValue;
 }
 
 void Scalar::setFloat(float value) {
-    d->scalarType = FLOAT;
-    d->floatValue = value;
+    scalarType = FLOAT;
+    this->value.setNumeric().floatValue = value;
 }
 
 double Scalar::getDouble() const {
-    return d->doubleValue;
+    return value.getNumeric().doubleValue;
 }
 
 void Scalar::setDouble(double value) {
-    d->scalarType = DOUBLE;
-    d->doubleValue = value;
+    scalarType = DOUBLE;
+    this->value.setNumeric().doubleValue = value;
 }
 
 Variant* Scalar::copy() const {
@@ -149,30 +104,30 @@ Variant::Type Scalar::getVariantType() const {
 std::string Scalar::toString() const {
     std::ostringstream msg;
     msg << "Scalar[type=";
-    switch (d->scalarType) {
+    switch (scalarType) {
         case BOOLEAN:
-            msg << "boolean,value=" << d->booleanValue;
+            msg << "boolean,value=" << getBoolean();
             break;
         case CHAR:
-            msg << "char,value=" << d->charValue;
+            msg << "char,value=" << getChar();
             break;
         case BYTE:
-            msg << "byte,value=" << d->byteValue;
+            msg << "byte,value=" << getByte();
             break;
         case SHORT:
-            msg << "short,value=" << d->shortValue;
+            msg << "short,value=" << getShort();
             break;
         case INT:
-            msg << "int,value=" << d->intValue;
+            msg << "int,value=" << getInt();
             break;
         case LONG:
-            msg << "long,value=" << d->longValue;
+            msg << "long,value=" << getLong();
             break;
         case FLOAT:
-            msg << "float,value=" << d->floatValue;
+            msg << "float,value=" << getFloat();
             break;
         case DOUBLE:
-            msg << "double,value=" << d->doubleValue;
+            msg << "double,value=" << getDouble();
             break;
     }
     msg << "]";
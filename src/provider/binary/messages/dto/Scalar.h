@@ -2,10 +2,9 @@
 #define PROVIDER_BINARY_MESSAGES_DTO_SCALAR_H
 
 #include "Variant.h"
+#include <common/CompactValue.h>
 #include <string>
 
-class ScalarPrivate;
-
 class Scalar : public Variant {
 public:
 
@@ -67,7 +66,9 @@ public:
 private:
     Scalar& operator=(const Scalar& orig);
 
-    ScalarPrivate* d;
+    Type scalarType;
+    // the value is stored in the instance itself
+    CommonNamespace::CompactValue value;
 };
 
 #endif /* PROVIDER_BINARY_MESSAGES_DTO_SCALAR_H */
@@ -0,0 +1,117 @@
+#ifndef PROVIDER_BINARY_MESSAGES_DTO_SCALARTRAITS_H
+#define PROVIDER_BINARY_MESSAGES_DTO_SCALARTRAITS_H
+
+#include "Scalar.h"
+
+// Compile-time description of a scalar type of the binary protocol. Converters use the traits
+// to generate a specialized conversion for each pair of types instead of dispatching via
+// switch statements for each value:
+//   Type:    the value type of the getter and setter of Scalar
+//   get/set: access to the value of a Scalar
+template<int ScalarType> class ScalarTraits;
+
+template<> class ScalarTraits<Scalar::BOOLEAN> {
+public:
+    typedef bool Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getBoolean();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setBoolean(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::CHAR> {
+public:
+    typedef char Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getChar();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setChar(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::BYTE> {
+public:
+    typedef signed char Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getByte();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setByte(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::SHORT> {
+public:
+    typedef int Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getShort();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setShort(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::INT> {
+public:
+    typedef long Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getInt();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setInt(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::LONG> {
+public:
+    typedef long long Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getLong();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setLong(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::FLOAT> {
+public:
+    typedef float Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getFloat();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setFloat(value);
+    }
+};
+
+template<> class ScalarTraits<Scalar::DOUBLE> {
+public:
+    typedef double Type;
+
+    static Type get(const Scalar& scalar) {
+        return scalar.getDouble();
+    }
+
+    static void set(Scalar& scalar, Type value) {
+        scalar.setDouble(value);
+    }
+};
+
+#endif /* PROVIDER_BINARY_MESSAGES_DTO_SCALARTRAITS_H */
@@ -1,46 +1,53 @@
 #include "Struct.h"
 #include <sstream> // std::ostringstream
+#include <vector>
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
 
-class StructPrivate {
+class StructPrivate : public CommonNamespace::ArenaObject {
     friend class Struct;
 private:
     const ParamId* structId;
-    const std::map<std::string, const Variant*>* fields;
+    std::vector<Struct::Field> fields;
+    // field name => field value (the attached map or NULL until the first call of getFields)
+    std::map<std::string, const Variant*>* fieldMap;
     bool hasAttachedValues;
 
+    void setFields(const std::map<std::string, const Variant*>& fields);
     void deleteFields();
 };
 
 Struct::Struct(const ParamId& structId, const std::map<std::string, const Variant*>& fields,
         bool attachValues) {
     d = new StructPrivate();
-    d->fields = &fields;
     d->structId = &structId;
+    d->fieldMap = NULL;
     d->hasAttachedValues = attachValues;
+    d->setFields(fields);
+}
+
+Struct::Struct() {
+    d = new StructPrivate();
 }
 
 Struct::Struct(const Struct& orig) {
     d = new StructPrivate();
     d->structId = new ParamId(*orig.d->structId);
-    std::map<std::string, const Variant*>* newFields = new std::map<std::string, const Variant*>();
-    for (std::map<std::string, const Variant*>::const_iterator i =
-            orig.d->fields->begin(); i != orig.d->fields->end(); i++) {
-        newFields->insert(
-                std::pair<std::string, const Variant*>(
-                std::string((*i).first), (*i).second->copy()));
-    }
-    d->fields = newFields;
+    d->fieldMap = NULL;
     d->hasAttachedValues = true;
+    d->fields.reserve(orig.d->fields.size());
+    for (std::vector<Field>::const_iterator i = orig.d->fields.begin();
+            i != orig.d->fields.end(); i++) {
+        addField((*i).name, *(*i).value->copy());
+    }
 }
 
 Struct::~Struct() {
     if (d->hasAttachedValues) {
         delete d->structId;
-        d->deleteFields();
     }
+    d->deleteFields();
     delete d;
 }
 
@@ -56,14 +63,71 @@ void Struct::setStructId(const ParamId& structId) {
 }
 
 const std::map<std::string, const Variant*>& Struct::getFields() const {
-    return *d->fields;
+    // the map is read and published atomically (readers of the same instance may call this
+    // method concurrently)
+    std::map<std::string, const Variant*>* ret = __sync_val_compare_and_swap(&d->fieldMap,
+            static_cast<std::map<std::string, const Variant*>*> (NULL),
+            static_cast<std::map<std::string, const Variant*>*> (NULL));
+    if (ret == NULL) {
+        std::map<std::string, const Variant*>* fieldMap =
+                new std::map<std::string, const Variant*>();
+        for (std::vector<Field>::const_iterator i = d->fields.begin();
+                i != d->fields.end(); i++) {
+            (*fieldMap)[(*i).name] = (*i).value;
+        }
+        ret = __sync_val_compare_and_swap(&d->fieldMap,
+                static_cast<std::map<std::string, const Variant*>*> (NULL), fieldMap);
+        if (ret == NULL) {
+            ret = fieldMap;
+        } else {
+            // another thread has created the map
+            delete fieldMap;
+        }
+    }
+    return *ret;
 }
 
 void Struct::setFields(const std::map<std::string, const Variant*>& fields) {
-    if (d->hasAttachedValues) {
-        d->deleteFields();
+    d->deleteFields();
+    d->setFields(fields);
+}
+
+size_t Struct::getFieldCount() const {
+    return d->fields.size();
+}
+
+const Struct::Field& Struct::getField(size_t index) const {
+    return d->fields[index];
+}
+
+const Variant* Struct::getFieldValue(const std::string& name, size_t hint) const {
+    size_t count = d->fields.size();
+    for (size_t i = 0; i < count; i++) {
+        const Field& field = d->fields[(hint + i) % count];
+        if (field.name == name) {
+            return field.value;
+        }
     }
-    d->fields = &fields;
+    return NULL;
+}
+
+void Struct::addField(const std::string& name, const Variant& value) {
+    d->fields.push_back(Field());
+    Field& field = d->fields.back();
+    field.name = name;
+    field.value = &value;
+    if (d->fieldMap != NULL) {
+        (*d->fieldMap)[name] = &value;
+    }
+}
+
+Struct* Struct::createStruct(const ParamId& structId, size_t fieldCount) {
+    Struct* ret = new Struct();
+    ret->d->structId = &structId;
+    ret->d->fieldMap = NULL;
+    ret->d->hasAttachedValues = true;
+    ret->d->fields.reserve(fieldCount);
+    return ret;
 }
 
 Variant* Struct::copy() const {
@@ -77,21 +141,39 @@ Variant::Type Struct::getVariantType() const {
 std::string Struct::toString() const {
     std::ostringstream msg;
     msg << "Struct[structId=" << d->structId->toString() << ",fields=";
-    for (std::map<std::string, const Variant*>::const_iterator i = d->fields->begin();
-            i != d->fields->end(); i++) {
-        if (i != d->fields->begin()) {
+    for (std::vector<Field>::const_iterator i = d->fields.begin(); i != d->fields.end(); i++) {
+        if (i != d->fields.begin()) {
             msg << ",";
         }
-        msg << (*i).first << "=>" << (*i).second->toString();
+        msg << (*i).name << "=>" << (*i).value->toString();
     }
     msg << "]";
     return msg.str();
 }
 
+void StructPrivate::setFields(const std::map<std::string, const Variant*>& fields) {
+    this->fields.reserve(fields.size());
+    for (std::map<std::string, const Variant*>::const_iterator i = fields.begin();
+            i != fields.end(); i++) {
+        this->fields.push_back(Struct::Field());
+        Struct::Field& field = this->fields.back();
+        field.name = (*i).first;
+        field.value = (*i).second;
+    }
+    if (hasAttachedValues) {
+        // the attached map is provided by getFields
+        fieldMap = const_cast<std::map<std::string, const Variant*>*> (&fields);
+    }
+}
+
 void StructPrivate::deleteFields() {
-    for (std::map<std::string, const Variant*>::const_iterator i =
-            fields->begin(); i != fields->end(); i++) {
-        delete (*i).second;
+    if (hasAttachedValues) {
+        for (std::vector<Struct::Field>::const_iterator i = fields.begin(); i != fields.end();
+                i++) {
+            delete (*i).value;
+        }
     }
-    delete fields;
+    fields.clear();
+    delete fieldMap;
+    fieldMap = NULL;
 }
@@ -4,14 +4,24 @@
 #include "ParamId.h"
 #include "Variant.h"
 #include <map>
+#include <stddef.h> // size_t
 #include <string>
 
 class StructPrivate;
 
+// The fields of a struct are stored contiguously in the order they have been added.
 class Struct : public Variant {
 public:
+
+    class Field {
+    public:
+        std::string name;
+        const Variant* value;
+    };
+
     // If the values are attached then the responsibility for destroying the value instances
     // is delegated to the instance.
+    // fields: field name => field value (the fields are stored in the order of the map)
     Struct(const ParamId& structId, const std::map<std::string, const Variant*>& fields,
             bool attachValues = false);
     // Creates a deep copy of the instance.
@@ -21,14 +31,32 @@ public:
     virtual const ParamId& getStructId() const;
     virtual void setStructId(const ParamId& structId);
 
+    // Returns the fields as map (field name => field value).
+    // The map is created with the first call (this is thread safe).
     virtual const std::map<std::string, const Variant*>& getFields() const;
     virtual void setFields(const std::map<std::string, const Variant*>& fields);
+    // Returns the count of fields.
+    virtual size_t getFieldCount() const;
+    // Returns the field at a position.
+    virtual const Field& getField(size_t index) const;
+    // Returns the value of a field or NULL if the struct does not contain the field.
+    // The search starts at the position "hint".
+    virtual const Variant* getFieldValue(const std::string& name, size_t hint = 0) const;
+    // Appends a field. If the values are attached then the value is attached too.
+    virtual void addField(const std::string& name, const Variant& value);
+
+    // Creates a struct without fields. The fields are appended via addField. The struct id
+    // and the values are attached.
+    // fieldCount: the expected count of fields
+    // The returned instance must be destroyed by the caller.
+    static Struct* createStruct(const ParamId& structId, size_t fieldCount);
 
     // interface Variant
     virtual Variant* copy() const;
     virtual Type getVariantType() const;
     virtual std::string toString() const;
 private:
+    Struct();
     Struct& operator=(const Struct& orig);
     
     StructPrivate* d;
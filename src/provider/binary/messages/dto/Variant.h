@@ -1,9 +1,12 @@
 #ifndef PROVIDER_BINARY_MESSAGES_DTO_VARIANT_H
 #define PROVIDER_BINARY_MESSAGES_DTO_VARIANT_H
 
+#include <common/ArenaObject.h>
 #include <string>
 
-class Variant {
+// Instances are allocated from the current arena of the thread if an ArenaScope is active
+// (only the instances themselves; their containers and strings use the heap).
+class Variant : public CommonNamespace::ArenaObject {
 public:
 
     enum Type {
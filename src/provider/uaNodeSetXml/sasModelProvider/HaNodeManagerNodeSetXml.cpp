@@ -3,12 +3,15 @@
 #include "HaXmlUaNodeFactoryNamespace.h"
 #include "ObjectTypeElement.h"
 #include <common/Exception.h>
+#include <common/ScopeGuard.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <sasModelProvider/base/HaNodeManagerException.h>
 #include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
 #include <sasModelProvider/base/NodeBrowser.h>
 #include <opcua_filetype.h> // OpcUa::FileType
+#include <uadatetime.h> // UaDateTime
+#include <uamutex.h> // UaMutexLocker
 #include <map>
 #include <vector>
 #include <sstream> // std::ostringstream
@@ -26,6 +29,7 @@ private:
     EventTypeRegistry* eventTypeRegistry;
     HaXmlUaNodeFactoryManagerSet* xmlUaNodeFactoryManagerSet;
     IODataProviderNamespace::IODataProvider* ioDataProvider;
+    HaNodeManagerIODataProviderBridge::Configuration bridgeConf;
     HaNodeManagerIODataProviderBridge* nmioBridge;
     // xmlNodeId => objectTypeElement
     std::map<std::string, const ObjectTypeElement*> objectTypeElements;
@@ -37,6 +41,15 @@ private:
     /* throws HaNodeManagerException */;
     // Adds object types and its components to internal list
     void addObjectTypeElements(UaNode& node, const UaNodeId& parentNodeId, int indent);
+    // Sets a value with the given source and server time stamp.
+    void setVariable(UaVariable& variable, UaVariant& newValue, const UaDateTime& timeStamp)
+    /* throws HaNodeManagerException */;
+    // Creates the data value for a new value with the given source and server time stamp.
+    void initDataValue(UaDataValue& dataValue, UaVariant& newValue, const UaDateTime& timeStamp);
+    void logValue(UaVariable& variable, const UaVariant& oldValue, UaVariant& newValue);
+    // The returned instance must be destroyed by the caller.
+    HaNodeManagerException* createException(UaVariable& variable, const UaStatus& status,
+            const UaVariant& oldValue, UaVariant& newValue);
     bool isEventType(UaNode& node, OpcUa_BrowseDirection browseDirection)
     /* throws HaNodeManagerException */;
     // logs the nodes which are added to internal lists via addVariables or addObjectTypeElements
@@ -47,7 +60,8 @@ HaNodeManagerNodeSetXml::HaNodeManagerNodeSetXml(const UaString& namespaceUri,
         const std::vector<HaNodeManager*>& associatedNodeManagers,
         EventTypeRegistry& eventTypeRegistry,
         HaXmlUaNodeFactoryManagerSet& uaNodeFactoryManagerSet,
-        IODataProviderNamespace::IODataProvider& ioDataProvider)
+        IODataProviderNamespace::IODataProvider& ioDataProvider,
+        const HaNodeManagerIODataProviderBridge::Configuration& bridgeConf)
 : NodeManagerNodeSetXml(namespaceUri) {
     d = new HaNodeManagerNodeSetXmlPrivate();
     d->log = LoggerFactory::getLogger("HaNodeManagerNodeSetXml");
@@ -56,6 +70,7 @@ HaNodeManagerNodeSetXml::HaNodeManagerNodeSetXml(const UaString& namespaceUri,
     d->eventTypeRegistry = &eventTypeRegistry;
     d->xmlUaNodeFactoryManagerSet = &uaNodeFactoryManagerSet;
     d->ioDataProvider = &ioDataProvider;
+    d->bridgeConf = bridgeConf;
 }
 
 HaNodeManagerNodeSetXml::~HaNodeManagerNodeSetXml() {
@@ -210,6 +225,16 @@ void HaNodeManagerNodeSetXml::dataTypeCreated(UaDataType* pNewNode, UaBase::Data
     //    }
 }
 
+UaStatus HaNodeManagerNodeSetXml::deleteUaNode(UaNode* pNode,
+        OpcUa_Boolean bDeleteTargetReferences, OpcUa_Boolean bDeleteSourceReferences,
+        OpcUa_Boolean bAddModelChangeEvents) {
+    if (pNode != NULL) {
+        NodeBrowser::nodeDeleted(pNode->nodeId());
+    }
+    return NodeManagerNodeSetXml::deleteUaNode(pNode, bDeleteTargetReferences,
+            bDeleteSourceReferences, bAddModelChangeEvents);
+}
+
 UaStatus HaNodeManagerNodeSetXml::afterStartUp() {
     UaStatus ret = NodeManagerNodeSetXml::afterStartUp();
     if (ret.isNotGood()) {
@@ -221,7 +246,7 @@ UaStatus HaNodeManagerNodeSetXml::afterStartUp() {
             *new HaXmlUaNodeFactoryNamespace(getNameSpaceIndex(), *this /*methodManager*/));
     // create the bridge to the IO data provider
     d->nmioBridge = new HaNodeManagerIODataProviderBridge(*this,
-            *d->ioDataProvider);
+            *d->ioDataProvider, d->bridgeConf);
     ret = d->nmioBridge->afterStartUp();
     if (ret.isNotGood()) {
         return ret;
@@ -269,6 +294,28 @@ void HaNodeManagerNodeSetXml::variableCacheMonitoringChanged(UaVariableCache* pV
     d->nmioBridge->variableCacheMonitoringChanged(pVariable, transactionType);
 }
 
+UaStatus HaNodeManagerNodeSetXml::beginStartMonitoring(OpcUa_Handle hEventManagerTransaction,
+        OpcUa_UInt32 callbackHandle, EventCallback* pEventCallback,
+        const UaNodeIdArray& eventSources, EventFilter* pEventFilter,
+        OpcUa_UInt32& hEventItem) {
+    UaStatus ret = NodeManagerNodeSetXml::beginStartMonitoring(hEventManagerTransaction,
+            callbackHandle, pEventCallback, eventSources, pEventFilter, hEventItem);
+    if (ret.isGood()) {
+        d->nmioBridge->eventMonitoringChanged(true /* isStarted */);
+    }
+    return ret;
+}
+
+UaStatus HaNodeManagerNodeSetXml::beginStopMonitoring(OpcUa_Handle hEventManagerTransaction,
+        OpcUa_UInt32 hEventItem) {
+    UaStatus ret = NodeManagerNodeSetXml::beginStopMonitoring(hEventManagerTransaction,
+            hEventItem);
+    if (ret.isGood()) {
+        d->nmioBridge->eventMonitoringChanged(false /* isStarted */);
+    }
+    return ret;
+}
+
 UaStatus HaNodeManagerNodeSetXml::beginCall(MethodManagerCallback* pCallback,
         const ServiceContext& serviceContext, OpcUa_UInt32 callbackHandle,
         MethodHandle* pMethodHandle, const UaVariantArray & inputArguments) {
@@ -306,32 +353,106 @@ const UaString & HaNodeManagerNodeSetXml::getDefaultLocaleId() const {
 
 void HaNodeManagerNodeSetXml::setVariable(UaVariable & variable,
         UaVariant & newValue) /* throws HaNodeManagerException */ {
+    d->setVariable(variable, newValue, UaDateTime::now()); // HaNodeManagerException
+}
+
+void HaNodeManagerNodeSetXml::setVariables(const std::vector<UaVariable*>& variables,
+        const std::vector<UaVariant*>& newValues) /* throws HaNodeManagerException */ {
+    size_t count = variables.size();
+    // prepare the data values before the nodes are locked
+    UaDateTime now = UaDateTime::now();
+    std::vector<UaDataValue> dataValues(count);
+    for (size_t i = 0; i < count; i++) {
+        d->initDataValue(dataValues[i], *newValues[i], now);
+    }
+    bool isInfoEnabled = d->log->isInfoEnabled();
+    // the previous values are only copied for logging and failed variables
+    std::vector<UaVariant> oldValues(count);
+    std::vector<UaStatus> statuses(count);
+    {
+        // lock the nodes once for all values; the SDK evaluates the value change of each
+        // variable in "setValue" (it provides no means to defer the change handling of
+        // several variables)
+        UaMutexLocker lock(&m_mutexNodes);
+        for (size_t i = 0; i < count; i++) {
+            if (isInfoEnabled) {
+                oldValues[i] = *variables[i]->value(NULL /* session */).value();
+            }
+            statuses[i] = variables[i]->setValue(NULL /* session */, dataValues[i],
+                    OpcUa_False /* checkAccessLevel */);
+            if (!statuses[i].isGood() && !isInfoEnabled) {
+                oldValues[i] = *variables[i]->value(NULL /* session */).value();
+            }
+        }
+    }
+    // log the values and report the first failed variable after the nodes are unlocked
+    HaNodeManagerException* exception = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (isInfoEnabled) {
+            d->logValue(*variables[i], oldValues[i], *newValues[i]);
+        }
+        if (!statuses[i].isGood() && exception == NULL) {
+            exception = d->createException(*variables[i], statuses[i], oldValues[i],
+                    *newValues[i]);
+        }
+    }
+    if (d->log->isDebugEnabled()) {
+        d->log->debug("Set %lu variable values", variables.size());
+    }
+    if (exception != NULL) {
+        ScopeGuard<HaNodeManagerException> exceptionSG(exception);
+        throw *exception;
+    }
+}
+
+void HaNodeManagerNodeSetXmlPrivate::setVariable(UaVariable& variable, UaVariant& newValue,
+        const UaDateTime& timeStamp) /* throws HaNodeManagerException */ {
     const OpcUa_Variant* cacheValue = variable.value(
             NULL /* session */).value();
-    if (d->log->isInfoEnabled()) {
-        d->log->info("SET %-20s nodeId=%s,oldValue=%s,newValue=%s",
-                variable.browseName().toString().toUtf8(),
-                variable.nodeId().toXmlString().toUtf8(),
-                UaVariant(*cacheValue).toString().toUtf8(),
-                newValue.toFullString().toUtf8());
+    if (log->isInfoEnabled()) {
+        logValue(variable, UaVariant(*cacheValue), newValue);
     }
     // set new value
     UaDataValue dataValue;
-    dataValue.setValue(newValue, OpcUa_False /* detachValue */, OpcUa_True /* updateTimeStamps */);
+    initDataValue(dataValue, newValue, timeStamp);
     UaStatus status = variable.setValue(NULL /* session */, dataValue,
             OpcUa_False /* checkAccessLevel */);
     if (!status.isGood()) {
-        std::ostringstream msg;
-        msg << "Cannot set value to variable: " << status.toString().toUtf8()
-                << " nodeId=" << variable.nodeId().toXmlString().toUtf8()
-                << ",dataType=" << variable.dataType().toXmlString().toUtf8()
-                << ",variantType=" << newValue.dataType().toXmlString().toUtf8()
-                << ",oldValue=" << UaVariant(*cacheValue).toString().toUtf8()
-                << ",newValue=" << newValue.toFullString().toUtf8();
-        throw ExceptionDef(HaNodeManagerException, msg.str());
+        HaNodeManagerException* exception = createException(variable, status,
+                UaVariant(*cacheValue), newValue);
+        ScopeGuard<HaNodeManagerException> exceptionSG(exception);
+        throw *exception;
     }
 }
 
+void HaNodeManagerNodeSetXmlPrivate::initDataValue(UaDataValue& dataValue, UaVariant& newValue,
+        const UaDateTime& timeStamp) {
+    dataValue.setValue(newValue, OpcUa_False /* detachValue */, OpcUa_False /* updateTimeStamps */);
+    dataValue.setSourceTimestamp(timeStamp);
+    dataValue.setServerTimestamp(timeStamp);
+}
+
+void HaNodeManagerNodeSetXmlPrivate::logValue(UaVariable& variable, const UaVariant& oldValue,
+        UaVariant& newValue) {
+    log->info("SET %-20s nodeId=%s,oldValue=%s,newValue=%s",
+            variable.browseName().toString().toUtf8(),
+            variable.nodeId().toXmlString().toUtf8(),
+            oldValue.toString().toUtf8(),
+            newValue.toFullString().toUtf8());
+}
+
+HaNodeManagerException* HaNodeManagerNodeSetXmlPrivate::createException(UaVariable& variable,
+        const UaStatus& status, const UaVariant& oldValue, UaVariant& newValue) {
+    std::ostringstream msg;
+    msg << "Cannot set value to variable: " << status.toString().toUtf8()
+            << " nodeId=" << variable.nodeId().toXmlString().toUtf8()
+            << ",dataType=" << variable.dataType().toXmlString().toUtf8()
+            << ",variantType=" << newValue.dataType().toXmlString().toUtf8()
+            << ",oldValue=" << oldValue.toString().toUtf8()
+            << ",newValue=" << newValue.toFullString().toUtf8();
+    return new ExceptionDef(HaNodeManagerException, msg.str());
+}
+
 void HaNodeManagerNodeSetXmlPrivate::addVariables(UaNode& node, const UaNodeId& parentNodeId,
         int indent)/* throws HaNodeManagerException */ {
     std::string nodeIdXml(node.nodeId().toXmlString().toUtf8());
@@ -3,8 +3,10 @@
 
 #include <ioDataProvider/IODataProvider.h>
 #include <sasModelProvider/base/HaNodeManager.h>
+#include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
 #include "HaXmlUaNodeFactoryManagerSet.h"
 #include <basenodes.h> // UaBase::Variable
+#include <eventmanager.h> // EventCallback, EventFilter
 #include <instancefactory.h> // XmlUaNodeFactoryManager
 #include <iomanageruanode.h> // UaVariableArray
 #include <methodmanager.h> // MethodHandle
@@ -30,7 +32,8 @@ public:
             const std::vector<HaNodeManager*>& associatedNodeManagers,
             EventTypeRegistry& eventTypeRegistry, 
             HaXmlUaNodeFactoryManagerSet& uaNodeFactoryManagerSet,
-            IODataProviderNamespace::IODataProvider& ioDataProvider);
+            IODataProviderNamespace::IODataProvider& ioDataProvider,
+            const HaNodeManagerIODataProviderBridge::Configuration& bridgeConf);
     virtual ~HaNodeManagerNodeSetXml();
 
     // interface NodeManagerNodeSetXml
@@ -44,6 +47,20 @@ public:
     virtual void methodCreated(UaMethod* pNewNode, UaBase::Method *pMethod);
     virtual void dataTypeCreated(UaDataType* pNewNode, UaBase::DataType *pDataType);
 
+    // interface NodeManagerConfig
+    // The node is removed from the caches of the node browsers before it is deleted.
+    virtual UaStatus deleteUaNode(UaNode* pNode, OpcUa_Boolean bDeleteTargetReferences,
+            OpcUa_Boolean bDeleteSourceReferences,
+            OpcUa_Boolean bAddModelChangeEvents = OpcUa_False);
+
+    // interface EventManagerUaNode
+    virtual UaStatus beginStartMonitoring(OpcUa_Handle hEventManagerTransaction,
+            OpcUa_UInt32 callbackHandle, EventCallback* pEventCallback,
+            const UaNodeIdArray& eventSources, EventFilter* pEventFilter,
+            OpcUa_UInt32& hEventItem);
+    virtual UaStatus beginStopMonitoring(OpcUa_Handle hEventManagerTransaction,
+            OpcUa_UInt32 hEventItem);
+
     // interface HaNodeManager
     virtual UaStatus afterStartUp();
     virtual UaStatus beforeShutDown();
@@ -70,6 +87,8 @@ public:
     virtual const UaString& getDefaultLocaleId() const;
     virtual void setVariable(UaVariable& variable,
             UaVariant& newValue) /* throws HaNodeManagerException */;
+    virtual void setVariables(const std::vector<UaVariable*>& variables,
+            const std::vector<UaVariant*>& newValues) /* throws HaNodeManagerException */;
 private:
     HaNodeManagerNodeSetXmlPrivate* d;
 };
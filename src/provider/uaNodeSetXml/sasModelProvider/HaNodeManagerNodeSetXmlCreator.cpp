@@ -8,18 +8,21 @@ private:
     std::vector<HaNodeManager*>* nodeManagers;
     EventTypeRegistry* eventTypeRegistry;
     IODataProviderNamespace::IODataProvider* ioDataProvider;
+    HaNodeManagerIODataProviderBridge::Configuration bridgeConf;
 };
 
 HaNodeManagerNodeSetXmlCreator::HaNodeManagerNodeSetXmlCreator(
         std::vector<HaNodeManager*>& nodeManagers,
         EventTypeRegistry& eventTypeRegistry,
         HaXmlUaNodeFactoryManagerSet& uaNodeFactoryManagerSet,
-        IODataProviderNamespace::IODataProvider& ioDataProvider) {
+        IODataProviderNamespace::IODataProvider& ioDataProvider,
+        const HaNodeManagerIODataProviderBridge::Configuration& bridgeConf) {
     d = new HaNodeManagerNodeSetXmlCreatorPrivate();
     d->nodeManagers = &nodeManagers;
     d->eventTypeRegistry = &eventTypeRegistry;
     d->xmlUaNodeFactoryManagerSet = &uaNodeFactoryManagerSet;
     d->ioDataProvider = &ioDataProvider;
+    d->bridgeConf = bridgeConf;
 }
 
 HaNodeManagerNodeSetXmlCreator::~HaNodeManagerNodeSetXmlCreator() {
@@ -30,7 +33,7 @@ NodeManagerNodeSetXml* HaNodeManagerNodeSetXmlCreator::createNodeManager(
         const UaString& namespaceUri) {
     HaNodeManagerNodeSetXml* nm = new HaNodeManagerNodeSetXml(namespaceUri,
             *d->nodeManagers, *d->eventTypeRegistry, *d->xmlUaNodeFactoryManagerSet,
-            *d->ioDataProvider);
+            *d->ioDataProvider, d->bridgeConf);
     d->nodeManagers->push_back(nm);
     return nm;
 }
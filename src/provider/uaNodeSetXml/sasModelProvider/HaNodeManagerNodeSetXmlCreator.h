@@ -4,6 +4,7 @@
 #include <ioDataProvider/IODataProvider.h>
 #include <sasModelProvider/base/EventTypeRegistry.h>
 #include <sasModelProvider/base/HaNodeManager.h>
+#include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
 #include "HaXmlUaNodeFactoryManagerSet.h"
 #include <nodemanagernodesetxml.h> // NodeManagerNodeSetXmlCreator
 #include <uastring.h> // UaString
@@ -17,7 +18,8 @@ public:
             std::vector<SASModelProviderNamespace::HaNodeManager*>& nodeManagers,
             SASModelProviderNamespace::EventTypeRegistry& eventTypeRegistry,
             HaXmlUaNodeFactoryManagerSet& uaNodeFactoryManagerSet,
-            IODataProviderNamespace::IODataProvider& ioDataProvider);
+            IODataProviderNamespace::IODataProvider& ioDataProvider,
+            const SASModelProviderNamespace::HaNodeManagerIODataProviderBridge::Configuration& bridgeConf);
     virtual ~HaNodeManagerNodeSetXmlCreator();
 
     // interface NodeManagerNodeSetXmlCreator
@@ -2,14 +2,18 @@
 #include "HaNodeManagerNodeSetXmlCreator.h"
 #include "HaXmlUaNodeFactoryManager.h"
 #include <common/Exception.h>
+#include <common/logging/LogThrottle.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <sasModelProvider/SASModelProviderException.h>
 #include <sasModelProvider/base/EventTypeRegistry.h>
 #include <sasModelProvider/base/HaNodeManager.h>
+#include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
 #include <uastring.h> // UaString
 #include <algorithm>  // std::sort
 #include <dirent.h>
+#include <fstream> // std::ifstream
+#include <map>
 #include <sstream> // opendir
 
 using namespace CommonNamespace;
@@ -29,6 +33,62 @@ private:
     // The list is delegated to each node manager as associated node managers.
     std::vector<HaNodeManager*> nodeManagers;
     HaXmlUaNodeFactoryManagerSet uaNodeFactoryManagerSet;
+    HaNodeManagerIODataProviderBridge::Configuration bridgeConf;
+
+    // Reads the optional configuration of the bridges to the IO data provider (see
+    // HaNodeManagerIODataProviderBridge::Configuration and LogThrottle::Configuration).
+    // Each line of the file contains a property (boolean values: true|false):
+    //   writeBehindWindow=<milliseconds>             max. delay of written values
+    //                                                (default: 0 = synchronous writing)
+    //   writeBehindMaxBatchSize=<count>              count of queued values which triggers
+    //                                                the writing (default: 500)
+    //   ingressSuppressEqualValues=<boolean>         suppress received values which equal
+    //                                                the last value (default: false)
+    //   ingressAbsoluteDeadband=<value>              absolute deadband for received numeric
+    //                                                values (default: 0 = disabled)
+    //   ingressPercentDeadband=<percent>             deadband in percent of the EURange
+    //                                                (default: 0 = disabled)
+    //   demandSubscriptions=<boolean>                subscribe variables only while they are
+    //                                                monitored (default: false)
+    //   demandSubscriptionDebounceTime=<milliseconds>
+    //                                                delay for collecting monitoring changes
+    //                                                (default: 1000)
+    //   pollGroups=<boolean>                         poll monitored synchronous variables in
+    //                                                groups (default: false)
+    //   pollMinInterval=<milliseconds>               min. poll interval (default: 100)
+    //   readCoalescing=<boolean>                     share concurrent reads of a node
+    //                                                (default: false)
+    //   readFreshnessWindow=<milliseconds>           answer back-to-back reads with the last
+    //                                                read value; requires readCoalescing
+    //                                                (default: 0 = disabled)
+    //   readFreshnessWindow@<namespaceUri>=<milliseconds>
+    //                                                readFreshnessWindow for a namespace
+    //                                                (default: readFreshnessWindow)
+    //   skipUnmonitoredEvents=<boolean>              skip received events while no event
+    //                                                monitored item exists (default: false)
+    //   dataGenerator=<boolean>                      generate values, method results and
+    //                                                events instead of using the IO data
+    //                                                provider (default: false)
+    //   generatorVariableCount=<count>               max. count of changed variables
+    //                                                (default: 0 = all subscribed variables)
+    //   generatorVariableChangeRate=<per second>     value changes per variable (default: 1)
+    //   generatorEventTypeCount=<count>              max. count of event types with events
+    //                                                (default: 0 = all subscribed types)
+    //   generatorEventRate=<per second>              events per event type (default: 1)
+    //   generatorMethodLatency=<milliseconds>        processing time of method calls
+    //                                                (default: 0)
+    //   logThrottleMaxBurst[@<logger>]=<count>       max. count of similar log messages
+    //                                                logged at once (default: 10)
+    //   logThrottleRate[@<logger>]=<per second>      similar log messages logged after a
+    //                                                burst (default: 1; 0 = no throttling)
+    //   logThrottleSummaryInterval[@<logger>]=<milliseconds>
+    //                                                interval for summaries of suppressed
+    //                                                messages (default: 60000)
+    // Without the suffix @<logger> the log throttle properties apply to all loggers. Log
+    // throttle properties which are not set for a logger have the default values (not the
+    // values for all loggers).
+    // Empty lines and lines starting with '#' are ignored.
+    void readBridgeConfiguration(const std::string& confFile) /* throws SASModelProviderException */;
 };
 
 UaNodeSetXMLSASModelProvider::UaNodeSetXMLSASModelProvider() {
@@ -43,6 +103,7 @@ UaNodeSetXMLSASModelProvider::~UaNodeSetXMLSASModelProvider() {
 void UaNodeSetXMLSASModelProvider::open(std::string& confDir,
         IODataProviderNamespace::IODataProvider& ioDataProvider) /* throws SASModelProviderException */ {
     d->ioDataProvider = &ioDataProvider;
+    d->readBridgeConfiguration(confDir + "bridge.conf"); // SASModelProviderException
     UaString modelsDir(confDir.c_str());
     modelsDir += "models/";
     std::vector<std::string> dirEntries;
@@ -99,10 +160,104 @@ std::vector<UaServerApplicationModule*>* UaNodeSetXMLSASModelProvider::createSer
         // at the end of its start up.
         HaNodeManagerNodeSetXmlCreator* nodeManagerCreator = new HaNodeManagerNodeSetXmlCreator(
                 d->nodeManagers, d->eventTypeRegistry, d->uaNodeFactoryManagerSet,
-                *d->ioDataProvider);
+                *d->ioDataProvider, d->bridgeConf);
         // create app module / XML parser        
         ret->push_back(new UaNodeSetXmlParserUaNode(modelFile.toUtf8(),
                 nodeManagerCreator, NULL /*baseNodeFactory*/, uaNodeFactoryManager));
     }
     return ret;
 }
+
+void UaNodeSetXMLSASModelProviderPrivate::readBridgeConfiguration(const std::string& confFile)
+/* throws SASModelProviderException */ {
+    std::ifstream in(confFile.c_str());
+    if (!in.is_open()) {
+        return;
+    }
+    log->info("Reading bridge configuration from %s", confFile.c_str());
+    const std::string readFreshnessWindowPrefix("readFreshnessWindow@");
+    // logger name => log throttle configuration ("": default for all loggers)
+    std::map<std::string, LogThrottle::Configuration> logThrottleConfs;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        size_t separator = line.find('=', start);
+        std::string key = line.substr(start,
+                separator == std::string::npos ? std::string::npos : separator - start);
+        key.erase(key.find_last_not_of(" \t") + 1);
+        std::istringstream value(separator == std::string::npos ? "" : line.substr(separator + 1));
+        bool isValid;
+        if (key == "writeBehindWindow") {
+            isValid = value >> bridgeConf.writeBehindWindow;
+        } else if (key == "writeBehindMaxBatchSize") {
+            isValid = value >> bridgeConf.writeBehindMaxBatchSize;
+        } else if (key == "ingressSuppressEqualValues") {
+            isValid = value >> std::boolalpha >> bridgeConf.ingressSuppressEqualValues;
+        } else if (key == "ingressAbsoluteDeadband") {
+            isValid = value >> bridgeConf.ingressAbsoluteDeadband;
+        } else if (key == "ingressPercentDeadband") {
+            isValid = value >> bridgeConf.ingressPercentDeadband;
+        } else if (key == "demandSubscriptions") {
+            isValid = value >> std::boolalpha >> bridgeConf.demandSubscriptions;
+        } else if (key == "demandSubscriptionDebounceTime") {
+            isValid = value >> bridgeConf.demandSubscriptionDebounceTime;
+        } else if (key == "pollGroups") {
+            isValid = value >> std::boolalpha >> bridgeConf.pollGroups;
+        } else if (key == "pollMinInterval") {
+            isValid = value >> bridgeConf.pollMinInterval;
+        } else if (key == "readCoalescing") {
+            isValid = value >> std::boolalpha >> bridgeConf.readCoalescing;
+        } else if (key == "readFreshnessWindow") {
+            isValid = value >> bridgeConf.readFreshnessWindow;
+        } else if (key == "skipUnmonitoredEvents") {
+            isValid = value >> std::boolalpha >> bridgeConf.skipUnmonitoredEvents;
+        } else if (key == "dataGenerator") {
+            isValid = value >> std::boolalpha >> bridgeConf.dataGenerator;
+        } else if (key == "generatorVariableCount") {
+            isValid = value >> bridgeConf.generatorVariableCount;
+        } else if (key == "generatorVariableChangeRate") {
+            isValid = value >> bridgeConf.generatorVariableChangeRate;
+        } else if (key == "generatorEventTypeCount") {
+            isValid = value >> bridgeConf.generatorEventTypeCount;
+        } else if (key == "generatorEventRate") {
+            isValid = value >> bridgeConf.generatorEventRate;
+        } else if (key == "generatorMethodLatency") {
+            isValid = value >> bridgeConf.generatorMethodLatency;
+        } else if (key.compare(0, 11, "logThrottle") == 0) {
+            // throttling of similar log messages for all loggers or a logger (suffix @name)
+            size_t at = key.find('@');
+            std::string property = key.substr(0, at);
+            LogThrottle::Configuration& logThrottleConf = logThrottleConfs[
+                    at == std::string::npos ? std::string() : key.substr(at + 1)];
+            if (property == "logThrottleMaxBurst") {
+                isValid = value >> logThrottleConf.maxBurst;
+            } else if (property == "logThrottleRate") {
+                isValid = value >> logThrottleConf.messagesPerSecond;
+            } else if (property == "logThrottleSummaryInterval") {
+                isValid = value >> logThrottleConf.summaryInterval;
+            } else {
+                isValid = false;
+            }
+        } else if (key.compare(0, readFreshnessWindowPrefix.size(), readFreshnessWindowPrefix) == 0) {
+            // freshness window for a namespace
+            isValid = value >> bridgeConf.namespaceReadFreshnessWindows[
+                    key.substr(readFreshnessWindowPrefix.size())];
+        } else {
+            isValid = false;
+        }
+        if (!isValid) {
+            std::ostringstream msg;
+            msg << "Invalid property in " << confFile.c_str() << ":" << lineNumber << ": " << line;
+            throw ExceptionDef(SASModelProviderException, msg.str());
+        }
+    }
+    for (std::map<std::string, LogThrottle::Configuration>::const_iterator i =
+            logThrottleConfs.begin(); i != logThrottleConfs.end(); i++) {
+        LoggerFactory::setLogThrottle((*i).first.c_str(), (*i).second);
+    }
+}
@@ -1,8 +1,14 @@
 #include <sasModelProvider/base/CodeNodeManagerBase.h>
+#include <common/Exception.h> // ExceptionDef
+#include <common/ScopeGuard.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <sasModelProvider/base/HaNodeManagerException.h>
+#include <sasModelProvider/base/NodeBrowser.h>
+#include <uadatetime.h> // UaDateTime
+#include <uamutex.h> // UaMutexLocker
 #include <sstream> // std::ostringstream
+#include <vector>
 
 using namespace CommonNamespace;
 
@@ -15,6 +21,17 @@ namespace SASModelProviderNamespace {
 
         EventTypeRegistry eventTypeRegistry;
         HaNodeManagerIODataProviderBridge* nmioBridge;
+
+        // Sets a value with the given source and server time stamp.
+        void setVariable(UaVariable& variable, UaVariant& newValue, const UaDateTime& timeStamp)
+        /* throws HaNodeManagerException */;
+        // Creates the data value for a new value with the given source and server time stamp.
+        void initDataValue(UaDataValue& dataValue, UaVariant& newValue,
+                const UaDateTime& timeStamp);
+        void logValue(UaVariable& variable, const UaVariant& oldValue, UaVariant& newValue);
+        // The returned instance must be destroyed by the caller.
+        HaNodeManagerException* createException(UaVariable& variable, const UaStatus& status,
+                const UaVariant& oldValue, UaVariant& newValue);
     };
 
     CodeNodeManagerBase::CodeNodeManagerBase(const UaString& sNamespaceUri,
@@ -32,6 +49,16 @@ namespace SASModelProviderNamespace {
         delete d;
     }
 
+    UaStatus CodeNodeManagerBase::deleteUaNode(UaNode* pNode,
+            OpcUa_Boolean bDeleteTargetReferences, OpcUa_Boolean bDeleteSourceReferences,
+            OpcUa_Boolean bAddModelChangeEvents) {
+        if (pNode != NULL) {
+            NodeBrowser::nodeDeleted(pNode->nodeId());
+        }
+        return NodeManagerBase::deleteUaNode(pNode, bDeleteTargetReferences,
+                bDeleteSourceReferences, bAddModelChangeEvents);
+    }
+
     UaStatus CodeNodeManagerBase::afterStartUp() {
         return d->nmioBridge->afterStartUp();
     }
@@ -100,26 +127,97 @@ namespace SASModelProviderNamespace {
 
     void CodeNodeManagerBase::setVariable(UaVariable& variable,
             UaVariant& newValue) /* throws HaNodeManagerException */ {
+        d->setVariable(variable, newValue, UaDateTime::now()); // HaNodeManagerException
+    }
+
+    void CodeNodeManagerBase::setVariables(const std::vector<UaVariable*>& variables,
+            const std::vector<UaVariant*>& newValues) /* throws HaNodeManagerException */ {
+        size_t count = variables.size();
+        // prepare the data values before the nodes are locked
+        UaDateTime now = UaDateTime::now();
+        std::vector<UaDataValue> dataValues(count);
+        for (size_t i = 0; i < count; i++) {
+            d->initDataValue(dataValues[i], *newValues[i], now);
+        }
+        bool isInfoEnabled = d->log->isInfoEnabled();
+        // the previous values are only copied for logging and failed variables
+        std::vector<UaVariant> oldValues(count);
+        std::vector<UaStatus> statuses(count);
+        {
+            // lock the nodes once for all values; the SDK evaluates the value change of each
+            // variable in "setValue" (it provides no means to defer the change handling of
+            // several variables)
+            UaMutexLocker lock(&m_mutexNodes);
+            for (size_t i = 0; i < count; i++) {
+                if (isInfoEnabled) {
+                    oldValues[i] = *variables[i]->value(NULL /* session */).value();
+                }
+                statuses[i] = variables[i]->setValue(NULL /* session */, dataValues[i],
+                        OpcUa_False /* checkAccessLevel */);
+                if (!statuses[i].isGood() && !isInfoEnabled) {
+                    oldValues[i] = *variables[i]->value(NULL /* session */).value();
+                }
+            }
+        }
+        // log the values and report the first failed variable after the nodes are unlocked
+        HaNodeManagerException* exception = NULL;
+        for (size_t i = 0; i < count; i++) {
+            if (isInfoEnabled) {
+                d->logValue(*variables[i], oldValues[i], *newValues[i]);
+            }
+            if (!statuses[i].isGood() && exception == NULL) {
+                exception = d->createException(*variables[i], statuses[i], oldValues[i],
+                        *newValues[i]);
+            }
+        }
+        if (exception != NULL) {
+            ScopeGuard<HaNodeManagerException> exceptionSG(exception);
+            throw *exception;
+        }
+    }
+
+    void CodeNodeManagerBasePrivate::setVariable(UaVariable& variable, UaVariant& newValue,
+            const UaDateTime& timeStamp) /* throws HaNodeManagerException */ {
         const OpcUa_Variant* cacheValue = variable.value(
                 NULL /* session */).value();
-        if (d->log->isInfoEnabled()) {
-            d->log->info("SET %-20s %s -> %s", variable.nodeId().toXmlString().toUtf8(),
-                    UaVariant(*cacheValue).toString().toUtf8(), newValue.toString().toUtf8());
+        if (log->isInfoEnabled()) {
+            logValue(variable, UaVariant(*cacheValue), newValue);
         }
         // set new value
         UaDataValue dataValue;
-        dataValue.setValue(newValue,
-                OpcUa_False /* detachValue */,
-                OpcUa_True /* updateTimeStamps */);
+        initDataValue(dataValue, newValue, timeStamp);
         UaStatus status = variable.setValue(NULL /* session */, dataValue,
                 OpcUa_False /* checkAccessLevel */);
         if (!status.isGood()) {
-            std::ostringstream msg;
-            msg << "Cannot set value to variable: " << status.toString().toUtf8()
-                    << " " << variable.nodeId().toXmlString().toUtf8() << " "
-                    << UaVariant(*cacheValue).toString().toUtf8() << " -> "
-                    << newValue.toString();
-            throw ExceptionDef(HaNodeManagerException, msg.str());
+            HaNodeManagerException* exception = createException(variable, status,
+                    UaVariant(*cacheValue), newValue);
+            ScopeGuard<HaNodeManagerException> exceptionSG(exception);
+            throw *exception;
         }
     }
+
+    void CodeNodeManagerBasePrivate::initDataValue(UaDataValue& dataValue, UaVariant& newValue,
+            const UaDateTime& timeStamp) {
+        dataValue.setValue(newValue,
+                OpcUa_False /* detachValue */,
+                OpcUa_False /* updateTimeStamps */);
+        dataValue.setSourceTimestamp(timeStamp);
+        dataValue.setServerTimestamp(timeStamp);
+    }
+
+    void CodeNodeManagerBasePrivate::logValue(UaVariable& variable, const UaVariant& oldValue,
+            UaVariant& newValue) {
+        log->info("SET %-20s %s -> %s", variable.nodeId().toXmlString().toUtf8(),
+                oldValue.toString().toUtf8(), newValue.toString().toUtf8());
+    }
+
+    HaNodeManagerException* CodeNodeManagerBasePrivate::createException(UaVariable& variable,
+            const UaStatus& status, const UaVariant& oldValue, UaVariant& newValue) {
+        std::ostringstream msg;
+        msg << "Cannot set value to variable: " << status.toString().toUtf8()
+                << " " << variable.nodeId().toXmlString().toUtf8() << " "
+                << oldValue.toString().toUtf8() << " -> "
+                << newValue.toString();
+        return new ExceptionDef(HaNodeManagerException, msg.str());
+    }
 } // namespace SASModelProviderNamespace
@@ -1,19 +1,26 @@
 #include <sasModelProvider/base/ConverterUa2IO.h>
 #include <common/Exception.h> // ExceptionDef
 #include <common/ScopeGuard.h>
-#include <common/MapScopeGuard.h>
+#include <common/Mutex.h>
+#include <common/MutexLock.h>
 #include <common/VectorScopeGuard.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <ioDataProvider/Array.h>
 #include <ioDataProvider/Scalar.h>
+#include <ioDataProvider/ScalarTraits.h>
 #include <ioDataProvider/Structure.h>
 #include <sasModelProvider/base/ConversionException.h>
+#include <uaarraytemplates.h> // UaInt32Array
+#include <uabytearray.h> // UaByteArray
 #include <uabytestring.h> // UaByteString
 #include <uadatetime.h> // UaDateTime
 #include <uagenericunionvalue.h> // UaGenericUnionValue
+#include <limits> // std::numeric_limits
+#include <map>
 #include <sstream> // std::ostringstream
 #include <stddef.h> // NULL
+#include <string.h> // memcpy
 #include <uadatavalue.h>
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
@@ -24,6 +31,398 @@ using namespace IODataProviderNamespace;
 
 namespace SASModelProviderNamespace {
 
+class ConverterUa2IOPrivate;
+
+// Compile-time description of a numeric or boolean OPC UA built-in type. The converters of
+// the conversion table (see ConverterUa2IOPrivate::conversions) are generated from the traits
+// for each pair of types:
+//   Type:      the value type
+//   ArrayType: the array type of the OPC UA SDK
+//   getName(): the name of the type for messages
+//   get/set:   access to a scalar value of an UaVariant
+//   getArray/setArray: access to an array value of an UaVariant (the array is detached)
+template<int BuildInType> class BuildInTypeTraits;
+
+template<> class BuildInTypeTraits<OpcUaType_Boolean> {
+public:
+	typedef OpcUa_Boolean Type;
+	typedef UaBooleanArray ArrayType;
+
+	static const char* getName() {
+		return "boolean";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toBool(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setBool(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toBoolArray(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setBoolArray(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_SByte> {
+public:
+	typedef OpcUa_SByte Type;
+	typedef UaSByteArray ArrayType;
+
+	static const char* getName() {
+		return "sbyte";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toSByte(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setSByte(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toSByteArray(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setSByteArray(array, OpcUa_True /*detach*/);
+	}
+};
+
+// The array type of the OPC UA SDK is a byte string (see UaByteArray).
+template<> class BuildInTypeTraits<OpcUaType_Byte> {
+public:
+	typedef OpcUa_Byte Type;
+	typedef UaByteArray ArrayType;
+
+	static const char* getName() {
+		return "byte";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toByte(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setByte(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toByteArray(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setByteArray(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_Int16> {
+public:
+	typedef OpcUa_Int16 Type;
+	typedef UaInt16Array ArrayType;
+
+	static const char* getName() {
+		return "int16";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toInt16(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setInt16(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toInt16Array(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setInt16Array(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_UInt16> {
+public:
+	typedef OpcUa_UInt16 Type;
+	typedef UaUInt16Array ArrayType;
+
+	static const char* getName() {
+		return "uint16";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toUInt16(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setUInt16(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toUInt16Array(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setUInt16Array(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_Int32> {
+public:
+	typedef OpcUa_Int32 Type;
+	typedef UaInt32Array ArrayType;
+
+	static const char* getName() {
+		return "int32";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toInt32(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setInt32(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toInt32Array(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setInt32Array(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_UInt32> {
+public:
+	typedef OpcUa_UInt32 Type;
+	typedef UaUInt32Array ArrayType;
+
+	static const char* getName() {
+		return "uint32";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toUInt32(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setUInt32(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toUInt32Array(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setUInt32Array(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_Int64> {
+public:
+	typedef OpcUa_Int64 Type;
+	typedef UaInt64Array ArrayType;
+
+	static const char* getName() {
+		return "int64";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toInt64(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setInt64(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toInt64Array(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setInt64Array(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_UInt64> {
+public:
+	typedef OpcUa_UInt64 Type;
+	typedef UaUInt64Array ArrayType;
+
+	static const char* getName() {
+		return "uint64";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toUInt64(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setUInt64(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toUInt64Array(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setUInt64Array(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_Float> {
+public:
+	typedef OpcUa_Float Type;
+	typedef UaFloatArray ArrayType;
+
+	static const char* getName() {
+		return "float";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toFloat(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setFloat(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toFloatArray(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setFloatArray(array, OpcUa_True /*detach*/);
+	}
+};
+
+template<> class BuildInTypeTraits<OpcUaType_Double> {
+public:
+	typedef OpcUa_Double Type;
+	typedef UaDoubleArray ArrayType;
+
+	static const char* getName() {
+		return "double";
+	}
+
+	static OpcUa_StatusCode get(const UaVariant& variant, Type& value) {
+		return variant.toDouble(value);
+	}
+
+	static void set(UaVariant& variant, Type value) {
+		variant.setDouble(value);
+	}
+
+	static OpcUa_StatusCode getArray(const UaVariant& variant, ArrayType& array) {
+		return variant.toDoubleArray(array);
+	}
+
+	static void setArray(UaVariant& variant, ArrayType& array) {
+		variant.setDoubleArray(array, OpcUa_True /*detach*/);
+	}
+};
+
+
+// Converts a scalar UaVariant with a resolved value type to a Variant (see
+// ConverterUa2IOPrivate::getUaScalar2ioConverter). If the value cannot be read NULL is returned.
+// The returned Variant instance must be destroyed by the caller.
+typedef Variant* (*UaScalar2ioConverter)(ConverterUa2IOPrivate& d, const UaVariant& value,
+		OpcUa_Int16 indent);
+// Converts a Scalar with a resolved scalar type to the UaVariant "dest" (see
+// ConverterUa2IOPrivate::getIoScalar2uaConverter). A previous value of "dest" is replaced.
+typedef void (*IoScalar2uaConverter)(const Scalar& value, UaVariant& dest);
+// Converts the contiguous values or the Scalar elements of an Array to an UaVariant with an
+// array of a built-in type (see ConverterUa2IOPrivate::convertIoArray2ua).
+// The returned UaVariant instance must be destroyed by the caller.
+typedef UaVariant* (*IoArray2uaConverter)(const Array& value);
+// Reads the array of a built-in type from an UaVariant and creates an Array with contiguous
+// values (see ConverterUa2IOPrivate::convertUaTypedArray2io). The status of the reading is
+// returned in "status".
+// The returned Array instance must be destroyed by the caller.
+typedef Array* (*UaValues2ioConverter)(const UaVariant& value, OpcUa_StatusCode& status);
+
+// A conversion between a scalar type of the internal interface and the value type of a
+// built-in type (see ConverterUa2IOPrivate::conversions). The converters which are not
+// supported for the pair of types are NULL.
+class ScalarConversion {
+public:
+	int ioScalarType;
+	// the value type of the built-in type (see ConverterUa2IOPrivate::getUaValueType)
+	OpcUa_BuiltInType uaValueType;
+	// the name of the scalar type for messages
+	const char* ioTypeName;
+	IoScalar2uaConverter io2uaScalar;
+	// for an Array with contiguous values
+	IoArray2uaConverter io2uaValues;
+	// for an Array with Scalar elements
+	IoArray2uaConverter io2uaElements;
+	// Only the conversion to the scalar type which represents the values of the value type
+	// provides the converters of UaVariant values.
+	UaScalar2ioConverter ua2ioScalar;
+	UaValues2ioConverter ua2ioValues;
+};
+
+// A codec for a structure or union data type. It is compiled once from the structure
+// definition and provides the fields in the order of the definition with their resolved
+// built-in types and the codecs for nested structures.
+class StructureCodec {
+public:
+	class Field {
+	public:
+		UaStructureField field;
+		std::string name;
+		// the position of the field in the definition; the values of UaGenericStructureValue
+		// are accessed by position (for a union: switch value - 1)
+		int index;
+		// only optional fields are checked via UaGenericStructureValue::isFieldSet
+		bool isOptional;
+		// the built-in type of the field (null if it cannot be resolved)
+		UaNodeId buildInDataTypeId;
+		// the codec for a field of a structure or union type (else NULL)
+		StructureCodec* codec;
+		// the expected type of an UaVariant value and its converter for a field of a scalar
+		// built-in type (else OpcUaType_Null and NULL)
+		OpcUa_BuiltInType uaValueType;
+		UaScalar2ioConverter ua2ioConverter;
+		// the expected type of a Scalar value and its converter for a field of a scalar
+		// built-in type (else -1 and NULL)
+		int ioScalarType;
+		IoScalar2uaConverter io2uaConverter;
+	};
+
+	StructureCodec() {
+		dataTypeId = NULL;
+	}
+
+	~StructureCodec() {
+		delete dataTypeId;
+	}
+
+	// the data type the codec has been compiled for
+	UaNodeId typeId;
+	UaStructureDefinition definition;
+	NodeId* dataTypeId;
+	bool isUnion;
+	// the fields in the order of the definition
+	std::vector<Field> fields;
+	// field name => position of the field in the definition
+	std::map<std::string, int> fieldIndices;
+
+	// Returns the index of a field or -1 if the field does not exist.
+	int getFieldIndex(const std::string& name) const {
+		std::map<std::string, int>::const_iterator i = fieldIndices.find(name);
+		return i == fieldIndices.end() ? -1 : (*i).second;
+	}
+};
+
 class ConverterUa2IOPrivate {
 	friend class ConverterUa2IO;
 private:
@@ -33,25 +432,88 @@ private:
 	ConverterUa2IO::ConverterCallback* callback;
 	bool hasAttachedValues;
 
+	// protects the codecs
+	Mutex* codecsMutex;
+	// data type -> codec
+	std::map<UaNodeId, StructureCodec*> codecs;
+
+	// The conversions between the scalar types of the internal interface and the built-in
+	// types. All converters of scalars and arrays are resolved from this table.
+	static const ScalarConversion conversions[];
+	static const size_t conversionCount;
+
+	// Gets the conversion between a scalar type and the value type of a built-in type. If the
+	// types cannot be converted NULL is returned.
+	static const ScalarConversion* getConversion(int ioScalarType,
+			OpcUa_BuiltInType uaValueType);
+	// Gets the conversion of the UaVariant values of a value type to the internal interface.
+	// If the value type is not supported NULL is returned.
+	static const ScalarConversion* getUaConversion(OpcUa_BuiltInType uaValueType);
+
 	UaNodeId getBuildInType(
 			const UaNodeId& typeId) /* throws ConversionException */;
 
+	// Gets the codec for a structure or union data type. The codec is compiled with the first
+	// call.
+	StructureCodec& getStructureCodec(
+			const UaNodeId& dataTypeId) /* throws ConversionException */;
+	// Gets or compiles a codec. The codecs mutex must be locked by the caller. The compiled
+	// codecs are added to "compiled".
+	StructureCodec& getStructureCodec(const UaNodeId& dataTypeId,
+			std::vector<StructureCodec*>& compiled) /* throws ConversionException */;
+
 	// Converts an UaVariant to a Variant.
 	// The returned Variant instance must be destroyed by the caller.
 	Variant* convertUa2io(const UaVariant& value, const UaNodeId& srcDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
 	// Converts a value of a simple OPC UA type to a Variant
+	// If the data type is not a built-in type or the value cannot be read NULL is returned.
 	// The returned Variant instance must be destroyed by the caller.
 	Variant* convertUaBuildInType2io(const UaVariant& value,
-			const UaNodeId& srcDataTypeId, OpcUa_Int16 indent);
+			const UaNodeId& srcDataTypeId,
+			OpcUa_Int16 indent) /* throws ConversionException */;
+	// Gets the converter for a value of a simple OPC UA type or throws an exception if the
+	// value type is not supported for the built-in type.
+	static UaScalar2ioConverter resolveUaScalar2ioConverter(OpcUa_BuiltInType valueType,
+			const UaNodeId& srcDataTypeId) /* throws ConversionException */;
+	// Gets the converter for a value of a simple OPC UA type. If the value type is not
+	// supported for the built-in type NULL is returned. The name of the destination scalar
+	// type is returned in "ioTypeName" (NULL if the built-in type is not supported).
+	static UaScalar2ioConverter getUaScalar2ioConverter(OpcUa_UInt32 buildInType,
+			OpcUa_BuiltInType valueType, const char*& ioTypeName);
+	// Gets the type of the UaVariant values for a built-in type (OpcUaType_Null if the
+	// built-in type is not a scalar type with a fixed value type).
+	static OpcUa_BuiltInType getUaValueType(OpcUa_UInt32 buildInType);
+	// the converters for the value types
+	template<int ValueType, int ScalarType> static Variant* convertUaNumeric2io(
+			ConverterUa2IOPrivate& d, const UaVariant& value, OpcUa_Int16 indent);
+	static Variant* convertUaString2io(ConverterUa2IOPrivate& d, const UaVariant& value,
+			OpcUa_Int16 indent);
+	static Variant* convertUaDateTime2io(ConverterUa2IOPrivate& d, const UaVariant& value,
+			OpcUa_Int16 indent);
+	static Variant* convertUaByteString2io(ConverterUa2IOPrivate& d,
+			const UaVariant& value, OpcUa_Int16 indent);
+	static Variant* convertUaNodeId2io(ConverterUa2IOPrivate& d, const UaVariant& value,
+			OpcUa_Int16 indent) /* throws ConversionException */;
+	static Variant* convertUaLocalizedText2io(ConverterUa2IOPrivate& d,
+			const UaVariant& value, OpcUa_Int16 indent);
+	static Variant* convertUaNull2io(ConverterUa2IOPrivate& d, const UaVariant& value,
+			OpcUa_Int16 indent);
+	static Variant* convertUaDataValue2io(ConverterUa2IOPrivate& d, const UaVariant& value,
+			OpcUa_Int16 indent) /* throws ConversionException */;
 	// Converts an UaExtensionObject to a Variant.
 	// The returned Variant instance must be destroyed by the caller.
 	Variant* convertUaExtensionObject2io(const UaExtensionObject& value,
 			const UaNodeId& srcDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an UaVariant value of a UaStructureField to a Variant.
+	// Converts an UaExtensionObject to a Variant using the codec of the data type.
+	// The returned Variant instance must be destroyed by the caller.
+	Variant* convertUaExtensionObject2io(const UaExtensionObject& value,
+			const StructureCodec& codec,
+			OpcUa_Int16 indent) /* throws ConversionException */;
+	// Converts an UaVariant value of a structure field to a Variant.
 	// The returned Variant instance must be destroyed by the caller.
-	Variant* convertUaStructureField2io(const UaStructureField& field,
+	Variant* convertUaStructureField2io(const StructureCodec::Field& field,
 			const UaVariant& value,
 			OpcUa_Int16 indent) /* throws ConversionException */;
 	// Converts an array of type UaVariant to a Variant.
@@ -59,6 +521,17 @@ private:
 	Array* convertUaArray2io(const UaVariant& value,
 			const UaNodeId& srcDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
+	// Converts an array of a numeric, boolean or byte type to an Array with contiguous values
+	// (the values are copied in bulk).
+	// The returned Array instance must be destroyed by the caller.
+	Array* convertUaTypedArray2io(const UaVariant& value, const UaNodeId& srcDataTypeId,
+			const ScalarConversion& conversion) /* throws ConversionException */;
+	// the converters for the arrays of the value types
+	template<int BuildInType, int ScalarType> static Array* convertUaValues2io(
+			const UaVariant& value, OpcUa_StatusCode& status);
+	static Array* convertUaByteArray2io(const UaVariant& value, OpcUa_StatusCode& status);
+	// Creates an Array with contiguous values from an array of the OPC UA SDK.
+	template<class T> static Array* createIoArray(int arrayType, const T& uaArray);
 	int getIoArrayType(
 			const UaNodeId dataTypeId) /* throws ConversionException */;
 
@@ -67,19 +540,51 @@ private:
 	UaVariant* convertIo2ua(const Variant& value,
 			const UaNodeId& destDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
+	// Converts a Variant to the UaVariant "dest". A scalar is converted directly to "dest",
+	// other values are moved to "dest" after the conversion.
+	void convertIo2ua(const Variant& value, const UaNodeId& destDataTypeId,
+			UaVariant& dest, OpcUa_Int16 indent) /* throws ConversionException */;
 	// Converts a Scalar to an UaVariant.
 	// The returned UaVariant instance must be destroyed by the caller.
 	UaVariant* convertIoScalar2ua(const IODataProviderNamespace::Scalar& value,
 			const UaNodeId& destDataTypeId,
 			OpcUa_Int16 indent) const /* throws ConversionException */;
+	// Converts a Scalar to the UaVariant "dest".
+	void convertIoScalar2ua(const IODataProviderNamespace::Scalar& value,
+			const UaNodeId& destDataTypeId,
+			UaVariant& dest) const /* throws ConversionException */;
+	// Gets the converter for a scalar type and a built-in type. If the scalar type cannot be
+	// converted to the built-in type NULL is returned.
+	static IoScalar2uaConverter getIoScalar2uaConverter(int scalarType,
+			OpcUa_UInt32 buildInType);
+	// Gets the scalar type of the values for a built-in type (-1 if the built-in type is not
+	// a scalar type).
+	static int getIoScalarType(OpcUa_UInt32 buildInType);
+	// the converters for the scalar types
+	template<int ScalarType, int BuildInType> static void convertIoNumeric2ua(
+			const Scalar& value, UaVariant& dest);
+	// Converts a numeric value to a narrower unsigned type. The range of the value is
+	// checked.
+	template<int ScalarType, int BuildInType> static void convertIoNumeric2uaChecked(
+			const Scalar& value, UaVariant& dest) /* throws ConversionException */;
+	static void convertIoString2ua(const Scalar& value, UaVariant& dest);
+	static void convertIoString2uaLocalizedText(const Scalar& value, UaVariant& dest);
+	static void convertIoLLong2uaDateTime(const Scalar& value, UaVariant& dest);
+	static void convertIoByteString2ua(const Scalar& value, UaVariant& dest);
+	static void convertIoLocalizedText2ua(const Scalar& value, UaVariant& dest);
 	// Converts a Structure to an UaVariant.
 	// The returned UaVariant instance must be destroyed by the caller.
 	UaVariant* convertIoStructure2ua(const Structure& value,
 			const UaNodeId& destDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an Variant value of a UaStructureField to a UaVariant.
+	// Converts a Structure to an UaVariant using the codec of the data type.
+	// The returned UaVariant instance must be destroyed by the caller.
+	UaVariant* convertIoStructure2ua(const Structure& value,
+			const StructureCodec& codec,
+			OpcUa_Int16 indent) /* throws ConversionException */;
+	// Converts an Variant value of a structure field to a UaVariant.
 	// The returned Variant instance must be destroyed by the caller.
-	UaVariant* convertIoStructureField2ua(const UaStructureField& field,
+	UaVariant* convertIoStructureField2ua(const StructureCodec::Field& field,
 			const Variant& value,
 			OpcUa_Int16 indent) /* throws ConversionException */;
 	// Converts an Array to an UaVariant.
@@ -87,42 +592,207 @@ private:
 	UaVariant* convertIoArray2ua(const Array& value,
 			const UaNodeId& destDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
+	// the converters for the arrays with contiguous values: equal types are copied in bulk,
+	// other types are widened or narrowed
+	template<int BuildInType> static UaVariant* copyIoValues(const Array& value);
+	static UaVariant* copyIoChars2uaByteArray(const Array& value);
+	template<int ScalarType, int BuildInType> static UaVariant* convertIoValues(
+			const Array& value);
 	// Converts an Array with elements of type Structure to an UaVariant.
 	// The returned UaVariant instance must be destroyed by the caller.
 	UaVariant* convertIoArray2uaStructureArray(const Array& value,
 			const UaNodeId& destDataTypeId,
 			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an Array with elements of type Long to an UaVariant of type UInt16.
-	// The returned UaVariant instance must be destroyed by the caller.
-	UaVariant* convertIoArray2uaUInt16Array(const Array& value,
-			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an Array with elements of type Long to an UaVariant of type Int32.
-	// The returned UaVariant instance must be destroyed by the caller.
-	UaVariant* convertIoArray2uaInt32Array(const Array& value,
-			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an Array with elements of type ULong/LLong to an UaVariant of type UInt32.
-	// The returned UaVariant instance must be destroyed by the caller.
-	UaVariant* convertIoArray2uaUInt32Array(const Array& value,
-			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an Array with elements of type String to an UaVariant of type String.
-	// The returned UaVariant instance must be destroyed by the caller.
-	UaVariant* convertIoArray2uaStringArray(const Array& value,
-			OpcUa_Int16 indent) /* throws ConversionException */;
-	// Converts an Array with elements of type LocalizedText to an UaVariant of type LocalizedText.
-	// The returned UaVariant instance must be destroyed by the caller.
-	UaVariant* convertIoArray2uaLocalizedTextArray(const Array& value,
-			OpcUa_Int16 indent) /* throws ConversionException */;
+	// the converters for the arrays with Scalar elements
+	template<int ScalarType, int BuildInType> static UaVariant* convertIoElements2ua(
+			const Array& value);
+	static UaVariant* convertIoArray2uaStringArray(const Array& value);
+	// The elements can be of type String or LocalizedText.
+	static UaVariant* convertIoArray2uaLocalizedTextArray(const Array& value);
 };
 
-ConverterUa2IO::ConverterUa2IO(ConverterCallback& callback, bool attachValues) {
+// InternalInterface - OPC UA
+// Only one conversion per value type provides the converters of UaVariant values.
+const ScalarConversion ConverterUa2IOPrivate::conversions[] = {
+	// bool(8) - boolean(8)
+	{ Scalar::BOOL, OpcUaType_Boolean, "bool",
+		&convertIoNumeric2ua<Scalar::BOOL, OpcUaType_Boolean>,
+		&copyIoValues<OpcUaType_Boolean>,
+		&convertIoElements2ua<Scalar::BOOL, OpcUaType_Boolean>,
+		&convertUaNumeric2io<OpcUaType_Boolean, Scalar::BOOL>,
+		&convertUaValues2io<OpcUaType_Boolean, Scalar::BOOL> },
+	// schar(8) - sbyte(8)
+	{ Scalar::SCHAR, OpcUaType_SByte, "schar",
+		&convertIoNumeric2ua<Scalar::SCHAR, OpcUaType_SByte>,
+		&copyIoValues<OpcUaType_SByte>,
+		&convertIoElements2ua<Scalar::SCHAR, OpcUaType_SByte>,
+		&convertUaNumeric2io<OpcUaType_SByte, Scalar::SCHAR>,
+		&convertUaValues2io<OpcUaType_SByte, Scalar::SCHAR> },
+	// char(8) - byte(8) (the array of the OPC UA SDK is a byte string)
+	{ Scalar::CHAR, OpcUaType_Byte, "char",
+		&convertIoNumeric2ua<Scalar::CHAR, OpcUaType_Byte>,
+		&copyIoChars2uaByteArray,
+		NULL,
+		&convertUaNumeric2io<OpcUaType_Byte, Scalar::CHAR>,
+		&convertUaByteArray2io },
+	// int(16) - int16/int32[]
+	{ Scalar::INT, OpcUaType_Int16, "int",
+		&convertIoNumeric2ua<Scalar::INT, OpcUaType_Int16>,
+		&copyIoValues<OpcUaType_Int16>,
+		&convertIoElements2ua<Scalar::INT, OpcUaType_Int16>,
+		&convertUaNumeric2io<OpcUaType_Int16, Scalar::INT>,
+		&convertUaValues2io<OpcUaType_Int16, Scalar::INT> },
+	{ Scalar::INT, OpcUaType_Int32, "int",
+		NULL, &convertIoValues<Scalar::INT, OpcUaType_Int32>, NULL, NULL, NULL },
+	// uint(16) - uint16/uint32[]
+	{ Scalar::UINT, OpcUaType_UInt16, "uint",
+		&convertIoNumeric2ua<Scalar::UINT, OpcUaType_UInt16>,
+		&copyIoValues<OpcUaType_UInt16>,
+		&convertIoElements2ua<Scalar::UINT, OpcUaType_UInt16>,
+		&convertUaNumeric2io<OpcUaType_UInt16, Scalar::UINT>,
+		&convertUaValues2io<OpcUaType_UInt16, Scalar::UINT> },
+	{ Scalar::UINT, OpcUaType_UInt32, "uint",
+		NULL, &convertIoValues<Scalar::UINT, OpcUaType_UInt32>, NULL, NULL, NULL },
+	// long(32) - int32/enum/uint16 (checked)/uint32/int64[]
+	{ Scalar::LONG, OpcUaType_Int32, "long",
+		&convertIoNumeric2ua<Scalar::LONG, OpcUaType_Int32>,
+		&copyIoValues<OpcUaType_Int32>,
+		&convertIoElements2ua<Scalar::LONG, OpcUaType_Int32>,
+		&convertUaNumeric2io<OpcUaType_Int32, Scalar::LONG>,
+		&convertUaValues2io<OpcUaType_Int32, Scalar::LONG> },
+	{ Scalar::LONG, OpcUaType_UInt16, "long",
+		&convertIoNumeric2uaChecked<Scalar::LONG, OpcUaType_UInt16>,
+		&convertIoValues<Scalar::LONG, OpcUaType_UInt16>,
+		&convertIoElements2ua<Scalar::LONG, OpcUaType_UInt16>,
+		NULL, NULL },
+	{ Scalar::LONG, OpcUaType_UInt32, "long",
+		&convertIoNumeric2ua<Scalar::LONG, OpcUaType_UInt32>, NULL, NULL, NULL, NULL },
+	{ Scalar::LONG, OpcUaType_Int64, "long",
+		NULL, &convertIoValues<Scalar::LONG, OpcUaType_Int64>, NULL, NULL, NULL },
+	// ulong(32) - uint32/uint64[]
+	{ Scalar::ULONG, OpcUaType_UInt32, "ulong",
+		&convertIoNumeric2ua<Scalar::ULONG, OpcUaType_UInt32>,
+		&copyIoValues<OpcUaType_UInt32>,
+		&convertIoElements2ua<Scalar::ULONG, OpcUaType_UInt32>,
+		&convertUaNumeric2io<OpcUaType_UInt32, Scalar::ULONG>,
+		&convertUaValues2io<OpcUaType_UInt32, Scalar::ULONG> },
+	{ Scalar::ULONG, OpcUaType_UInt64, "ulong",
+		NULL, &convertIoValues<Scalar::ULONG, OpcUaType_UInt64>, NULL, NULL, NULL },
+	// llong(64) - int64/uint32 (checked)/dateTime/utcTime
+	{ Scalar::LLONG, OpcUaType_Int64, "llong",
+		&convertIoNumeric2ua<Scalar::LLONG, OpcUaType_Int64>,
+		&copyIoValues<OpcUaType_Int64>,
+		&convertIoElements2ua<Scalar::LLONG, OpcUaType_Int64>,
+		&convertUaNumeric2io<OpcUaType_Int64, Scalar::LLONG>,
+		&convertUaValues2io<OpcUaType_Int64, Scalar::LLONG> },
+	{ Scalar::LLONG, OpcUaType_UInt32, "llong",
+		&convertIoNumeric2uaChecked<Scalar::LLONG, OpcUaType_UInt32>,
+		&convertIoValues<Scalar::LLONG, OpcUaType_UInt32>,
+		&convertIoElements2ua<Scalar::LLONG, OpcUaType_UInt32>,
+		NULL, NULL },
+	{ Scalar::LLONG, OpcUaType_DateTime, "llong",
+		&convertIoLLong2uaDateTime, NULL, NULL, &convertUaDateTime2io, NULL },
+	// ullong(64) - uint64
+	{ Scalar::ULLONG, OpcUaType_UInt64, "ullong",
+		&convertIoNumeric2ua<Scalar::ULLONG, OpcUaType_UInt64>,
+		&copyIoValues<OpcUaType_UInt64>,
+		&convertIoElements2ua<Scalar::ULLONG, OpcUaType_UInt64>,
+		&convertUaNumeric2io<OpcUaType_UInt64, Scalar::ULLONG>,
+		&convertUaValues2io<OpcUaType_UInt64, Scalar::ULLONG> },
+	// float - float/double[]
+	{ Scalar::FLOAT, OpcUaType_Float, "float",
+		&convertIoNumeric2ua<Scalar::FLOAT, OpcUaType_Float>,
+		&copyIoValues<OpcUaType_Float>,
+		&convertIoElements2ua<Scalar::FLOAT, OpcUaType_Float>,
+		&convertUaNumeric2io<OpcUaType_Float, Scalar::FLOAT>,
+		&convertUaValues2io<OpcUaType_Float, Scalar::FLOAT> },
+	{ Scalar::FLOAT, OpcUaType_Double, "float",
+		NULL, &convertIoValues<Scalar::FLOAT, OpcUaType_Double>, NULL, NULL, NULL },
+	// double - double/duration
+	{ Scalar::DOUBLE, OpcUaType_Double, "double",
+		&convertIoNumeric2ua<Scalar::DOUBLE, OpcUaType_Double>,
+		&copyIoValues<OpcUaType_Double>,
+		&convertIoElements2ua<Scalar::DOUBLE, OpcUaType_Double>,
+		&convertUaNumeric2io<OpcUaType_Double, Scalar::DOUBLE>,
+		&convertUaValues2io<OpcUaType_Double, Scalar::DOUBLE> },
+	// string - string/localizedText
+	{ Scalar::STRING, OpcUaType_String, "string",
+		&convertIoString2ua, NULL, &convertIoArray2uaStringArray,
+		&convertUaString2io, NULL },
+	{ Scalar::STRING, OpcUaType_LocalizedText, "string",
+		&convertIoString2uaLocalizedText, NULL, &convertIoArray2uaLocalizedTextArray,
+		NULL, NULL },
+	// byteString - byteString
+	{ Scalar::BYTE_STRING, OpcUaType_ByteString, "byteString",
+		&convertIoByteString2ua, NULL, NULL, &convertUaByteString2io, NULL },
+	// localizedText - localizedText
+	{ Scalar::LOCALIZED_TEXT, OpcUaType_LocalizedText, "localizedText",
+		&convertIoLocalizedText2ua, NULL, &convertIoArray2uaLocalizedTextArray,
+		&convertUaLocalizedText2io, NULL }
+};
+
+const size_t ConverterUa2IOPrivate::conversionCount =
+		sizeof (conversions) / sizeof (conversions[0]);
+
+// The table is small and searched linearly. The converters are resolved once per value, per
+// array or per structure field (see StructureCodec).
+const ScalarConversion* ConverterUa2IOPrivate::getConversion(int ioScalarType,
+		OpcUa_BuiltInType uaValueType) {
+	for (size_t i = 0; i < conversionCount; i++) {
+		if (conversions[i].ioScalarType == ioScalarType
+				&& conversions[i].uaValueType == uaValueType) {
+			return &conversions[i];
+		}
+	}
+	return NULL;
+}
+
+const ScalarConversion* ConverterUa2IOPrivate::getUaConversion(
+		OpcUa_BuiltInType uaValueType) {
+	for (size_t i = 0; i < conversionCount; i++) {
+		if (conversions[i].uaValueType == uaValueType
+				&& conversions[i].ua2ioScalar != NULL) {
+			return &conversions[i];
+		}
+	}
+	return NULL;
+}
+
+UaNodeId ConverterUa2IO::ConverterCallback::getBuildInType(const UaNodeId& typeId) {
+	if (0 == typeId.namespaceIndex()) {
+		return typeId;
+	}
+	std::vector<UaNodeId>* superTypes = getSuperTypes(typeId); // ConversionException
+	if (superTypes != NULL) {
+		ScopeGuard<std::vector<UaNodeId> > superTypesSG(superTypes);
+		if (superTypes->size() > 0) {
+			return superTypes->back();
+		}
+	}
+	return UaNodeId();
+}
+
+ConverterUa2IO::ConverterUa2IO(ConverterCallback& callback, bool attachValues)
+/* throws MutexException */{
 	d = new ConverterUa2IOPrivate();
 	d->log = LoggerFactory::getLogger("ConverterUa2IO");
 	d->parent = this;
 	d->callback = &callback;
 	d->hasAttachedValues = attachValues;
+	try {
+		d->codecsMutex = new Mutex(); // MutexException
+	} catch (Exception& e) {
+		delete d;
+		throw;
+	}
 }
 
 ConverterUa2IO::~ConverterUa2IO() {
+	for (std::map<UaNodeId, StructureCodec*>::const_iterator i = d->codecs.begin();
+			i != d->codecs.end(); i++) {
+		delete (*i).second;
+	}
+	delete d->codecsMutex;
 	if (d->hasAttachedValues) {
 		delete d->callback;
 	}
@@ -188,23 +858,115 @@ UaVariant* ConverterUa2IO::convertIo2ua(const Variant& value,
 	return ret;
 }
 
+void ConverterUa2IO::convertIo2ua(const Variant& value, const UaNodeId& destDataTypeId,
+		UaVariant& dest) const /* throws ConversionException */{
+	d->convertIo2ua(value, destDataTypeId, dest, 0 /*indent*/); // ConversionException
+	if (d->log->isDebugEnabled()
+			&& (value.getVariantType() == Variant::STRUCTURE
+					|| value.getVariantType() == Variant::ARRAY)) {
+		d->log->debug("< %s -> %s", value.toString().c_str(),
+				dest.toFullString().toUtf8());
+	}
+}
+
 UaNodeId ConverterUa2IOPrivate::getBuildInType(const UaNodeId& typeId)
 /* throws ConversionException */{
 	if (0 == typeId.namespaceIndex()) {
 		return typeId;
 	}
-	std::vector<UaNodeId>* superTypes = callback->getSuperTypes(typeId); // ConversionException
-	if (superTypes != NULL) {
-		ScopeGuard<std::vector<UaNodeId> > superTypesSG(superTypes);
-		if (superTypes->size() > 0) {
-			return superTypes->back();
-		}
+	UaNodeId ret = callback->getBuildInType(typeId); // ConversionException
+	if (!ret.isNull()) {
+		return ret;
 	}
 	throw ExceptionDef(ConversionException,
 			std::string("Cannot get base type of ").append(
 					typeId.toXmlString().toUtf8()));
 }
 
+StructureCodec& ConverterUa2IOPrivate::getStructureCodec(const UaNodeId& dataTypeId)
+/* throws ConversionException */{
+	MutexLock lock(*codecsMutex);
+	std::vector<StructureCodec*> compiled;
+	try {
+		return getStructureCodec(dataTypeId, compiled); // ConversionException
+	} catch (Exception& e) {
+		// remove the codecs of this call (they may refer to each other)
+		for (std::vector<StructureCodec*>::const_iterator i = compiled.begin();
+				i != compiled.end(); i++) {
+			codecs.erase((*i)->typeId);
+			delete *i;
+		}
+		throw;
+	}
+}
+
+StructureCodec& ConverterUa2IOPrivate::getStructureCodec(const UaNodeId& dataTypeId,
+		std::vector<StructureCodec*>& compiled) /* throws ConversionException */{
+	std::map<UaNodeId, StructureCodec*>::const_iterator i = codecs.find(dataTypeId);
+	if (i != codecs.end()) {
+		return *(*i).second;
+	}
+	StructureCodec* codec = new StructureCodec();
+	compiled.push_back(codec);
+	codec->typeId = dataTypeId;
+	codec->definition = callback->getStructureDefinition(dataTypeId); // ConversionException
+	// register the codec before the fields are compiled (a structure may refer to itself)
+	codecs[dataTypeId] = codec;
+	codec->dataTypeId = parent->convertUa2io(dataTypeId); // ConversionException
+	codec->isUnion = codec->definition.isUnion();
+	codec->fields.resize(codec->definition.childrenCount());
+	for (int j = 0; j < codec->definition.childrenCount(); j++) {
+		StructureCodec::Field& field = codec->fields[j];
+		field.field = codec->definition.child(j);
+		field.name = field.field.name().toUtf8();
+		field.index = j;
+		codec->fieldIndices.insert(std::pair<std::string, int>(field.name, j));
+		field.isOptional = field.field.isOptional();
+		field.codec = NULL;
+		field.uaValueType = OpcUaType_Null;
+		field.ua2ioConverter = NULL;
+		field.ioScalarType = -1;
+		field.io2uaConverter = NULL;
+		try {
+			field.buildInDataTypeId = getBuildInType(field.field.typeId()); // ConversionException
+		} catch (ConversionException& e) {
+			// the type is resolved again when a value of the field is converted
+			continue;
+		}
+		if (0 == field.buildInDataTypeId.namespaceIndex()) {
+			OpcUa_UInt32 buildInType = field.buildInDataTypeId.identifierNumeric();
+			switch (buildInType) {
+			case OpcUaId_Structure:
+			case OpcUaId_Union:
+				field.codec = &getStructureCodec(field.field.typeId(),
+						compiled); // ConversionException
+				break;
+			default: {
+				// resolve the converters for the expected value types once
+				const char* ioTypeName;
+				field.uaValueType = getUaValueType(buildInType);
+				if (field.uaValueType != OpcUaType_Null) {
+					field.ua2ioConverter = getUaScalar2ioConverter(buildInType,
+							field.uaValueType, ioTypeName);
+				}
+				field.ioScalarType = getIoScalarType(buildInType);
+				if (field.ioScalarType >= 0) {
+					field.io2uaConverter = getIoScalar2uaConverter(field.ioScalarType,
+							buildInType);
+				}
+				break;
+			}
+			}
+		}
+	}
+	if (log->isDebugEnabled()) {
+		log->debug("Compiled codec for %s %s with %lu fields",
+				codec->isUnion ? "union" : "structure",
+				dataTypeId.toXmlString().toUtf8(), codec->fields.size());
+	}
+	return *codec;
+}
+
 Variant* ConverterUa2IOPrivate::convertUa2io(const UaVariant& value,
 		const UaNodeId& srcDataTypeId,
 		OpcUa_Int16 indent) /* throws ConversionException */{
@@ -257,460 +1019,241 @@ Variant* ConverterUa2IOPrivate::convertUa2io(const UaVariant& value,
 }
 
 Variant * ConverterUa2IOPrivate::convertUaBuildInType2io(const UaVariant& value,
-		const UaNodeId& srcDataTypeId, OpcUa_Int16 indent) {
-	Variant* ret = NULL;
-	OpcUa_UInt32 srcType = srcDataTypeId.identifierNumeric();
-
-	if (0 == srcDataTypeId.namespaceIndex()) {
-		//log->error("Source Type %d", srcType);
-		switch (srcType) {
-		case OpcUaType_Boolean: // 1
-			switch (value.type()) {
-			case OpcUaType_Boolean: {
-				OpcUa_Boolean booleanValue;
-				if (OpcUa_IsGood(value.toBool(booleanValue))) {
-					Scalar* s = new Scalar();
-					s->setBool(static_cast<bool>(booleanValue));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type bool";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_SByte: // 2
-			switch (value.type()) {
-			case OpcUaType_SByte: {
-				OpcUa_SByte sbyteValue;
-				if (OpcUa_IsGood(value.toSByte(sbyteValue))) {
-					Scalar* s = new Scalar();
-					s->setSChar(static_cast<signed char>(sbyteValue));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type schar";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Byte: // 3
-			switch (value.type()) {
-			case OpcUaType_Byte: {
-				OpcUa_Byte byteValue;
-				if (OpcUa_IsGood(value.toByte(byteValue))) {
-					Scalar* s = new Scalar();
-					s->setChar(static_cast<char>(byteValue));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type char";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Int16: // 4
-			switch (value.type()) {
-			case OpcUaType_Int16: {
-				OpcUa_Int16 int16Value;
-				if (OpcUa_IsGood(value.toInt16(int16Value))) {
-					Scalar* s = new Scalar();
-					s->setInt(static_cast<int>(int16Value));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type int";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_UInt16: // 5
-			switch (value.type()) {
-			case OpcUaType_UInt16: {
-				OpcUa_UInt16 uint16Value;
-				if (OpcUa_IsGood(value.toUInt16(uint16Value))) {
-					Scalar* s = new Scalar();
-					s->setUInt(static_cast<unsigned int>(uint16Value));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type uint";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Int32: // 6
-		case OpcUaId_Enumeration: // 29
-			switch (value.type()) {
-			case OpcUaType_UInt16: {
-				OpcUa_UInt16 uint16Value;
-				if (OpcUa_IsGood(value.toUInt16(uint16Value))) {
-					Scalar* s = new Scalar();
-					s->setLong(static_cast<long>(uint16Value));
-					ret = s;
-				}
-				break;
-			}
-			case OpcUaType_Int32: {
-				OpcUa_Int32 int32Value;
-				if (OpcUa_IsGood(value.toInt32(int32Value))) {
-					Scalar* s = new Scalar();
-					s->setLong(static_cast<long>(int32Value));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type long";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_UInt32: // 7
-			switch (value.type()) {
-			case OpcUaType_UInt32: {
-				OpcUa_UInt32 uint32Value;
-				if (OpcUa_IsGood(value.toUInt32(uint32Value))) {
-					Scalar* s = new Scalar();
-					s->setULong(static_cast<unsigned long>(uint32Value));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type ulong";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Int64: // 8
-			switch (value.type()) {
-			case OpcUaType_Int64: {
-				OpcUa_Int64 int64Value;
-				if (OpcUa_IsGood(value.toInt64(int64Value))) {
-					Scalar* s = new Scalar();
-					s->setLLong(static_cast<long long>(int64Value));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type llong";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_UInt64: // 9
-			switch (value.type()) {
-			case OpcUaType_UInt64: {
-				OpcUa_UInt64 uint64Value;
-				if (OpcUa_IsGood(value.toUInt64(uint64Value))) {
-					Scalar* s = new Scalar();
-					s->setULLong(static_cast<unsigned long long>(uint64Value));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type ullong";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Float: // 10
-			switch (value.type()) {
-			case OpcUaType_Float: {
-				OpcUa_Float floatValue;
-				if (OpcUa_IsGood(value.toFloat(floatValue))) {
-					Scalar* s = new Scalar();
-					s->setFloat(static_cast<float>(floatValue));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type float";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Double: // 11
-		case OpcUaId_Duration: // 290
-			switch (value.type()) {
-			case OpcUaType_Double: {
-				OpcUa_Double doubleValue;
-				if (OpcUa_IsGood(value.toDouble(doubleValue))) {
-					Scalar* s = new Scalar();
-					s->setDouble(static_cast<double>(doubleValue));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type double";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_String: // 12
-			switch (value.type()) {
-			case OpcUaType_String: {
-				Scalar* s = new Scalar();
-				if (value.toString().isNull()) {
-					s->setString(NULL, false /* attachValues */);
-				} else {
-					s->setString(new std::string(value.toString().toUtf8()),
-							true /* attachValues */);
-				}
-				ret = s;
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type string";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_DateTime: // 13
-		case OpcUaId_UtcTime: // 294
-			switch (value.type()) {
-			case OpcUaType_DateTime: {
-				UaDateTime dateTimeValue;
-				if (OpcUa_IsGood(value.toDateTime(dateTimeValue))) {
-					Scalar* s = new Scalar();
-					s->setLLong(
-							static_cast<long long>((OpcUa_Int64) dateTimeValue));
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type llong";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_ByteString: // 15
-			switch (value.type()) {
-			case OpcUaType_ByteString: {
-				Scalar* s = new Scalar();
-				UaByteString byteString;
-				value.toByteString(byteString);
-				if (byteString.data() == NULL) {
-					s->setByteString(NULL, -1 /* length */,
-							false /* attachValues*/);
-				} else {
-					const OpcUa_Byte* bytes = byteString.data();
-					char* chars = new char[byteString.length()];
-					for (size_t i = 0; i < byteString.length(); i++) {
-						chars[i] = bytes[i];
-					}
-					s->setByteString(chars, byteString.length(),
-							true /* attachValues */);
-				}
-				ret = s;
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type byteString";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_NodeId:
-			switch (value.type()) {
-			case OpcUaType_NodeId: {
-				UaNodeId nodeId;
-				value.toNodeId(nodeId);
-				switch (nodeId.identifierType()) {
-				case OpcUa_IdentifierType_Numeric:
-					ret = new NodeId(nodeId.namespaceIndex(),
-							nodeId.identifierNumeric());
-					break;
-				case OpcUa_IdentifierType_String: {
-					std::string* id = new std::string(
-							UaString(nodeId.identifierString()).toUtf8());
-					ret = new NodeId(nodeId.namespaceIndex(), *id,
-							true /*attachValues*/);
-					break;
-				}
-				default:
-					std::ostringstream msg;
-					msg << "Cannot convert UaVariant of type " << value.type()
-							<< "/" << srcDataTypeId.toXmlString().toUtf8()
-							<< " to Scalar of type nodeId: Unsupported identifier type "
-							<< nodeId.identifierType();
-					throw ExceptionDef(ConversionException, msg.str());
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type nodeId";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_LocalizedText: // 21
-			switch (value.type()) {
-			case OpcUaType_LocalizedText: {
-				UaLocalizedText lt;
-				if (OpcUa_IsGood(value.toLocalizedText(lt))) {
-					Scalar* s = new Scalar();
-					std::string* ltLocale = NULL;
-					std::string* ltText = NULL;
-					if (!lt.isNull()) {
-						const OpcUa_String* locale = lt.locale();
-						if (locale != NULL) {
-							ltLocale = new std::string(
-									UaString(*locale).toUtf8());
-						}
-						const OpcUa_String* text = lt.text();
-						if (text != NULL) {
-							ltText = new std::string(UaString(*text).toUtf8());
-						}
-					}
-					s->setLocalizedText(ltLocale, ltText,
-							true /* attachValues */);
-					ret = s;
-				}
-				break;
-			}
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type localizedText";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		case OpcUaType_Null: // 0
-			switch (value.type()) {
-			default:
-				{
-					Scalar* s = new Scalar();
-					s->setString(new std::string("NULL"), true /* attachValues */);
-					ret = s;
-				}
-				break;
-			}
-		break;
-		case OpcUaType_Variant: //24
-			switch (value.type()) {		
-			case OpcUaType_DataValue: {
-				UaDataValue dv;
-				if (OpcUa_IsGood(value.toDataValue(&dv))) {
-					UaVariant uav(*dv.value());
-					if (uav.isArray()) {
-						std::vector<const Variant*>* elements = new std::vector<
-								const Variant*>();
-						VectorScopeGuard<const Variant> elementsSG(elements);
-						//TODO Bug in sdk? Variant arrays have to be transfer to UaVariantArray, else the values are empty
-						UaVariantArray arr;
-						uav.toVariantArray(arr);
-						for (OpcUa_UInt32 i = 0; i < arr.length(); i++) {
-							UaVariant element(arr[i]);
-							if (element.isArray()) {
-								throw ExceptionDef(ConversionException,
-										std::string(
-												"Cannot convert Array of type ").append(
-														element.dataType().toXmlString().toUtf8()).append(
-												" to Variant due to unsupported nested Variant arrays"));
-							}
-							Variant* v = convertUa2io(element, element.dataType(),
-									indent + 1); // ConversionException
-							elements->push_back(v);
-						}
-						ret = new Array(OpcUaType_Variant, elementsSG.detach(),
-								true /*attachValues*/);
-					} else {
-						ret = convertUa2io(uav, uav.dataType(), 0);
-					}
-				}
-			}
-			break;
-			default: {
-				std::ostringstream msg;
-				msg << "Cannot convert UaVariant of type " << value.type()
-						<< "/" << srcDataTypeId.toXmlString().toUtf8()
-						<< " to Scalar of type dataValue";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			}
-			break;
-		default: {
-			std::ostringstream msg;
-			msg << "Cannot convert UaVariant of type " << value.type() << "/"
-					<< srcDataTypeId.toXmlString().toUtf8() << " to Scalar";
-			throw ExceptionDef(ConversionException, msg.str());
-		}
+		const UaNodeId& srcDataTypeId,
+		OpcUa_Int16 indent) /* throws ConversionException */{
+	if (0 != srcDataTypeId.namespaceIndex()) {
+		return NULL;
+	}
+	UaScalar2ioConverter convert = resolveUaScalar2ioConverter(value.type(),
+			srcDataTypeId); // ConversionException
+	return convert(*this, value, indent); // ConversionException
+}
+
+UaScalar2ioConverter ConverterUa2IOPrivate::resolveUaScalar2ioConverter(
+		OpcUa_BuiltInType valueType,
+		const UaNodeId& srcDataTypeId) /* throws ConversionException */{
+	const char* ioTypeName;
+	UaScalar2ioConverter ret = getUaScalar2ioConverter(srcDataTypeId.identifierNumeric(),
+			valueType, ioTypeName);
+	if (ret == NULL) {
+		std::ostringstream msg;
+		msg << "Cannot convert UaVariant of type " << valueType << "/"
+				<< srcDataTypeId.toXmlString().toUtf8() << " to Scalar";
+		if (ioTypeName != NULL) {
+			msg << " of type " << ioTypeName;
 		}
+		throw ExceptionDef(ConversionException, msg.str());
 	}
 	return ret;
 }
 
+UaScalar2ioConverter ConverterUa2IOPrivate::getUaScalar2ioConverter(
+		OpcUa_UInt32 buildInType, OpcUa_BuiltInType valueType, const char*& ioTypeName) {
+	// OPC UA          - InternalInterface
+	// (scalar types)  - see conversions
+	// int32/enum      - long(32) (value type int32 or uint16)
+	// nodeId          - nodeId
+	// null            - string (any value type)
+	// variant         - variant (value type dataValue)
+	switch (buildInType) {
+	case OpcUaType_NodeId: // 17
+		ioTypeName = "nodeId";
+		return valueType == OpcUaType_NodeId ? &convertUaNodeId2io : NULL;
+	case OpcUaType_Null: // 0
+		ioTypeName = "string";
+		return &convertUaNull2io;
+	case OpcUaType_Variant: // 24
+		ioTypeName = "dataValue";
+		return valueType == OpcUaType_DataValue ? &convertUaDataValue2io : NULL;
+	}
+	OpcUa_BuiltInType uaValueType = getUaValueType(buildInType);
+	const ScalarConversion* conversion = getUaConversion(uaValueType);
+	if (conversion == NULL) {
+		ioTypeName = NULL;
+		return NULL;
+	}
+	ioTypeName = conversion->ioTypeName;
+	if (valueType == uaValueType) {
+		return conversion->ua2ioScalar;
+	}
+	if (uaValueType == OpcUaType_Int32 && valueType == OpcUaType_UInt16) {
+		return &convertUaNumeric2io<OpcUaType_UInt16, Scalar::LONG>;
+	}
+	return NULL;
+}
+
+OpcUa_BuiltInType ConverterUa2IOPrivate::getUaValueType(OpcUa_UInt32 buildInType) {
+	switch (buildInType) {
+	case OpcUaType_Boolean:
+	case OpcUaType_SByte:
+	case OpcUaType_Byte:
+	case OpcUaType_Int16:
+	case OpcUaType_UInt16:
+	case OpcUaType_Int32:
+	case OpcUaType_UInt32:
+	case OpcUaType_Int64:
+	case OpcUaType_UInt64:
+	case OpcUaType_Float:
+	case OpcUaType_Double:
+	case OpcUaType_String:
+	case OpcUaType_DateTime:
+	case OpcUaType_ByteString:
+	case OpcUaType_NodeId:
+	case OpcUaType_LocalizedText:
+		return static_cast<OpcUa_BuiltInType>(buildInType);
+	case OpcUaId_Enumeration:
+		return OpcUaType_Int32;
+	case OpcUaId_Duration:
+		return OpcUaType_Double;
+	case OpcUaId_UtcTime:
+		return OpcUaType_DateTime;
+	default:
+		return OpcUaType_Null;
+	}
+}
+
+template<int ValueType, int ScalarType> Variant* ConverterUa2IOPrivate::convertUaNumeric2io(
+		ConverterUa2IOPrivate& d, const UaVariant& value, OpcUa_Int16 indent) {
+	typename BuildInTypeTraits<ValueType>::Type v;
+	if (OpcUa_IsNotGood(BuildInTypeTraits<ValueType>::get(value, v))) {
+		return NULL;
+	}
+	Scalar* s = new Scalar();
+	ScalarTraits<ScalarType>::set(*s,
+			static_cast<typename ScalarTraits<ScalarType>::Type>(v));
+	return s;
+}
+
+Variant* ConverterUa2IOPrivate::convertUaString2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) {
+	Scalar* s = new Scalar();
+	if (value.toString().isNull()) {
+		s->setString(NULL, false /* attachValues */);
+	} else {
+		s->setString(new std::string(value.toString().toUtf8()),
+				true /* attachValues */);
+	}
+	return s;
+}
+
+Variant* ConverterUa2IOPrivate::convertUaDateTime2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) {
+	UaDateTime dateTimeValue;
+	if (OpcUa_IsNotGood(value.toDateTime(dateTimeValue))) {
+		return NULL;
+	}
+	Scalar* s = new Scalar();
+	s->setLLong(static_cast<long long>((OpcUa_Int64) dateTimeValue));
+	return s;
+}
+
+Variant* ConverterUa2IOPrivate::convertUaByteString2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) {
+	Scalar* s = new Scalar();
+	UaByteString byteString;
+	value.toByteString(byteString);
+	if (byteString.data() == NULL) {
+		s->setByteString(NULL, -1 /* length */, false /* attachValues*/);
+	} else {
+		char* chars = new char[byteString.length()];
+		memcpy(chars, byteString.data(), byteString.length());
+		s->setByteString(chars, byteString.length(), true /* attachValues */);
+	}
+	return s;
+}
+
+Variant* ConverterUa2IOPrivate::convertUaNodeId2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) /* throws ConversionException */{
+	UaNodeId nodeId;
+	value.toNodeId(nodeId);
+	switch (nodeId.identifierType()) {
+	case OpcUa_IdentifierType_Numeric:
+	case OpcUa_IdentifierType_String:
+		return d.parent->convertUa2io(nodeId); // ConversionException
+	default:
+		std::ostringstream msg;
+		msg << "Cannot convert UaVariant of type " << value.type() << "/"
+				<< UaNodeId(OpcUaId_NodeId).toXmlString().toUtf8()
+				<< " to Scalar of type nodeId: Unsupported identifier type "
+				<< nodeId.identifierType();
+		throw ExceptionDef(ConversionException, msg.str());
+	}
+}
+
+Variant* ConverterUa2IOPrivate::convertUaLocalizedText2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) {
+	UaLocalizedText lt;
+	if (OpcUa_IsNotGood(value.toLocalizedText(lt))) {
+		return NULL;
+	}
+	Scalar* s = new Scalar();
+	std::string* ltLocale = NULL;
+	std::string* ltText = NULL;
+	if (!lt.isNull()) {
+		const OpcUa_String* locale = lt.locale();
+		if (locale != NULL) {
+			ltLocale = new std::string(UaString(*locale).toUtf8());
+		}
+		const OpcUa_String* text = lt.text();
+		if (text != NULL) {
+			ltText = new std::string(UaString(*text).toUtf8());
+		}
+	}
+	s->setLocalizedText(ltLocale, ltText, true /* attachValues */);
+	return s;
+}
+
+Variant* ConverterUa2IOPrivate::convertUaNull2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) {
+	Scalar* s = new Scalar();
+	s->setString(new std::string("NULL"), true /* attachValues */);
+	return s;
+}
+
+Variant* ConverterUa2IOPrivate::convertUaDataValue2io(ConverterUa2IOPrivate& d,
+		const UaVariant& value, OpcUa_Int16 indent) /* throws ConversionException */{
+	UaDataValue dv;
+	if (OpcUa_IsNotGood(value.toDataValue(&dv))) {
+		return NULL;
+	}
+	UaVariant uav(*dv.value());
+	if (!uav.isArray()) {
+		return d.convertUa2io(uav, uav.dataType(), 0 /*indent*/); // ConversionException
+	}
+	std::vector<const Variant*>* elements = new std::vector<const Variant*>();
+	VectorScopeGuard<const Variant> elementsSG(elements);
+	//TODO Bug in sdk? Variant arrays have to be transfer to UaVariantArray, else the values are empty
+	UaVariantArray arr;
+	uav.toVariantArray(arr);
+	elements->reserve(arr.length());
+	for (OpcUa_UInt32 i = 0; i < arr.length(); i++) {
+		UaVariant element(arr[i]);
+		if (element.isArray()) {
+			throw ExceptionDef(ConversionException,
+					std::string("Cannot convert Array of type ").append(
+							element.dataType().toXmlString().toUtf8()).append(
+							" to Variant due to unsupported nested Variant arrays"));
+		}
+		Variant* v = d.convertUa2io(element, element.dataType(),
+				indent + 1); // ConversionException
+		elements->push_back(v);
+	}
+	return new Array(OpcUaType_Variant, elementsSG.detach(), true /*attachValues*/);
+}
+
 Variant * ConverterUa2IOPrivate::convertUaExtensionObject2io(
 		const UaExtensionObject& value, const UaNodeId& srcDataTypeId,
 		OpcUa_Int16 indent)
 		/* throws ConversionException */{
-	NodeId* nodeId = parent->convertUa2io(srcDataTypeId); // ConversionException
-	ScopeGuard<NodeId> nodeIdSG(nodeId);
-	UaStructureDefinition sd = callback->getStructureDefinition(srcDataTypeId); // ConversionException
+	return convertUaExtensionObject2io(value, getStructureCodec(srcDataTypeId),
+			indent); // ConversionException
+}
+
+Variant * ConverterUa2IOPrivate::convertUaExtensionObject2io(
+		const UaExtensionObject& value, const StructureCodec& codec,
+		OpcUa_Int16 indent)
+		/* throws ConversionException */{
+	const UaStructureDefinition& sd = codec.definition;
 	if (log->isTraceEnabled()) {
 		char ind[indent + 1];
 		memset(ind, ' ', indent);
@@ -719,62 +1262,91 @@ Variant * ConverterUa2IOPrivate::convertUaExtensionObject2io(
 				sd.name().toUtf8(), sd.dataTypeId().toXmlString().toUtf8(),
 				sd.isUnion());
 	}
-	std::map<std::string, const Variant*>* fieldData = new std::map<std::string,
-			const Variant*>();
-	MapScopeGuard<std::string, const Variant> fieldDataSG(fieldData);
-	if (sd.isUnion()) {
+	// the fields are added in the order of the definition
+	Structure* ret = Structure::createStructure(*new NodeId(*codec.dataTypeId),
+			codec.isUnion ? 1 : codec.fields.size());
+	ScopeGuard<Structure> retSG(ret);
+	if (codec.isUnion) {
 		UaGenericUnionValue uv(value, sd);
-		UaStructureField sf = uv.field();
-		if (!sf.isNull()) {
-			Variant* v = convertUaStructureField2io(sf, uv.value(), indent + 1); // ConversionException
-			std::string fieldName(sf.name().toUtf8());
-			(*fieldData)[fieldName] = v;
+		// the switch value is the position of the field in the definition + 1
+		// (0: no field)
+		int switchValue = uv.switchValue();
+		if (switchValue > 0) {
+			if ((size_t) switchValue > codec.fields.size()) {
+				std::ostringstream msg;
+				msg << "Cannot convert UaExtensionObject of type "
+						<< sd.dataTypeId().toXmlString().toUtf8()
+						<< " due to unknown union field " << switchValue;
+				throw ExceptionDef(ConversionException, msg.str());
+			}
+			const StructureCodec::Field& field = codec.fields[switchValue - 1];
+			Variant* v = convertUaStructureField2io(field, uv.value(), indent + 1); // ConversionException
+			ret->addField(field.name, *v);
 		}
 	} else {
 		UaGenericStructureValue sv(value, sd);
-		for (int j = 0; j < sd.childrenCount(); j++) {
-			UaStructureField sf = sd.child(j);
-			std::string fieldName(sf.name().toUtf8());
-			UaString uaFieldName(fieldName.c_str());
-			if (!sf.isOptional() && !sv.isFieldSet(uaFieldName)) {
+		// for each field in the order of the definition
+		for (std::vector<StructureCodec::Field>::const_iterator j = codec.fields.begin();
+				j != codec.fields.end(); j++) {
+			const StructureCodec::Field& field = *j;
+			// the fields are accessed by position; mandatory fields are read directly
+			if (field.isOptional && !sv.isFieldSet(field.index)) {
+				continue;
+			}
+			OpcUa_StatusCode status;
+			UaVariant fieldValue = sv.value(field.index, &status);
+			if (!OpcUa_IsGood(status)) {
 				throw ExceptionDef(ConversionException,
 						std::string("Cannot convert UaExtensionObject of type ").append(
-								srcDataTypeId.toXmlString().toUtf8()).append(
-								" due to missing value for mandatory field '").append(
-								sf.name().toUtf8()).append("'"));
-			}
-			if (sv.isFieldSet(uaFieldName)) {
-				OpcUa_StatusCode status;
-				UaVariant fieldValue = sv.value(uaFieldName, &status);
-				if (!OpcUa_IsGood(status)) {
-					throw ExceptionDef(ConversionException,
-							std::string("Cannot get value of field '").append(
-									fieldName.c_str()).append(
-									"' of structure with data type ").append(
-									sd.dataTypeId().toXmlString().toUtf8()));
-				}
-				Variant* v = convertUaStructureField2io(sf, fieldValue,
-						indent + 1); // ConversionException
-				(*fieldData)[fieldName] = v;
+								sd.dataTypeId().toXmlString().toUtf8()).append(
+								" due to missing value for field '").append(
+								field.name).append("'"));
 			}
+			Variant* v = convertUaStructureField2io(field, fieldValue,
+					indent + 1); // ConversionException
+			ret->addField(field.name, *v);
 		}
 	}
-	return new Structure(*nodeIdSG.detach(), *fieldDataSG.detach(),
-			true /*attachValues*/);
+	return retSG.detach();
 }
 
 Variant* ConverterUa2IOPrivate::convertUaStructureField2io(
-		const UaStructureField& field, const UaVariant& value,
+		const StructureCodec::Field& field, const UaVariant& value,
 		OpcUa_Int16 indent) /* throws ConversionException */{
 	if (log->isTraceEnabled()) {
 		char ind[indent + 1];
 		memset(ind, ' ', indent);
 		ind[indent] = 0;
 		log->trace("> %sfield name=%s,dataTypeId=%s,arrayType=%d", ind,
-				field.name().toUtf8(), field.typeId().toXmlString().toUtf8(),
-				field.arrayType());
+				field.name.c_str(), field.field.typeId().toXmlString().toUtf8(),
+				field.field.arrayType());
+	}
+	Variant* v;
+	if (value.isArray()) {
+		v = convertUaArray2io(value, field.field.typeId(), indent); // ConversionException
+	} else if (field.codec != NULL) {
+		// nested structure: use the codec of the field
+		UaExtensionObject eo;
+		value.toExtensionObject(eo);
+		v = convertUaExtensionObject2io(eo, *field.codec, indent); // ConversionException
+	} else if (field.buildInDataTypeId.isNull()) {
+		v = convertUa2io(value, field.field.typeId(), indent); // ConversionException
+	} else {
+		// the built-in type of the field has been resolved by the codec
+		if (field.ua2ioConverter != NULL && value.type() == field.uaValueType) {
+			// the converter of the field has been resolved by the codec
+			v = field.ua2ioConverter(*this, value, indent); // ConversionException
+		} else {
+			v = convertUaBuildInType2io(value, field.buildInDataTypeId,
+					indent); // ConversionException
+		}
+		if (v == NULL) {
+			throw ExceptionDef(ConversionException,
+					std::string("Cannot convert UaVariant of type ").append(
+							field.field.typeId().toXmlString().toUtf8()).append(
+							" to Variant"));
+		}
 	}
-	Variant* v = convertUa2io(value, field.typeId(), indent); // ConversionException
 	if (log->isTraceEnabled() && v->getVariantType() != Variant::ARRAY) {
 		char ind[indent + 1];
 		memset(ind, ' ', indent);
@@ -790,10 +1362,23 @@ IODataProviderNamespace::Array* ConverterUa2IOPrivate::convertUaArray2io(
 		/* throws ConversionException */{
 	UaNodeId buildInDataTypeId = getBuildInType(srcDataTypeId); // ConversionException
 	int arrayType = getIoArrayType(buildInDataTypeId); // ConversionException
+	if (Array::getElementSize(arrayType) > 0) {
+		return convertUaTypedArray2io(value, srcDataTypeId,
+				*getUaConversion(getUaValueType(
+						buildInDataTypeId.identifierNumeric()))); // ConversionException
+	}
+	// the codec for structure elements
+	const StructureCodec* codec = arrayType == Variant::STRUCTURE ?
+			&getStructureCodec(srcDataTypeId) : NULL; // ConversionException
 	std::vector<const Variant*>* elements = new std::vector<const Variant*>();
 	VectorScopeGuard<const Variant> elementsSG(elements);
 	//log->error("arraySize %d", value.arraySize());
 	if (value.arraySize()>0){
+		elements->reserve(value.arraySize());
+		// the converter for scalar elements (it is resolved again if the value type of an
+		// element differs from the value type of the previous element)
+		UaScalar2ioConverter convert = NULL;
+		OpcUa_BuiltInType valueType = OpcUaType_Null;
 		for (OpcUa_UInt32 i = 0; i < value.arraySize(); i++) {
 			UaVariant uav(value[i]);
 			if (uav.isArray()) {
@@ -802,39 +1387,94 @@ IODataProviderNamespace::Array* ConverterUa2IOPrivate::convertUaArray2io(
 								srcDataTypeId.toXmlString().toUtf8()).append(
 								" to Variant due to unsupported nested Variant arrays"));
 			}
-			Variant* v = convertUa2io(uav, srcDataTypeId, indent + 1); // ConversionException
+			Variant* v;
+			if (codec != NULL) {
+				UaExtensionObject eo;
+				uav.toExtensionObject(eo);
+				v = convertUaExtensionObject2io(eo, *codec, indent + 1); // ConversionException
+			} else {
+				if (convert == NULL || uav.type() != valueType) {
+					valueType = uav.type();
+					convert = resolveUaScalar2ioConverter(valueType,
+							buildInDataTypeId); // ConversionException
+				}
+				v = convert(*this, uav, indent + 1); // ConversionException
+				if (v == NULL) {
+					throw ExceptionDef(ConversionException,
+							std::string("Cannot convert UaVariant of type ").append(
+									srcDataTypeId.toXmlString().toUtf8()).append(
+									" to Variant"));
+				}
+			}
 			elements->push_back(v);
 		}
 	}
 	return new Array(arrayType, elementsSG.detach(), true /*attachValues*/);
 }
 
+Array* ConverterUa2IOPrivate::convertUaTypedArray2io(const UaVariant& value,
+		const UaNodeId& srcDataTypeId,
+		const ScalarConversion& conversion) /* throws ConversionException */{
+	OpcUa_StatusCode status = OpcUa_BadTypeMismatch;
+	Array* ret = conversion.ua2ioValues(value, status);
+	if (OpcUa_IsNotGood(status)) {
+		delete ret;
+		std::ostringstream msg;
+		msg << "Cannot convert Array of type " << value.type() << "/"
+				<< srcDataTypeId.toXmlString().toUtf8() << " to Array of type "
+				<< conversion.ioScalarType;
+		throw ExceptionDef(ConversionException, msg.str());
+	}
+	return ret;
+}
+
+template<int BuildInType, int ScalarType> Array* ConverterUa2IOPrivate::convertUaValues2io(
+		const UaVariant& value, OpcUa_StatusCode& status) {
+	typedef BuildInTypeTraits<BuildInType> Traits;
+	typename Traits::ArrayType array;
+	status = Traits::getArray(value, array);
+	return createIoArray(ScalarType, array);
+}
+
+Array* ConverterUa2IOPrivate::convertUaByteArray2io(const UaVariant& value,
+		OpcUa_StatusCode& status) {
+	UaByteArray array;
+	status = value.toByteArray(array);
+	Array* ret = Array::createTypedArray(Scalar::CHAR, array.size());
+	if (array.size() > 0) {
+		memcpy(ret->getValues(), array.data(), array.size());
+	}
+	return ret;
+}
+
+template<class T> Array* ConverterUa2IOPrivate::createIoArray(int arrayType,
+		const T& uaArray) {
+	Array* ret = Array::createTypedArray(arrayType, uaArray.length());
+	if (uaArray.length() > 0) {
+		memcpy(ret->getValues(), &uaArray[0], uaArray.length() * sizeof (uaArray[0]));
+	}
+	return ret;
+}
+
 int ConverterUa2IOPrivate::getIoArrayType(
 		const UaNodeId dataTypeId) /* throws ConversionException */{
 	if (0 == dataTypeId.namespaceIndex()) {
-		//log->error("DataType %d ", dataTypeId.identifierNumeric());
 		switch (dataTypeId.identifierNumeric()) {
 		case OpcUaType_Null:
 			return Scalar::STRING;
-		case OpcUaType_Int16:
-			return Scalar::INT;
-		case OpcUaType_UInt16:
-			return Scalar::UINT;
-		case OpcUaType_Int32:
-		case OpcUaId_Enumeration:
-			return Scalar::LONG;
-		case OpcUaType_UInt32:
-			return Scalar::ULONG;
-		case OpcUaType_String:
-			return Scalar::STRING;
-		case OpcUaId_LocalizedText:
-			return Scalar::LOCALIZED_TEXT;
 		case OpcUaType_Variant:
 			return Scalar::VARIANT;
 		case OpcUaId_Structure:
 		case OpcUaId_Union:
 			return Variant::STRUCTURE;
 		}
+		const ScalarConversion* conversion = getUaConversion(
+				getUaValueType(dataTypeId.identifierNumeric()));
+		// arrays of scalar types with a fixed size are read in bulk
+		if (conversion != NULL && (conversion->ua2ioValues != NULL
+				|| Array::getElementSize(conversion->ioScalarType) == 0)) {
+			return conversion->ioScalarType;
+		}
 	}
 	throw ExceptionDef(ConversionException,
 			std::string("Cannot get Array type for ").append(
@@ -891,219 +1531,139 @@ UaVariant * ConverterUa2IOPrivate::convertIo2ua(const Variant& value,
 	return ret;
 }
 
+void ConverterUa2IOPrivate::convertIo2ua(const Variant& value,
+		const UaNodeId& destDataTypeId, UaVariant& dest, OpcUa_Int16 indent)
+		/* throws ConversionException */{
+	if (value.getVariantType() == Variant::SCALAR) {
+		UaNodeId buildInDataTypeId = getBuildInType(destDataTypeId); // ConversionException
+		convertIoScalar2ua(static_cast<const Scalar&>(value), buildInDataTypeId,
+				dest); // ConversionException
+		return;
+	}
+	UaVariant* ret = convertIo2ua(value, destDataTypeId, indent); // ConversionException
+	OpcUa_Variant v;
+	ret->detach(&v);
+	delete ret;
+	dest.attach(&v);
+}
+
 UaVariant * ConverterUa2IOPrivate::convertIoScalar2ua(const Scalar& value,
 		const UaNodeId& destDataTypeId, OpcUa_Int16 indent) const
 		/* throws ConversionException */{
-	UaVariant* ret = NULL;
-	switch (value.getScalarType()) {
-	case Scalar::BOOL:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Boolean:
-			ret = new UaVariant();
-			ret->setBool(value.getBool());
-			break;
-		}
-		break;
-	case Scalar::SCHAR:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_SByte:
-			ret = new UaVariant();
-			ret->setSByte(value.getSChar());
-			break;
-		}
-		break;
-	case Scalar::CHAR:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Byte:
-			ret = new UaVariant();
-			ret->setByte(value.getChar());
-			break;
-		}
-		break;
-	case Scalar::INT:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Int16:
-			ret = new UaVariant();
-			ret->setInt16(value.getInt());
-			break;
-		}
-		break;
-	case Scalar::UINT:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_UInt16:
-			ret = new UaVariant();
-			ret->setUInt16(value.getUInt());
-			break;
-		}
-		break;
-	case Scalar::LONG:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Int32:
-		case OpcUaId_Enumeration:
-			ret = new UaVariant();
-			ret->setInt32(value.getLong());
-			break;
-		case OpcUaType_UInt32:
-			ret = new UaVariant();
-			ret->setUInt32(value.getULong());
-			break;
-		case OpcUaType_UInt16: {
-			long v = value.getLong();
-			if (v >= 0 && v < 2 ^ 15) {
-				ret = new UaVariant();
-				ret->setUInt16(v);
-			} else {
-				std::ostringstream msg;
-				msg << "Invalid value " << v << " for destination type uint16";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			break;
-		}
-		}
-		break;
-	case Scalar::ULONG:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_UInt32:
-			ret = new UaVariant();
-			ret->setUInt32(value.getULong());
-			break;
-		}
-		break;
-	case Scalar::LLONG:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Int64:
-			ret = new UaVariant();
-			ret->setInt64(value.getLLong());
-			break;
-		case OpcUaType_UInt32: {
-			long long v = value.getLLong();
-			if (v >= 0 && v < 2 ^ 31) {
-				ret = new UaVariant();
-				ret->setUInt32(v);
-			} else {
-				std::ostringstream msg;
-				msg << "Invalid value " << v
-						<< " for destination type OpcUa_UInt32";
-				throw ExceptionDef(ConversionException, msg.str());
-			}
-			break;
-		}
-		case OpcUaType_DateTime:
-		case OpcUaId_UtcTime:
-			ret = new UaVariant();
-			ret->setDateTime(
-					UaDateTime(static_cast<OpcUa_Int64>(value.getLLong())));
-			break;
-		}
-		break;
-	case Scalar::ULLONG:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_UInt64:
-			ret = new UaVariant();
-			ret->setUInt64(value.getULLong());
-			break;
-		}
-		break;
-	case Scalar::FLOAT:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Float:
-			ret = new UaVariant();
-			ret->setFloat(value.getFloat());
-			break;
-		}
-		break;
-	case Scalar::DOUBLE:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_Double:
-		case OpcUaId_Duration:
-			ret = new UaVariant();
-			ret->setDouble(value.getDouble());
-			break;
-		}
-		break;
-	case Scalar::STRING: {
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_String:
-			ret = new UaVariant();
-			if (value.getString() == NULL) {
-				UaString str;
-				ret->setString(str);
-			} else {
-				ret->setString(UaString(value.getString()->c_str()));
-			}
-			break;
-		case OpcUaType_LocalizedText:
-			ret = new UaVariant();
-			if (value.getString() == NULL) {
-				UaLocalizedText lt;
-				ret->setLocalizedText(lt);
-			} else {
-				UaLocalizedText lt(UaString("en"),
-						UaString(value.getString()->c_str()));
-				ret->setLocalizedText(lt);
-			}
-			break;
-		}
-		break;
-	}
-	case Scalar::BYTE_STRING:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_ByteString: {
-			const char* bs = value.getByteString();
-			ret = new UaVariant();
-			if (bs == NULL) {
-				UaByteString byteString;
-				ret->setByteString(byteString, true /*detach*/);
-			} else {
-				long length = value.getByteStringLength();
-				OpcUa_Byte bytes[length];
-				for (size_t i = 0; i < length; i++) {
-					bytes[i] = bs[i];
-				}
-				UaByteString byteString(length, bytes);
-				ret->setByteString(byteString, true /*detach*/);
-			}
-			break;
-		}
-		}
-		break;
-	case Scalar::LOCALIZED_TEXT:
-		switch (destDataTypeId.identifierNumeric()) {
-		case OpcUaType_LocalizedText: {
-			ret = new UaVariant();
-			UaLocalizedText lt;
-			const std::string* locale = value.getLocalizedTextLocale();
-			if (locale != NULL) {
-				UaString uaLocale(locale->c_str());
-				lt.setLocale(uaLocale);
-			}
-			const std::string* text = value.getLocalizedTextText();
-			if (text != NULL) {
-				UaString uaText(text->c_str());
-				lt.setText(uaText);
-			}
-			ret->setLocalizedText(lt);
-			break;
-		}
-		}
-		break;
-	}
-	if (ret == NULL) {
+	UaVariant* ret = new UaVariant();
+	ScopeGuard<UaVariant> retSG(ret);
+	convertIoScalar2ua(value, destDataTypeId, *ret); // ConversionException
+	return retSG.detach();
+}
+
+void ConverterUa2IOPrivate::convertIoScalar2ua(const Scalar& value,
+		const UaNodeId& destDataTypeId, UaVariant& dest) const
+		/* throws ConversionException */{
+	IoScalar2uaConverter convert = getIoScalar2uaConverter(value.getScalarType(),
+			destDataTypeId.identifierNumeric());
+	if (convert == NULL) {
 		std::ostringstream msg;
 		msg << "Cannot convert Scalar of type " << value.getScalarType()
 				<< " to UaVariant of type "
 				<< destDataTypeId.toXmlString().toUtf8();
 		throw ExceptionDef(ConversionException, msg.str());
 	}
-	return ret;
+	convert(value, dest); // ConversionException
+}
+
+IoScalar2uaConverter ConverterUa2IOPrivate::getIoScalar2uaConverter(int scalarType,
+		OpcUa_UInt32 buildInType) {
+	const ScalarConversion* conversion = getConversion(scalarType,
+			getUaValueType(buildInType));
+	return conversion == NULL ? NULL : conversion->io2uaScalar;
+}
+
+int ConverterUa2IOPrivate::getIoScalarType(OpcUa_UInt32 buildInType) {
+	const ScalarConversion* conversion = getUaConversion(getUaValueType(buildInType));
+	return conversion == NULL ? -1 : conversion->ioScalarType;
+}
+
+template<int ScalarType, int BuildInType> void ConverterUa2IOPrivate::convertIoNumeric2ua(
+		const Scalar& value, UaVariant& dest) {
+	typedef BuildInTypeTraits<BuildInType> Traits;
+	Traits::set(dest,
+			static_cast<typename Traits::Type>(ScalarTraits<ScalarType>::get(value)));
+}
+
+template<int ScalarType, int BuildInType> void ConverterUa2IOPrivate::convertIoNumeric2uaChecked(
+		const Scalar& value, UaVariant& dest) /* throws ConversionException */{
+	typedef BuildInTypeTraits<BuildInType> Traits;
+	typename ScalarTraits<ScalarType>::Type v = ScalarTraits<ScalarType>::get(value);
+	if (v < 0 || v > std::numeric_limits<typename Traits::Type>::max()) {
+		std::ostringstream msg;
+		msg << "Invalid value " << v << " for destination type " << Traits::getName();
+		throw ExceptionDef(ConversionException, msg.str());
+	}
+	Traits::set(dest, static_cast<typename Traits::Type>(v));
+}
+
+void ConverterUa2IOPrivate::convertIoString2ua(const Scalar& value, UaVariant& dest) {
+	if (value.getString() == NULL) {
+		UaString str;
+		dest.setString(str);
+	} else {
+		dest.setString(UaString(value.getString()->c_str()));
+	}
+}
+
+void ConverterUa2IOPrivate::convertIoString2uaLocalizedText(const Scalar& value,
+		UaVariant& dest) {
+	if (value.getString() == NULL) {
+		UaLocalizedText lt;
+		dest.setLocalizedText(lt);
+	} else {
+		UaLocalizedText lt(UaString("en"), UaString(value.getString()->c_str()));
+		dest.setLocalizedText(lt);
+	}
+}
+
+void ConverterUa2IOPrivate::convertIoLLong2uaDateTime(const Scalar& value, UaVariant& dest) {
+	dest.setDateTime(UaDateTime(static_cast<OpcUa_Int64>(value.getLLong())));
+}
+
+void ConverterUa2IOPrivate::convertIoByteString2ua(const Scalar& value, UaVariant& dest) {
+	const char* bs = value.getByteString();
+	if (bs == NULL) {
+		UaByteString byteString;
+		dest.setByteString(byteString, true /*detach*/);
+	} else {
+		UaByteString byteString(value.getByteStringLength(),
+				reinterpret_cast<OpcUa_Byte*>(const_cast<char*>(bs)));
+		dest.setByteString(byteString, true /*detach*/);
+	}
+}
+
+void ConverterUa2IOPrivate::convertIoLocalizedText2ua(const Scalar& value, UaVariant& dest) {
+	UaLocalizedText lt;
+	const std::string* locale = value.getLocalizedTextLocale();
+	if (locale != NULL) {
+		UaString uaLocale(locale->c_str());
+		lt.setLocale(uaLocale);
+	}
+	const std::string* text = value.getLocalizedTextText();
+	if (text != NULL) {
+		UaString uaText(text->c_str());
+		lt.setText(uaText);
+	}
+	dest.setLocalizedText(lt);
 }
 
 UaVariant * ConverterUa2IOPrivate::convertIoStructure2ua(const Structure& value,
 		const UaNodeId& destDataTypeId,
 		OpcUa_Int16 indent) /* throws ConversionException */{
-	UaStructureDefinition sd = callback->getStructureDefinition(destDataTypeId); // ConversionException
-	const std::map<std::string, const Variant*>& fieldData =
-			value.getFieldData();
+	return convertIoStructure2ua(value, getStructureCodec(destDataTypeId),
+			indent); // ConversionException
+}
+
+UaVariant * ConverterUa2IOPrivate::convertIoStructure2ua(const Structure& value,
+		const StructureCodec& codec,
+		OpcUa_Int16 indent) /* throws ConversionException */{
+	const UaStructureDefinition& sd = codec.definition;
 	if (log->isTraceEnabled()) {
 		char ind[indent + 1];
 		memset(ind, ' ', indent);
@@ -1113,90 +1673,130 @@ UaVariant * ConverterUa2IOPrivate::convertIoStructure2ua(const Structure& value,
 				sd.isUnion());
 	}
 	UaExtensionObject eo;
-	if (sd.isUnion()) {
+	if (codec.isUnion) {
 		UaGenericUnionValue uv(sd);
-		if (fieldData.size() > 1) {
+		if (value.getFieldCount() > 1) {
 			std::ostringstream msg;
 			msg << "Cannot convert Structure of type "
-					<< destDataTypeId.toXmlString().toUtf8()
+					<< sd.dataTypeId().toXmlString().toUtf8()
 					<< " due to too many values for a union type: "
-					<< fieldData.size();
+					<< value.getFieldCount();
 			throw ExceptionDef(ConversionException, msg.str());
 		}
-		if (fieldData.size() == 1) {
-			std::map<std::string, const Variant*>::const_iterator fieldValueIter =
-					fieldData.begin();
-			UaString fieldName(fieldValueIter->first.c_str());
-			bool found = false;
-			// for each union field
-			for (int j = 0; j < sd.childrenCount(); j++) {
-				UaStructureField sf = sd.child(j);
-				// if union field for value
-				if (sf.name() == fieldName) {
-					// convert value from Variant to UaVariant
-					UaVariant* fieldValue = convertIoStructureField2ua(sf,
-							*fieldValueIter->second, indent + 1); // ConversionException
-					// set value to union field
-					uv.setValue(sf.name(), *fieldValue);
-					delete fieldValue;
-
-					found = true;
-					break;
-				}
-			}
-			if (!found) {
+		if (value.getFieldCount() == 1) {
+			const Structure::Field& unionField = value.getField(0);
+			int fieldIndex = codec.getFieldIndex(unionField.name);
+			if (fieldIndex < 0) {
 				throw ExceptionDef(ConversionException,
 						std::string("Cannot convert Structure of type ").append(
-								destDataTypeId.toXmlString().toUtf8()).append(
+								sd.dataTypeId().toXmlString().toUtf8()).append(
 								" due to missing union field ").append(
-								fieldName.toUtf8()));
-			}
+								unionField.name));
+			}
+			const StructureCodec::Field& field = codec.fields[fieldIndex];
+			// convert value from Variant to UaVariant
+			UaVariant* fieldValue = convertIoStructureField2ua(field,
+					*unionField.value, indent + 1); // ConversionException
+			// set value to union field (switch value: position + 1)
+			uv.setValue(field.index + 1, *fieldValue);
+			delete fieldValue;
 		}
 		uv.toExtensionObject(eo);
 	} else {
 		UaGenericStructureValue sv(sd);
-		// for each field
-		for (int j = 0; j < sd.childrenCount(); j++) {
-			UaStructureField sf = sd.child(j);
-			std::string fieldName(sf.name().toUtf8());
-			std::map<std::string, const Variant*>::const_iterator fieldValueIter =
-					fieldData.find(fieldName);
-			if (!sf.isOptional() && fieldValueIter == fieldData.end()) {
-				throw ExceptionDef(ConversionException,
-						std::string("Cannot convert Structure of type ").append(
-								destDataTypeId.toXmlString().toUtf8()).append(
-								" due to missing value for mandatory field ").append(
-								sf.name().toUtf8()));
-			}
-			if (fieldValueIter != fieldData.end()) {
-				// convert value from Variant to UaVariant
-				UaVariant* fieldValue = convertIoStructureField2ua(sf,
-						*fieldValueIter->second, indent + 1); // ConversionException
-				// set value to field
-				sv.setField(sf.name(), *fieldValue);
-				delete fieldValue;
+		// assign the values to the fields of the definition: the fields of a structure
+		// created by a converter are provided in the order of the definition, else
+		// (e.g. the fields of a Java map) the position is looked up via the codec
+		std::vector<const Variant*> ioFieldValues(codec.fields.size(), NULL);
+		size_t nextFieldIndex = 0;
+		for (size_t i = 0; i < value.getFieldCount(); i++) {
+			const Structure::Field& ioField = value.getField(i);
+			int fieldIndex = nextFieldIndex < codec.fields.size()
+					&& codec.fields[nextFieldIndex].name == ioField.name ?
+					static_cast<int> (nextFieldIndex) : codec.getFieldIndex(ioField.name);
+			// fields which are not part of the definition are ignored
+			if (fieldIndex >= 0) {
+				if (ioFieldValues[fieldIndex] == NULL) {
+					ioFieldValues[fieldIndex] = ioField.value;
+				}
+				nextFieldIndex = fieldIndex + 1;
 			}
 		}
+		// for each field in the order of the definition
+		for (std::vector<StructureCodec::Field>::const_iterator j = codec.fields.begin();
+				j != codec.fields.end(); j++) {
+			const StructureCodec::Field& field = *j;
+			const Variant* ioFieldValue = ioFieldValues[field.index];
+			if (ioFieldValue == NULL) {
+				if (!field.isOptional) {
+					throw ExceptionDef(ConversionException,
+							std::string("Cannot convert Structure of type ").append(
+									sd.dataTypeId().toXmlString().toUtf8()).append(
+									" due to missing value for mandatory field ").append(
+									field.name));
+				}
+				continue;
+			}
+			// convert value from Variant to UaVariant
+			UaVariant* fieldValue = convertIoStructureField2ua(field,
+					*ioFieldValue, indent + 1); // ConversionException
+			// set value to field
+			sv.setField(field.index, *fieldValue);
+			delete fieldValue;
+		}
 		sv.toExtensionObject(eo);
 	}
 	UaVariant* ret = new UaVariant();
-	ret->setExtensionObject(eo, OpcUa_False /*detach*/);
+	ret->setExtensionObject(eo, OpcUa_True /*detach*/);
 	return ret;
 }
 
 UaVariant * ConverterUa2IOPrivate::convertIoStructureField2ua(
-		const UaStructureField& field, const Variant& value,
+		const StructureCodec::Field& field, const Variant& value,
 		OpcUa_Int16 indent) /* throws ConversionException */{
 	if (log->isTraceEnabled()) {
 		char ind[indent + 1];
 		memset(ind, ' ', indent);
 		ind[indent] = 0;
 		log->trace("< %sfield name=%s,dataTypeId=%s,isOptional=%d,arrayType=%d",
-				ind, field.name().toUtf8(),
-				field.typeId().toXmlString().toUtf8(), field.isOptional(),
-				field.arrayType());
+				ind, field.name.c_str(),
+				field.field.typeId().toXmlString().toUtf8(), field.isOptional,
+				field.field.arrayType());
+	}
+	UaVariant* fieldValue;
+	switch (value.getVariantType()) {
+	case Variant::STRUCTURE:
+		if (field.codec != NULL) {
+			// nested structure: use the codec of the field
+			fieldValue = convertIoStructure2ua(static_cast<const Structure&>(value),
+					*field.codec, indent); // ConversionException
+			break;
+		}
+		fieldValue = convertIo2ua(value, field.field.typeId(), indent); // ConversionException
+		break;
+	case Variant::SCALAR:
+		if (field.buildInDataTypeId.isNull()) {
+			fieldValue = convertIo2ua(value, field.field.typeId(), indent); // ConversionException
+			break;
+		}
+		if (field.io2uaConverter != NULL && static_cast<const Scalar&>(value).getScalarType()
+				== field.ioScalarType) {
+			// the converter of the field has been resolved by the codec
+			fieldValue = new UaVariant();
+			ScopeGuard<UaVariant> fieldValueSG(fieldValue);
+			field.io2uaConverter(static_cast<const Scalar&>(value),
+					*fieldValue); // ConversionException
+			fieldValueSG.detach();
+			break;
+		}
+		// the built-in type of the field has been resolved by the codec
+		fieldValue = convertIoScalar2ua(static_cast<const Scalar&>(value),
+				field.buildInDataTypeId, indent); // ConversionException
+		break;
+	default:
+		fieldValue = convertIo2ua(value, field.field.typeId(), indent); // ConversionException
+		break;
 	}
-	UaVariant* fieldValue = convertIo2ua(value, field.typeId(), indent); // ConversionException
 	if (log->isTraceEnabled()) {
 		char ind[indent + 1];
 		memset(ind, ' ', indent);
@@ -1211,81 +1811,25 @@ UaVariant * ConverterUa2IOPrivate::convertIoArray2ua(const Array& value,
 		const UaNodeId& destDataTypeId, OpcUa_Int16 indent)
 		/* throws ConversionException */{
 
-	// InternalInterface - OPC UA
-	// long[]            - int32[]/uint16[]/enum[]
-	// ulong[]           - uint32[]
-	// llong[]           - uint32[]
-	// string[]          - string[]/localizedText[]
-	// localizedText[]   - localizedText[]
-
-	if (value.getElements() == NULL) {
+	// check the contiguous values first: getElements would create the elements
+	if (value.getValues() == NULL && value.getElements() == NULL) {
 		throw ExceptionDef(ConversionException,
 				std::string("A null array cannot be converted to UaVariant"));
 	}
 	UaVariant* ret = NULL;
-	switch (value.getArrayType()) {
-	case Variant::STRUCTURE:
+	if (value.getArrayType() == Variant::STRUCTURE) {
 		ret = convertIoArray2uaStructureArray(value, destDataTypeId, indent);
-		break;
-	default:
+	} else {
 		UaNodeId buildInDataTypeId = getBuildInType(destDataTypeId); // ConversionException
-		switch (value.getArrayType()) {
-		case Scalar::LONG: {
-			switch (buildInDataTypeId.identifierNumeric()) {
-			case OpcUaType_Int32:
-			case OpcUaId_Enumeration:
-				ret = convertIoArray2uaInt32Array(value, indent);
-				break;
-			case OpcUaType_UInt16:
-				ret = convertIoArray2uaUInt16Array(value, indent);
-				break;
-			}
-			break;
-		}
-		case Scalar::ULONG: {
-			switch (buildInDataTypeId.identifierNumeric()) {
-			case OpcUaType_UInt32:
-				ret = convertIoArray2uaUInt32Array(value, indent);
-				break;
-			}
-			break;
-		}
-		case Scalar::LLONG: {
-			switch (buildInDataTypeId.identifierNumeric()) {
-			case OpcUaType_Int64:
-				//TODO
-				break;
-			case OpcUaType_UInt32:
-				ret = convertIoArray2uaUInt32Array(value, indent);
-				break;
-			case OpcUaType_DateTime:
-			case OpcUaId_UtcTime:
-				//TODO
-				break;
-			}
-			break;
-		}
-		case Scalar::STRING: {
-			switch (buildInDataTypeId.identifierNumeric()) {
-			case OpcUaType_String:
-				ret = convertIoArray2uaStringArray(value, indent);
-				break;
-			case OpcUaType_LocalizedText:
-				ret = convertIoArray2uaLocalizedTextArray(value, indent);
-				break;
-			}
-			break;
-		}
-		case Scalar::LOCALIZED_TEXT: {
-			switch (buildInDataTypeId.identifierNumeric()) {
-			case OpcUaType_LocalizedText:
-				ret = convertIoArray2uaLocalizedTextArray(value, indent);
-				break;
+		const ScalarConversion* conversion = getConversion(value.getArrayType(),
+				getUaValueType(buildInDataTypeId.identifierNumeric()));
+		if (conversion != NULL) {
+			IoArray2uaConverter convert = value.getValues() != NULL
+					? conversion->io2uaValues : conversion->io2uaElements;
+			if (convert != NULL) {
+				ret = convert(value);
 			}
-			break;
-		}
 		}
-		break;
 	}
 	if (ret == NULL) {
 		std::ostringstream msg;
@@ -1297,92 +1841,83 @@ UaVariant * ConverterUa2IOPrivate::convertIoArray2ua(const Array& value,
 	return ret;
 }
 
-UaVariant * ConverterUa2IOPrivate::convertIoArray2uaStructureArray(
-		const Array& value, const UaNodeId& destDataTypeId, OpcUa_Int16 indent)
-		/* throws ConversionException */{
-	const std::vector<const Variant*>* elements = value.getElements();
-	UaExtensionObjectArray array;
-	array.create(elements->size());
-	// for each array element
-	for (int i = 0; i < elements->size(); i++) {
-		const Structure& elem = *static_cast<const Structure*>((*elements)[i]);
-		UaVariant* v = convertIoStructure2ua(elem, destDataTypeId, indent + 1); // ConversionException
-		UaExtensionObject eo;
-		v->toExtensionObject(eo);
-		eo.copyTo(&array[i]);
-		delete v;
+template<int BuildInType> UaVariant* ConverterUa2IOPrivate::copyIoValues(
+		const Array& value) {
+	typedef BuildInTypeTraits<BuildInType> Traits;
+	typename Traits::ArrayType array;
+	array.create(value.getLength());
+	if (value.getLength() > 0) {
+		memcpy(&array[0], value.getValues(), value.getLength() * sizeof (array[0]));
 	}
 	UaVariant* ret = new UaVariant();
-	ret->setExtensionObjectArray(array, OpcUa_True /*detach*/);
+	Traits::setArray(*ret, array);
 	return ret;
 }
 
-UaVariant * ConverterUa2IOPrivate::convertIoArray2uaUInt16Array(
-		const Array& value,
-		OpcUa_Int16 indent) /* throws ConversionException */{
-	const std::vector<const Variant*>* elements = value.getElements();
-	UaUInt16Array array;
-	array.create(elements->size());
-	// for each array element
-	for (int i = 0; i < elements->size(); i++) {
-		const Scalar& elem = *static_cast<const Scalar*>((*elements)[i]);
-		switch (value.getArrayType()) {
-		case Scalar::LONG:
-			array[i] = static_cast<OpcUa_UInt16>(elem.getLong());
-			break;
-		}
+UaVariant* ConverterUa2IOPrivate::copyIoChars2uaByteArray(const Array& value) {
+	UaByteArray array(static_cast<const char*>(value.getValues()), value.getLength());
+	UaVariant* ret = new UaVariant();
+	ret->setByteArray(array, OpcUa_True /*detach*/);
+	return ret;
+}
+
+template<int ScalarType, int BuildInType> UaVariant* ConverterUa2IOPrivate::convertIoValues(
+		const Array& value) {
+	typedef BuildInTypeTraits<BuildInType> Traits;
+	unsigned long length = value.getLength();
+	typename Traits::ArrayType array;
+	array.create(length);
+	const typename ScalarTraits<ScalarType>::ElementType* values =
+			static_cast<const typename ScalarTraits<ScalarType>::ElementType*>(
+					value.getValues());
+	// a simple loop which can be vectorized by the compiler
+	for (unsigned long i = 0; i < length; i++) {
+		array[i] = values[i];
 	}
 	UaVariant* ret = new UaVariant();
-	ret->setUInt16Array(array, OpcUa_True /*detach*/);
+	Traits::setArray(*ret, array);
 	return ret;
 }
 
-UaVariant * ConverterUa2IOPrivate::convertIoArray2uaInt32Array(
-		const Array& value,
-		OpcUa_Int16 indent) /* throws ConversionException */{
+UaVariant * ConverterUa2IOPrivate::convertIoArray2uaStructureArray(
+		const Array& value, const UaNodeId& destDataTypeId, OpcUa_Int16 indent)
+		/* throws ConversionException */{
 	const std::vector<const Variant*>* elements = value.getElements();
-	UaInt32Array array;
+	const StructureCodec& codec = getStructureCodec(destDataTypeId); // ConversionException
+	UaExtensionObjectArray array;
 	array.create(elements->size());
 	// for each array element
 	for (int i = 0; i < elements->size(); i++) {
-		const Scalar& elem = *static_cast<const Scalar*>((*elements)[i]);
-		switch (value.getArrayType()) {
-		case Scalar::LONG:
-			array[i] = static_cast<OpcUa_Int32>(elem.getLong());
-			break;
-		}
+		const Structure& elem = *static_cast<const Structure*>((*elements)[i]);
+		UaVariant* v = convertIoStructure2ua(elem, codec, indent + 1); // ConversionException
+		UaExtensionObject eo;
+		v->toExtensionObject(eo);
+		eo.copyTo(&array[i]);
+		delete v;
 	}
 	UaVariant* ret = new UaVariant();
-	ret->setInt32Array(array, OpcUa_True /*detach*/);
+	ret->setExtensionObjectArray(array, OpcUa_True /*detach*/);
 	return ret;
 }
 
-UaVariant * ConverterUa2IOPrivate::convertIoArray2uaUInt32Array(
-		const Array& value,
-		OpcUa_Int16 indent) /* throws ConversionException */{
-	const std::vector<const Variant*>* elements = value.getElements();
-	UaUInt32Array array;
-	array.create(elements->size());
+template<int ScalarType, int BuildInType> UaVariant* ConverterUa2IOPrivate::convertIoElements2ua(
+		const Array& value) {
+	typedef BuildInTypeTraits<BuildInType> Traits;
+	const std::vector<const Variant*>& elements = *value.getElements();
+	typename Traits::ArrayType array;
+	array.create(elements.size());
 	// for each array element
-	for (int i = 0; i < elements->size(); i++) {
-		const Scalar& elem = *static_cast<const Scalar*>((*elements)[i]);
-		switch (value.getArrayType()) {
-		case Scalar::ULONG:
-			array[i] = static_cast<OpcUa_UInt32>(elem.getULong());
-			break;
-		case Scalar::LLONG:
-			array[i] = static_cast<OpcUa_UInt32>(elem.getLLong());
-			break;
-		}
+	for (size_t i = 0; i < elements.size(); i++) {
+		const Scalar& elem = *static_cast<const Scalar*>(elements[i]);
+		array[i] = static_cast<typename Traits::Type>(ScalarTraits<ScalarType>::get(elem));
 	}
 	UaVariant* ret = new UaVariant();
-	ret->setUInt32Array(array, OpcUa_True /*detach*/);
+	Traits::setArray(*ret, array);
 	return ret;
 }
 
 UaVariant * ConverterUa2IOPrivate::convertIoArray2uaStringArray(
-		const Array& value,
-		OpcUa_Int16 indent) /* throws ConversionException */{
+		const Array& value) {
 	const std::vector<const Variant*>* elements = value.getElements();
 	UaStringArray array;
 	array.create(elements->size());
@@ -1402,8 +1937,7 @@ UaVariant * ConverterUa2IOPrivate::convertIoArray2uaStringArray(
 }
 
 UaVariant * ConverterUa2IOPrivate::convertIoArray2uaLocalizedTextArray(
-		const Array& value,
-		OpcUa_Int16 indent) /* throws ConversionException */{
+		const Array& value) {
 	const std::vector<const Variant*>* elements = value.getElements();
 	UaLocalizedTextArray array;
 	array.create(elements->size());
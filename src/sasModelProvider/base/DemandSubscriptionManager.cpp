@@ -0,0 +1,336 @@
+#include <sasModelProvider/base/DemandSubscriptionManager.h>
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <pthread.h> // pthread_t
+#include <time.h> // clock_gettime
+#include <map>
+#include <set>
+#include <string>
+#include <string.h> // memset
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace SASModelProviderNamespace {
+
+    class DemandSubscriptionManagerPrivate {
+        friend class DemandSubscriptionManager;
+    private:
+
+        class Node {
+        public:
+            NodeId* nodeId;
+            // count of monitored items
+            int monitoredItemCount;
+            bool isSubscribed;
+        };
+
+        Logger* log;
+
+        IODataProvider* ioDataProvider;
+        SubscriberCallback* subscriberCallback;
+        long debounceTime;
+        DemandSubscriptionManager::StatusCallback* statusCallback;
+
+        // protects the nodes, the metrics and the state of the subscribing thread
+        pthread_mutex_t mutex;
+        pthread_cond_t cond;
+        // serializes the provider calls to keep the order of the changes
+        pthread_mutex_t callMutex;
+        pthread_t thread;
+        bool isClosed;
+
+        typedef std::map<NodeId, Node, NodeId::Less> Nodes;
+        typedef std::set<NodeId, NodeId::Less> NodeIds;
+
+        // nodeId -> node
+        Nodes nodes;
+        // nodeIds of nodes with changed monitored item counts
+        NodeIds pending;
+        // time of the first pending change
+        timespec firstChangeTime;
+
+        DemandSubscriptionManager::Metrics metrics;
+
+        static void* run(void* object);
+        // Adds a change of the monitored item count of a node.
+        void change(const NodeId& nodeId, int delta);
+        // Sends the pending changes to the IO data provider.
+        // The call mutex must be locked by the caller.
+        void sendChanges();
+        // Gets the time when the pending changes must be sent.
+        timespec getSendTime();
+    };
+
+    DemandSubscriptionManager::StatusCallback::StatusCallback() {
+    }
+
+    DemandSubscriptionManager::StatusCallback::~StatusCallback() {
+    }
+
+    DemandSubscriptionManager::DemandSubscriptionManager(IODataProvider& ioDataProvider,
+            SubscriberCallback& subscriberCallback, long debounceTime,
+            StatusCallback* statusCallback) /* throws MutexException */ {
+        d = new DemandSubscriptionManagerPrivate();
+        d->log = LoggerFactory::getLogger("DemandSubscriptionManager");
+        d->ioDataProvider = &ioDataProvider;
+        d->subscriberCallback = &subscriberCallback;
+        d->debounceTime = debounceTime;
+        d->statusCallback = statusCallback;
+        d->isClosed = false;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0
+                || pthread_mutex_init(&d->callMutex, NULL /*attr*/) != 0
+                || pthread_cond_init(&d->cond, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException,
+                    "Cannot initialize mutex for demand subscription manager");
+        }
+        if (pthread_create(&d->thread, NULL /*attr*/, &DemandSubscriptionManagerPrivate::run,
+                d) != 0) {
+            pthread_cond_destroy(&d->cond);
+            pthread_mutex_destroy(&d->callMutex);
+            pthread_mutex_destroy(&d->mutex);
+            delete d;
+            throw ExceptionDef(MutexException,
+                    "Cannot start thread for demand subscription manager");
+        }
+    }
+
+    DemandSubscriptionManager::~DemandSubscriptionManager() {
+        // stop the subscribing thread
+        pthread_mutex_lock(&d->mutex);
+        d->isClosed = true;
+        pthread_cond_signal(&d->cond);
+        pthread_mutex_unlock(&d->mutex);
+        pthread_join(d->thread, NULL /*return*/);
+        for (DemandSubscriptionManagerPrivate::Nodes::iterator i =
+                d->nodes.begin(); i != d->nodes.end(); i++) {
+            delete (*i).second.nodeId;
+        }
+        pthread_cond_destroy(&d->cond);
+        pthread_mutex_destroy(&d->callMutex);
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    void DemandSubscriptionManager::monitoringStarted(const NodeId& nodeId) {
+        d->change(nodeId, 1);
+    }
+
+    void DemandSubscriptionManager::monitoringStopped(const NodeId& nodeId) {
+        d->change(nodeId, -1);
+    }
+
+    void DemandSubscriptionManager::flush() {
+        pthread_mutex_lock(&d->callMutex);
+        d->sendChanges();
+        pthread_mutex_unlock(&d->callMutex);
+    }
+
+    bool DemandSubscriptionManager::isSubscribed(const NodeId& nodeId) {
+        pthread_mutex_lock(&d->mutex);
+        DemandSubscriptionManagerPrivate::Nodes::iterator i =
+                d->nodes.find(nodeId);
+        bool ret = i != d->nodes.end() && (*i).second.isSubscribed;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    int DemandSubscriptionManager::getPendingCount() {
+        pthread_mutex_lock(&d->mutex);
+        int ret = d->pending.size();
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    DemandSubscriptionManager::Metrics DemandSubscriptionManager::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void DemandSubscriptionManagerPrivate::change(const NodeId& nodeId, int delta) {
+        pthread_mutex_lock(&mutex);
+        Nodes::iterator i = nodes.find(nodeId);
+        if (i == nodes.end()) {
+            Node node;
+            node.nodeId = new NodeId(nodeId);
+            node.monitoredItemCount = 0;
+            node.isSubscribed = false;
+            i = nodes.insert(std::make_pair(nodeId, node)).first;
+        }
+        Node& node = (*i).second;
+        int oldCount = node.monitoredItemCount;
+        node.monitoredItemCount += delta;
+        if (node.monitoredItemCount < 0) {
+            // stop without begin
+            node.monitoredItemCount = 0;
+        }
+        // if the node must be subscribed or unsubscribed
+        // (a failed subscription is retried with the next begin of a monitored item)
+        if ((oldCount == 0) != (node.monitoredItemCount == 0)
+                || (delta > 0 && !node.isSubscribed)) {
+            if (pending.size() == 0) {
+                clock_gettime(CLOCK_REALTIME, &firstChangeTime);
+                pthread_cond_signal(&cond);
+            }
+            pending.insert(nodeId);
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void* DemandSubscriptionManagerPrivate::run(void* object) {
+        DemandSubscriptionManagerPrivate& d =
+                *static_cast<DemandSubscriptionManagerPrivate*> (object);
+        pthread_mutex_lock(&d.mutex);
+        while (!d.isClosed) {
+            if (d.pending.size() == 0) {
+                pthread_cond_wait(&d.cond, &d.mutex);
+                continue;
+            }
+            timespec sendTime = d.getSendTime();
+            if (pthread_cond_timedwait(&d.cond, &d.mutex, &sendTime) == 0) {
+                // the changes have been modified or the manager has been closed
+                // => check the state again
+                continue;
+            }
+            pthread_mutex_unlock(&d.mutex);
+            pthread_mutex_lock(&d.callMutex);
+            d.sendChanges();
+            pthread_mutex_unlock(&d.callMutex);
+            pthread_mutex_lock(&d.mutex);
+        }
+        pthread_mutex_unlock(&d.mutex);
+        return NULL;
+    }
+
+    void DemandSubscriptionManagerPrivate::sendChanges() {
+        // the node ids are owned by the nodes which are not removed while
+        // the call mutex is locked
+        std::vector<const NodeId*> subscribeNodeIds;
+        std::vector<const NodeId*> unsubscribeNodeIds;
+        pthread_mutex_lock(&mutex);
+        for (NodeIds::iterator i = pending.begin(); i != pending.end(); i++) {
+            Node& node = nodes[*i];
+            if (node.monitoredItemCount > 0 && !node.isSubscribed) {
+                node.isSubscribed = true;
+                subscribeNodeIds.push_back(node.nodeId);
+            } else if (node.monitoredItemCount == 0 && node.isSubscribed) {
+                node.isSubscribed = false;
+                unsubscribeNodeIds.push_back(node.nodeId);
+            } else {
+                // the change has been reverted
+                metrics.debouncedCount++;
+            }
+        }
+        pending.clear();
+        pthread_mutex_unlock(&mutex);
+
+        if (unsubscribeNodeIds.size() > 0) {
+            try {
+                ioDataProvider->unsubscribe(unsubscribeNodeIds); // IODataProviderException
+            } catch (Exception& e) {
+                IODataProviderException ex = ExceptionDef(IODataProviderException,
+                        std::string("Cannot unsubscribe nodes at IO data provider"));
+                ex.setCause(&e);
+                if (statusCallback != NULL) {
+                    statusCallback->subscriptionFailed(unsubscribeNodeIds,
+                            false /* isSubscribe */, ex);
+                } else {
+                    std::string st;
+                    ex.getStackTrace(st);
+                    log->error("Exception while unsubscribing nodes: %s", st.c_str());
+                }
+            }
+        }
+        NodeIds failedNodeIds;
+        if (subscribeNodeIds.size() > 0) {
+            try {
+                std::vector<NodeData*>* results = ioDataProvider->subscribe(subscribeNodeIds,
+                        *subscriberCallback); // IODataProviderException
+                VectorScopeGuard<NodeData> resultsSG(results);
+                if (results != NULL) {
+                    for (std::vector<NodeData*>::iterator i = results->begin();
+                            i != results->end(); i++) {
+                        if ((*i)->hasError()) {
+                            failedNodeIds.insert((*i)->getNodeId());
+                        }
+                    }
+                    if (statusCallback != NULL) {
+                        statusCallback->subscribed(*results);
+                    }
+                }
+            } catch (Exception& e) {
+                for (std::vector<const NodeId*>::iterator i = subscribeNodeIds.begin();
+                        i != subscribeNodeIds.end(); i++) {
+                    failedNodeIds.insert(**i);
+                }
+                IODataProviderException ex = ExceptionDef(IODataProviderException,
+                        std::string("Cannot subscribe nodes at IO data provider"));
+                ex.setCause(&e);
+                if (statusCallback != NULL) {
+                    statusCallback->subscriptionFailed(subscribeNodeIds,
+                            true /* isSubscribe */, ex);
+                } else {
+                    std::string st;
+                    ex.getStackTrace(st);
+                    log->error("Exception while subscribing nodes: %s", st.c_str());
+                }
+            }
+        }
+
+        pthread_mutex_lock(&mutex);
+        // failed subscriptions are retried with the next begin of a monitored item
+        for (NodeIds::iterator i = failedNodeIds.begin();
+                i != failedNodeIds.end(); i++) {
+            Nodes::iterator node = nodes.find(*i);
+            if (node != nodes.end()) {
+                (*node).second.isSubscribed = false;
+            }
+        }
+        // remove unused nodes
+        for (std::vector<const NodeId*>::iterator i = unsubscribeNodeIds.begin();
+                i != unsubscribeNodeIds.end(); i++) {
+            Nodes::iterator node = nodes.find(**i);
+            if (node != nodes.end() && (*node).second.monitoredItemCount == 0
+                    && pending.find((*node).first) == pending.end()) {
+                delete (*node).second.nodeId;
+                nodes.erase(node);
+            }
+        }
+        if (subscribeNodeIds.size() > 0) {
+            metrics.subscribeCallCount++;
+            metrics.subscribedNodeCount += subscribeNodeIds.size();
+        }
+        if (unsubscribeNodeIds.size() > 0) {
+            metrics.unsubscribeCallCount++;
+            metrics.unsubscribedNodeCount += unsubscribeNodeIds.size();
+        }
+        pthread_mutex_unlock(&mutex);
+        if (log->isDebugEnabled() && (subscribeNodeIds.size() > 0
+                || unsubscribeNodeIds.size() > 0)) {
+            log->debug("Subscribed %lu nodes, unsubscribed %lu nodes at IO data provider",
+                    subscribeNodeIds.size(), unsubscribeNodeIds.size());
+        }
+    }
+
+    timespec DemandSubscriptionManagerPrivate::getSendTime() {
+        timespec ret = firstChangeTime;
+        ret.tv_sec += debounceTime / 1000;
+        ret.tv_nsec += (debounceTime % 1000) * 1000000;
+        if (ret.tv_nsec >= 1000000000) {
+            ret.tv_sec++;
+            ret.tv_nsec -= 1000000000;
+        }
+        return ret;
+    }
+
+} // namespace SASModelProviderNamespace
@@ -2,8 +2,8 @@
 #include "common/Exception.h"
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
-#include <map>
 #include <sstream>
+#include <vector>
 
 using namespace CommonNamespace;
 
@@ -14,7 +14,18 @@ namespace SASModelProviderNamespace {
     private:
         Logger* log;
         EventTypeRegistry* eventTypeRegistry;
-        std::map<UaNodeId, UaVariant> fieldData;
+        UaNodeId eventTypeNodeId;
+        // index of the event type in the registry
+        int eventTypeIndex;
+        // field index => field data
+        std::vector<UaVariant> fieldData;
+        // field index => whether data have been added for the field
+        std::vector<bool> hasFieldData;
+
+        // Gets the slot for a field. The slots are extended if fields have been registered
+        // after the creation of the event.
+        UaVariant* getSlot(const UaNodeId& fieldNodeId);
+        UaVariant& getSlot(int index);
     };
 
     EventTypeData::EventTypeData(const UaNodeId& eventTypeNodeId,
@@ -24,40 +35,94 @@ namespace SASModelProviderNamespace {
         m_EventTypeId.setNodeId(eventTypeNodeId.identifierNumeric(),
                 eventTypeNodeId.namespaceIndex());
         d->eventTypeRegistry = &eventTypeRegistry;
+        d->eventTypeNodeId = eventTypeNodeId;
+        d->eventTypeIndex = eventTypeRegistry.getEventTypeIndex(m_EventTypeId);
+        // preallocate the slots for the registered fields
+        OpcUa_UInt32 fieldCount = eventTypeRegistry.getEventFieldCount(d->eventTypeIndex);
+        d->fieldData.resize(fieldCount);
+        d->hasFieldData.resize(fieldCount, false);
     }
 
     EventTypeData::~EventTypeData() {
         delete d;
     }
 
+    const UaNodeId& EventTypeData::getEventTypeNodeId() const {
+        return d->eventTypeNodeId;
+    }
+
     void EventTypeData::addFieldData(const UaNodeId& fieldNodeId,
             const UaVariant& data) {
-        d->fieldData[fieldNodeId] = data;
+        UaVariant* slot = d->getSlot(fieldNodeId);
+        if (slot != NULL) {
+            *slot = data;
+        }
+    }
+
+    bool EventTypeData::moveFieldData(const UaNodeId& fieldNodeId, UaVariant& data) {
+        UaVariant* slot = d->getSlot(fieldNodeId);
+        if (slot == NULL) {
+            return false;
+        }
+        OpcUa_Variant value;
+        data.detach(&value);
+        slot->attach(&value);
+        return true;
+    }
+
+    UaVariant& EventTypeData::getFieldSlot(int fieldIndex) {
+        return d->getSlot(fieldIndex);
+    }
+
+    void EventTypeData::clear() {
+        for (size_t i = 0; i < d->fieldData.size(); i++) {
+            if (d->hasFieldData[i]) {
+                d->fieldData[i].clear();
+                d->hasFieldData[i] = false;
+            }
+        }
     }
 
     void EventTypeData::getFieldData(OpcUa_UInt32 index, Session* pSession, OpcUa_Variant& data) {
+        if (index < d->fieldData.size() && d->hasFieldData[index]) {
+            // return data
+            d->fieldData[index].copyTo(&data);
+            return;
+        }
         // get nodeId for field index from event field registry
-        const UaNodeId* nodeId = d->eventTypeRegistry->getEventFieldNodeId(m_EventTypeId, index);
-        if (nodeId == NULL) {
+        UaNodeId nodeId = d->eventTypeRegistry->getEventFieldNodeId(d->eventTypeIndex, index);
+        if (nodeId.isNull()) {
             BaseEventTypeData::getFieldData(index, pSession, data);
             return;
         }
-        // get data for nodeId
-        std::map<UaNodeId, UaVariant>::iterator fieldDataIter = d->fieldData.find(
-                *nodeId);
-        if (fieldDataIter == d->fieldData.end()) {
-            std::ostringstream msg;
-            msg << "Missing data for event field " << nodeId->toXmlString().toUtf8();
-            Exception e = ExceptionDef(Exception, msg.str());
-            // there is no way to inform the OPC UA server about details => log the exception
-            std::string st;
-            e.getStackTrace(st);
-            d->log->error("Exception while getting field data: %s", st.c_str());
-            return;
+        std::ostringstream msg;
+        msg << "Missing data for event field " << nodeId.toXmlString().toUtf8();
+        Exception e = ExceptionDef(Exception, msg.str());
+        // there is no way to inform the OPC UA server about details => log the exception
+        std::string st;
+        e.getStackTrace(st);
+        d->log->error("Exception while getting field data: %s", st.c_str());
+    }
+
+    UaVariant* EventTypeDataPrivate::getSlot(const UaNodeId& fieldNodeId) {
+        int index = eventTypeRegistry->getEventFieldIndex(eventTypeIndex, fieldNodeId);
+        if (index < 0) {
+            if (log->isDebugEnabled()) {
+                log->debug("Skipping data of unregistered event field %s",
+                        fieldNodeId.toXmlString().toUtf8());
+            }
+            return NULL;
+        }
+        return &getSlot(index);
+    }
+
+    UaVariant& EventTypeDataPrivate::getSlot(int index) {
+        if (index >= fieldData.size()) {
+            fieldData.resize(index + 1);
+            hasFieldData.resize(index + 1, false);
         }
-        UaVariant& fieldData = fieldDataIter->second;
-        // return data
-        fieldData.copyTo(&data);
+        hasFieldData[index] = true;
+        return fieldData[index];
     }
 
 } // namespace SASModelProviderNamespace
@@ -11,20 +11,38 @@ namespace SASModelProviderNamespace {
 
     class EventTypeDataPrivate;
 
+    // The field data are held in slots indexed by the field index of the event type registry.
+    // An instance can be reused for further events of the same type after calling "clear"
+    // (see EventTypeDataPool).
     class EventTypeData : public BaseEventTypeData {
     public:
         EventTypeData(const UaNodeId& eventTypeNodeId, EventTypeRegistry& eventTypeRegistry);
         virtual ~EventTypeData();
 
+        virtual const UaNodeId& getEventTypeNodeId() const;
+
         // Adds data for a field.
         // Copies of the parameter values are stored internally.
         virtual void addFieldData(const UaNodeId& fieldNodeId,
                 const UaVariant& data);
+        // Adds data for a field.
+        // The data are moved to the event: the passed variant is empty afterwards.
+        // Returns false if the field has not been registered for the event type.
+        virtual bool moveFieldData(const UaNodeId& fieldNodeId, UaVariant& data);
+        // Returns the slot for the data of a field with its index in the event type registry
+        // (see EventTypeRegistry::getEventFieldIndex). The data can be written directly to
+        // the slot.
+        virtual UaVariant& getFieldSlot(int fieldIndex);
+        // Removes the field data for reusing the instance.
+        virtual void clear();
 
         // interface BaseEventTypeData
         virtual void getFieldData(OpcUa_UInt32 index, Session* pSession,
                 OpcUa_Variant& data);
     private:
+        EventTypeData(const EventTypeData&);
+        EventTypeData& operator=(const EventTypeData&);
+
         EventTypeDataPrivate* d;
     };
 
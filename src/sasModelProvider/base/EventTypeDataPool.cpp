@@ -0,0 +1,151 @@
+#include <sasModelProvider/base/EventTypeDataPool.h>
+#include "EventTypeData.h"
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <pthread.h> // pthread_mutex_t
+#include <map>
+#include <string.h> // memset
+#include <vector>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace SASModelProviderNamespace {
+
+    class EventTypeDataPoolPrivate {
+        friend class EventTypeDataPool;
+    private:
+        EventTypeRegistry* eventTypeRegistry;
+        int maxIdleCount;
+
+        // IO field id => field
+        typedef std::map<NodeId, EventTypeDataPool::Field*, NodeId::Less> Fields;
+
+        // protects the idle event objects, the fields and the metrics
+        pthread_mutex_t mutex;
+        // event type => unused event objects
+        std::map<UaNodeId, std::vector<EventTypeData*> > idleEvents;
+        // event type => cached fields (the fields are never changed or removed)
+        std::map<UaNodeId, Fields> fields;
+
+        EventTypeDataPool::Metrics metrics;
+    };
+
+    EventTypeDataPool::EventTypeDataPool(EventTypeRegistry& eventTypeRegistry, int maxIdleCount)
+    /* throws MutexException */ {
+        d = new EventTypeDataPoolPrivate();
+        d->eventTypeRegistry = &eventTypeRegistry;
+        d->maxIdleCount = maxIdleCount;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for event pool");
+        }
+    }
+
+    EventTypeDataPool::~EventTypeDataPool() {
+        for (std::map<UaNodeId, std::vector<EventTypeData*> >::iterator i =
+                d->idleEvents.begin(); i != d->idleEvents.end(); i++) {
+            std::vector<EventTypeData*>& events = (*i).second;
+            for (int j = 0; j < events.size(); j++) {
+                delete events[j];
+            }
+        }
+        for (std::map<UaNodeId, EventTypeDataPoolPrivate::Fields>::iterator i =
+                d->fields.begin(); i != d->fields.end(); i++) {
+            EventTypeDataPoolPrivate::Fields& fields = (*i).second;
+            for (EventTypeDataPoolPrivate::Fields::iterator j = fields.begin();
+                    j != fields.end(); j++) {
+                delete (*j).second;
+            }
+        }
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    EventTypeData* EventTypeDataPool::acquire(const UaNodeId& eventTypeNodeId) {
+        EventTypeData* ret = NULL;
+        pthread_mutex_lock(&d->mutex);
+        d->metrics.acquireCount++;
+        d->metrics.inUseCount++;
+        if (d->metrics.inUseCount > d->metrics.highWaterMark) {
+            d->metrics.highWaterMark = d->metrics.inUseCount;
+        }
+        std::map<UaNodeId, std::vector<EventTypeData*> >::iterator i =
+                d->idleEvents.find(eventTypeNodeId);
+        if (i != d->idleEvents.end() && !(*i).second.empty()) {
+            ret = (*i).second.back();
+            (*i).second.pop_back();
+            d->metrics.hitCount++;
+        }
+        pthread_mutex_unlock(&d->mutex);
+        if (ret == NULL) {
+            ret = new EventTypeData(eventTypeNodeId, *d->eventTypeRegistry);
+        }
+        return ret;
+    }
+
+    void EventTypeDataPool::release(EventTypeData* eventData) {
+        // remove the field data outside of the lock
+        eventData->clear();
+        pthread_mutex_lock(&d->mutex);
+        d->metrics.inUseCount--;
+        std::vector<EventTypeData*>& events = d->idleEvents[eventData->getEventTypeNodeId()];
+        if (events.size() < d->maxIdleCount) {
+            events.push_back(eventData);
+            eventData = NULL;
+        }
+        pthread_mutex_unlock(&d->mutex);
+        delete eventData;
+    }
+
+    const EventTypeDataPool::Field* EventTypeDataPool::getField(const UaNodeId& eventTypeNodeId,
+            const NodeId& ioFieldNodeId) {
+        const Field* ret = NULL;
+        pthread_mutex_lock(&d->mutex);
+        std::map<UaNodeId, EventTypeDataPoolPrivate::Fields>::iterator i =
+                d->fields.find(eventTypeNodeId);
+        if (i != d->fields.end()) {
+            EventTypeDataPoolPrivate::Fields::iterator j = (*i).second.find(ioFieldNodeId);
+            if (j != (*i).second.end()) {
+                ret = (*j).second;
+            }
+        }
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    const EventTypeDataPool::Field* EventTypeDataPool::addField(const UaNodeId& eventTypeNodeId,
+            const NodeId& ioFieldNodeId, const UaNodeId& fieldNodeId,
+            const UaNodeId& dataTypeId) {
+        // resolve the field outside of the lock
+        Field* field = new Field();
+        field->nodeId = fieldNodeId;
+        field->dataTypeId = dataTypeId;
+        field->index = d->eventTypeRegistry->getEventFieldIndex(
+                d->eventTypeRegistry->getEventTypeIndex(eventTypeNodeId), fieldNodeId);
+        pthread_mutex_lock(&d->mutex);
+        EventTypeDataPoolPrivate::Fields& fields = d->fields[eventTypeNodeId];
+        EventTypeDataPoolPrivate::Fields::iterator i = fields.find(ioFieldNodeId);
+        if (i == fields.end()) {
+            fields[ioFieldNodeId] = field;
+        } else {
+            // the field has been cached by another thread
+            delete field;
+            field = (*i).second;
+        }
+        pthread_mutex_unlock(&d->mutex);
+        return field;
+    }
+
+    EventTypeDataPool::Metrics EventTypeDataPool::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+} // namespace SASModelProviderNamespace
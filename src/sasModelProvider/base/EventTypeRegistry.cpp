@@ -2,8 +2,11 @@
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
 #include <eventmanageruanode.h> // EventManagerUaNode
+#include <pthread.h> // pthread_mutex_t
+#include <stddef.h> // NULL
 #include <map>
-#include <string>
+#include <utility> // std::pair
+#include <vector>
 
 using namespace CommonNamespace;
 
@@ -14,29 +17,67 @@ namespace SASModelProviderNamespace {
     private:
         Logger* log;
 
-        // type => super type
-        std::map<UaNodeId, UaNodeId> eventTypes;
-        // key => nodeId
-        std::map<std::string, UaNodeId> eventFields;
+        // protects the event types and the field table
+        pthread_mutex_t mutex;
 
-        std::string getKey(const UaNodeId& eventTypeId, OpcUa_UInt32 fieldIndex);
+        // type => type index
+        std::map<UaNodeId, int> eventTypeIndices;
+        // type index => index of super type (-1: unknown super type)
+        std::vector<int> superTypeIndices;
+        // type index => indices of the sub types
+        std::vector<std::vector<int> > subTypeIndices;
+        // (type index, field index) => nodeId of the fields registered for the type
+        std::map<std::pair<int, OpcUa_UInt32>, UaNodeId> eventFields;
+        // type index => field index => nodeId of the field of the type or its super types
+        // (the nodeIds are held by "eventFields")
+        std::vector<std::vector<const UaNodeId*> > fieldTable;
+        // type index => nodeId of field => field index (reverse mapping of "fieldTable")
+        std::vector<std::map<UaNodeId, OpcUa_UInt32> > fieldIndices;
+
+        // Gets the index of a type. If the type is unknown then it is added.
+        // The mutex must be locked by the caller.
+        int addEventType(const UaNodeId& eventTypeId);
+        // Updates the row of the field table for a type and its sub types.
+        // The mutex must be locked by the caller.
+        void updateFieldTable(int eventTypeIndex, int depth);
     };
 
     EventTypeRegistry::EventTypeRegistry() {
         d = new EventTypeRegistryPrivate();
         d->log = LoggerFactory::getLogger("EventTypeRegistry");
+        pthread_mutex_init(&d->mutex, NULL /*attr*/);
     }
 
     EventTypeRegistry::~EventTypeRegistry() {
+        pthread_mutex_destroy(&d->mutex);
         delete d;
     }
 
     void EventTypeRegistry::registerEventType(const UaNodeId& superType,
             const UaNodeId& newType) {
         EventManagerUaNode::registerEventType(superType, newType);
-        d->eventTypes[newType] = superType;
+        pthread_mutex_lock(&d->mutex);
+        int superTypeIndex = d->addEventType(superType);
+        int newTypeIndex = d->addEventType(newType);
+        int oldSuperTypeIndex = d->superTypeIndices[newTypeIndex];
+        if (oldSuperTypeIndex != superTypeIndex) {
+            if (oldSuperTypeIndex >= 0) {
+                std::vector<int>& subTypes = d->subTypeIndices[oldSuperTypeIndex];
+                for (std::vector<int>::iterator i = subTypes.begin(); i != subTypes.end(); i++) {
+                    if (*i == newTypeIndex) {
+                        subTypes.erase(i);
+                        break;
+                    }
+                }
+            }
+            d->superTypeIndices[newTypeIndex] = superTypeIndex;
+            d->subTypeIndices[superTypeIndex].push_back(newTypeIndex);
+            // the type and its sub types inherit the fields of the super type
+            d->updateFieldTable(newTypeIndex, 0 /* depth */);
+        }
+        pthread_mutex_unlock(&d->mutex);
         if (d->log->isDebugEnabled()) {
-            d->log->info("Registered event type %s for super type %s",
+            d->log->debug("Registered event type %s for super type %s",
                     newType.toXmlString().toUtf8(), superType.toXmlString().toUtf8());
         }
     }
@@ -44,51 +85,120 @@ namespace SASModelProviderNamespace {
     void EventTypeRegistry::registerEventField(const UaNodeId& eventTypeId,
             const UaNodeId& fieldNodeId, const UaQualifiedName& filterName) {
         OpcUa_UInt32 fieldIndex = EventManagerUaNode::registerEventField(filterName);
-        d->eventFields[d->getKey(eventTypeId, fieldIndex)] = fieldNodeId;
+        pthread_mutex_lock(&d->mutex);
+        int eventTypeIndex = d->addEventType(eventTypeId);
+        d->eventFields[std::make_pair(eventTypeIndex, fieldIndex)] = fieldNodeId;
+        d->updateFieldTable(eventTypeIndex, 0 /* depth */);
+        pthread_mutex_unlock(&d->mutex);
         if (d->log->isDebugEnabled()) {
-            d->log->info("Registered event field %s of event type %s for name '%s' with index %d",
+            d->log->debug("Registered event field %s of event type %s for name '%s' with index %d",
                     fieldNodeId.toXmlString().toUtf8(), eventTypeId.toXmlString().toUtf8(),
                     filterName.toFullString().toUtf8(), fieldIndex);
         }
     }
 
-    const UaNodeId* EventTypeRegistry::getEventFieldNodeId(const UaNodeId& eventTypeId,
+    int EventTypeRegistry::getEventTypeIndex(const UaNodeId& eventTypeId) {
+        pthread_mutex_lock(&d->mutex);
+        std::map<UaNodeId, int>::const_iterator i = d->eventTypeIndices.find(eventTypeId);
+        int ret = i == d->eventTypeIndices.end() ? -1 : (*i).second;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    UaNodeId EventTypeRegistry::getEventFieldNodeId(int eventTypeIndex,
             OpcUa_UInt32 fieldIndex) {
-        // get nodeId for event type or any of its super types
-        const UaNodeId* typeId = &eventTypeId;
-        std::map<std::string, UaNodeId>::iterator iterFields;
-        while (typeId != NULL) {
-            iterFields = d->eventFields.find(d->getKey(*typeId, fieldIndex));
-            if (iterFields == d->eventFields.end()) {
-                // get super type
-                std::map<UaNodeId, UaNodeId>::iterator iterTypes = d->eventTypes.find(*typeId);
-                if (iterTypes != d->eventTypes.end()) {
-                    typeId = &iterTypes->second;
-                } else {
-                    // index has not been registered
-                    typeId = NULL;
-                }
-            } else {
-                typeId = NULL;
+        UaNodeId ret;
+        pthread_mutex_lock(&d->mutex);
+        if (eventTypeIndex >= 0 && eventTypeIndex < d->fieldTable.size()) {
+            const std::vector<const UaNodeId*>& fields = d->fieldTable[eventTypeIndex];
+            // the nodeId is copied while the mutex is locked because the registration of
+            // a field replaces the nodeId in "eventFields"
+            if (fieldIndex < fields.size() && fields[fieldIndex] != NULL) {
+                ret = *fields[fieldIndex];
             }
         }
-        UaNodeId* ret = NULL;
-        // if nodeId has been found
-        if (iterFields != d->eventFields.end()) {
-            ret = &iterFields->second;
-            if (d->log->isDebugEnabled()) {
-                d->log->info("Provided event field %s for event type %s and index %d",
-                        ret->toXmlString().toUtf8(), eventTypeId.toXmlString().toUtf8(), fieldIndex);
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    UaNodeId EventTypeRegistry::getEventFieldNodeId(const UaNodeId& eventTypeId,
+            OpcUa_UInt32 fieldIndex) {
+        return getEventFieldNodeId(getEventTypeIndex(eventTypeId), fieldIndex);
+    }
+
+    int EventTypeRegistry::getEventFieldIndex(int eventTypeIndex, const UaNodeId& fieldNodeId) {
+        int ret = -1;
+        pthread_mutex_lock(&d->mutex);
+        if (eventTypeIndex >= 0 && eventTypeIndex < d->fieldIndices.size()) {
+            const std::map<UaNodeId, OpcUa_UInt32>& indices = d->fieldIndices[eventTypeIndex];
+            std::map<UaNodeId, OpcUa_UInt32>::const_iterator i = indices.find(fieldNodeId);
+            if (i != indices.end()) {
+                ret = (*i).second;
             }
         }
+        pthread_mutex_unlock(&d->mutex);
         return ret;
     }
 
-    std::string EventTypeRegistryPrivate::getKey(const UaNodeId& eventTypeId,
-            OpcUa_UInt32 fieldIndex) {
-        UaString key(eventTypeId.toXmlString());
-        key += UaString(":") + UaString::number(fieldIndex, 10);
-        return std::string(key.toUtf8());
+    OpcUa_UInt32 EventTypeRegistry::getEventFieldCount(int eventTypeIndex) {
+        OpcUa_UInt32 ret = 0;
+        pthread_mutex_lock(&d->mutex);
+        if (eventTypeIndex >= 0 && eventTypeIndex < d->fieldTable.size()) {
+            ret = d->fieldTable[eventTypeIndex].size();
+        }
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    int EventTypeRegistryPrivate::addEventType(const UaNodeId& eventTypeId) {
+        std::map<UaNodeId, int>::const_iterator i = eventTypeIndices.find(eventTypeId);
+        if (i != eventTypeIndices.end()) {
+            return (*i).second;
+        }
+        int ret = superTypeIndices.size();
+        eventTypeIndices[eventTypeId] = ret;
+        superTypeIndices.push_back(-1);
+        subTypeIndices.push_back(std::vector<int>());
+        fieldTable.push_back(std::vector<const UaNodeId*>());
+        fieldIndices.push_back(std::map<UaNodeId, OpcUa_UInt32>());
+        return ret;
+    }
+
+    void EventTypeRegistryPrivate::updateFieldTable(int eventTypeIndex, int depth) {
+        // avoid endless loops due to cyclic type hierarchies
+        if (depth > superTypeIndices.size()) {
+            return;
+        }
+        // start with the fields of the super type
+        int superTypeIndex = superTypeIndices[eventTypeIndex];
+        std::vector<const UaNodeId*> fields;
+        if (superTypeIndex >= 0) {
+            fields = fieldTable[superTypeIndex];
+        }
+        // add the own fields
+        for (std::map<std::pair<int, OpcUa_UInt32>, UaNodeId>::const_iterator i =
+                eventFields.lower_bound(std::make_pair(eventTypeIndex, (OpcUa_UInt32) 0));
+                i != eventFields.end() && (*i).first.first == eventTypeIndex; i++) {
+            OpcUa_UInt32 fieldIndex = (*i).first.second;
+            if (fieldIndex >= fields.size()) {
+                fields.resize(fieldIndex + 1, NULL);
+            }
+            fields[fieldIndex] = &(*i).second;
+        }
+        fieldTable[eventTypeIndex].swap(fields);
+        std::map<UaNodeId, OpcUa_UInt32>& indices = fieldIndices[eventTypeIndex];
+        indices.clear();
+        const std::vector<const UaNodeId*>& row = fieldTable[eventTypeIndex];
+        for (OpcUa_UInt32 i = 0; i < row.size(); i++) {
+            if (row[i] != NULL) {
+                indices[*row[i]] = i;
+            }
+        }
+        // update the sub types
+        std::vector<int> subTypes = subTypeIndices[eventTypeIndex];
+        for (std::vector<int>::const_iterator i = subTypes.begin(); i != subTypes.end(); i++) {
+            updateFieldTable(*i, depth + 1);
+        }
     }
 
 } // namespace SASModelProviderNamespace
@@ -3,18 +3,24 @@
 #include <common/Exception.h>
 #include <common/ScopeGuard.h>
 #include <common/VectorScopeGuard.h>
+#include <common/logging/LogThrottle.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/MessageRegistry.h>
 #include <ioDataProvider/MethodData.h>
 #include <ioDataProvider/NodeData.h>
 #include <ioDataProvider/NodeId.h>
 #include <ioDataProvider/NodeProperties.h>
 #include <ioDataProvider/Structure.h>
+#include <sasModelProvider/base/DemandSubscriptionManager.h>
 #include <sasModelProvider/base/HaNodeManagerIODataProviderBridgeException.h>
 #include <sasModelProvider/base/ConversionException.h>
 #include <sasModelProvider/base/ConverterUa2IO.h>
 #include <sasModelProvider/base/IODataProviderSubscriberCallback.h>
+#include <sasModelProvider/base/IngressFilter.h>
 #include <sasModelProvider/base/NodeBrowser.h>
+#include <sasModelProvider/base/PollScheduler.h>
+#include <sasModelProvider/base/WriteBehindQueue.h>
 #include <methodhandleuanode.h> // MethodHandleUaNode
 #include <statuscode.h> // UaStatus
 #include <uaargument.h> // UaArgument
@@ -23,10 +29,15 @@
 #include <uadatetime.h> // UaDateTime
 #include <uadiagnosticinfos.h> // UaDiagnosticInfos
 #include <uanodeid.h> // UaNodeId
+#include <uarange.h> // UaRange
 #include <uastring.h> // UaString
 #include <uavariant.h> // UaVariant
+#include <math.h> // fabs
+#include <pthread.h> // pthread_mutex_t
+#include <string.h> // memset
 #include <iterator>
 #include <map>
+#include <set>
 #include <sstream> // std::ostringstream
 #include <string>
 #include <vector>
@@ -34,8 +45,6 @@
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
 
-//#define USE_DATA_GENERATOR
-
 using namespace CommonNamespace;
 using namespace IODataProviderNamespace;
 
@@ -60,12 +69,116 @@ namespace SASModelProviderNamespace {
                 return nodeBrowser->getSuperTypes(nodeId);
             }
 
+            virtual UaNodeId getBuildInType(const UaNodeId& typeId) {
+                return nodeBrowser->getBuildInType(typeId);
+            }
+
         private:
             NodeBrowser* nodeBrowser;
         };
 
+        class WriteBehindStatusCallback : public WriteBehindQueue::StatusCallback {
+        public:
+
+            WriteBehindStatusCallback(Logger& log) {
+                this->log = &log;
+            }
+
+            virtual void writeFailed(const std::vector<const NodeData*>& nodeData,
+                    const IODataProviderException& exception) {
+                // there is no way to inform the OPC UA server => log the exception
+                IODataProviderException ex(exception);
+                std::string st;
+                ex.getStackTrace(st);
+                for (std::vector<const NodeData*>::const_iterator i = nodeData.begin();
+                        i != nodeData.end(); i++) {
+                    log->error("ASET nodeId=%s,value=%s: write behind failed",
+                            (*i)->getNodeId().toString().c_str(),
+                            (*i)->getData() == NULL ? "<NULL>" : (*i)->getData()->toString().c_str());
+                }
+                log->error("Exception while writing values: %s", st.c_str());
+            }
+        private:
+            Logger* log;
+        };
+
+        class DemandSubscriptionStatusCallback
+        : public DemandSubscriptionManager::StatusCallback {
+        public:
+
+            DemandSubscriptionStatusCallback(HaNodeManagerIODataProviderBridgePrivate& d) {
+                this->d = &d;
+            }
+
+            virtual void subscribed(const std::vector<NodeData*>& initialValues) {
+                d->setCacheValues(initialValues);
+            }
+
+            virtual void subscriptionFailed(const std::vector<const NodeId*>& nodeIds,
+                    bool isSubscribe, const IODataProviderException& exception) {
+                // there is no way to inform the OPC UA server => log the exception
+                IODataProviderException ex(exception);
+                std::string st;
+                ex.getStackTrace(st);
+                d->log->error("Exception while %s %lu nodes: %s",
+                        isSubscribe ? "subscribing" : "unsubscribing", nodeIds.size(),
+                        st.c_str());
+            }
+        private:
+            HaNodeManagerIODataProviderBridgePrivate* d;
+        };
+
+        class PollCallback : public PollScheduler::PollCallback {
+        public:
+
+            PollCallback(HaNodeManagerIODataProviderBridgePrivate& d) {
+                this->d = &d;
+            }
+
+            virtual void polled(const std::vector<NodeData*>& values) {
+                d->setCacheValues(values);
+            }
+
+            virtual void pollFailed(const std::vector<const NodeId*>& nodeIds,
+                    const IODataProviderException& exception) {
+                // there is no way to inform the OPC UA server => log the exception
+                IODataProviderException ex(exception);
+                std::string st;
+                ex.getStackTrace(st);
+                d->log->error("Exception while polling %lu nodes: %s", nodeIds.size(),
+                        st.c_str());
+            }
+        private:
+            HaNodeManagerIODataProviderBridgePrivate* d;
+        };
+
         Logger* log;
 
+        HaNodeManagerIODataProviderBridge::Configuration conf;
+        WriteBehindStatusCallback* writeBehindStatusCallback;
+        // queue for values set via beforeSetAttributeValue (NULL: synchronous writing)
+        WriteBehindQueue* writeBehindQueue;
+        // filter for values of asynchronous variables (NULL: no filtering)
+        IngressFilter* ingressFilter;
+        DemandSubscriptionStatusCallback* demandSubscriptionStatusCallback;
+        // subscriptions of monitored asynchronous variables
+        // (NULL: all asynchronous variables are subscribed at start up)
+        DemandSubscriptionManager* demandSubscriptionManager;
+        // protects the nodeIds of the variables which are subscribed on demand or polled
+        pthread_mutex_t valueHandlingMutex;
+        // nodeIds of asynchronous variables which are subscribed on demand
+        std::set<std::string> demandNodeIds;
+        PollCallback* pollCallback;
+        // poll groups of monitored synchronous variables (NULL: no polling)
+        PollScheduler* pollScheduler;
+        // nodeIds of synchronous variables which are polled while they are monitored
+        std::set<std::string> pollNodeIds;
+        // shared reads of the IO data provider (NULL: each read calls the IO data provider)
+        SingleFlightReader* singleFlightReader;
+        // protects the event monitoring metrics
+        pthread_mutex_t eventMonitoringMutex;
+        HaNodeManagerIODataProviderBridge::EventMonitoringMetrics eventMonitoringMetrics;
+
         HaNodeManager* haNodeManager;
         NodeBrowser* nodeBrowser;
         IODataProviderNamespace::IODataProvider* ioDataProvider;
@@ -73,19 +186,68 @@ namespace SASModelProviderNamespace {
         const IODataProviderNamespace::NodeProperties* dfltNodeProps;
         std::vector<const IODataProviderNamespace::NodeData*>* nodePropsMap;
         ConverterUa2IO* converter;
-        static GeneratorIODataProvider* dataGenerator;
+        GeneratorIODataProvider* dataGenerator;
 
+        // Gets the properties of a node or the default node properties (NULL: the IO data
+        // provider does not provide properties for the node).
+        const NodeProperties* getNodeProperties(const IODataProviderNamespace::NodeId& nodeId);
         // Gets the value handling for a node.
         NodeProperties::ValueHandling getValueHandling(
                 const IODataProviderNamespace::NodeId& nodeId);
+        // Returns whether values of any node shall be filtered via the server configuration
+        // or the node properties.
+        bool hasIngressFilters();
+        // Adds the ingress filter of an asynchronous variable. The filter settings of the
+        // node properties replace the settings of the server configuration.
+        void setIngressFilter(const IODataProviderNamespace::NodeId& nodeId,
+                UaVariable& variable);
+        // Gets the deadband for the values of a variable using the EURange property
+        // for a percent deadband.
+        double getIngressDeadband(UaVariable& variable, double absoluteDeadband,
+                double percentDeadband);
+        // Sets values received from the IO data provider (eg. initial values of newly
+        // subscribed variables or polled values) to the server cache.
+        void setCacheValues(const std::vector<NodeData*>& values);
     };
 
-    GeneratorIODataProvider* HaNodeManagerIODataProviderBridgePrivate::dataGenerator = NULL;
+    HaNodeManagerIODataProviderBridge::Configuration::Configuration() {
+        writeBehindWindow = 0;
+        writeBehindMaxBatchSize = 500;
+        ingressSuppressEqualValues = false;
+        ingressAbsoluteDeadband = 0;
+        ingressPercentDeadband = 0;
+        demandSubscriptions = false;
+        demandSubscriptionDebounceTime = 1000;
+        pollGroups = false;
+        pollMinInterval = 100;
+        readCoalescing = false;
+        readFreshnessWindow = 0;
+        skipUnmonitoredEvents = false;
+        dataGenerator = false;
+        generatorVariableCount = 0;
+        generatorVariableChangeRate = 1;
+        generatorEventTypeCount = 0;
+        generatorEventRate = 1;
+        generatorMethodLatency = 0;
+    }
 
     HaNodeManagerIODataProviderBridge::HaNodeManagerIODataProviderBridge(
-            HaNodeManager& haNodeManager, IODataProvider& ioDataProvider) {
+            HaNodeManager& haNodeManager, IODataProvider& ioDataProvider,
+            const Configuration& conf) {
         d = new HaNodeManagerIODataProviderBridgePrivate();
         d->log = LoggerFactory::getLogger("HaNodeManagerIODataProviderBridge");
+        d->conf = conf;
+        d->writeBehindStatusCallback = NULL;
+        d->writeBehindQueue = NULL;
+        d->ingressFilter = NULL;
+        d->demandSubscriptionStatusCallback = NULL;
+        d->demandSubscriptionManager = NULL;
+        d->pollCallback = NULL;
+        d->pollScheduler = NULL;
+        d->singleFlightReader = NULL;
+        pthread_mutex_init(&d->valueHandlingMutex, NULL /*attr*/);
+        pthread_mutex_init(&d->eventMonitoringMutex, NULL /*attr*/);
+        memset(&d->eventMonitoringMetrics, 0, sizeof (d->eventMonitoringMetrics));
         d->haNodeManager = &haNodeManager;
         d->nodeBrowser = NULL;
         d->ioDataProvider = &ioDataProvider;
@@ -93,9 +255,12 @@ namespace SASModelProviderNamespace {
         d->dfltNodeProps = NULL;
         d->nodePropsMap = NULL;
         d->converter = NULL;
+        d->dataGenerator = NULL;
     }
 
     HaNodeManagerIODataProviderBridge::~HaNodeManagerIODataProviderBridge() {
+        pthread_mutex_destroy(&d->eventMonitoringMutex);
+        pthread_mutex_destroy(&d->valueHandlingMutex);
         delete d;
     }
 
@@ -103,22 +268,77 @@ namespace SASModelProviderNamespace {
         std::string ns(d->haNodeManager->getNameSpaceUri().toUtf8());
         OpcUa_UInt16 nsIndex = d->haNodeManager->getNodeManagerBase().getNameSpaceIndex();
         try {
+            // update the namespace tables of the node browsers of the other node managers
+            NodeBrowser::nodeManagerStarted(*d->haNodeManager);
             d->nodeBrowser = new NodeBrowser(*d->haNodeManager);
             d->ioDataProvider->setNodeBrowser(d->nodeBrowser);
-            d->ioDataProviderSubscriberCallback = new IODataProviderSubscriberCallback(
-                    *d->haNodeManager);
             d->dfltNodeProps = d->ioDataProvider->getDefaultNodeProperties(ns,
                     nsIndex); // IODataProviderException
             d->nodePropsMap = d->ioDataProvider->getNodeProperties(ns,
                     nsIndex); // IODataProviderException
+            if (d->hasIngressFilters()) {
+                d->ingressFilter = new IngressFilter(); // MutexException
+                d->log->info("Enabled ingress filter for namespace index %d: suppressEqualValues=%s,absoluteDeadband=%f,percentDeadband=%f",
+                        nsIndex, d->conf.ingressSuppressEqualValues ? "true" : "false",
+                        d->conf.ingressAbsoluteDeadband, d->conf.ingressPercentDeadband);
+            }
+            d->ioDataProviderSubscriberCallback = new IODataProviderSubscriberCallback(
+                    *d->haNodeManager, d->ingressFilter);
             d->converter = new ConverterUa2IO(
                     *new HaNodeManagerIODataProviderBridgePrivate::ConverterCallback(
                     *d->nodeBrowser), true /* attachValues*/);
-#ifdef USE_DATA_GENERATOR
-            if (d->dataGenerator == NULL) {
-                d->dataGenerator = new GeneratorIODataProvider(*d->nodeBrowser, *d->converter);
+            if (d->conf.dataGenerator) {
+                GeneratorIODataProvider::Configuration generatorConf;
+                generatorConf.variableCount = d->conf.generatorVariableCount;
+                generatorConf.variableChangeRate = d->conf.generatorVariableChangeRate;
+                generatorConf.eventTypeCount = d->conf.generatorEventTypeCount;
+                generatorConf.eventRate = d->conf.generatorEventRate;
+                generatorConf.methodLatency = d->conf.generatorMethodLatency;
+                d->dataGenerator = new GeneratorIODataProvider(*d->nodeBrowser, *d->converter,
+                        generatorConf); // MutexException
+                d->log->info("Enabled data generator for namespace index %d: variableCount=%ld,variableChangeRate=%f,eventTypeCount=%ld,eventRate=%f,methodLatency=%ldms",
+                        nsIndex, generatorConf.variableCount, generatorConf.variableChangeRate,
+                        generatorConf.eventTypeCount, generatorConf.eventRate,
+                        generatorConf.methodLatency);
+            }
+            if (d->conf.writeBehindWindow > 0 && d->dataGenerator == NULL) {
+                d->writeBehindStatusCallback =
+                        new HaNodeManagerIODataProviderBridgePrivate::WriteBehindStatusCallback(
+                        *d->log);
+                d->writeBehindQueue = new WriteBehindQueue(*d->ioDataProvider,
+                        d->conf.writeBehindWindow, d->conf.writeBehindMaxBatchSize,
+                        d->writeBehindStatusCallback); // MutexException
+                d->log->info("Enabled write behind for namespace index %d: window=%ldms,maxBatchSize=%d",
+                        nsIndex, d->conf.writeBehindWindow, d->conf.writeBehindMaxBatchSize);
+            }
+            if (d->conf.demandSubscriptions && d->dataGenerator == NULL) {
+                d->demandSubscriptionStatusCallback =
+                        new HaNodeManagerIODataProviderBridgePrivate::DemandSubscriptionStatusCallback(
+                        *d);
+                d->demandSubscriptionManager = new DemandSubscriptionManager(*d->ioDataProvider,
+                        *d->ioDataProviderSubscriberCallback,
+                        d->conf.demandSubscriptionDebounceTime,
+                        d->demandSubscriptionStatusCallback); // MutexException
+                d->log->info("Enabled demand driven subscriptions for namespace index %d: debounceTime=%ldms",
+                        nsIndex, d->conf.demandSubscriptionDebounceTime);
+            }
+            if (d->conf.pollGroups && d->dataGenerator == NULL) {
+                d->pollCallback = new HaNodeManagerIODataProviderBridgePrivate::PollCallback(*d);
+                d->pollScheduler = new PollScheduler(*d->ioDataProvider, d->conf.pollMinInterval,
+                        d->pollCallback); // MutexException
+                d->log->info("Enabled poll groups for namespace index %d: minInterval=%ldms",
+                        nsIndex, d->conf.pollMinInterval);
+            }
+            if (d->conf.readCoalescing && d->dataGenerator == NULL) {
+                std::map<std::string, long>::const_iterator window =
+                        d->conf.namespaceReadFreshnessWindows.find(ns);
+                long freshnessWindow = window == d->conf.namespaceReadFreshnessWindows.end() ?
+                        d->conf.readFreshnessWindow : (*window).second;
+                d->singleFlightReader = new SingleFlightReader(*d->ioDataProvider,
+                        freshnessWindow); // MutexException
+                d->log->info("Enabled read coalescing for namespace index %d: freshnessWindow=%ldms",
+                        nsIndex, freshnessWindow);
             }
-#endif
             d->log->info("Started bridge from node manager for namespace index %d to IO data provider",
                     nsIndex);
             return UaStatus(OpcUa_Good);
@@ -138,6 +358,66 @@ namespace SASModelProviderNamespace {
     }
 
     UaStatus HaNodeManagerIODataProviderBridge::beforeShutDown() {
+        if (d->conf.skipUnmonitoredEvents) {
+            EventMonitoringMetrics metrics = getEventMonitoringMetrics();
+            d->log->info("Event monitoring: monitoredItems=%lu,skippedEvents=%lu",
+                    metrics.monitoredItemCount, metrics.skippedEventCount);
+        }
+        if (d->singleFlightReader != NULL) {
+            SingleFlightReader::Metrics metrics = d->singleFlightReader->getMetrics();
+            d->log->info("Read coalescing: readCalls=%lu,readNodes=%lu,shared=%lu,fresh=%lu",
+                    metrics.readCallCount, metrics.readNodeCount, metrics.sharedCount,
+                    metrics.freshCount);
+        }
+        delete d->singleFlightReader;
+        d->singleFlightReader = NULL;
+        if (d->demandSubscriptionManager != NULL) {
+            DemandSubscriptionManager::Metrics metrics = d->demandSubscriptionManager->getMetrics();
+            d->log->info("Demand subscriptions: subscribeCalls=%lu,unsubscribeCalls=%lu,subscribedNodes=%lu,unsubscribedNodes=%lu,debounced=%lu",
+                    metrics.subscribeCallCount, metrics.unsubscribeCallCount,
+                    metrics.subscribedNodeCount, metrics.unsubscribedNodeCount,
+                    metrics.debouncedCount);
+        }
+        if (d->pollScheduler != NULL) {
+            PollScheduler::Metrics metrics = d->pollScheduler->getMetrics();
+            d->log->info("Poll groups: polls=%lu,failedPolls=%lu,polledNodes=%lu,overruns=%lu",
+                    metrics.pollCount, metrics.failedPollCount, metrics.polledNodeCount,
+                    metrics.overrunCount);
+        }
+        // stop the polling thread
+        delete d->pollScheduler;
+        d->pollScheduler = NULL;
+        delete d->pollCallback;
+        d->pollCallback = NULL;
+        pthread_mutex_lock(&d->valueHandlingMutex);
+        d->pollNodeIds.clear();
+        pthread_mutex_unlock(&d->valueHandlingMutex);
+        // stop the subscribing thread
+        delete d->demandSubscriptionManager;
+        d->demandSubscriptionManager = NULL;
+        delete d->demandSubscriptionStatusCallback;
+        d->demandSubscriptionStatusCallback = NULL;
+        pthread_mutex_lock(&d->valueHandlingMutex);
+        d->demandNodeIds.clear();
+        pthread_mutex_unlock(&d->valueHandlingMutex);
+        if (d->writeBehindQueue != NULL) {
+            WriteBehindQueue::Metrics metrics = d->writeBehindQueue->getMetrics();
+            d->log->info("Write behind: batches=%lu,failedBatches=%lu,values=%lu,coalesced=%lu,maxBatchSize=%lu",
+                    metrics.batchCount, metrics.failedBatchCount, metrics.valueCount,
+                    metrics.coalescedCount, metrics.maxBatchSize);
+        }
+        // write the queued values
+        delete d->writeBehindQueue;
+        d->writeBehindQueue = NULL;
+        delete d->writeBehindStatusCallback;
+        d->writeBehindStatusCallback = NULL;
+        if (d->dataGenerator != NULL) {
+            GeneratorIODataProvider::Metrics metrics = d->dataGenerator->getMetrics();
+            d->log->info("Data generator: valueChanges=%lu,events=%lu,overruns=%lu,failed=%lu",
+                    metrics.valueChangeCount, metrics.eventCount, metrics.overrunCount,
+                    metrics.failedCount);
+        }
+        // stop the generating thread
         delete d->dataGenerator;
         d->dataGenerator = NULL;
         delete d->converter;
@@ -152,6 +432,16 @@ namespace SASModelProviderNamespace {
             delete d->dfltNodeProps;
         }
         delete d->ioDataProviderSubscriberCallback;
+        if (d->ingressFilter != NULL) {
+            IngressFilter::Metrics metrics = d->ingressFilter->getMetrics();
+            d->log->info("Ingress filter: passed=%lu,suppressedEqual=%lu,suppressedDeadband=%lu",
+                    metrics.passedCount, metrics.suppressedEqualCount,
+                    metrics.suppressedDeadbandCount);
+            delete d->ingressFilter;
+            d->ingressFilter = NULL;
+        }
+        // the nodes of the node manager are deleted after the shut down of the bridge
+        NodeBrowser::nodeManagerStopped(*d->haNodeManager);
         delete d->nodeBrowser;
         return UaStatus(OpcUa_Good);
     }
@@ -180,6 +470,16 @@ namespace SASModelProviderNamespace {
                 ScopeGuard<NodeId> nodeIdSG(nodeId);
                 // if value handling is enabled
                 if (d->getValueHandling(*nodeId) != NodeProperties::NONE) {
+                    if ((d->pollScheduler != NULL && d->pollScheduler->isFresh(*nodeId))
+                            || (d->demandSubscriptionManager != NULL
+                            && d->demandSubscriptionManager->isSubscribed(*nodeId))) {
+                        // the value has been polled within the interval of its poll group
+                        // or the cache receives the values of the subscribed variable
+                        // => return the cached value
+                        returnValues[i] = variable.value(NULL /* session */);
+                        returnValues[i].setServerTimestamp(serverTimeStamp);
+                        continue;
+                    }
                     // save nodeId, array index
                     nodeIds->push_back(nodeIdSG.detach());
                     arrayIndices[nodeId] = i;
@@ -197,11 +497,18 @@ namespace SASModelProviderNamespace {
             }
         }
         if (nodeIds->size() > 0) {
+            // the IO data provider shall return the queued values of the read nodes
+            if (d->writeBehindQueue != NULL && d->dataGenerator == NULL
+                    && d->writeBehindQueue->isQueued(*nodeIds)) {
+                d->writeBehindQueue->flush();
+            }
             try {
                 // get values from IO data provider
-                std::vector<NodeData*>* results = d->dataGenerator == NULL ?
-                        d->ioDataProvider->read(*nodeIds) // IODataProviderException                     
-                        : d->dataGenerator->read(*nodeIds);
+                std::vector<NodeData*>* results = d->dataGenerator != NULL ?
+                        d->dataGenerator->read(*nodeIds)
+                        : d->singleFlightReader != NULL ?
+                        d->singleFlightReader->read(*nodeIds)
+                        : d->ioDataProvider->read(*nodeIds); // IODataProviderException
                 VectorScopeGuard<NodeData> resultsSG(results);
                 OpcUa_UInt32 resultCount = results == NULL ? 0 : results->size();
                 if (resultCount != nodeIds->size() && exception == NULL) {
@@ -239,8 +546,12 @@ namespace SASModelProviderNamespace {
                     UaVariable& variable = *variables[arrayIndex];
                     const OpcUa_Variant& cacheValue = *variable.value(
                             NULL /* session */).value();
-                    IODataProviderException* resultException = result.getException();
-                    if (resultException == NULL) {
+                    // the status code of a failed node; the exception is only created for
+                    // debug logging
+                    OpcUa_StatusCode statusCode = result.hasError() ?
+                            (OpcUa_StatusCode) result.getStatusCode() : OpcUa_Good;
+                    const char* errorMsg = "Reading of data from IO data provider failed";
+                    if (statusCode == OpcUa_Good) {
                         try {
                             // convert Variant to UaVariant
                             UaVariant* value = result.getData() == NULL ?
@@ -261,26 +572,47 @@ namespace SASModelProviderNamespace {
                                         value->toFullString().toUtf8());
                             }
                         } catch (Exception& e) {
-                            resultException = new ExceptionDef(IODataProviderException,
-                                    std::string("Cannot set value for variable ")
-                                    .append(nodeId.toString().c_str())
-                                    .append(" after reading data from IO data provider"));
-                            resultException->setCause(&e);
+                            statusCode = OpcUa_BadTypeMismatch;
+                            errorMsg = "Cannot set value after reading data from IO data provider";
+                            if (d->log->isDebugEnabled()) {
+                                IODataProviderException ex = ExceptionDef(IODataProviderException,
+                                        std::string("Cannot set value for variable ")
+                                        .append(nodeId.toString().c_str())
+                                        .append(" after reading data from IO data provider"));
+                                ex.setCause(&e);
+                                std::string st;
+                                ex.getStackTrace(st);
+                                d->log->debug("READ %-20s nodeId=%s,exception=%s",
+                                        variable.browseName().toString().toUtf8(),
+                                        variable.nodeId().toXmlString().toUtf8(), st.c_str());
+                            }
                         }
-                    }
-                    if (resultException != NULL) {
-                        // there is no way to inform the OPC UA server about details => log the exception                        
+                    } else if (d->log->isDebugEnabled()) {
                         std::string st;
-                        resultException->getStackTrace(st);
-                        d->log->error("READ %-20s nodeId=%s,oldValue=%s,exception=%s",
+                        result.getException()->getStackTrace(st);
+                        d->log->debug("READ %-20s nodeId=%s,exception=%s",
+                                variable.browseName().toString().toUtf8(),
+                                variable.nodeId().toXmlString().toUtf8(), st.c_str());
+                    }
+                    if (statusCode != OpcUa_Good) {
+                        returnValues[arrayIndex].setStatusCode(statusCode);
+                    }
+                    // there is no way to inform the OPC UA server about details
+                    // => log the status (similar messages are throttled while e.g. the
+                    // IO data provider is not reachable)
+                    LogThrottle* throttle = statusCode == OpcUa_Good ? NULL
+                            : LoggerFactory::getLogThrottle("HaNodeManagerIODataProviderBridge");
+                    if (throttle != NULL && throttle->pass("READ nodeId=%s,statusCode=0x%08X",
+                            std::string(variable.nodeId().toXmlString().toUtf8()))) {
+                        std::string resultMsg = !result.hasError() ? std::string()
+                                : result.getMessageId() >= 0 ?
+                                MessageRegistry::getMessage(result.getMessageId())
+                                : result.getException()->getMessage();
+                        d->log->error("READ %-20s nodeId=%s,oldValue=%s,statusCode=0x%08X,message=%s",
                                 variable.browseName().toString().toUtf8(),
                                 variable.nodeId().toXmlString().toUtf8(),
-                                UaVariant(cacheValue).toFullString().toUtf8(),
-                                st.c_str());
-                        if (resultException != result.getException()) {
-                            delete resultException;
-                        }
-                        returnValues[arrayIndex].setStatusCode(OpcUa_Bad);
+                                UaVariant(cacheValue).toFullString().toUtf8(), statusCode,
+                                resultMsg.empty() ? errorMsg : resultMsg.c_str());
                     }
                     returnValues[arrayIndex].setSourceTimestamp(serverTimeStamp);
                     returnValues[arrayIndex].setServerTimestamp(serverTimeStamp);
@@ -300,7 +632,11 @@ namespace SASModelProviderNamespace {
             // there is no way to inform the OPC UA server about details => log the exception
             std::string st;
             ex.getStackTrace(st);
-            d->log->error("Exception while reading values: %s", st.c_str());
+            LogThrottle* throttle =
+                    LoggerFactory::getLogThrottle("HaNodeManagerIODataProviderBridge");
+            if (throttle == NULL || throttle->pass("Exception while reading values: %s")) {
+                d->log->error("Exception while reading values: %s", st.c_str());
+            }
             ret = UaStatus(OpcUa_Bad);
         }
         return ret;
@@ -309,6 +645,10 @@ namespace SASModelProviderNamespace {
     UaStatus HaNodeManagerIODataProviderBridge::writeValues(const UaVariableArray &variables,
             const PDataValueArray &values, UaStatusCodeArray &returnStatusCodes) {
         UaStatus ret(OpcUa_Good);
+        // keep the order of writes: send the queued values first
+        if (d->writeBehindQueue != NULL) {
+            d->writeBehindQueue->flush();
+        }
         // initialize return values
         OpcUa_UInt32 variableCount = variables.length();
         returnStatusCodes.create(variableCount);
@@ -360,6 +700,12 @@ namespace SASModelProviderNamespace {
                 // write values to IO data provider
                 d->ioDataProvider->write(*nodeData,
                         false /* sendValueChangedEvents */); // IODataProviderException                            
+                // the next reads shall return the written values
+                if (d->singleFlightReader != NULL) {
+                    for (int i = 0; i < nodeData->size(); i++) {
+                        d->singleFlightReader->invalidate((*nodeData)[i]->getNodeId());
+                    }
+                }
                 // write values to the server cache
                 for (OpcUa_UInt32 i = 0; i < variableCount; i++) {
                     UaVariable& variable = *variables[i];
@@ -409,6 +755,14 @@ namespace SASModelProviderNamespace {
 		ScopeGuard<NodeId> nodeIdSG(nodeId);
 		// if value handling is enabled
 		if (d->getValueHandling(*nodeId) != NodeProperties::NONE) {
+			// the server cache gets a new value => the next received value must pass
+			if (d->ingressFilter != NULL) {
+				d->ingressFilter->reset(*nodeId);
+			}
+			// the next reads shall return the new value
+			if (d->singleFlightReader != NULL) {
+				d->singleFlightReader->invalidate(*nodeId);
+			}
 			if (d->log->isInfoEnabled()) {
 				d->log->info("ASET %-20s nodeId=%s,value=%s",
 						variable.browseName().toString().toUtf8(),
@@ -419,11 +773,17 @@ namespace SASModelProviderNamespace {
 				// convert UaVariant to Variant
 				Variant* value = d->converter->convertUa2io(UaVariant(*dataValue.value()),
 						variable.dataType()); // ConversionException
-				NodeData nd(*nodeIdSG.detach(), value, true /* attachValues */);
-				std::vector<const NodeData*> nodeData;
-				nodeData.push_back(&nd);
-				d->ioDataProvider->write(nodeData,
-						false /* sendValueChangedEvents */); // IODataProviderException
+				NodeData* nd = new NodeData(*nodeIdSG.detach(), value, true /* attachValues */);
+				if (d->writeBehindQueue != NULL) {
+					// the value is written later in a batch with other values
+					d->writeBehindQueue->enqueue(nd);
+				} else {
+					ScopeGuard<NodeData> ndSG(nd);
+					std::vector<const NodeData*> nodeData;
+					nodeData.push_back(nd);
+					d->ioDataProvider->write(nodeData,
+							false /* sendValueChangedEvents */); // IODataProviderException
+				}
 			} catch (Exception& e) {
 				std::ostringstream msg;
 				msg << "The writing of node values to IO data provider after server cache modification failed";
@@ -434,6 +794,7 @@ namespace SASModelProviderNamespace {
 				std::string st;
 				ex.getStackTrace(st);
 				d->log->error("Exception while writing values: %s", st.c_str());
+				variable.releaseReference();
 				return false;
 			}
 		} else if (d->log->isInfoEnabled()) {
@@ -446,6 +807,89 @@ namespace SASModelProviderNamespace {
     	return true;
     }
 
+    WriteBehindQueue::Metrics HaNodeManagerIODataProviderBridge::getWriteBehindMetrics() {
+        if (d->writeBehindQueue != NULL) {
+            return d->writeBehindQueue->getMetrics();
+        }
+        return WriteBehindQueue::Metrics();
+    }
+
+    IngressFilter::Metrics HaNodeManagerIODataProviderBridge::getIngressFilterMetrics() {
+        if (d->ingressFilter != NULL) {
+            return d->ingressFilter->getMetrics();
+        }
+        IngressFilter::Metrics ret;
+        ret.passedCount = 0;
+        ret.suppressedEqualCount = 0;
+        ret.suppressedDeadbandCount = 0;
+        return ret;
+    }
+
+    DemandSubscriptionManager::Metrics HaNodeManagerIODataProviderBridge::getDemandSubscriptionMetrics() {
+        if (d->demandSubscriptionManager != NULL) {
+            return d->demandSubscriptionManager->getMetrics();
+        }
+        DemandSubscriptionManager::Metrics ret;
+        memset(&ret, 0, sizeof (ret));
+        return ret;
+    }
+
+    PollScheduler::Metrics HaNodeManagerIODataProviderBridge::getPollMetrics() {
+        if (d->pollScheduler != NULL) {
+            return d->pollScheduler->getMetrics();
+        }
+        PollScheduler::Metrics ret;
+        memset(&ret, 0, sizeof (ret));
+        return ret;
+    }
+
+    SingleFlightReader::Metrics HaNodeManagerIODataProviderBridge::getReadCoalescingMetrics() {
+        if (d->singleFlightReader != NULL) {
+            return d->singleFlightReader->getMetrics();
+        }
+        SingleFlightReader::Metrics ret;
+        memset(&ret, 0, sizeof (ret));
+        return ret;
+    }
+
+    HaNodeManagerIODataProviderBridge::EventMonitoringMetrics
+    HaNodeManagerIODataProviderBridge::getEventMonitoringMetrics() {
+        pthread_mutex_lock(&d->eventMonitoringMutex);
+        EventMonitoringMetrics ret = d->eventMonitoringMetrics;
+        pthread_mutex_unlock(&d->eventMonitoringMutex);
+        return ret;
+    }
+
+    void HaNodeManagerIODataProviderBridge::eventMonitoringChanged(bool isStarted) {
+        if (!d->conf.skipUnmonitoredEvents) {
+            return;
+        }
+        pthread_mutex_lock(&d->eventMonitoringMutex);
+        unsigned long& count = d->eventMonitoringMetrics.monitoredItemCount;
+        if (isStarted) {
+            count++;
+        } else if (count > 0) {
+            count--;
+        }
+        pthread_mutex_unlock(&d->eventMonitoringMutex);
+    }
+
+    bool HaNodeManagerIODataProviderBridge::isEventMonitored() {
+        if (!d->conf.skipUnmonitoredEvents) {
+            return true;
+        }
+        pthread_mutex_lock(&d->eventMonitoringMutex);
+        bool ret = d->eventMonitoringMetrics.monitoredItemCount > 0;
+        pthread_mutex_unlock(&d->eventMonitoringMutex);
+        return ret;
+    }
+
+    void HaNodeManagerIODataProviderBridge::eventSkipped() {
+        pthread_mutex_lock(&d->eventMonitoringMutex);
+        d->eventMonitoringMetrics.skippedEventCount++;
+        pthread_mutex_unlock(&d->eventMonitoringMutex);
+    }
+
     void HaNodeManagerIODataProviderBridge::afterSetAttributeValue(
             Session* pSession, UaNode* pNode, OpcUa_Int32 attributeId,
             const UaDataValue& dataValue) {
@@ -462,8 +906,51 @@ namespace SASModelProviderNamespace {
             d->log->info("MON %-20s nodeId=%s,transactionType=%s",
                     pVariable->browseName().toString().toUtf8(),
                     pVariable->nodeId().toXmlString().toUtf8(),
-                    transactionType == IOManager::TransactionMonitorBegin ?
-                    "monitorBegin" : "monitorStop");
+                    transactionType == IOManager::TransactionMonitorBegin ? "monitorBegin"
+                    : transactionType == IOManager::TransactionMonitorModify ? "monitorModify"
+                    : "monitorStop");
+        }
+        if ((d->demandSubscriptionManager == NULL && d->pollScheduler == NULL)
+                || (transactionType != IOManager::TransactionMonitorBegin
+                && transactionType != IOManager::TransactionMonitorModify
+                && transactionType != IOManager::TransactionMonitorStop)) {
+            return;
+        }
+        try {
+            // convert UaNodeId to NodeId
+            NodeId* nodeId = d->converter->convertUa2io(pVariable->nodeId()); // ConversionException
+            ScopeGuard<NodeId> nodeIdSG(nodeId);
+            std::string key = nodeId->toString();
+            pthread_mutex_lock(&d->valueHandlingMutex);
+            bool isDemandNode = d->demandNodeIds.find(key) != d->demandNodeIds.end();
+            bool isPollNode = d->pollNodeIds.find(key) != d->pollNodeIds.end();
+            pthread_mutex_unlock(&d->valueHandlingMutex);
+            // if the variable is subscribed on demand
+            if (isDemandNode) {
+                if (transactionType == IOManager::TransactionMonitorBegin) {
+                    d->demandSubscriptionManager->monitoringStarted(*nodeId);
+                } else if (transactionType == IOManager::TransactionMonitorStop) {
+                    d->demandSubscriptionManager->monitoringStopped(*nodeId);
+                }
+            } else if (isPollNode) {
+                // if the variable is polled
+                // the min. sampling interval of the variable considers the intervals of
+                // all current monitored items
+                long samplingInterval = (long) pVariable->getMinSamplingInterval();
+                if (transactionType == IOManager::TransactionMonitorBegin) {
+                    d->pollScheduler->monitoringStarted(*nodeId, samplingInterval);
+                } else if (transactionType == IOManager::TransactionMonitorModify) {
+                    d->pollScheduler->monitoringModified(*nodeId, samplingInterval);
+                } else {
+                    d->pollScheduler->monitoringStopped(*nodeId, samplingInterval);
+                }
+            }
+        } catch (Exception& e) {
+            // there is no way to inform the OPC UA server => log the exception
+            std::string st;
+            e.getStackTrace(st);
+            d->log->error("Exception while updating the subscription of %s: %s",
+                    pVariable->nodeId().toXmlString().toUtf8(), st.c_str());
         }
     }
 
@@ -715,8 +1202,21 @@ namespace SASModelProviderNamespace {
                         // add subscription for variable                        
                         asyncNodeIds->push_back(nodeIdSG.detach());
                         asyncVariables[nodeId] = &variable;
-                        // the server cache is the data source for OPC UA clients
-                        variable.setValueHandling(UaVariable_Value_CacheIsSource);
+                        if (d->ingressFilter != NULL) {
+                            d->setIngressFilter(*nodeId, variable);
+                        }
+                        if (d->demandSubscriptionManager != NULL) {
+                            pthread_mutex_lock(&d->valueHandlingMutex);
+                            d->demandNodeIds.insert(nodeId->toString());
+                            pthread_mutex_unlock(&d->valueHandlingMutex);
+                            // the server cache only receives values while the variable is
+                            // monitored => method "readValues" reads the values of
+                            // unmonitored variables from the IO data provider
+                            variable.setValueHandling(UaVariable_Value_CacheIsUpdatedOnRequest);
+                        } else {
+                            // the server cache is the data source for OPC UA clients
+                            variable.setValueHandling(UaVariable_Value_CacheIsSource);
+                        }
                         break;
                     case NodeProperties::SYNC:
                         vh = std::string("sync");
@@ -724,6 +1224,11 @@ namespace SASModelProviderNamespace {
                         // the server only caches the values
                         // method "writeValues" updates the cache
                         variable.setValueHandling(UaVariable_Value_CacheIsUpdatedOnRequest);
+                        if (d->pollScheduler != NULL) {
+                            pthread_mutex_lock(&d->valueHandlingMutex);
+                            d->pollNodeIds.insert(nodeId->toString());
+                            pthread_mutex_unlock(&d->valueHandlingMutex);
+                        }
                     default:
                         break;
                 }
@@ -744,11 +1249,14 @@ namespace SASModelProviderNamespace {
         if (asyncNodeIds->size() > 0) {
             try {
                 // subscribe for async nodeIds and get initial values
-                std::vector<NodeData*>* results = d->dataGenerator == NULL ?
-                        d->ioDataProvider->subscribe(*asyncNodeIds,
-                        *d->ioDataProviderSubscriberCallback) // IODataProviderException                                
-                        : d->dataGenerator->subscribe(*asyncNodeIds,
-                        *d->ioDataProviderSubscriberCallback);
+                // (demand driven subscriptions: only read the initial values)
+                std::vector<NodeData*>* results = d->dataGenerator != NULL ?
+                        d->dataGenerator->subscribe(*asyncNodeIds,
+                        *d->ioDataProviderSubscriberCallback)
+                        : d->demandSubscriptionManager != NULL ?
+                        d->ioDataProvider->read(*asyncNodeIds) // IODataProviderException
+                        : d->ioDataProvider->subscribe(*asyncNodeIds,
+                        *d->ioDataProviderSubscriberCallback); // IODataProviderException
                 //Test unsubscribe
 				//if (d->dataGenerator == NULL){
 				//	d->ioDataProvider->unsubscribe(*asyncNodeIds);
@@ -786,7 +1294,7 @@ namespace SASModelProviderNamespace {
                         // continue with next variable
                         continue;
                     }
-                    if (result->getException() == NULL) {
+                    if (!result->hasError()) {
                         try {
                             // convert Variant to UaVariant
                             UaVariant* value = result->getData() == NULL ?
@@ -796,6 +1304,10 @@ namespace SASModelProviderNamespace {
                             ScopeGuard<UaVariant> valueSG(value);                            
                             // set the value to the server cache
                             d->haNodeManager->setVariable(*variable, *value); // HaNodeManagerException
+                            // save the value as reference for the received values
+                            if (d->ingressFilter != NULL) {
+                                d->ingressFilter->commit(*result);
+                            }
                         } catch (Exception& e) {
                             if (exception == NULL) {
                                 exception = new ExceptionDef(HaNodeManagerIODataProviderBridgeException,
@@ -844,24 +1356,157 @@ namespace SASModelProviderNamespace {
         return d->converter->convertIo2ua(value, dataTypeId);
     }
 
+    void HaNodeManagerIODataProviderBridge::convert(const Variant& value,
+            const UaNodeId & dataTypeId, UaVariant& dest) /* throws ConversionException */ {
+        d->converter->convertIo2ua(value, dataTypeId, dest);
+    }
+
     Variant * HaNodeManagerIODataProviderBridge::convert(
             const UaVariant& value, const UaNodeId & dataTypeId) /* throws ConversionException */ {
         return d->converter->convertUa2io(value, dataTypeId);
     }
 
-    NodeProperties::ValueHandling HaNodeManagerIODataProviderBridgePrivate::getValueHandling(
-            const NodeId & nodeId) {
-        // get node properties
-        const NodeProperties* nodeProps = dfltNodeProps;
+    bool HaNodeManagerIODataProviderBridgePrivate::hasIngressFilters() {
+        if (conf.ingressSuppressEqualValues || conf.ingressAbsoluteDeadband > 0
+                || conf.ingressPercentDeadband > 0
+                || (dfltNodeProps != NULL && dfltNodeProps->hasIngressFilter())) {
+            return true;
+        }
+        if (nodePropsMap != NULL) {
+            for (std::vector<const NodeData*>::const_iterator i = nodePropsMap->begin();
+                    i != nodePropsMap->end(); i++) {
+                const NodeProperties* nodeProps =
+                        static_cast<const NodeProperties*> ((*i)->getData());
+                if (nodeProps != NULL && nodeProps->hasIngressFilter()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void HaNodeManagerIODataProviderBridgePrivate::setIngressFilter(const NodeId& nodeId,
+            UaVariable& variable) {
+        bool suppressEqualValues = conf.ingressSuppressEqualValues;
+        double absoluteDeadband = conf.ingressAbsoluteDeadband;
+        double percentDeadband = conf.ingressPercentDeadband;
+        const NodeProperties* nodeProps = getNodeProperties(nodeId);
+        if (nodeProps != NULL && nodeProps->hasIngressFilter()) {
+            suppressEqualValues = nodeProps->getIngressSuppressEqualValues();
+            absoluteDeadband = nodeProps->getIngressAbsoluteDeadband();
+            percentDeadband = nodeProps->getIngressPercentDeadband();
+        }
+        if (suppressEqualValues || absoluteDeadband > 0 || percentDeadband > 0) {
+            ingressFilter->setFilter(nodeId, suppressEqualValues,
+                    getIngressDeadband(variable, absoluteDeadband, percentDeadband));
+        } else {
+            ingressFilter->removeFilter(nodeId);
+        }
+    }
+
+    double HaNodeManagerIODataProviderBridgePrivate::getIngressDeadband(UaVariable& variable,
+            double absoluteDeadband, double percentDeadband) {
+        if (percentDeadband > 0) {
+            UaVariable* euRangeVariable = static_cast<UaVariable*> (
+                    variable.getUaReferenceLists()->getTargetNodeByBrowseName(
+                    UaQualifiedName("EURange", 0 /*nsIndex*/)));
+            if (euRangeVariable != NULL) {
+                UaVariant euRangeValue(*euRangeVariable->value(NULL /*session*/).value());
+                UaExtensionObject euRangeEO;
+                if (euRangeValue.toExtensionObject(euRangeEO).isGood()) {
+                    UaRange euRange(euRangeEO);
+                    return percentDeadband / 100 * fabs(euRange.getHigh() - euRange.getLow());
+                }
+            }
+        }
+        return absoluteDeadband;
+    }
+
+    void HaNodeManagerIODataProviderBridgePrivate::setCacheValues(
+            const std::vector<NodeData*>& newValues) {
+        std::vector<UaVariable*> variables;
+        std::vector<UaVariant*>* values = new std::vector<UaVariant*>();
+        VectorScopeGuard<UaVariant> valuesSG(values);
+        // the node data of the values
+        std::vector<const NodeData*> variableNodeData;
+        for (std::vector<NodeData*>::const_iterator i = newValues.begin();
+                i != newValues.end(); i++) {
+            NodeData& nodeData = **i;
+            if (nodeData.hasError()) {
+                continue;
+            }
+            UaVariable* variable = NULL;
+            try {
+                // convert NodeId to UaNodeId
+                UaNodeId* nodeId = converter->convertIo2ua(nodeData.getNodeId()); // ConversionException
+                ScopeGuard<UaNodeId> nodeIdSG(nodeId);
+                variable = nodeBrowser->getVariable(*nodeId);
+                if (variable == NULL) {
+                    continue;
+                }
+                // convert Variant to UaVariant
+                UaVariant* value = nodeData.getData() == NULL ? new UaVariant()
+                        : converter->convertIo2ua(*nodeData.getData(),
+                        variable->dataType()); // ConversionException
+                variables.push_back(variable);
+                values->push_back(value);
+                variableNodeData.push_back(&nodeData);
+            } catch (Exception& e) {
+                if (variable != NULL) {
+                    variable->releaseReference();
+                }
+                // the value of the node is skipped, the other values are set
+                // (similar messages are throttled while e.g. the IO data provider sends
+                // values of an unexpected type)
+                LogThrottle* throttle =
+                        LoggerFactory::getLogThrottle("HaNodeManagerIODataProviderBridge");
+                if (throttle == NULL
+                        || throttle->pass("Exception while converting value for %s: %s",
+                        nodeData.getNodeId().toString())) {
+                    std::string st;
+                    e.getStackTrace(st);
+                    log->error("Exception while converting value for %s: %s",
+                            nodeData.getNodeId().toString().c_str(), st.c_str());
+                }
+            }
+        }
+        try {
+            // set the values to the server cache
+            haNodeManager->setVariables(variables, *values); // HaNodeManagerException
+            // save the values as reference for the received values
+            if (ingressFilter != NULL) {
+                for (std::vector<const NodeData*>::const_iterator i = variableNodeData.begin();
+                        i != variableNodeData.end(); i++) {
+                    ingressFilter->commit(**i);
+                }
+            }
+        } catch (Exception& e) {
+            // there is no way to inform the OPC UA server => log the exception
+            std::string st;
+            e.getStackTrace(st);
+            log->error("Exception while setting values to server cache: %s", st.c_str());
+        }
+        for (std::vector<UaVariable*>::iterator i = variables.begin(); i != variables.end(); i++) {
+            (*i)->releaseReference();
+        }
+    }
+
+    const NodeProperties* HaNodeManagerIODataProviderBridgePrivate::getNodeProperties(
+            const NodeId& nodeId) {
         if (nodePropsMap != NULL) {
             for (std::vector<const NodeData*>::const_iterator i =
                     nodePropsMap->begin(); i != nodePropsMap->end(); i++) {
                 if (nodeId.equals((*i)->getNodeId())) {
-                    nodeProps = static_cast<const NodeProperties*> ((*i)->getData());
-                    break;
+                    return static_cast<const NodeProperties*> ((*i)->getData());
                 }
             }
         }
+        return dfltNodeProps;
+    }
+
+    NodeProperties::ValueHandling HaNodeManagerIODataProviderBridgePrivate::getValueHandling(
+            const NodeId & nodeId) {
+        const NodeProperties* nodeProps = getNodeProperties(nodeId);
         if (nodeProps != NULL) {
             return nodeProps->getValueHandling();
         }
@@ -1,12 +1,16 @@
 #include "EventTypeData.h"
 #include <common/Exception.h>
 #include <common/ScopeGuard.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/LogThrottle.h>
 #include <common/logging/Logger.h>
 #include <common/logging/LoggerFactory.h>
+#include <sasModelProvider/base/EventTypeDataPool.h>
 #include <sasModelProvider/base/IODataProviderSubscriberCallback.h>
 #include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
 #include <ioDataProvider/Event.h>
 #include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
 #include <ioDataProvider/OpcUaEventData.h>
 #include <ioDataProvider/Scalar.h>
 #include <ioDataProvider/SubscriberCallbackException.h>
@@ -29,21 +33,39 @@ namespace SASModelProviderNamespace {
 
         HaNodeManager* haNodeManager;
         NodeBrowser* nodeBrowser;
+        IngressFilter* ingressFilter;
+        // reusable event objects
+        EventTypeDataPool* eventPool;
 
         // dateTime: milliseconds since 01.01.1970
         void processOpcUaEvent(long long time, const UaNodeId& eventTypeId,
                 const OpcUaEventData& eventData) /* throws ConversionException, SubscriberCallbackException */;
+        // Resolves a field of an event type and caches it in the event pool.
+        const EventTypeDataPool::Field* addField(const UaNodeId& eventTypeId,
+                const NodeId& ioFieldNodeId) /* throws ConversionException, SubscriberCallbackException */;
     };
 
     IODataProviderSubscriberCallback::IODataProviderSubscriberCallback(
-            HaNodeManager& haNodeManager) {
+            HaNodeManager& haNodeManager, IngressFilter* ingressFilter) {
         d = new IODataProviderSubscriberCallbackPrivate();
         d->log = LoggerFactory::getLogger("IODataProviderSubscriberCallback");
         d->haNodeManager = &haNodeManager;
+        d->ingressFilter = ingressFilter;
         d->nodeBrowser = new NodeBrowser(haNodeManager);
+        d->eventPool = new EventTypeDataPool(haNodeManager.getEventTypeRegistry(),
+                16 /* maxIdleCount */);
     }
 
     IODataProviderSubscriberCallback::~IODataProviderSubscriberCallback() {
+        if (d->log->isInfoEnabled()) {
+            EventTypeDataPool::Metrics metrics = d->eventPool->getMetrics();
+            if (metrics.acquireCount > 0) {
+                d->log->info("Event pool: events=%lu,hit rate=%.1f%%,high water mark=%lu",
+                        metrics.acquireCount, metrics.hitCount * 100.0 / metrics.acquireCount,
+                        metrics.highWaterMark);
+            }
+        }
+        delete d->eventPool;
         delete d->nodeBrowser;
         delete d;
     }
@@ -54,115 +76,208 @@ namespace SASModelProviderNamespace {
                 d->haNodeManager->getIODataProviderBridge();
         const std::vector<const NodeData*>& nodeDataList = event.getNodeData();
         SubscriberCallbackException* exception = NULL;
+        // resolve the variables and convert the values,
+        // OPC UA events are processed immediately
+        std::vector<UaVariable*> variables;
+        std::vector<UaVariant*>* values = new std::vector<UaVariant*>();
+        VectorScopeGuard<UaVariant> valuesSG(values);
+        // the received values of the variables
+        std::vector<const NodeData*> variableNodeData;
         for (int i = 0; i < nodeDataList.size(); i++) {
             const NodeData& nodeData = *nodeDataList[i];
-            try {                
+            bool isOpcUaEvent = nodeData.getData() != NULL
+                    && nodeData.getData()->getVariantType() == Variant::OPC_UA_EVENT_DATA;
+            // skip events which are not delivered to any client before any conversion
+            if (isOpcUaEvent && !nmioBridge.isEventMonitored()) {
+                nmioBridge.eventSkipped();
+                continue;
+            }
+            // skip failed nodes without creating exceptions
+            if (nodeData.hasError()) {
+                if (d->log->isDebugEnabled()) {
+                    d->log->debug("Skipping failed node %s: %s",
+                            nodeData.getNodeId().toString().c_str(),
+                            nodeData.getException()->getMessage().c_str());
+                }
+                continue;
+            }
+            // skip unchanged values before any conversion
+            if (d->ingressFilter != NULL && !d->ingressFilter->pass(nodeData)) {
+                continue;
+            }
+            try {
                 // convert NodeId to UaNodeId
-            	//d->log->error("Convert-> %s", nodeData.getNodeId().toString().c_str());
                 UaNodeId* nodeId = nmioBridge.convert(nodeData.getNodeId()); // ConversionException
                 ScopeGuard<UaNodeId> nodeIdSG(nodeId);
                 // if OPC UA event
-                if (nodeData.getData() != NULL && nodeData.getData()->getVariantType()
-                        == Variant::OPC_UA_EVENT_DATA) {
+                if (isOpcUaEvent) {
                     // process the event
                     d->processOpcUaEvent(event.getDateTime(), *nodeId,
                             *static_cast<const OpcUaEventData*> (nodeData.getData())); // ConversionException, SubscriberCallbackException
                 } else {
-                	//d->log->error("NodeBrowser-> %s", nodeId->toString().toUtf8());
+                    // the variable is taken from the cache of the node browser
                     UaVariable* variable = d->nodeBrowser->getVariable(*nodeId);
                     if (variable == NULL) {
-                    	return;
-//                        throw ExceptionDef(SubscriberCallbackException,
-//                                std::string("Unknown variable ")
-//                                .append(" received"));
+                        if (d->log->isDebugEnabled()) {
+                            d->log->debug("Skipping value of unknown variable %s",
+                                    nodeId->toXmlString().toUtf8());
+                        }
+                        continue;
                     }
-                    //d->log->error("<-NodeBrowser %s", nodeData.getNodeId().toString().c_str());
+                    UaVariant* value;
                     try {
                         // convert Variant to UaVariant
-                        UaVariant* value = nodeData.getData() == NULL ? new UaVariant()
+                        value = nodeData.getData() == NULL ? new UaVariant()
                                 : nmioBridge.convert(*nodeData.getData(),
-                                variable->dataType()); // ConversionException                                  
-                        ScopeGuard<UaVariant> valueSG(value);
-                        // update variable
-                        d->haNodeManager->setVariable(*variable, *value); // HaNodeManagerException
-                        variable->releaseReference();
+                                variable->dataType()); // ConversionException
                     } catch (Exception& e) {
                         variable->releaseReference();
                         throw;
                     }
+                    values->push_back(value);
+                    variables.push_back(variable);
+                    variableNodeData.push_back(&nodeData);
+                }
+            } catch (Exception& e) {
+                if (exception == NULL) {
+                    exception = new ExceptionDef(SubscriberCallbackException,
+                            std::string("Processing of event failed"));
+                    // the throttle is keyed on the message template and the node because
+                    // the exception messages contain varying details
+                    LogThrottle* throttle =
+                            LoggerFactory::getLogThrottle("IODataProviderSubscriberCallback");
+                    std::string node = nodeData.getNodeId().toString();
+                    if (throttle == NULL
+                            || throttle->pass("Processing of event failed for %s: %s", node)) {
+                        d->log->info("Processing of event failed for %s: %s", node.c_str(),
+                                e.getMessage().c_str());
+                    }
+                    exception->setCause(&e);
+                }
+            }
+        }
+        // update all variables with one lock of the node manager
+        if (variables.size() > 0) {
+            try {
+                d->haNodeManager->setVariables(variables, *values); // HaNodeManagerException
+                // save the set values as reference for the next values
+                if (d->ingressFilter != NULL) {
+                    for (size_t i = 0; i < variableNodeData.size(); i++) {
+                        d->ingressFilter->commit(*variableNodeData[i]);
+                    }
                 }
             } catch (Exception& e) {
                 if (exception == NULL) {
                     exception = new ExceptionDef(SubscriberCallbackException,
                             std::string("Processing of event failed"));
-                    d->log->info(e.getMessage().c_str());
+                    LogThrottle* throttle =
+                            LoggerFactory::getLogThrottle("IODataProviderSubscriberCallback");
+                    if (throttle == NULL
+                            || throttle->pass("Setting of variables failed: %s")) {
+                        d->log->info("Setting of variables failed: %s", e.getMessage().c_str());
+                    }
                     exception->setCause(&e);
                 }
             }
         }
+        for (int i = 0; i < variables.size(); i++) {
+            variables[i]->releaseReference();
+        }
         if (exception != NULL) {
-        	return;
+            delete exception;
         }
     }
 
-    void IODataProviderSubscriberCallbackPrivate::processOpcUaEvent(long long time,
-            const UaNodeId& eventTypeId, const OpcUaEventData& eventData)
+    bool IODataProviderSubscriberCallback::isEventMonitored(const NodeId& eventTypeId) {
+        return d->haNodeManager->getIODataProviderBridge().isEventMonitored();
+    }
+
+    void IODataProviderSubscriberCallback::eventSkipped(const NodeId& eventTypeId) {
+        d->haNodeManager->getIODataProviderBridge().eventSkipped();
+    }
+
+    const EventTypeDataPool::Field* IODataProviderSubscriberCallbackPrivate::addField(
+            const UaNodeId& eventTypeId, const NodeId& ioFieldNodeId)
     /* throws ConversionException, SubscriberCallbackException */ {
-        HaNodeManagerIODataProviderBridge& nmioBridge = haNodeManager->getIODataProviderBridge();
-        EventTypeData uaEvent(*eventTypeId, haNodeManager->getEventTypeRegistry());
-        // SourceNode
         // convert NodeId to UaNodeId
-        UaNodeId* sourceNodeId = nmioBridge.convert(
-                eventData.getSourceNodeId()); // ConversionException
-        ScopeGuard<UaNodeId> sourceNodeIdSG(sourceNodeId);
-        uaEvent.setSourceNode(*sourceNodeId);
-        // SourceName
-        UaNode* sourceNode = nodeBrowser->getNode(*sourceNodeId);
-        if (sourceNode == NULL) {
+        UaNodeId* fieldNodeId = haNodeManager->getIODataProviderBridge().convert(
+                ioFieldNodeId); // ConversionException
+        ScopeGuard<UaNodeId> fieldNodeIdSG(fieldNodeId);
+        UaVariable* variable = nodeBrowser->getVariable(*fieldNodeId);
+        if (variable == NULL) {
             throw ExceptionDef(SubscriberCallbackException,
-                    std::string("Unknown source node ").append(sourceNodeId->toXmlString().toUtf8())
-                    .append(" for event type ").append(eventTypeId.toXmlString().toUtf8())
-                    .append(" received"));
+                    std::string("Unknown event field ")
+                    .append(fieldNodeId->toXmlString().toUtf8()).append(" received"));
         }
-        uaEvent.setSourceName(sourceNode->browseName().toString());
-        sourceNode->releaseReference();
-        uaEvent.setMessage(
-                UaLocalizedText("en",
-                UaString(eventData.getMessage().c_str())));
-        uaEvent.setSeverity(eventData.getSeverity());
-        // set time stamps (in 100 ns) and unique EventId
-        // 01.01.1601 - 01.01.1970: 11644473600 seconds        
-        uaEvent.prepareNewEvent(
-                UaDateTime(time * 10000 + 116444736000000000),
-                UaDateTime::now() /* receiveTime */,
-                UaByteString() /* userEventId */);
-        // set field data
-        const std::vector<const NodeData*>& fieldData = eventData.getFieldData();
-        std::map<UaNodeId*, UaVariant*> addedFieldData;
+        UaNodeId dataTypeId = variable->dataType();
+        variable->releaseReference();
+        return eventPool->addField(eventTypeId, ioFieldNodeId, *fieldNodeId, dataTypeId);
+    }
+
+    void IODataProviderSubscriberCallbackPrivate::processOpcUaEvent(long long time,
+            const UaNodeId& eventTypeId, const OpcUaEventData& eventData)
+    /* throws ConversionException, SubscriberCallbackException */ {
+        HaNodeManagerIODataProviderBridge& nmioBridge = haNodeManager->getIODataProviderBridge();
+        EventTypeData& uaEvent = *eventPool->acquire(eventTypeId);
         try {
+            // SourceNode
+            // convert NodeId to UaNodeId
+            UaNodeId* sourceNodeId = nmioBridge.convert(
+                    eventData.getSourceNodeId()); // ConversionException
+            ScopeGuard<UaNodeId> sourceNodeIdSG(sourceNodeId);
+            uaEvent.setSourceNode(*sourceNodeId);
+            // SourceName
+            UaNode* sourceNode = nodeBrowser->getNode(*sourceNodeId);
+            if (sourceNode == NULL) {
+                throw ExceptionDef(SubscriberCallbackException,
+                        std::string("Unknown source node ").append(sourceNodeId->toXmlString().toUtf8())
+                        .append(" for event type ").append(eventTypeId.toXmlString().toUtf8())
+                        .append(" received"));
+            }
+            uaEvent.setSourceName(sourceNode->browseName().toString());
+            sourceNode->releaseReference();
+            uaEvent.setMessage(
+                    UaLocalizedText("en",
+                    UaString(eventData.getMessage().c_str())));
+            uaEvent.setSeverity(eventData.getSeverity());
+            // set time stamps (in 100 ns) and unique EventId
+            // 01.01.1601 - 01.01.1970: 11644473600 seconds
+            uaEvent.prepareNewEvent(
+                    UaDateTime(time * 10000 + 116444736000000000),
+                    UaDateTime::now() /* receiveTime */,
+                    UaByteString() /* userEventId */);
+            // set field data
+            const std::vector<const NodeData*>& fieldData = eventData.getFieldData();
             for (size_t i = 0; i < fieldData.size(); i++) {
                 const NodeData& nodeData = *fieldData[i];
-                // convert NodeId to UaNodeId
-                UaNodeId* fieldNodeId = nmioBridge.convert(nodeData.getNodeId()); // ConversionException
-                ScopeGuard<UaNodeId> fieldNodeIdSG(fieldNodeId);
-                UaVariable* variable = nodeBrowser->getVariable(*fieldNodeId);
-                if (variable == NULL) {
-                    throw ExceptionDef(SubscriberCallbackException,
-                            std::string("Unknown event field ")
-                            .append(fieldNodeId->toXmlString().toUtf8()).append(" received"));
+                // the field is resolved once per event type and cached in the pool
+                const EventTypeDataPool::Field* field =
+                        eventPool->getField(eventTypeId, nodeData.getNodeId());
+                if (field == NULL) {
+                    field = addField(eventTypeId, nodeData.getNodeId()); // ConversionException, SubscriberCallbackException
+                }
+                if (field->index < 0) {
+                    // the field had not been registered when it was cached
+                    UaVariant fieldValue;
+                    if (nodeData.getData() != NULL) {
+                        nmioBridge.convert(*nodeData.getData(), field->dataTypeId,
+                                fieldValue); // ConversionException
+                    }
+                    uaEvent.moveFieldData(field->nodeId, fieldValue);
+                    continue;
                 }
-                try {
-                    // convert Variant to UaVariant
-                    UaVariant* fieldValue = nodeData.getData() == NULL ? new UaVariant()
-                            : nmioBridge.convert(*nodeData.getData(),
-                            variable->dataType()); // ConversionException                            
-                    // add field data to event
-                    uaEvent.addFieldData(*fieldNodeId, *fieldValue);
-                    addedFieldData[fieldNodeIdSG.detach()] = fieldValue;
-                    variable->releaseReference();
-                } catch (Exception& e) {
-                    variable->releaseReference();
-                    throw;
+                // convert Variant to UaVariant directly into the slot of the event
+                UaVariant& fieldValue = uaEvent.getFieldSlot(field->index);
+                if (nodeData.getData() == NULL) {
+                    fieldValue.clear();
+                } else {
+                    nmioBridge.convert(*nodeData.getData(), field->dataTypeId,
+                            fieldValue); // ConversionException
+                }
+                if (log->isDebugEnabled()) {
+                    log->debug(" field nodeId=%s,value=%s",
+                            field->nodeId.toXmlString().toUtf8(),
+                            fieldValue.toString().toUtf8());
                 }
             }
             // fire the event
@@ -172,28 +287,11 @@ namespace SASModelProviderNamespace {
                 log->info("Fired event %s %s", eventTypeId.toXmlString().toUtf8(),
                         uaEvent.getMessage().toString().toUtf8());
             }
-            // for each added field data
-            for (std::map<UaNodeId*, UaVariant*>::iterator i =
-                    addedFieldData.begin(); i != addedFieldData.end(); i++) {
-                UaNodeId* fieldNodeId = (*i).first;
-                UaVariant* fieldValue = (*i).second;
-                if (log->isDebugEnabled()) {
-                    log->debug(" field nodeId=%s,value=%s", fieldNodeId->toXmlString().toUtf8(),
-                            fieldValue->toString().toUtf8());
-                }
-                // delete field data
-                delete fieldNodeId;
-                delete fieldValue;
-            }
         } catch (Exception& e) {
-            // delete added field data
-            for (std::map<UaNodeId*, UaVariant*>::iterator i =
-                    addedFieldData.begin(); i != addedFieldData.end(); i++) {
-                delete (*i).first;
-                delete (*i).second;
-            }
+            eventPool->release(&uaEvent);
             throw;
         }
+        eventPool->release(&uaEvent);
     }
 
 } // namespace SASModelProviderNamespace
@@ -0,0 +1,242 @@
+#include <sasModelProvider/base/IngressFilter.h>
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <ioDataProvider/Scalar.h>
+#include <ioDataProvider/Variant.h>
+#include <math.h> // fabs
+#include <pthread.h> // pthread_mutex_t
+#include <stddef.h> // NULL
+#include <string.h> // memcmp, memset
+#include <map>
+#include <string>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace SASModelProviderNamespace {
+
+    class IngressFilterPrivate {
+        friend class IngressFilter;
+    private:
+
+        class Filter {
+        public:
+            bool suppressEqualValues;
+            double deadband;
+            // last committed value (NULL: no value has been committed yet)
+            Scalar* lastValue;
+        };
+
+        pthread_mutex_t mutex;
+        typedef std::map<NodeId, Filter, NodeId::Less> Filters;
+        // nodeId -> filter
+        Filters filters;
+        IngressFilter::Metrics metrics;
+
+        // Gets the value of a numeric scalar. Returns false for other scalar types.
+        bool getNumber(const Scalar& value, double& ret);
+        bool equals(const std::string* value1, const std::string* value2);
+        bool equals(const Scalar& value1, const Scalar& value2);
+    };
+
+    IngressFilter::IngressFilter() /* throws MutexException */ {
+        d = new IngressFilterPrivate();
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for ingress filter");
+        }
+    }
+
+    IngressFilter::~IngressFilter() {
+        for (IngressFilterPrivate::Filters::iterator i = d->filters.begin();
+                i != d->filters.end(); i++) {
+            delete (*i).second.lastValue;
+        }
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    void IngressFilter::setFilter(const NodeId& nodeId, bool suppressEqualValues,
+            double deadband) {
+        pthread_mutex_lock(&d->mutex);
+        IngressFilterPrivate::Filters::iterator i = d->filters.find(nodeId);
+        if (i == d->filters.end()) {
+            IngressFilterPrivate::Filter filter;
+            filter.lastValue = NULL;
+            i = d->filters.insert(std::make_pair(nodeId, filter)).first;
+        }
+        (*i).second.suppressEqualValues = suppressEqualValues;
+        (*i).second.deadband = deadband;
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    void IngressFilter::removeFilter(const NodeId& nodeId) {
+        pthread_mutex_lock(&d->mutex);
+        IngressFilterPrivate::Filters::iterator i = d->filters.find(nodeId);
+        if (i != d->filters.end()) {
+            delete (*i).second.lastValue;
+            d->filters.erase(i);
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    void IngressFilter::reset(const NodeId& nodeId) {
+        pthread_mutex_lock(&d->mutex);
+        IngressFilterPrivate::Filters::iterator i = d->filters.find(nodeId);
+        if (i != d->filters.end()) {
+            delete (*i).second.lastValue;
+            (*i).second.lastValue = NULL;
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    bool IngressFilter::pass(const NodeData& nodeData) {
+        if (nodeData.hasError()) {
+            return true;
+        }
+        bool ret = true;
+        pthread_mutex_lock(&d->mutex);
+        IngressFilterPrivate::Filters::iterator i = d->filters.find(nodeData.getNodeId());
+        if (i != d->filters.end()) {
+            IngressFilterPrivate::Filter& filter = (*i).second;
+            const Variant* data = nodeData.getData();
+            if (filter.lastValue != NULL && data != NULL
+                    && data->getVariantType() == Variant::SCALAR) {
+                const Scalar& value = *static_cast<const Scalar*> (data);
+                double number;
+                double lastNumber;
+                if (filter.deadband > 0 && d->getNumber(value, number)
+                        && d->getNumber(*filter.lastValue, lastNumber)
+                        && fabs(number - lastNumber) <= filter.deadband) {
+                    d->metrics.suppressedDeadbandCount++;
+                    ret = false;
+                } else if (filter.suppressEqualValues && d->equals(value, *filter.lastValue)) {
+                    d->metrics.suppressedEqualCount++;
+                    ret = false;
+                }
+            }
+            if (ret) {
+                d->metrics.passedCount++;
+            }
+        }
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void IngressFilter::commit(const NodeData& nodeData) {
+        if (nodeData.hasError()) {
+            return;
+        }
+        pthread_mutex_lock(&d->mutex);
+        IngressFilterPrivate::Filters::iterator i = d->filters.find(nodeData.getNodeId());
+        if (i != d->filters.end()) {
+            IngressFilterPrivate::Filter& filter = (*i).second;
+            const Variant* data = nodeData.getData();
+            delete filter.lastValue;
+            // a value which cannot be compared is not saved
+            filter.lastValue = data == NULL || data->getVariantType() != Variant::SCALAR
+                    ? NULL : new Scalar(*static_cast<const Scalar*> (data));
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    int IngressFilter::size() {
+        pthread_mutex_lock(&d->mutex);
+        int ret = d->filters.size();
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    IngressFilter::Metrics IngressFilter::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    bool IngressFilterPrivate::getNumber(const Scalar& value, double& ret) {
+        switch (value.getScalarType()) {
+            case Scalar::SCHAR:
+                ret = value.getSChar();
+                return true;
+            case Scalar::INT:
+                ret = value.getInt();
+                return true;
+            case Scalar::UINT:
+                ret = value.getUInt();
+                return true;
+            case Scalar::LONG:
+                ret = value.getLong();
+                return true;
+            case Scalar::ULONG:
+                ret = value.getULong();
+                return true;
+            case Scalar::LLONG:
+                ret = value.getLLong();
+                return true;
+            case Scalar::ULLONG:
+                ret = value.getULLong();
+                return true;
+            case Scalar::FLOAT:
+                ret = value.getFloat();
+                return true;
+            case Scalar::DOUBLE:
+                ret = value.getDouble();
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool IngressFilterPrivate::equals(const std::string* value1, const std::string* value2) {
+        return value1 == NULL || value2 == NULL ? value1 == value2 : *value1 == *value2;
+    }
+
+    bool IngressFilterPrivate::equals(const Scalar& value1, const Scalar& value2) {
+        if (value1.getScalarType() != value2.getScalarType()) {
+            return false;
+        }
+        switch (value1.getScalarType()) {
+            case Scalar::BOOL:
+                return value1.getBool() == value2.getBool();
+            case Scalar::SCHAR:
+                return value1.getSChar() == value2.getSChar();
+            case Scalar::CHAR:
+                return value1.getChar() == value2.getChar();
+            case Scalar::INT:
+                return value1.getInt() == value2.getInt();
+            case Scalar::UINT:
+                return value1.getUInt() == value2.getUInt();
+            case Scalar::LONG:
+                return value1.getLong() == value2.getLong();
+            case Scalar::ULONG:
+                return value1.getULong() == value2.getULong();
+            case Scalar::LLONG:
+                return value1.getLLong() == value2.getLLong();
+            case Scalar::ULLONG:
+                return value1.getULLong() == value2.getULLong();
+            case Scalar::FLOAT:
+                return value1.getFloat() == value2.getFloat();
+            case Scalar::DOUBLE:
+                return value1.getDouble() == value2.getDouble();
+            case Scalar::STRING:
+                return equals(value1.getString(), value2.getString());
+            case Scalar::BYTE_STRING:
+                return value1.getByteStringLength() == value2.getByteStringLength()
+                        && (value1.getByteStringLength() <= 0
+                        || memcmp(value1.getByteString(), value2.getByteString(),
+                        value1.getByteStringLength()) == 0);
+            case Scalar::LOCALIZED_TEXT:
+                return equals(value1.getLocalizedTextLocale(), value2.getLocalizedTextLocale())
+                        && equals(value1.getLocalizedTextText(), value2.getLocalizedTextText());
+            default:
+                // unknown content => the values are handled as different values
+                return false;
+        }
+    }
+
+} // namespace SASModelProviderNamespace
@@ -1,34 +1,192 @@
 #include <sasModelProvider/base/NodeBrowser.h>
 #include <sasModelProvider/base/NodeBrowserException.h>
+#include <common/Exception.h>
 #include <opcuatypes.h> // ServiceContext
 #include <opcua_types.h> // OpcUa_ViewDescription
 #include <opcua_p_types.h> // OpcUa_UInt32
 #include <continuationpoint.h> // BrowseContext
 #include <opcua_builtintypes.h> // OpcUa_NodeId
 #include <uaarraytemplates.h> // UaReferenceDescriptions
+#include <pthread.h> // pthread_mutex_t
 #include <map>
+#include <set>
 #include <sstream> // std::ostringstream
 #include <vector>
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
 
 namespace SASModelProviderNamespace {
 
     class NodeBrowserPrivate {
         friend class NodeBrowser;
     private:
+        // protects the set of node browsers and the stopped node managers
+        static pthread_mutex_t registryMutex;
+        static std::set<NodeBrowserPrivate*> nodeBrowsers;
+        static std::set<NodeManagerUaNode*> stoppedNodeManagers;
+
+        // the super types of a type in the flat array of super types
+        class TypeEntry {
+        public:
+            // index of the nearest super type
+            int offset;
+            // count of super types incl. the first one in namespace 0
+            int count;
+            // the last super type (null if the type has no super types)
+            UaNodeId buildInType;
+        };
+
+        // protects the type hierarchy
+        static pthread_mutex_t typeMutex;
+        // typeId -> super types (only types with a namespace index > 0)
+        static std::map<UaNodeId, TypeEntry> typeEntries;
+        // the concatenated super type chains
+        static std::vector<UaNodeId> superTypeIds;
+
+        // namespace index -> node manager
+        // The size of a published table is not changed. An entry is only changed once from
+        // NULL (not searched yet) to the node manager or to "noNodeManager".
+        class NamespaceTable {
+        public:
+            std::vector<NodeManagerUaNode*> nodeManagers;
+        };
+
+        // marks a namespace without node manager in the namespace table
+        static NodeManagerUaNode* const noNodeManager;
+
         HaNodeManager* nodeManager;
 
+        // the current namespace table: it is read without lock and replaced with the
+        // registry mutex locked (see reset)
+        NamespaceTable* namespaceTable;
+        // the replaced namespace tables which may still be read by other threads; they are
+        // destroyed with the node browser (the table is only replaced if a node manager is
+        // started or stopped or the table must be enlarged)
+        std::vector<NamespaceTable*> replacedNamespaceTables;
+        // protects the variable cache
+        pthread_mutex_t mutex;
+        // nodeId -> variable (a reference is held for each variable)
+        std::map<UaNodeId, UaVariable*> variables;
+
         NodeManagerUaNode* getNodeManagerUaNode(const UaNodeId& nodeId);
+        // Searches the node manager for a namespace in the own and the associated
+        // node managers. The registry mutex must be locked by the caller.
+        NodeManagerUaNode* findNodeManagerUaNode(OpcUa_UInt16 namespaceIndex);
+        // Rebuilds the namespace table and clears the variable cache.
+        // The registry mutex must be locked by the caller.
+        void reset();
+        // Publishes a new namespace table. The registry mutex must be locked by the caller.
+        void setNamespaceTable(NamespaceTable* table);
+        // Releases the references to the cached variables. The mutex must be locked by
+        // the caller.
+        void clearVariables();
+
+        // Builds the type hierarchy for all data types and object types by browsing the
+        // sub types starting at the base types.
+        void buildTypeHierarchy() /* throws NodeBrowserException */;
+        // Copies the super types of a type from the type hierarchy. If the type is unknown
+        // then the super types are browsed and added to the type hierarchy.
+        // Returns false if the type does not exist.
+        bool getSuperTypes(const UaNodeId& typeId, std::vector<UaNodeId>& superTypes)
+        /* throws NodeBrowserException */;
+        // Gets the last super type of a type from the type hierarchy without copying the
+        // super types. If the type is unknown then the super types are browsed and added
+        // to the type hierarchy.
+        // Returns false if the type does not exist.
+        bool getBuildInType(const UaNodeId& typeId, UaNodeId& buildInType)
+        /* throws NodeBrowserException */;
+        // Browses the super types of a type and adds them to the type hierarchy.
+        // Returns false if the type does not exist.
+        bool addSuperTypes(const UaNodeId& typeId, std::vector<UaNodeId>& superTypes)
+        /* throws NodeBrowserException */;
+        // Browses the HasSubtype references of a type.
+        void browseTypes(UaNode& type, OpcUa_BrowseDirection direction,
+                std::vector<UaNodeId>& typeIds) /* throws NodeBrowserException */;
     };
 
+    pthread_mutex_t NodeBrowserPrivate::registryMutex = PTHREAD_MUTEX_INITIALIZER;
+    std::set<NodeBrowserPrivate*> NodeBrowserPrivate::nodeBrowsers;
+    std::set<NodeManagerUaNode*> NodeBrowserPrivate::stoppedNodeManagers;
+    pthread_mutex_t NodeBrowserPrivate::typeMutex = PTHREAD_MUTEX_INITIALIZER;
+    std::map<UaNodeId, NodeBrowserPrivate::TypeEntry> NodeBrowserPrivate::typeEntries;
+    std::vector<UaNodeId> NodeBrowserPrivate::superTypeIds;
+    static int noNodeManagerMarker;
+    NodeManagerUaNode* const NodeBrowserPrivate::noNodeManager =
+            reinterpret_cast<NodeManagerUaNode*> (&noNodeManagerMarker);
+
     NodeBrowser::NodeBrowser(HaNodeManager& nodeManager) {
         d = new NodeBrowserPrivate();
         d->nodeManager = &nodeManager;
+        d->namespaceTable = NULL;
+        pthread_mutex_init(&d->mutex, NULL /*attr*/);
+        pthread_mutex_lock(&NodeBrowserPrivate::registryMutex);
+        d->reset();
+        NodeBrowserPrivate::nodeBrowsers.insert(d);
+        pthread_mutex_unlock(&NodeBrowserPrivate::registryMutex);
     }
 
     NodeBrowser::~NodeBrowser() {
+        pthread_mutex_lock(&NodeBrowserPrivate::registryMutex);
+        NodeBrowserPrivate::nodeBrowsers.erase(d);
+        pthread_mutex_unlock(&NodeBrowserPrivate::registryMutex);
+        d->clearVariables();
+        pthread_mutex_destroy(&d->mutex);
+        for (std::vector<NodeBrowserPrivate::NamespaceTable*>::iterator i =
+                d->replacedNamespaceTables.begin(); i != d->replacedNamespaceTables.end(); i++) {
+            delete *i;
+        }
+        delete d->namespaceTable;
         delete d;
     }
 
+    void NodeBrowser::nodeManagerStarted(HaNodeManager& nodeManager)
+    /* throws NodeBrowserException */ {
+        pthread_mutex_lock(&NodeBrowserPrivate::registryMutex);
+        NodeBrowserPrivate::stoppedNodeManagers.erase(&nodeManager.getNodeManagerBase());
+        for (std::set<NodeBrowserPrivate*>::iterator i = NodeBrowserPrivate::nodeBrowsers.begin();
+                i != NodeBrowserPrivate::nodeBrowsers.end(); i++) {
+            (*i)->reset();
+        }
+        pthread_mutex_unlock(&NodeBrowserPrivate::registryMutex);
+        // the node manager may have added types
+        NodeBrowser nodeBrowser(nodeManager);
+        nodeBrowser.d->buildTypeHierarchy(); // NodeBrowserException
+    }
+
+    void NodeBrowser::nodeManagerStopped(HaNodeManager& nodeManager) {
+        pthread_mutex_lock(&NodeBrowserPrivate::registryMutex);
+        NodeBrowserPrivate::stoppedNodeManagers.insert(&nodeManager.getNodeManagerBase());
+        for (std::set<NodeBrowserPrivate*>::iterator i = NodeBrowserPrivate::nodeBrowsers.begin();
+                i != NodeBrowserPrivate::nodeBrowsers.end(); i++) {
+            (*i)->reset();
+        }
+        pthread_mutex_unlock(&NodeBrowserPrivate::registryMutex);
+        // the types of the node manager are removed => the type hierarchy is rebuilt on demand
+        pthread_mutex_lock(&NodeBrowserPrivate::typeMutex);
+        NodeBrowserPrivate::typeEntries.clear();
+        NodeBrowserPrivate::superTypeIds.clear();
+        pthread_mutex_unlock(&NodeBrowserPrivate::typeMutex);
+    }
+
+    void NodeBrowser::nodeDeleted(const UaNodeId& nodeId) {
+        pthread_mutex_lock(&NodeBrowserPrivate::registryMutex);
+        for (std::set<NodeBrowserPrivate*>::iterator i = NodeBrowserPrivate::nodeBrowsers.begin();
+                i != NodeBrowserPrivate::nodeBrowsers.end(); i++) {
+            NodeBrowserPrivate& nb = **i;
+            pthread_mutex_lock(&nb.mutex);
+            std::map<UaNodeId, UaVariable*>::iterator variable = nb.variables.find(nodeId);
+            if (variable != nb.variables.end()) {
+                (*variable).second->releaseReference();
+                nb.variables.erase(variable);
+            }
+            pthread_mutex_unlock(&nb.mutex);
+        }
+        pthread_mutex_unlock(&NodeBrowserPrivate::registryMutex);
+    }
+
     UaDataType* NodeBrowser::getDataType(const UaNodeId& nodeId) {
         UaNode* node = getNode(nodeId);
         return node != NULL && node->nodeClass() == OpcUa_NodeClass_DataType ?
@@ -54,9 +212,34 @@ namespace SASModelProviderNamespace {
     }
 
     UaVariable* NodeBrowser::getVariable(const UaNodeId& nodeId) {
+        pthread_mutex_lock(&d->mutex);
+        std::map<UaNodeId, UaVariable*>::iterator i = d->variables.find(nodeId);
+        if (i != d->variables.end()) {
+            UaVariable* ret = (*i).second;
+            ret->addReference();
+            pthread_mutex_unlock(&d->mutex);
+            return ret;
+        }
+        pthread_mutex_unlock(&d->mutex);
+
         UaNode* node = getNode(nodeId);
-        return node != NULL && node->nodeClass() == OpcUa_NodeClass_Variable ?
-                (UaVariable*) node : NULL;
+        if (node == NULL) {
+            return NULL;
+        }
+        if (node->nodeClass() != OpcUa_NodeClass_Variable) {
+            node->releaseReference();
+            return NULL;
+        }
+        UaVariable* ret = (UaVariable*) node;
+        // add the variable to the cache if it has not been added by another thread
+        // in the meantime
+        pthread_mutex_lock(&d->mutex);
+        if (d->variables.find(nodeId) == d->variables.end()) {
+            ret->addReference();
+            d->variables[nodeId] = ret;
+        }
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
     }
 
     UaMethod* NodeBrowser::getMethod(const UaNodeId& nodeId) {
@@ -78,64 +261,302 @@ namespace SASModelProviderNamespace {
     std::vector<UaNodeId>* NodeBrowser::getSuperTypes(const UaNodeId& typeId)
     /* throws NodeBrowserException */ {
         std::vector<UaNodeId>* ret = new std::vector<UaNodeId>();
-        ServiceContext sc;
-        UaNodeId nodeToBrowse;
-        UaNodeId referenceTypeId(OpcUaId_HasSubtype);
-        BrowseContext bc(NULL /*view*/,
-                (OpcUa_NodeId*) (const OpcUa_NodeId*) nodeToBrowse,
-                0 /*maxResultsToReturn*/,
-                OpcUa_BrowseDirection_Inverse,
-                (OpcUa_NodeId*) (const OpcUa_NodeId*) referenceTypeId,
-                OpcUa_True /*includeSubtypes*/,
-                0 /*nodeClassMask*/,
-                OpcUa_BrowseResultMask_All /* resultMask */);
-        UaNode* type = getNode(typeId);
-        while (type != NULL && type->nodeId().namespaceIndex() != 0) {
-            UaReferenceDescriptions referenceDescriptions;
-            UaStatus result = type->browse(sc, bc, referenceDescriptions);
-            if (!result.isGood()) {
-                std::ostringstream msg;
-                msg << "Cannot get super types for " << type->nodeId().toXmlString().toUtf8()
-                        << ": " << result.toString().toUtf8();
-                throw ExceptionDef(NodeBrowserException, msg.str());
-            }
-            UaNodeId* superTypeId = NULL;
-            for (OpcUa_UInt32 i = 0; i < referenceDescriptions.length(); i++) {
-                superTypeId = new UaNodeId(referenceDescriptions[i].NodeId.NodeId);
-                ret->push_back(*superTypeId);
-            }
-            type->releaseReference();
-            if (superTypeId == NULL) {
-                type = NULL;
-            } else {
-                type = getNode(*superTypeId);
-                delete superTypeId;
-            }
+        if (typeId.namespaceIndex() == 0) {
+            return ret;
         }
-        if (type != NULL) {
-            type->releaseReference();
+        try {
+            d->getSuperTypes(typeId, *ret); // NodeBrowserException
+        } catch (Exception& e) {
+            delete ret;
+            throw;
+        }
+        return ret;
+    }
+
+    UaNodeId NodeBrowser::getBuildInType(const UaNodeId& typeId)
+    /* throws NodeBrowserException */ {
+        if (typeId.namespaceIndex() == 0) {
+            return typeId;
         }
+        UaNodeId ret;
+        d->getBuildInType(typeId, ret); // NodeBrowserException
         return ret;
     }
 
     NodeManagerUaNode* NodeBrowserPrivate::getNodeManagerUaNode(const UaNodeId& nodeId) {
-        if (0 == nodeId.namespaceIndex()) {
+        OpcUa_UInt16 namespaceIndex = nodeId.namespaceIndex();
+        if (0 == namespaceIndex) {
             return nodeManager->getNodeManagerRoot().getNodeManagerUaNode();
         }
-        if (nodeManager->getNodeManagerBase().getNameSpaceIndex() == nodeId.namespaceIndex()) {
-            return &nodeManager->getNodeManagerBase();
+        // the table is published with a full barrier (see setNamespaceTable)
+        NamespaceTable* table = namespaceTable;
+        __sync_synchronize();
+        NodeManagerUaNode* ret = namespaceIndex < table->nodeManagers.size() ?
+                table->nodeManagers[namespaceIndex] : NULL;
+        if (ret != NULL) {
+            return ret == noNodeManager ? NULL : ret;
+        }
+        // the namespace has not been searched since the last update of the table
+        pthread_mutex_lock(&registryMutex);
+        table = namespaceTable;
+        if (namespaceIndex >= table->nodeManagers.size()) {
+            // enlarge the table (at least doubling the size to limit the count of
+            // replaced tables)
+            NamespaceTable* newTable = new NamespaceTable(*table);
+            size_t size = 2 * table->nodeManagers.size();
+            if (size <= namespaceIndex) {
+                size = namespaceIndex + 1;
+            } else if (size > 0x10000) {
+                // the max. count of namespaces
+                size = 0x10000;
+            }
+            newTable->nodeManagers.resize(size, NULL);
+            setNamespaceTable(newTable);
+            table = newTable;
+        }
+        ret = table->nodeManagers[namespaceIndex];
+        if (ret == NULL) {
+            // the node manager may have been created after the last update of the table;
+            // a missing node manager is also cached until the next update
+            ret = findNodeManagerUaNode(namespaceIndex);
+            table->nodeManagers[namespaceIndex] = ret == NULL ? noNodeManager : ret;
+        }
+        pthread_mutex_unlock(&registryMutex);
+        return ret == noNodeManager ? NULL : ret;
+    }
+
+    NodeManagerUaNode* NodeBrowserPrivate::findNodeManagerUaNode(OpcUa_UInt16 namespaceIndex) {
+        NodeManagerUaNode* ret = NULL;
+        if (nodeManager->getNodeManagerBase().getNameSpaceIndex() == namespaceIndex) {
+            ret = &nodeManager->getNodeManagerBase();
+        } else {
+            const std::vector<HaNodeManager*>* associatedNodeManagers
+                    = nodeManager->getAssociatedNodeManagers();
+            if (associatedNodeManagers != NULL) {
+                for (std::vector<HaNodeManager*>::const_iterator i =
+                        associatedNodeManagers->begin(); i != associatedNodeManagers->end(); i++) {
+                    HaNodeManager* nm = *i;
+                    if (nm->getNodeManagerBase().getNameSpaceIndex() == namespaceIndex) {
+                        ret = &nm->getNodeManagerBase();
+                        break;
+                    }
+                }
+            }
         }
+        return ret == NULL || stoppedNodeManagers.find(ret) != stoppedNodeManagers.end() ?
+                NULL : ret;
+    }
+
+    void NodeBrowserPrivate::reset() {
+        std::vector<NodeManagerUaNode*> table;
+        std::vector<HaNodeManager*> nodeManagers;
+        nodeManagers.push_back(nodeManager);
         const std::vector<HaNodeManager*>* associatedNodeManagers
                 = nodeManager->getAssociatedNodeManagers();
         if (associatedNodeManagers != NULL) {
-            for (std::vector<HaNodeManager*>::const_iterator i = associatedNodeManagers->begin();
-                    i != associatedNodeManagers->end(); i++) {
-                HaNodeManager* nm = *i;
-                if (nm->getNodeManagerBase().getNameSpaceIndex() == nodeId.namespaceIndex()) {
-                    return &nm->getNodeManagerBase();
+            nodeManagers.insert(nodeManagers.end(), associatedNodeManagers->begin(),
+                    associatedNodeManagers->end());
+        }
+        for (std::vector<HaNodeManager*>::const_iterator i = nodeManagers.begin();
+                i != nodeManagers.end(); i++) {
+            NodeManagerUaNode* nm = &(*i)->getNodeManagerBase();
+            OpcUa_UInt16 namespaceIndex = (*i)->getNodeManagerBase().getNameSpaceIndex();
+            // skip node managers which have not been started yet or have been stopped
+            if (namespaceIndex == 0 || stoppedNodeManagers.find(nm) != stoppedNodeManagers.end()) {
+                continue;
+            }
+            if (namespaceIndex >= table.size()) {
+                table.resize(namespaceIndex + 1, NULL);
+            }
+            // the first node manager for a namespace wins
+            if (table[namespaceIndex] == NULL) {
+                table[namespaceIndex] = nm;
+            }
+        }
+        NamespaceTable* newTable = new NamespaceTable();
+        newTable->nodeManagers.swap(table);
+        setNamespaceTable(newTable);
+        pthread_mutex_lock(&mutex);
+        clearVariables();
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void NodeBrowserPrivate::setNamespaceTable(NamespaceTable* table) {
+        // the content of the table must be visible to other threads before the table
+        __sync_synchronize();
+        if (namespaceTable != NULL) {
+            replacedNamespaceTables.push_back(namespaceTable);
+        }
+        namespaceTable = table;
+    }
+
+    void NodeBrowserPrivate::clearVariables() {
+        for (std::map<UaNodeId, UaVariable*>::iterator i = variables.begin();
+                i != variables.end(); i++) {
+            (*i).second->releaseReference();
+        }
+        variables.clear();
+    }
+
+    void NodeBrowserPrivate::buildTypeHierarchy() /* throws NodeBrowserException */ {
+        std::map<UaNodeId, TypeEntry> entries;
+        std::vector<UaNodeId> flatSuperTypeIds;
+        // browse the sub types level by level starting at the base types
+        std::vector<UaNodeId> types;
+        types.push_back(UaNodeId(OpcUaId_BaseDataType));
+        types.push_back(UaNodeId(OpcUaId_BaseObjectType));
+        for (int i = 0; i < types.size(); i++) {
+            UaNodeId typeId = types[i];
+            NodeManagerUaNode* nm = getNodeManagerUaNode(typeId);
+            UaNode* type = nm == NULL ? NULL : nm->getNode(typeId);
+            if (type == NULL) {
+                continue;
+            }
+            std::vector<UaNodeId> subTypeIds;
+            try {
+                browseTypes(*type, OpcUa_BrowseDirection_Forward, subTypeIds); // NodeBrowserException
+            } catch (Exception& e) {
+                type->releaseReference();
+                throw;
+            }
+            type->releaseReference();
+            for (std::vector<UaNodeId>::const_iterator j = subTypeIds.begin();
+                    j != subTypeIds.end(); j++) {
+                const UaNodeId& subTypeId = *j;
+                if (subTypeId.namespaceIndex() == 0) {
+                    types.push_back(subTypeId);
+                    continue;
                 }
+                if (entries.find(subTypeId) != entries.end()) {
+                    continue;
+                }
+                // super types of the sub type: the type and its super types
+                TypeEntry entry;
+                entry.offset = flatSuperTypeIds.size();
+                flatSuperTypeIds.push_back(typeId);
+                if (typeId.namespaceIndex() != 0) {
+                    TypeEntry superEntry = entries[typeId];
+                    for (int k = 0; k < superEntry.count; k++) {
+                        flatSuperTypeIds.push_back(flatSuperTypeIds[superEntry.offset + k]);
+                    }
+                }
+                entry.count = flatSuperTypeIds.size() - entry.offset;
+                entry.buildInType = flatSuperTypeIds.back();
+                entries[subTypeId] = entry;
+                types.push_back(subTypeId);
+            }
+        }
+        pthread_mutex_lock(&typeMutex);
+        typeEntries.swap(entries);
+        superTypeIds.swap(flatSuperTypeIds);
+        pthread_mutex_unlock(&typeMutex);
+    }
+
+    bool NodeBrowserPrivate::getSuperTypes(const UaNodeId& typeId,
+            std::vector<UaNodeId>& superTypes) /* throws NodeBrowserException */ {
+        // the type hierarchy may be cleared or rebuilt by other threads
+        // => look up the entry and copy the super types while the mutex is locked
+        pthread_mutex_lock(&typeMutex);
+        std::map<UaNodeId, TypeEntry>::const_iterator i = typeEntries.find(typeId);
+        if (i != typeEntries.end()) {
+            const TypeEntry& typeEntry = (*i).second;
+            superTypes.assign(superTypeIds.begin() + typeEntry.offset,
+                    superTypeIds.begin() + typeEntry.offset + typeEntry.count);
+            pthread_mutex_unlock(&typeMutex);
+            return true;
+        }
+        pthread_mutex_unlock(&typeMutex);
+        // the type is not part of the type hierarchy (eg. it has been added after the
+        // start of the node managers) => browse the super types
+        return addSuperTypes(typeId, superTypes); // NodeBrowserException
+    }
+
+    bool NodeBrowserPrivate::getBuildInType(const UaNodeId& typeId, UaNodeId& buildInType)
+    /* throws NodeBrowserException */ {
+        pthread_mutex_lock(&typeMutex);
+        std::map<UaNodeId, TypeEntry>::const_iterator i = typeEntries.find(typeId);
+        if (i != typeEntries.end()) {
+            buildInType = (*i).second.buildInType;
+            pthread_mutex_unlock(&typeMutex);
+            return true;
+        }
+        pthread_mutex_unlock(&typeMutex);
+        std::vector<UaNodeId> superTypes;
+        if (!addSuperTypes(typeId, superTypes)) { // NodeBrowserException
+            return false;
+        }
+        if (superTypes.size() > 0) {
+            buildInType = superTypes.back();
+        }
+        return true;
+    }
+
+    bool NodeBrowserPrivate::addSuperTypes(const UaNodeId& typeId,
+            std::vector<UaNodeId>& superTypes) /* throws NodeBrowserException */ {
+        NodeManagerUaNode* nm = getNodeManagerUaNode(typeId);
+        UaNode* type = nm == NULL ? NULL : nm->getNode(typeId);
+        if (type == NULL) {
+            return false;
+        }
+        std::vector<UaNodeId> chain;
+        while (type != NULL && type->nodeId().namespaceIndex() != 0) {
+            std::vector<UaNodeId> superTypeIds;
+            try {
+                browseTypes(*type, OpcUa_BrowseDirection_Inverse, superTypeIds); // NodeBrowserException
+            } catch (Exception& e) {
+                type->releaseReference();
+                throw;
             }
+            type->releaseReference();
+            if (superTypeIds.size() == 0) {
+                type = NULL;
+            } else {
+                chain.push_back(superTypeIds.back());
+                nm = getNodeManagerUaNode(superTypeIds.back());
+                type = nm == NULL ? NULL : nm->getNode(superTypeIds.back());
+            }
+        }
+        if (type != NULL) {
+            type->releaseReference();
+        }
+        pthread_mutex_lock(&typeMutex);
+        TypeEntry typeEntry;
+        typeEntry.offset = superTypeIds.size();
+        typeEntry.count = chain.size();
+        if (chain.size() > 0) {
+            typeEntry.buildInType = chain.back();
+        }
+        superTypeIds.insert(superTypeIds.end(), chain.begin(), chain.end());
+        typeEntries[typeId] = typeEntry;
+        pthread_mutex_unlock(&typeMutex);
+        superTypes.assign(chain.begin(), chain.end());
+        return true;
+    }
+
+    void NodeBrowserPrivate::browseTypes(UaNode& type, OpcUa_BrowseDirection direction,
+            std::vector<UaNodeId>& typeIds) /* throws NodeBrowserException */ {
+        ServiceContext sc;
+        UaNodeId nodeToBrowse;
+        UaNodeId referenceTypeId(OpcUaId_HasSubtype);
+        BrowseContext bc(NULL /*view*/,
+                (OpcUa_NodeId*) (const OpcUa_NodeId*) nodeToBrowse,
+                0 /*maxResultsToReturn*/,
+                direction,
+                (OpcUa_NodeId*) (const OpcUa_NodeId*) referenceTypeId,
+                OpcUa_True /*includeSubtypes*/,
+                0 /*nodeClassMask*/,
+                OpcUa_BrowseResultMask_All /* resultMask */);
+        UaReferenceDescriptions referenceDescriptions;
+        UaStatus result = type.browse(sc, bc, referenceDescriptions);
+        if (!result.isGood()) {
+            std::ostringstream msg;
+            msg << "Cannot browse " << (direction == OpcUa_BrowseDirection_Inverse ? "super" : "sub")
+                    << " types of " << type.nodeId().toXmlString().toUtf8()
+                    << ": " << result.toString().toUtf8();
+            throw ExceptionDef(NodeBrowserException, msg.str());
+        }
+        for (OpcUa_UInt32 i = 0; i < referenceDescriptions.length(); i++) {
+            typeIds.push_back(UaNodeId(referenceDescriptions[i].NodeId.NodeId));
         }
-        return NULL;
     }
-} // namespace SASModelProviderNamespace
+} // namespace SASModelProviderNamespace
\ No newline at end of file
@@ -0,0 +1,367 @@
+#include <sasModelProvider/base/PollScheduler.h>
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <pthread.h> // pthread_t
+#include <time.h> // clock_gettime
+#include <map>
+#include <set>
+#include <string>
+#include <string.h> // memset
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace SASModelProviderNamespace {
+
+    class PollSchedulerPrivate {
+        friend class PollScheduler;
+    private:
+
+        class Node {
+        public:
+            NodeId* nodeId;
+            // count of monitored items
+            int monitoredItemCount;
+            // interval of the group
+            long interval;
+            // time of the last successful poll (tv_sec = 0: not polled yet)
+            timespec pollTime;
+        };
+
+        typedef std::map<NodeId, Node, NodeId::Less> Nodes;
+        typedef std::set<NodeId, NodeId::Less> NodeIds;
+
+        class Group {
+        public:
+            // nodeIds of the nodes
+            NodeIds nodes;
+            timespec nextPollTime;
+        };
+
+        Logger* log;
+
+        IODataProvider* ioDataProvider;
+        long minInterval;
+        PollScheduler::PollCallback* callback;
+
+        // protects the nodes, the groups, the metrics and the state of the polling thread
+        pthread_mutex_t mutex;
+        pthread_cond_t cond;
+        pthread_t thread;
+        bool isClosed;
+
+        // nodeId -> node
+        Nodes nodes;
+        // interval -> group
+        std::map<long, Group> groups;
+        // count of created groups (used for staggering the first ticks)
+        unsigned long createdGroupCount;
+
+        PollScheduler::Metrics metrics;
+
+        static void* run(void* object);
+        // Moves a node to the group for an interval. The mutex must be locked by the caller.
+        void moveNode(const NodeId& nodeId, Node& node, long interval);
+        // Reads the values of a group. The mutex must be locked by the caller.
+        // It is unlocked while the IO data provider is called.
+        void poll(long interval);
+        static timespec add(const timespec& time, long milliseconds);
+        static bool isBefore(const timespec& time1, const timespec& time2);
+        static long diff(const timespec& end, const timespec& start);
+    };
+
+    PollScheduler::PollCallback::PollCallback() {
+    }
+
+    PollScheduler::PollCallback::~PollCallback() {
+    }
+
+    PollScheduler::PollScheduler(IODataProvider& ioDataProvider, long minInterval,
+            PollCallback* callback) /* throws MutexException */ {
+        d = new PollSchedulerPrivate();
+        d->log = LoggerFactory::getLogger("PollScheduler");
+        d->ioDataProvider = &ioDataProvider;
+        d->minInterval = minInterval > 0 ? minInterval : 1;
+        d->callback = callback;
+        d->isClosed = false;
+        d->createdGroupCount = 0;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0
+                || pthread_cond_init(&d->cond, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for poll scheduler");
+        }
+        if (pthread_create(&d->thread, NULL /*attr*/, &PollSchedulerPrivate::run, d) != 0) {
+            pthread_cond_destroy(&d->cond);
+            pthread_mutex_destroy(&d->mutex);
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot start thread for poll scheduler");
+        }
+    }
+
+    PollScheduler::~PollScheduler() {
+        // stop the polling thread
+        pthread_mutex_lock(&d->mutex);
+        d->isClosed = true;
+        pthread_cond_signal(&d->cond);
+        pthread_mutex_unlock(&d->mutex);
+        pthread_join(d->thread, NULL /*return*/);
+        for (PollSchedulerPrivate::Nodes::iterator i = d->nodes.begin();
+                i != d->nodes.end(); i++) {
+            delete (*i).second.nodeId;
+        }
+        pthread_cond_destroy(&d->cond);
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    void PollScheduler::monitoringStarted(const NodeId& nodeId, long samplingInterval) {
+        long interval = samplingInterval < d->minInterval ? d->minInterval : samplingInterval;
+        pthread_mutex_lock(&d->mutex);
+        PollSchedulerPrivate::Nodes::iterator i = d->nodes.find(nodeId);
+        if (i == d->nodes.end()) {
+            PollSchedulerPrivate::Node node;
+            node.nodeId = new NodeId(nodeId);
+            node.monitoredItemCount = 0;
+            node.interval = 0;
+            node.pollTime.tv_sec = 0;
+            node.pollTime.tv_nsec = 0;
+            i = d->nodes.insert(std::make_pair(nodeId, node)).first;
+        }
+        PollSchedulerPrivate::Node& node = (*i).second;
+        node.monitoredItemCount++;
+        // the fastest requested interval wins
+        if (node.interval == 0 || interval < node.interval) {
+            d->moveNode(nodeId, node, interval);
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    void PollScheduler::monitoringStopped(const NodeId& nodeId, long samplingInterval) {
+        pthread_mutex_lock(&d->mutex);
+        PollSchedulerPrivate::Nodes::iterator i = d->nodes.find(nodeId);
+        if (i != d->nodes.end()) {
+            PollSchedulerPrivate::Node& node = (*i).second;
+            node.monitoredItemCount--;
+            if (node.monitoredItemCount <= 0) {
+                d->moveNode(nodeId, node, 0 /* interval */);
+                delete node.nodeId;
+                d->nodes.erase(i);
+            } else if (samplingInterval > 0) {
+                // the fastest remaining interval wins
+                long interval = samplingInterval < d->minInterval ?
+                        d->minInterval : samplingInterval;
+                if (interval != node.interval) {
+                    d->moveNode(nodeId, node, interval);
+                }
+            }
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    void PollScheduler::monitoringModified(const NodeId& nodeId, long samplingInterval) {
+        long interval = samplingInterval < d->minInterval ? d->minInterval : samplingInterval;
+        pthread_mutex_lock(&d->mutex);
+        PollSchedulerPrivate::Nodes::iterator i = d->nodes.find(nodeId);
+        if (i != d->nodes.end() && interval != (*i).second.interval) {
+            d->moveNode(nodeId, (*i).second, interval);
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    bool PollScheduler::isFresh(const NodeId& nodeId) {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        pthread_mutex_lock(&d->mutex);
+        PollSchedulerPrivate::Nodes::iterator i = d->nodes.find(nodeId);
+        bool ret = i != d->nodes.end() && (*i).second.pollTime.tv_sec != 0
+                && PollSchedulerPrivate::diff(now, (*i).second.pollTime) <= (*i).second.interval;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    long PollScheduler::getInterval(const NodeId& nodeId) {
+        pthread_mutex_lock(&d->mutex);
+        PollSchedulerPrivate::Nodes::iterator i = d->nodes.find(nodeId);
+        long ret = i == d->nodes.end() ? 0 : (*i).second.interval;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    int PollScheduler::getGroupCount() {
+        pthread_mutex_lock(&d->mutex);
+        int ret = d->groups.size();
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    PollScheduler::Metrics PollScheduler::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void PollSchedulerPrivate::moveNode(const NodeId& nodeId, Node& node, long interval) {
+        // remove the node from its current group
+        if (node.interval > 0) {
+            std::map<long, Group>::iterator i = groups.find(node.interval);
+            if (i != groups.end()) {
+                (*i).second.nodes.erase(nodeId);
+                if ((*i).second.nodes.size() == 0) {
+                    groups.erase(i);
+                }
+            }
+        }
+        node.interval = interval;
+        node.pollTime.tv_sec = 0;
+        if (interval <= 0) {
+            return;
+        }
+        // add the node to the group
+        std::map<long, Group>::iterator i = groups.find(interval);
+        if (i == groups.end()) {
+            // stagger the first tick of the new group by a fraction of the interval
+            Group group;
+            timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            group.nextPollTime = add(now, interval * (createdGroupCount % 8) / 8);
+            createdGroupCount++;
+            i = groups.insert(std::make_pair(interval, group)).first;
+            pthread_cond_signal(&cond);
+        }
+        (*i).second.nodes.insert(nodeId);
+    }
+
+    void* PollSchedulerPrivate::run(void* object) {
+        PollSchedulerPrivate& d = *static_cast<PollSchedulerPrivate*> (object);
+        pthread_mutex_lock(&d.mutex);
+        while (!d.isClosed) {
+            if (d.groups.size() == 0) {
+                pthread_cond_wait(&d.cond, &d.mutex);
+                continue;
+            }
+            // get the next group
+            std::map<long, Group>::iterator next = d.groups.begin();
+            for (std::map<long, Group>::iterator i = d.groups.begin(); i != d.groups.end(); i++) {
+                if (isBefore((*i).second.nextPollTime, (*next).second.nextPollTime)) {
+                    next = i;
+                }
+            }
+            timespec nextPollTime = (*next).second.nextPollTime;
+            timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            if (isBefore(now, nextPollTime)) {
+                // wait until the poll time or a modification of the groups
+                pthread_cond_timedwait(&d.cond, &d.mutex, &nextPollTime);
+                continue;
+            }
+            d.poll((*next).first);
+        }
+        pthread_mutex_unlock(&d.mutex);
+        return NULL;
+    }
+
+    void PollSchedulerPrivate::poll(long interval) {
+        std::map<long, Group>::iterator group = groups.find(interval);
+        timespec startTime;
+        clock_gettime(CLOCK_REALTIME, &startTime);
+        // copy the nodeIds because the nodes may be removed while the provider is called
+        std::vector<const NodeId*>* nodeIds = new std::vector<const NodeId*>();
+        VectorScopeGuard<const NodeId> nodeIdsSG(nodeIds);
+        for (NodeIds::iterator i = (*group).second.nodes.begin();
+                i != (*group).second.nodes.end(); i++) {
+            nodeIds->push_back(new NodeId(*nodes[*i].nodeId));
+        }
+        pthread_mutex_unlock(&mutex);
+
+        NodeIds polledNodes;
+        bool failed = false;
+        try {
+            std::vector<NodeData*>* results = ioDataProvider->read(*nodeIds); // IODataProviderException
+            VectorScopeGuard<NodeData> resultsSG(results);
+            if (results != NULL) {
+                for (std::vector<NodeData*>::iterator i = results->begin(); i != results->end();
+                        i++) {
+                    if (!(*i)->hasError()) {
+                        polledNodes.insert((*i)->getNodeId());
+                    }
+                }
+                if (callback != NULL) {
+                    callback->polled(*results);
+                }
+            }
+        } catch (Exception& e) {
+            failed = true;
+            IODataProviderException ex = ExceptionDef(IODataProviderException,
+                    std::string("The polling of node values from IO data provider failed"));
+            ex.setCause(&e);
+            if (callback != NULL) {
+                callback->pollFailed(*nodeIds, ex);
+            } else {
+                std::string st;
+                ex.getStackTrace(st);
+                log->error("Exception while polling values: %s", st.c_str());
+            }
+        }
+
+        timespec endTime;
+        clock_gettime(CLOCK_REALTIME, &endTime);
+        pthread_mutex_lock(&mutex);
+        for (NodeIds::iterator i = polledNodes.begin(); i != polledNodes.end(); i++) {
+            Nodes::iterator node = nodes.find(*i);
+            // the node may have been moved to another group in the meantime
+            if (node != nodes.end() && (*node).second.interval == interval) {
+                (*node).second.pollTime = startTime;
+            }
+        }
+        metrics.pollCount++;
+        if (failed) {
+            metrics.failedPollCount++;
+        }
+        metrics.polledNodeCount += nodeIds->size();
+        bool isOverrun = diff(endTime, startTime) > interval;
+        if (isOverrun) {
+            metrics.overrunCount++;
+        }
+        // the group may have been removed in the meantime
+        group = groups.find(interval);
+        if (group != groups.end()) {
+            timespec nextPollTime = add((*group).second.nextPollTime, interval);
+            // skip the missed ticks
+            (*group).second.nextPollTime = isBefore(nextPollTime, endTime) ?
+                    endTime : nextPollTime;
+        }
+        if (isOverrun && log->isDebugEnabled()) {
+            log->debug("Polling of %lu nodes took %ldms (interval %ldms)", nodeIds->size(),
+                    diff(endTime, startTime), interval);
+        }
+    }
+
+    timespec PollSchedulerPrivate::add(const timespec& time, long milliseconds) {
+        timespec ret = time;
+        ret.tv_sec += milliseconds / 1000;
+        ret.tv_nsec += (milliseconds % 1000) * 1000000;
+        if (ret.tv_nsec >= 1000000000) {
+            ret.tv_sec++;
+            ret.tv_nsec -= 1000000000;
+        }
+        return ret;
+    }
+
+    bool PollSchedulerPrivate::isBefore(const timespec& time1, const timespec& time2) {
+        return time1.tv_sec < time2.tv_sec
+                || (time1.tv_sec == time2.tv_sec && time1.tv_nsec < time2.tv_nsec);
+    }
+
+    long PollSchedulerPrivate::diff(const timespec& end, const timespec& start) {
+        return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    }
+
+} // namespace SASModelProviderNamespace
@@ -0,0 +1,356 @@
+#include <sasModelProvider/base/SingleFlightReader.h>
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/MessageRegistry.h>
+#include <statuscode.h> // OpcUa_BadCommunicationError
+#include <pthread.h> // pthread_mutex_t
+#include <time.h> // clock_gettime
+#include <map>
+#include <set>
+#include <string>
+#include <string.h> // memset
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace SASModelProviderNamespace {
+
+    class SingleFlightReaderPrivate {
+        friend class SingleFlightReader;
+    private:
+
+        typedef std::map<NodeId, NodeData*, NodeId::Less> Results;
+
+        // a read of the IO data provider
+        class Flight {
+        public:
+            // count of threads using the results
+            int refCount;
+            bool isDone;
+            // nodeId -> result
+            Results results;
+            // nodeIds which have been invalidated while reading
+            std::set<NodeId, NodeId::Less> invalidated;
+        };
+
+        class FreshValue {
+        public:
+            NodeData* nodeData;
+            timespec readTime;
+        };
+
+        Logger* log;
+
+        IODataProvider* ioDataProvider;
+        long freshnessWindow;
+
+        // protects the flights, the fresh values and the metrics
+        pthread_mutex_t mutex;
+        // is signaled when a flight is done
+        pthread_cond_t cond;
+
+        typedef std::map<NodeId, Flight*, NodeId::Less> Flights;
+        typedef std::map<NodeId, FreshValue, NodeId::Less> FreshValues;
+
+        // nodeId -> running flight
+        Flights flights;
+        // nodeId -> fresh value (only used with a freshness window)
+        FreshValues freshValues;
+
+        SingleFlightReader::Metrics metrics;
+
+        // ids of the messages for failed nodes
+        int readFailedMessageId;
+        int missingNodeDataMessageId;
+
+        // Reads the nodes of a flight. The mutex must be locked by the caller.
+        // It is unlocked while the IO data provider is called.
+        void fly(Flight& flight, const std::vector<const NodeId*>& nodeIds);
+        // Saves copies of the successfully read values of a flight for the freshness window.
+        // The mutex must be locked by the caller.
+        void saveFreshValues(Flight& flight, const std::vector<const NodeId*>& nodeIds,
+                const timespec& readTime);
+        // Returns the result of a flight for a node. If the flight is only used by the calling
+        // thread then the result is taken over without a copy and NULL is left in the flight
+        // (a further occurrence of the node in the same request returns NULL), else a copy is
+        // returned.
+        NodeData* getResult(Flight& flight, const NodeId& nodeId);
+        // Decrements the reference counter of a flight and deletes it if it is not used
+        // anymore. The mutex must be locked by the caller.
+        void release(Flight* flight);
+        static NodeData* createErrorResult(const NodeId& nodeId, unsigned long statusCode,
+                int messageId);
+        static long diff(const timespec& end, const timespec& start);
+    };
+
+    SingleFlightReader::SingleFlightReader(IODataProvider& ioDataProvider, long freshnessWindow)
+    /* throws MutexException */ {
+        d = new SingleFlightReaderPrivate();
+        d->log = LoggerFactory::getLogger("SingleFlightReader");
+        d->ioDataProvider = &ioDataProvider;
+        d->freshnessWindow = freshnessWindow;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        d->readFailedMessageId = MessageRegistry::registerMessage(
+                "Cannot read values from IO data provider");
+        d->missingNodeDataMessageId = MessageRegistry::registerMessage(
+                "Missing node data in the result of the IO data provider");
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0
+                || pthread_cond_init(&d->cond, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for single flight reader");
+        }
+    }
+
+    SingleFlightReader::~SingleFlightReader() {
+        for (SingleFlightReaderPrivate::FreshValues::iterator i = d->freshValues.begin();
+                i != d->freshValues.end(); i++) {
+            delete (*i).second.nodeData;
+        }
+        pthread_cond_destroy(&d->cond);
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    std::vector<NodeData*>* SingleFlightReader::read(const std::vector<const NodeId*>& nodeIds) {
+        std::vector<NodeData*>* ret = new std::vector<NodeData*>(nodeIds.size(), NULL);
+        VectorScopeGuard<NodeData> retSG(ret);
+        // flights whose results are used for the nodes (NULL: fresh value)
+        std::vector<SingleFlightReaderPrivate::Flight*> nodeFlights(nodeIds.size(), NULL);
+        // flights which are used by this thread
+        std::set<SingleFlightReaderPrivate::Flight*> usedFlights;
+        SingleFlightReaderPrivate::Flight* ownFlight = NULL;
+        std::vector<const NodeId*> ownNodeIds;
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        pthread_mutex_lock(&d->mutex);
+        for (int i = 0; i < nodeIds.size(); i++) {
+            const NodeId& nodeId = *nodeIds[i];
+            if (d->freshnessWindow > 0) {
+                SingleFlightReaderPrivate::FreshValues::iterator fresh =
+                        d->freshValues.find(nodeId);
+                if (fresh != d->freshValues.end()) {
+                    if (SingleFlightReaderPrivate::diff(now, (*fresh).second.readTime)
+                            <= d->freshnessWindow) {
+                        (*ret)[i] = new NodeData(*(*fresh).second.nodeData);
+                        d->metrics.freshCount++;
+                        continue;
+                    }
+                    delete (*fresh).second.nodeData;
+                    d->freshValues.erase(fresh);
+                }
+            }
+            SingleFlightReaderPrivate::Flights::iterator flight = d->flights.find(nodeId);
+            if (flight == d->flights.end()) {
+                // the node is not being read => read it with the own flight
+                if (ownFlight == NULL) {
+                    ownFlight = new SingleFlightReaderPrivate::Flight();
+                    ownFlight->refCount = 1;
+                    ownFlight->isDone = false;
+                    usedFlights.insert(ownFlight);
+                }
+                ownNodeIds.push_back(nodeIds[i]);
+                flight = d->flights.insert(std::make_pair(nodeId, ownFlight)).first;
+            } else if ((*flight).second != ownFlight) {
+                // the node is being read by another thread => share its result
+                if (usedFlights.insert((*flight).second).second) {
+                    (*flight).second->refCount++;
+                }
+                d->metrics.sharedCount++;
+            }
+            nodeFlights[i] = (*flight).second;
+        }
+        if (ownFlight != NULL) {
+            d->fly(*ownFlight, ownNodeIds);
+            pthread_cond_broadcast(&d->cond);
+        }
+        // collect the results
+        for (int i = 0; i < nodeIds.size(); i++) {
+            SingleFlightReaderPrivate::Flight* flight = nodeFlights[i];
+            if (flight == NULL) {
+                continue;
+            }
+            while (!flight->isDone) {
+                pthread_cond_wait(&d->cond, &d->mutex);
+            }
+            NodeData* result = d->getResult(*flight, *nodeIds[i]);
+            if (result == NULL) {
+                // the result has been taken over by a previous occurrence of the node
+                for (int j = 0; j < i; j++) {
+                    if (nodeFlights[j] == flight && nodeIds[j]->equals(*nodeIds[i])) {
+                        result = new NodeData(*(*ret)[j]);
+                        break;
+                    }
+                }
+            }
+            (*ret)[i] = result;
+        }
+        for (std::set<SingleFlightReaderPrivate::Flight*>::iterator i = usedFlights.begin();
+                i != usedFlights.end(); i++) {
+            d->release(*i);
+        }
+        pthread_mutex_unlock(&d->mutex);
+        retSG.detach();
+        return ret;
+    }
+
+    void SingleFlightReader::invalidate(const NodeId& nodeId) {
+        pthread_mutex_lock(&d->mutex);
+        SingleFlightReaderPrivate::FreshValues::iterator fresh = d->freshValues.find(nodeId);
+        if (fresh != d->freshValues.end()) {
+            delete (*fresh).second.nodeData;
+            d->freshValues.erase(fresh);
+        }
+        // a running read may return the old value => do not save it as fresh value
+        SingleFlightReaderPrivate::Flights::iterator flight = d->flights.find(nodeId);
+        if (flight != d->flights.end()) {
+            (*flight).second->invalidated.insert(nodeId);
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    SingleFlightReader::Metrics SingleFlightReader::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void SingleFlightReaderPrivate::fly(Flight& flight,
+            const std::vector<const NodeId*>& nodeIds) {
+        metrics.readCallCount++;
+        metrics.readNodeCount += nodeIds.size();
+        pthread_mutex_unlock(&mutex);
+
+        Results results;
+        timespec readTime;
+        clock_gettime(CLOCK_REALTIME, &readTime);
+        try {
+            std::vector<NodeData*>* nodeData = ioDataProvider->read(nodeIds); // IODataProviderException
+            if (nodeData != NULL) {
+                for (int i = 0; i < nodeData->size(); i++) {
+                    NodeData* result = (*nodeData)[i];
+                    Results::iterator existing = results.find(result->getNodeId());
+                    if (existing != results.end()) {
+                        delete (*existing).second;
+                        (*existing).second = result;
+                    } else {
+                        results.insert(std::make_pair(result->getNodeId(), result));
+                    }
+                }
+                delete nodeData;
+            }
+        } catch (Exception& e) {
+            // the exception is logged once, the nodes only get a status code
+            if (log->isDebugEnabled()) {
+                IODataProviderException ex = ExceptionDef(IODataProviderException,
+                        std::string("Cannot read values from IO data provider"));
+                ex.setCause(&e);
+                std::string st;
+                ex.getStackTrace(st);
+                log->debug("Exception while reading %lu nodes: %s", nodeIds.size(), st.c_str());
+            }
+            for (int i = 0; i < nodeIds.size(); i++) {
+                NodeData* result = createErrorResult(*nodeIds[i], OpcUa_BadCommunicationError,
+                        readFailedMessageId);
+                Results::iterator existing = results.find(*nodeIds[i]);
+                if (existing != results.end()) {
+                    delete (*existing).second;
+                    (*existing).second = result;
+                } else {
+                    results.insert(std::make_pair(*nodeIds[i], result));
+                }
+            }
+        }
+
+        pthread_mutex_lock(&mutex);
+        if (flight.refCount > 1) {
+            // the results may reference the node ids of the calling thread, which may be
+            // destroyed before the other threads have taken their results
+            for (Results::iterator i = results.begin(); i != results.end(); i++) {
+                (*i).second->copyNodeId();
+            }
+        }
+        flight.results.swap(results);
+        flight.isDone = true;
+        for (int i = 0; i < nodeIds.size(); i++) {
+            Flights::iterator f = flights.find(*nodeIds[i]);
+            if (f != flights.end() && (*f).second == &flight) {
+                flights.erase(f);
+            }
+        }
+        // the values are only copied if a freshness window is configured
+        if (freshnessWindow > 0) {
+            saveFreshValues(flight, nodeIds, readTime);
+        }
+    }
+
+    void SingleFlightReaderPrivate::saveFreshValues(Flight& flight,
+            const std::vector<const NodeId*>& nodeIds, const timespec& readTime) {
+        for (int i = 0; i < nodeIds.size(); i++) {
+            const NodeId& nodeId = *nodeIds[i];
+            if (flight.invalidated.find(nodeId) != flight.invalidated.end()) {
+                continue;
+            }
+            Results::iterator result = flight.results.find(nodeId);
+            if (result == flight.results.end() || (*result).second->hasError()) {
+                continue;
+            }
+            FreshValue freshValue;
+            freshValue.nodeData = new NodeData(*(*result).second);
+            freshValue.readTime = readTime;
+            FreshValues::iterator fresh = freshValues.find(nodeId);
+            if (fresh != freshValues.end()) {
+                delete (*fresh).second.nodeData;
+                (*fresh).second = freshValue;
+            } else {
+                freshValues.insert(std::make_pair(nodeId, freshValue));
+            }
+        }
+    }
+
+    NodeData* SingleFlightReaderPrivate::getResult(Flight& flight, const NodeId& nodeId) {
+        Results::iterator result = flight.results.find(nodeId);
+        if (result == flight.results.end()) {
+            return createErrorResult(nodeId, OpcUa_BadNoData, missingNodeDataMessageId);
+        }
+        NodeData* ret = (*result).second;
+        if (ret != NULL && flight.refCount == 1) {
+            // no other thread uses the result => take it over (the flight is released by the
+            // calling thread)
+            (*result).second = NULL;
+            return ret;
+        }
+        return ret == NULL ? NULL : new NodeData(*ret);
+    }
+
+    void SingleFlightReaderPrivate::release(Flight* flight) {
+        flight->refCount--;
+        if (flight->refCount > 0) {
+            return;
+        }
+        for (Results::iterator i = flight->results.begin(); i != flight->results.end(); i++) {
+            delete (*i).second;
+        }
+        delete flight;
+    }
+
+    NodeData* SingleFlightReaderPrivate::createErrorResult(const NodeId& nodeId,
+            unsigned long statusCode, int messageId) {
+        NodeData* ret = new NodeData(*new NodeId(nodeId), NULL /* data */,
+                true /* attachValues */);
+        ret->setStatus(statusCode, messageId);
+        return ret;
+    }
+
+    long SingleFlightReaderPrivate::diff(const timespec& end, const timespec& start) {
+        return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    }
+
+} // namespace SASModelProviderNamespace
@@ -0,0 +1,242 @@
+#include <sasModelProvider/base/WriteBehindQueue.h>
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <pthread.h> // pthread_t
+#include <time.h> // clock_gettime
+#include <map>
+#include <string>
+#include <string.h> // memset
+#ifdef DEBUG
+#include <CppUTest/MemoryLeakDetectorNewMacros.h>
+#endif
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace SASModelProviderNamespace {
+
+    class WriteBehindQueuePrivate {
+        friend class WriteBehindQueue;
+    private:
+        Logger* log;
+
+        IODataProvider* ioDataProvider;
+        long window;
+        int maxBatchSize;
+        WriteBehindQueue::StatusCallback* callback;
+
+        // protects the queue, the metrics and the state of the flushing thread
+        pthread_mutex_t mutex;
+        pthread_cond_t cond;
+        // serializes the batched writes to keep the order of the values
+        pthread_mutex_t writeMutex;
+        pthread_t thread;
+        bool isClosed;
+
+        std::vector<const NodeData*> queue;
+        // nodeId -> position in queue
+        std::map<NodeId, int, NodeId::Less> positions;
+        // time of the first queued value
+        timespec firstEnqueueTime;
+
+        WriteBehindQueue::Metrics metrics;
+
+        static void* run(void* object);
+        // Removes the queued values and writes them to the IO data provider.
+        // The write mutex must be locked by the caller.
+        void writeBatch();
+        // Gets the time when the queue must be flushed.
+        timespec getFlushTime();
+    };
+
+    WriteBehindQueue::StatusCallback::StatusCallback() {
+    }
+
+    WriteBehindQueue::StatusCallback::~StatusCallback() {
+    }
+
+    WriteBehindQueue::WriteBehindQueue(IODataProvider& ioDataProvider, long window,
+            int maxBatchSize, StatusCallback* callback) /* throws MutexException */ {
+        d = new WriteBehindQueuePrivate();
+        d->log = LoggerFactory::getLogger("WriteBehindQueue");
+        d->ioDataProvider = &ioDataProvider;
+        d->window = window;
+        d->maxBatchSize = maxBatchSize;
+        d->callback = callback;
+        d->isClosed = false;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0
+                || pthread_mutex_init(&d->writeMutex, NULL /*attr*/) != 0
+                || pthread_cond_init(&d->cond, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for write behind queue");
+        }
+        if (pthread_create(&d->thread, NULL /*attr*/, &WriteBehindQueuePrivate::run, d) != 0) {
+            pthread_cond_destroy(&d->cond);
+            pthread_mutex_destroy(&d->writeMutex);
+            pthread_mutex_destroy(&d->mutex);
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot start thread for write behind queue");
+        }
+    }
+
+    WriteBehindQueue::~WriteBehindQueue() {
+        // stop the flushing thread
+        pthread_mutex_lock(&d->mutex);
+        d->isClosed = true;
+        pthread_cond_signal(&d->cond);
+        pthread_mutex_unlock(&d->mutex);
+        pthread_join(d->thread, NULL /*return*/);
+        // write the remaining values
+        flush();
+        pthread_cond_destroy(&d->cond);
+        pthread_mutex_destroy(&d->writeMutex);
+        pthread_mutex_destroy(&d->mutex);
+        delete d;
+    }
+
+    void WriteBehindQueue::enqueue(const NodeData* nodeData) {
+        const NodeId& nodeId = nodeData->getNodeId();
+        pthread_mutex_lock(&d->mutex);
+        std::map<NodeId, int, NodeId::Less>::iterator i = d->positions.find(nodeId);
+        if (i != d->positions.end()) {
+            // replace the queued value
+            delete d->queue[(*i).second];
+            d->queue[(*i).second] = nodeData;
+            d->metrics.coalescedCount++;
+        } else {
+            if (d->queue.size() == 0) {
+                clock_gettime(CLOCK_REALTIME, &d->firstEnqueueTime);
+                pthread_cond_signal(&d->cond);
+            }
+            d->positions[nodeId] = d->queue.size();
+            d->queue.push_back(nodeData);
+            if (d->queue.size() >= d->maxBatchSize) {
+                pthread_cond_signal(&d->cond);
+            }
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    void WriteBehindQueue::flush() {
+        pthread_mutex_lock(&d->writeMutex);
+        d->writeBatch();
+        pthread_mutex_unlock(&d->writeMutex);
+    }
+
+    int WriteBehindQueue::size() {
+        pthread_mutex_lock(&d->mutex);
+        int ret = d->queue.size();
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    bool WriteBehindQueue::isQueued(const std::vector<const NodeId*>& nodeIds) {
+        bool ret = false;
+        pthread_mutex_lock(&d->mutex);
+        if (d->queue.size() > 0) {
+            for (std::vector<const NodeId*>::const_iterator i = nodeIds.begin();
+                    i != nodeIds.end() && !ret; i++) {
+                ret = d->positions.find(**i) != d->positions.end();
+            }
+        }
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    WriteBehindQueue::Metrics WriteBehindQueue::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void* WriteBehindQueuePrivate::run(void* object) {
+        WriteBehindQueuePrivate& d = *static_cast<WriteBehindQueuePrivate*> (object);
+        pthread_mutex_lock(&d.mutex);
+        while (!d.isClosed) {
+            if (d.queue.size() == 0) {
+                pthread_cond_wait(&d.cond, &d.mutex);
+                continue;
+            }
+            if (d.queue.size() < d.maxBatchSize) {
+                timespec flushTime = d.getFlushTime();
+                if (pthread_cond_timedwait(&d.cond, &d.mutex, &flushTime) == 0) {
+                    // the queue has been modified or closed => check the state again
+                    continue;
+                }
+            }
+            pthread_mutex_unlock(&d.mutex);
+            pthread_mutex_lock(&d.writeMutex);
+            d.writeBatch();
+            pthread_mutex_unlock(&d.writeMutex);
+            pthread_mutex_lock(&d.mutex);
+        }
+        pthread_mutex_unlock(&d.mutex);
+        return NULL;
+    }
+
+    void WriteBehindQueuePrivate::writeBatch() {
+        std::vector<const NodeData*> batch;
+        pthread_mutex_lock(&mutex);
+        batch.swap(queue);
+        positions.clear();
+        pthread_mutex_unlock(&mutex);
+        if (batch.size() == 0) {
+            return;
+        }
+        bool failed = false;
+        try {
+            ioDataProvider->write(batch, false /* sendValueChangedEvents */); // IODataProviderException
+        } catch (Exception& e) {
+            failed = true;
+            IODataProviderException ex = ExceptionDef(IODataProviderException,
+                    std::string("The batched writing of node values to IO data provider failed"));
+            ex.setCause(&e);
+            if (callback != NULL) {
+                callback->writeFailed(batch, ex);
+            } else {
+                std::string st;
+                ex.getStackTrace(st);
+                log->error("Exception while writing values: %s", st.c_str());
+            }
+        }
+        pthread_mutex_lock(&mutex);
+        metrics.batchCount++;
+        if (failed) {
+            metrics.failedBatchCount++;
+        }
+        metrics.valueCount += batch.size();
+        if (batch.size() > metrics.maxBatchSize) {
+            metrics.maxBatchSize = batch.size();
+        }
+        int bucket = 0;
+        for (unsigned long size = batch.size();
+                size > 1 && bucket < WriteBehindQueue::Metrics::BATCH_SIZE_BUCKETS - 1;
+                size >>= 1) {
+            bucket++;
+        }
+        metrics.batchSizes[bucket]++;
+        pthread_mutex_unlock(&mutex);
+        if (log->isDebugEnabled()) {
+            log->debug("Wrote %lu values to IO data provider in one batch", batch.size());
+        }
+        for (std::vector<const NodeData*>::iterator i = batch.begin(); i != batch.end(); i++) {
+            delete *i;
+        }
+    }
+
+    timespec WriteBehindQueuePrivate::getFlushTime() {
+        timespec ret = firstEnqueueTime;
+        ret.tv_sec += window / 1000;
+        ret.tv_nsec += (window % 1000) * 1000000;
+        if (ret.tv_nsec >= 1000000000) {
+            ret.tv_sec++;
+            ret.tv_nsec -= 1000000000;
+        }
+        return ret;
+    }
+
+} // namespace SASModelProviderNamespace
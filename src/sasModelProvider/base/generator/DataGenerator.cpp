@@ -237,12 +237,9 @@ namespace SASModelProviderNamespace {
         if (0 == dataTypeId.namespaceIndex()) {
             return dataTypeId;
         }
-        std::vector<UaNodeId>* superTypes = nodeBrowser->getSuperTypes(dataTypeId);
-        if (superTypes != NULL) {
-            ScopeGuard<std::vector<UaNodeId> > superTypesSG(superTypes);
-            if (superTypes->size() > 0) {
-                return superTypes->back();
-            }
+        UaNodeId ret = nodeBrowser->getBuildInType(dataTypeId);
+        if (!ret.isNull()) {
+            return ret;
         }
         std::ostringstream msg;
         msg << "Cannot get base type of " << dataTypeId.toXmlString().toUtf8();
@@ -4,19 +4,27 @@
 #include "../../../utilities/linux.h" // getTime
 #include <common/Exception.h>
 #include <common/Mutex.h>
+#include <common/MutexException.h>
 #include <common/MutexLock.h>
 #include <common/ScopeGuard.h>
-#include <common/MapScopeGuard.h>
 #include <common/VectorScopeGuard.h>
+#include <common/logging/LogThrottle.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
 #include <ioDataProvider/Event.h>
 #include <sasModelProvider/base/NodeBrowser.h>
 #include <uaargument.h> // UaArgument
 #include <uanodeid.h> // UaNodeId
 #include <uavariant.h> // UaVariant
-#include <ctime>
+#include <pthread.h> // pthread_t
+#include <time.h> // nanosleep
+#include <iterator> // std::advance
 #include <map>
 #include <sstream> // std::ostringstream
 #include <stddef.h> // NULL
+#include <string>
+#include <string.h> // memset
+#include <utility> // std::pair
 #ifdef DEBUG
 #include <CppUTest/MemoryLeakDetectorNewMacros.h>
 #endif
@@ -29,34 +37,136 @@ namespace SASModelProviderNamespace {
     class GeneratorIODataProviderPrivate {
         friend class GeneratorIODataProvider;
     private:
-        static int EVENT_COUNT;
-        static int EVENT_INTERVAL;
+        // interval in milliseconds for generating values and events
+        static long TICK_INTERVAL;
 
+        class Variable {
+        public:
+            NodeId* nodeId;
+            SubscriberCallback* callback;
+        };
+
+        Logger* log;
+
+        GeneratorIODataProvider* provider;
         NodeBrowser* nodeBrowser;
         ConverterUa2IO* converter;
         DataGenerator* dataGenerator;
+        // serializes the calls of the data generator
+        Mutex* generatorMutex;
+        GeneratorIODataProvider::Configuration conf;
+
+        // protects the subscriptions, the metrics and the state of the generating thread
+        pthread_mutex_t mutex;
+        pthread_cond_t cond;
+        pthread_t thread;
+        bool hasThread;
+        bool isClosed;
+        // whether the generating thread calls the callbacks (the mutex is unlocked meanwhile)
+        bool isGenerating;
 
-        Mutex* mutex;
+        // subscribed variables in the order of their subscription
+        std::vector<Variable> variables;
+        // nodeId -> index in variables
+        std::map<std::string, size_t> variableIndices;
         std::map<UaNodeId, SubscriberCallback*> eventTypes;
+        // fractions of value changes and events which are due with the next tick
+        double dueValueChanges;
+        double dueEvents;
+        // indices of the next variable and event type to be generated
+        size_t nextVariable;
+        size_t nextEventType;
 
-        void fireEvents() /* throws GeneratorExceptionn */;
+        GeneratorIODataProvider::Metrics metrics;
+
+        static void* run(void* object);
+        // Generates the value changes and events which are due after an elapsed time.
+        // The mutex must be locked by the caller. It is unlocked while the values and events
+        // are generated.
+        void generate(double elapsedSeconds);
+        // Generates values for variables and sends them to a callback.
+        void fireValueChanges(const std::vector<const NodeId*>& nodeIds,
+                SubscriberCallback& callback)
+        /* throws ConversionException, GeneratorExceptionn, SubscriberCallbackException */;
+        // Generates an event for each event type and sends them to the callbacks.
+        void fireEvents(const std::vector<std::pair<UaNodeId, SubscriberCallback*> >& types)
+        /* throws GeneratorExceptionn */;
+        static timespec add(const timespec& time, long milliseconds);
+        static bool isBefore(const timespec& time1, const timespec& time2);
     };
 
-    int GeneratorIODataProviderPrivate::EVENT_COUNT = 10;
-    int GeneratorIODataProviderPrivate::EVENT_INTERVAL = 1; // in sec.
+    long GeneratorIODataProviderPrivate::TICK_INTERVAL = 10;
+
+    GeneratorIODataProvider::Configuration::Configuration() {
+        variableCount = 0;
+        variableChangeRate = 1;
+        eventTypeCount = 0;
+        eventRate = 1;
+        methodLatency = 0;
+    }
 
     GeneratorIODataProvider::GeneratorIODataProvider(NodeBrowser& nodeBrowser,
-            ConverterUa2IO& converter) {
+            ConverterUa2IO& converter, const Configuration& conf) /* throws MutexException */ {
         d = new GeneratorIODataProviderPrivate();
+        d->log = LoggerFactory::getLogger("GeneratorIODataProvider");
         d->nodeBrowser = &nodeBrowser;
         d->converter = &converter;
+        d->conf = conf;
+        d->provider = this;
+        d->hasThread = false;
+        d->isClosed = false;
+        d->isGenerating = false;
+        d->dueValueChanges = 0;
+        d->dueEvents = 0;
+        d->nextVariable = 0;
+        d->nextEventType = 0;
+        memset(&d->metrics, 0, sizeof (d->metrics));
+        if (pthread_mutex_init(&d->mutex, NULL /*attr*/) != 0
+                || pthread_cond_init(&d->cond, NULL /*attr*/) != 0) {
+            delete d;
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for data generator");
+        }
+        try {
+            d->generatorMutex = new Mutex(); // MutexException
+        } catch (Exception& e) {
+            pthread_cond_destroy(&d->cond);
+            pthread_mutex_destroy(&d->mutex);
+            delete d;
+            throw;
+        }
         d->dataGenerator = new DataGenerator(nodeBrowser, converter);
-        d->mutex = new Mutex(); // MutexException
+        // the thread is only required if values or events are generated continuously
+        if (conf.variableChangeRate > 0 || conf.eventRate > 0) {
+            if (pthread_create(&d->thread, NULL /*attr*/, &GeneratorIODataProviderPrivate::run,
+                    d) != 0) {
+                pthread_cond_destroy(&d->cond);
+                pthread_mutex_destroy(&d->mutex);
+                delete d->dataGenerator;
+                delete d->generatorMutex;
+                delete d;
+                throw ExceptionDef(MutexException, "Cannot start thread for data generator");
+            }
+            d->hasThread = true;
+        }
     }
 
     GeneratorIODataProvider::~GeneratorIODataProvider() {
-        delete d->mutex;
+        // stop the generating thread
+        if (d->hasThread) {
+            pthread_mutex_lock(&d->mutex);
+            d->isClosed = true;
+            pthread_cond_signal(&d->cond);
+            pthread_mutex_unlock(&d->mutex);
+            pthread_join(d->thread, NULL /*return*/);
+        }
+        for (std::vector<GeneratorIODataProviderPrivate::Variable>::iterator i =
+                d->variables.begin(); i != d->variables.end(); i++) {
+            delete (*i).nodeId;
+        }
+        pthread_cond_destroy(&d->cond);
+        pthread_mutex_destroy(&d->mutex);
         delete d->dataGenerator;
+        delete d->generatorMutex;
         delete d;
     }
 
@@ -73,7 +183,11 @@ namespace SASModelProviderNamespace {
                 variables.push_back(d->nodeBrowser->getVariable(*uaNodeId));
             }
             // generate data for variables
-            std::vector<UaVariant*>* generatedData = d->dataGenerator->generate(variables); // ConversionException, GeneratorExceptionn
+            std::vector<UaVariant*>* generatedData;
+            {
+                MutexLock lock(*d->generatorMutex);
+                generatedData = d->dataGenerator->generate(variables); // ConversionException, GeneratorExceptionn
+            }
             VectorScopeGuard<UaVariant> generatedDataSG(generatedData);
             // for each variable
             for (int i = 0; i < generatedData->size(); i++) {
@@ -111,12 +225,11 @@ namespace SASModelProviderNamespace {
 
     std::vector<MethodData*>* GeneratorIODataProvider::call(std::vector<const MethodData*>& methodDataList)
     /* throws ConversionException, GeneratorExceptionn */ {
-
-        timespec ts;
-        ts.tv_sec = d->EVENT_INTERVAL;
-        ts.tv_nsec = 0;
-        for (int i = 0; i < d->EVENT_COUNT; i++) {
-            d->fireEvents();
+        // simulate the processing time of the methods
+        if (d->conf.methodLatency > 0) {
+            timespec ts;
+            ts.tv_sec = d->conf.methodLatency / 1000;
+            ts.tv_nsec = (d->conf.methodLatency % 1000) * 1000000;
             nanosleep(&ts, NULL /*remaining*/);
         }
 
@@ -150,7 +263,11 @@ namespace SASModelProviderNamespace {
             }
             method->releaseReference();
             // generate data for arguments
-            std::vector<UaVariant*>* generatedData = d->dataGenerator->generate(*args); // ConversionException, GeneratorExceptionn
+            std::vector<UaVariant*>* generatedData;
+            {
+                MutexLock lock(*d->generatorMutex);
+                generatedData = d->dataGenerator->generate(*args); // ConversionException, GeneratorExceptionn
+            }
             VectorScopeGuard<UaVariant> generatedDataSG(generatedData);
             // for each UaVariant
             for (int j = 0; j < generatedData->size(); j++) {
@@ -182,13 +299,31 @@ namespace SASModelProviderNamespace {
             if (node != NULL) {
                 switch (node->nodeClass()) {
                     case OpcUa_NodeClass_Variable:
+                    {
                         // add variable
                         variables.push_back(nodeId);
+                        // register variable for value changes
+                        std::string key = nodeId->toString();
+                        pthread_mutex_lock(&d->mutex);
+                        std::map<std::string, size_t>::iterator index =
+                                d->variableIndices.find(key);
+                        if (index == d->variableIndices.end()) {
+                            GeneratorIODataProviderPrivate::Variable variable;
+                            variable.nodeId = new NodeId(*nodeId);
+                            variable.callback = &callback;
+                            d->variableIndices[key] = d->variables.size();
+                            d->variables.push_back(variable);
+                        } else {
+                            d->variables[(*index).second].callback = &callback;
+                        }
+                        pthread_mutex_unlock(&d->mutex);
                         break;
+                    }
                     case OpcUa_NodeClass_ObjectType:
                         // register event type
-                        MutexLock lock(*d->mutex);
+                        pthread_mutex_lock(&d->mutex);
                         d->eventTypes[*uaNodeId] = &callback;
+                        pthread_mutex_unlock(&d->mutex);
                         break;
                 }
                 node->releaseReference();
@@ -226,26 +361,196 @@ namespace SASModelProviderNamespace {
         return ret;
     }
 
-    void GeneratorIODataProviderPrivate::fireEvents() /* throws GeneratorExceptionn */ {
-        MutexLock lock(*mutex);
+    void GeneratorIODataProvider::unsubscribe(const std::vector<const NodeId*>& nodeIds)
+    /* throws ConversionException */ {
+        std::vector<UaNodeId*>* uaNodeIds = new std::vector<UaNodeId*>();
+        VectorScopeGuard<UaNodeId> uaNodeIdsSG(uaNodeIds);
+        for (int i = 0; i < nodeIds.size(); i++) {
+            uaNodeIds->push_back(d->converter->convertIo2ua(*nodeIds[i])); // ConversionException
+        }
+        pthread_mutex_lock(&d->mutex);
+        // the callbacks of the nodes may be called by the generating thread
+        while (d->isGenerating) {
+            pthread_cond_wait(&d->cond, &d->mutex);
+        }
+        bool hasRemovedVariables = false;
+        for (int i = 0; i < nodeIds.size(); i++) {
+            std::map<std::string, size_t>::iterator index =
+                    d->variableIndices.find(nodeIds[i]->toString());
+            if (index != d->variableIndices.end()) {
+                // mark the variable as removed
+                GeneratorIODataProviderPrivate::Variable& variable = d->variables[(*index).second];
+                delete variable.nodeId;
+                variable.nodeId = NULL;
+                d->variableIndices.erase(index);
+                hasRemovedVariables = true;
+            } else {
+                d->eventTypes.erase(*(*uaNodeIds)[i]);
+            }
+        }
+        if (hasRemovedVariables) {
+            // remove the marked variables and update the indices of the remaining ones
+            size_t count = 0;
+            for (size_t i = 0; i < d->variables.size(); i++) {
+                GeneratorIODataProviderPrivate::Variable& variable = d->variables[i];
+                if (variable.nodeId != NULL) {
+                    d->variableIndices[variable.nodeId->toString()] = count;
+                    d->variables[count++] = variable;
+                }
+            }
+            d->variables.resize(count);
+        }
+        pthread_mutex_unlock(&d->mutex);
+    }
+
+    GeneratorIODataProvider::Metrics GeneratorIODataProvider::getMetrics() {
+        pthread_mutex_lock(&d->mutex);
+        Metrics ret = d->metrics;
+        pthread_mutex_unlock(&d->mutex);
+        return ret;
+    }
+
+    void* GeneratorIODataProviderPrivate::run(void* object) {
+        GeneratorIODataProviderPrivate& d = *static_cast<GeneratorIODataProviderPrivate*> (object);
+        pthread_mutex_lock(&d.mutex);
+        timespec lastTickTime;
+        clock_gettime(CLOCK_REALTIME, &lastTickTime);
+        while (!d.isClosed) {
+            timespec nextTickTime = add(lastTickTime, TICK_INTERVAL);
+            timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            if (isBefore(now, nextTickTime)) {
+                pthread_cond_timedwait(&d.cond, &d.mutex, &nextTickTime);
+                continue;
+            }
+            double elapsedSeconds = (now.tv_sec - lastTickTime.tv_sec)
+                    + (now.tv_nsec - lastTickTime.tv_nsec) / 1000000000.0;
+            lastTickTime = now;
+            d.generate(elapsedSeconds);
+        }
+        pthread_mutex_unlock(&d.mutex);
+        return NULL;
+    }
+
+    void GeneratorIODataProviderPrivate::generate(double elapsedSeconds) {
+        // get the variables whose values are due
+        size_t variableCount = conf.variableCount > 0
+                && conf.variableCount < variables.size() ? conf.variableCount : variables.size();
+        dueValueChanges += elapsedSeconds * conf.variableChangeRate * variableCount;
+        unsigned long valueChangeCount = static_cast<unsigned long> (dueValueChanges);
+        dueValueChanges -= valueChangeCount;
+        // max. one value change per variable and tick
+        if (valueChangeCount > variableCount) {
+            metrics.overrunCount += valueChangeCount - variableCount;
+            valueChangeCount = variableCount;
+        }
+        // callback -> nodeIds
+        std::map<SubscriberCallback*, std::vector<const NodeId*>*> valueChanges;
+        for (unsigned long i = 0; i < valueChangeCount; i++) {
+            Variable& variable = variables[nextVariable++ % variableCount];
+            std::vector<const NodeId*>*& nodeIds = valueChanges[variable.callback];
+            if (nodeIds == NULL) {
+                nodeIds = new std::vector<const NodeId*>();
+            }
+            nodeIds->push_back(new NodeId(*variable.nodeId));
+        }
+        // get the event types whose events are due
+        size_t eventTypeCount = conf.eventTypeCount > 0
+                && conf.eventTypeCount < eventTypes.size() ? conf.eventTypeCount : eventTypes.size();
+        dueEvents += elapsedSeconds * conf.eventRate * eventTypeCount;
+        unsigned long eventCount = static_cast<unsigned long> (dueEvents);
+        dueEvents -= eventCount;
+        // max. one event per event type and tick
+        if (eventCount > eventTypeCount) {
+            metrics.overrunCount += eventCount - eventTypeCount;
+            eventCount = eventTypeCount;
+        }
+        std::vector<std::pair<UaNodeId, SubscriberCallback*> > events;
+        for (unsigned long i = 0; i < eventCount; i++) {
+            std::map<UaNodeId, SubscriberCallback*>::iterator eventType = eventTypes.begin();
+            std::advance(eventType, nextEventType++ % eventTypeCount);
+            events.push_back(*eventType);
+        }
+        isGenerating = true;
+        pthread_mutex_unlock(&mutex);
+
+        unsigned long failedCount = 0;
+        for (std::map<SubscriberCallback*, std::vector<const NodeId*>*>::iterator i =
+                valueChanges.begin(); i != valueChanges.end(); i++) {
+            VectorScopeGuard<const NodeId> nodeIdsSG((*i).second);
+            try {
+                fireValueChanges(*(*i).second, *(*i).first); // ConversionException, GeneratorException, SubscriberCallbackException
+            } catch (Exception& e) {
+                failedCount++;
+                LogThrottle* throttle = LoggerFactory::getLogThrottle("GeneratorIODataProvider");
+                if (throttle == NULL || throttle->pass("Cannot generate values: %s")) {
+                    std::string st;
+                    e.getStackTrace(st);
+                    log->error("Cannot generate values: %s", st.c_str());
+                }
+            }
+        }
+        if (events.size() > 0) {
+            try {
+                fireEvents(events); // GeneratorException
+            } catch (Exception& e) {
+                failedCount++;
+                LogThrottle* throttle = LoggerFactory::getLogThrottle("GeneratorIODataProvider");
+                if (throttle == NULL || throttle->pass("Cannot generate events: %s")) {
+                    std::string st;
+                    e.getStackTrace(st);
+                    log->error("Cannot generate events: %s", st.c_str());
+                }
+            }
+        }
+
+        pthread_mutex_lock(&mutex);
+        metrics.valueChangeCount += valueChangeCount;
+        metrics.eventCount += eventCount;
+        metrics.failedCount += failedCount;
+        // wake up the threads which are waiting in "unsubscribe"
+        isGenerating = false;
+        pthread_cond_broadcast(&cond);
+    }
+
+    void GeneratorIODataProviderPrivate::fireValueChanges(const std::vector<const NodeId*>& nodeIds,
+            SubscriberCallback& callback)
+    /* throws ConversionException, GeneratorExceptionn, SubscriberCallbackException */ {
+        // generate data for variables
+        std::vector<NodeData*>* values = provider->read(nodeIds); // ConversionException, GeneratorException
+        VectorScopeGuard<NodeData> valuesSG(values);
+        // move the node data to an event with time stamp
+        std::vector<const NodeData*>* nodeData =
+                new std::vector<const NodeData*>(values->begin(), values->end());
+        values->clear();
+        Event event(getTime(), *nodeData, true /*attachValues*/);
+        // fire value changes
+        callback.valuesChanged(event); // SubscriberCallbackException
+    }
+
+    void GeneratorIODataProviderPrivate::fireEvents(
+            const std::vector<std::pair<UaNodeId, SubscriberCallback*> >& types)
+    /* throws GeneratorExceptionn */ {
         GeneratorException* exception = NULL;
         std::vector<UaObjectType*> objectTypes;
         try {
             // for each event type
-            for (std::map<UaNodeId, SubscriberCallback*>::const_iterator it = eventTypes.begin();
-                    it != eventTypes.end(); it++) {
-                // get UaObjectType                
-                objectTypes.push_back(nodeBrowser->getObjectType(it->first));
+            for (int i = 0; i < types.size(); i++) {
+                // get UaObjectType
+                objectTypes.push_back(nodeBrowser->getObjectType(types[i].first));
             }
             // generate data for event types
-            std::vector<OpcUaEventData*>* generatedData =
-                    dataGenerator->generate(objectTypes); // ConversionException, GeneratorException
+            std::vector<OpcUaEventData*>* generatedData;
+            {
+                MutexLock lock(*generatorMutex);
+                generatedData = dataGenerator->generate(objectTypes); // ConversionException, GeneratorException
+            }
             VectorScopeGuard<OpcUaEventData> generatedDataSG(generatedData);
             // for each event type
             for (int i = 0; i < generatedData->size(); i++) {
                 OpcUaEventData* eventData = (*generatedData)[i];
                 if (eventData != NULL) {
-                    UaNodeId uaNodeId = objectTypes[i]->nodeId();
+                    const UaNodeId& uaNodeId = types[i].first;
                     try {
                         // convert UaNodeId to NodeId
                         NodeId* nodeId = converter->convertUa2io(uaNodeId); // ConversionException
@@ -256,9 +561,9 @@ namespace SASModelProviderNamespace {
                         // create event with time stamp and node data
                         Event event(getTime(), *nodeData, true /*attachValues*/);
                         // fire event
-                        eventTypes[uaNodeId]->valuesChanged(event); // SubscriberCallbackException                        
+                        types[i].second->valuesChanged(event); // SubscriberCallbackException
                     } catch (Exception& e) {
-                        if (exception != NULL) {
+                        if (exception == NULL) {
                             std::ostringstream msg;
                             msg << "Cannot fire event for type " << uaNodeId.toXmlString().toUtf8();
                             exception = new ExceptionDef(GeneratorException, msg.str());
@@ -276,9 +581,9 @@ namespace SASModelProviderNamespace {
             for (int i = 0; i < objectTypes.size(); i++) {
                 objectTypes[i]->releaseReference();
             }
-            if (exception != NULL) {
+            if (exception == NULL) {
                 exception = new ExceptionDef(GeneratorException, std::string("Cannot fire events"));
-                exception->setCause(exception);
+                exception->setCause(&e);
             }
         }
         if (exception != NULL) {
@@ -286,4 +591,20 @@ namespace SASModelProviderNamespace {
             throw *exception;
         }
     }
+
+    timespec GeneratorIODataProviderPrivate::add(const timespec& time, long milliseconds) {
+        timespec ret = time;
+        ret.tv_sec += milliseconds / 1000;
+        ret.tv_nsec += (milliseconds % 1000) * 1000000;
+        if (ret.tv_nsec >= 1000000000) {
+            ret.tv_sec++;
+            ret.tv_nsec -= 1000000000;
+        }
+        return ret;
+    }
+
+    bool GeneratorIODataProviderPrivate::isBefore(const timespec& time1, const timespec& time2) {
+        return time1.tv_sec < time2.tv_sec
+                || (time1.tv_sec == time2.tv_sec && time1.tv_nsec < time2.tv_nsec);
+    }
 } // namespace SASModelProviderNamespace
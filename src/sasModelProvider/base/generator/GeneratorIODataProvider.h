@@ -13,10 +13,46 @@ namespace SASModelProviderNamespace {
 
     class GeneratorIODataProviderPrivate;
 
+    // Generates values for variables, method output arguments and events.
+    // The values of subscribed variables and events of subscribed event types are generated
+    // by a separate thread with the configured rates. It can be used for driving the server
+    // with a target load without a real IO data provider. Subscriptions are dropped with
+    // "unsubscribe".
+    // This class is thread safe.
     class GeneratorIODataProvider {
     public:
 
-        GeneratorIODataProvider(NodeBrowser& nodeBrowser, ConverterUa2IO& converter);
+        class Configuration {
+        public:
+            Configuration();
+
+            // max. count of subscribed variables whose values are changed (0: all)
+            long variableCount;
+            // value changes per second and variable (0: the values are not changed)
+            double variableChangeRate;
+            // max. count of subscribed event types for which events are fired (0: all)
+            long eventTypeCount;
+            // events per second and event type (0: no events are fired)
+            double eventRate;
+            // processing time of method calls in milliseconds
+            long methodLatency;
+        };
+
+        class Metrics {
+        public:
+            // count of generated value changes of subscribed variables
+            unsigned long valueChangeCount;
+            // count of fired events
+            unsigned long eventCount;
+            // count of value changes and events which could not be generated in time
+            unsigned long overrunCount;
+            // count of failed generations
+            unsigned long failedCount;
+        };
+
+        GeneratorIODataProvider(NodeBrowser& nodeBrowser, ConverterUa2IO& converter,
+                const Configuration& conf = Configuration()) /* throws MutexException */;
+        // Stops the generating thread.
         virtual ~GeneratorIODataProvider();
 
         // The returned vector instance and its content must be destroyed by the caller.
@@ -29,7 +65,15 @@ namespace SASModelProviderNamespace {
         /* throws ConversionException, DataGeneratorExceptionn */;
         virtual std::vector<IODataProviderNamespace::NodeData*>* subscribe(
                 const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds,
-                IODataProviderNamespace::SubscriberCallback& callback);
+                IODataProviderNamespace::SubscriberCallback& callback)
+        /* throws ConversionException, GeneratorExceptionn */;
+        // Cancels the subscriptions of variables and event types. Unknown nodes are ignored.
+        // After the method returns the callbacks of the nodes are not called anymore. Thus the
+        // method must not be called from a callback.
+        virtual void unsubscribe(const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds)
+        /* throws ConversionException */;
+
+        virtual Metrics getMetrics();
     private:
         GeneratorIODataProvider(const GeneratorIODataProvider& orig);
         GeneratorIODataProvider& operator=(const GeneratorIODataProvider&);
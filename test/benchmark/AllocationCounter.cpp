@@ -0,0 +1,40 @@
+#include "AllocationCounter.h"
+#include <stddef.h> // size_t
+
+// the allocation functions of glibc
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+namespace BenchmarkNamespace {
+
+    static unsigned long long allocationCount = 0;
+    static unsigned long long allocatedBytes = 0;
+
+    static inline void count(size_t size) {
+        __sync_add_and_fetch(&allocationCount, 1);
+        __sync_add_and_fetch(&allocatedBytes, size);
+    }
+
+    AllocationCounter::Counts AllocationCounter::getCounts() {
+        Counts ret;
+        ret.allocationCount = __sync_add_and_fetch(&allocationCount, 0);
+        ret.allocatedBytes = __sync_add_and_fetch(&allocatedBytes, 0);
+        return ret;
+    }
+} // namespace BenchmarkNamespace
+
+extern "C" void* malloc(size_t size) {
+    BenchmarkNamespace::count(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    BenchmarkNamespace::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    BenchmarkNamespace::count(size);
+    return __libc_realloc(ptr, size);
+}
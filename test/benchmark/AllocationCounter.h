@@ -0,0 +1,26 @@
+#ifndef BENCHMARK_ALLOCATIONCOUNTER_H
+#define BENCHMARK_ALLOCATIONCOUNTER_H
+
+namespace BenchmarkNamespace {
+
+    // Counts the heap allocations of the process.
+    // The functions malloc, calloc and realloc are replaced for the benchmark executable. All
+    // allocations are counted including those of the OPC UA stack (OpcUa_Alloc) and the C++
+    // runtime (operator new). The counters are updated atomically.
+    // The executable must not be built with a sanitizer which replaces the allocator itself.
+    class AllocationCounter {
+    public:
+
+        class Counts {
+        public:
+            unsigned long long allocationCount;
+            unsigned long long allocatedBytes;
+        };
+
+        // Returns the counts since the start of the process.
+        static Counts getCounts();
+    private:
+        AllocationCounter();
+    };
+} // namespace BenchmarkNamespace
+#endif /* BENCHMARK_ALLOCATIONCOUNTER_H */
@@ -0,0 +1,27 @@
+#include "Benchmark.h"
+
+namespace BenchmarkNamespace {
+
+    Benchmark::Benchmark(const std::string& name) {
+        this->name = name;
+    }
+
+    Benchmark::~Benchmark() {
+    }
+
+    const std::string& Benchmark::getName() const {
+        return name;
+    }
+
+    void Benchmark::setUp() {
+    }
+
+    void Benchmark::tearDown() {
+    }
+
+    BenchmarkGroup::BenchmarkGroup() {
+    }
+
+    BenchmarkGroup::~BenchmarkGroup() {
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,82 @@
+#ifndef BENCHMARK_BENCHMARK_H
+#define BENCHMARK_BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+namespace BenchmarkNamespace {
+
+    // A benchmark measures one operation which is executed repeatedly by the BenchmarkRunner.
+    class Benchmark {
+    public:
+        // The name has the format "<group>/<operation>[/<variant>]".
+        Benchmark(const std::string& name);
+        virtual ~Benchmark();
+
+        virtual const std::string& getName() const;
+
+        // Prepares the execution of the operation (e.g. attaches the thread to a JVM). It is
+        // called by the BenchmarkRunner before the first execution of the operation in the
+        // same thread. The default implementation does nothing.
+        virtual void setUp();
+        // Called after the last execution of the operation or if "setUp" or "run" fails. The
+        // default implementation does nothing.
+        virtual void tearDown();
+
+        // Executes the operation once. The results of the operation must be released in the
+        // same call because the allocations are measured per operation.
+        virtual void run() = 0;
+    private:
+        Benchmark(const Benchmark& orig);
+        Benchmark& operator=(const Benchmark&);
+
+        std::string name;
+    };
+
+    // A benchmark which calls a method of a fixture object (e.g. the group) per operation.
+    template<typename T> class MethodBenchmark : public Benchmark {
+    public:
+        typedef void (T::*Operation)();
+
+        MethodBenchmark(const std::string& name, T& fixture, Operation operation)
+        : Benchmark(name) {
+            this->fixture = &fixture;
+            this->operation = operation;
+        }
+
+        virtual void run() {
+            (fixture->*operation)();
+        }
+    private:
+        T* fixture;
+        Operation operation;
+    };
+
+    // A group provides the benchmarks of a component and holds the fixture data which is
+    // shared by the benchmarks (converters, registries, values). The group must outlive its
+    // benchmarks.
+    class BenchmarkGroup {
+    public:
+        BenchmarkGroup();
+        virtual ~BenchmarkGroup();
+
+        // Creates the benchmarks of the group. The responsibility for destroying the
+        // benchmarks is delegated to the caller.
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) = 0;
+    private:
+        BenchmarkGroup(const BenchmarkGroup& orig);
+        BenchmarkGroup& operator=(const BenchmarkGroup&);
+    };
+
+    // the groups of the benchmark executable
+    BenchmarkGroup* createLogThrottleBenchmarks();
+    BenchmarkGroup* createNodeIdBenchmarks();
+    BenchmarkGroup* createNodeDataBenchmarks();
+    BenchmarkGroup* createScalarBenchmarks();
+    BenchmarkGroup* createConverterUa2IOBenchmarks();
+    BenchmarkGroup* createConverterBin2IOBenchmarks();
+    BenchmarkGroup* createCachedConverterCallbackBenchmarks();
+    BenchmarkGroup* createEventTypeRegistryBenchmarks();
+    BenchmarkGroup* createNodeBrowserBenchmarks();
+} // namespace BenchmarkNamespace
+#endif /* BENCHMARK_BENCHMARK_H */
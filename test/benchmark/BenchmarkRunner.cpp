@@ -0,0 +1,156 @@
+#include "BenchmarkRunner.h"
+#include "AllocationCounter.h"
+#include <stdio.h> // snprintf
+#include <time.h> // clock_gettime
+
+namespace BenchmarkNamespace {
+
+    static long long now() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    static std::string quote(const std::string& str) {
+        std::string ret("\"");
+        for (size_t i = 0; i < str.size(); i++) {
+            if (str[i] == '"' || str[i] == '\\') {
+                ret.push_back('\\');
+            }
+            ret.push_back(str[i]);
+        }
+        ret.push_back('"');
+        return ret;
+    }
+
+    static std::string format(double value) {
+        char buffer[32];
+        snprintf(buffer, sizeof (buffer), "%.2f", value);
+        return std::string(buffer);
+    }
+
+    BenchmarkRunner::Counter::Counter(const std::string& name) {
+        this->name = name;
+    }
+
+    BenchmarkRunner::Counter::~Counter() {
+    }
+
+    const std::string& BenchmarkRunner::Counter::getName() const {
+        return name;
+    }
+
+    BenchmarkRunner::BenchmarkRunner(long minTime) {
+        this->minTime = minTime;
+    }
+
+    BenchmarkRunner::~BenchmarkRunner() {
+    }
+
+    void BenchmarkRunner::addCounter(Counter& counter) {
+        counters.push_back(&counter);
+    }
+
+    BenchmarkRunner::Result BenchmarkRunner::run(Benchmark& benchmark) {
+        try {
+            benchmark.setUp();
+            Result ret = measure(benchmark);
+            benchmark.tearDown();
+            return ret;
+        } catch (...) {
+            benchmark.tearDown();
+            throw;
+        }
+    }
+
+    BenchmarkRunner::Result BenchmarkRunner::measure(Benchmark& benchmark) {
+        long long minTimeNs = minTime * 1000000LL;
+        unsigned long long iterationCount = 1;
+        std::vector<long long> startValues(counters.size());
+        while (true) {
+            for (size_t i = 0; i < counters.size(); i++) {
+                startValues[i] = counters[i]->getValue();
+            }
+            AllocationCounter::Counts startCounts = AllocationCounter::getCounts();
+            long long start = now();
+            for (unsigned long long i = 0; i < iterationCount; i++) {
+                benchmark.run();
+            }
+            long long duration = now() - start;
+            AllocationCounter::Counts endCounts = AllocationCounter::getCounts();
+            if (duration >= minTimeNs) {
+                Result ret;
+                ret.name = benchmark.getName();
+                ret.iterationCount = iterationCount;
+                ret.nsPerOp = static_cast<double> (duration) / iterationCount;
+                ret.allocationsPerOp = static_cast<double> (
+                        endCounts.allocationCount - startCounts.allocationCount) / iterationCount;
+                ret.bytesPerOp = static_cast<double> (
+                        endCounts.allocatedBytes - startCounts.allocatedBytes) / iterationCount;
+                for (size_t i = 0; i < counters.size(); i++) {
+                    ret.counters.push_back(std::pair<std::string, double>(
+                            counters[i]->getName(), static_cast<double> (
+                            counters[i]->getValue() - startValues[i]) / iterationCount));
+                }
+                return ret;
+            }
+            // estimate the iteration count for the min. time (+20%) but increase it at most
+            // by factor 100
+            unsigned long long next = iterationCount * 100;
+            if (duration > 0) {
+                double estimate = 1.2 * minTimeNs / duration * iterationCount;
+                if (estimate < next) {
+                    next = static_cast<unsigned long long> (estimate);
+                }
+            }
+            iterationCount = next > iterationCount ? next : iterationCount + 1;
+        }
+    }
+
+    void BenchmarkRunner::write(std::ostream& out, const std::string& version,
+            const std::vector<Result>& results, Format format) {
+        switch (format) {
+            case JSON:
+                out << "{\n  \"version\": " << quote(version) << ",\n  \"benchmarks\": [";
+                for (size_t i = 0; i < results.size(); i++) {
+                    const Result& result = results[i];
+                    out << (i == 0 ? "\n" : ",\n")
+                            << "    {\"name\": " << quote(result.name)
+                            << ", \"iterations\": " << result.iterationCount
+                            << ", \"nsPerOp\": " << BenchmarkNamespace::format(result.nsPerOp)
+                            << ", \"allocationsPerOp\": "
+                            << BenchmarkNamespace::format(result.allocationsPerOp)
+                            << ", \"bytesPerOp\": "
+                            << BenchmarkNamespace::format(result.bytesPerOp);
+                    for (size_t j = 0; j < result.counters.size(); j++) {
+                        out << ", " << quote(result.counters[j].first + "PerOp") << ": "
+                                << BenchmarkNamespace::format(result.counters[j].second);
+                    }
+                    out << "}";
+                }
+                out << "\n  ]\n}\n";
+                break;
+            case CSV:
+                out << "name,iterations,nsPerOp,allocationsPerOp,bytesPerOp";
+                if (results.size() > 0) {
+                    for (size_t j = 0; j < results[0].counters.size(); j++) {
+                        out << "," << results[0].counters[j].first << "PerOp";
+                    }
+                }
+                out << "\n";
+                for (size_t i = 0; i < results.size(); i++) {
+                    const Result& result = results[i];
+                    // the names do not contain separators
+                    out << result.name << "," << result.iterationCount << ","
+                            << BenchmarkNamespace::format(result.nsPerOp) << ","
+                            << BenchmarkNamespace::format(result.allocationsPerOp) << ","
+                            << BenchmarkNamespace::format(result.bytesPerOp);
+                    for (size_t j = 0; j < result.counters.size(); j++) {
+                        out << "," << BenchmarkNamespace::format(result.counters[j].second);
+                    }
+                    out << "\n";
+                }
+                break;
+        }
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,73 @@
+#ifndef BENCHMARK_BENCHMARKRUNNER_H
+#define BENCHMARK_BENCHMARKRUNNER_H
+
+#include "Benchmark.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace BenchmarkNamespace {
+
+    // Executes benchmarks and writes the results in a machine-readable format.
+    class BenchmarkRunner {
+    public:
+
+        enum Format {
+            JSON, CSV
+        };
+
+        // An additional counter which is measured per operation (e.g. the JNI references
+        // created by the operation).
+        class Counter {
+        public:
+            // The name is written with the suffix "PerOp".
+            Counter(const std::string& name);
+            virtual ~Counter();
+
+            virtual const std::string& getName() const;
+            // Returns the current value of the counter.
+            virtual long long getValue() = 0;
+        private:
+            Counter(const Counter& orig);
+            Counter& operator=(const Counter&);
+
+            std::string name;
+        };
+
+        class Result {
+        public:
+            std::string name;
+            unsigned long long iterationCount;
+            double nsPerOp;
+            double allocationsPerOp;
+            double bytesPerOp;
+            // the names and values per operation of the additional counters
+            std::vector<std::pair<std::string, double> > counters;
+        };
+
+        // The iteration count of a benchmark is increased until the measured time reaches
+        // "minTime" (in ms). The calibration runs also warm up caches of the components.
+        BenchmarkRunner(long minTime);
+        virtual ~BenchmarkRunner();
+
+        // Adds a counter which is measured for each benchmark. A reference to the counter is
+        // saved internally.
+        virtual void addCounter(Counter& counter);
+
+        virtual Result run(Benchmark& benchmark);
+
+        // Writes the results. JSON: {"version": ..., "benchmarks": [{"name": ..., ...}, ...]},
+        // CSV: a header line and a line per result. The results must have the same counters.
+        static void write(std::ostream& out, const std::string& version,
+                const std::vector<Result>& results, Format format);
+    private:
+        BenchmarkRunner(const BenchmarkRunner& orig);
+        BenchmarkRunner& operator=(const BenchmarkRunner&);
+
+        Result measure(Benchmark& benchmark);
+
+        long minTime;
+        std::vector<Counter*> counters;
+    };
+} // namespace BenchmarkNamespace
+#endif /* BENCHMARK_BENCHMARKRUNNER_H */
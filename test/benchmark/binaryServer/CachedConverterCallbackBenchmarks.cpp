@@ -0,0 +1,79 @@
+#include "../Benchmark.h"
+#include "../../../src/binaryServer/CachedConverterCallback.h"
+#include <sasModelProvider/base/ConverterUa2IO.h>
+#include <uanodeid.h> // UaNodeId
+#include <uastructuredefinition.h> // UaStructureDefinition
+#include <vector>
+
+using namespace SASModelProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // The hit paths of CachedConverterCallback (the values have been cached before).
+    class CachedConverterCallbackBenchmarks : public BenchmarkGroup {
+    public:
+
+        // Provides a structure definition and the super types for any data type.
+        class ConverterCallback : public ConverterUa2IO::ConverterCallback {
+        public:
+
+            virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId) {
+                UaStructureDefinition ret;
+                ret.setName("Structure");
+                ret.setDataTypeId(dataTypeId);
+                UaStructureField field;
+                field.setName("Field");
+                field.setDataTypeId(OpcUaId_Int32);
+                field.setArrayType(UaStructureField::ArrayType_Scalar);
+                ret.addChild(field);
+                return ret;
+            }
+
+            virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& dataTypeId) {
+                std::vector<UaNodeId>* ret = new std::vector<UaNodeId>();
+                ret->push_back(UaNodeId(OpcUaId_Structure));
+                return ret;
+            }
+        };
+
+        CachedConverterCallbackBenchmarks()
+        : cache(callback, false /* attachValues */), dataTypeId(17, 2 /* nsIndex */) {
+            // fill the cache with 100 data types
+            for (int i = 0; i < 100; i++) {
+                cache.preload(UaNodeId(i, 2 /* nsIndex */));
+            }
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new MethodBenchmark<CachedConverterCallbackBenchmarks>(
+                    "CachedConverterCallback/getStructureDefinition/hit", *this,
+                    &CachedConverterCallbackBenchmarks::getStructureDefinition));
+            benchmarks.push_back(new MethodBenchmark<CachedConverterCallbackBenchmarks>(
+                    "CachedConverterCallback/getSuperTypes/hit", *this,
+                    &CachedConverterCallbackBenchmarks::getSuperTypes));
+            benchmarks.push_back(new MethodBenchmark<CachedConverterCallbackBenchmarks>(
+                    "CachedConverterCallback/getBuildInType/hit", *this,
+                    &CachedConverterCallbackBenchmarks::getBuildInType));
+        }
+
+        void getStructureDefinition() {
+            cache.getStructureDefinition(dataTypeId);
+        }
+
+        void getSuperTypes() {
+            delete cache.getSuperTypes(dataTypeId);
+        }
+
+        void getBuildInType() {
+            cache.getBuildInType(dataTypeId);
+        }
+    private:
+        ConverterCallback callback;
+        CachedConverterCallback cache;
+        UaNodeId dataTypeId;
+    };
+
+    BenchmarkGroup* createCachedConverterCallbackBenchmarks() {
+        return new CachedConverterCallbackBenchmarks();
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,112 @@
+#include "../../Benchmark.h"
+#include <common/logging/LogThrottle.h>
+#include <common/logging/Logger.h>
+#include <stdio.h> // sprintf
+#include <vector>
+
+using namespace CommonNamespace;
+
+namespace BenchmarkNamespace {
+
+    // The log throttle during an outage: each read of 100 nodes fails and the errors are
+    // logged via a logger which discards the messages.
+    class LogThrottleBenchmarks : public BenchmarkGroup {
+    public:
+        typedef MethodBenchmark<LogThrottleBenchmarks> Method;
+
+        LogThrottleBenchmarks() : throttle(log, LogThrottle::Configuration()) {
+            LogThrottle::Configuration conf;
+            conf.messagesPerSecond = 0;
+            disabledThrottle = new LogThrottle(log, conf);
+            for (int i = 0; i < NODE_COUNT; i++) {
+                sprintf(nodes[i], "ns=1;i=%d", i);
+            }
+        }
+
+        virtual ~LogThrottleBenchmarks() {
+            delete disabledThrottle;
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new Method("LogThrottle/outage/noThrottle", *this,
+                    &LogThrottleBenchmarks::outageWithoutThrottle));
+            benchmarks.push_back(new Method("LogThrottle/outage/disabled", *this,
+                    &LogThrottleBenchmarks::outageWithDisabledThrottle));
+            benchmarks.push_back(new Method("LogThrottle/outage/throttled", *this,
+                    &LogThrottleBenchmarks::outageWithThrottle));
+        }
+
+        void outageWithoutThrottle() {
+            for (int i = 0; i < NODE_COUNT; i++) {
+                log.error("Cannot read value of node %s: %s", nodes[i], "timeout");
+            }
+        }
+
+        void outageWithDisabledThrottle() {
+            read(*disabledThrottle);
+        }
+
+        void outageWithThrottle() {
+            read(throttle);
+        }
+    private:
+
+        class LoggerImpl : public Logger {
+        public:
+
+            virtual void error(const char* format, ...) {
+            }
+
+            virtual void warn(const char* format, ...) {
+            }
+
+            virtual void info(const char* format, ...) {
+            }
+
+            virtual void debug(const char* format, ...) {
+            }
+
+            virtual void trace(const char* format, ...) {
+            }
+
+            virtual bool isErrorEnabled() {
+                return true;
+            }
+
+            virtual bool isWarnEnabled() {
+                return true;
+            }
+
+            virtual bool isInfoEnabled() {
+                return true;
+            }
+
+            virtual bool isDebugEnabled() {
+                return true;
+            }
+
+            virtual bool isTraceEnabled() {
+                return true;
+            }
+        };
+
+        static const int NODE_COUNT = 100;
+
+        LoggerImpl log;
+        LogThrottle throttle;
+        LogThrottle* disabledThrottle;
+        char nodes[NODE_COUNT][16];
+
+        void read(LogThrottle& throttle) {
+            for (int i = 0; i < NODE_COUNT; i++) {
+                if (throttle.pass("Cannot read value of node %s: %s", nodes[i])) {
+                    log.error("Cannot read value of node %s: %s", nodes[i], "timeout");
+                }
+            }
+        }
+    };
+
+    BenchmarkGroup* createLogThrottleBenchmarks() {
+        return new LogThrottleBenchmarks();
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,109 @@
+#include "../Benchmark.h"
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/MessageRegistry.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <stddef.h> // NULL
+#include <string>
+#include <vector>
+
+using namespace IODataProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // The error path of a read: the results of 500 nodes are created and processed like the
+    // bridge does. The failures of nodes are reported via exceptions or via status codes.
+    class NodeDataBenchmarks : public BenchmarkGroup {
+    public:
+        typedef MethodBenchmark<NodeDataBenchmarks> Method;
+
+        NodeDataBenchmarks() : cause(ExceptionDef(IODataProviderException,
+        std::string("Connection lost"))) {
+            messageId = MessageRegistry::registerMessage("Cannot read data");
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new Method("NodeData/read/noFailures", *this,
+                    &NodeDataBenchmarks::readWithoutFailures));
+            benchmarks.push_back(new Method("NodeData/read/10%failures/exception", *this,
+                    &NodeDataBenchmarks::read10PercentExceptions));
+            benchmarks.push_back(new Method("NodeData/read/10%failures/status", *this,
+                    &NodeDataBenchmarks::read10PercentStatus));
+            benchmarks.push_back(new Method("NodeData/read/100%failures/exception", *this,
+                    &NodeDataBenchmarks::read100PercentExceptions));
+            benchmarks.push_back(new Method("NodeData/read/100%failures/status", *this,
+                    &NodeDataBenchmarks::read100PercentStatus));
+        }
+
+        void readWithoutFailures() {
+            read(0 /* failurePercent */, true /* useStatus */);
+        }
+
+        void read10PercentExceptions() {
+            read(10 /* failurePercent */, false /* useStatus */);
+        }
+
+        void read10PercentStatus() {
+            read(10 /* failurePercent */, true /* useStatus */);
+        }
+
+        void read100PercentExceptions() {
+            read(100 /* failurePercent */, false /* useStatus */);
+        }
+
+        void read100PercentStatus() {
+            read(100 /* failurePercent */, true /* useStatus */);
+        }
+    private:
+        IODataProviderException cause;
+        int messageId;
+
+        // Returns the count of failed nodes.
+        int read(int failurePercent, bool useStatus) {
+            const int nodeCount = 500;
+            std::vector<NodeData*> results;
+            for (int i = 0; i < nodeCount; i++) {
+                NodeId* nodeId = new NodeId(1, i);
+                if (failurePercent == 0 || i % (100 / failurePercent) != 0) {
+                    Scalar* value = new Scalar();
+                    value->setLong(i);
+                    results.push_back(new NodeData(*nodeId, value, true /* attachValues */));
+                    continue;
+                }
+                NodeData* result = new NodeData(*nodeId, NULL /* data */,
+                        true /* attachValues */);
+                if (useStatus) {
+                    result->setStatus(0x80050000 /* BadCommunicationError */, messageId);
+                } else {
+                    IODataProviderException* exception = new ExceptionDef(
+                            IODataProviderException,
+                            std::string("Cannot read data for ").append(nodeId->toString()));
+                    exception->setCause(&cause);
+                    result->setException(exception);
+                }
+                results.push_back(result);
+            }
+            int ret = 0;
+            for (int i = 0; i < results.size(); i++) {
+                NodeData& result = *results[i];
+                if (useStatus) {
+                    if (result.hasError()) {
+                        std::string msg = MessageRegistry::getMessage(result.getMessageId());
+                        ret += result.getStatusCode() != 0 && !msg.empty() ? 1 : 0;
+                    }
+                } else if (result.getException() != NULL) {
+                    std::string st;
+                    result.getException()->getStackTrace(st);
+                    ret += st.empty() ? 0 : 1;
+                }
+                delete results[i];
+            }
+            return ret;
+        }
+    };
+
+    BenchmarkGroup* createNodeDataBenchmarks() {
+        return new NodeDataBenchmarks();
+    }
+} // namespace BenchmarkNamespace
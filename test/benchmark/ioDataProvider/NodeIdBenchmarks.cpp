@@ -0,0 +1,123 @@
+#include "../Benchmark.h"
+#include "../../../src/provider/binary/messages/dto/ParamId.h"
+#include <ioDataProvider/NodeId.h>
+#include <uanodeid.h> // UaNodeId
+#include <uastring.h> // UaString
+#include <string>
+
+namespace BenchmarkNamespace {
+
+    // Construction, copying and parsing of the node identifiers of the layers:
+    // NodeId (IO data provider), UaNodeId (OPC UA) and ParamId (binary provider).
+    class NodeIdBenchmarks : public BenchmarkGroup {
+    public:
+        typedef MethodBenchmark<NodeIdBenchmarks> Method;
+
+        NodeIdBenchmarks() : numericNodeId(2 /*nsIndex*/, 4711),
+        stringId("rfid.reader.antenna1.scanData"), stringNodeId(2 /*nsIndex*/, stringId),
+        numericUaNodeId(4711, 2 /*nsIndex*/),
+        stringUaNodeId(UaString(stringId.c_str()), 2 /*nsIndex*/),
+        numericXml("ns=2;i=4711"), stringXml("ns=2;s=rfid.reader.antenna1.scanData"),
+        numericParamId(2 /*nsIndex*/, 4711), stringParamId(2 /*nsIndex*/, stringId),
+        numericParamIdString("NS2|Numeric|4711"),
+        stringParamIdString("NS2|String|rfid.reader.antenna1.scanData") {
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new Method("NodeId/create/numeric", *this,
+                    &NodeIdBenchmarks::createNumericNodeId));
+            benchmarks.push_back(new Method("NodeId/create/string", *this,
+                    &NodeIdBenchmarks::createStringNodeId));
+            benchmarks.push_back(new Method("NodeId/copy/string", *this,
+                    &NodeIdBenchmarks::copyStringNodeId));
+            benchmarks.push_back(new Method("NodeId/toString/numeric", *this,
+                    &NodeIdBenchmarks::numericNodeIdToString));
+            benchmarks.push_back(new Method("UaNodeId/create/string", *this,
+                    &NodeIdBenchmarks::createStringUaNodeId));
+            benchmarks.push_back(new Method("UaNodeId/parse/numeric", *this,
+                    &NodeIdBenchmarks::parseNumericUaNodeId));
+            benchmarks.push_back(new Method("UaNodeId/parse/string", *this,
+                    &NodeIdBenchmarks::parseStringUaNodeId));
+            benchmarks.push_back(new Method("UaNodeId/toXmlString/string", *this,
+                    &NodeIdBenchmarks::stringUaNodeIdToXmlString));
+            benchmarks.push_back(new Method("ParamId/create/numeric", *this,
+                    &NodeIdBenchmarks::createNumericParamId));
+            benchmarks.push_back(new Method("ParamId/create/string", *this,
+                    &NodeIdBenchmarks::createStringParamId));
+            benchmarks.push_back(new Method("ParamId/parse/numeric", *this,
+                    &NodeIdBenchmarks::parseNumericParamId));
+            benchmarks.push_back(new Method("ParamId/parse/string", *this,
+                    &NodeIdBenchmarks::parseStringParamId));
+            benchmarks.push_back(new Method("ParamId/toString/string", *this,
+                    &NodeIdBenchmarks::stringParamIdToString));
+        }
+
+        void createNumericNodeId() {
+            IODataProviderNamespace::NodeId nodeId(2 /*nsIndex*/, 4711);
+        }
+
+        void createStringNodeId() {
+            IODataProviderNamespace::NodeId nodeId(2 /*nsIndex*/, stringId);
+        }
+
+        void copyStringNodeId() {
+            IODataProviderNamespace::NodeId nodeId(stringNodeId);
+        }
+
+        void numericNodeIdToString() {
+            numericNodeId.toString();
+        }
+
+        void createStringUaNodeId() {
+            UaNodeId nodeId(UaString(stringId.c_str()), 2 /*nsIndex*/);
+        }
+
+        void parseNumericUaNodeId() {
+            UaNodeId::fromXmlString(numericXml);
+        }
+
+        void parseStringUaNodeId() {
+            UaNodeId::fromXmlString(stringXml);
+        }
+
+        void stringUaNodeIdToXmlString() {
+            stringUaNodeId.toXmlString();
+        }
+
+        void createNumericParamId() {
+            ParamId paramId(2 /*nsIndex*/, 4711);
+        }
+
+        void createStringParamId() {
+            ParamId paramId(2 /*nsIndex*/, stringId);
+        }
+
+        void parseNumericParamId() {
+            ParamId paramId(numericParamIdString);
+        }
+
+        void parseStringParamId() {
+            ParamId paramId(stringParamIdString);
+        }
+
+        void stringParamIdToString() {
+            stringParamId.toString();
+        }
+    private:
+        IODataProviderNamespace::NodeId numericNodeId;
+        std::string stringId;
+        IODataProviderNamespace::NodeId stringNodeId;
+        UaNodeId numericUaNodeId;
+        UaNodeId stringUaNodeId;
+        UaString numericXml;
+        UaString stringXml;
+        ParamId numericParamId;
+        ParamId stringParamId;
+        std::string numericParamIdString;
+        std::string stringParamIdString;
+    };
+
+    BenchmarkGroup* createNodeIdBenchmarks() {
+        return new NodeIdBenchmarks();
+    }
+} // namespace BenchmarkNamespace
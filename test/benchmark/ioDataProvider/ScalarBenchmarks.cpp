@@ -0,0 +1,71 @@
+#include "../Benchmark.h"
+#include <ioDataProvider/Scalar.h>
+#include <string>
+
+namespace BenchmarkNamespace {
+
+    // Construction and copying of IO data provider scalars with values which are stored
+    // inline (numeric values, short strings) and values which need own storage.
+    class ScalarBenchmarks : public BenchmarkGroup {
+    public:
+        typedef MethodBenchmark<ScalarBenchmarks> Method;
+
+        ScalarBenchmarks() : shortString("temperature"),
+        longString("a string which does not fit into the inline storage"),
+        bytes(64, 'x') {
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new Method("Scalar/copy/double", *this,
+                    &ScalarBenchmarks::copyDouble));
+            benchmarks.push_back(new Method("Scalar/copy/shortString", *this,
+                    &ScalarBenchmarks::copyShortString));
+            benchmarks.push_back(new Method("Scalar/copy/longString", *this,
+                    &ScalarBenchmarks::copyLongString));
+            benchmarks.push_back(new Method("Scalar/get/string", *this,
+                    &ScalarBenchmarks::getString));
+            benchmarks.push_back(new Method("Scalar/attach/byteString", *this,
+                    &ScalarBenchmarks::attachByteString));
+        }
+
+        void copyDouble() {
+            IODataProviderNamespace::Scalar scalar;
+            scalar.setDouble(1.5);
+            IODataProviderNamespace::Scalar copy(scalar);
+        }
+
+        void copyShortString() {
+            IODataProviderNamespace::Scalar scalar;
+            scalar.setString(&shortString);
+            IODataProviderNamespace::Scalar copy(scalar);
+        }
+
+        void copyLongString() {
+            IODataProviderNamespace::Scalar scalar;
+            scalar.setString(&longString);
+            IODataProviderNamespace::Scalar copy(scalar);
+        }
+
+        void getString() {
+            IODataProviderNamespace::Scalar scalar;
+            scalar.setString(&longString);
+            scalar.getString();
+            scalar.getString();
+        }
+
+        void attachByteString() {
+            char* value = new char[bytes.size()];
+            bytes.copy(value, bytes.size());
+            IODataProviderNamespace::Scalar scalar;
+            scalar.setByteString(value, bytes.size(), true /* attachValue */);
+        }
+    private:
+        std::string shortString;
+        std::string longString;
+        std::string bytes;
+    };
+
+    BenchmarkGroup* createScalarBenchmarks() {
+        return new ScalarBenchmarks();
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "BenchmarkRunner.h"
+#include <common/Exception.h>
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <config.h> // SERVER_VERSION
+#include <fstream>
+#include <iostream>
+#include <stdlib.h> // atol
+#include <string.h> // strncmp
+#include <string>
+#include <vector>
+
+using namespace BenchmarkNamespace;
+using namespace CommonNamespace;
+
+// Usage: ServerBenchmark [--filter=<substring>] [--format=json|csv] [--minTime=<ms>]
+//                        [--output=<file>] [--list]
+// The results are written to stdout if no output file is specified. The progress is written
+// to stderr.
+
+static const char* getOption(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    return strncmp(arg, name, length) == 0 ? arg + length : NULL;
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    BenchmarkRunner::Format format = BenchmarkRunner::JSON;
+    long minTime = 200;
+    std::string outputFile;
+    bool list = false;
+    for (int i = 1; i < argc; i++) {
+        const char* value;
+        if ((value = getOption(argv[i], "--filter=")) != NULL) {
+            filter = value;
+        } else if ((value = getOption(argv[i], "--format=")) != NULL) {
+            format = strcmp(value, "csv") == 0 ? BenchmarkRunner::CSV : BenchmarkRunner::JSON;
+        } else if ((value = getOption(argv[i], "--minTime=")) != NULL) {
+            minTime = atol(value);
+        } else if ((value = getOption(argv[i], "--output=")) != NULL) {
+            outputFile = value;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter=<substring>] [--format=json|csv]"
+                    << " [--minTime=<ms>] [--output=<file>] [--list]" << std::endl;
+            return 1;
+        }
+    }
+
+    ConsoleLoggerFactory clf;
+    LoggerFactory lf(clf);
+    std::vector<BenchmarkGroup*> groups;
+    groups.push_back(createLogThrottleBenchmarks());
+    groups.push_back(createNodeIdBenchmarks());
+    groups.push_back(createNodeDataBenchmarks());
+    groups.push_back(createScalarBenchmarks());
+    groups.push_back(createConverterUa2IOBenchmarks());
+    groups.push_back(createConverterBin2IOBenchmarks());
+    groups.push_back(createCachedConverterCallbackBenchmarks());
+    groups.push_back(createEventTypeRegistryBenchmarks());
+    groups.push_back(createNodeBrowserBenchmarks());
+    std::vector<Benchmark*> benchmarks;
+    for (size_t i = 0; i < groups.size(); i++) {
+        groups[i]->createBenchmarks(benchmarks);
+    }
+
+    int ret = 0;
+    BenchmarkRunner runner(minTime);
+    std::vector<BenchmarkRunner::Result> results;
+    for (size_t i = 0; i < benchmarks.size(); i++) {
+        Benchmark& benchmark = *benchmarks[i];
+        if (benchmark.getName().find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list) {
+            std::cout << benchmark.getName() << std::endl;
+            continue;
+        }
+        std::cerr << benchmark.getName() << std::endl;
+        try {
+            results.push_back(runner.run(benchmark));
+        } catch (Exception& e) {
+            std::string st;
+            e.getStackTrace(st);
+            std::cerr << "Benchmark " << benchmark.getName() << " failed: " << st << std::endl;
+            ret = 1;
+        }
+    }
+    if (!list) {
+        if (outputFile.empty()) {
+            BenchmarkRunner::write(std::cout, SERVER_VERSION, results, format);
+        } else {
+            std::ofstream out(outputFile.c_str());
+            BenchmarkRunner::write(out, SERVER_VERSION, results, format);
+        }
+    }
+
+    for (size_t i = 0; i < benchmarks.size(); i++) {
+        delete benchmarks[i];
+    }
+    for (size_t i = 0; i < groups.size(); i++) {
+        delete groups[i];
+    }
+    return ret;
+}
@@ -0,0 +1,203 @@
+#include "../../../Benchmark.h"
+#include "../../../../../src/provider/binary/messages/ConverterBin2IO.h"
+#include "../../../../../src/provider/binary/messages/dto/Array.h"
+#include "../../../../../src/provider/binary/messages/dto/ParamId.h"
+#include "../../../../../src/provider/binary/messages/dto/Scalar.h"
+#include "../../../../../src/provider/binary/messages/dto/Struct.h"
+#include <common/ArenaScope.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Variant.h>
+#include <map>
+#include <sstream> // std::ostringstream
+#include <string>
+#include <vector>
+
+namespace BenchmarkNamespace {
+
+    // Conversions of ConverterBin2IO in both directions for the scalar types, strings,
+    // arrays and nested structures of the binary provider.
+    class ConverterBin2IOBenchmarks : public BenchmarkGroup {
+    public:
+
+        // binary Variant -> Variant
+        class Bin2IOBenchmark : public Benchmark {
+        public:
+
+            // The responsibility for destroying the value is delegated to the instance.
+            Bin2IOBenchmark(const std::string& name, ConverterBin2IO& converter,
+                    ::Variant* value) : Benchmark(name) {
+                this->converter = &converter;
+                this->value = value;
+            }
+
+            virtual ~Bin2IOBenchmark() {
+                delete value;
+            }
+
+            virtual void run() {
+                delete converter->convertBin2io(*value, 2 /* destNamespaceIndex */);
+            }
+        private:
+            ConverterBin2IO* converter;
+            ::Variant* value;
+        };
+
+        // Variant -> binary Variant
+        // The binary values can be allocated from the arena of the thread like the requests of
+        // JDataProvider do. The allocations per operation show the heap allocations which
+        // remain with the arena (the containers and strings of the binary values).
+        class IO2BinBenchmark : public Benchmark {
+        public:
+
+            // The value is created from the binary value with the converter.
+            IO2BinBenchmark(const std::string& name, ConverterBin2IO& converter,
+                    const ::Variant& value, bool useArena) : Benchmark(name) {
+                this->converter = &converter;
+                this->value = converter.convertBin2io(value, 2 /* destNamespaceIndex */);
+                this->useArena = useArena;
+            }
+
+            virtual ~IO2BinBenchmark() {
+                delete value;
+            }
+
+            virtual void run() {
+                if (useArena) {
+                    CommonNamespace::ArenaScope arenaScope;
+                    delete converter->convertIo2bin(*value);
+                } else {
+                    delete converter->convertIo2bin(*value);
+                }
+            }
+        private:
+            ConverterBin2IO* converter;
+            IODataProviderNamespace::Variant* value;
+            bool useArena;
+        };
+
+        ConverterBin2IOBenchmarks() : numericParamId(2 /*nsIndex*/, 4711),
+        stringParamId(2 /*nsIndex*/, std::string("rfid.reader.scanData")),
+        stringNodeId(2 /*nsIndex*/, std::string("rfid.reader.scanData")) {
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            Scalar* value = new Scalar();
+            value->setBoolean(true);
+            add(benchmarks, "Boolean", value);
+            value = new Scalar();
+            value->setShort(-2);
+            add(benchmarks, "Short", value);
+            value = new Scalar();
+            value->setInt(-3);
+            add(benchmarks, "Int", value);
+            value = new Scalar();
+            value->setLong(-4);
+            add(benchmarks, "Long", value);
+            value = new Scalar();
+            value->setDouble(6.6);
+            add(benchmarks, "Double", value);
+            add(benchmarks, "String", createString("urn:epc:id:sgtin:0614141.812345.6789"));
+
+            int lengths[] = {1, 100, 10000};
+            for (int i = 0; i < 3; i++) {
+                int length = lengths[i];
+                std::vector<const ::Variant*>* elements = new std::vector<const ::Variant*>();
+                for (int j = 0; j < length; j++) {
+                    Scalar* element = new Scalar();
+                    element->setInt(j);
+                    elements->push_back(element);
+                }
+                std::ostringstream name;
+                name << "Int[" << length << "]";
+                add(benchmarks, name.str(),
+                        new Array(Scalar::INT, *elements, true /* attachValues */));
+            }
+
+            add(benchmarks, "Struct", createScanResult(5 /* sightingCount */));
+
+            benchmarks.push_back(new MethodBenchmark<ConverterBin2IOBenchmarks>(
+                    "ConverterBin2IO/bin2io/ParamId/numeric", *this,
+                    &ConverterBin2IOBenchmarks::convertNumericParamId));
+            benchmarks.push_back(new MethodBenchmark<ConverterBin2IOBenchmarks>(
+                    "ConverterBin2IO/bin2io/ParamId/string", *this,
+                    &ConverterBin2IOBenchmarks::convertStringParamId));
+            benchmarks.push_back(new MethodBenchmark<ConverterBin2IOBenchmarks>(
+                    "ConverterBin2IO/io2bin/NodeId/string", *this,
+                    &ConverterBin2IOBenchmarks::convertStringNodeId));
+        }
+
+        void convertNumericParamId() {
+            delete converter.convertBin2io(numericParamId, 2 /* destNamespaceIndex */);
+        }
+
+        void convertStringParamId() {
+            delete converter.convertBin2io(stringParamId, 2 /* destNamespaceIndex */);
+        }
+
+        void convertStringNodeId() {
+            delete converter.convertIo2bin(stringNodeId);
+        }
+    private:
+        ConverterBin2IO converter;
+        ParamId numericParamId;
+        ParamId stringParamId;
+        IODataProviderNamespace::NodeId stringNodeId;
+
+        // The responsibility for destroying the value is delegated to the created benchmarks.
+        void add(std::vector<Benchmark*>& benchmarks, const std::string& name,
+                ::Variant* value) {
+            benchmarks.push_back(new IO2BinBenchmark("ConverterBin2IO/io2bin/" + name, converter,
+                    *value, false /* useArena */));
+            benchmarks.push_back(new IO2BinBenchmark("ConverterBin2IO/io2bin/" + name + "/arena",
+                    converter, *value, true /* useArena */));
+            benchmarks.push_back(new Bin2IOBenchmark("ConverterBin2IO/bin2io/" + name, converter,
+                    value));
+        }
+
+        // Creates a string (array of chars).
+        Array* createString(const std::string& str) {
+            std::vector<const ::Variant*>* elements = new std::vector<const ::Variant*>();
+            for (size_t i = 0; i < str.size(); i++) {
+                Scalar* element = new Scalar();
+                element->setChar(str[i]);
+                elements->push_back(element);
+            }
+            return new Array(Scalar::CHAR, *elements, true /* attachValues */);
+        }
+
+        Scalar* createInt(long value) {
+            Scalar* ret = new Scalar();
+            ret->setInt(value);
+            return ret;
+        }
+
+        // Creates a RFID scan result of the AutoID model (see ConverterUa2IOBenchmarks).
+        Struct* createScanResult(int sightingCount) {
+            std::map<std::string, const ::Variant*>* scanDataFields =
+                    new std::map<std::string, const ::Variant*>();
+            (*scanDataFields)["String"] = createString("urn:epc:id:sgtin:0614141.812345.6789");
+            std::vector<const ::Variant*>* sightings = new std::vector<const ::Variant*>();
+            for (int i = 0; i < sightingCount; i++) {
+                std::map<std::string, const ::Variant*>* sightingFields =
+                        new std::map<std::string, const ::Variant*>();
+                (*sightingFields)["Antenna"] = createInt(i);
+                (*sightingFields)["Strength"] = createInt(-60);
+                (*sightingFields)["CurrentPowerLevel"] = createInt(27);
+                sightings->push_back(new Struct(*new ParamId(2 /*nsIndex*/, 15), *sightingFields,
+                        true /* attachValues */));
+            }
+            std::map<std::string, const ::Variant*>* fields =
+                    new std::map<std::string, const ::Variant*>();
+            (*fields)["CodeType"] = createString("EPC");
+            (*fields)["ScanData"] = new Struct(*new ParamId(2 /*nsIndex*/, 13), *scanDataFields,
+                    true /* attachValues */);
+            (*fields)["Sighting"] = new Array(::Variant::STRUCT, *sightings,
+                    true /* attachValues */);
+            return new Struct(*new ParamId(2 /*nsIndex*/, 17), *fields, true /* attachValues */);
+        }
+    };
+
+    BenchmarkGroup* createConverterBin2IOBenchmarks() {
+        return new ConverterBin2IOBenchmarks();
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,369 @@
+#include "../../Benchmark.h"
+#include <common/ScopeGuard.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Variant.h>
+#include <sasModelProvider/base/ConverterUa2IO.h>
+#include <opcua_builtintypes.h> // OpcUaType_Int16
+#include <uaarraytemplates.h> // UaDoubleArray
+#include <uabytestring.h> // UaByteString
+#include <uadatetime.h> // UaDateTime
+#include <uaextensionobject.h> // UaExtensionObject
+#include <uagenericunionvalue.h> // UaGenericUnionValue
+#include <ualocalizedtext.h> // UaLocalizedText
+#include <uanodeid.h> // UaNodeId
+#include <uastring.h> // UaString
+#include <uastructuredefinition.h> // UaStructureDefinition
+#include <uavariant.h> // UaVariant
+#include <map>
+#include <sstream> // std::ostringstream
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // Conversions of ConverterUa2IO in both directions for the built-in types, arrays and the
+    // nested structures of the AutoID model.
+    class ConverterUa2IOBenchmarks : public BenchmarkGroup {
+    public:
+
+        // Provides the structure definitions and super types of the fixture data types.
+        class ConverterCallback : public ConverterUa2IO::ConverterCallback {
+        public:
+
+            void addStructureDefinition(const UaStructureDefinition& structureDefinition,
+                    const UaNodeId& superType) {
+                structureDefinitions[structureDefinition.dataTypeId()] = structureDefinition;
+                addSuperType(structureDefinition.dataTypeId(), superType);
+            }
+
+            void addSuperType(const UaNodeId& dataTypeId, const UaNodeId& superType) {
+                superTypes[dataTypeId].push_back(superType);
+            }
+
+            // interface ConverterUa2IO::ConverterCallback
+
+            virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId) {
+                std::map<UaNodeId, UaStructureDefinition>::const_iterator it =
+                        structureDefinitions.find(dataTypeId);
+                return it == structureDefinitions.end() ? UaStructureDefinition() : it->second;
+            }
+
+            virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& dataTypeId) {
+                std::map<UaNodeId, std::vector<UaNodeId> >::const_iterator it =
+                        superTypes.find(dataTypeId);
+                return it == superTypes.end() ? new std::vector<UaNodeId>()
+                        : new std::vector<UaNodeId>(it->second);
+            }
+        private:
+            std::map<UaNodeId, UaStructureDefinition> structureDefinitions;
+            std::map<UaNodeId, std::vector<UaNodeId> > superTypes;
+        };
+
+        // UaVariant -> Variant
+        class Ua2IOBenchmark : public Benchmark {
+        public:
+
+            Ua2IOBenchmark(const std::string& name, ConverterUa2IO& converter,
+                    const UaVariant& value, const UaNodeId& dataTypeId)
+            : Benchmark(name), value(value), dataTypeId(dataTypeId) {
+                this->converter = &converter;
+            }
+
+            virtual void run() {
+                delete converter->convertUa2io(value, dataTypeId);
+            }
+        private:
+            ConverterUa2IO* converter;
+            UaVariant value;
+            UaNodeId dataTypeId;
+        };
+
+        // Variant -> UaVariant
+        class IO2UaBenchmark : public Benchmark {
+        public:
+
+            // The value is created from the UaVariant with the converter.
+            IO2UaBenchmark(const std::string& name, ConverterUa2IO& converter,
+                    const UaVariant& value, const UaNodeId& dataTypeId)
+            : Benchmark(name), dataTypeId(dataTypeId) {
+                this->converter = &converter;
+                this->value = converter.convertUa2io(value, dataTypeId);
+            }
+
+            virtual ~IO2UaBenchmark() {
+                delete value;
+            }
+
+            virtual void run() {
+                delete converter->convertIo2ua(*value, dataTypeId);
+            }
+        private:
+            ConverterUa2IO* converter;
+            IODataProviderNamespace::Variant* value;
+            UaNodeId dataTypeId;
+        };
+
+        ConverterUa2IOBenchmarks() : converter(callback) {
+            createAutoIdTypes();
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            UaVariant v;
+            v.setBool(true);
+            add(benchmarks, "Boolean", v, UaNodeId(OpcUaType_Boolean));
+            v.setSByte(-1);
+            add(benchmarks, "SByte", v, UaNodeId(OpcUaType_SByte));
+            v.setByte(1);
+            add(benchmarks, "Byte", v, UaNodeId(OpcUaType_Byte));
+            v.setInt16(-2);
+            add(benchmarks, "Int16", v, UaNodeId(OpcUaType_Int16));
+            v.setUInt16(2);
+            add(benchmarks, "UInt16", v, UaNodeId(OpcUaType_UInt16));
+            v.setInt32(-3);
+            add(benchmarks, "Int32", v, UaNodeId(OpcUaType_Int32));
+            add(benchmarks, "Enumeration", v, enumDataTypeId);
+            v.setUInt32(3);
+            add(benchmarks, "UInt32", v, UaNodeId(OpcUaType_UInt32));
+            v.setInt64(-4);
+            add(benchmarks, "Int64", v, UaNodeId(OpcUaType_Int64));
+            v.setUInt64(4);
+            add(benchmarks, "UInt64", v, UaNodeId(OpcUaType_UInt64));
+            v.setFloat(5.5);
+            add(benchmarks, "Float", v, UaNodeId(OpcUaType_Float));
+            v.setDouble(6.6);
+            add(benchmarks, "Double", v, UaNodeId(OpcUaType_Double));
+            v.setDateTime(UaDateTime::fromString(UaString("2012-05-30T09:30:10Z")));
+            add(benchmarks, "DateTime", v, UaNodeId(OpcUaType_DateTime));
+            v.setString(UaString("EPC"));
+            add(benchmarks, "String", v, UaNodeId(OpcUaType_String));
+            v.setString(UaString("urn:epc:id:sgtin:0614141.812345.6789-long-identifier"));
+            add(benchmarks, "String/long", v, UaNodeId(OpcUaType_String));
+            OpcUa_Byte bytes[12] = {0x30, 0x14, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0,
+                0x12, 0x34};
+            UaByteString byteString(sizeof (bytes), bytes);
+            v.setByteString(byteString, false /* detach */);
+            add(benchmarks, "ByteString", v, UaNodeId(OpcUaType_ByteString));
+            v.setLocalizedText(UaLocalizedText(UaString("en"), UaString("antenna")));
+            add(benchmarks, "LocalizedText", v, UaNodeId(OpcUaType_LocalizedText));
+
+            int lengths[] = {1, 100, 10000};
+            for (int i = 0; i < 3; i++) {
+                int length = lengths[i];
+                std::ostringstream suffix;
+                suffix << "[" << length << "]";
+                UaDoubleArray doubleArray;
+                doubleArray.create(length);
+                UaInt32Array int32Array;
+                int32Array.create(length);
+                UaStringArray stringArray;
+                stringArray.create(length);
+                for (int j = 0; j < length; j++) {
+                    doubleArray[j] = j * 0.5;
+                    int32Array[j] = j;
+                    std::ostringstream str;
+                    str << "value" << j;
+                    UaString(str.str().c_str()).copyTo(&stringArray[j]);
+                }
+                v.setDoubleArray(doubleArray);
+                add(benchmarks, "Double" + suffix.str(), v, UaNodeId(OpcUaType_Double));
+                v.setInt32Array(int32Array);
+                add(benchmarks, "Int32" + suffix.str(), v, UaNodeId(OpcUaType_Int32));
+                v.setStringArray(stringArray);
+                add(benchmarks, "String" + suffix.str(), v, UaNodeId(OpcUaType_String));
+            }
+
+            add(benchmarks, "RfidScanResult", createScanResult(5 /* sightingCount */),
+                    scanResult.dataTypeId());
+            UaExtensionObjectArray scanResults;
+            scanResults.create(100);
+            for (int i = 0; i < 100; i++) {
+                UaExtensionObject eo;
+                createScanResult(1 /* sightingCount */).toExtensionObject(eo);
+                eo.copyTo(&scanResults[i]);
+            }
+            v.setExtensionObjectArray(scanResults);
+            add(benchmarks, "RfidScanResult[100]", v, scanResult.dataTypeId());
+
+            benchmarks.push_back(new MethodBenchmark<ConverterUa2IOBenchmarks>(
+                    "ConverterUa2IO/ua2io/NodeId", *this,
+                    &ConverterUa2IOBenchmarks::convertUaNodeId));
+            benchmarks.push_back(new MethodBenchmark<ConverterUa2IOBenchmarks>(
+                    "ConverterUa2IO/io2ua/NodeId", *this,
+                    &ConverterUa2IOBenchmarks::convertNodeId));
+        }
+
+        void convertUaNodeId() {
+            delete converter.convertUa2io(UaNodeId(UaString("rfid.reader.scanData"), 2));
+        }
+
+        void convertNodeId() {
+            IODataProviderNamespace::NodeId nodeId(2 /* nsIndex */,
+                    std::string("rfid.reader.scanData"));
+            delete converter.convertIo2ua(nodeId);
+        }
+    private:
+        ConverterCallback callback;
+        ConverterUa2IO converter;
+        UaNodeId enumDataTypeId;
+        UaStructureDefinition scanDataEpc;
+        UaStructureDefinition scanData;
+        UaStructureDefinition sighting;
+        UaStructureDefinition scanResult;
+
+        void add(std::vector<Benchmark*>& benchmarks, const std::string& name,
+                const UaVariant& value, const UaNodeId& dataTypeId) {
+            benchmarks.push_back(new Ua2IOBenchmark("ConverterUa2IO/ua2io/" + name, converter,
+                    value, dataTypeId));
+            benchmarks.push_back(new IO2UaBenchmark("ConverterUa2IO/io2ua/" + name, converter,
+                    value, dataTypeId));
+        }
+
+        // Creates the data types of the AutoID model which are used for RFID scan results
+        // (with the node identifiers of the benchmark).
+        void createAutoIdTypes() {
+            int nsIndex = 2;
+            enumDataTypeId = UaNodeId(10, nsIndex);
+            callback.addSuperType(enumDataTypeId, UaNodeId(OpcUaId_Enumeration));
+
+            UaStructureField field;
+            field.setArrayType(UaStructureField::ArrayType_Scalar);
+
+            // ScanDataEpc: structure
+            scanDataEpc.setName("ScanDataEpc");
+            scanDataEpc.setDataTypeId(UaNodeId(11, nsIndex));
+            scanDataEpc.setBinaryEncodingId(UaNodeId(12, nsIndex));
+            field.setName("PC");
+            field.setDataTypeId(OpcUaId_UInt16);
+            scanDataEpc.addChild(field);
+            field.setName("UId");
+            field.setDataTypeId(OpcUaId_ByteString);
+            scanDataEpc.addChild(field);
+            field.setName("XPC_W1");
+            field.setDataTypeId(OpcUaId_UInt16);
+            scanDataEpc.addChild(field);
+            field.setName("XPC_W2");
+            scanDataEpc.addChild(field);
+            callback.addStructureDefinition(scanDataEpc, UaNodeId(OpcUaId_Structure));
+
+            // ScanData: union
+            scanData.setName("ScanData");
+            scanData.setDataTypeId(UaNodeId(13, nsIndex));
+            scanData.setBinaryEncodingId(UaNodeId(14, nsIndex));
+            scanData.setUnion(true);
+            field.setName("ByteString");
+            field.setDataTypeId(OpcUaId_ByteString);
+            scanData.addChild(field);
+            field.setName("String");
+            field.setDataTypeId(OpcUaId_String);
+            scanData.addChild(field);
+            field.setName("Epc");
+            field.setStructureDefinition(scanDataEpc);
+            scanData.addChild(field);
+            callback.addStructureDefinition(scanData, UaNodeId(OpcUaId_Union));
+
+            // RfidSighting: structure
+            sighting.setName("RfidSighting");
+            sighting.setDataTypeId(UaNodeId(15, nsIndex));
+            sighting.setBinaryEncodingId(UaNodeId(16, nsIndex));
+            UaStructureField sightingField;
+            sightingField.setArrayType(UaStructureField::ArrayType_Scalar);
+            sightingField.setName("Antenna");
+            sightingField.setDataTypeId(OpcUaId_Int32);
+            sighting.addChild(sightingField);
+            sightingField.setName("Strength");
+            sighting.addChild(sightingField);
+            sightingField.setName("Timestamp");
+            sightingField.setDataTypeId(OpcUaId_DateTime);
+            sighting.addChild(sightingField);
+            sightingField.setName("CurrentPowerLevel");
+            sightingField.setDataTypeId(OpcUaId_Int32);
+            sighting.addChild(sightingField);
+            callback.addStructureDefinition(sighting, UaNodeId(OpcUaId_Structure));
+
+            // RfidScanResult: structure with a nested union and an array of structures
+            scanResult.setName("RfidScanResult");
+            scanResult.setDataTypeId(UaNodeId(17, nsIndex));
+            scanResult.setBinaryEncodingId(UaNodeId(18, nsIndex));
+            UaStructureField scanResultField;
+            scanResultField.setArrayType(UaStructureField::ArrayType_Scalar);
+            scanResultField.setName("CodeType");
+            scanResultField.setDataTypeId(OpcUaId_String);
+            scanResult.addChild(scanResultField);
+            scanResultField.setName("ScanData");
+            scanResultField.setStructureDefinition(scanData);
+            scanResult.addChild(scanResultField);
+            UaStructureField timestampField;
+            timestampField.setArrayType(UaStructureField::ArrayType_Scalar);
+            timestampField.setName("Timestamp");
+            timestampField.setDataTypeId(OpcUaId_DateTime);
+            scanResult.addChild(timestampField);
+            UaStructureField sightingsField;
+            sightingsField.setName("Sighting");
+            sightingsField.setStructureDefinition(sighting);
+            sightingsField.setArrayType(UaStructureField::ArrayType_Array);
+            scanResult.addChild(sightingsField);
+            callback.addStructureDefinition(scanResult, UaNodeId(OpcUaId_Structure));
+        }
+
+        UaVariant createScanResult(int sightingCount) {
+            UaDateTime timestamp(UaDateTime::fromString(UaString("2012-05-30T09:30:10Z")));
+            // ScanData with an EPC
+            UaGenericStructureValue epcSv(scanDataEpc);
+            epcSv.setField(UaString("PC"), UaVariant(static_cast<OpcUa_UInt16> (0x3000)));
+            OpcUa_Byte uid[12] = {0x30, 0x14, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0,
+                0x12, 0x34};
+            UaVariant uidValue;
+            UaByteString uidByteString(sizeof (uid), uid);
+            uidValue.setByteString(uidByteString, false /* detach */);
+            epcSv.setField(UaString("UId"), uidValue);
+            epcSv.setField(UaString("XPC_W1"), UaVariant(static_cast<OpcUa_UInt16> (0)));
+            epcSv.setField(UaString("XPC_W2"), UaVariant(static_cast<OpcUa_UInt16> (0)));
+            UaExtensionObject epcEo;
+            epcSv.toExtensionObject(epcEo);
+            UaVariant tmp;
+            tmp.setExtensionObject(epcEo, OpcUa_False /* detach */);
+            UaGenericUnionValue scanDataUv(scanData);
+            scanDataUv.setValue(UaString("Epc"), tmp);
+            UaExtensionObject scanDataEo;
+            scanDataUv.toExtensionObject(scanDataEo);
+            // sightings
+            UaExtensionObjectArray sightings;
+            sightings.create(sightingCount);
+            for (int i = 0; i < sightingCount; i++) {
+                UaGenericStructureValue sightingSv(sighting);
+                sightingSv.setField(UaString("Antenna"), UaVariant(static_cast<OpcUa_Int32> (i)));
+                sightingSv.setField(UaString("Strength"),
+                        UaVariant(static_cast<OpcUa_Int32> (-60)));
+                UaVariant timestampValue;
+                timestampValue.setDateTime(timestamp);
+                sightingSv.setField(UaString("Timestamp"), timestampValue);
+                sightingSv.setField(UaString("CurrentPowerLevel"),
+                        UaVariant(static_cast<OpcUa_Int32> (27)));
+                UaExtensionObject sightingEo;
+                sightingSv.toExtensionObject(sightingEo);
+                sightingEo.copyTo(&sightings[i]);
+            }
+            // scan result
+            UaGenericStructureValue scanResultSv(scanResult);
+            scanResultSv.setField(UaString("CodeType"), UaVariant(UaString("EPC")));
+            tmp.setExtensionObject(scanDataEo, OpcUa_False /* detach */);
+            scanResultSv.setField(UaString("ScanData"), tmp);
+            tmp.setDateTime(timestamp);
+            scanResultSv.setField(UaString("Timestamp"), tmp);
+            tmp.setExtensionObjectArray(sightings);
+            scanResultSv.setField(UaString("Sighting"), tmp);
+            UaExtensionObject scanResultEo;
+            scanResultSv.toExtensionObject(scanResultEo);
+            UaVariant ret;
+            ret.setExtensionObject(scanResultEo, OpcUa_True /* detach */);
+            return ret;
+        }
+    };
+
+    BenchmarkGroup* createConverterUa2IOBenchmarks() {
+        return new ConverterUa2IOBenchmarks();
+    }
+} // namespace BenchmarkNamespace
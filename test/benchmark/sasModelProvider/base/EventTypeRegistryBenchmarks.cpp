@@ -0,0 +1,80 @@
+#include "../../Benchmark.h"
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <eventmanageruanode.h> // EventManagerUaNode
+#include <uanodeid.h> // UaNodeId
+#include <uaqualifiedname.h> // UaQualifiedName
+#include <uastring.h> // UaString
+#include <vector>
+
+using namespace SASModelProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // Lookups of EventTypeRegistry for an event type with 20 fields (half of them are
+    // inherited from the super type).
+    class EventTypeRegistryBenchmarks : public BenchmarkGroup {
+    public:
+
+        EventTypeRegistryBenchmarks() : superType("benchmarkSuperType", 2),
+        type("benchmarkType", 2), lastField(UaString("benchmark.f%1").arg(FIELD_COUNT - 1), 2) {
+            registry.registerEventType(superType, type);
+            for (int i = 0; i < FIELD_COUNT; i++) {
+                UaQualifiedName name(UaString("benchmark%1").arg(i), 2);
+                registry.registerEventField(i % 2 == 0 ? superType : type,
+                        UaNodeId(UaString("benchmark.f%1").arg(i), 2), name);
+                fieldIndices.push_back(EventManagerUaNode::registerEventField(name));
+            }
+            typeIndex = registry.getEventTypeIndex(type);
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new MethodBenchmark<EventTypeRegistryBenchmarks>(
+                    "EventTypeRegistry/getEventTypeIndex", *this,
+                    &EventTypeRegistryBenchmarks::getEventTypeIndex));
+            benchmarks.push_back(new MethodBenchmark<EventTypeRegistryBenchmarks>(
+                    "EventTypeRegistry/getEventFieldNodeId/index", *this,
+                    &EventTypeRegistryBenchmarks::getEventFieldNodeIdByIndex));
+            benchmarks.push_back(new MethodBenchmark<EventTypeRegistryBenchmarks>(
+                    "EventTypeRegistry/getEventFieldNodeId/nodeId", *this,
+                    &EventTypeRegistryBenchmarks::getEventFieldNodeIdByNodeId));
+            benchmarks.push_back(new MethodBenchmark<EventTypeRegistryBenchmarks>(
+                    "EventTypeRegistry/getEventFieldIndex", *this,
+                    &EventTypeRegistryBenchmarks::getEventFieldIndex));
+        }
+
+        void getEventTypeIndex() {
+            registry.getEventTypeIndex(type);
+        }
+
+        // all fields of an event
+        void getEventFieldNodeIdByIndex() {
+            for (int i = 0; i < FIELD_COUNT; i++) {
+                registry.getEventFieldNodeId(typeIndex, fieldIndices[i]);
+            }
+        }
+
+        // all fields of an event
+        void getEventFieldNodeIdByNodeId() {
+            for (int i = 0; i < FIELD_COUNT; i++) {
+                registry.getEventFieldNodeId(type, fieldIndices[i]);
+            }
+        }
+
+        void getEventFieldIndex() {
+            registry.getEventFieldIndex(typeIndex, lastField);
+        }
+    private:
+        static const int FIELD_COUNT = 20;
+
+        EventTypeRegistry registry;
+        UaNodeId superType;
+        UaNodeId type;
+        UaNodeId lastField;
+        std::vector<OpcUa_UInt32> fieldIndices;
+        int typeIndex;
+    };
+
+    BenchmarkGroup* createEventTypeRegistryBenchmarks() {
+        return new EventTypeRegistryBenchmarks();
+    }
+} // namespace BenchmarkNamespace
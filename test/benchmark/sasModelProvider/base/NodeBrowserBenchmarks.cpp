@@ -0,0 +1,161 @@
+#include "../../Benchmark.h"
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <sasModelProvider/base/HaNodeManager.h>
+#include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
+#include <sasModelProvider/base/NodeBrowser.h>
+#include <methodmanager.h> // MethodManagerCallback
+#include <nodemanagerbase.h> // NodeManagerBase
+#include <uabasenodes.h> // UaPropertyCache
+#include <uanodeid.h> // UaNodeId
+#include <uastring.h> // UaString
+#include <vector>
+
+using namespace SASModelProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // Resolution of variables via a node manager and via the variable cache of a node browser.
+    class NodeBrowserBenchmarks : public BenchmarkGroup {
+    public:
+        typedef MethodBenchmark<NodeBrowserBenchmarks> Method;
+
+        NodeBrowserBenchmarks() {
+            for (int i = 0; i < VARIABLE_COUNT; i++) {
+                UaNodeId nodeId(UaString("benchmark%1").arg(i),
+                        nodeManager.getNameSpaceIndex());
+                nodeManager.addVariable(nodeId);
+                nodeIds.push_back(nodeId);
+            }
+            nodeBrowser = new NodeBrowser(nodeManager);
+        }
+
+        virtual ~NodeBrowserBenchmarks() {
+            delete nodeBrowser;
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            benchmarks.push_back(new Method("NodeBrowser/getVariable/nodeManager", *this,
+                    &NodeBrowserBenchmarks::getNode));
+            benchmarks.push_back(new Method("NodeBrowser/getVariable/nodeBrowser", *this,
+                    &NodeBrowserBenchmarks::getVariable));
+        }
+
+        // all variables
+        void getNode() {
+            for (int i = 0; i < VARIABLE_COUNT; i++) {
+                nodeManager.getNode(nodeIds[i])->releaseReference();
+            }
+        }
+
+        // all variables
+        void getVariable() {
+            for (int i = 0; i < VARIABLE_COUNT; i++) {
+                nodeBrowser->getVariable(nodeIds[i])->releaseReference();
+            }
+        }
+    private:
+        static const int VARIABLE_COUNT = 1000;
+
+        // A node manager which is not started by a server.
+        // It is its own root node manager.
+        class HaNodeManagerImpl : public NodeManagerBase, public HaNodeManager {
+        public:
+            EventTypeRegistry eventTypeRegistry;
+            HaNodeManagerIODataProviderBridge* bridge;
+            UaString defaultLocaleId;
+
+            HaNodeManagerImpl() : NodeManagerBase("http://benchmark/NodeBrowser") {
+                bridge = NULL;
+            }
+
+            void addVariable(const UaNodeId& nodeId) {
+                UaPropertyCache* variable = new UaPropertyCache(nodeId.toString(), nodeId,
+                        UaVariant(), Ua_AccessLevel_CurrentRead, defaultLocaleId);
+                addUaNode(variable);
+            }
+
+            virtual UaStatus afterStartUp() {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus beforeShutDown() {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus readValues(const UaVariableArray &arrUaVariables,
+                    UaDataValueArray &arrDataValues) {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus writeValues(const UaVariableArray &arrUaVariables,
+                    const PDataValueArray &arrpDataValues,
+                    UaStatusCodeArray &arrStatusCodes) {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual OpcUa_Boolean beforeSetAttributeValue(Session* pSession, UaNode* pNode,
+                    OpcUa_Int32 attributeId, const UaDataValue& dataValue,
+                    OpcUa_Boolean& checkWriteMask) {
+                return OpcUa_True;
+            }
+
+            virtual void afterSetAttributeValue(Session* pSession, UaNode* pNode,
+                    OpcUa_Int32 attributeId, const UaDataValue& dataValue) {
+            }
+
+            virtual void variableCacheMonitoringChanged(UaVariableCache* pVariable,
+                    TransactionType transactionType) {
+            }
+
+            virtual UaStatus beginCall(MethodManagerCallback* pCallback,
+                    const ServiceContext& serviceContext, OpcUa_UInt32 callbackHandle,
+                    MethodHandle* pMethodHandle, const UaVariantArray& inputArguments) {
+                return UaStatus(OpcUa_BadNotImplemented);
+            }
+
+            virtual NodeManager& getNodeManagerRoot() {
+                return *this;
+            }
+
+            virtual NodeManagerBase& getNodeManagerBase() {
+                return *this;
+            }
+
+            virtual const std::vector<HaNodeManager*>* getAssociatedNodeManagers() {
+                return NULL;
+            }
+
+            virtual EventTypeRegistry& getEventTypeRegistry() {
+                return eventTypeRegistry;
+            }
+
+            virtual HaNodeManagerIODataProviderBridge& getIODataProviderBridge() {
+                // the bridge is not used by the node browser
+                return *bridge;
+            }
+
+            virtual UaString getNameSpaceUri() {
+                return NodeManagerBase::getNameSpaceUri();
+            }
+
+            virtual const UaString& getDefaultLocaleId() const {
+                return defaultLocaleId;
+            }
+
+            virtual void setVariable(UaVariable& variable, UaVariant& newValue) {
+            }
+
+            virtual void setVariables(const std::vector<UaVariable*>& variables,
+                    const std::vector<UaVariant*>& newValues) {
+            }
+        };
+
+        HaNodeManagerImpl nodeManager;
+        std::vector<UaNodeId> nodeIds;
+        NodeBrowser* nodeBrowser;
+    };
+
+    BenchmarkGroup* createNodeBrowserBenchmarks() {
+        return new NodeBrowserBenchmarks();
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,144 @@
+#include "BenchmarkModel.h"
+#include <uaarraytemplates.h> // UaUInt32Array
+#include <uabasenodes.h> // UaPropertyCache, UaPropertyMethodArgument, UaObjectTypeSimple
+#include <uagenericnodes.h> // UaMethodGeneric
+#include <ualocalizedtext.h> // UaLocalizedText
+#include <uastring.h> // UaString
+#include <uavariant.h> // UaVariant
+
+using namespace SASModelProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // Adds the fields of a map of BenchmarkDataProvider (see createMap) to a structure.
+    static void addSensorFields(UaStructureDefinition& structure) {
+        UaStructureField field;
+        field.setArrayType(UaStructureField::ArrayType_Scalar);
+        field.setName("temperature");
+        field.setDataTypeId(OpcUaId_Double);
+        structure.addChild(field);
+        field.setName("humidity");
+        field.setDataTypeId(OpcUaId_Float);
+        structure.addChild(field);
+        field.setName("active");
+        field.setDataTypeId(OpcUaId_Boolean);
+        structure.addChild(field);
+        field.setName("count");
+        field.setDataTypeId(OpcUaId_Int64);
+        structure.addChild(field);
+        field.setName("name");
+        field.setDataTypeId(OpcUaId_String);
+        structure.addChild(field);
+    }
+
+    BenchmarkTypes::BenchmarkTypes(int namespaceIndex) {
+        sensor.setName("Sensor");
+        sensor.setDataTypeId(UaNodeId(20, namespaceIndex));
+        sensor.setBinaryEncodingId(UaNodeId(21, namespaceIndex));
+        addSensorFields(sensor);
+        addStructureDefinition(sensor);
+
+        nested.setName("Nested");
+        nested.setDataTypeId(UaNodeId(22, namespaceIndex));
+        nested.setBinaryEncodingId(UaNodeId(23, namespaceIndex));
+        addSensorFields(nested);
+        UaStructureField field;
+        field.setArrayType(UaStructureField::ArrayType_Scalar);
+        field.setName("config");
+        field.setStructureDefinition(sensor);
+        nested.addChild(field);
+        field.setName("history");
+        field.setArrayType(UaStructureField::ArrayType_Array);
+        nested.addChild(field);
+        addStructureDefinition(nested);
+    }
+
+    const UaStructureDefinition& BenchmarkTypes::getSensor() const {
+        return sensor;
+    }
+
+    const UaStructureDefinition& BenchmarkTypes::getNested() const {
+        return nested;
+    }
+
+    UaStructureDefinition BenchmarkTypes::getStructureDefinition(const UaNodeId& dataTypeId) {
+        std::map<UaNodeId, UaStructureDefinition>::const_iterator it =
+                structureDefinitions.find(dataTypeId);
+        return it == structureDefinitions.end() ? UaStructureDefinition() : it->second;
+    }
+
+    std::vector<UaNodeId>* BenchmarkTypes::getSuperTypes(const UaNodeId& dataTypeId) {
+        std::vector<UaNodeId>* ret = new std::vector<UaNodeId>();
+        if (structureDefinitions.find(dataTypeId) != structureDefinitions.end()) {
+            ret->push_back(UaNodeId(OpcUaId_Structure));
+        }
+        return ret;
+    }
+
+    void BenchmarkTypes::addStructureDefinition(const UaStructureDefinition& structureDefinition) {
+        structureDefinitions[structureDefinition.dataTypeId()] = structureDefinition;
+    }
+
+    BenchmarkNodeManager::BenchmarkNodeManager(IODataProviderNamespace::IODataProvider& ioDataProvider) :
+    CodeNodeManagerBase("http://www.peramic.io/benchmark", ioDataProvider) {
+    }
+
+    void BenchmarkNodeManager::addNodes(const BenchmarkTypes& types) {
+        OpcUa_UInt16 namespaceIndex = getNameSpaceIndex();
+        const char* names[] = {"Scalar", "Array", "Map", "Nested"};
+        UaNodeId dataTypeIds[] = {UaNodeId(OpcUaId_Double), UaNodeId(OpcUaId_Int32),
+            types.getSensor().dataTypeId(), types.getNested().dataTypeId()};
+        for (int i = 0; i < 4; i++) {
+            UaNodeId nodeId(names[i], namespaceIndex);
+            UaPropertyCache* variable = new UaPropertyCache(names[i], nodeId, UaVariant(),
+                    Ua_AccessLevel_CurrentRead | Ua_AccessLevel_CurrentWrite,
+                    getDefaultLocaleId());
+            variable->setDataType(dataTypeIds[i]);
+            variable->setValueRank(i == 1 ? OpcUa_ValueRanks_OneDimension
+                    : OpcUa_ValueRanks_Scalar);
+            addUaNode(variable);
+        }
+
+        // the method returns its input arguments
+        UaMethodGeneric* method = new UaMethodGeneric("Echo", UaNodeId("Echo", namespaceIndex),
+                getDefaultLocaleId());
+        addUaNode(method);
+        UaPropertyMethodArgument* outputArguments = new UaPropertyMethodArgument(
+                UaNodeId("Echo.OutputArguments", namespaceIndex), Ua_AccessLevel_CurrentRead,
+                1 /* numberOfArguments */, UaPropertyMethodArgument::OUTARGUMENTS);
+        outputArguments->setArgument(0 /* index */, "value", UaNodeId(OpcUaId_BaseDataType),
+                OpcUa_ValueRanks_Any, UaUInt32Array(), UaLocalizedText("", "value"));
+        addNodeAndReference(method->nodeId(), outputArguments, OpcUaId_HasProperty);
+
+        // the fields of the events contain the values of the variables
+        UaObjectTypeSimple* eventType = new UaObjectTypeSimple("BenchmarkEventType",
+                UaNodeId("BenchmarkEventType", namespaceIndex), getDefaultLocaleId(),
+                OpcUa_False /* isAbstract */);
+        addUaNode(eventType);
+        UaPropertyCache* value = new UaPropertyCache("Value", UaNodeId("Value", namespaceIndex),
+                UaVariant(), Ua_AccessLevel_CurrentRead, getDefaultLocaleId());
+        value->setDataType(UaNodeId(OpcUaId_BaseDataType));
+        addNodeAndReference(eventType->nodeId(), value, OpcUaId_HasProperty);
+    }
+
+    NodeManager& BenchmarkNodeManager::getNodeManagerRoot() {
+        return *this;
+    }
+
+    BenchmarkNodeBrowser::BenchmarkNodeBrowser(HaNodeManager& nodeManager,
+            BenchmarkTypes& types) : NodeBrowser(nodeManager) {
+        this->types = &types;
+    }
+
+    UaStructureDefinition BenchmarkNodeBrowser::getStructureDefinition(const UaNodeId& dataTypeId) {
+        return types->getStructureDefinition(dataTypeId);
+    }
+
+    std::vector<UaNodeId>* BenchmarkNodeBrowser::getSuperTypes(const UaNodeId& typeId) {
+        return types->getSuperTypes(typeId);
+    }
+
+    UaNodeId BenchmarkNodeBrowser::getBuildInType(const UaNodeId& typeId) {
+        return types->getBuildInType(typeId);
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,70 @@
+#ifndef JNI_BENCHMARKMODEL_H
+#define JNI_BENCHMARKMODEL_H
+
+#include <ioDataProvider/IODataProvider.h>
+#include <sasModelProvider/base/CodeNodeManagerBase.h>
+#include <sasModelProvider/base/ConverterUa2IO.h>
+#include <sasModelProvider/base/NodeBrowser.h>
+#include <uanodeid.h> // UaNodeId
+#include <uastructuredefinition.h> // UaStructureDefinition
+#include <map>
+#include <vector>
+
+namespace BenchmarkNamespace {
+
+    // The data types of the values of the Java data provider BenchmarkDataProvider:
+    // Sensor: structure with the fields of a map (see createMap)
+    // Nested: the fields of a sensor with a nested sensor "config" and a list of sensors
+    //     "history"
+    // The super type of both structures is Structure.
+    class BenchmarkTypes : public SASModelProviderNamespace::ConverterUa2IO::ConverterCallback {
+    public:
+        BenchmarkTypes(int namespaceIndex);
+
+        virtual const UaStructureDefinition& getSensor() const;
+        virtual const UaStructureDefinition& getNested() const;
+
+        // interface ConverterUa2IO::ConverterCallback
+        virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId);
+        virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& dataTypeId);
+    private:
+        UaStructureDefinition sensor;
+        UaStructureDefinition nested;
+        std::map<UaNodeId, UaStructureDefinition> structureDefinitions;
+
+        void addStructureDefinition(const UaStructureDefinition& structureDefinition);
+    };
+
+    // The nodes of the Java data provider BenchmarkDataProvider:
+    // variables: Scalar (Double), Array (Int32[]), Map (Sensor), Nested (Nested)
+    // method: Echo with an output argument
+    // event type: BenchmarkEventType with property Value
+    // The node manager is not started by a server. It is its own root node manager.
+    class BenchmarkNodeManager : public SASModelProviderNamespace::CodeNodeManagerBase {
+    public:
+        BenchmarkNodeManager(IODataProviderNamespace::IODataProvider& ioDataProvider);
+
+        // Adds the nodes. The data types must have been created for the namespace index of
+        // the node manager.
+        virtual void addNodes(const BenchmarkTypes& types);
+
+        // interface HaNodeManager
+        virtual NodeManager& getNodeManagerRoot();
+    };
+
+    // A node browser for a node manager without a server: the nodes are provided by the
+    // node manager and the data types by BenchmarkTypes (the type hierarchy of a server is
+    // not available).
+    class BenchmarkNodeBrowser : public SASModelProviderNamespace::NodeBrowser {
+    public:
+        BenchmarkNodeBrowser(SASModelProviderNamespace::HaNodeManager& nodeManager,
+                BenchmarkTypes& types);
+
+        virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId);
+        virtual std::vector<UaNodeId>* getSuperTypes(const UaNodeId& typeId);
+        virtual UaNodeId getBuildInType(const UaNodeId& typeId);
+    private:
+        BenchmarkTypes* types;
+    };
+} // namespace BenchmarkNamespace
+#endif /* JNI_BENCHMARKMODEL_H */
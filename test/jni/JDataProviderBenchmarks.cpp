@@ -0,0 +1,367 @@
+#include "JDataProviderBenchmarks.h"
+#include "BenchmarkModel.h"
+#include "../../src/provider/binary/jDataProvider/JDataProvider.h"
+#include <common/Exception.h>
+#include <common/VectorScopeGuard.h>
+#include <ioDataProvider/Event.h>
+#include <ioDataProvider/MethodData.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/SubscriberCallback.h>
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    // the node ids of the values of the Java data provider
+    static const int VALUE_COUNT = 4;
+    static const char* VALUES[VALUE_COUNT] = {"Scalar", "Array", "Map", "Nested"};
+
+    // the provider which is used by the native methods of the Java data provider
+    static JDataProvider* nativeProvider = NULL;
+
+    // Throws an exception if a Java exception is pending. The Java exception is cleared.
+    static void checkException(JNIEnv& env, const std::string& msg) /* throws Exception */ {
+        if (env.ExceptionCheck()) {
+            env.ExceptionDescribe();
+            env.ExceptionClear();
+            throw ExceptionDef(Exception, msg);
+        }
+    }
+
+    static void JNICALL notification(JNIEnv* env, jobject obj, jint ns, jobject id,
+            jobject value) {
+        try {
+            nativeProvider->notification(env, ns, id, value);
+        } catch (Exception& e) {
+            std::string st;
+            e.getStackTrace(st);
+            env->ThrowNew(env->FindClass("java/lang/RuntimeException"), st.c_str());
+        }
+    }
+
+    static void JNICALL event(JNIEnv* env, jobject obj, jint eNs, jobject evt, jint pNs,
+            jobject param, jlong timestamp, jint severity, jstring msg, jobject value) {
+        try {
+            nativeProvider->event(env, eNs, evt, pNs, param, timestamp, severity, msg, value);
+        } catch (Exception& e) {
+            std::string st;
+            e.getStackTrace(st);
+            env->ThrowNew(env->FindClass("java/lang/RuntimeException"), st.c_str());
+        }
+    }
+
+    // Round trips of JDataProvider to the Java data provider BenchmarkDataProvider for a
+    // scalar, an array, a map and a nested structure (maps and a list of maps):
+    // read/write/call: native -> Java -> native (the thread is attached and detached per
+    // request like the threads of the server)
+    // notification/event: Java -> native (the Java data provider is triggered by the
+    // benchmark)
+    // The data types of the values are provided by a node browser for a node manager without
+    // a server (see BenchmarkModel).
+    class JDataProviderBenchmarks : public BenchmarkGroup {
+    public:
+
+        class Callback : public SubscriberCallback {
+        public:
+
+            Callback() {
+                valueChangeCount = 0;
+            }
+
+            virtual void valuesChanged(const Event& event) {
+                valueChangeCount++;
+            }
+
+            unsigned long valueChangeCount;
+        };
+
+        // Reads a node.
+        class ReadBenchmark : public Benchmark {
+        public:
+
+            ReadBenchmark(const std::string& name, JDataProvider& provider,
+                    const NodeId& nodeId) : Benchmark(name) {
+                this->provider = &provider;
+                nodeIds.push_back(&nodeId);
+            }
+
+            virtual void setUp() /* throws Exception */ {
+                VectorScopeGuard<NodeData> resultsSG(provider->read(nodeIds));
+                if ((*resultsSG.getObject())[0]->getData() == NULL) {
+                    throw ExceptionDef(Exception, std::string("Cannot read ")
+                            .append(nodeIds[0]->toString()));
+                }
+            }
+
+            virtual void run() {
+                VectorScopeGuard<NodeData> resultsSG(provider->read(nodeIds));
+            }
+        private:
+            JDataProvider* provider;
+            std::vector<const NodeId*> nodeIds;
+        };
+
+        // Writes the value of a node which is read before.
+        class WriteBenchmark : public Benchmark {
+        public:
+
+            WriteBenchmark(const std::string& name, JDataProvider& provider,
+                    const NodeId& nodeId) : Benchmark(name) {
+                this->provider = &provider;
+                this->nodeId = &nodeId;
+            }
+
+            virtual void setUp() /* throws Exception */ {
+                std::vector<const NodeId*> nodeIds;
+                nodeIds.push_back(nodeId);
+                VectorScopeGuard<NodeData> resultsSG(provider->read(nodeIds));
+                NodeData* value = (*resultsSG.getObject())[0];
+                if (value->getData() == NULL) {
+                    throw ExceptionDef(Exception, std::string("Cannot read ")
+                            .append(nodeId->toString()));
+                }
+                resultsSG.getObject()->clear();
+                nodeData.push_back(value);
+            }
+
+            virtual void tearDown() {
+                for (size_t i = 0; i < nodeData.size(); i++) {
+                    delete nodeData[i];
+                }
+                nodeData.clear();
+            }
+
+            virtual void run() {
+                provider->write(nodeData, false /* sendValueChangedEvents */);
+            }
+        private:
+            JDataProvider* provider;
+            const NodeId* nodeId;
+            std::vector<const NodeData*> nodeData;
+        };
+
+        // Calls a method with the value of a node which is read before. The method returns
+        // the value as output argument.
+        class CallBenchmark : public Benchmark {
+        public:
+
+            CallBenchmark(const std::string& name, JDataProvider& provider,
+                    const NodeId& nodeId) : Benchmark(name),
+            objectNodeId(nodeId.getNamespaceIndex(), std::string("Benchmark")),
+            methodNodeId(nodeId.getNamespaceIndex(), std::string("Echo")) {
+                this->provider = &provider;
+                this->nodeId = &nodeId;
+            }
+
+            virtual void setUp() /* throws Exception */ {
+                std::vector<const NodeId*> nodeIds;
+                nodeIds.push_back(nodeId);
+                VectorScopeGuard<NodeData> resultsSG(provider->read(nodeIds));
+                const NodeData& value = *(*resultsSG.getObject())[0];
+                if (value.getData() == NULL) {
+                    throw ExceptionDef(Exception, std::string("Cannot read ")
+                            .append(nodeId->toString()));
+                }
+                std::vector<const Variant*>* args = new std::vector<const Variant*>();
+                args->push_back(value.getData()->copy());
+                methodData.push_back(new MethodData(*new NodeId(objectNodeId),
+                        *new NodeId(methodNodeId), *args, true /* attachValues */));
+                VectorScopeGuard<MethodData> callResultsSG(provider->call(methodData));
+                const MethodData& result = *(*callResultsSG.getObject())[0];
+                if (result.getException() != NULL || result.getMethodArguments().size() != 1) {
+                    throw ExceptionDef(Exception, std::string("Cannot call a method with ")
+                            .append(nodeId->toString()));
+                }
+            }
+
+            virtual void tearDown() {
+                for (size_t i = 0; i < methodData.size(); i++) {
+                    delete methodData[i];
+                }
+                methodData.clear();
+            }
+
+            virtual void run() {
+                VectorScopeGuard<MethodData> resultsSG(provider->call(methodData));
+            }
+        private:
+            JDataProvider* provider;
+            const NodeId* nodeId;
+            NodeId objectNodeId;
+            NodeId methodNodeId;
+            std::vector<const MethodData*> methodData;
+        };
+
+        // Triggers a notification or an event in the Java data provider. The thread is
+        // attached to the JVM while the benchmark is executed.
+        class JavaBenchmark : public Benchmark {
+        public:
+
+            JavaBenchmark(const std::string& name, JavaVM& vm, jobject javaProvider,
+                    jmethodID method, int namespaceIndex, const std::string& id,
+                    Callback& callback) : Benchmark(name) {
+                this->vm = &vm;
+                this->namespaceIndex = namespaceIndex;
+                this->javaProvider = javaProvider;
+                this->method = method;
+                this->id = id;
+                this->callback = &callback;
+                env = NULL;
+                jId = NULL;
+            }
+
+            virtual void setUp() /* throws Exception */ {
+                if (vm->AttachCurrentThread(reinterpret_cast<void**> (&env), NULL) != JNI_OK) {
+                    env = NULL;
+                    throw ExceptionDef(Exception, "Cannot attach the thread to the JVM");
+                }
+                jId = env->NewStringUTF(id.c_str());
+                unsigned long valueChangeCount = callback->valueChangeCount;
+                run(); // Exception
+                if (callback->valueChangeCount == valueChangeCount) {
+                    throw ExceptionDef(Exception, std::string("No data received for ")
+                            .append(getName()));
+                }
+            }
+
+            virtual void tearDown() {
+                if (env != NULL) {
+                    env->DeleteLocalRef(jId);
+                    vm->DetachCurrentThread();
+                    env = NULL;
+                    jId = NULL;
+                }
+            }
+
+            virtual void run() /* throws Exception */ {
+                env->CallVoidMethod(javaProvider, method, namespaceIndex, jId);
+                checkException(*env, std::string("Execution of ").append(getName())
+                        .append(" failed")); // Exception
+            }
+        private:
+            JavaVM* vm;
+            jobject javaProvider;
+            jmethodID method;
+            int namespaceIndex;
+            std::string id;
+            Callback* callback;
+            JNIEnv* env;
+            jstring jId;
+        };
+
+        JDataProviderBenchmarks(JavaVM& vm) /* throws MutexException, Exception */ :
+        nodeManager(provider), types(nodeManager.getNameSpaceIndex()),
+        nodeBrowser(nodeManager, types) {
+            this->vm = &vm;
+            namespaceIndex = nodeManager.getNameSpaceIndex();
+            nodeManager.addNodes(types);
+            provider.setNodeBrowser(&nodeBrowser);
+            JNIEnv* env;
+            if (vm.GetEnv(reinterpret_cast<void**> (&env), JNI_VERSION_1_6) != JNI_OK) {
+                throw ExceptionDef(Exception, "The thread is not attached to the JVM");
+            }
+            jclass clazz = env->FindClass("havis/util/opcua/benchmark/BenchmarkDataProvider");
+            checkException(*env, "Cannot find the Java data provider"); // Exception
+            JNINativeMethod methods[] = {
+                {const_cast<char*> ("notification"),
+                    const_cast<char*> ("(ILjava/lang/Object;Ljava/lang/Object;)V"),
+                    reinterpret_cast<void*> (notification)},
+                {const_cast<char*> ("event"),
+                    const_cast<char*> ("(ILjava/lang/Object;ILjava/lang/Object;JILjava/lang/String;Ljava/lang/Object;)V"),
+                    reinterpret_cast<void*> (event)}
+            };
+            env->RegisterNatives(clazz, methods, 2);
+            checkException(*env, "Cannot register the native methods"); // Exception
+            jmethodID constructor = env->GetMethodID(clazz, "<init>", "(I)V");
+            fireNotification = env->GetMethodID(clazz, "fireNotification",
+                    "(ILjava/lang/String;)V");
+            fireEvent = env->GetMethodID(clazz, "fireEvent", "(ILjava/lang/String;)V");
+            checkException(*env, "Cannot get the methods of the Java data provider"); // Exception
+            jobject obj = env->NewObject(clazz, constructor, namespaceIndex);
+            checkException(*env, "Cannot create the Java data provider"); // Exception
+            javaProvider = env->NewGlobalRef(obj);
+            env->DeleteLocalRef(obj);
+            env->DeleteLocalRef(clazz);
+
+            provider.open(env, NULL /* properties */, javaProvider);
+            delete provider.getDefaultNodeProperties(
+                    nodeManager.getNameSpaceUri().toUtf8(), namespaceIndex);
+            nativeProvider = &provider;
+            vm.DetachCurrentThread();
+
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                nodeIds.push_back(new NodeId(namespaceIndex, std::string(VALUES[i])));
+            }
+            nodeIds.push_back(new NodeId(namespaceIndex, std::string("BenchmarkEventType")));
+            std::vector<const NodeId*> subscribedNodeIds(nodeIds.begin(), nodeIds.end());
+            VectorScopeGuard<NodeData> resultsSG(provider.subscribe(subscribedNodeIds,
+                    callback)); // IODataProviderException
+        }
+
+        virtual ~JDataProviderBenchmarks() {
+            std::vector<const NodeId*> subscribedNodeIds(nodeIds.begin(), nodeIds.end());
+            try {
+                provider.unsubscribe(subscribedNodeIds); // IODataProviderException
+            } catch (Exception& e) {
+                // ignore
+            }
+            JNIEnv* env;
+            if (vm->AttachCurrentThread(reinterpret_cast<void**> (&env), NULL) == JNI_OK) {
+                env->DeleteGlobalRef(javaProvider);
+                vm->DetachCurrentThread();
+            }
+            nativeProvider = NULL;
+            for (size_t i = 0; i < nodeIds.size(); i++) {
+                delete nodeIds[i];
+            }
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                std::string value(VALUES[i]);
+                benchmarks.push_back(new ReadBenchmark("JDataProvider/read/" + value,
+                        provider, *nodeIds[i]));
+            }
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                std::string value(VALUES[i]);
+                benchmarks.push_back(new WriteBenchmark("JDataProvider/write/" + value,
+                        provider, *nodeIds[i]));
+            }
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                std::string value(VALUES[i]);
+                benchmarks.push_back(new CallBenchmark("JDataProvider/call/" + value,
+                        provider, *nodeIds[i]));
+            }
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                std::string value(VALUES[i]);
+                benchmarks.push_back(new JavaBenchmark("JDataProvider/notification/" + value,
+                        *vm, javaProvider, fireNotification, namespaceIndex, value, callback));
+            }
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                std::string value(VALUES[i]);
+                benchmarks.push_back(new JavaBenchmark("JDataProvider/event/" + value,
+                        *vm, javaProvider, fireEvent, namespaceIndex, value, callback));
+            }
+        }
+    private:
+        JavaVM* vm;
+        JDataProvider provider;
+        BenchmarkNodeManager nodeManager;
+        BenchmarkTypes types;
+        BenchmarkNodeBrowser nodeBrowser;
+        int namespaceIndex;
+        jobject javaProvider;
+        jmethodID fireNotification;
+        jmethodID fireEvent;
+        Callback callback;
+        std::vector<NodeId*> nodeIds;
+    };
+
+    BenchmarkGroup* createJDataProviderBenchmarks(JavaVM& vm) /* throws Exception */ {
+        return new JDataProviderBenchmarks(vm);
+    }
+} // namespace BenchmarkNamespace
@@ -0,0 +1,16 @@
+#ifndef JNI_JDATAPROVIDERBENCHMARKS_H
+#define JNI_JDATAPROVIDERBENCHMARKS_H
+
+#include "../benchmark/Benchmark.h"
+#include <jni.h>
+
+namespace BenchmarkNamespace {
+
+    // Creates the benchmarks of the JNI data provider. The current thread must be attached to
+    // the JVM. It is detached before the function returns because the benchmarks are executed
+    // like the requests of the server threads which attach and detach themselves.
+    // The class path of the JVM must contain the class
+    // havis.util.opcua.benchmark.BenchmarkDataProvider.
+    BenchmarkGroup* createJDataProviderBenchmarks(JavaVM& vm) /* throws Exception */;
+} // namespace BenchmarkNamespace
+#endif /* JNI_JDATAPROVIDERBENCHMARKS_H */
@@ -0,0 +1,279 @@
+#include "JniCounters.h"
+#include <common/Exception.h>
+#include <jvmti.h>
+#include <stdarg.h> // va_list
+
+using namespace CommonNamespace;
+
+namespace BenchmarkNamespace {
+
+    // the counts of the current thread
+    static __thread unsigned long long localRefCount = 0;
+    static __thread unsigned long long deletedLocalRefCount = 0;
+    static __thread unsigned long long globalRefCount = 0;
+    static __thread unsigned long long deletedGlobalRefCount = 0;
+    static __thread unsigned long long attachCount = 0;
+    static __thread unsigned long long detachCount = 0;
+
+    // the original functions
+    static JavaVM* originalVm = NULL;
+    static JNINativeInterface_ originalFunctions;
+    // the counting functions
+    static JNIInvokeInterface_ vmFunctions;
+    static JNINativeInterface_ envFunctions;
+    static JavaVM vm;
+
+    static jobject countLocalRef(jobject ref) {
+        if (ref != NULL) {
+            localRefCount++;
+        }
+        return ref;
+    }
+
+    static jclass JNICALL findClass(JNIEnv* env, const char* name) {
+        return static_cast<jclass> (countLocalRef(originalFunctions.FindClass(env, name)));
+    }
+
+    static jclass JNICALL getObjectClass(JNIEnv* env, jobject obj) {
+        return static_cast<jclass> (countLocalRef(originalFunctions.GetObjectClass(env, obj)));
+    }
+
+    static jstring JNICALL newStringUTF(JNIEnv* env, const char* utf) {
+        return static_cast<jstring> (countLocalRef(originalFunctions.NewStringUTF(env, utf)));
+    }
+
+    static jobject JNICALL callObjectMethodV(JNIEnv* env, jobject obj, jmethodID methodID,
+            va_list args) {
+        return countLocalRef(originalFunctions.CallObjectMethodV(env, obj, methodID, args));
+    }
+
+    static jobject JNICALL callObjectMethod(JNIEnv* env, jobject obj, jmethodID methodID, ...) {
+        va_list args;
+        va_start(args, methodID);
+        jobject ret = callObjectMethodV(env, obj, methodID, args);
+        va_end(args);
+        return ret;
+    }
+
+    static jobject JNICALL callObjectMethodA(JNIEnv* env, jobject obj, jmethodID methodID,
+            const jvalue* args) {
+        return countLocalRef(originalFunctions.CallObjectMethodA(env, obj, methodID, args));
+    }
+
+    static jobject JNICALL callStaticObjectMethodV(JNIEnv* env, jclass clazz,
+            jmethodID methodID, va_list args) {
+        return countLocalRef(originalFunctions.CallStaticObjectMethodV(env, clazz, methodID,
+                args));
+    }
+
+    static jobject JNICALL callStaticObjectMethod(JNIEnv* env, jclass clazz, jmethodID methodID,
+            ...) {
+        va_list args;
+        va_start(args, methodID);
+        jobject ret = callStaticObjectMethodV(env, clazz, methodID, args);
+        va_end(args);
+        return ret;
+    }
+
+    static jobject JNICALL callStaticObjectMethodA(JNIEnv* env, jclass clazz,
+            jmethodID methodID, const jvalue* args) {
+        return countLocalRef(originalFunctions.CallStaticObjectMethodA(env, clazz, methodID,
+                args));
+    }
+
+    static jobject JNICALL newObjectV(JNIEnv* env, jclass clazz, jmethodID methodID,
+            va_list args) {
+        return countLocalRef(originalFunctions.NewObjectV(env, clazz, methodID, args));
+    }
+
+    static jobject JNICALL newObject(JNIEnv* env, jclass clazz, jmethodID methodID, ...) {
+        va_list args;
+        va_start(args, methodID);
+        jobject ret = newObjectV(env, clazz, methodID, args);
+        va_end(args);
+        return ret;
+    }
+
+    static jobject JNICALL newObjectA(JNIEnv* env, jclass clazz, jmethodID methodID,
+            const jvalue* args) {
+        return countLocalRef(originalFunctions.NewObjectA(env, clazz, methodID, args));
+    }
+
+    static jobjectArray JNICALL newObjectArray(JNIEnv* env, jsize length, jclass elementClass,
+            jobject initialElement) {
+        return static_cast<jobjectArray> (countLocalRef(originalFunctions.NewObjectArray(env,
+                length, elementClass, initialElement)));
+    }
+
+    static jobject JNICALL getObjectArrayElement(JNIEnv* env, jobjectArray array,
+            jsize index) {
+        return countLocalRef(originalFunctions.GetObjectArrayElement(env, array, index));
+    }
+
+    static jthrowable JNICALL exceptionOccurred(JNIEnv* env) {
+        return static_cast<jthrowable> (countLocalRef(originalFunctions.ExceptionOccurred(env)));
+    }
+
+    static jobject JNICALL newLocalRef(JNIEnv* env, jobject ref) {
+        return countLocalRef(originalFunctions.NewLocalRef(env, ref));
+    }
+
+    static void JNICALL deleteLocalRef(JNIEnv* env, jobject ref) {
+        if (ref != NULL) {
+            deletedLocalRefCount++;
+        }
+        originalFunctions.DeleteLocalRef(env, ref);
+    }
+
+    static jobject JNICALL newGlobalRef(JNIEnv* env, jobject ref) {
+        jobject ret = originalFunctions.NewGlobalRef(env, ref);
+        if (ret != NULL) {
+            globalRefCount++;
+        }
+        return ret;
+    }
+
+    static void JNICALL deleteGlobalRef(JNIEnv* env, jobject ref) {
+        if (ref != NULL) {
+            deletedGlobalRefCount++;
+        }
+        originalFunctions.DeleteGlobalRef(env, ref);
+    }
+
+    static jint JNICALL getJavaVM(JNIEnv* env, JavaVM** returnVm) {
+        jint ret = originalFunctions.GetJavaVM(env, returnVm);
+        if (ret == JNI_OK) {
+            *returnVm = &vm;
+        }
+        return ret;
+    }
+
+    static jint JNICALL destroyJavaVM(JavaVM* javaVm) {
+        return originalVm->DestroyJavaVM();
+    }
+
+    static jint JNICALL attachCurrentThread(JavaVM* javaVm, void** penv, void* args) {
+        attachCount++;
+        return originalVm->AttachCurrentThread(penv, args);
+    }
+
+    static jint JNICALL attachCurrentThreadAsDaemon(JavaVM* javaVm, void** penv, void* args) {
+        attachCount++;
+        return originalVm->AttachCurrentThreadAsDaemon(penv, args);
+    }
+
+    static jint JNICALL detachCurrentThread(JavaVM* javaVm) {
+        detachCount++;
+        return originalVm->DetachCurrentThread();
+    }
+
+    static jint JNICALL getEnv(JavaVM* javaVm, void** penv, jint version) {
+        return originalVm->GetEnv(penv, version);
+    }
+
+    // A counter of the BenchmarkRunner which provides a value of the counts.
+    class JniCounter : public BenchmarkRunner::Counter {
+    public:
+
+        enum Type {
+            LOCAL_REFS, LEAKED_LOCAL_REFS, GLOBAL_REFS, LEAKED_GLOBAL_REFS, ATTACHES, DETACHES
+        };
+
+        JniCounter(const std::string& name, Type type) : Counter(name) {
+            this->type = type;
+        }
+
+        virtual long long getValue() {
+            JniCounters::Counts counts = JniCounters::getCounts();
+            switch (type) {
+                case LOCAL_REFS:
+                    return counts.localRefCount;
+                case LEAKED_LOCAL_REFS:
+                    return counts.localRefCount - counts.deletedLocalRefCount;
+                case GLOBAL_REFS:
+                    return counts.globalRefCount;
+                case LEAKED_GLOBAL_REFS:
+                    return counts.globalRefCount - counts.deletedGlobalRefCount;
+                case ATTACHES:
+                    return counts.attachCount;
+                case DETACHES:
+                    return counts.detachCount;
+            }
+            return 0;
+        }
+    private:
+        Type type;
+    };
+
+    JavaVM* JniCounters::install(JavaVM& javaVm) /* throws Exception */ {
+        if (originalVm != NULL) {
+            throw ExceptionDef(Exception, "The JNI counters have already been installed");
+        }
+        jvmtiEnv* jvmti;
+        if (javaVm.GetEnv(reinterpret_cast<void**> (&jvmti), JVMTI_VERSION_1_0) != JNI_OK) {
+            throw ExceptionDef(Exception, "Cannot get the JVMTI environment");
+        }
+        jniNativeInterface* functions;
+        if (jvmti->GetJNIFunctionTable(&functions) != JVMTI_ERROR_NONE) {
+            throw ExceptionDef(Exception, "Cannot get the JNI function table");
+        }
+        originalFunctions = *functions;
+        jvmti->Deallocate(reinterpret_cast<unsigned char*> (functions));
+
+        envFunctions = originalFunctions;
+        envFunctions.FindClass = findClass;
+        envFunctions.GetObjectClass = getObjectClass;
+        envFunctions.NewStringUTF = newStringUTF;
+        envFunctions.CallObjectMethod = callObjectMethod;
+        envFunctions.CallObjectMethodV = callObjectMethodV;
+        envFunctions.CallObjectMethodA = callObjectMethodA;
+        envFunctions.CallStaticObjectMethod = callStaticObjectMethod;
+        envFunctions.CallStaticObjectMethodV = callStaticObjectMethodV;
+        envFunctions.CallStaticObjectMethodA = callStaticObjectMethodA;
+        envFunctions.NewObject = newObject;
+        envFunctions.NewObjectV = newObjectV;
+        envFunctions.NewObjectA = newObjectA;
+        envFunctions.NewObjectArray = newObjectArray;
+        envFunctions.GetObjectArrayElement = getObjectArrayElement;
+        envFunctions.ExceptionOccurred = exceptionOccurred;
+        envFunctions.NewLocalRef = newLocalRef;
+        envFunctions.DeleteLocalRef = deleteLocalRef;
+        envFunctions.NewGlobalRef = newGlobalRef;
+        envFunctions.DeleteGlobalRef = deleteGlobalRef;
+        envFunctions.GetJavaVM = getJavaVM;
+        // the table is applied to all existing and future JNI environments
+        if (jvmti->SetJNIFunctionTable(&envFunctions) != JVMTI_ERROR_NONE) {
+            throw ExceptionDef(Exception, "Cannot set the JNI function table");
+        }
+
+        originalVm = &javaVm;
+        vmFunctions = *javaVm.functions;
+        vmFunctions.DestroyJavaVM = destroyJavaVM;
+        vmFunctions.AttachCurrentThread = attachCurrentThread;
+        vmFunctions.AttachCurrentThreadAsDaemon = attachCurrentThreadAsDaemon;
+        vmFunctions.DetachCurrentThread = detachCurrentThread;
+        vmFunctions.GetEnv = getEnv;
+        vm.functions = &vmFunctions;
+        return &vm;
+    }
+
+    JniCounters::Counts JniCounters::getCounts() {
+        Counts ret;
+        ret.localRefCount = localRefCount;
+        ret.deletedLocalRefCount = deletedLocalRefCount;
+        ret.globalRefCount = globalRefCount;
+        ret.deletedGlobalRefCount = deletedGlobalRefCount;
+        ret.attachCount = attachCount;
+        ret.detachCount = detachCount;
+        return ret;
+    }
+
+    void JniCounters::createCounters(std::vector<BenchmarkRunner::Counter*>& counters) {
+        counters.push_back(new JniCounter("localRefs", JniCounter::LOCAL_REFS));
+        counters.push_back(new JniCounter("leakedLocalRefs", JniCounter::LEAKED_LOCAL_REFS));
+        counters.push_back(new JniCounter("globalRefs", JniCounter::GLOBAL_REFS));
+        counters.push_back(new JniCounter("leakedGlobalRefs", JniCounter::LEAKED_GLOBAL_REFS));
+        counters.push_back(new JniCounter("attaches", JniCounter::ATTACHES));
+        counters.push_back(new JniCounter("detaches", JniCounter::DETACHES));
+    }
+} // namespace BenchmarkNamespace
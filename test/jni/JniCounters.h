@@ -0,0 +1,49 @@
+#ifndef JNI_JNICOUNTERS_H
+#define JNI_JNICOUNTERS_H
+
+#include "../benchmark/BenchmarkRunner.h"
+#include <jni.h>
+#include <vector>
+
+namespace BenchmarkNamespace {
+
+    // Counts the JNI references and the thread attachments of the current thread.
+    // The JNI function table of the JVM is replaced via JVMTI. The JavaVM instance which is
+    // returned by "GetJavaVM" is replaced by a wrapper which counts the calls of
+    // "AttachCurrentThread(AsDaemon)" and "DetachCurrentThread". The local references are
+    // counted for the functions which are used by the JNI data provider and the converters
+    // (FindClass, GetObjectClass, NewStringUTF, Call(Static)ObjectMethod, NewObject,
+    // NewObjectArray, GetObjectArrayElement, ExceptionOccurred, NewLocalRef).
+    // Only the calls of the current thread are counted so that the JNI calls of the threads
+    // of the JVM are not included.
+    class JniCounters {
+    public:
+
+        class Counts {
+        public:
+            unsigned long long localRefCount;
+            unsigned long long deletedLocalRefCount;
+            unsigned long long globalRefCount;
+            unsigned long long deletedGlobalRefCount;
+            unsigned long long attachCount;
+            unsigned long long detachCount;
+        };
+
+        // Installs the counting functions. It must be called once after the creation of the
+        // JVM. The returned JavaVM instance must be used instead of the original one.
+        static JavaVM* install(JavaVM& vm) /* throws Exception */;
+
+        // Returns the counts of the current thread.
+        static Counts getCounts();
+
+        // Creates the counters for the BenchmarkRunner: localRefs, leakedLocalRefs (local
+        // references which are not deleted explicitly; they are released when the native
+        // method returns or the thread is detached), globalRefs, leakedGlobalRefs, attaches,
+        // detaches. The responsibility for destroying the counters is delegated to the
+        // caller.
+        static void createCounters(std::vector<BenchmarkRunner::Counter*>& counters);
+    private:
+        JniCounters();
+    };
+} // namespace BenchmarkNamespace
+#endif /* JNI_JNICOUNTERS_H */
@@ -0,0 +1,191 @@
+#include "ValueConversionBenchmarks.h"
+#include "BenchmarkModel.h"
+#include "../../src/common/native2J/Native2J.h"
+#include "../../src/provider/binary/jDataProvider/Java2IO.h"
+#include "../../src/provider/binary/messages/ConverterBin2IO.h"
+#include <common/ArenaScope.h>
+#include <common/Exception.h>
+#include <common/ScopeGuard.h>
+#include <ioDataProvider/Variant.h>
+#include <sasModelProvider/base/ConverterUa2IO.h>
+#include <uanodeid.h> // UaNodeId
+#include <uavariant.h> // UaVariant
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace BenchmarkNamespace {
+
+    static const int NAMESPACE_INDEX = 2;
+
+    // Throws an exception if a Java exception is pending. The Java exception is cleared.
+    static void checkException(JNIEnv& env, const std::string& msg) /* throws Exception */ {
+        if (env.ExceptionCheck()) {
+            env.ExceptionDescribe();
+            env.ExceptionClear();
+            throw ExceptionDef(Exception, msg);
+        }
+    }
+
+    // Conversions of the values of the Java data provider BenchmarkDataProvider (a scalar, an
+    // array and a nested structure with a list of structures) to UaVariants:
+    // direct: Java -> Java2IO -> IO model -> ConverterUa2IO -> UaVariant
+    // generic: Java -> Native2J -> binary model -> ConverterBin2IO -> IO model
+    //     -> ConverterUa2IO -> UaVariant
+    // The data types of the values are provided by BenchmarkTypes like the node browser of the
+    // server does. The thread is attached to the JVM while a benchmark is executed.
+    class ValueConversionBenchmarks : public BenchmarkGroup {
+    public:
+
+        // Converts a Java value to a UaVariant. The value is converted once in "setUp" to
+        // verify the conversion.
+        class ConversionBenchmark : public Benchmark {
+        public:
+
+            ConversionBenchmark(const std::string& name, JavaVM& vm,
+                    ValueConversionBenchmarks& group, bool isDirect, jobject value,
+                    const UaNodeId& dataTypeId) : Benchmark(name), dataTypeId(dataTypeId) {
+                this->vm = &vm;
+                this->group = &group;
+                this->isDirect = isDirect;
+                this->value = value;
+                env = NULL;
+            }
+
+            virtual void setUp() /* throws Exception */ {
+                if (vm->AttachCurrentThread(reinterpret_cast<void**> (&env), NULL) != JNI_OK) {
+                    env = NULL;
+                    throw ExceptionDef(Exception, "Cannot attach the thread to the JVM");
+                }
+                run(); // Exception
+            }
+
+            virtual void tearDown() {
+                if (env != NULL) {
+                    vm->DetachCurrentThread();
+                    env = NULL;
+                }
+            }
+
+            virtual void run() /* throws Exception */ {
+                if (isDirect) {
+                    delete group->convertDirect(*env, value, dataTypeId); // Exception
+                } else {
+                    delete group->convertGeneric(*env, value, dataTypeId); // Exception
+                }
+            }
+        private:
+            JavaVM* vm;
+            ValueConversionBenchmarks* group;
+            bool isDirect;
+            jobject value;
+            UaNodeId dataTypeId;
+            JNIEnv* env;
+        };
+
+        ValueConversionBenchmarks(JavaVM& vm) /* throws MutexException, Exception */ :
+        types(NAMESPACE_INDEX), converter(types), java2io(types) {
+            this->vm = &vm;
+            JNIEnv* env;
+            if (vm.AttachCurrentThread(reinterpret_cast<void**> (&env), NULL) != JNI_OK) {
+                throw ExceptionDef(Exception, "Cannot attach the thread to the JVM");
+            }
+            native2j = new Native2J(env, NULL /* handler */);
+            try {
+                readValues(*env); // Exception
+            } catch (Exception& e) {
+                vm.DetachCurrentThread();
+                throw;
+            }
+            vm.DetachCurrentThread();
+        }
+
+        virtual ~ValueConversionBenchmarks() {
+            JNIEnv* env;
+            if (vm->AttachCurrentThread(reinterpret_cast<void**> (&env), NULL) == JNI_OK) {
+                for (std::map<std::string, jobject>::const_iterator it = values.begin();
+                        it != values.end(); it++) {
+                    env->DeleteGlobalRef(it->second);
+                }
+                vm->DetachCurrentThread();
+            }
+            delete native2j;
+        }
+
+        virtual void createBenchmarks(std::vector<Benchmark*>& benchmarks) {
+            add(benchmarks, "Scalar", UaNodeId(OpcUaId_Double));
+            add(benchmarks, "Array", UaNodeId(OpcUaId_Int32));
+            add(benchmarks, "Nested", types.getNested().dataTypeId());
+        }
+
+        // Java -> IO model -> UaVariant
+        UaVariant* convertDirect(JNIEnv& env, jobject value,
+                const UaNodeId& dataTypeId) /* throws ConversionException */ {
+            IODataProviderNamespace::Variant* ioValue = java2io.convert(&env, value,
+                    dataTypeId); // ConversionException
+            ScopeGuard<IODataProviderNamespace::Variant> ioValueSG(ioValue);
+            return converter.convertIo2ua(*ioValue, dataTypeId); // ConversionException
+        }
+
+        // Java -> binary model -> IO model -> UaVariant
+        // The binary model is allocated from the arena of the thread like JDataProvider does.
+        UaVariant* convertGeneric(JNIEnv& env, jobject value,
+                const UaNodeId& dataTypeId) /* throws ConversionException */ {
+            ArenaScope arenaScope;
+            Variant* binValue = native2j->getVariant(&env, value);
+            ScopeGuard<Variant> binValueSG(binValue);
+            IODataProviderNamespace::Variant* ioValue = bin2io.convertBin2io(*binValue,
+                    NAMESPACE_INDEX);
+            ScopeGuard<IODataProviderNamespace::Variant> ioValueSG(ioValue);
+            return converter.convertIo2ua(*ioValue, dataTypeId); // ConversionException
+        }
+    private:
+        JavaVM* vm;
+        BenchmarkTypes types;
+        ConverterUa2IO converter;
+        Java2IO java2io;
+        Native2J* native2j;
+        ConverterBin2IO bin2io;
+        // node id -> global reference to the Java value
+        std::map<std::string, jobject> values;
+
+        void add(std::vector<Benchmark*>& benchmarks, const std::string& name,
+                const UaNodeId& dataTypeId) {
+            jobject value = values[name];
+            benchmarks.push_back(new ConversionBenchmark("ValueConversion/direct/" + name,
+                    *vm, *this, true /* isDirect */, value, dataTypeId));
+            benchmarks.push_back(new ConversionBenchmark("ValueConversion/generic/" + name,
+                    *vm, *this, false /* isDirect */, value, dataTypeId));
+        }
+
+        // Reads the values from an instance of the Java data provider.
+        void readValues(JNIEnv& env) /* throws Exception */ {
+            jclass clazz = env.FindClass("havis/util/opcua/benchmark/BenchmarkDataProvider");
+            checkException(env, "Cannot find the Java data provider"); // Exception
+            jmethodID constructor = env.GetMethodID(clazz, "<init>", "(I)V");
+            jmethodID read = env.GetMethodID(clazz, "read",
+                    "(ILjava/lang/Object;)Ljava/lang/Object;");
+            checkException(env, "Cannot get the methods of the Java data provider"); // Exception
+            jobject provider = env.NewObject(clazz, constructor, NAMESPACE_INDEX);
+            checkException(env, "Cannot create the Java data provider"); // Exception
+            const char* names[] = {"Scalar", "Array", "Nested"};
+            for (int i = 0; i < 3; i++) {
+                jstring id = env.NewStringUTF(names[i]);
+                jobject value = env.CallObjectMethod(provider, read, NAMESPACE_INDEX, id);
+                checkException(env, std::string("Cannot read ").append(names[i])); // Exception
+                values[names[i]] = env.NewGlobalRef(value);
+                env.DeleteLocalRef(value);
+                env.DeleteLocalRef(id);
+            }
+            env.DeleteLocalRef(provider);
+            env.DeleteLocalRef(clazz);
+        }
+    };
+
+    BenchmarkGroup* createValueConversionBenchmarks(JavaVM& vm) /* throws Exception */ {
+        return new ValueConversionBenchmarks(vm);
+    }
+} // namespace BenchmarkNamespace
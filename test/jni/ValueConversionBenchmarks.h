@@ -0,0 +1,16 @@
+#ifndef JNI_VALUECONVERSIONBENCHMARKS_H
+#define JNI_VALUECONVERSIONBENCHMARKS_H
+
+#include "../benchmark/Benchmark.h"
+#include <jni.h>
+
+namespace BenchmarkNamespace {
+
+    // Creates the benchmarks which compare the conversions of Java values to UaVariants.
+    // The current thread is attached to the JVM while the group is created and detached
+    // before the function returns (see createJDataProviderBenchmarks).
+    // The class path of the JVM must contain the class
+    // havis.util.opcua.benchmark.BenchmarkDataProvider.
+    BenchmarkGroup* createValueConversionBenchmarks(JavaVM& vm) /* throws Exception */;
+} // namespace BenchmarkNamespace
+#endif /* JNI_VALUECONVERSIONBENCHMARKS_H */
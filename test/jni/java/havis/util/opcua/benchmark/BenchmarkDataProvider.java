@@ -0,0 +1,106 @@
+package havis.util.opcua.benchmark;
+
+import havis.util.opcua.DataProvider;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Data provider of the JNI benchmark. It provides a value for each node id (Scalar, Array,
+ * Map, Nested) and an event for each node id. Written values are discarded and a method
+ * returns its input arguments.
+ *
+ * The native methods are registered by the benchmark executable.
+ */
+public class BenchmarkDataProvider implements DataProvider {
+
+	private static final long serialVersionUID = 1L;
+
+	private static final String EVENT_TYPE = "BenchmarkEventType";
+	private static final String EVENT_SOURCE = "BenchmarkSource";
+
+	private final Map<String, Object> values = new HashMap<String, Object>();
+	private final Map<String, Object> events = new HashMap<String, Object>();
+
+	public BenchmarkDataProvider(int namespace) {
+		values.put("Scalar", Double.valueOf(21.5));
+
+		Object[] array = new Object[16];
+		for (int i = 0; i < array.length; i++) {
+			array[i] = Integer.valueOf(i);
+		}
+		values.put("Array", array);
+
+		values.put("Map", createMap(1));
+
+		HashMap<String, Object> nested = createMap(2);
+		nested.put("config", createMap(3));
+		List<Object> history = new ArrayList<Object>();
+		for (int i = 0; i < 4; i++) {
+			history.add(createMap(i));
+		}
+		nested.put("history", history);
+		values.put("Nested", nested);
+
+		for (Map.Entry<String, Object> entry : values.entrySet()) {
+			HashMap<String, Object> fields = new HashMap<String, Object>();
+			fields.put("NS" + namespace + "|String|Value", entry.getValue());
+			events.put(entry.getKey(), fields);
+		}
+	}
+
+	private static HashMap<String, Object> createMap(int index) {
+		HashMap<String, Object> ret = new HashMap<String, Object>();
+		ret.put("temperature", Double.valueOf(20 + index));
+		ret.put("humidity", Float.valueOf(40 + index));
+		ret.put("active", Boolean.TRUE);
+		ret.put("count", Long.valueOf(index));
+		ret.put("name", "sensor" + index);
+		return ret;
+	}
+
+	@Override
+	public Object read(int namespace, Object id) throws Exception {
+		return values.get(id);
+	}
+
+	@Override
+	public void write(int namespace, Object id, Object value) throws Exception {
+	}
+
+	@Override
+	public void subscribe(int namespace, Object id) throws Exception {
+	}
+
+	@Override
+	public void unsubscribe(int namespace, Object id) throws Exception {
+	}
+
+	@Override
+	public Object exec(int namespaceMethod, Object methodId, int nodeNamespace, Object nodeId,
+			Object params) throws Exception {
+		return params;
+	}
+
+	/**
+	 * Sends the value of a node to the native data provider.
+	 */
+	public void fireNotification(int namespace, String id) {
+		notification(namespace, id, values.get(id));
+	}
+
+	/**
+	 * Sends the event of a node to the native data provider.
+	 */
+	public void fireEvent(int namespace, String id) {
+		event(namespace, EVENT_TYPE, namespace, EVENT_SOURCE, System.currentTimeMillis(), 500,
+				"Benchmark event", events.get(id));
+	}
+
+	private native void notification(int namespace, Object nodeId, Object value);
+
+	private native void event(int eventNamespace, Object eventId, int paramNamespace,
+			Object paramId, long timestamp, int severity, String msg, Object param);
+}
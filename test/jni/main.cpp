@@ -0,0 +1,180 @@
+#include "JDataProviderBenchmarks.h"
+#include "JniCounters.h"
+#include "ValueConversionBenchmarks.h"
+#include "../benchmark/Benchmark.h"
+#include "../benchmark/BenchmarkRunner.h"
+#include <common/Exception.h>
+#include <common/VectorScopeGuard.h>
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <config.h> // SERVER_VERSION
+#include <jni.h>
+#include <pthread.h>
+#include <stdlib.h> // atol
+#include <string.h> // strncmp
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace BenchmarkNamespace;
+using namespace CommonNamespace;
+
+// Usage: ServerJniBenchmark [--classPath=<path>] [--jvmOption=<option>]... [--filter=<substring>]
+//                           [--format=json|csv] [--minTime=<ms>] [--output=<file>] [--list]
+// Creates a JVM in the process and measures the round trips of the JNI data provider to a
+// Java data provider and the conversions of the Java values. The class path must contain the classes of the jar
+// "jni-benchmark.jar" (default: the jar of the build directory). The results contain the
+// JNI references and the thread attachments per operation in addition to the time and the
+// allocations. The results are written to stdout if no output file is specified. The
+// progress is written to stderr.
+
+static const char* getOption(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    return strncmp(arg, name, length) == 0 ? arg + length : NULL;
+}
+
+class Options {
+public:
+    std::string classPath;
+    std::vector<std::string> jvmOptions;
+    std::string filter;
+    BenchmarkRunner::Format format;
+    long minTime;
+    std::string outputFile;
+    bool list;
+    int ret;
+};
+
+static void runBenchmarks(Options& options, JavaVM& vm) /* throws Exception */ {
+    std::vector<BenchmarkRunner::Counter*>* counters =
+            new std::vector<BenchmarkRunner::Counter*>();
+    VectorScopeGuard<BenchmarkRunner::Counter> countersSG(counters);
+    JniCounters::createCounters(*counters);
+    std::vector<BenchmarkGroup*> groups;
+    groups.push_back(createJDataProviderBenchmarks(vm)); // Exception
+    groups.push_back(createValueConversionBenchmarks(vm)); // Exception
+    std::vector<Benchmark*> benchmarks;
+    for (size_t i = 0; i < groups.size(); i++) {
+        groups[i]->createBenchmarks(benchmarks);
+    }
+
+    BenchmarkRunner runner(options.minTime);
+    for (size_t i = 0; i < counters->size(); i++) {
+        runner.addCounter(*(*counters)[i]);
+    }
+    std::vector<BenchmarkRunner::Result> results;
+    for (size_t i = 0; i < benchmarks.size(); i++) {
+        Benchmark& benchmark = *benchmarks[i];
+        if (benchmark.getName().find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (options.list) {
+            std::cout << benchmark.getName() << std::endl;
+            continue;
+        }
+        std::cerr << benchmark.getName() << std::endl;
+        try {
+            results.push_back(runner.run(benchmark));
+        } catch (Exception& e) {
+            std::string st;
+            e.getStackTrace(st);
+            std::cerr << "Benchmark " << benchmark.getName() << " failed: " << st << std::endl;
+            options.ret = 1;
+        }
+    }
+    if (!options.list) {
+        if (options.outputFile.empty()) {
+            BenchmarkRunner::write(std::cout, SERVER_VERSION, results, options.format);
+        } else {
+            std::ofstream out(options.outputFile.c_str());
+            BenchmarkRunner::write(out, SERVER_VERSION, results, options.format);
+        }
+    }
+
+    for (size_t i = 0; i < benchmarks.size(); i++) {
+        delete benchmarks[i];
+    }
+    for (size_t i = 0; i < groups.size(); i++) {
+        delete groups[i];
+    }
+}
+
+// The JVM is created in a separate thread like the Java launcher does (the stack of the
+// primordial thread is not supported by all JVMs).
+static void* run(void* arg) {
+    Options& options = *static_cast<Options*> (arg);
+    std::string classPathOption("-Djava.class.path=");
+    classPathOption.append(options.classPath);
+    std::vector<JavaVMOption> jvmOptions(1 + options.jvmOptions.size());
+    jvmOptions[0].optionString = const_cast<char*> (classPathOption.c_str());
+    for (size_t i = 0; i < options.jvmOptions.size(); i++) {
+        jvmOptions[i + 1].optionString = const_cast<char*> (options.jvmOptions[i].c_str());
+    }
+    JavaVMInitArgs args;
+    args.version = JNI_VERSION_1_6;
+    args.nOptions = jvmOptions.size();
+    args.options = &jvmOptions[0];
+    args.ignoreUnrecognized = JNI_FALSE;
+    JavaVM* originalVm;
+    JNIEnv* env;
+    if (JNI_CreateJavaVM(&originalVm, reinterpret_cast<void**> (&env), &args) != JNI_OK) {
+        std::cerr << "Cannot create the JVM" << std::endl;
+        options.ret = 1;
+        return NULL;
+    }
+    try {
+        JavaVM* vm = JniCounters::install(*originalVm); // Exception
+        runBenchmarks(options, *vm); // Exception
+    } catch (Exception& e) {
+        std::string st;
+        e.getStackTrace(st);
+        std::cerr << "Benchmarks failed: " << st << std::endl;
+        options.ret = 1;
+    }
+    originalVm->DestroyJavaVM();
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    options.classPath = JNI_BENCHMARK_CLASS_PATH;
+    options.format = BenchmarkRunner::JSON;
+    options.minTime = 200;
+    options.list = false;
+    options.ret = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* value;
+        if ((value = getOption(argv[i], "--classPath=")) != NULL) {
+            options.classPath = value;
+        } else if ((value = getOption(argv[i], "--jvmOption=")) != NULL) {
+            options.jvmOptions.push_back(value);
+        } else if ((value = getOption(argv[i], "--filter=")) != NULL) {
+            options.filter = value;
+        } else if ((value = getOption(argv[i], "--format=")) != NULL) {
+            options.format = strcmp(value, "csv") == 0
+                    ? BenchmarkRunner::CSV : BenchmarkRunner::JSON;
+        } else if ((value = getOption(argv[i], "--minTime=")) != NULL) {
+            options.minTime = atol(value);
+        } else if ((value = getOption(argv[i], "--output=")) != NULL) {
+            options.outputFile = value;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            options.list = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--classPath=<path>]"
+                    << " [--jvmOption=<option>]... [--filter=<substring>] [--format=json|csv]"
+                    << " [--minTime=<ms>] [--output=<file>] [--list]" << std::endl;
+            return 1;
+        }
+    }
+
+    ConsoleLoggerFactory clf;
+    LoggerFactory lf(clf);
+    pthread_t thread;
+    if (pthread_create(&thread, NULL /*attr*/, &run, &options) != 0) {
+        std::cerr << "Cannot create the benchmark thread" << std::endl;
+        return 1;
+    }
+    pthread_join(thread, NULL /*return value*/);
+    return options.ret;
+}
@@ -0,0 +1,170 @@
+#include "LatencyRecorder.h"
+#include <common/Exception.h>
+#include <common/MutexException.h>
+#include <stdio.h> // snprintf
+#include <time.h> // clock_gettime
+#include <string.h> // memset, memcpy
+
+using namespace CommonNamespace;
+
+namespace LoadNamespace {
+
+    static long long now() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    static std::string format(double value) {
+        char buffer[32];
+        snprintf(buffer, sizeof (buffer), "%.3f", value);
+        return std::string(buffer);
+    }
+
+    LatencyRecorder::LatencyRecorder() /* throws MutexException */ {
+        if (pthread_mutex_init(&mutex, NULL /*attr*/) != 0) {
+            throw ExceptionDef(MutexException, "Cannot initialize mutex for latency recorder");
+        }
+        memset(buckets, 0, sizeof (buckets));
+        notificationCount = 0;
+        latencyMax = 0;
+        eventCount = 0;
+        startTime = now();
+    }
+
+    LatencyRecorder::~LatencyRecorder() {
+        pthread_mutex_destroy(&mutex);
+    }
+
+    void LatencyRecorder::addLatency(long long latency) {
+        if (latency < 0) {
+            // the clocks of the server and the client are not synchronized exactly
+            latency = 0;
+        }
+        int index = getBucketIndex(latency);
+        pthread_mutex_lock(&mutex);
+        buckets[index]++;
+        notificationCount++;
+        if (latency > latencyMax) {
+            latencyMax = latency;
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void LatencyRecorder::addEvents(unsigned long count) {
+        pthread_mutex_lock(&mutex);
+        eventCount += count;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void LatencyRecorder::reset() {
+        pthread_mutex_lock(&mutex);
+        memset(buckets, 0, sizeof (buckets));
+        notificationCount = 0;
+        latencyMax = 0;
+        eventCount = 0;
+        startTime = now();
+        pthread_mutex_unlock(&mutex);
+    }
+
+    LatencyRecorder::Statistics LatencyRecorder::getStatistics() {
+        unsigned long sortedBuckets[BUCKET_COUNT];
+        Statistics ret;
+        pthread_mutex_lock(&mutex);
+        memcpy(sortedBuckets, buckets, sizeof (buckets));
+        ret.notificationCount = notificationCount;
+        long long max = latencyMax;
+        ret.duration = (now() - startTime) / 1000000000.0;
+        ret.eventCount = eventCount;
+        pthread_mutex_unlock(&mutex);
+
+        ret.notificationsPerSecond = ret.duration > 0 ? ret.notificationCount / ret.duration : 0;
+        ret.eventsPerSecond = ret.duration > 0 ? ret.eventCount / ret.duration : 0;
+        ret.latencyP50 = getPercentile(sortedBuckets, ret.notificationCount, max, 50);
+        ret.latencyP90 = getPercentile(sortedBuckets, ret.notificationCount, max, 90);
+        ret.latencyP99 = getPercentile(sortedBuckets, ret.notificationCount, max, 99);
+        ret.latencyMax = ret.notificationCount == 0 ? 0 : max / 1000.0;
+        return ret;
+    }
+
+    int LatencyRecorder::getBucketIndex(long long latency) {
+        if (latency < 2 * SUB_BUCKET_COUNT) {
+            return static_cast<int> (latency);
+        }
+        // position of the most significant bit (>= SUB_BUCKET_BITS + 1)
+        int msb = 63 - __builtin_clzll(static_cast<unsigned long long> (latency));
+        int shift = msb - SUB_BUCKET_BITS;
+        int subBucket = static_cast<int> (latency >> shift) - SUB_BUCKET_COUNT;
+        return 2 * SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_COUNT + subBucket;
+    }
+
+    long long LatencyRecorder::getBucketValue(int index) {
+        if (index < 2 * SUB_BUCKET_COUNT) {
+            return index;
+        }
+        int shift = (index - 2 * SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT + 1;
+        unsigned long long subBucket = SUB_BUCKET_COUNT
+                + (index - 2 * SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+        return static_cast<long long> (((subBucket + 1) << shift) - 1);
+    }
+
+    double LatencyRecorder::getPercentile(const unsigned long* buckets, unsigned long count,
+            long long max, double percent) {
+        if (count == 0) {
+            return 0;
+        }
+        // nearest rank
+        unsigned long rank = static_cast<unsigned long> (percent / 100 * count + 0.999999);
+        if (rank < 1) {
+            rank = 1;
+        } else if (rank > count) {
+            rank = count;
+        }
+        unsigned long current = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            current += buckets[i];
+            if (current >= rank) {
+                long long value = getBucketValue(i);
+                return (value < max ? value : max) / 1000.0;
+            }
+        }
+        return max / 1000.0;
+    }
+
+    void LatencyRecorder::write(std::ostream& out, const std::string& version, int sessionCount,
+            int monitoredItemCount, const Statistics& statistics, Format format) {
+        switch (format) {
+            case JSON:
+                out << "{\n  \"version\": \"" << version << "\""
+                        << ",\n  \"sessions\": " << sessionCount
+                        << ",\n  \"monitoredItems\": " << monitoredItemCount
+                        << ",\n  \"duration\": " << LoadNamespace::format(statistics.duration)
+                        << ",\n  \"notifications\": " << statistics.notificationCount
+                        << ",\n  \"events\": " << statistics.eventCount
+                        << ",\n  \"notificationsPerSecond\": "
+                        << LoadNamespace::format(statistics.notificationsPerSecond)
+                        << ",\n  \"eventsPerSecond\": "
+                        << LoadNamespace::format(statistics.eventsPerSecond)
+                        << ",\n  \"latencyP50Ms\": " << LoadNamespace::format(statistics.latencyP50)
+                        << ",\n  \"latencyP90Ms\": " << LoadNamespace::format(statistics.latencyP90)
+                        << ",\n  \"latencyP99Ms\": " << LoadNamespace::format(statistics.latencyP99)
+                        << ",\n  \"latencyMaxMs\": " << LoadNamespace::format(statistics.latencyMax)
+                        << "\n}\n";
+                break;
+            case CSV:
+                out << "version,sessions,monitoredItems,duration,notifications,events,"
+                        << "notificationsPerSecond,eventsPerSecond,"
+                        << "latencyP50Ms,latencyP90Ms,latencyP99Ms,latencyMaxMs\n";
+                out << version << "," << sessionCount << "," << monitoredItemCount << ","
+                        << LoadNamespace::format(statistics.duration) << ","
+                        << statistics.notificationCount << "," << statistics.eventCount << ","
+                        << LoadNamespace::format(statistics.notificationsPerSecond) << ","
+                        << LoadNamespace::format(statistics.eventsPerSecond) << ","
+                        << LoadNamespace::format(statistics.latencyP50) << ","
+                        << LoadNamespace::format(statistics.latencyP90) << ","
+                        << LoadNamespace::format(statistics.latencyP99) << ","
+                        << LoadNamespace::format(statistics.latencyMax) << "\n";
+                break;
+        }
+    }
+} // namespace LoadNamespace
@@ -0,0 +1,83 @@
+#ifndef LOAD_LATENCYRECORDER_H
+#define LOAD_LATENCYRECORDER_H
+
+#include <pthread.h> // pthread_mutex_t
+#include <ostream>
+#include <string>
+
+namespace LoadNamespace {
+
+    // Collects the latencies of received notifications and the count of received events.
+    // The latencies are counted in a histogram with a fixed count of buckets: latencies below
+    // 64 microseconds are counted exactly, larger latencies in buckets with a relative width
+    // of at most 1/32 (percentiles are reported with the upper bound of their bucket).
+    // The memory usage does not depend on the count of notifications.
+    // This class is thread safe.
+    class LatencyRecorder {
+    public:
+
+        enum Format {
+            JSON, CSV
+        };
+
+        class Statistics {
+        public:
+            // duration of the measurement in seconds
+            double duration;
+            unsigned long notificationCount;
+            unsigned long eventCount;
+            // received notifications and events per second
+            double notificationsPerSecond;
+            double eventsPerSecond;
+            // latencies in milliseconds (0 if no notification has been received)
+            double latencyP50;
+            double latencyP90;
+            double latencyP99;
+            double latencyMax;
+        };
+
+        LatencyRecorder() /* throws MutexException */;
+        virtual ~LatencyRecorder();
+
+        // latency: time in microseconds between the source time stamp of a value and its receipt
+        virtual void addLatency(long long latency);
+        virtual void addEvents(unsigned long count);
+        // Discards the collected data and starts a new measurement.
+        virtual void reset();
+        // Returns the statistics since the start of the measurement.
+        virtual Statistics getStatistics();
+
+        // Writes the statistics. JSON: {"version": ..., "sessions": ..., ...},
+        // CSV: a header line and a line with the values.
+        static void write(std::ostream& out, const std::string& version, int sessionCount,
+                int monitoredItemCount, const Statistics& statistics, Format format);
+    private:
+        LatencyRecorder(const LatencyRecorder& orig);
+        LatencyRecorder& operator=(const LatencyRecorder&);
+
+        // count of sub buckets per power of two (the first power of two with sub buckets is
+        // SUB_BUCKET_COUNT, all latencies below are counted exactly)
+        static const int SUB_BUCKET_BITS = 5;
+        static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+        static const int BUCKET_COUNT = 2 * SUB_BUCKET_COUNT
+                + (62 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT;
+
+        // Returns the index of the bucket for a latency in microseconds.
+        static int getBucketIndex(long long latency);
+        // Returns the upper bound of a bucket in microseconds.
+        static long long getBucketValue(int index);
+        // Returns the percentile of the latencies in milliseconds.
+        static double getPercentile(const unsigned long* buckets, unsigned long count,
+                long long max, double percent);
+
+        pthread_mutex_t mutex;
+        unsigned long buckets[BUCKET_COUNT];
+        unsigned long notificationCount;
+        // maximum latency in microseconds
+        long long latencyMax;
+        unsigned long eventCount;
+        // start time of the measurement in nanoseconds
+        long long startTime;
+    };
+} // namespace LoadNamespace
+#endif /* LOAD_LATENCYRECORDER_H */
@@ -0,0 +1,108 @@
+#include "LoadClient.h"
+#include <common/Exception.h>
+#include <common/VectorScopeGuard.h>
+#include <uadatetime.h> // UaDateTime
+#include <iostream>
+#include <map>
+
+using namespace CommonNamespace;
+
+namespace LoadNamespace {
+
+    // Returns the time in microseconds since 01.01.1601.
+    static long long toMicroseconds(const UaDateTime& dateTime) {
+        OpcUa_DateTime value = dateTime;
+        return ((static_cast<long long> (value.dwHighDateTime) << 32) | value.dwLowDateTime) / 10;
+    }
+
+    LoadClient::Configuration::Configuration() {
+        host = "localhost";
+        port = 4840;
+        username = NULL;
+        password = NULL;
+        sessionCount = 1;
+        publishingInterval = 100;
+    }
+
+    LoadClient::SessionCallback::SessionCallback(LatencyRecorder& recorder) {
+        this->recorder = &recorder;
+        connectionErrorCount = 0;
+    }
+
+    void LoadClient::SessionCallback::dataChanged(std::vector<NodeAttributes*>& nodeAttributes) {
+        long long receiveTime = toMicroseconds(UaDateTime::now());
+        for (size_t i = 0; i < nodeAttributes.size(); i++) {
+            NodeAttributes& attr = *nodeAttributes[i];
+            if (attr.getException() == NULL && attr.getSourceTimestamp() != NULL) {
+                recorder->addLatency(receiveTime - toMicroseconds(*attr.getSourceTimestamp()));
+            }
+        }
+    }
+
+    void LoadClient::SessionCallback::newEvents(
+            std::vector<const BinaryServerNamespace::Event*>& events) {
+        recorder->addEvents(events.size());
+    }
+
+    void LoadClient::SessionCallback::connectionStateChanged(int state) {
+        if (state != UaClientSdk::UaClient::Connected) {
+            __sync_add_and_fetch(&connectionErrorCount, 1);
+        }
+    }
+
+    LoadClient::LoadClient(const Configuration& conf, LatencyRecorder& recorder) :
+    callback(recorder) {
+        sessionConf.host = conf.host;
+        sessionConf.port = conf.port;
+        sessionConf.username = conf.username;
+        sessionConf.password = conf.password;
+        sessionConf.connectTimeout = 5;
+        sessionConf.sendReceiveTimeout = 5;
+        sessionConf.watchdogInterval = 5;
+        sessionConf.maxReconnectDelay = 10;
+        sessionConf.publishingInterval = conf.publishingInterval;
+        sessionCount = conf.sessionCount;
+    }
+
+    LoadClient::~LoadClient() {
+        close();
+    }
+
+    void LoadClient::open(const std::vector<const UaNodeId*>& nodeIds)
+    /* throws MutexException, HaSessionException, HaSubscriptionException */ {
+        for (int i = 0; i < sessionCount; i++) {
+            // the session is closed by "close" if the opening or subscribing fails
+            sessions.push_back(new HaSession(sessionConf, callback)); // MutexException
+            HaSession& session = *sessions.back();
+            session.open(); // HaSessionException
+            std::vector<NodeAttributes*> nodeAttributes;
+            std::map<UaNodeId, std::vector<BinaryServerNamespace::EventField*>*> eventFields;
+            session.subscribe(nodeIds, nodeAttributes, eventFields); // HaSubscriptionException
+            for (size_t j = 0; j < nodeAttributes.size(); j++) {
+                delete nodeAttributes[j];
+            }
+            for (std::map<UaNodeId, std::vector<BinaryServerNamespace::EventField*>*>::const_iterator it =
+                    eventFields.begin(); it != eventFields.end(); it++) {
+                VectorScopeGuard<BinaryServerNamespace::EventField> eventFieldsSG(it->second);
+            }
+        }
+    }
+
+    void LoadClient::close() {
+        for (size_t i = 0; i < sessions.size(); i++) {
+            try {
+                sessions[i]->close(); // HaSessionException, HaSubscriptionException
+            } catch (Exception& e) {
+                std::string st;
+                e.getStackTrace(st);
+                std::cerr << "Cannot close session: " << st << std::endl;
+            }
+            delete sessions[i];
+        }
+        sessions.clear();
+    }
+
+    unsigned long LoadClient::getConnectionErrorCount() {
+        return __sync_add_and_fetch(&callback.connectionErrorCount, 0);
+    }
+} // namespace LoadNamespace
@@ -0,0 +1,68 @@
+#ifndef LOAD_LOADCLIENT_H
+#define LOAD_LOADCLIENT_H
+
+#include "LatencyRecorder.h"
+#include "../../src/binaryServer/HaSession.h"
+#include <uanodeid.h> // UaNodeId
+#include <string>
+#include <vector>
+
+namespace LoadNamespace {
+
+    // Opens sessions to an OPC UA server and subscribes the same nodes in each session.
+    // The latencies of the received data change notifications (time between the source time
+    // stamp of a value and its receipt) and the count of received events are collected by a
+    // latency recorder.
+    class LoadClient {
+    public:
+
+        class Configuration {
+        public:
+            Configuration();
+
+            std::string host;
+            int port;
+            // optional credentials
+            std::string* username;
+            std::string* password;
+            int sessionCount;
+            // publishing interval of the subscriptions in milliseconds
+            int publishingInterval;
+        };
+
+        // A reference to the recorder is saved internally.
+        LoadClient(const Configuration& conf, LatencyRecorder& recorder);
+        // Closes the sessions.
+        virtual ~LoadClient();
+
+        // Opens the sessions and subscribes the nodes in each session.
+        virtual void open(const std::vector<const UaNodeId*>& nodeIds)
+        /* throws MutexException, HaSessionException, HaSubscriptionException */;
+        virtual void close();
+        // Returns the count of changes of the connection states of the sessions to a state
+        // other than "connected" (e.g. due to watchdog timeouts).
+        virtual unsigned long getConnectionErrorCount();
+    private:
+        LoadClient(const LoadClient& orig);
+        LoadClient& operator=(const LoadClient&);
+
+        class SessionCallback : public HaSession::HaSessionCallback {
+        public:
+            SessionCallback(LatencyRecorder& recorder);
+
+            virtual void dataChanged(std::vector<NodeAttributes*>& nodeAttributes);
+            virtual void newEvents(std::vector<const BinaryServerNamespace::Event*>& events);
+            virtual void connectionStateChanged(int state);
+
+            unsigned long connectionErrorCount;
+        private:
+            LatencyRecorder* recorder;
+        };
+
+        HaSession::Configuration sessionConf;
+        int sessionCount;
+        SessionCallback callback;
+        std::vector<HaSession*> sessions;
+    };
+} // namespace LoadNamespace
+#endif /* LOAD_LOADCLIENT_H */
@@ -0,0 +1,153 @@
+#include "LatencyRecorder.h"
+#include "LoadClient.h"
+#include <common/Exception.h>
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <config.h> // SERVER_VERSION
+#include <uanodeid.h> // UaNodeId
+#include <uaplatformlayer.h> // UaPlatformLayer
+#include <uastring.h> // UaString
+#include <xmldocument.h> // UaXmlDocument
+#include <stdlib.h> // atoi
+#include <string.h> // strncmp
+#include <unistd.h> // sleep
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace LoadNamespace;
+
+// Usage: ServerLoadClient --nodeIds=<file> [--host=<host>] [--port=<port>] [--sessions=<N>]
+//                         [--monitoredItems=<M>] [--publishingInterval=<ms>] [--warmUp=<s>]
+//                         [--duration=<s>] [--format=json|csv] [--output=<file>]
+// Opens N sessions to the server and subscribes the first M node ids of the file in each
+// session. The file contains a node id per line in XML notation (e.g. "ns=2;i=6001"). Empty
+// lines and lines starting with '#' are ignored.
+// The notifications received within the warm up time are ignored. The results of the
+// measurement are written to stdout if no output file is specified. The progress is written
+// to stderr.
+
+static const char* getOption(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    return strncmp(arg, name, length) == 0 ? arg + length : NULL;
+}
+
+static bool readNodeIds(const std::string& file, int maxCount,
+        std::vector<const UaNodeId*>& returnNodeIds) {
+    std::ifstream in(file.c_str());
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line) && (maxCount <= 0 || returnNodeIds.size() < maxCount)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        returnNodeIds.push_back(new UaNodeId(
+                UaNodeId::fromXmlString(UaString(line.substr(start).c_str()))));
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    LoadClient::Configuration conf;
+    std::string nodeIdsFile;
+    int monitoredItemCount = 0;
+    int warmUp = 5;
+    int duration = 30;
+    LatencyRecorder::Format format = LatencyRecorder::JSON;
+    std::string outputFile;
+    for (int i = 1; i < argc; i++) {
+        const char* value;
+        if ((value = getOption(argv[i], "--nodeIds=")) != NULL) {
+            nodeIdsFile = value;
+        } else if ((value = getOption(argv[i], "--host=")) != NULL) {
+            conf.host = value;
+        } else if ((value = getOption(argv[i], "--port=")) != NULL) {
+            conf.port = atoi(value);
+        } else if ((value = getOption(argv[i], "--sessions=")) != NULL) {
+            conf.sessionCount = atoi(value);
+        } else if ((value = getOption(argv[i], "--monitoredItems=")) != NULL) {
+            monitoredItemCount = atoi(value);
+        } else if ((value = getOption(argv[i], "--publishingInterval=")) != NULL) {
+            conf.publishingInterval = atoi(value);
+        } else if ((value = getOption(argv[i], "--warmUp=")) != NULL) {
+            warmUp = atoi(value);
+        } else if ((value = getOption(argv[i], "--duration=")) != NULL) {
+            duration = atoi(value);
+        } else if ((value = getOption(argv[i], "--format=")) != NULL) {
+            format = strcmp(value, "csv") == 0 ? LatencyRecorder::CSV : LatencyRecorder::JSON;
+        } else if ((value = getOption(argv[i], "--output=")) != NULL) {
+            outputFile = value;
+        } else {
+            nodeIdsFile.clear();
+            break;
+        }
+    }
+    if (nodeIdsFile.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --nodeIds=<file> [--host=<host>] [--port=<port>]"
+                << " [--sessions=<N>] [--monitoredItems=<M>] [--publishingInterval=<ms>]"
+                << " [--warmUp=<s>] [--duration=<s>] [--format=json|csv] [--output=<file>]"
+                << std::endl;
+        return 1;
+    }
+    std::vector<const UaNodeId*> nodeIds;
+    if (!readNodeIds(nodeIdsFile, monitoredItemCount, nodeIds) || nodeIds.size() == 0) {
+        std::cerr << "Cannot read node ids from " << nodeIdsFile << std::endl;
+        return 1;
+    }
+    if (monitoredItemCount > nodeIds.size()) {
+        std::cerr << "Only " << nodeIds.size() << " node ids found in " << nodeIdsFile
+                << std::endl;
+    }
+
+    ConsoleLoggerFactory clf;
+    LoggerFactory lf(clf);
+    UaXmlDocument::initParser();
+    UaPlatformLayer::init();
+    int ret = 0;
+    {
+        LatencyRecorder recorder;
+        LoadClient client(conf, recorder);
+        try {
+            std::cerr << "Opening " << conf.sessionCount << " sessions with "
+                    << nodeIds.size() << " monitored items" << std::endl;
+            client.open(nodeIds); // MutexException, HaSessionException, HaSubscriptionException
+            std::cerr << "Warming up for " << warmUp << "s" << std::endl;
+            sleep(warmUp);
+            recorder.reset();
+            std::cerr << "Measuring for " << duration << "s" << std::endl;
+            sleep(duration);
+            LatencyRecorder::Statistics statistics = recorder.getStatistics();
+            if (client.getConnectionErrorCount() > 0) {
+                std::cerr << "Connection errors: " << client.getConnectionErrorCount()
+                        << std::endl;
+            }
+            if (outputFile.empty()) {
+                LatencyRecorder::write(std::cout, SERVER_VERSION, conf.sessionCount,
+                        nodeIds.size(), statistics, format);
+            } else {
+                std::ofstream out(outputFile.c_str());
+                LatencyRecorder::write(out, SERVER_VERSION, conf.sessionCount, nodeIds.size(),
+                        statistics, format);
+            }
+        } catch (Exception& e) {
+            std::string st;
+            e.getStackTrace(st);
+            std::cerr << "Load test failed: " << st << std::endl;
+            ret = 1;
+        }
+        client.close();
+    }
+    UaPlatformLayer::cleanup();
+    UaXmlDocument::cleanupParser();
+
+    for (size_t i = 0; i < nodeIds.size(); i++) {
+        delete nodeIds[i];
+    }
+    return ret;
+}
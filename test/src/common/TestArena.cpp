@@ -0,0 +1,119 @@
+#include "CppUTest/TestHarness.h"
+#include <common/Arena.h>
+#include <common/ArenaObject.h>
+#include <common/ArenaScope.h>
+#include <stdint.h> // uintptr_t
+
+using namespace CommonNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(Common_Arena) {
+
+        class Value : public ArenaObject {
+        public:
+
+            Value(long long value) {
+                this->value = value;
+            }
+
+            long long value;
+        };
+    };
+
+    TEST(Common_Arena, Allocate) {
+        Arena arena(1024 /* blockSize */);
+        // aligned allocations
+        char* p1 = static_cast<char*> (arena.allocate(1));
+        char* p2 = static_cast<char*> (arena.allocate(17));
+        char* p3 = static_cast<char*> (arena.allocate(8));
+        CHECK_EQUAL(0, reinterpret_cast<uintptr_t> (p1) % 16);
+        CHECK_EQUAL(16, p2 - p1);
+        CHECK_EQUAL(48, p3 - p1);
+        CHECK_EQUAL(64, arena.getUsedBytes());
+        Arena::Metrics metrics = arena.getMetrics();
+        CHECK_EQUAL(3, metrics.allocationCount);
+        CHECK_EQUAL(64, metrics.allocatedBytes);
+        CHECK_EQUAL(1, metrics.blockAllocationCount);
+
+        // fill the first block => a second block is allocated
+        arena.allocate(1024 - 64);
+        CHECK_EQUAL(1, arena.getMetrics().blockAllocationCount);
+        arena.allocate(1);
+        CHECK_EQUAL(2, arena.getMetrics().blockAllocationCount);
+        // large allocation => own block
+        arena.allocate(4096);
+        CHECK_EQUAL(3, arena.getMetrics().blockAllocationCount);
+        // the remaining memory of the second block is still used
+        arena.allocate(16);
+        CHECK_EQUAL(3, arena.getMetrics().blockAllocationCount);
+        CHECK_EQUAL(1024 + 16 + 4096 + 16, arena.getUsedBytes());
+
+        // reset: the first block is reused
+        arena.reset();
+        CHECK_EQUAL(0, arena.getUsedBytes());
+        CHECK_TRUE(p1 == arena.allocate(1));
+        metrics = arena.getMetrics();
+        CHECK_EQUAL(3, metrics.blockAllocationCount);
+        CHECK_EQUAL(1, metrics.resetCount);
+        CHECK_EQUAL(1024 + 16 + 4096 + 16, metrics.maxUsedBytes);
+    }
+
+    TEST(Common_Arena, Scope) {
+        // no active scope => heap
+        POINTERS_EQUAL(NULL, Arena::getCurrent());
+        Value* heapValue = new Value(1);
+
+        Arena arena;
+        {
+            ArenaScope scope(arena);
+            POINTERS_EQUAL(&arena, Arena::getCurrent());
+            Value* value = new Value(2);
+            CHECK_EQUAL(1, arena.getMetrics().allocationCount);
+            {
+                // nested scope for the same arena
+                ArenaScope nestedScope(arena);
+                Value* nestedValue = new Value(3);
+                delete nestedValue;
+            }
+            // the arena has not been reset
+            CHECK_EQUAL(0, arena.getMetrics().resetCount);
+            CHECK_EQUAL(2, value->value);
+            CHECK_EQUAL(2, arena.getMetrics().allocationCount);
+            {
+                // nested scope for another arena
+                Arena arena2;
+                ArenaScope nestedScope(arena2);
+                Value* nestedValue = new Value(4);
+                delete nestedValue;
+                CHECK_EQUAL(1, arena2.getMetrics().allocationCount);
+            }
+            POINTERS_EQUAL(&arena, Arena::getCurrent());
+            // a heap value can be deleted in the scope
+            delete heapValue;
+            delete value;
+        }
+        POINTERS_EQUAL(NULL, Arena::getCurrent());
+        CHECK_EQUAL(1, arena.getMetrics().resetCount);
+        CHECK_EQUAL(0, arena.getUsedBytes());
+    }
+
+    TEST(Common_Arena, Reuse) {
+        Arena arena;
+        Value* values[100];
+        for (int i = 0; i < 1000; i++) {
+            ArenaScope scope(arena);
+            for (int j = 0; j < 100; j++) {
+                values[j] = new Value(j);
+            }
+            for (int j = 0; j < 100; j++) {
+                delete values[j];
+            }
+        }
+        Arena::Metrics metrics = arena.getMetrics();
+        CHECK_EQUAL(1000 * 100, metrics.allocationCount);
+        CHECK_EQUAL(1000, metrics.resetCount);
+        // one block is allocated and reused for all requests
+        CHECK_EQUAL(1, metrics.blockAllocationCount);
+    }
+}
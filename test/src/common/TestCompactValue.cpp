@@ -0,0 +1,79 @@
+#include "CppUTest/TestHarness.h"
+#include <common/CompactValue.h>
+#include <string.h> // memcmp, memset
+
+using namespace CommonNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(Common_CompactValue) {
+    };
+
+    TEST(Common_CompactValue, Numeric) {
+        CompactValue value;
+        CHECK_TRUE(value.isNull());
+        POINTERS_EQUAL(NULL, value.getBytes());
+        value.setNumeric().llongValue = -5;
+        CHECK_TRUE(value.isNumeric());
+        CompactValue copy(value);
+        CHECK_EQUAL(-5, copy.getNumeric().llongValue);
+        POINTERS_EQUAL(NULL, copy.getBytes());
+        copy.clear();
+        CHECK_TRUE(copy.isNull());
+    }
+
+    TEST(Common_CompactValue, Bytes) {
+        // empty byte sequence
+        CompactValue value;
+        value.setBytes("", 0);
+        CHECK_FALSE(value.isNull());
+        CHECK_TRUE(value.getBytes() != NULL);
+        CHECK_EQUAL(0, value.getLength());
+        // NULL
+        value.setBytes(NULL, 0);
+        CHECK_TRUE(value.isNull());
+
+        // inline value
+        const char* shortBytes = "012345678901234567890123";
+        value.setBytes(shortBytes, CompactValue::INLINE_CAPACITY);
+        CompactValue copy(value);
+        CHECK_TRUE(copy.getBytes() != value.getBytes());
+        CHECK_TRUE(copy.equalBytes(shortBytes, CompactValue::INLINE_CAPACITY));
+        CHECK_FALSE(copy.equalBytes(shortBytes, 3));
+        CHECK_FALSE(copy.equalBytes(NULL, 0));
+
+        // shared buffer
+        const char* longBytes = "0123456789012345678901234";
+        value.setBytes(longBytes, 25);
+        copy = value;
+        POINTERS_EQUAL(value.getBytes(), copy.getBytes());
+        CHECK_EQUAL(25, copy.getLength());
+        // the buffer is released with the last instance
+        value.clear();
+        CHECK_EQUAL(0, memcmp(longBytes, copy.getBytes(), 25));
+        copy = copy;
+        CHECK_TRUE(copy.equalBytes(longBytes, 25));
+        // replace the buffer with a numeric value
+        copy.setNumeric().intValue = 3;
+        POINTERS_EQUAL(NULL, copy.getBytes());
+    }
+
+    TEST(Common_CompactValue, AttachedBytes) {
+        char* bytes = new char[30];
+        memset(bytes, 'x', 30);
+        CompactValue value;
+        value.attachBytes(bytes, 30);
+        // the bytes are not copied
+        POINTERS_EQUAL(bytes, value.getBytes());
+        CHECK_EQUAL(30, value.getLength());
+        // a copy gets its own storage
+        CompactValue copy(value);
+        CHECK_TRUE(copy.getBytes() != bytes);
+        CHECK_TRUE(copy.equalBytes(bytes, 30));
+        // the attached bytes are destroyed with the value
+        value.setNumeric().intValue = 1;
+        CHECK_EQUAL(30, copy.getLength());
+        value.attachBytes(NULL, 0);
+        CHECK_TRUE(value.isNull());
+    }
+}
@@ -0,0 +1,217 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ILoggerFactory.h>
+#include <common/logging/LogThrottle.h>
+#include <common/logging/Logger.h>
+#include <common/logging/LoggerFactory.h>
+#include <stdio.h> // sprintf
+#include <time.h> // clock_gettime
+#include <string>
+
+using namespace CommonNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(CommonLogging_LogThrottle) {
+
+        class LoggerImpl : public Logger {
+        public:
+
+            LoggerImpl() {
+                errorCount = 0;
+                warnCount = 0;
+            }
+
+            virtual void error(const char* format, ...) {
+                errorCount++;
+            }
+
+            virtual void warn(const char* format, ...) {
+                warnCount++;
+            }
+
+            virtual void info(const char* format, ...) {
+            }
+
+            virtual void debug(const char* format, ...) {
+            }
+
+            virtual void trace(const char* format, ...) {
+            }
+
+            virtual bool isErrorEnabled() {
+                return true;
+            }
+
+            virtual bool isWarnEnabled() {
+                return true;
+            }
+
+            virtual bool isInfoEnabled() {
+                return true;
+            }
+
+            virtual bool isDebugEnabled() {
+                return true;
+            }
+
+            virtual bool isTraceEnabled() {
+                return true;
+            }
+
+            int errorCount;
+            int warnCount;
+        };
+
+        class ILoggerFactoryImpl : public ILoggerFactory {
+        public:
+
+            ILoggerFactoryImpl(Logger& log) {
+                this->log = &log;
+            }
+
+            virtual Logger* getLogger(const char* name) {
+                return log;
+            }
+        private:
+            Logger* log;
+        };
+    };
+
+    TEST(CommonLogging_LogThrottle, Pass) {
+        LoggerImpl log;
+        LogThrottle::Configuration conf;
+        conf.maxBurst = 3;
+        conf.messagesPerSecond = 1;
+        conf.summaryInterval = 60000;
+        LogThrottle* throttle = new LogThrottle(log, conf);
+        // a burst of similar messages passes
+        for (int i = 0; i < 3; i++) {
+            CHECK_TRUE(throttle->pass("Cannot read %s", "n1"));
+        }
+        // further similar messages are suppressed
+        CHECK_FALSE(throttle->pass("Cannot read %s", "n1"));
+        CHECK_FALSE(throttle->pass("Cannot read %s", "n1"));
+        // messages for other nodes or with other templates are not affected
+        CHECK_TRUE(throttle->pass("Cannot read %s", "n2"));
+        CHECK_TRUE(throttle->pass("Cannot write %s", "n1"));
+        LogThrottle::Metrics metrics = throttle->getMetrics();
+        CHECK_EQUAL(5, metrics.passedCount);
+        CHECK_EQUAL(2, metrics.suppressedCount);
+        CHECK_EQUAL(0, metrics.summaryCount);
+        CHECK_EQUAL(0, log.warnCount);
+
+        // the summary of the suppressed messages is logged
+        throttle->flush();
+        CHECK_EQUAL(1, log.warnCount);
+        CHECK_EQUAL(1, throttle->getMetrics().summaryCount);
+        throttle->flush();
+        CHECK_EQUAL(1, log.warnCount);
+
+        // throttling is disabled
+        conf.messagesPerSecond = 0;
+        throttle->setConfiguration(conf);
+        for (int i = 0; i < 10; i++) {
+            CHECK_TRUE(throttle->pass("Cannot read %s", "n1"));
+        }
+        delete throttle;
+        CHECK_EQUAL(1, log.warnCount);
+    }
+
+    TEST(CommonLogging_LogThrottle, SummaryInterval) {
+        LoggerImpl log;
+        LogThrottle::Configuration conf;
+        conf.maxBurst = 1;
+        conf.messagesPerSecond = 0.001;
+        conf.summaryInterval = 0;
+        LogThrottle throttle(log, conf);
+        CHECK_TRUE(throttle.pass("Cannot read %s", "n1"));
+        // the suppressed message is reported with the next call after the summary interval
+        CHECK_FALSE(throttle.pass("Cannot read %s", "n1"));
+        CHECK_EQUAL(1, log.warnCount);
+        CHECK_FALSE(throttle.pass("Cannot read %s", "n1"));
+        CHECK_EQUAL(2, log.warnCount);
+    }
+
+    TEST(CommonLogging_LogThrottle, LoggerFactory) {
+        CHECK_TRUE(NULL == LoggerFactory::getLogThrottle("a"));
+        LoggerImpl log;
+        ILoggerFactoryImpl ilf(log);
+        LoggerFactory* lf = new LoggerFactory(ilf);
+        LogThrottle::Configuration defaultConf;
+        defaultConf.maxBurst = 1;
+        LoggerFactory::setLogThrottle("", defaultConf);
+        LogThrottle::Configuration conf;
+        conf.maxBurst = 2;
+        LoggerFactory::setLogThrottle("b", conf);
+        // the throttles are created once per logger
+        LogThrottle* a = LoggerFactory::getLogThrottle("a");
+        LogThrottle* b = LoggerFactory::getLogThrottle("b");
+        CHECK_TRUE(a == LoggerFactory::getLogThrottle("a"));
+        CHECK_TRUE(a != b);
+        // logger "a" uses the default configuration
+        CHECK_TRUE(a->pass("x"));
+        CHECK_FALSE(a->pass("x"));
+        CHECK_TRUE(b->pass("x"));
+        CHECK_TRUE(b->pass("x"));
+        CHECK_FALSE(b->pass("x"));
+        // update the default configuration of existing throttles
+        defaultConf.messagesPerSecond = 0;
+        LoggerFactory::setLogThrottle("", defaultConf);
+        CHECK_TRUE(a->pass("x"));
+        CHECK_FALSE(b->pass("x"));
+
+        // the throttles are kept if a further logger factory implementation is activated
+        // (the summaries are logged with the logger of the previous implementation)
+        LoggerImpl log2;
+        ILoggerFactoryImpl ilf2(log2);
+        LoggerFactory* lf2 = new LoggerFactory(ilf2);
+        CHECK_EQUAL(2, log.warnCount);
+        CHECK_TRUE(a == LoggerFactory::getLogThrottle("a"));
+        CHECK_TRUE(b == LoggerFactory::getLogThrottle("b"));
+        CHECK_FALSE(b->pass("x"));
+        // the summaries are logged with the logger of the active implementation
+        delete lf2;
+        CHECK_EQUAL(1, log2.warnCount);
+        CHECK_TRUE(b == LoggerFactory::getLogThrottle("b"));
+        CHECK_FALSE(b->pass("x"));
+
+        // the summaries are logged when the logging is deactivated
+        delete lf;
+        CHECK_EQUAL(3, log.warnCount);
+        CHECK_TRUE(NULL == LoggerFactory::getLogThrottle("a"));
+    }
+
+    TEST(CommonLogging_LogThrottle, Outage) {
+        LoggerImpl log;
+        LogThrottle::Configuration conf;
+        LogThrottle throttle(log, conf);
+        const int nodeCount = 100;
+        char nodes[nodeCount][16];
+        for (int i = 0; i < nodeCount; i++) {
+            sprintf(nodes[i], "ns=1;i=%d", i);
+        }
+        // simulate an outage: each read of each node fails
+        int readCount = 1000;
+        timespec start, end;
+        clock_gettime(CLOCK_REALTIME, &start);
+        for (int r = 0; r < readCount; r++) {
+            for (int i = 0; i < nodeCount; i++) {
+                if (throttle.pass("Cannot read value of node %s: %s", nodes[i])) {
+                    log.error("Cannot read value of node %s: %s", nodes[i], "timeout");
+                }
+            }
+        }
+        clock_gettime(CLOCK_REALTIME, &end);
+        throttle.flush();
+        long duration = (end.tv_sec - start.tv_sec) * 1000000
+                + (end.tv_nsec - start.tv_nsec) / 1000;
+        // the count of logged messages per node is bounded by the burst size and the
+        // messages which are allowed by the rate during the outage
+        CHECK_TRUE(log.errorCount <= nodeCount
+                * (conf.maxBurst + 1 + duration * conf.messagesPerSecond / 1000000));
+        // a summary is logged per node
+        CHECK_EQUAL(nodeCount, log.warnCount);
+        LogThrottle::Metrics metrics = throttle.getMetrics();
+        CHECK_EQUAL(readCount * nodeCount, metrics.passedCount + metrics.suppressedCount);
+    }
+}
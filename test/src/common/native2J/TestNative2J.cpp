@@ -0,0 +1,239 @@
+#include "CppUTest/TestHarness.h"
+#include "../../../../src/common/native2J/Native2J.h"
+#include <opcua_identifiers.h> // OpcUaId_Float
+#include <jni.h>
+#include <stddef.h> // NULL
+#include <string.h> // memset, strcmp
+#include <string>
+
+namespace TestNamespace {
+
+    TEST_GROUP(Common_Native2J) {
+
+        // A Java class. Only the classes in "classes" are known.
+        class FakeClass : public _jclass {
+        public:
+            const char* name;
+        };
+
+        // An instance of a Java box class with its value.
+        class FakeObject : public _jobject {
+        public:
+
+            FakeObject(const char* className, double value) {
+                this->className = className;
+                this->value = value;
+            }
+
+            const char* className;
+            double value;
+        };
+
+        class FakeMethod {
+        public:
+            const char* name;
+            const char* signature;
+        };
+
+        // A JNI environment which provides the functions used to read the values of Java box
+        // classes. The calls of the value methods are recorded in "calls" like
+        // "CallByteMethod byteValue()B;".
+        class FakeJNIEnv {
+        public:
+            // must be the first member (see get)
+            JNIEnv env;
+            JNINativeInterface_ functions;
+            FakeClass classes[10];
+            FakeMethod methods[16];
+            int methodCount;
+            std::string calls;
+
+            FakeJNIEnv() {
+                memset(&functions, 0, sizeof (functions));
+                functions.FindClass = &findClass;
+                functions.IsInstanceOf = &isInstanceOf;
+                functions.GetMethodID = &getMethodID;
+                functions.GetJavaVM = &getJavaVM;
+                functions.NewGlobalRef = &newGlobalRef;
+                functions.DeleteLocalRef = &deleteLocalRef;
+                functions.CallBooleanMethodV = &callBooleanMethod;
+                functions.CallCharMethodV = &callCharMethod;
+                functions.CallByteMethodV = &callByteMethod;
+                functions.CallShortMethodV = &callShortMethod;
+                functions.CallIntMethodV = &callIntMethod;
+                functions.CallLongMethodV = &callLongMethod;
+                functions.CallFloatMethodV = &callFloatMethod;
+                functions.CallDoubleMethodV = &callDoubleMethod;
+                env.functions = &functions;
+                const char* classNames[] = {"java/lang/Boolean", "java/lang/Character",
+                    "java/lang/Byte", "java/lang/Short", "java/lang/Integer", "java/lang/Long",
+                    "java/lang/Float", "java/lang/Double", "java/lang/Number",
+                    "havis/util/opcua/MessageHandler"};
+                for (int i = 0; i < 10; i++) {
+                    classes[i].name = classNames[i];
+                }
+                methodCount = 0;
+            }
+
+            static FakeJNIEnv& get(JNIEnv* env) {
+                return *reinterpret_cast<FakeJNIEnv*> (env);
+            }
+
+            static jclass findClass(JNIEnv* env, const char* name) {
+                FakeJNIEnv& fake = get(env);
+                for (int i = 0; i < 10; i++) {
+                    if (strcmp(fake.classes[i].name, name) == 0) {
+                        return &fake.classes[i];
+                    }
+                }
+                return NULL;
+            }
+
+            // The numeric box classes are sub classes of java.lang.Number.
+            static jboolean isInstanceOf(JNIEnv* env, jobject obj, jclass clazz) {
+                const char* className = static_cast<FakeObject*> (obj)->className;
+                const char* name = static_cast<FakeClass*> (clazz)->name;
+                if (strcmp(className, name) == 0) {
+                    return JNI_TRUE;
+                }
+                return strcmp(name, "java/lang/Number") == 0
+                        && strcmp(className, "java/lang/Boolean") != 0
+                        && strcmp(className, "java/lang/Character") != 0;
+            }
+
+            static jmethodID getMethodID(JNIEnv* env, jclass clazz, const char* name,
+                    const char* signature) {
+                FakeJNIEnv& fake = get(env);
+                FakeMethod& method = fake.methods[fake.methodCount++];
+                method.name = name;
+                method.signature = signature;
+                return reinterpret_cast<jmethodID> (&method);
+            }
+
+            static jint getJavaVM(JNIEnv* env, JavaVM** vm) {
+                *vm = NULL;
+                return JNI_OK;
+            }
+
+            static jobject newGlobalRef(JNIEnv* env, jobject obj) {
+                return obj;
+            }
+
+            static void deleteLocalRef(JNIEnv* env, jobject obj) {
+            }
+
+            // Records the call of a value method and returns the value of the object.
+            static double call(JNIEnv* env, const char* callName, jobject obj,
+                    jmethodID methodID) {
+                FakeMethod* method = reinterpret_cast<FakeMethod*> (methodID);
+                get(env).calls.append(callName).append(" ").append(method->name)
+                        .append(method->signature).append(";");
+                return static_cast<FakeObject*> (obj)->value;
+            }
+
+            static jboolean callBooleanMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return call(env, "CallBooleanMethod", obj, method) != 0;
+            }
+
+            static jchar callCharMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return static_cast<jchar> (call(env, "CallCharMethod", obj, method));
+            }
+
+            static jbyte callByteMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return static_cast<jbyte> (call(env, "CallByteMethod", obj, method));
+            }
+
+            static jshort callShortMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return static_cast<jshort> (call(env, "CallShortMethod", obj, method));
+            }
+
+            static jint callIntMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return static_cast<jint> (call(env, "CallIntMethod", obj, method));
+            }
+
+            static jlong callLongMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return static_cast<jlong> (call(env, "CallLongMethod", obj, method));
+            }
+
+            static jfloat callFloatMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return static_cast<jfloat> (call(env, "CallFloatMethod", obj, method));
+            }
+
+            static jdouble callDoubleMethod(JNIEnv* env, jobject obj, jmethodID method,
+                    va_list args) {
+                return call(env, "CallDoubleMethod", obj, method);
+            }
+        };
+    };
+
+    TEST(Common_Native2J, GuessScalar) {
+        FakeJNIEnv fake;
+        Native2J native2j(&fake.env, NULL /* handler */);
+        ModelType unknownType;
+
+        // the value of each box class is read with the value method of the class
+        FakeObject byteValue("java/lang/Byte", -2);
+        fake.calls.clear();
+        Scalar* scalar = native2j.getScalarVariant(&fake.env, &byteValue, unknownType);
+        CHECK_EQUAL(Scalar::BYTE, scalar->getScalarType());
+        CHECK_EQUAL(-2, scalar->getByte());
+        STRCMP_EQUAL("CallByteMethod byteValue()B;", fake.calls.c_str());
+        delete scalar;
+
+        FakeObject shortValue("java/lang/Short", -300);
+        fake.calls.clear();
+        scalar = native2j.getScalarVariant(&fake.env, &shortValue, unknownType);
+        CHECK_EQUAL(Scalar::SHORT, scalar->getScalarType());
+        CHECK_EQUAL(-300, scalar->getShort());
+        STRCMP_EQUAL("CallShortMethod shortValue()S;", fake.calls.c_str());
+        delete scalar;
+
+        FakeObject longValue("java/lang/Long", 5000000000.0);
+        fake.calls.clear();
+        scalar = native2j.getScalarVariant(&fake.env, &longValue, unknownType);
+        CHECK_EQUAL(Scalar::LONG, scalar->getScalarType());
+        CHECK_TRUE(5000000000LL == scalar->getLong());
+        STRCMP_EQUAL("CallLongMethod longValue()J;", fake.calls.c_str());
+        delete scalar;
+
+        FakeObject floatValue("java/lang/Float", 1.5);
+        fake.calls.clear();
+        scalar = native2j.getScalarVariant(&fake.env, &floatValue, unknownType);
+        CHECK_EQUAL(Scalar::FLOAT, scalar->getScalarType());
+        DOUBLES_EQUAL(1.5, scalar->getFloat(), 0);
+        STRCMP_EQUAL("CallFloatMethod floatValue()F;", fake.calls.c_str());
+        delete scalar;
+    }
+
+    TEST(Common_Native2J, ScalarOfModelType) {
+        FakeJNIEnv fake;
+        Native2J native2j(&fake.env, NULL /* handler */);
+
+        // an integer is read as float via java.lang.Number
+        ModelType floatType;
+        floatType.t = OpcUaId_Float;
+        FakeObject intValue("java/lang/Integer", 3);
+        fake.calls.clear();
+        Scalar* scalar = native2j.getScalarVariant(&fake.env, &intValue, floatType);
+        CHECK_EQUAL(Scalar::FLOAT, scalar->getScalarType());
+        DOUBLES_EQUAL(3, scalar->getFloat(), 0);
+        STRCMP_EQUAL("CallFloatMethod floatValue()F;", fake.calls.c_str());
+        delete scalar;
+
+        // a boolean is not a number => the scalar type is guessed
+        FakeObject boolValue("java/lang/Boolean", 1);
+        fake.calls.clear();
+        scalar = native2j.getScalarVariant(&fake.env, &boolValue, floatType);
+        CHECK_EQUAL(Scalar::BOOLEAN, scalar->getScalarType());
+        CHECK_TRUE(scalar->getBoolean());
+        STRCMP_EQUAL("CallBooleanMethod booleanValue()Z;", fake.calls.c_str());
+        delete scalar;
+    }
+} // namespace TestNamespace
@@ -0,0 +1,218 @@
+#ifndef TEST_IODATAPROVIDER_IODATAPROVIDERSTUB_H
+#define TEST_IODATAPROVIDER_IODATAPROVIDERSTUB_H
+
+#include <common/Exception.h>
+#include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/MethodData.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/NodeProperties.h>
+#include <ioDataProvider/Scalar.h>
+#include <pthread.h> // pthread_mutex_t
+#include <stddef.h> // NULL
+#include <string>
+#include <time.h> // nanosleep
+#include <vector>
+
+namespace TestNamespace {
+
+    // A scalar which counts the copies of itself and its copies.
+    class CountedScalar : public IODataProviderNamespace::Scalar {
+    public:
+
+        CountedScalar(int& copyCount) {
+            this->copyCount = &copyCount;
+        }
+
+        CountedScalar(const CountedScalar& orig) : IODataProviderNamespace::Scalar(orig) {
+            copyCount = orig.copyCount;
+        }
+
+        virtual IODataProviderNamespace::Variant* copy() const {
+            (*copyCount)++;
+            return new CountedScalar(*this);
+        }
+    private:
+        int* copyCount;
+    };
+
+    // An IO data provider for tests which records the calls. Reads and subscriptions return
+    // a long value with the numeric part of the node id for each node (see createResults and
+    // createValue). Tests derive from this class for a different behaviour.
+    // The recording is thread safe.
+    class IODataProviderStub : public IODataProviderNamespace::IODataProvider {
+    public:
+        // delay of each read in milliseconds
+        long delay;
+        // reads, writes and subscriptions throw an IODataProviderException after they have been
+        // recorded
+        bool fail;
+
+        // protects the recorded calls
+        pthread_mutex_t mutex;
+        // the count of nodes per read
+        std::vector<int> readSizes;
+        // the read node ids (see NodeId::toString)
+        std::vector<std::string> readNodeIds;
+        // the count of values per write
+        std::vector<int> writeSizes;
+        // the written long values
+        std::vector<long> writtenValues;
+        // the numeric parts of the node ids per subscription
+        std::vector<std::vector<long> > subscribeCalls;
+        std::vector<std::vector<long> > unsubscribeCalls;
+        int notificationCount;
+        int eventCount;
+
+        IODataProviderStub() {
+            delay = 0;
+            fail = false;
+            notificationCount = 0;
+            eventCount = 0;
+            pthread_mutex_init(&mutex, NULL /*attr*/);
+        }
+
+        virtual ~IODataProviderStub() {
+            pthread_mutex_destroy(&mutex);
+        }
+
+        std::vector<int> getReadSizes() {
+            pthread_mutex_lock(&mutex);
+            std::vector<int> ret = readSizes;
+            pthread_mutex_unlock(&mutex);
+            return ret;
+        }
+
+        virtual void open(const std::string& confDir) {
+        }
+
+        virtual void open(JNIEnv *env, jobject properties, jobject dataProvider) {
+        }
+
+        virtual void close() {
+        }
+
+        virtual const IODataProviderNamespace::NodeProperties* getDefaultNodeProperties(
+                const std::string& namespaceUri, int namespaceId) {
+            return NULL;
+        }
+
+        virtual std::vector<const IODataProviderNamespace::NodeData*>* getNodeProperties(
+                const std::string& namespaceUri, int namespaceId) {
+            return NULL;
+        }
+
+        virtual std::vector<IODataProviderNamespace::NodeData*>* read(
+                const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds) {
+            pthread_mutex_lock(&mutex);
+            readSizes.push_back(nodeIds.size());
+            for (size_t i = 0; i < nodeIds.size(); i++) {
+                readNodeIds.push_back(nodeIds[i]->toString());
+            }
+            pthread_mutex_unlock(&mutex);
+            if (delay > 0) {
+                timespec t;
+                t.tv_sec = 0;
+                t.tv_nsec = delay * 1000000;
+                nanosleep(&t, NULL);
+            }
+            if (fail) {
+                throw ExceptionDef(IODataProviderNamespace::IODataProviderException,
+                        std::string("read failed"));
+            }
+            return createResults(nodeIds);
+        }
+
+        virtual void write(const std::vector<const IODataProviderNamespace::NodeData*>& nodeData,
+                bool sendValuesChangedEvents) {
+            pthread_mutex_lock(&mutex);
+            writeSizes.push_back(nodeData.size());
+            for (size_t i = 0; i < nodeData.size(); i++) {
+                writtenValues.push_back(static_cast<const IODataProviderNamespace::Scalar*> (
+                        nodeData[i]->getData())->getLong());
+            }
+            pthread_mutex_unlock(&mutex);
+            if (fail) {
+                throw ExceptionDef(IODataProviderNamespace::IODataProviderException,
+                        std::string("write failed"));
+            }
+        }
+
+        virtual std::vector<IODataProviderNamespace::MethodData*>* call(
+                const std::vector<const IODataProviderNamespace::MethodData*>& methodData) {
+            return new std::vector<IODataProviderNamespace::MethodData*>();
+        }
+
+        virtual std::vector<IODataProviderNamespace::NodeData*>* subscribe(
+                const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds,
+                IODataProviderNamespace::SubscriberCallback& callback) {
+            pthread_mutex_lock(&mutex);
+            subscribeCalls.push_back(getNumericIds(nodeIds));
+            pthread_mutex_unlock(&mutex);
+            if (fail) {
+                throw ExceptionDef(IODataProviderNamespace::IODataProviderException,
+                        std::string("subscribe failed"));
+            }
+            return createResults(nodeIds);
+        }
+
+        virtual void unsubscribe(
+                const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds) {
+            pthread_mutex_lock(&mutex);
+            unsubscribeCalls.push_back(getNumericIds(nodeIds));
+            pthread_mutex_unlock(&mutex);
+        }
+
+        virtual void notification(JNIEnv *env, int ns, jobject id, jobject value) {
+            pthread_mutex_lock(&mutex);
+            notificationCount++;
+            pthread_mutex_unlock(&mutex);
+        }
+
+        virtual void event(JNIEnv *env, int eNs, jobject event, int pNs, jobject param,
+                long timestamp, int severity, jstring msg, jobject value) {
+            pthread_mutex_lock(&mutex);
+            eventCount++;
+            pthread_mutex_unlock(&mutex);
+        }
+
+        virtual void setNodeBrowser(SASModelProviderNamespace::NodeBrowser* nodeBrowser) {
+        }
+    protected:
+
+        // Creates the results of a read or a subscription in the order of the request.
+        // The node ids are copied.
+        virtual std::vector<IODataProviderNamespace::NodeData*>* createResults(
+                const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds) {
+            std::vector<IODataProviderNamespace::NodeData*>* ret =
+                    new std::vector<IODataProviderNamespace::NodeData*>();
+            for (size_t i = 0; i < nodeIds.size(); i++) {
+                ret->push_back(new IODataProviderNamespace::NodeData(
+                        *new IODataProviderNamespace::NodeId(*nodeIds[i]),
+                        createValue(*nodeIds[i]), true /* attachValues */));
+            }
+            return ret;
+        }
+
+        // Creates the value of a node.
+        virtual IODataProviderNamespace::Scalar* createValue(
+                const IODataProviderNamespace::NodeId& nodeId) {
+            IODataProviderNamespace::Scalar* ret = new IODataProviderNamespace::Scalar();
+            ret->setLong(nodeId.getNumeric());
+            return ret;
+        }
+    private:
+
+        static std::vector<long> getNumericIds(
+                const std::vector<const IODataProviderNamespace::NodeId*>& nodeIds) {
+            std::vector<long> ret;
+            for (size_t i = 0; i < nodeIds.size(); i++) {
+                ret.push_back(nodeIds[i]->getNumeric());
+            }
+            return ret;
+        }
+    };
+
+} // namespace TestNamespace
+#endif /* TEST_IODATAPROVIDER_IODATAPROVIDERSTUB_H */
@@ -0,0 +1,89 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/Array.h>
+#include <ioDataProvider/Scalar.h>
+#include <stddef.h> // NULL
+#include <stdint.h> // int32_t
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(IODataProvider_Array) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+    };
+
+    TEST(IODataProvider_Array, Elements) {
+        std::vector<const Variant*>* elements = new std::vector<const Variant*>();
+        Scalar* s = new Scalar();
+        s->setLong(3);
+        elements->push_back(s);
+        Array array(Scalar::LONG, elements, true /*attachValues*/);
+        CHECK_EQUAL(1, array.getLength());
+        CHECK_TRUE(NULL == array.getValues());
+        CHECK_TRUE(elements == array.getElements());
+        // a NULL array
+        Array nullArray(Scalar::LONG, NULL /*elements*/);
+        CHECK_EQUAL(0, nullArray.getLength());
+        CHECK_TRUE(NULL == nullArray.getElements());
+    }
+
+    TEST(IODataProvider_Array, Values) {
+        CHECK_EQUAL(1, Array::getElementSize(Scalar::BOOL));
+        CHECK_EQUAL(2, Array::getElementSize(Scalar::UINT));
+        CHECK_EQUAL(4, Array::getElementSize(Scalar::LONG));
+        CHECK_EQUAL(8, Array::getElementSize(Scalar::DOUBLE));
+        CHECK_EQUAL(0, Array::getElementSize(Scalar::STRING));
+        CHECK_EQUAL(0, Array::getElementSize(Variant::STRUCTURE));
+
+        // create an array with contiguous values
+        Array* typedArray = Array::createTypedArray(Scalar::LONG, 3 /*length*/);
+        Array& array = *typedArray;
+        CHECK_EQUAL(Scalar::LONG, array.getArrayType());
+        CHECK_EQUAL(3, array.getLength());
+        int32_t* values = static_cast<int32_t*> (array.getValues());
+        CHECK_EQUAL(0, values[0]);
+        values[0] = 1;
+        values[1] = -2;
+        values[2] = 3;
+        STRCMP_EQUAL("IODataProviderNamespace::Array[type=6,elements="
+                "IODataProviderNamespace::Scalar[type=long,value=1],"
+                "IODataProviderNamespace::Scalar[type=long,value=-2],"
+                "IODataProviderNamespace::Scalar[type=long,value=3]]", array.toString().c_str());
+
+        // copy the array
+        Array* copy = static_cast<Array*> (array.copy());
+        CHECK_TRUE(array.getValues() != copy->getValues());
+        CHECK_EQUAL(-2, static_cast<const int32_t*> (copy->getValues())[1]);
+
+        // the elements are created on demand
+        CHECK_FALSE(array.hasElements());
+        CHECK_FALSE(copy->hasElements());
+        const std::vector<const Variant*>* elements = array.getElements();
+        CHECK_TRUE(array.hasElements());
+        CHECK_EQUAL(3, elements->size());
+        CHECK_EQUAL(-2, static_cast<const Scalar*> ((*elements)[1])->getLong());
+        CHECK_TRUE(elements == array.getElements());
+        delete copy;
+        delete typedArray;
+
+        // an empty array
+        Array* emptyArray = Array::createTypedArray(Scalar::DOUBLE, 0 /*length*/);
+        CHECK_EQUAL(0, emptyArray->getLength());
+        CHECK_EQUAL(0, emptyArray->getElements()->size());
+        delete emptyArray;
+    }
+}
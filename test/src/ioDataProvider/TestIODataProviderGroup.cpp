@@ -0,0 +1,210 @@
+#include "CppUTest/TestHarness.h"
+#include "IODataProviderStub.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <common/VectorScopeGuard.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/IODataProviderGroup.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <stddef.h> // NULL
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(IODataProvider_IODataProviderGroup) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        // Returns the provider id as value for each read node.
+        class IODataProviderImpl : public IODataProviderStub {
+        public:
+            long id;
+            // throws an instance which is not derived from Exception
+            bool failUnknown;
+
+            IODataProviderImpl(long id) {
+                this->id = id;
+                failUnknown = false;
+            }
+
+            virtual std::vector<NodeData*>* read(const std::vector<const NodeId*>& nodeIds) {
+                if (failUnknown) {
+                    throw std::string("read failed");
+                }
+                return IODataProviderStub::read(nodeIds);
+            }
+        protected:
+
+            virtual Scalar* createValue(const NodeId& nodeId) {
+                Scalar* ret = new Scalar();
+                ret->setLong(id);
+                return ret;
+            }
+        };
+    };
+
+    TEST(IODataProvider_IODataProviderGroup, Routing) {
+        IODataProviderImpl p0(0);
+        IODataProviderImpl p1(1);
+        IODataProviderImpl p2(2);
+        std::vector<IODataProvider*> providers;
+        providers.push_back(&p0);
+        providers.push_back(&p1);
+        providers.push_back(&p2);
+        IODataProviderGroup group(providers);
+        group.addNamespaceRoute("urn:rfid", p1);
+        group.addNodeIdPrefixRoute(-1 /* namespaceIndex */, "io.", p2);
+        group.addNodeIdPrefixRoute(3 /* namespaceIndex */, "io.rfid.", p1);
+
+        std::string id0("a");
+        std::string id1("io.in1");
+        std::string id2("io.rfid.tag");
+        NodeId n0(3, id0);
+        NodeId n1(3, id1);
+        NodeId n2(3, id2);
+        // the namespace index is unknown before the namespace has been announced
+        POINTERS_EQUAL(&p0, &group.getProvider(n0));
+        CHECK_TRUE(NULL == group.getDefaultNodeProperties("urn:rfid", 3));
+        POINTERS_EQUAL(&p1, &group.getProvider(n0));
+        // the longest prefix wins
+        POINTERS_EQUAL(&p2, &group.getProvider(n1));
+        POINTERS_EQUAL(&p1, &group.getProvider(n2));
+        // unrouted namespace
+        NodeId n3(4, 10);
+        POINTERS_EQUAL(&p0, &group.getProvider(n3));
+    }
+
+    TEST(IODataProvider_IODataProviderGroup, Read) {
+        IODataProviderImpl p0(0);
+        IODataProviderImpl p1(1);
+        std::vector<IODataProvider*> providers;
+        providers.push_back(&p0);
+        providers.push_back(&p1);
+        IODataProviderGroup group(providers);
+        group.addNodeIdPrefixRoute(-1 /* namespaceIndex */, "p1.", p1);
+
+        std::string id0("p1.a");
+        std::string id1("b");
+        std::string id2("p1.c");
+        NodeId n0(2, id0);
+        NodeId n1(2, id1);
+        NodeId n2(2, id2);
+        std::vector<const NodeId*> nodeIds;
+        nodeIds.push_back(&n0);
+        nodeIds.push_back(&n1);
+        nodeIds.push_back(&n2);
+
+        // the results are merged in the order of the request
+        std::vector<NodeData*>* results = group.read(nodeIds);
+        VectorScopeGuard<NodeData> resultsSG(results);
+        LONGS_EQUAL(3, results->size());
+        LONGS_EQUAL(1, p0.readNodeIds.size());
+        LONGS_EQUAL(2, p1.readNodeIds.size());
+        for (int i = 0; i < nodeIds.size(); i++) {
+            NodeData& result = *(*results)[i];
+            CHECK_TRUE(result.getNodeId().equals(*nodeIds[i]));
+            CHECK_TRUE(NULL == result.getException());
+            const Scalar& value = *static_cast<const Scalar*> (result.getData());
+            LONGS_EQUAL(i == 1 ? 0 : 1, value.getLong());
+        }
+
+        // a failing provider does not affect the nodes of the other providers
+        p1.fail = true;
+        std::vector<NodeData*>* results2 = group.read(nodeIds);
+        VectorScopeGuard<NodeData> results2SG(results2);
+        LONGS_EQUAL(3, results2->size());
+        CHECK_TRUE(NULL != (*results2)[0]->getException());
+        CHECK_TRUE(NULL == (*results2)[0]->getData());
+        CHECK_TRUE((*results2)[0]->getNodeId().equals(n0));
+        CHECK_TRUE(NULL == (*results2)[1]->getException());
+        CHECK_TRUE(NULL != (*results2)[2]->getException());
+
+        // an unknown exception is reported like an IODataProviderException
+        p1.fail = false;
+        p1.failUnknown = true;
+        std::vector<NodeData*>* results3 = group.read(nodeIds);
+        VectorScopeGuard<NodeData> results3SG(results3);
+        LONGS_EQUAL(3, results3->size());
+        CHECK_TRUE(NULL != (*results3)[0]->getException());
+        CHECK_TRUE(NULL == (*results3)[1]->getException());
+        CHECK_TRUE(NULL != (*results3)[2]->getException());
+
+        // the worker of a provider processes the sub requests of several requests
+        p1.failUnknown = false;
+        for (int i = 0; i < 10; i++) {
+            std::vector<NodeData*>* results4 = group.read(nodeIds);
+            VectorScopeGuard<NodeData> results4SG(results4);
+            CHECK_TRUE(NULL == (*results4)[2]->getException());
+        }
+        // the failed read is recorded too
+        LONGS_EQUAL(24, p1.readNodeIds.size());
+    }
+
+    TEST(IODataProvider_IODataProviderGroup, NotificationRouting) {
+        IODataProviderImpl p0(0);
+        IODataProviderImpl p1(1);
+        std::vector<IODataProvider*> providers;
+        providers.push_back(&p0);
+        providers.push_back(&p1);
+        IODataProviderGroup group(providers);
+        group.addNamespaceRoute("urn:rfid", p1);
+        CHECK_TRUE(NULL == group.getDefaultNodeProperties("urn:rfid", 3));
+
+        // the notifications and events are forwarded to the provider of the namespace only
+        group.notification(NULL /* env */, 3 /* ns */, NULL /* id */, NULL /* value */);
+        group.event(NULL /* env */, 3 /* eNs */, NULL /* event */, 4 /* pNs */,
+                NULL /* param */, 0 /* timestamp */, 0 /* severity */, NULL /* msg */,
+                NULL /* value */);
+        LONGS_EQUAL(0, p0.notificationCount);
+        LONGS_EQUAL(1, p1.notificationCount);
+        LONGS_EQUAL(0, p0.eventCount);
+        LONGS_EQUAL(1, p1.eventCount);
+        // an unrouted namespace is forwarded to the default provider
+        group.notification(NULL /* env */, 4 /* ns */, NULL /* id */, NULL /* value */);
+        LONGS_EQUAL(1, p0.notificationCount);
+        LONGS_EQUAL(1, p1.notificationCount);
+    }
+
+    TEST(IODataProvider_IODataProviderGroup, NotificationRoutingPerNamespace) {
+        // two providers with a namespace each (like the modules of a server)
+        IODataProviderImpl p0(0);
+        IODataProviderImpl p1(1);
+        std::vector<IODataProvider*> providers;
+        providers.push_back(&p0);
+        providers.push_back(&p1);
+        IODataProviderGroup group(providers);
+        group.addNamespaceRoute("urn:io", p0);
+        group.addNamespaceRoute("urn:rfid", p1);
+        CHECK_TRUE(NULL == group.getDefaultNodeProperties("urn:io", 2));
+        CHECK_TRUE(NULL == group.getDefaultNodeProperties("urn:rfid", 3));
+
+        // a notification is received by the provider of its namespace only
+        group.notification(NULL /* env */, 3 /* ns */, NULL /* id */, NULL /* value */);
+        LONGS_EQUAL(0, p0.notificationCount);
+        LONGS_EQUAL(1, p1.notificationCount);
+        group.notification(NULL /* env */, 2 /* ns */, NULL /* id */, NULL /* value */);
+        LONGS_EQUAL(1, p0.notificationCount);
+        LONGS_EQUAL(1, p1.notificationCount);
+
+        // an event is received by the provider of the event type namespace only
+        group.event(NULL /* env */, 3 /* eNs */, NULL /* event */, 2 /* pNs */,
+                NULL /* param */, 0 /* timestamp */, 0 /* severity */, NULL /* msg */,
+                NULL /* value */);
+        LONGS_EQUAL(0, p0.eventCount);
+        LONGS_EQUAL(1, p1.eventCount);
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,91 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/MessageRegistry.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <stddef.h> // NULL
+#include <string>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(IODataProvider_NodeData) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+    };
+
+    TEST(IODataProvider_NodeData, Status) {
+        int messageId = MessageRegistry::registerMessage("Cannot read data");
+        LONGS_EQUAL(messageId, MessageRegistry::registerMessage("Cannot read data"));
+        STRCMP_EQUAL("Cannot read data", MessageRegistry::getMessage(messageId).c_str());
+        STRCMP_EQUAL("", MessageRegistry::getMessage(-1).c_str());
+
+        NodeData nodeData(*new NodeId(1, 1), NULL /* data */, true /* attachValues */);
+        CHECK_FALSE(nodeData.hasError());
+        CHECK_TRUE(nodeData.getException() == NULL);
+        LONGS_EQUAL(0, nodeData.getStatusCode());
+
+        // an exception is created on demand for a bad status code
+        nodeData.setStatus(0x80050000, messageId);
+        CHECK_TRUE(nodeData.hasError());
+        LONGS_EQUAL(0x80050000, nodeData.getStatusCode());
+        LONGS_EQUAL(messageId, nodeData.getMessageId());
+        IODataProviderException* exception = nodeData.getException();
+        CHECK_TRUE(exception != NULL);
+        CHECK_TRUE(exception->getMessage().find("Cannot read data") == 0);
+        CHECK_TRUE(exception->getMessage().find("0x80050000") != std::string::npos);
+        POINTERS_EQUAL(exception, nodeData.getException());
+
+        // the status is copied
+        NodeData copy(nodeData);
+        LONGS_EQUAL(0x80050000, copy.getStatusCode());
+        CHECK_TRUE(copy.getException() != NULL);
+
+        // a good status code is no error
+        nodeData.setStatus(0);
+        CHECK_FALSE(nodeData.hasError());
+        CHECK_TRUE(nodeData.getException() == NULL);
+
+        // an exception without status code results in a bad status code
+        nodeData.setException(new ExceptionDef(IODataProviderException, std::string("failed")));
+        CHECK_TRUE(nodeData.hasError());
+        LONGS_EQUAL(0x80000000, nodeData.getStatusCode());
+    }
+
+    TEST(IODataProvider_NodeData, NodeId) {
+        // the node id of a request is referenced while the value is attached
+        NodeId nodeId(1, std::string("a long string identifier of a node"));
+        NodeData* nodeData = new NodeData(nodeId, new NodeId(1, 2), true /* attachValues */,
+                false /* attachNodeId */);
+        POINTERS_EQUAL(&nodeId, &nodeData->getNodeId());
+
+        // a copy always owns its node id
+        NodeData copy(*nodeData);
+        CHECK_TRUE(&nodeId != &copy.getNodeId());
+        CHECK_TRUE(nodeId.equals(copy.getNodeId()));
+
+        // the referenced node id is replaced with a copy once
+        nodeData->copyNodeId();
+        const NodeId* copiedNodeId = &nodeData->getNodeId();
+        CHECK_TRUE(&nodeId != copiedNodeId);
+        CHECK_TRUE(nodeId.equals(*copiedNodeId));
+        nodeData->copyNodeId();
+        POINTERS_EQUAL(copiedNodeId, &nodeData->getNodeId());
+        // the copy is deleted with the instance, the node id of the request is not
+        delete nodeData;
+        STRCMP_EQUAL("a long string identifier of a node", nodeId.getString().c_str());
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,42 @@
+#include "CppUTest/TestHarness.h"
+#include <ioDataProvider/NodeId.h>
+#include <map>
+#include <string>
+
+using namespace IODataProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(IODataProvider_NodeId) {
+    };
+
+    TEST(IODataProvider_NodeId, Less) {
+        NodeId::Less less;
+        std::string a("a");
+        std::string b("b");
+        NodeId numeric1(2, 1);
+        NodeId numeric2(2, 2);
+        NodeId stringA(2, a);
+        NodeId stringB(2, b);
+        NodeId otherNamespace(1, 2);
+        // namespace index, type, identifier
+        CHECK_TRUE(less(numeric1, numeric2));
+        CHECK_FALSE(less(numeric2, numeric1));
+        CHECK_FALSE(less(numeric1, numeric1));
+        CHECK_TRUE(less(stringA, stringB));
+        CHECK_FALSE(less(stringA, stringA));
+        CHECK_TRUE(less(numeric2, stringA));
+        CHECK_TRUE(less(otherNamespace, numeric1));
+
+        // equal node ids are one key of a map
+        std::map<NodeId, int, NodeId::Less> map;
+        map[numeric1] = 1;
+        map[stringA] = 2;
+        map[NodeId(2, 1)] = 3;
+        map[NodeId(2, a)] = 4;
+        LONGS_EQUAL(2, map.size());
+        LONGS_EQUAL(3, map[numeric1]);
+        LONGS_EQUAL(4, map[stringA]);
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,90 @@
+#include "CppUTest/TestHarness.h"
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <stddef.h> // NULL
+#include <string.h> // memcmp
+#include <string>
+
+using namespace IODataProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(IODataProvider_Scalar) {
+    };
+
+    TEST(IODataProvider_Scalar, String) {
+        // NULL string
+        Scalar scalar;
+        scalar.setString(NULL);
+        CHECK_EQUAL(Scalar::STRING, scalar.getScalarType());
+        POINTERS_EQUAL(NULL, scalar.getString());
+
+        // the value is copied
+        std::string value("a");
+        scalar.setString(&value);
+        value.assign("b");
+        STRCMP_EQUAL("a", scalar.getString()->c_str());
+        // the same instance is returned until the value is changed
+        POINTERS_EQUAL(scalar.getString(), scalar.getString());
+
+        // attached long string: the content is taken over
+        std::string longValue(100, 'x');
+        scalar.setString(new std::string(longValue), true /* attachValue */);
+        CHECK_TRUE(longValue == *scalar.getString());
+        Scalar copy(scalar);
+        CHECK_TRUE(longValue == *copy.getString());
+        Scalar copy2(copy);
+        scalar.setInt(1);
+        CHECK_EQUAL(1, scalar.getInt());
+        CHECK_TRUE(*copy.getString() == *copy2.getString());
+
+        // localized text
+        std::string locale("en");
+        scalar.setLocalizedText(&locale, NULL);
+        Scalar copy3(scalar);
+        STRCMP_EQUAL("en", copy3.getLocalizedTextLocale()->c_str());
+        POINTERS_EQUAL(NULL, copy3.getLocalizedTextText());
+        STRCMP_EQUAL("IODataProviderNamespace::Scalar[type=localizedText,locale=en,text=<NULL>]",
+                copy3.toString().c_str());
+    }
+
+    TEST(IODataProvider_Scalar, ByteString) {
+        Scalar scalar;
+        scalar.setByteString(NULL, 0);
+        POINTERS_EQUAL(NULL, scalar.getByteString());
+        // empty byte string
+        scalar.setByteString("", 0);
+        CHECK_TRUE(scalar.getByteString() != NULL);
+        CHECK_EQUAL(0, scalar.getByteStringLength());
+        // attached byte string
+        char* bytes = new char[3];
+        bytes[0] = 1;
+        bytes[1] = 2;
+        bytes[2] = 3;
+        scalar.setByteString(bytes, 3, true /* attachValue */);
+        // the byte string is not copied
+        POINTERS_EQUAL(bytes, scalar.getByteString());
+        Scalar copy(scalar);
+        CHECK_TRUE(bytes != copy.getByteString());
+        CHECK_EQUAL(3, copy.getByteStringLength());
+        CHECK_EQUAL(3, copy.getByteString()[2]);
+        // the attached byte string is destroyed with the next value
+        scalar.setByteString(NULL, 0);
+        CHECK_EQUAL(3, copy.getByteString()[2]);
+    }
+
+    TEST(IODataProvider_Scalar, NodeId) {
+        NodeId nodeId1(1, std::string("a"));
+        NodeId nodeId2(1, *new std::string("a"), true /* attachValues */);
+        NodeId nodeId3(nodeId2);
+        CHECK_TRUE(nodeId1.equals(nodeId2));
+        CHECK_TRUE(nodeId2.equals(nodeId1));
+        CHECK_TRUE(nodeId2.equals(nodeId3));
+        CHECK_TRUE(nodeId3.equals(nodeId1));
+        CHECK_FALSE(nodeId1.equals(NodeId(1, std::string("b"))));
+        CHECK_FALSE(nodeId1.equals(NodeId(2, std::string("a"))));
+        CHECK_FALSE(nodeId1.equals(NodeId(1, 3)));
+        STRCMP_EQUAL("a", nodeId3.getString().c_str());
+        CHECK_TRUE(NodeId(1, 3).equals(NodeId(1, 3)));
+    }
+}
@@ -0,0 +1,131 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <ioDataProvider/Structure.h>
+#include <pthread.h> // pthread_t
+#include <stddef.h> // NULL
+#include <map>
+#include <string>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(IODataProvider_Structure) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        static void* getFieldDataThreadRun(void* structure) {
+            return const_cast<std::map<std::string, const Variant*>*> (
+                    &static_cast<Structure*> (structure)->getFieldData());
+        }
+    };
+
+    TEST(IODataProvider_Structure, Fields) {
+        // create a structure with fields in the order of a data type definition
+        Structure* structure = Structure::createStructure(*new NodeId(1, 20), 3 /*fieldCount*/);
+        Scalar* b = new Scalar();
+        b->setLong(2);
+        structure->addField("b", *b);
+        Scalar* a = new Scalar();
+        a->setLong(1);
+        structure->addField("a", *a);
+        CHECK_EQUAL(20, structure->getDataTypeId().getNumeric());
+        CHECK_EQUAL(2, structure->getFieldCount());
+        STRCMP_EQUAL("b", structure->getField(0).name.c_str());
+        CHECK_TRUE(b == structure->getField(0).value);
+        STRCMP_EQUAL("a", structure->getField(1).name.c_str());
+        CHECK_TRUE(a == structure->getField(1).value);
+        STRCMP_EQUAL("IODataProviderNamespace::Structure[dataTypeId="
+                "IODataProviderNamespace::NodeId[type=numeric,ns=1,value=20],fieldData="
+                "b=>IODataProviderNamespace::Scalar[type=long,value=2] "
+                "a=>IODataProviderNamespace::Scalar[type=long,value=1]]",
+                structure->toString().c_str());
+
+        // find the fields with and without a hint
+        CHECK_TRUE(a == structure->getFieldValue("a"));
+        CHECK_TRUE(a == structure->getFieldValue("a", 1 /*hint*/));
+        CHECK_TRUE(b == structure->getFieldValue("b", 1 /*hint*/));
+        CHECK_TRUE(b == structure->getFieldValue("b", 5 /*hint*/));
+        CHECK_TRUE(NULL == structure->getFieldValue("c"));
+
+        // the map is created on demand and updated by addField
+        const std::map<std::string, const Variant*>& fieldData = structure->getFieldData();
+        CHECK_EQUAL(2, fieldData.size());
+        CHECK_TRUE(a == fieldData.at("a"));
+        CHECK_TRUE(&fieldData == &structure->getFieldData());
+        Scalar* c = new Scalar();
+        c->setLong(3);
+        structure->addField("c", *c);
+        CHECK_EQUAL(3, fieldData.size());
+        CHECK_TRUE(c == fieldData.at("c"));
+
+        // copy the structure
+        Structure* copy = static_cast<Structure*> (structure->copy());
+        CHECK_EQUAL(3, copy->getFieldCount());
+        STRCMP_EQUAL("b", copy->getField(0).name.c_str());
+        CHECK_TRUE(b != copy->getField(0).value);
+        STRCMP_EQUAL(structure->toString().c_str(), copy->toString().c_str());
+        delete copy;
+        delete structure;
+
+        // an empty structure
+        Structure* emptyStructure = Structure::createStructure(*new NodeId(1, 21),
+                0 /*fieldCount*/);
+        CHECK_EQUAL(0, emptyStructure->getFieldCount());
+        CHECK_TRUE(NULL == emptyStructure->getFieldValue("a"));
+        CHECK_EQUAL(0, emptyStructure->getFieldData().size());
+        delete emptyStructure;
+    }
+
+    TEST(IODataProvider_Structure, FieldData) {
+        // the fields are stored in the order of the map
+        std::map<std::string, const Variant*>* fieldData =
+                new std::map<std::string, const Variant*>();
+        Scalar* b = new Scalar();
+        b->setLong(2);
+        (*fieldData)["b"] = b;
+        Scalar* a = new Scalar();
+        a->setLong(1);
+        (*fieldData)["a"] = a;
+        Structure structure(*new NodeId(1, 20), *fieldData, true /*attachValues*/);
+        CHECK_EQUAL(2, structure.getFieldCount());
+        STRCMP_EQUAL("a", structure.getField(0).name.c_str());
+        STRCMP_EQUAL("b", structure.getField(1).name.c_str());
+        CHECK_TRUE(b == structure.getFieldValue("b"));
+        // the attached map is provided
+        CHECK_TRUE(fieldData == &structure.getFieldData());
+    }
+
+    TEST(IODataProvider_Structure, FieldDataConcurrently) {
+        Structure* structure = Structure::createStructure(*new NodeId(1, 20), 1 /*fieldCount*/);
+        Scalar* a = new Scalar();
+        a->setLong(1);
+        structure->addField("a", *a);
+        // the map is created by concurrent readers: all of them get the same instance
+        pthread_t threads[4];
+        for (int i = 0; i < 4; i++) {
+            pthread_create(&threads[i], NULL, &getFieldDataThreadRun, structure);
+        }
+        void* fieldData[4];
+        for (int i = 0; i < 4; i++) {
+            pthread_join(threads[i], &fieldData[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            CHECK_TRUE(fieldData[i] == &structure->getFieldData());
+        }
+        CHECK_EQUAL(1, structure->getFieldData().size());
+        delete structure;
+    }
+}
@@ -0,0 +1,132 @@
+#include "CppUTest/TestHarness.h"
+#include "../../../../../../src/provider/binary/messages/dto/ParamId.h"
+#include "../../../../../../src/provider/binary/messages/dto/Scalar.h"
+#include "../../../../../../src/provider/binary/messages/dto/Struct.h"
+#include <pthread.h> // pthread_t
+#include <stddef.h> // NULL
+#include <map>
+#include <string>
+
+namespace TestNamespace {
+
+    TEST_GROUP(ProviderBinaryMessagesDto_Struct) {
+
+        static void* getFieldsThreadRun(void* object) {
+            return const_cast<std::map<std::string, const Variant*>*> (
+                    &static_cast<Struct*> (object)->getFields());
+        }
+    };
+
+    TEST(ProviderBinaryMessagesDto_Struct, AttachedValues) {
+        // the struct id, the map and the values are destroyed with the struct
+        std::map<std::string, const Variant*>* fields =
+                new std::map<std::string, const Variant*>();
+        Scalar* b = new Scalar();
+        b->setInt(2);
+        (*fields)["b"] = b;
+        Scalar* a = new Scalar();
+        a->setInt(1);
+        (*fields)["a"] = a;
+        Struct* value = new Struct(*new ParamId(1, 20), *fields, true /*attachValues*/);
+        // the fields are stored in the order of the map
+        CHECK_EQUAL(2, value->getFieldCount());
+        STRCMP_EQUAL("a", value->getField(0).name.c_str());
+        CHECK_TRUE(a == value->getField(0).value);
+        // the attached map is provided
+        CHECK_TRUE(fields == &value->getFields());
+
+        // replace the fields: the previous values and map are destroyed
+        std::map<std::string, const Variant*>* newFields =
+                new std::map<std::string, const Variant*>();
+        Scalar* c = new Scalar();
+        c->setInt(3);
+        (*newFields)["c"] = c;
+        value->setFields(*newFields);
+        CHECK_EQUAL(1, value->getFieldCount());
+        CHECK_TRUE(c == value->getFieldValue("c"));
+        CHECK_TRUE(NULL == value->getFieldValue("a"));
+        CHECK_TRUE(newFields == &value->getFields());
+
+        // replace the struct id: the previous id is destroyed
+        value->setStructId(*new ParamId(1, 21));
+        CHECK_EQUAL(21, value->getStructId().getNumeric());
+        delete value;
+    }
+
+    TEST(ProviderBinaryMessagesDto_Struct, DetachedValues) {
+        // the struct id, the map and the values are not destroyed with the struct
+        ParamId structId(1, 20);
+        Scalar a;
+        a.setInt(1);
+        std::map<std::string, const Variant*> fields;
+        fields["a"] = &a;
+        Struct* value = new Struct(structId, fields);
+        // a map is created for getFields
+        CHECK_TRUE(&fields != &value->getFields());
+        CHECK_TRUE(&a == value->getFields().at("a"));
+
+        // replace the fields: the previous values are kept
+        Scalar b;
+        b.setInt(2);
+        std::map<std::string, const Variant*> newFields;
+        newFields["b"] = &b;
+        value->setFields(newFields);
+        CHECK_EQUAL(1, value->getFieldCount());
+        CHECK_TRUE(&b == value->getFieldValue("b"));
+        CHECK_TRUE(&b == value->getFields().at("b"));
+        CHECK_EQUAL(1, a.getInt());
+        delete value;
+        CHECK_EQUAL(1, a.getInt());
+        CHECK_EQUAL(2, b.getInt());
+        CHECK_EQUAL(20, structId.getNumeric());
+    }
+
+    TEST(ProviderBinaryMessagesDto_Struct, CreateStruct) {
+        // the struct id and the values added via addField are attached
+        Struct* value = Struct::createStruct(*new ParamId(1, 20), 2 /*fieldCount*/);
+        Scalar* b = new Scalar();
+        b->setInt(2);
+        value->addField("b", *b);
+        // the map is created on demand and updated by addField
+        const std::map<std::string, const Variant*>& fields = value->getFields();
+        CHECK_EQUAL(1, fields.size());
+        Scalar* a = new Scalar();
+        a->setInt(1);
+        value->addField("a", *a);
+        CHECK_EQUAL(2, fields.size());
+        // the fields are stored in the order they have been added
+        STRCMP_EQUAL("b", value->getField(0).name.c_str());
+        STRCMP_EQUAL("a", value->getField(1).name.c_str());
+        CHECK_TRUE(a == value->getFieldValue("a", 1 /*hint*/));
+
+        // a copy is independent of the original
+        Struct* copy = static_cast<Struct*> (value->copy());
+        delete value;
+        CHECK_EQUAL(2, copy->getFieldCount());
+        CHECK_EQUAL(20, copy->getStructId().getNumeric());
+        STRCMP_EQUAL("b", copy->getField(0).name.c_str());
+        CHECK_EQUAL(1, static_cast<const Scalar*> (copy->getFieldValue("a"))->getInt());
+        delete copy;
+    }
+
+    TEST(ProviderBinaryMessagesDto_Struct, FieldsConcurrently) {
+        Struct* value = Struct::createStruct(*new ParamId(1, 20), 1 /*fieldCount*/);
+        Scalar* a = new Scalar();
+        a->setInt(1);
+        value->addField("a", *a);
+        // the map is created by concurrent readers: all of them get the same instance
+        pthread_t threads[4];
+        for (int i = 0; i < 4; i++) {
+            pthread_create(&threads[i], NULL, &getFieldsThreadRun, value);
+        }
+        void* fields[4];
+        for (int i = 0; i < 4; i++) {
+            pthread_join(threads[i], &fields[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            CHECK_TRUE(fields[i] == &value->getFields());
+        }
+        CHECK_EQUAL(1, value->getFields().size());
+        delete value;
+    }
+}
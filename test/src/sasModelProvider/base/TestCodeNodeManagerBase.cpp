@@ -0,0 +1,183 @@
+#include "CppUTest/TestHarness.h"
+#include "../../ioDataProvider/IODataProviderStub.h"
+#include <common/Exception.h>
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/IODataProvider.h>
+#include <sasModelProvider/base/CodeNodeManagerBase.h>
+#include <sasModelProvider/base/HaNodeManagerException.h>
+#include <sasModelProvider/base/NodeBrowser.h>
+#include <uabasenodes.h> // UaPropertyCache
+#include <uadatetime.h> // UaDateTime
+#include <uanodeid.h> // UaNodeId
+#include <uastring.h> // UaString
+#include <uavariant.h> // UaVariant
+#include <stddef.h> // NULL
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_CodeNodeManagerBase) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        // A variable which rejects all values.
+        class ReadOnlyVariable : public UaPropertyCache {
+        public:
+
+            ReadOnlyVariable(const UaNodeId& nodeId, const UaString& defaultLocaleId) :
+            UaPropertyCache(nodeId.toString(), nodeId, UaVariant(), Ua_AccessLevel_CurrentRead,
+            defaultLocaleId) {
+            }
+
+            virtual UaStatus setValue(Session* pSession, const UaDataValue& dataValue,
+                    OpcUa_Boolean checkAccessLevel) {
+                return UaStatus(OpcUa_BadNotWritable);
+            }
+        };
+
+        // A variable which reports its deletion.
+        class TrackedVariable : public UaPropertyCache {
+        public:
+            bool* isDeleted;
+
+            TrackedVariable(const UaNodeId& nodeId, const UaString& defaultLocaleId,
+                    bool& isDeleted) :
+            UaPropertyCache(nodeId.toString(), nodeId, UaVariant(), Ua_AccessLevel_CurrentRead,
+            defaultLocaleId) {
+                this->isDeleted = &isDeleted;
+            }
+
+            virtual ~TrackedVariable() {
+                *isDeleted = true;
+            }
+        };
+
+        // A node manager which is not started by a server.
+        // It is its own root node manager.
+        class CodeNodeManagerBaseImpl : public CodeNodeManagerBase {
+        public:
+
+            CodeNodeManagerBaseImpl(IODataProvider& ioDataProvider) :
+            CodeNodeManagerBase("http://test/CodeNodeManagerBase", ioDataProvider) {
+            }
+
+            virtual NodeManager& getNodeManagerRoot() {
+                return *this;
+            }
+
+            UaVariable* addVariable(const UaNodeId& nodeId) {
+                UaPropertyCache* variable = new UaPropertyCache(nodeId.toString(), nodeId,
+                        UaVariant(), Ua_AccessLevel_CurrentRead, getDefaultLocaleId());
+                addUaNode(variable);
+                return variable;
+            }
+
+            UaVariable* addTrackedVariable(const UaNodeId& nodeId, bool& isDeleted) {
+                TrackedVariable* variable = new TrackedVariable(nodeId, getDefaultLocaleId(),
+                        isDeleted);
+                addUaNode(variable);
+                return variable;
+            }
+
+            UaVariable* addReadOnlyVariable(const UaNodeId& nodeId) {
+                ReadOnlyVariable* variable = new ReadOnlyVariable(nodeId, getDefaultLocaleId());
+                addUaNode(variable);
+                return variable;
+            }
+        };
+    };
+
+    TEST(SasModelProviderBase_CodeNodeManagerBase, SetVariables) {
+        IODataProviderStub ioDataProvider;
+        CodeNodeManagerBaseImpl nodeManager(ioDataProvider);
+        std::vector<UaVariable*> variables;
+        variables.push_back(nodeManager.addVariable(
+                UaNodeId("v1", nodeManager.getNameSpaceIndex())));
+        variables.push_back(nodeManager.addVariable(
+                UaNodeId("v2", nodeManager.getNameSpaceIndex())));
+        UaVariant value1;
+        value1.setInt32(1);
+        UaVariant value2;
+        value2.setInt32(2);
+        std::vector<UaVariant*> values;
+        values.push_back(&value1);
+        values.push_back(&value2);
+
+        // all values are set with the same time stamps
+        nodeManager.setVariables(variables, values);
+        OpcUa_Int32 value;
+        UaDataValue dataValue1 = variables[0]->value(NULL /* session */);
+        UaDataValue dataValue2 = variables[1]->value(NULL /* session */);
+        UaVariant(*dataValue1.value()).toInt32(value);
+        LONGS_EQUAL(1, value);
+        UaVariant(*dataValue2.value()).toInt32(value);
+        LONGS_EQUAL(2, value);
+        CHECK_TRUE((OpcUa_Int64) UaDateTime(dataValue1.sourceTimestamp())
+                == (OpcUa_Int64) UaDateTime(dataValue2.sourceTimestamp()));
+        CHECK_TRUE((OpcUa_Int64) UaDateTime(dataValue1.serverTimestamp())
+                == (OpcUa_Int64) UaDateTime(dataValue2.serverTimestamp()));
+    }
+
+    TEST(SasModelProviderBase_CodeNodeManagerBase, SetVariablesError) {
+        IODataProviderStub ioDataProvider;
+        CodeNodeManagerBaseImpl nodeManager(ioDataProvider);
+        std::vector<UaVariable*> variables;
+        variables.push_back(nodeManager.addReadOnlyVariable(
+                UaNodeId("ro1", nodeManager.getNameSpaceIndex())));
+        variables.push_back(nodeManager.addVariable(
+                UaNodeId("v1", nodeManager.getNameSpaceIndex())));
+        variables.push_back(nodeManager.addReadOnlyVariable(
+                UaNodeId("ro2", nodeManager.getNameSpaceIndex())));
+        UaVariant value;
+        value.setInt32(3);
+        std::vector<UaVariant*> values(variables.size(), &value);
+
+        // the remaining values are set and an exception for the first failed variable is
+        // thrown afterwards
+        try {
+            nodeManager.setVariables(variables, values);
+            FAIL("");
+        } catch (HaNodeManagerException& e) {
+            STRCMP_CONTAINS("ro1", e.getMessage().c_str());
+        } catch (Exception& e) {
+            FAIL("");
+        }
+        OpcUa_Int32 v1Value;
+        UaVariant(*variables[1]->value(NULL /* session */).value()).toInt32(v1Value);
+        LONGS_EQUAL(3, v1Value);
+    }
+
+    TEST(SasModelProviderBase_CodeNodeManagerBase, DeleteUaNode) {
+        IODataProviderStub ioDataProvider;
+        CodeNodeManagerBaseImpl nodeManager(ioDataProvider);
+        UaNodeId nodeId("v1", nodeManager.getNameSpaceIndex());
+        bool isDeleted = false;
+        nodeManager.addTrackedVariable(nodeId, isDeleted);
+        NodeBrowser nodeBrowser(nodeManager);
+        // the node browser holds a reference to the cached variable
+        UaVariable* variable = nodeBrowser.getVariable(nodeId);
+        CHECK_TRUE(variable != NULL);
+        variable->releaseReference();
+
+        // the node managers remove the node from the caches of the node browsers
+        nodeManager.deleteUaNode(variable, OpcUa_True /* deleteTargetReferences */,
+                OpcUa_True /* deleteSourceReferences */);
+        CHECK_TRUE(isDeleted);
+        CHECK_TRUE(nodeBrowser.getVariable(nodeId) == NULL);
+    }
+
+} // namespace TestNamespace
@@ -20,6 +20,7 @@
 #include <uastring.h> // UaString
 #include <map>
 #include <stddef.h> // NULL
+#include <stdint.h> // int32_t
 #include <string>
 #include <vector>
 
@@ -43,6 +44,10 @@ namespace TestNamespace {
         class ConverterCallback : public ConverterUa2IO::ConverterCallback {
         public:
 
+            ConverterCallback() {
+                structureDefinitionCount = 0;
+            }
+
             virtual void addStructureDefinition(UaStructureDefinition& structureDefinition) {
                 std::string dataTypeId(structureDefinition.dataTypeId().toXmlString().toUtf8());
                 structureDefinitions[dataTypeId] = &structureDefinition;
@@ -56,6 +61,7 @@ namespace TestNamespace {
             // interface Converter::ConverterCallback
 
             virtual UaStructureDefinition getStructureDefinition(const UaNodeId& dataTypeId) {
+                structureDefinitionCount++;
                 return *structureDefinitions.at(std::string(dataTypeId.toXmlString().toUtf8()));
             }
 
@@ -70,6 +76,9 @@ namespace TestNamespace {
                 }
                 return parentsCopy;
             }
+
+            // count of calls of getStructureDefinition
+            int structureDefinitionCount;
         private:
             std::map<std::string, UaStructureDefinition*> structureDefinitions;
             std::map<std::string, std::vector<UaNodeId>*> dataTypeParents;
@@ -900,6 +909,47 @@ namespace TestNamespace {
             FAIL("");
         }
 
+        // long -> uint16: values out of range
+        long invalidLongs[] = {70000, -1};
+        for (int i = 0; i < 2; i++) {
+            s.setLong(invalidLongs[i]);
+            try {
+                conv.convertIo2ua(s, UaNodeId(OpcUaType_UInt16));
+                FAIL("");
+            } catch (ConversionException& e) {
+                STRCMP_CONTAINS("for destination type uint16", e.getMessage().c_str());
+            } catch (Exception& e) {
+                FAIL("");
+            }
+        }
+        // long -> uint16: maximum value
+        s.setLong(65535);
+        UaVariant* value = conv.convertIo2ua(s, UaNodeId(OpcUaType_UInt16));
+        OpcUa_UInt16 valueUInt16;
+        value->toUInt16(valueUInt16);
+        CHECK_EQUAL(65535, valueUInt16);
+        delete value;
+
+        // llong -> uint32: values out of range
+        long long invalidLLongs[] = {4294967296LL, -1};
+        for (int i = 0; i < 2; i++) {
+            s.setLLong(invalidLLongs[i]);
+            try {
+                conv.convertIo2ua(s, UaNodeId(OpcUaType_UInt32));
+                FAIL("");
+            } catch (ConversionException& e) {
+                STRCMP_CONTAINS("for destination type uint32", e.getMessage().c_str());
+            } catch (Exception& e) {
+                FAIL("");
+            }
+        }
+        // llong -> uint32: maximum value
+        s.setLLong(4294967295LL);
+        value = conv.convertIo2ua(s, UaNodeId(OpcUaType_UInt32));
+        OpcUa_UInt32 valueUInt32;
+        value->toUInt32(valueUInt32);
+        CHECK_TRUE(4294967295U == valueUInt32);
+        delete value;
     }
 
     TEST(SasModelProviderBase_ConverterUa2IO, VariantArrayValue) {
@@ -1192,7 +1242,6 @@ namespace TestNamespace {
         UaGenericStructureValue configurationsSv(configurationsEo, baConfigurations);
 
         // check FurnaceControllers
-        OpcUa_StatusCode status;
         UaVariant controllersVa = configurationsSv.value(UaString("FurnaceControllers"), &status);
         CHECK_TRUE(controllersVa.isArray());
         CHECK_EQUAL(1, controllersVa.arraySize());
@@ -1240,4 +1289,245 @@ namespace TestNamespace {
         delete configurationsValue;
     }
 
+    TEST(SasModelProviderBase_ConverterUa2IO, TypedArrayValue) {
+        ConverterCallback callback;
+        ConverterUa2IO conv(callback);
+
+        // double[] -> double[] with contiguous values
+        UaDoubleArray valueDoubleArray;
+        valueDoubleArray.create(2);
+        valueDoubleArray[0] = 1.5;
+        valueDoubleArray[1] = -2.5;
+        UaVariant valueDouble;
+        valueDouble.setDoubleArray(valueDoubleArray);
+        IODataProviderNamespace::Array* arrayDouble =
+                static_cast<IODataProviderNamespace::Array*> (
+                conv.convertUa2io(valueDouble, UaNodeId(OpcUaType_Double)));
+        CHECK_EQUAL(IODataProviderNamespace::Scalar::DOUBLE, arrayDouble->getArrayType());
+        CHECK_EQUAL(2, arrayDouble->getLength());
+        const double* doubleValues = static_cast<const double*> (arrayDouble->getValues());
+        DOUBLES_EQUAL(1.5, doubleValues[0], 0);
+        DOUBLES_EQUAL(-2.5, doubleValues[1], 0);
+        // double[] -> double[]
+        UaVariant* value = conv.convertIo2ua(*arrayDouble, UaNodeId(OpcUaType_Double));
+        CHECK_EQUAL(OpcUaType_Double, value->dataType().identifierNumeric());
+        value->toDoubleArray(valueDoubleArray);
+        CHECK_EQUAL(2, valueDoubleArray.length());
+        DOUBLES_EQUAL(-2.5, valueDoubleArray[1], 0);
+        delete value;
+        delete arrayDouble;
+
+        // long[] -> uint16[] (narrowing)
+        IODataProviderNamespace::Array* arrayLong =
+                IODataProviderNamespace::Array::createTypedArray(
+                IODataProviderNamespace::Scalar::LONG, 2 /*length*/);
+        int32_t* longValues = static_cast<int32_t*> (arrayLong->getValues());
+        longValues[0] = 7;
+        longValues[1] = 8;
+        value = conv.convertIo2ua(*arrayLong, UaNodeId(OpcUaType_UInt16));
+        CHECK_EQUAL(OpcUaType_UInt16, value->dataType().identifierNumeric());
+        UaUInt16Array valueUInt16Array;
+        value->toUInt16Array(valueUInt16Array);
+        CHECK_EQUAL(2, valueUInt16Array.length());
+        CHECK_EQUAL(7, valueUInt16Array[0]);
+        CHECK_EQUAL(8, valueUInt16Array[1]);
+        delete value;
+        // long[] -> int64[] (widening)
+        value = conv.convertIo2ua(*arrayLong, UaNodeId(OpcUaType_Int64));
+        CHECK_EQUAL(OpcUaType_Int64, value->dataType().identifierNumeric());
+        UaInt64Array valueInt64Array;
+        value->toInt64Array(valueInt64Array);
+        CHECK_EQUAL(8, valueInt64Array[1]);
+        delete value;
+        // long[] -> string[]: unsupported
+        try {
+            conv.convertIo2ua(*arrayLong, UaNodeId(OpcUaType_String));
+            FAIL("");
+        } catch (ConversionException& e) {
+        }
+        // no element instances have been created by the conversions
+        CHECK_FALSE(arrayLong->hasElements());
+        delete arrayLong;
+
+        // a large array: the contiguous values are converted without element instances
+        const int length = 10000;
+        valueDoubleArray.create(length);
+        for (int i = 0; i < length; i++) {
+            valueDoubleArray[i] = i;
+        }
+        valueDouble.setDoubleArray(valueDoubleArray);
+        arrayDouble = static_cast<IODataProviderNamespace::Array*> (
+                conv.convertUa2io(valueDouble, UaNodeId(OpcUaType_Double)));
+        CHECK_FALSE(arrayDouble->hasElements());
+        value = conv.convertIo2ua(*arrayDouble, UaNodeId(OpcUaType_Double));
+        CHECK_FALSE(arrayDouble->hasElements());
+        value->toDoubleArray(valueDoubleArray);
+        CHECK_EQUAL(length, valueDoubleArray.length());
+        DOUBLES_EQUAL(length - 1, valueDoubleArray[length - 1], 0);
+        delete value;
+        delete arrayDouble;
+    }
+
+    TEST(SasModelProviderBase_ConverterUa2IO, StructureCodec) {
+        ConverterCallback callback;
+        ConverterUa2IO conv(callback);
+        int nsIndex = 2;
+
+        // ScanData: union with a string or a byte string
+        UaStructureDefinition scanData;
+        scanData.setName("ScanData");
+        scanData.setDataTypeId(UaNodeId(20, nsIndex));
+        scanData.setBinaryEncodingId(UaNodeId(21, nsIndex));
+        scanData.setUnion(true);
+        UaStructureField field;
+        field.setName("String");
+        field.setDataTypeId(OpcUaId_String);
+        field.setArrayType(UaStructureField::ArrayType_Scalar);
+        scanData.addChild(field);
+        field.setName("ByteString");
+        field.setDataTypeId(OpcUaId_ByteString);
+        scanData.addChild(field);
+        callback.addStructureDefinition(scanData);
+        std::vector<UaNodeId> parentsScanData;
+        parentsScanData.push_back(UaNodeId(OpcUaId_Union));
+        UaNodeId dataTypeScanData(scanData.dataTypeId());
+        callback.addDataTypeParents(dataTypeScanData, parentsScanData);
+
+        // RfidScanResult: structure with a nested union and an optional field
+        UaStructureDefinition scanResult;
+        scanResult.setName("RfidScanResult");
+        scanResult.setDataTypeId(UaNodeId(22, nsIndex));
+        scanResult.setBinaryEncodingId(UaNodeId(23, nsIndex));
+        field.setName("CodeType");
+        field.setDataTypeId(OpcUaId_String);
+        scanResult.addChild(field);
+        field.setName("ScanData");
+        field.setStructureDefinition(scanData);
+        scanResult.addChild(field);
+        UaStructureField optionalField;
+        optionalField.setName("Antenna");
+        optionalField.setDataTypeId(OpcUaId_Int32);
+        optionalField.setArrayType(UaStructureField::ArrayType_Scalar);
+        optionalField.setOptional(true);
+        scanResult.addChild(optionalField);
+        callback.addStructureDefinition(scanResult);
+        std::vector<UaNodeId> parentsScanResult;
+        parentsScanResult.push_back(UaNodeId(OpcUaId_Structure));
+        UaNodeId dataTypeScanResult(scanResult.dataTypeId());
+        callback.addDataTypeParents(dataTypeScanResult, parentsScanResult);
+
+        // create UaVariant
+        UaGenericUnionValue scanDataUv(scanData);
+        scanDataUv.setValue(UaString("String"), UaVariant(UaString("epc")));
+        UaExtensionObject scanDataEo;
+        scanDataUv.toExtensionObject(scanDataEo);
+        UaGenericStructureValue scanResultSv(scanResult);
+        scanResultSv.setField(UaString("CodeType"), UaVariant(UaString("EPC")));
+        UaVariant tmp;
+        tmp.setExtensionObject(scanDataEo, OpcUa_False /*detach*/);
+        scanResultSv.setField(UaString("ScanData"), tmp);
+        UaExtensionObject scanResultEo;
+        scanResultSv.toExtensionObject(scanResultEo);
+        UaVariant value;
+        value.setExtensionObject(scanResultEo, OpcUa_False /*detach*/);
+
+        for (int i = 0; i < 3; i++) {
+            // UaVariant -> Structure
+            IODataProviderNamespace::Structure* structure =
+                    static_cast<IODataProviderNamespace::Structure*> (
+                    conv.convertUa2io(value, dataTypeScanResult));
+            const std::map<std::string, const IODataProviderNamespace::Variant*>& fields =
+                    structure->getFieldData();
+            CHECK_EQUAL(2, fields.size());
+            STRCMP_EQUAL("EPC", static_cast<const IODataProviderNamespace::Scalar*> (
+                    fields.find("CodeType")->second)->getString()->c_str());
+            const IODataProviderNamespace::Structure* nested =
+                    static_cast<const IODataProviderNamespace::Structure*> (fields.find("ScanData")->second);
+            CHECK_EQUAL(1, nested->getFieldData().size());
+            STRCMP_EQUAL("epc", static_cast<const IODataProviderNamespace::Scalar*> (
+                    nested->getFieldData().find("String")->second)->getString()->c_str());
+
+            // Structure -> UaVariant
+            UaVariant* uaValue = conv.convertIo2ua(*structure, dataTypeScanResult);
+            UaExtensionObject eo;
+            uaValue->toExtensionObject(eo);
+            UaGenericStructureValue sv(eo, scanResult);
+            CHECK_TRUE(sv.isFieldSet(UaString("CodeType")));
+            CHECK_TRUE(sv.isFieldSet(UaString("ScanData")));
+            CHECK_FALSE(sv.isFieldSet(UaString("Antenna")));
+            delete uaValue;
+            delete structure;
+        }
+        // the codecs for both data types have been compiled once
+        CHECK_EQUAL(2, callback.structureDefinitionCount);
+
+        // the union fields are accessed by position (switch value: position + 1)
+        UaGenericUnionValue byteStringUv(scanData);
+        OpcUa_Byte bytes[] = {0x01, 0x02};
+        UaByteString byteString(2 /* length */, bytes);
+        UaVariant byteStringValue;
+        byteStringValue.setByteString(byteString, false /* detach*/);
+        byteStringUv.setValue(UaString("ByteString"), byteStringValue);
+        UaExtensionObject byteStringEo;
+        byteStringUv.toExtensionObject(byteStringEo);
+        UaVariant unionValue;
+        unionValue.setExtensionObject(byteStringEo, OpcUa_False /*detach*/);
+        IODataProviderNamespace::Structure* unionStructure =
+                static_cast<IODataProviderNamespace::Structure*> (
+                conv.convertUa2io(unionValue, dataTypeScanData));
+        CHECK_EQUAL(1, unionStructure->getFieldCount());
+        STRCMP_EQUAL("ByteString", unionStructure->getField(0).name.c_str());
+        UaVariant* uaUnionValue = conv.convertIo2ua(*unionStructure, dataTypeScanData);
+        UaExtensionObject uaUnionEo;
+        uaUnionValue->toExtensionObject(uaUnionEo);
+        UaGenericUnionValue uv(uaUnionEo, scanData);
+        STRCMP_EQUAL("ByteString", uv.field().name().toUtf8());
+        delete uaUnionValue;
+        delete unionStructure;
+
+        // fields which are not in the order of the definition (e.g. the fields of a Java map)
+        // are assigned via the codec; unknown fields are ignored
+        IODataProviderNamespace::Structure* unordered =
+                IODataProviderNamespace::Structure::createStructure(
+                *new IODataProviderNamespace::NodeId(nsIndex, 22), 4 /* fieldCount */);
+        IODataProviderNamespace::Scalar* antenna = new IODataProviderNamespace::Scalar();
+        antenna->setLong(3);
+        unordered->addField("Antenna", *antenna);
+        IODataProviderNamespace::Scalar* unknown = new IODataProviderNamespace::Scalar();
+        unknown->setLong(4);
+        unordered->addField("Unknown", *unknown);
+        IODataProviderNamespace::Structure* unorderedScanData =
+                IODataProviderNamespace::Structure::createStructure(
+                *new IODataProviderNamespace::NodeId(nsIndex, 20), 1 /* fieldCount */);
+        IODataProviderNamespace::Scalar* epc = new IODataProviderNamespace::Scalar();
+        epc->setString(new std::string("epc"), true /* attachValue */);
+        unorderedScanData->addField("String", *epc);
+        unordered->addField("ScanData", *unorderedScanData);
+        IODataProviderNamespace::Scalar* codeType = new IODataProviderNamespace::Scalar();
+        codeType->setString(new std::string("EPC"), true /* attachValue */);
+        unordered->addField("CodeType", *codeType);
+        UaVariant* uaUnordered = conv.convertIo2ua(*unordered, dataTypeScanResult);
+        UaExtensionObject unorderedEo;
+        uaUnordered->toExtensionObject(unorderedEo);
+        UaGenericStructureValue unorderedSv(unorderedEo, scanResult);
+        OpcUa_Int32 antennaValue;
+        unorderedSv.value(UaString("Antenna")).toInt32(antennaValue);
+        CHECK_EQUAL(3, antennaValue);
+        STRCMP_EQUAL("EPC", unorderedSv.value(UaString("CodeType")).toString().toUtf8());
+        CHECK_TRUE(unorderedSv.isFieldSet(UaString("ScanData")));
+        delete uaUnordered;
+        delete unordered;
+
+        // a missing mandatory field
+        std::map<std::string, const IODataProviderNamespace::Variant*>* fieldData =
+                new std::map<std::string, const IODataProviderNamespace::Variant*>();
+        IODataProviderNamespace::Structure missingField(
+                *new IODataProviderNamespace::NodeId(nsIndex, 22), *fieldData, true /*attachValues*/);
+        try {
+            conv.convertIo2ua(missingField, dataTypeScanResult);
+            FAIL("");
+        } catch (ConversionException& e) {
+        }
+    }
+
 }
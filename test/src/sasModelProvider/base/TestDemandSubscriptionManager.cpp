@@ -0,0 +1,143 @@
+#include "CppUTest/TestHarness.h"
+#include "../../ioDataProvider/IODataProviderStub.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/Event.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <sasModelProvider/base/DemandSubscriptionManager.h>
+#include <stddef.h> // NULL
+#include <string>
+#include <time.h> // nanosleep
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_DemandSubscriptionManager) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        class SubscriberCallbackImpl : public SubscriberCallback {
+        public:
+
+            virtual void valuesChanged(const Event& event) {
+            }
+        };
+
+        class StatusCallbackImpl : public DemandSubscriptionManager::StatusCallback {
+        public:
+            int initialValueCount;
+            int failedNodeCount;
+
+            StatusCallbackImpl() {
+                initialValueCount = 0;
+                failedNodeCount = 0;
+            }
+
+            virtual void subscribed(const std::vector<NodeData*>& initialValues) {
+                initialValueCount += initialValues.size();
+            }
+
+            virtual void subscriptionFailed(const std::vector<const NodeId*>& nodeIds,
+                    bool isSubscribe, const IODataProviderException& exception) {
+                failedNodeCount += nodeIds.size();
+            }
+        };
+    };
+
+    TEST(SasModelProviderBase_DemandSubscriptionManager, RefCount) {
+        IODataProviderStub provider;
+        SubscriberCallbackImpl subscriberCallback;
+        StatusCallbackImpl statusCallback;
+        DemandSubscriptionManager manager(provider, subscriberCallback, 60000 /* debounceTime */,
+                &statusCallback);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        NodeId n3(1, 3);
+        // two monitored items for n1, one for n2
+        manager.monitoringStarted(n1);
+        manager.monitoringStarted(n1);
+        manager.monitoringStarted(n2);
+        // n3 is started and stopped within the debounce time
+        manager.monitoringStarted(n3);
+        manager.monitoringStopped(n3);
+        LONGS_EQUAL(3, manager.getPendingCount());
+        manager.flush();
+        LONGS_EQUAL(0, manager.getPendingCount());
+        // all nodes are subscribed with one call
+        LONGS_EQUAL(1, provider.subscribeCalls.size());
+        LONGS_EQUAL(2, provider.subscribeCalls[0].size());
+        LONGS_EQUAL(0, provider.unsubscribeCalls.size());
+        LONGS_EQUAL(2, statusCallback.initialValueCount);
+        CHECK_TRUE(manager.isSubscribed(n1));
+        CHECK_TRUE(manager.isSubscribed(n2));
+        CHECK_FALSE(manager.isSubscribed(n3));
+
+        // n1 stays subscribed until the last monitored item stops
+        manager.monitoringStopped(n1);
+        manager.monitoringStopped(n2);
+        manager.flush();
+        LONGS_EQUAL(1, provider.unsubscribeCalls.size());
+        LONGS_EQUAL(1, provider.unsubscribeCalls[0].size());
+        LONGS_EQUAL(2, provider.unsubscribeCalls[0][0]);
+        CHECK_TRUE(manager.isSubscribed(n1));
+        CHECK_FALSE(manager.isSubscribed(n2));
+        manager.monitoringStopped(n1);
+        manager.flush();
+        LONGS_EQUAL(2, provider.unsubscribeCalls.size());
+        CHECK_FALSE(manager.isSubscribed(n1));
+
+        DemandSubscriptionManager::Metrics metrics = manager.getMetrics();
+        LONGS_EQUAL(1, metrics.subscribeCallCount);
+        LONGS_EQUAL(2, metrics.unsubscribeCallCount);
+        LONGS_EQUAL(2, metrics.subscribedNodeCount);
+        LONGS_EQUAL(2, metrics.unsubscribedNodeCount);
+        LONGS_EQUAL(1, metrics.debouncedCount);
+    }
+
+    TEST(SasModelProviderBase_DemandSubscriptionManager, Debounce) {
+        IODataProviderStub provider;
+        SubscriberCallbackImpl subscriberCallback;
+        StatusCallbackImpl statusCallback;
+        DemandSubscriptionManager manager(provider, subscriberCallback, 50 /* debounceTime */,
+                &statusCallback);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        // the debounce time triggers the subscribing
+        manager.monitoringStarted(n1);
+        manager.monitoringStarted(n2);
+        timespec delay;
+        delay.tv_sec = 0;
+        delay.tv_nsec = 200 * 1000000;
+        nanosleep(&delay, NULL);
+        LONGS_EQUAL(0, manager.getPendingCount());
+        LONGS_EQUAL(1, provider.subscribeCalls.size());
+        LONGS_EQUAL(2, provider.subscribeCalls[0].size());
+
+        // failures are reported via the callback and retried with the next begin
+        provider.fail = true;
+        NodeId n3(1, 3);
+        manager.monitoringStarted(n3);
+        manager.flush();
+        LONGS_EQUAL(1, statusCallback.failedNodeCount);
+        CHECK_FALSE(manager.isSubscribed(n3));
+        provider.fail = false;
+        manager.monitoringStarted(n3);
+        manager.flush();
+        CHECK_TRUE(manager.isSubscribed(n3));
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,103 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/NodeId.h>
+#include <sasModelProvider/base/EventTypeDataPool.h>
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <eventmanageruanode.h> // EventManagerUaNode
+#include <opcua_identifiers.h> // OpcUaId_Int32
+#include <uanodeid.h> // UaNodeId
+#include <uaqualifiedname.h> // UaQualifiedName
+#include <stddef.h> // NULL
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_EventTypeDataPool) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+    };
+
+    TEST(SasModelProviderBase_EventTypeDataPool, AcquireRelease) {
+        EventTypeRegistry registry;
+        EventTypeDataPool pool(registry, 1 /* maxIdleCount */);
+        UaNodeId type1("type1", 2);
+        UaNodeId type2("type2", 2);
+
+        // a released event object is reused for the same event type
+        EventTypeData* event1 = pool.acquire(type1);
+        pool.release(event1);
+        EventTypeData* event2 = pool.acquire(type1);
+        POINTERS_EQUAL(event1, event2);
+        // a new event object is created for another event type
+        EventTypeData* event3 = pool.acquire(type2);
+        CHECK_TRUE(event3 != event2);
+        // a new event object is created if the pool is empty
+        EventTypeData* event4 = pool.acquire(type1);
+        CHECK_TRUE(event4 != event2);
+
+        EventTypeDataPool::Metrics metrics = pool.getMetrics();
+        LONGS_EQUAL(4, metrics.acquireCount);
+        LONGS_EQUAL(1, metrics.hitCount);
+        LONGS_EQUAL(3, metrics.inUseCount);
+        LONGS_EQUAL(3, metrics.highWaterMark);
+
+        // only one unused event object is held per event type
+        pool.release(event2);
+        pool.release(event3);
+        pool.release(event4);
+        metrics = pool.getMetrics();
+        LONGS_EQUAL(0, metrics.inUseCount);
+        LONGS_EQUAL(3, metrics.highWaterMark);
+        event1 = pool.acquire(type1);
+        event2 = pool.acquire(type1);
+        LONGS_EQUAL(2, pool.getMetrics().hitCount);
+        pool.release(event1);
+        pool.release(event2);
+    }
+
+    TEST(SasModelProviderBase_EventTypeDataPool, Fields) {
+        EventTypeRegistry registry;
+        EventTypeDataPool pool(registry, 1 /* maxIdleCount */);
+        UaNodeId type("poolType", 2);
+        UaNodeId otherType("poolOtherType", 2);
+        UaQualifiedName name("poolField", 2);
+        UaNodeId fieldNodeId("poolType.f", 2);
+        UaNodeId dataTypeId(OpcUaId_Int32);
+        NodeId ioFieldNodeId(2, "poolType.f");
+        registry.registerEventField(type, fieldNodeId, name);
+        OpcUa_UInt32 fieldIndex = EventManagerUaNode::registerEventField(name);
+
+        // a field is resolved once
+        POINTERS_EQUAL(NULL, pool.getField(type, ioFieldNodeId));
+        const EventTypeDataPool::Field* field = pool.addField(type, ioFieldNodeId, fieldNodeId,
+                dataTypeId);
+        CHECK_TRUE(fieldNodeId == field->nodeId);
+        CHECK_TRUE(dataTypeId == field->dataTypeId);
+        LONGS_EQUAL(fieldIndex, field->index);
+        // the cached field is returned for an equal IO field id
+        NodeId ioFieldNodeId2(2, "poolType.f");
+        POINTERS_EQUAL(field, pool.getField(type, ioFieldNodeId2));
+        // an already cached field is not replaced
+        POINTERS_EQUAL(field, pool.addField(type, ioFieldNodeId2, fieldNodeId, dataTypeId));
+        // the fields are cached per event type
+        POINTERS_EQUAL(NULL, pool.getField(otherType, ioFieldNodeId));
+        // a field which has not been registered for the event type has no index
+        const EventTypeDataPool::Field* otherField = pool.addField(otherType, ioFieldNodeId,
+                fieldNodeId, dataTypeId);
+        CHECK_TRUE(otherField != field);
+        LONGS_EQUAL(-1, otherField->index);
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,92 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <eventmanageruanode.h> // EventManagerUaNode
+#include <uanodeid.h> // UaNodeId
+#include <uaqualifiedname.h> // UaQualifiedName
+#include <uastring.h> // UaString
+#include <stddef.h> // NULL
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_EventTypeRegistry) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+    };
+
+    TEST(SasModelProviderBase_EventTypeRegistry, GetEventFieldNodeId) {
+        EventTypeRegistry registry;
+        UaNodeId superType("superType", 2);
+        UaNodeId type("type", 2);
+        UaNodeId unknownType("unknownType", 2);
+        UaQualifiedName name1("f1", 2);
+        UaQualifiedName name2("f2", 2);
+        UaNodeId superField1("superType.f1", 2);
+        UaNodeId superField2("superType.f2", 2);
+        UaNodeId field2("type.f2", 2);
+
+        registry.registerEventField(superType, superField1, name1);
+        registry.registerEventField(superType, superField2, name2);
+        OpcUa_UInt32 fieldIndex1 = EventManagerUaNode::registerEventField(name1);
+        OpcUa_UInt32 fieldIndex2 = EventManagerUaNode::registerEventField(name2);
+        // the fields of the super type are inherited after the type has been registered
+        registry.registerEventType(superType, type);
+        int typeIndex = registry.getEventTypeIndex(type);
+        CHECK_TRUE(typeIndex >= 0);
+        CHECK_TRUE(superField1 == registry.getEventFieldNodeId(typeIndex, fieldIndex1));
+        CHECK_TRUE(superField2 == registry.getEventFieldNodeId(typeIndex, fieldIndex2));
+        // an own field overrides the field of the super type
+        registry.registerEventField(type, field2, name2);
+        CHECK_TRUE(superField1 == registry.getEventFieldNodeId(typeIndex, fieldIndex1));
+        CHECK_TRUE(field2 == registry.getEventFieldNodeId(typeIndex, fieldIndex2));
+        CHECK_TRUE(superField2 == registry.getEventFieldNodeId(superType, fieldIndex2));
+
+        // unknown types and fields
+        LONGS_EQUAL(-1, registry.getEventTypeIndex(unknownType));
+        CHECK_TRUE(registry.getEventFieldNodeId(unknownType, fieldIndex1).isNull());
+        CHECK_TRUE(registry.getEventFieldNodeId(typeIndex, 100000).isNull());
+    }
+
+    TEST(SasModelProviderBase_EventTypeRegistry, InheritedFields) {
+        const int fieldCount = 20;
+        EventTypeRegistry registry;
+        UaNodeId superType("inheritedSuperType", 2);
+        UaNodeId type("inheritedType", 2);
+        registry.registerEventType(superType, type);
+        std::vector<OpcUa_UInt32> fieldIndices;
+        std::vector<UaNodeId> fieldNodeIds;
+        for (int i = 0; i < fieldCount; i++) {
+            UaQualifiedName name(UaString("inherited%1").arg(i), 2);
+            fieldNodeIds.push_back(UaNodeId(UaString("inherited.f%1").arg(i), 2));
+            registry.registerEventField(i % 2 == 0 ? superType : type, fieldNodeIds[i], name);
+            fieldIndices.push_back(EventManagerUaNode::registerEventField(name));
+        }
+
+        // the type provides the own fields and the fields registered for the super type
+        // after the type has been registered
+        int typeIndex = registry.getEventTypeIndex(type);
+        int superTypeIndex = registry.getEventTypeIndex(superType);
+        for (int i = 0; i < fieldCount; i++) {
+            UaNodeId fieldNodeId = registry.getEventFieldNodeId(typeIndex, fieldIndices[i]);
+            CHECK_FALSE(fieldNodeId.isNull());
+            CHECK_TRUE(fieldNodeIds[i] == fieldNodeId);
+            // the super type only provides its own fields
+            CHECK_EQUAL(i % 2 == 0,
+                    !registry.getEventFieldNodeId(superTypeIndex, fieldIndices[i]).isNull());
+        }
+    }
+
+} // namespace TestNamespace
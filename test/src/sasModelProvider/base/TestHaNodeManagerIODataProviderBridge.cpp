@@ -0,0 +1,327 @@
+#include "CppUTest/TestHarness.h"
+#include "../../ioDataProvider/IODataProviderStub.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/Event.h>
+#include <ioDataProvider/IODataProvider.h>
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/NodeProperties.h>
+#include <ioDataProvider/OpcUaEventData.h>
+#include <ioDataProvider/Scalar.h>
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <sasModelProvider/base/HaNodeManager.h>
+#include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
+#include <sasModelProvider/base/IODataProviderSubscriberCallback.h>
+#include <methodmanager.h> // MethodManagerCallback
+#include <nodemanagerbase.h> // NodeManagerBase
+#include <opcua_builtintypes.h> // OpcUaType_Int64
+#include <uaarraytemplates.h> // UaDataValueArray
+#include <uabasenodes.h> // UaPropertyCache
+#include <uanodeid.h> // UaNodeId
+#include <uastring.h> // UaString
+#include <uavariant.h> // UaVariant
+#include <stddef.h> // NULL
+#include <string>
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_HaNodeManagerIODataProviderBridge) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        // An IO data provider which reads long values with the numeric part of the node ids.
+        // The reading of nodes with string ids fails with a status code.
+        class IODataProviderImpl : public IODataProviderStub {
+        public:
+            NodeProperties::ValueHandling valueHandling;
+            unsigned long failedStatusCode;
+            // whether the results reference the node ids of the request like JDataProvider
+            bool referenceNodeIds;
+            // count of node ids which have been copied for the results
+            int nodeIdCopyCount;
+            // count of copies of the returned values
+            int valueCopyCount;
+
+            IODataProviderImpl() {
+                valueHandling = NodeProperties::NONE;
+                failedStatusCode = 0x80050000; // BadCommunicationError
+                referenceNodeIds = false;
+                nodeIdCopyCount = 0;
+                valueCopyCount = 0;
+            }
+
+            virtual const NodeProperties* getDefaultNodeProperties(const std::string& namespaceUri,
+                    int namespaceId) {
+                // the bridge deletes the node properties
+                return new NodeProperties(valueHandling);
+            }
+        protected:
+
+            virtual std::vector<NodeData*>* createResults(
+                    const std::vector<const NodeId*>& nodeIds) {
+                std::vector<NodeData*>* ret = new std::vector<NodeData*>();
+                for (std::vector<const NodeId*>::const_iterator i = nodeIds.begin();
+                        i != nodeIds.end(); i++) {
+                    const NodeId& nodeId = **i;
+                    if (nodeId.getNodeType() == NodeId::NUMERIC) {
+                        Scalar* value = new CountedScalar(valueCopyCount);
+                        value->setLong(nodeId.getNumeric());
+                        if (referenceNodeIds) {
+                            ret->push_back(new NodeData(nodeId, value, true /* attachValues */,
+                                    false /* attachNodeId */));
+                        } else {
+                            nodeIdCopyCount++;
+                            ret->push_back(new NodeData(*new NodeId(nodeId), value,
+                                    true /* attachValues */));
+                        }
+                    } else {
+                        NodeData* nodeData = new NodeData(*new NodeId(nodeId),
+                                NULL /* data */, true /* attachValues */);
+                        nodeData->setStatus(failedStatusCode);
+                        ret->push_back(nodeData);
+                    }
+                }
+                return ret;
+            }
+        };
+
+        // A node manager which is not started by a server.
+        // It is its own root node manager.
+        class HaNodeManagerImpl : public NodeManagerBase, public HaNodeManager {
+        public:
+            EventTypeRegistry eventTypeRegistry;
+            HaNodeManagerIODataProviderBridge* bridge;
+            UaString defaultLocaleId;
+
+            HaNodeManagerImpl(IODataProvider& ioDataProvider,
+                    const HaNodeManagerIODataProviderBridge::Configuration& conf) :
+            NodeManagerBase("http://test/HaNodeManagerIODataProviderBridge") {
+                bridge = new HaNodeManagerIODataProviderBridge(*this, ioDataProvider, conf);
+            }
+
+            virtual ~HaNodeManagerImpl() {
+                delete bridge;
+            }
+
+            virtual UaStatus afterStartUp() {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus beforeShutDown() {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus readValues(const UaVariableArray &arrUaVariables,
+                    UaDataValueArray &arrDataValues) {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus writeValues(const UaVariableArray &arrUaVariables,
+                    const PDataValueArray &arrpDataValues,
+                    UaStatusCodeArray &arrStatusCodes) {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual OpcUa_Boolean beforeSetAttributeValue(Session* pSession, UaNode* pNode,
+                    OpcUa_Int32 attributeId, const UaDataValue& dataValue,
+                    OpcUa_Boolean& checkWriteMask) {
+                return OpcUa_True;
+            }
+
+            virtual void afterSetAttributeValue(Session* pSession, UaNode* pNode,
+                    OpcUa_Int32 attributeId, const UaDataValue& dataValue) {
+            }
+
+            virtual void variableCacheMonitoringChanged(UaVariableCache* pVariable,
+                    TransactionType transactionType) {
+            }
+
+            virtual UaStatus beginCall(MethodManagerCallback* pCallback,
+                    const ServiceContext& serviceContext, OpcUa_UInt32 callbackHandle,
+                    MethodHandle* pMethodHandle, const UaVariantArray& inputArguments) {
+                return UaStatus(OpcUa_BadNotImplemented);
+            }
+
+            virtual NodeManager& getNodeManagerRoot() {
+                return *this;
+            }
+
+            virtual NodeManagerBase& getNodeManagerBase() {
+                return *this;
+            }
+
+            virtual const std::vector<HaNodeManager*>* getAssociatedNodeManagers() {
+                return NULL;
+            }
+
+            virtual EventTypeRegistry& getEventTypeRegistry() {
+                return eventTypeRegistry;
+            }
+
+            virtual HaNodeManagerIODataProviderBridge& getIODataProviderBridge() {
+                return *bridge;
+            }
+
+            virtual UaString getNameSpaceUri() {
+                return NodeManagerBase::getNameSpaceUri();
+            }
+
+            virtual const UaString& getDefaultLocaleId() const {
+                return defaultLocaleId;
+            }
+
+            virtual void setVariable(UaVariable& variable, UaVariant& newValue) {
+            }
+
+            virtual void setVariables(const std::vector<UaVariable*>& variables,
+                    const std::vector<UaVariant*>& newValues) {
+            }
+
+            UaVariable* addVariable(const UaNodeId& nodeId) {
+                UaPropertyCache* variable = new UaPropertyCache(nodeId.toString(), nodeId,
+                        UaVariant(), Ua_AccessLevel_CurrentRead, getDefaultLocaleId());
+                variable->setDataType(UaNodeId(OpcUaType_Int64));
+                addUaNode(variable);
+                return variable;
+            }
+        };
+    };
+
+    TEST(SasModelProviderBase_HaNodeManagerIODataProviderBridge, EventMonitoring) {
+        IODataProviderImpl ioDataProvider;
+        HaNodeManagerIODataProviderBridge::Configuration conf;
+        conf.skipUnmonitoredEvents = true;
+        HaNodeManagerImpl nodeManager(ioDataProvider, conf);
+        HaNodeManagerIODataProviderBridge& bridge = *nodeManager.bridge;
+
+        // the event monitored items are counted
+        // (see beginStartMonitoring/beginStopMonitoring of the node managers)
+        CHECK_FALSE(bridge.isEventMonitored());
+        bridge.eventMonitoringChanged(true /* isStarted */);
+        bridge.eventMonitoringChanged(true /* isStarted */);
+        LONGS_EQUAL(2, bridge.getEventMonitoringMetrics().monitoredItemCount);
+        CHECK_TRUE(bridge.isEventMonitored());
+        bridge.eventMonitoringChanged(false /* isStarted */);
+        bridge.eventMonitoringChanged(false /* isStarted */);
+        LONGS_EQUAL(0, bridge.getEventMonitoringMetrics().monitoredItemCount);
+        // a stop without a start is ignored
+        bridge.eventMonitoringChanged(false /* isStarted */);
+        LONGS_EQUAL(0, bridge.getEventMonitoringMetrics().monitoredItemCount);
+        // queries are not counted as skipped events
+        CHECK_FALSE(bridge.isEventMonitored());
+        CHECK_FALSE(bridge.isEventMonitored());
+        LONGS_EQUAL(0, bridge.getEventMonitoringMetrics().skippedEventCount);
+
+        // an unmonitored event is skipped by the subscriber callback and counted once
+        IODataProviderSubscriberCallback callback(nodeManager);
+        NodeId eventTypeId(1, "eventType");
+        CHECK_FALSE(callback.isEventMonitored(eventTypeId));
+        std::vector<const NodeData*>* nodeData = new std::vector<const NodeData*>();
+        nodeData->push_back(new NodeData(*new NodeId(eventTypeId),
+                new OpcUaEventData(*new NodeId(1, "source"), *new std::string("message"),
+                500 /* severity */, *new std::vector<const NodeData*>(),
+                true /* attachValues */), true /* attachValues */));
+        Event event(0 /* dateTime */, *nodeData, true /* attachValues */);
+        callback.valuesChanged(event);
+        LONGS_EQUAL(1, bridge.getEventMonitoringMetrics().skippedEventCount);
+        // an event skipped by an IO data provider is counted
+        callback.eventSkipped(eventTypeId);
+        LONGS_EQUAL(2, bridge.getEventMonitoringMetrics().skippedEventCount);
+
+        // all events are processed if skipping is disabled
+        IODataProviderImpl ioDataProvider2;
+        HaNodeManagerImpl nodeManager2(ioDataProvider2,
+                HaNodeManagerIODataProviderBridge::Configuration());
+        CHECK_TRUE(nodeManager2.bridge->isEventMonitored());
+        nodeManager2.bridge->eventMonitoringChanged(true /* isStarted */);
+        LONGS_EQUAL(0, nodeManager2.bridge->getEventMonitoringMetrics().monitoredItemCount);
+    }
+
+    TEST(SasModelProviderBase_HaNodeManagerIODataProviderBridge, ReadStatus) {
+        IODataProviderImpl ioDataProvider;
+        ioDataProvider.valueHandling = NodeProperties::SYNC;
+        HaNodeManagerImpl nodeManager(ioDataProvider,
+                HaNodeManagerIODataProviderBridge::Configuration());
+        HaNodeManagerIODataProviderBridge& bridge = *nodeManager.bridge;
+        OpcUa_UInt16 ns = nodeManager.getNameSpaceIndex();
+        UaVariableArray variables;
+        variables.create(3);
+        variables[0] = nodeManager.addVariable(UaNodeId(1, ns));
+        variables[1] = nodeManager.addVariable(UaNodeId("failed", ns));
+        variables[2] = nodeManager.addVariable(UaNodeId(3, ns));
+        CHECK_TRUE(bridge.afterStartUp().isGood());
+
+        // the status codes of failed nodes are returned for the variables
+        // while the values of the remaining variables are converted
+        UaDataValueArray returnValues;
+        CHECK_TRUE(bridge.readValues(variables, returnValues).isGood());
+        LONGS_EQUAL(3, returnValues.length());
+        OpcUa_Int64 value;
+        LONGS_EQUAL(OpcUa_Good, returnValues[0].statusCode());
+        UaVariant(*returnValues[0].value()).toInt64(value);
+        LONGS_EQUAL(1, value);
+        LONGS_EQUAL(0x80050000, returnValues[1].statusCode());
+        LONGS_EQUAL(OpcUa_Good, returnValues[2].statusCode());
+        UaVariant(*returnValues[2].value()).toInt64(value);
+        LONGS_EQUAL(3, value);
+
+        // a status code without the bad flag is not an error
+        // => the missing value is returned as empty value
+        ioDataProvider.failedStatusCode = 0x40000000; // Uncertain
+        CHECK_TRUE(bridge.readValues(variables, returnValues).isGood());
+        LONGS_EQUAL(OpcUa_Good, returnValues[1].statusCode());
+        CHECK_TRUE(UaVariant(*returnValues[1].value()).isEmpty());
+
+        bridge.beforeShutDown();
+    }
+
+    TEST(SasModelProviderBase_HaNodeManagerIODataProviderBridge, ReadCopies) {
+        IODataProviderImpl ioDataProvider;
+        ioDataProvider.valueHandling = NodeProperties::SYNC;
+        HaNodeManagerIODataProviderBridge::Configuration conf;
+        conf.readCoalescing = true;
+        HaNodeManagerImpl nodeManager(ioDataProvider, conf);
+        HaNodeManagerIODataProviderBridge& bridge = *nodeManager.bridge;
+        OpcUa_UInt16 ns = nodeManager.getNameSpaceIndex();
+        UaVariableArray variables;
+        variables.create(2);
+        variables[0] = nodeManager.addVariable(UaNodeId(1, ns));
+        variables[1] = nodeManager.addVariable(UaNodeId(2, ns));
+        CHECK_TRUE(bridge.afterStartUp().isGood());
+
+        // a provider which copies the node ids (before: JDataProvider)
+        UaDataValueArray returnValues;
+        CHECK_TRUE(bridge.readValues(variables, returnValues).isGood());
+        LONGS_EQUAL(2, ioDataProvider.nodeIdCopyCount);
+
+        // the results reference the node ids of the request of the bridge
+        // => neither the node ids nor the values are copied per read
+        ioDataProvider.referenceNodeIds = true;
+        ioDataProvider.nodeIdCopyCount = 0;
+        CHECK_TRUE(bridge.readValues(variables, returnValues).isGood());
+        LONGS_EQUAL(0, ioDataProvider.nodeIdCopyCount);
+        LONGS_EQUAL(0, ioDataProvider.valueCopyCount);
+        OpcUa_Int64 value;
+        UaVariant(*returnValues[0].value()).toInt64(value);
+        LONGS_EQUAL(1, value);
+        UaVariant(*returnValues[1].value()).toInt64(value);
+        LONGS_EQUAL(2, value);
+
+        bridge.beforeShutDown();
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,109 @@
+#include "CppUTest/TestHarness.h"
+#include <ioDataProvider/NodeData.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <sasModelProvider/base/IngressFilter.h>
+#include <string>
+
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_IngressFilter) {
+
+        NodeData* createNodeData(long id, double value) {
+            Scalar* v = new Scalar();
+            v->setDouble(value);
+            return new NodeData(*new NodeId(1 /* namespaceIndex */, id), v,
+                    true /* attachValues */);
+        }
+
+        // Filters a value. A passed value is committed like after a successful update of
+        // the server cache.
+        bool pass(IngressFilter& filter, long id, double value) {
+            NodeData* nodeData = createNodeData(id, value);
+            bool ret = filter.pass(*nodeData);
+            if (ret) {
+                filter.commit(*nodeData);
+            }
+            delete nodeData;
+            return ret;
+        }
+    };
+
+    TEST(SasModelProviderBase_IngressFilter, Equality) {
+        IngressFilter filter;
+        NodeId nodeId(1, 1);
+        filter.setFilter(nodeId, true /* suppressEqualValues */, 0 /* deadband */);
+        LONGS_EQUAL(1, filter.size());
+        CHECK_TRUE(pass(filter, 1, 10));
+        CHECK_FALSE(pass(filter, 1, 10));
+        CHECK_TRUE(pass(filter, 1, 10.5));
+        // nodes without a filter are not affected
+        CHECK_TRUE(pass(filter, 2, 10));
+        CHECK_TRUE(pass(filter, 2, 10));
+        // the next value passes after a reset
+        filter.reset(nodeId);
+        CHECK_TRUE(pass(filter, 1, 10.5));
+
+        // strings
+        std::string s1("a");
+        std::string s2("a");
+        Scalar* v1 = new Scalar();
+        v1->setString(&s1);
+        Scalar* v2 = new Scalar();
+        v2->setString(&s2);
+        NodeData nd1(*new NodeId(nodeId), v1, true /* attachValues */);
+        NodeData nd2(*new NodeId(nodeId), v2, true /* attachValues */);
+        CHECK_TRUE(filter.pass(nd1));
+        filter.commit(nd1);
+        CHECK_FALSE(filter.pass(nd2));
+
+        IngressFilter::Metrics metrics = filter.getMetrics();
+        LONGS_EQUAL(4, metrics.passedCount);
+        LONGS_EQUAL(2, metrics.suppressedEqualCount);
+        LONGS_EQUAL(0, metrics.suppressedDeadbandCount);
+
+        filter.removeFilter(nodeId);
+        LONGS_EQUAL(0, filter.size());
+        CHECK_TRUE(filter.pass(nd2));
+    }
+
+    TEST(SasModelProviderBase_IngressFilter, Deadband) {
+        IngressFilter filter;
+        NodeId nodeId(1, 1);
+        filter.setFilter(nodeId, false /* suppressEqualValues */, 0.5 /* deadband */);
+        CHECK_TRUE(pass(filter, 1, 10));
+        CHECK_FALSE(pass(filter, 1, 10.3));
+        CHECK_FALSE(pass(filter, 1, 9.5));
+        // the deadband is relative to the last committed value
+        CHECK_TRUE(pass(filter, 1, 10.6));
+        CHECK_FALSE(pass(filter, 1, 10.2));
+        CHECK_TRUE(pass(filter, 1, 10));
+
+        IngressFilter::Metrics metrics = filter.getMetrics();
+        LONGS_EQUAL(3, metrics.passedCount);
+        LONGS_EQUAL(0, metrics.suppressedEqualCount);
+        LONGS_EQUAL(3, metrics.suppressedDeadbandCount);
+    }
+
+    TEST(SasModelProviderBase_IngressFilter, Commit) {
+        IngressFilter filter;
+        NodeId nodeId(1, 1);
+        filter.setFilter(nodeId, true /* suppressEqualValues */, 0 /* deadband */);
+        CHECK_TRUE(pass(filter, 1, 10));
+        // a passed value which has not been committed (e.g. the conversion failed) does not
+        // suppress the next equal value
+        NodeData* nodeData = createNodeData(1, 11);
+        CHECK_TRUE(filter.pass(*nodeData));
+        CHECK_TRUE(filter.pass(*nodeData));
+        filter.commit(*nodeData);
+        CHECK_FALSE(filter.pass(*nodeData));
+        delete nodeData;
+        // the last committed value is still used as reference
+        CHECK_FALSE(pass(filter, 1, 11));
+        CHECK_TRUE(pass(filter, 1, 10));
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,215 @@
+#include "CppUTest/TestHarness.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <sasModelProvider/base/EventTypeRegistry.h>
+#include <sasModelProvider/base/HaNodeManager.h>
+#include <sasModelProvider/base/HaNodeManagerIODataProviderBridge.h>
+#include <sasModelProvider/base/NodeBrowser.h>
+#include <methodmanager.h> // MethodManagerCallback
+#include <nodemanagerbase.h> // NodeManagerBase
+#include <uabasenodes.h> // UaPropertyCache
+#include <uanodeid.h> // UaNodeId
+#include <uastring.h> // UaString
+#include <stddef.h> // NULL
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_NodeBrowser) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        // A variable which reports its deletion.
+        class TrackedVariable : public UaPropertyCache {
+        public:
+            int generation;
+            bool* isDeleted;
+
+            TrackedVariable(const UaNodeId& nodeId, const UaString& defaultLocaleId,
+                    int generation, bool& isDeleted) :
+            UaPropertyCache(nodeId.toString(), nodeId, UaVariant(), Ua_AccessLevel_CurrentRead,
+            defaultLocaleId) {
+                this->generation = generation;
+                this->isDeleted = &isDeleted;
+            }
+
+            virtual ~TrackedVariable() {
+                *isDeleted = true;
+            }
+        };
+
+        // A node manager which is not started by a server.
+        // It is its own root node manager.
+        class HaNodeManagerImpl : public NodeManagerBase, public HaNodeManager {
+        public:
+            EventTypeRegistry eventTypeRegistry;
+            HaNodeManagerIODataProviderBridge* bridge;
+            UaString defaultLocaleId;
+
+            HaNodeManagerImpl() : NodeManagerBase("http://test/NodeBrowser") {
+                bridge = NULL;
+            }
+
+            void addVariable(const UaNodeId& nodeId) {
+                UaPropertyCache* variable = new UaPropertyCache(nodeId.toString(), nodeId,
+                        UaVariant(), Ua_AccessLevel_CurrentRead, defaultLocaleId);
+                addUaNode(variable);
+            }
+
+            void addTrackedVariable(const UaNodeId& nodeId, int generation, bool& isDeleted) {
+                addUaNode(new TrackedVariable(nodeId, defaultLocaleId, generation, isDeleted));
+            }
+
+            virtual UaStatus afterStartUp() {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus beforeShutDown() {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus readValues(const UaVariableArray &arrUaVariables,
+                    UaDataValueArray &arrDataValues) {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual UaStatus writeValues(const UaVariableArray &arrUaVariables,
+                    const PDataValueArray &arrpDataValues,
+                    UaStatusCodeArray &arrStatusCodes) {
+                return UaStatus(OpcUa_Good);
+            }
+
+            virtual OpcUa_Boolean beforeSetAttributeValue(Session* pSession, UaNode* pNode,
+                    OpcUa_Int32 attributeId, const UaDataValue& dataValue,
+                    OpcUa_Boolean& checkWriteMask) {
+                return OpcUa_True;
+            }
+
+            virtual void afterSetAttributeValue(Session* pSession, UaNode* pNode,
+                    OpcUa_Int32 attributeId, const UaDataValue& dataValue) {
+            }
+
+            virtual void variableCacheMonitoringChanged(UaVariableCache* pVariable,
+                    TransactionType transactionType) {
+            }
+
+            virtual UaStatus beginCall(MethodManagerCallback* pCallback,
+                    const ServiceContext& serviceContext, OpcUa_UInt32 callbackHandle,
+                    MethodHandle* pMethodHandle, const UaVariantArray& inputArguments) {
+                return UaStatus(OpcUa_BadNotImplemented);
+            }
+
+            virtual NodeManager& getNodeManagerRoot() {
+                return *this;
+            }
+
+            virtual NodeManagerBase& getNodeManagerBase() {
+                return *this;
+            }
+
+            virtual const std::vector<HaNodeManager*>* getAssociatedNodeManagers() {
+                return NULL;
+            }
+
+            virtual EventTypeRegistry& getEventTypeRegistry() {
+                return eventTypeRegistry;
+            }
+
+            virtual HaNodeManagerIODataProviderBridge& getIODataProviderBridge() {
+                // the bridge is not used by the node browser
+                return *bridge;
+            }
+
+            virtual UaString getNameSpaceUri() {
+                return NodeManagerBase::getNameSpaceUri();
+            }
+
+            virtual const UaString& getDefaultLocaleId() const {
+                return defaultLocaleId;
+            }
+
+            virtual void setVariable(UaVariable& variable, UaVariant& newValue) {
+            }
+
+            virtual void setVariables(const std::vector<UaVariable*>& variables,
+                    const std::vector<UaVariant*>& newValues) {
+            }
+        };
+    };
+
+    TEST(SasModelProviderBase_NodeBrowser, GetVariable) {
+        HaNodeManagerImpl nodeManager;
+        UaNodeId nodeId("v1", nodeManager.getNameSpaceIndex());
+        UaNodeId unknownNodeId("unknown", nodeManager.getNameSpaceIndex());
+        nodeManager.addVariable(nodeId);
+        NodeBrowser nodeBrowser(nodeManager);
+
+        // the cached variable is returned with an added reference
+        UaVariable* variable1 = nodeBrowser.getVariable(nodeId);
+        CHECK_TRUE(variable1 != NULL);
+        UaVariable* variable2 = nodeBrowser.getVariable(nodeId);
+        POINTERS_EQUAL(variable1, variable2);
+        variable1->releaseReference();
+        variable2->releaseReference();
+        CHECK_TRUE(nodeBrowser.getVariable(unknownNodeId) == NULL);
+
+        // a deleted node is removed from the cache
+        UaNodeId trackedNodeId("v2", nodeManager.getNameSpaceIndex());
+        bool isDeleted1 = false;
+        nodeManager.addTrackedVariable(trackedNodeId, 1 /* generation */, isDeleted1);
+        variable1 = nodeBrowser.getVariable(trackedNodeId);
+        LONGS_EQUAL(1, static_cast<TrackedVariable*> (variable1)->generation);
+        variable1->releaseReference();
+        NodeBrowser::nodeDeleted(trackedNodeId);
+        nodeManager.deleteUaNode(variable1, OpcUa_True /* deleteTargetReferences */,
+                OpcUa_True /* deleteSourceReferences */);
+        // the reference of the cache has been released
+        CHECK_TRUE(isDeleted1);
+        // a new node with the same nodeId is fetched from the node manager
+        bool isDeleted2 = false;
+        nodeManager.addTrackedVariable(trackedNodeId, 2 /* generation */, isDeleted2);
+        variable2 = nodeBrowser.getVariable(trackedNodeId);
+        CHECK_TRUE(variable2 != NULL);
+        LONGS_EQUAL(2, static_cast<TrackedVariable*> (variable2)->generation);
+        variable2->releaseReference();
+    }
+
+    TEST(SasModelProviderBase_NodeBrowser, GetVariables) {
+        const int variableCount = 100;
+        HaNodeManagerImpl nodeManager;
+        std::vector<UaNodeId> nodeIds;
+        for (int i = 0; i < variableCount; i++) {
+            UaNodeId nodeId(UaString("v%1").arg(i), nodeManager.getNameSpaceIndex());
+            nodeManager.addVariable(nodeId);
+            nodeIds.push_back(nodeId);
+        }
+        NodeBrowser nodeBrowser(nodeManager);
+
+        // each variable is cached separately and returned by the cache afterwards
+        std::vector<UaVariable*> variables;
+        for (int i = 0; i < variableCount; i++) {
+            UaVariable* variable = nodeBrowser.getVariable(nodeIds[i]);
+            CHECK_TRUE(variable != NULL);
+            CHECK_TRUE(nodeIds[i] == variable->nodeId());
+            variables.push_back(variable);
+        }
+        for (int i = 0; i < variableCount; i++) {
+            UaVariable* variable = nodeBrowser.getVariable(nodeIds[i]);
+            POINTERS_EQUAL(variables[i], variable);
+            variable->releaseReference();
+            variables[i]->releaseReference();
+        }
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,129 @@
+#include "CppUTest/TestHarness.h"
+#include "../../ioDataProvider/IODataProviderStub.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <sasModelProvider/base/PollScheduler.h>
+#include <pthread.h> // pthread_mutex_t
+#include <stddef.h> // NULL
+#include <string>
+#include <time.h> // nanosleep
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_PollScheduler) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        void sleep(long milliseconds) {
+            timespec delay;
+            delay.tv_sec = milliseconds / 1000;
+            delay.tv_nsec = (milliseconds % 1000) * 1000000;
+            nanosleep(&delay, NULL);
+        }
+    };
+
+    TEST(SasModelProviderBase_PollScheduler, Groups) {
+        IODataProviderStub provider;
+        PollScheduler scheduler(provider, 50 /* minInterval */, NULL /* callback */);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        NodeId n3(1, 3);
+        // the min. interval is used for faster intervals
+        scheduler.monitoringStarted(n1, 10 /* samplingInterval */);
+        scheduler.monitoringStarted(n2, 50 /* samplingInterval */);
+        scheduler.monitoringStarted(n3, 5000 /* samplingInterval */);
+        LONGS_EQUAL(2, scheduler.getGroupCount());
+        LONGS_EQUAL(50, scheduler.getInterval(n1));
+        // the fastest requested interval wins
+        scheduler.monitoringStarted(n3, 100 /* samplingInterval */);
+        LONGS_EQUAL(100, scheduler.getInterval(n3));
+        LONGS_EQUAL(2, scheduler.getGroupCount());
+
+        sleep(300);
+        // the nodes of a group are read with one call
+        std::vector<int> readSizes = provider.getReadSizes();
+        CHECK_TRUE(readSizes.size() >= 3);
+        for (int i = 0; i < readSizes.size(); i++) {
+            CHECK_TRUE(readSizes[i] == 2 || readSizes[i] == 1);
+        }
+        CHECK_TRUE(scheduler.isFresh(n3));
+
+        // a node leaves its group after the last monitored item stops
+        scheduler.monitoringStopped(n3);
+        LONGS_EQUAL(100, scheduler.getInterval(n3));
+        scheduler.monitoringStopped(n3);
+        LONGS_EQUAL(0, scheduler.getInterval(n3));
+        CHECK_FALSE(scheduler.isFresh(n3));
+        LONGS_EQUAL(1, scheduler.getGroupCount());
+        LONGS_EQUAL(0, scheduler.getMetrics().overrunCount);
+    }
+
+    TEST(SasModelProviderBase_PollScheduler, Intervals) {
+        IODataProviderStub provider;
+        PollScheduler scheduler(provider, 50 /* minInterval */, NULL /* callback */);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        scheduler.monitoringStarted(n1, 1000 /* samplingInterval */);
+        scheduler.monitoringStarted(n1, 100 /* samplingInterval */);
+        scheduler.monitoringStarted(n2, 1000 /* samplingInterval */);
+        LONGS_EQUAL(100, scheduler.getInterval(n1));
+        LONGS_EQUAL(2, scheduler.getGroupCount());
+
+        // the interval is extended after the fastest monitored item stops
+        scheduler.monitoringStopped(n1, 1000 /* samplingInterval */);
+        LONGS_EQUAL(1000, scheduler.getInterval(n1));
+        LONGS_EQUAL(1, scheduler.getGroupCount());
+        // the interval is kept without a remaining sampling interval
+        scheduler.monitoringStarted(n1, 200 /* samplingInterval */);
+        scheduler.monitoringStopped(n1);
+        LONGS_EQUAL(200, scheduler.getInterval(n1));
+
+        // a modified sampling interval may extend or shorten the interval
+        scheduler.monitoringModified(n1, 500 /* samplingInterval */);
+        LONGS_EQUAL(500, scheduler.getInterval(n1));
+        scheduler.monitoringModified(n1, 10 /* samplingInterval */);
+        LONGS_EQUAL(50, scheduler.getInterval(n1));
+        LONGS_EQUAL(2, scheduler.getGroupCount());
+        // unmonitored nodes are ignored
+        NodeId n3(1, 3);
+        scheduler.monitoringModified(n3, 100 /* samplingInterval */);
+        LONGS_EQUAL(0, scheduler.getInterval(n3));
+
+        scheduler.monitoringStopped(n1);
+        LONGS_EQUAL(0, scheduler.getInterval(n1));
+        scheduler.monitoringStopped(n2);
+        LONGS_EQUAL(0, scheduler.getGroupCount());
+    }
+
+    TEST(SasModelProviderBase_PollScheduler, Overrun) {
+        IODataProviderStub provider;
+        provider.delay = 80;
+        PollScheduler scheduler(provider, 20 /* minInterval */, NULL /* callback */);
+        NodeId n1(1, 1);
+        scheduler.monitoringStarted(n1, 20 /* samplingInterval */);
+        sleep(300);
+        scheduler.monitoringStopped(n1);
+        PollScheduler::Metrics metrics = scheduler.getMetrics();
+        CHECK_TRUE(metrics.pollCount > 0);
+        // each poll takes longer than the interval
+        LONGS_EQUAL(metrics.pollCount, metrics.overrunCount);
+        LONGS_EQUAL(0, metrics.failedPollCount);
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,211 @@
+#include "CppUTest/TestHarness.h"
+#include "../../ioDataProvider/IODataProviderStub.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <sasModelProvider/base/SingleFlightReader.h>
+#include <pthread.h> // pthread_t
+#include <stddef.h> // NULL
+#include <string>
+#include <time.h> // nanosleep
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_SingleFlightReader) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        // Returns the values in reverse order. The results reference the node ids of the
+        // request like JDataProvider does.
+        class IODataProviderImpl : public IODataProviderStub {
+        public:
+            // count of copies of the returned values
+            int copyCount;
+
+            IODataProviderImpl() {
+                copyCount = 0;
+            }
+        protected:
+
+            virtual std::vector<NodeData*>* createResults(
+                    const std::vector<const NodeId*>& nodeIds) {
+                std::vector<NodeData*>* ret = new std::vector<NodeData*>();
+                for (int i = nodeIds.size() - 1; i >= 0; i--) {
+                    Scalar* value = new CountedScalar(copyCount);
+                    value->setLong(nodeIds[i]->getNumeric());
+                    ret->push_back(new NodeData(*nodeIds[i], value, true /* attachValues */,
+                            false /* attachNodeId */));
+                }
+                return ret;
+            }
+        };
+
+        class Reader {
+        public:
+            SingleFlightReader* reader;
+            std::vector<const NodeId*>* nodeIds;
+            std::vector<NodeData*>* results;
+        };
+
+        static void* read(void* object) {
+            Reader& reader = *static_cast<Reader*> (object);
+            reader.results = reader.reader->read(*reader.nodeIds);
+            return NULL;
+        }
+
+        void deleteResults(std::vector<NodeData*>* results) {
+            for (int i = 0; i < results->size(); i++) {
+                delete (*results)[i];
+            }
+            delete results;
+        }
+    };
+
+    TEST(SasModelProviderBase_SingleFlightReader, Coalescing) {
+        IODataProviderImpl provider;
+        provider.delay = 200;
+        SingleFlightReader reader(provider, 0 /* freshnessWindow */);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        NodeId n3(1, 3);
+        // the node ids of the first read are destroyed before the shared results are used
+        std::vector<const NodeId*> nodeIds1;
+        nodeIds1.push_back(new NodeId(n1));
+        nodeIds1.push_back(new NodeId(n2));
+        std::vector<const NodeId*> nodeIds2;
+        nodeIds2.push_back(&n3);
+        nodeIds2.push_back(&n2);
+        nodeIds2.push_back(&n1);
+
+        // start the first read
+        Reader reader1;
+        reader1.reader = &reader;
+        reader1.nodeIds = &nodeIds1;
+        reader1.results = NULL;
+        pthread_t thread;
+        pthread_create(&thread, NULL /*attr*/, &read, &reader1);
+        timespec delay;
+        delay.tv_sec = 0;
+        delay.tv_nsec = 50 * 1000000;
+        nanosleep(&delay, NULL);
+        // the second read shares the running read of n1 and n2 and only reads n3
+        std::vector<NodeData*>* results2 = reader.read(nodeIds2);
+        pthread_join(thread, NULL /*return*/);
+
+        LONGS_EQUAL(2, provider.readSizes.size());
+        LONGS_EQUAL(3, provider.readNodeIds.size());
+        // the results are returned in the order of the nodeIds
+        LONGS_EQUAL(2, reader1.results->size());
+        LONGS_EQUAL(1, static_cast<const Scalar*> ((*reader1.results)[0]->getData())->getLong());
+        LONGS_EQUAL(2, static_cast<const Scalar*> ((*reader1.results)[1]->getData())->getLong());
+        deleteResults(reader1.results);
+        delete nodeIds1[0];
+        delete nodeIds1[1];
+        LONGS_EQUAL(3, results2->size());
+        for (int i = 0; i < results2->size(); i++) {
+            CHECK_TRUE((*results2)[i]->getException() == NULL);
+            CHECK_TRUE(nodeIds2[i]->equals((*results2)[i]->getNodeId()));
+            LONGS_EQUAL(nodeIds2[i]->getNumeric(),
+                    static_cast<const Scalar*> ((*results2)[i]->getData())->getLong());
+        }
+        deleteResults(results2);
+
+        SingleFlightReader::Metrics metrics = reader.getMetrics();
+        LONGS_EQUAL(2, metrics.readCallCount);
+        LONGS_EQUAL(3, metrics.readNodeCount);
+        LONGS_EQUAL(2, metrics.sharedCount);
+        LONGS_EQUAL(0, metrics.freshCount);
+
+        // failures are returned as exceptions of the node data
+        provider.fail = true;
+        provider.delay = 0;
+        std::vector<NodeData*>* results = reader.read(nodeIds2);
+        LONGS_EQUAL(3, results->size());
+        CHECK_TRUE((*results)[0]->getException() != NULL);
+        CHECK_TRUE((*results)[1]->getException() != NULL);
+        CHECK_TRUE((*results)[2]->getException() != NULL);
+        deleteResults(results);
+    }
+
+    TEST(SasModelProviderBase_SingleFlightReader, FreshnessWindow) {
+        IODataProviderImpl provider;
+        SingleFlightReader reader(provider, 60000 /* freshnessWindow */);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        std::vector<const NodeId*> nodeIds;
+        nodeIds.push_back(&n1);
+        nodeIds.push_back(&n2);
+        deleteResults(reader.read(nodeIds));
+        // the values are returned from the freshness window
+        std::vector<NodeData*>* results = reader.read(nodeIds);
+        LONGS_EQUAL(1, provider.readSizes.size());
+        LONGS_EQUAL(2, static_cast<const Scalar*> ((*results)[1]->getData())->getLong());
+        deleteResults(results);
+        LONGS_EQUAL(2, reader.getMetrics().freshCount);
+
+        // an invalidated node is read again
+        reader.invalidate(n2);
+        deleteResults(reader.read(nodeIds));
+        LONGS_EQUAL(2, provider.readSizes.size());
+        LONGS_EQUAL(3, provider.readNodeIds.size());
+
+        // failed reads are not saved
+        provider.fail = true;
+        reader.invalidate(n1);
+        deleteResults(reader.read(nodeIds));
+        deleteResults(reader.read(nodeIds));
+        LONGS_EQUAL(4, provider.readSizes.size());
+    }
+
+    TEST(SasModelProviderBase_SingleFlightReader, Copies) {
+        IODataProviderImpl provider;
+        SingleFlightReader reader(provider, 0 /* freshnessWindow */);
+        NodeId n1(1, 1);
+        NodeId n2(1, 2);
+        std::vector<const NodeId*> nodeIds;
+        nodeIds.push_back(&n1);
+        nodeIds.push_back(&n2);
+        nodeIds.push_back(&n1);
+        // the results of the own read are taken over, only the duplicate node is copied
+        // (before: one copy per node)
+        std::vector<NodeData*>* results = reader.read(nodeIds);
+        LONGS_EQUAL(1, provider.copyCount);
+        LONGS_EQUAL(3, results->size());
+        for (int i = 0; i < results->size(); i++) {
+            LONGS_EQUAL(nodeIds[i]->getNumeric(),
+                    static_cast<const Scalar*> ((*results)[i]->getData())->getLong());
+        }
+        CHECK_TRUE((*results)[0] != (*results)[2]);
+        // the node ids of the request are not copied, only the duplicate owns a copy
+        POINTERS_EQUAL(&n1, &(*results)[0]->getNodeId());
+        POINTERS_EQUAL(&n2, &(*results)[1]->getNodeId());
+        CHECK_TRUE(&n1 != &(*results)[2]->getNodeId());
+        deleteResults(results);
+
+        // with a freshness window a copy is saved per node and returned per fresh value
+        IODataProviderImpl provider2;
+        SingleFlightReader reader2(provider2, 60000 /* freshnessWindow */);
+        nodeIds.pop_back();
+        deleteResults(reader2.read(nodeIds));
+        LONGS_EQUAL(2, provider2.copyCount);
+        deleteResults(reader2.read(nodeIds));
+        LONGS_EQUAL(4, provider2.copyCount);
+        LONGS_EQUAL(1, provider2.readSizes.size());
+    }
+
+} // namespace TestNamespace
@@ -0,0 +1,122 @@
+#include "CppUTest/TestHarness.h"
+#include "../../ioDataProvider/IODataProviderStub.h"
+#include <common/logging/ConsoleLoggerFactory.h>
+#include <common/logging/LoggerFactory.h>
+#include <ioDataProvider/IODataProviderException.h>
+#include <ioDataProvider/NodeId.h>
+#include <ioDataProvider/Scalar.h>
+#include <sasModelProvider/base/WriteBehindQueue.h>
+#include <stddef.h> // NULL
+#include <string>
+#include <time.h> // nanosleep
+#include <vector>
+
+using namespace CommonNamespace;
+using namespace IODataProviderNamespace;
+using namespace SASModelProviderNamespace;
+
+namespace TestNamespace {
+
+    TEST_GROUP(SasModelProviderBase_WriteBehindQueue) {
+        ConsoleLoggerFactory clf;
+        LoggerFactory* lf;
+
+        void setup() {
+            lf = new LoggerFactory(clf);
+        }
+
+        void teardown() {
+            delete lf;
+        }
+
+        class StatusCallbackImpl : public WriteBehindQueue::StatusCallback {
+        public:
+            int failedValueCount;
+
+            StatusCallbackImpl() {
+                failedValueCount = 0;
+            }
+
+            virtual void writeFailed(const std::vector<const NodeData*>& nodeData,
+                    const IODataProviderException& exception) {
+                failedValueCount += nodeData.size();
+            }
+        };
+
+        NodeData* createNodeData(long id, long value) {
+            Scalar* v = new Scalar();
+            v->setLong(value);
+            return new NodeData(*new NodeId(1 /* namespaceIndex */, id), v,
+                    true /* attachValues */);
+        }
+    };
+
+    TEST(SasModelProviderBase_WriteBehindQueue, Coalesce) {
+        IODataProviderStub provider;
+        StatusCallbackImpl callback;
+        WriteBehindQueue* queue = new WriteBehindQueue(provider, 60000 /* window */,
+                100 /* maxBatchSize */, &callback);
+        // values for the same node are coalesced
+        queue->enqueue(createNodeData(1, 10));
+        queue->enqueue(createNodeData(2, 20));
+        queue->enqueue(createNodeData(1, 11));
+        LONGS_EQUAL(2, queue->size());
+        // the queued nodes can be checked
+        NodeId node1(1 /* namespaceIndex */, 1);
+        NodeId node3(1 /* namespaceIndex */, 3);
+        std::vector<const NodeId*> nodeIds;
+        nodeIds.push_back(&node3);
+        CHECK_FALSE(queue->isQueued(nodeIds));
+        nodeIds.push_back(&node1);
+        CHECK_TRUE(queue->isQueued(nodeIds));
+        queue->flush();
+        LONGS_EQUAL(0, queue->size());
+        CHECK_FALSE(queue->isQueued(nodeIds));
+        LONGS_EQUAL(1, provider.writeSizes.size());
+        LONGS_EQUAL(2, provider.writeSizes[0]);
+        LONGS_EQUAL(11, provider.writtenValues[0]);
+        LONGS_EQUAL(20, provider.writtenValues[1]);
+
+        WriteBehindQueue::Metrics metrics = queue->getMetrics();
+        LONGS_EQUAL(1, metrics.batchCount);
+        LONGS_EQUAL(0, metrics.failedBatchCount);
+        LONGS_EQUAL(2, metrics.valueCount);
+        LONGS_EQUAL(1, metrics.coalescedCount);
+        LONGS_EQUAL(2, metrics.maxBatchSize);
+        LONGS_EQUAL(1, metrics.batchSizes[1]);
+
+        // the queued values are written while destroying the queue
+        queue->enqueue(createNodeData(3, 30));
+        delete queue;
+        LONGS_EQUAL(2, provider.writeSizes.size());
+        LONGS_EQUAL(0, callback.failedValueCount);
+    }
+
+    TEST(SasModelProviderBase_WriteBehindQueue, Flush) {
+        IODataProviderStub provider;
+        StatusCallbackImpl callback;
+        WriteBehindQueue queue(provider, 50 /* window */, 3 /* maxBatchSize */, &callback);
+        // the size threshold triggers the flushing
+        queue.enqueue(createNodeData(1, 10));
+        queue.enqueue(createNodeData(2, 20));
+        queue.enqueue(createNodeData(3, 30));
+        // the window triggers the flushing
+        timespec delay;
+        delay.tv_sec = 0;
+        delay.tv_nsec = 200 * 1000000;
+        nanosleep(&delay, NULL);
+        LONGS_EQUAL(0, queue.size());
+        queue.enqueue(createNodeData(4, 40));
+        nanosleep(&delay, NULL);
+        LONGS_EQUAL(0, queue.size());
+        LONGS_EQUAL(4, provider.writtenValues.size());
+
+        // failures are reported via the callback
+        provider.fail = true;
+        queue.enqueue(createNodeData(5, 50));
+        queue.flush();
+        LONGS_EQUAL(1, callback.failedValueCount);
+        LONGS_EQUAL(1, queue.getMetrics().failedBatchCount);
+    }
+
+} // namespace TestNamespace